@@ -60,6 +60,26 @@
  *	[4]. Register the ISR in the Interrupt Vector
  *
  * =====================================================================
+ * 	Multiple radios:
+ * =====================================================================
+ *
+ *	[1]. Declare one tNRF24L01 for every radio (static, the driver keeps a pointer
+ *		 to it only while an asynchronous operation is running).
+ *	[2]. Pass the instance as the first argument of every API, starting with NRF24L01_Init().
+ *	[3]. Radios on different SSI modules share nothing and can be served from
+ *		 different interrupts. Radios on the same SSI module need their own CSN pins
+ *		 and must not be accessed from different interrupt priorities.
+ *
+ * =====================================================================
+ * 	Other platforms (backend interface):
+ * =====================================================================
+ *
+ *	[1]. Define 'NRF24L01_CONF_HAL' in project settings (PART_LM4F120H5QR is not needed).
+ *	[2]. Prepare a backend context, eg. NRF24L01_LinuxHALOpen() or NRF24L01_StellarisHALInit().
+ *	[3]. Call NRF24L01_InitHAL() with the backend table and the context instead of NRF24L01_Init().
+ *	[4]. Use the rest of the APIs as usual. Blocking waits sleep in the backend's pfnWaitIRQ.
+ *
+ * =====================================================================
  * Change Log
  * =====================================================================
  *
@@ -109,16 +129,20 @@
  * 						PE3	<-> IRQ
  */
 
-#define PDLIB_DEBUG
+/* PS: The profile and the trace share one fast clock (see _NRF24L01_CycleNow) */
+#if defined(NRF24L01_CONF_PROFILE) || defined(NRF24L01_CONF_TRACE)
+#define CYCLE_CLOCK
+#endif
+
+#if defined(CYCLE_CLOCK) && !defined(PART_LM4F120H5QR)
+/* PS: clock_gettime with -std=c99 */
+#define _POSIX_C_SOURCE 200809L
+#endif
 
 #include <stdio.h>
-#include <stdlib.h>
+#include <string.h>
 #include "pdlib_nrf24l01.h"
 
-#ifdef PDLIB_DEBUG
-#include "uart_debug.h"
-#endif
-
 // SPI library
 #ifdef PDLIB_SPI
 #include "pdlib_spi.h"
@@ -133,6 +157,98 @@
 #include "driverlib/gpio.h"
 #endif
 
+#ifdef NRF24L01_CONF_STATIC_WIRING
+#if !defined(PART_LM4F120H5QR) || defined(NRF24L01_CONF_HAL)
+#error "NRF24L01_CONF_STATIC_WIRING needs the built-in SSI code (PART_LM4F120H5QR without NRF24L01_CONF_HAL)"
+#endif
+
+#if defined(PDLIB_SPI_CONF_SSI) && (PDLIB_SPI_CONF_SSI != NRF24L01_CONF_SSI)
+#error "PDLIB_SPI_CONF_SSI must be NRF24L01_CONF_SSI"
+#endif
+
+#include "inc/hw_ints.h"
+#endif
+
+#if defined(NRF24L01_CONF_FAST_SPI) || defined(NRF24L01_CONF_STATIC_WIRING)
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+
+/* PS: Address bits 9:2 of the GPIO DATA register mask the pins a store changes, so one store
+ * drives one pin without a read-modify-write (what GPIOPinWrite does after the ROM call) */
+#define FAST_GPIO_DATA(base, pin)	HWREG((base) + GPIO_O_DATA + ((pin) << 2))
+
+#define FAST_CE				FAST_GPIO_DATA(NRF24L01_CONF_CE_BASE, NRF24L01_CONF_CE_PIN)
+#define FAST_CSN			FAST_GPIO_DATA(NRF24L01_CONF_CSN_BASE, NRF24L01_CONF_CSN_PIN)
+#endif
+
+#ifdef NRF24L01_CONF_FAST_SPI
+#if !defined(PART_LM4F120H5QR) || !defined(PDLIB_SPI) || defined(NRF24L01_CONF_HAL)
+#error "NRF24L01_CONF_FAST_SPI needs the built-in SSI code (PART_LM4F120H5QR and PDLIB_SPI without NRF24L01_CONF_HAL)"
+#endif
+
+#include "inc/hw_ssi.h"
+
+/* PS: SSI module of NRF24L01_CONF_SSI, mapped as in pdlib_spi.c */
+#if (NRF24L01_CONF_SSI == 0)
+#define FAST_SSI_BASE		SSI0_BASE
+#elif (NRF24L01_CONF_SSI == 1) || (NRF24L01_CONF_SSI == 4)
+#define FAST_SSI_BASE		SSI1_BASE
+#elif (NRF24L01_CONF_SSI == 2)
+#define FAST_SSI_BASE		SSI2_BASE
+#elif (NRF24L01_CONF_SSI == 3)
+#define FAST_SSI_BASE		SSI3_BASE
+#else
+#error "NRF24L01_CONF_SSI must be 0 to 4"
+#endif
+
+#define FAST_SSI_DR			HWREG(FAST_SSI_BASE + SSI_O_DR)
+#define FAST_SSI_SR			HWREG(FAST_SSI_BASE + SSI_O_SR)
+
+/* PS: Depth of the SSI TX and RX FIFOs */
+#define FAST_SSI_FIFO_DEPTH	8
+#endif
+
+/* PS: SSI module of an instance, a constant with NRF24L01_CONF_STATIC_WIRING */
+#ifdef NRF24L01_CONF_STATIC_WIRING
+#define RADIO_SSI(psRadio)	NRF24L01_CONF_SSI
+#else
+#define RADIO_SSI(psRadio)	((psRadio)->ucSSI)
+#endif
+
+#ifdef CYCLE_CLOCK
+#ifdef PART_LM4F120H5QR
+/* PS: DWT cycle counter of the Cortex-M4 */
+#define CYCLE_DEMCR				0xE000EDFC
+#define CYCLE_DEMCR_TRCENA		(1UL << 24)
+#define CYCLE_DWT_CTRL			0xE0001000
+#define CYCLE_DWT_CYCCNTENA		(1UL << 0)
+#define CYCLE_DWT_CYCCNT		0xE0001004
+#elif defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#else
+#error "NRF24L01_CONF_PROFILE and NRF24L01_CONF_TRACE have no clock for this target"
+#endif
+#endif
+
+#ifdef NRF24L01_CONF_TRACE
+#if (NRF24L01_CONF_TRACE_DEPTH & (NRF24L01_CONF_TRACE_DEPTH - 1)) != 0
+#error "NRF24L01_CONF_TRACE_DEPTH must be a power of two"
+#endif
+#endif
+
+#ifdef NRF24L01_CONF_NO_HEAP
+/* PS: The driver must not use the heap. Any reference to these fails to link. */
+extern void *_NRF24L01_HeapNotAllowed_malloc(unsigned int);
+extern void *_NRF24L01_HeapNotAllowed_calloc(unsigned int, unsigned int);
+extern void *_NRF24L01_HeapNotAllowed_realloc(void *, unsigned int);
+extern void _NRF24L01_HeapNotAllowed_free(void *);
+
+#define malloc(size)			_NRF24L01_HeapNotAllowed_malloc(size)
+#define calloc(count, size)		_NRF24L01_HeapNotAllowed_calloc(count, size)
+#define realloc(ptr, size)		_NRF24L01_HeapNotAllowed_realloc(ptr, size)
+#define free(ptr)				_NRF24L01_HeapNotAllowed_free(ptr)
+#endif
+
 #define TYPE_RX		0x01
 #define TYPE_TX		0x02
 
@@ -143,32 +259,195 @@
 #define INTERNAL_STATE_POWER_UP			(1 << 4)
 #define INTERNAL_STATE_STAND_BY			(1 << 5)
 
-static void _NRF24L01_CEHigh();
-static void _NRF24L01_CELow();
+static void _NRF24L01_CEHigh(tNRF24L01 *psRadio);
+static void _NRF24L01_CELow(tNRF24L01 *psRadio);
+static void _NRF24L01_CEPulse(tNRF24L01 *psRadio);
+static void _NRF24L01_SpinUs(tNRF24L01 *psRadio, unsigned long ulUs);
+
+static void _NRF24L01_CSNHigh(tNRF24L01 *psRadio);
+#ifndef NRF24L01_CONF_HAL
+static void _NRF24L01_CSNLow(tNRF24L01 *psRadio);
+#endif
+
+/* PS: Radio timings from the datasheet, in microseconds */
+#define TPD2STBY_US		1500	// Power down to Standby I (crystal start-up)
+#define TSTBY2A_US		130		// Standby to TX/RX settling
+#define THCE_US			10		// CE high time which starts one TX
+
+/* PS: Reads of a backend clock before a spin gives up, for clocks which only move with the radio */
+#define SPIN_GUARD		100000UL
+
+static void _NRF24L01_StateInit(tNRF24L01 *psRadio);
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL)
+static void _NRF24L01_InitWiring(tNRF24L01 *psRadio, unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph, unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph, unsigned char ucSSIIndex, unsigned long ulSPIBitRate);
+#endif
+#ifdef NRF24L01_CONF_HAL
+static int _NRF24L01_WaitIRQ(tNRF24L01 *psRadio, unsigned long ulTimeoutUs);
+static int _NRF24L01_IRQActive(tNRF24L01 *psRadio);
+#endif
+#if defined(PDLIB_SPI) && !defined(NRF24L01_CONF_HAL)
+static int _NRF24L01_IsSPIClockStable(tNRF24L01 *psRadio);
+#endif
+#ifdef NRF24L01_CONF_FAST_SPI
+static unsigned char _NRF24L01_FastTransaction(tNRF24L01 *psRadio, unsigned char ucCommand, unsigned char *pucTxData, unsigned char *pucRxData, unsigned int uiLength);
+#endif
+static unsigned char _NRF24L01_Transaction(tNRF24L01 *psRadio, unsigned char ucCommand, unsigned char *pucTxData, unsigned char *pucRxData, unsigned int uiLength);
+static void _NRF24L01_StatusUpdate(tNRF24L01 *psRadio, unsigned char ucCommand, unsigned char ucStatus);
+static int _NRF24L01_DecodeDataReady(unsigned char ucStatus, char *pcPipeNo);
+static void _NRF24L01_SetAckAddress(tNRF24L01 *psRadio);
+static int _NRF24L01_SetTarget(tNRF24L01 *psRadio, const unsigned char *pucAddress);
+static void _NRF24L01_ApplyPowerPolicy(tNRF24L01 *psRadio);
+static int _NRF24L01_WaitForTxDone(tNRF24L01 *psRadio);
+static tNRF24L01TxHandle *_NRF24L01_TxAsyncTake(tNRF24L01 *psRadio);
+static void _NRF24L01_TxAsyncComplete(tNRF24L01 *psRadio, tNRF24L01TxHandle *psHandle, int iResult);
+static void _NRF24L01_RegisterUpdate_8(tNRF24L01 *psRadio, unsigned char ucRegister, unsigned char ucClear, unsigned char ucSet);
+static int _NRF24L01_WriteTxPayload(tNRF24L01 *psRadio, unsigned char ucCommand, char *pcData, unsigned int uiLength);
+static int _NRF24L01_NoAckReady(tNRF24L01 *psRadio);
+static int _NRF24L01_SendDataAsync(tNRF24L01 *psRadio, unsigned char ucCommand, char *pcData, unsigned int uiLength, tNRF24L01TxHandle *psHandle, tNRF24L01Callback pfnCallback);
+static void _NRF24L01_BeaconFire(tNRF24L01 *psRadio);
+static void _NRF24L01_BeaconEnd(tNRF24L01 *psRadio);
+
+/* PS: ucBeaconState */
+#define BEACON_IDLE		0
+#define BEACON_TX		1		// A transmission is on air
+#define BEACON_WAIT		2		// Waiting for the period to elapse (NRF24L01_Tick)
+
+/* PS: Registers kept in the RAM shadow (bit n is register n) */
+#define SHADOW_REGISTERS	((1UL << RF24_CONFIG)    | (1UL << RF24_EN_AA)     | (1UL << RF24_EN_RXADDR) |\
+							 (1UL << RF24_SETUP_AW)  | (1UL << RF24_SETUP_RETR)| (1UL << RF24_RF_CH)     |\
+							 (1UL << RF24_RF_SETUP)  | (1UL << RF24_RX_PW_P0)  | (1UL << RF24_RX_PW_P1)  |\
+							 (1UL << RF24_RX_PW_P2)  | (1UL << RF24_RX_PW_P3)  | (1UL << RF24_RX_PW_P4)  |\
+							 (1UL << RF24_RX_PW_P5)  | (1UL << RF24_DYNPD)     | (1UL << RF24_FEATURE))
+
+#define IS_SHADOWED(reg)	(((reg) <= RF24_FEATURE) && (SHADOW_REGISTERS & (1UL << (reg))))
+
+/* PS: Address registers kept in ucAddressShadow, at (reg - RF24_RX_ADDR_P0) */
+#define IS_ADDRESS(reg)		(((reg) >= RF24_RX_ADDR_P0) && ((reg) <= RF24_TX_ADDR))
+#define IS_FULL_ADDRESS(reg)	(((reg) == RF24_RX_ADDR_P0) || ((reg) == RF24_RX_ADDR_P1) || ((reg) == RF24_TX_ADDR))
+
+/* PS: Bytes of an address with a SETUP_AW value (00 is illegal, the module takes it as 3 bytes) */
+#define SETUP_AW_BYTES(aw)	((unsigned int)(((((aw) & 0x03) != 0) ? ((aw) & 0x03) : 1) + 2))
+
+/* PS: Bytes the module holds in an address register, by the SETUP_AW in the shadow */
+#define ADDRESS_WIDTH(psRadio, reg)	(IS_FULL_ADDRESS(reg) ? SETUP_AW_BYTES((psRadio)->ucShadow[RF24_SETUP_AW]) : 1)
+
+static int _NRF24L01_ApplyConfig(tNRF24L01 *psRadio, const tNRF24L01Config *psConfig, unsigned char ucForce);
+static unsigned int _NRF24L01_BatchAdd(unsigned char *pucBatch, unsigned int uiBytes, unsigned char ucCommand, const unsigned char *pucData, unsigned int uiLength);
+static void _NRF24L01_WriteBatch(tNRF24L01 *psRadio, unsigned char *pucBatch, unsigned int uiBytes);
+
+/* PS: Frames of _NRF24L01_ApplyConfig, each is length, command and data: ACTIVATE, the 15 shadowed
+ * registers, three 5 byte and four 1 byte addresses */
+#define CONFIG_BATCH_SIZE	((1 * 3) + (15 * 3) + (3 * 7) + (4 * 3))
+
+#ifdef NRF24L01_CONF_TX_QUEUE
+static int _NRF24L01_QueueData(tNRF24L01 *psRadio, unsigned char ucCommand, char *pcData, unsigned int uiLength);
+static void _NRF24L01_TxQueueRefill(tNRF24L01 *psRadio);
+
+/* PS: One slot more than the depth, so that head == tail only when empty */
+#define TX_QUEUE_SIZE	(NRF24L01_CONF_TX_QUEUE_DEPTH + 1)
+#endif
+
+#ifdef NRF24L01_CONF_TX_STREAM
+static void _NRF24L01_StreamRefill(tNRF24L01 *psRadio);
+
+/* PS: ucStreamState */
+#define STREAM_STOPPED	0
+#define STREAM_RUNNING	1		// Payloads were loaded since the TX FIFO was last seen empty
+#define STREAM_STARVED	2		// TX FIFO seen empty, CE still high
+#endif
+
+#ifdef NRF24L01_CONF_RX_QUEUE
+/* PS: One slot more than the depth, so that head == tail only when empty */
+#define RX_QUEUE_SIZE	(NRF24L01_CONF_RX_QUEUE_DEPTH + 1)
+#endif
+
+#ifdef NRF24L01_CONF_SPI_ENGINE
+#if !defined(NRF24L01_CONF_HAL) && (!defined(PDLIB_SPI) || !defined(PART_LM4F120H5QR))
+#error "NRF24L01_CONF_SPI_ENGINE needs the SSI code of pdlib_spi.c or NRF24L01_CONF_HAL"
+#endif
+
+static int _NRF24L01_EnginePut(tNRF24L01 *psRadio, unsigned char ucData);
+static int _NRF24L01_EngineGet(tNRF24L01 *psRadio, unsigned char *pucData);
+static void _NRF24L01_EngineInt(tNRF24L01 *psRadio, unsigned char ucEnable);
+static void _NRF24L01_EngineStart(tNRF24L01 *psRadio);
+static void _NRF24L01_EngineFill(tNRF24L01 *psRadio);
+#ifdef PART_LM4F120H5QR
+static tBoolean _NRF24L01_EngineMaskIdle(tNRF24L01 *psRadio);
+#endif
+static void _NRF24L01_IRQChainStep(tNRF24L01 *psRadio, tNRF24L01SPIOp *psOp);
+static void _NRF24L01_IRQChainNext(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain, unsigned char ucStatus);
+static void _NRF24L01_IRQChainSubmit(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain, unsigned char ucStep, unsigned char ucCommand, unsigned char *pucTxData, unsigned char *pucRxData, unsigned int uiLength);
+
+/* PS: One slot more than the depth, so that head == tail only when empty */
+#define ENGINE_QUEUE_SIZE	(NRF24L01_CONF_SPI_ENGINE_DEPTH + 1)
+
+/* PS: Bytes in flight, the depth of the SSI FIFOs */
+#define ENGINE_FIFO_DEPTH	8
+
+/* PS: ucStep of tNRF24L01IRQChain, the transaction the chain waits for */
+#define CHAIN_CLEAR		0		// W_REGISTER STATUS clearing the interrupt flags
+#define CHAIN_STATUS	1		// NOP for the pipe of the next payload
+#define CHAIN_WIDTH		2		// R_RX_PL_WID
+#define CHAIN_PAYLOAD	3		// R_RX_PAYLOAD
+#define CHAIN_FLUSH		4		// FLUSH_RX after an invalid width
+#endif
+
+#if defined(PDLIB_SPI) && defined(PDLIB_SPI_CONF_UDMA)
+static void _NRF24L01_DMACommand_Complete(void *pvArg);
+#endif
 
-static void _NRF24L01_CSNHigh();
-static void _NRF24L01_CSNLow();
+#ifdef CYCLE_CLOCK
+static void _NRF24L01_CycleInit(void);
+static unsigned long _NRF24L01_CycleNow(void);
+static unsigned long _NRF24L01_CycleRate(void);
+#endif
 
-static unsigned long g_ulCEPin;
-static unsigned long g_ulCEBase;
-static unsigned long g_ulCSNPin;
-static unsigned long g_ulCSNBase;
+#ifdef NRF24L01_CONF_TRACE
+static void _NRF24L01_Trace(tNRF24L01 *psRadio, unsigned char ucType, unsigned char ucCommand, unsigned int uiLength, unsigned char ucStatus);
 
-static unsigned char g_ucStatus;
+#define TRACE(psRadio, ucType, ucCommand, uiLength, ucStatus)	_NRF24L01_Trace(psRadio, ucType, ucCommand, uiLength, ucStatus)
+#else
+#define TRACE(psRadio, ucType, ucCommand, uiLength, ucStatus)
+#endif
 
-static unsigned int internal_states;
+#ifdef NRF24L01_CONF_PROFILE
+/* PS: Clock and SPI byte count at the start of a profiled call */
+typedef struct
+{
+	unsigned long ulStart;
+	unsigned long long ullBytes;
+}tNRF24L01ProfileMark;
+
+static tNRF24L01ProfileMark _NRF24L01_ProfileStart(tNRF24L01 *psRadio);
+static void _NRF24L01_ProfileEnd(tNRF24L01 *psRadio, unsigned char ucFunction, tNRF24L01ProfileMark *psMark);
+
+/* PS: PROFILE_START goes last in the declarations of a function, PROFILE_END before every return */
+#define PROFILE_START(psRadio)				tNRF24L01ProfileMark sProfileMark = _NRF24L01_ProfileStart(psRadio)
+#define PROFILE_END(psRadio, ucFunction)	_NRF24L01_ProfileEnd(psRadio, ucFunction, &sProfileMark)
+#define PROFILE_BYTES(psRadio, uiBytes)		((psRadio)->ullProfileBytes += (uiBytes))
+#else
+#define PROFILE_START(psRadio)
+#define PROFILE_END(psRadio, ucFunction)
+#define PROFILE_BYTES(psRadio, uiBytes)
+#endif
 
 /* PS:
  * 
  * Function		: 	NRF24L01_Init
  * 
- * Arguments	: 	ulCEBase	:	This is the base of the CE pin
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ulCEBase	:	This is the base of the CE pin
  * 					ulCEPin		:	This is the pin to be used for CE
  * 					ulCEPeriph	:	This is the peripheral bit mask
  * 					ulCSNBase	:	This is the base of the CSN pin
  * 					ulCSNPin	:	This is the pin to be used for CSN
  * 					ulCSNPeriph	:	This is the peripheral bit mask
  * 					ucSSIIndex	:	The index of the SSI module
+ * 					ulSPIBitRate:	SPI bit rate in Hz. Limited to NRF24L01_CONF_SPI_MAX_BITRATE
+ * 									and to what the SSI prescaler can produce from the
+ * 									system clock (see pdlibSPI_SetBitRate).
+ * 									PDLIB_NRF24_SPI_BITRATE_AUTO will probe the fastest
+ * 									stable bit rate (see NRF24L01_CalibrateSPIClock).
  * 
  * Return		: 	None
  * 
@@ -185,242 +464,693 @@ static unsigned int internal_states;
  */
  	
   
-#ifdef PART_LM4F120H5QR
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL)
 
+#ifndef NRF24L01_CONF_STATIC_WIRING
 void
-NRF24L01_Init(	unsigned long ulCEBase,
+NRF24L01_Init(	tNRF24L01 *psRadio,
+				unsigned long ulCEBase,
 				unsigned long ulCEPin,
 				unsigned long ulCEPeriph,
 				unsigned long ulCSNBase,
 				unsigned long ulCSNPin,
 				unsigned long ulCSNPeriph,
-				unsigned char ucSSIIndex)
+				unsigned char ucSSIIndex,
+				unsigned long ulSPIBitRate)
+{
+	_NRF24L01_InitWiring(psRadio, ulCEBase, ulCEPin, ulCEPeriph, ulCSNBase, ulCSNPin, ulCSNPeriph, ucSSIIndex, ulSPIBitRate);
+}
+
+#else
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_InitStatic
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	NRF24L01_Init with the wiring and SPI bit rate of
+ * 					NRF24L01_CONF_WIRING_HEADER (NRF24L01_CONF_STATIC_WIRING).
+ *
+ */
+
+void
+NRF24L01_InitStatic(tNRF24L01 *psRadio)
+{
+	_NRF24L01_InitWiring(psRadio, NRF24L01_CONF_CE_BASE, NRF24L01_CONF_CE_PIN, NRF24L01_CONF_CE_PERIPH,
+						 NRF24L01_CONF_CSN_BASE, NRF24L01_CONF_CSN_PIN, NRF24L01_CONF_CSN_PERIPH,
+						 NRF24L01_CONF_SSI, NRF24L01_CONF_SPI_BITRATE);
+}
+#endif
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_InitWiring
+ *
+ * Arguments	: 	As for NRF24L01_Init
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The body of NRF24L01_Init and NRF24L01_InitStatic. With
+ * 					NRF24L01_CONF_STATIC_WIRING the wiring is not kept in the
+ * 					instance, the pins are driven with constants.
+ *
+ */
+
+static void
+_NRF24L01_InitWiring(	tNRF24L01 *psRadio,
+						unsigned long ulCEBase,
+						unsigned long ulCEPin,
+						unsigned long ulCEPeriph,
+						unsigned long ulCSNBase,
+						unsigned long ulCSNPin,
+						unsigned long ulCSNPeriph,
+						unsigned char ucSSIIndex,
+						unsigned long ulSPIBitRate)
 {
-	internal_states = 0x00;
+	_NRF24L01_StateInit(psRadio);
+
+#ifndef NRF24L01_CONF_STATIC_WIRING
+	psRadio->ucSSI = ucSSIIndex;
+#endif
+
+	if(ulSPIBitRate > NRF24L01_CONF_SPI_MAX_BITRATE)
+	{
+		ulSPIBitRate = NRF24L01_CONF_SPI_MAX_BITRATE;
+	}
 
 	/* PS: Initialize communication */
 #ifdef PDLIB_SPI
-	pdlibSPI_ConfigureSPIInterface(ucSSIIndex);
+	if(PDLIB_NRF24_SPI_BITRATE_AUTO == ulSPIBitRate)
+	{
+		psRadio->ulSPIBitRate = pdlibSPI_ConfigureSPIInterface(ucSSIIndex, PDLIB_SPI_DEFAULT_BITRATE);
+	}else
+	{
+		psRadio->ulSPIBitRate = pdlibSPI_ConfigureSPIInterface(ucSSIIndex, ulSPIBitRate);
+	}
 #endif
 
+#ifndef NRF24L01_CONF_STATIC_WIRING
 	/* PS: Set the CE pin */
-	g_ulCEBase = ulCEBase;
-	g_ulCEPin = ulCEPin;
+	psRadio->ulCEBase = ulCEBase;
+	psRadio->ulCEPin = ulCEPin;
 	
 	/* PS: Set the CSN pin */
-	g_ulCSNBase = ulCSNBase;
-	g_ulCSNPin = ulCSNPin;
+	psRadio->ulCSNBase = ulCSNBase;
+	psRadio->ulCSNPin = ulCSNPin;
+#endif
 
 	/* PS: Configure the CE pin to be GPIO output */
 	ROM_SysCtlPeripheralEnable(ulCEPeriph);
-	ROM_GPIOPinTypeGPIOOutput(g_ulCEBase, g_ulCEPin);
+	ROM_GPIOPinTypeGPIOOutput(ulCEBase, ulCEPin);
 	
-	_NRF24L01_CELow();
+	_NRF24L01_CELow(psRadio);
 
 	/* PS: Configure the CSN pin to be GPIO output */
 	ROM_SysCtlPeripheralEnable(ulCSNPeriph);
 	ROM_GPIOPinTypeGPIOOutput(ulCSNBase, ulCSNPin);
 
-	_NRF24L01_CSNHigh();
+	_NRF24L01_CSNHigh(psRadio);
 
-	NRF24L01_RegisterInit();
+	if(PDLIB_NRF24_SPI_BITRATE_AUTO == ulSPIBitRate)
+	{
+		NRF24L01_CalibrateSPIClock(psRadio, NRF24L01_CONF_SPI_MAX_BITRATE);
+	}
 
-	internal_states |= INTERNAL_STATE_INIT;
+	NRF24L01_RegisterInit(psRadio);
+
+	psRadio->uiInternalStates |= INTERNAL_STATE_INIT;
 }
 
 #endif
 
 
+#ifdef NRF24L01_CONF_HAL
+
 /* PS:
  *
- * Function		: 	NRF24L01_InterruptInit
+ * Function		: 	NRF24L01_InitHAL
  *
- * Arguments	:	None
+ * Arguments	: 	psRadio		:	Radio instance
+ * 					psHAL		:	Backend of the radio (see pdlib_nrf24l01_hal.h)
+ * 					pvContext	:	Context of the backend, passed to every backend function
  *
  * Return		: 	None
  *
- * Description	:	Registers the IRQ pin as an interrupt
+ * Description	: 	Same as NRF24L01_Init for a radio behind a backend. The backend
+ * 					must be ready to use (SPI and pins configured by its own open or
+ * 					init function). The registers are reset to their default values.
  *
  */
 
-#ifdef NRF24L01_CONF_INTERRUPT_PIN
-
-#ifdef PART_LM4F120H5QR
+void
+NRF24L01_InitHAL(tNRF24L01 *psRadio, const tNRF24L01HAL *psHAL, void *pvContext)
+{
+	_NRF24L01_StateInit(psRadio);
 
-void NRF24L01_InterruptInit(unsigned long ulIRQBase,
-							unsigned long ulIRQPin,
-							unsigned long ulIRQPeriph,
-							unsigned long ulInterrupt){
+	psRadio->psHAL = psHAL;
+	psRadio->pvHALContext = pvContext;
 
-	/* PS: Configure the CE pin to be GPIO output */
-	ROM_SysCtlPeripheralEnable(ulIRQPeriph);
+	_NRF24L01_CELow(psRadio);
+	_NRF24L01_CSNHigh(psRadio);
 
-	ROM_GPIOPinTypeGPIOInput(ulIRQBase, ulIRQPin);
-	ROM_GPIOPinIntClear(ulIRQBase, ulIRQPin);
-	ROM_GPIOIntTypeSet(ulIRQBase, ulIRQPin, GPIO_LOW_LEVEL);
-	ROM_GPIOPinIntEnable(ulIRQBase, ulIRQPin);
+	NRF24L01_RegisterInit(psRadio);
 
-	ROM_IntEnable(ulInterrupt);
-	ROM_IntMasterEnable();
+	psRadio->uiInternalStates |= INTERNAL_STATE_INIT;
 }
-#endif
 
-#endif
 
 /* PS:
  *
- * Function		: 	NRF24L01_RegisterInit
+ * Function		: 	NRF24L01_GetTimeUs
  *
- * Arguments	:	None
+ * Arguments	: 	psRadio	:	Radio instance
  *
- * Return		: 	None
+ * Return		: 	Microsecond clock of the backend. ZERO if the backend has no clock.
  *
- * Description	:	This function will reset the CE pin and reset all the registers.
+ * Description	: 	Lets the application time the radio with the same clock as the
+ * 					backend (the simulated clock for a simulated radio).
  *
  */
 
-void
-NRF24L01_RegisterInit()
+unsigned long
+NRF24L01_GetTimeUs(tNRF24L01 *psRadio)
 {
-	unsigned char ucRxAddr1[5] = {0xE7,0xE7,0xE7,0xE7,0xE7};
-	unsigned char ucRxAddr2[5] = {0xC2,0xC2,0xC2,0xC2,0xC2};
-	
-	NRF24L01_FlushTX();
-	NRF24L01_FlushRX();
-
-	_NRF24L01_CELow();
-
-	NRF24L01_RegisterWrite_8(RF24_CONFIG,0x09);
-	NRF24L01_RegisterWrite_8(RF24_EN_AA,0x3F);
-	NRF24L01_RegisterWrite_8(RF24_EN_RXADDR,0x03);
-	NRF24L01_RegisterWrite_8(RF24_SETUP_AW,0x03);
-	NRF24L01_RegisterWrite_8(RF24_SETUP_RETR,0x03);
-	NRF24L01_RegisterWrite_8(RF24_RF_CH,0x02);
-	NRF24L01_RegisterWrite_8(RF24_RF_SETUP,0x0F);
-	NRF24L01_RegisterWrite_8(RF24_STATUS,0x70);
-	NRF24L01_RegisterWrite_8(RF24_CD, 0x00);
-	NRF24L01_RegisterWrite_Multi(RF24_RX_ADDR_P0,ucRxAddr1,5);
-	NRF24L01_RegisterWrite_Multi(RF24_RX_ADDR_P1,ucRxAddr2,5);
-	NRF24L01_RegisterWrite_8(RF24_RX_ADDR_P2,0xC3);
-	NRF24L01_RegisterWrite_8(RF24_RX_ADDR_P3,0xC4);
-	NRF24L01_RegisterWrite_8(RF24_RX_ADDR_P4,0xC5);
-	NRF24L01_RegisterWrite_8(RF24_RX_ADDR_P5,0xC6);
-	NRF24L01_RegisterWrite_Multi(RF24_TX_ADDR,ucRxAddr1,5);
-	NRF24L01_RegisterWrite_8(RF24_RX_PW_P0,0x00);
-	NRF24L01_RegisterWrite_8(RF24_RX_PW_P1,0x00);
-	NRF24L01_RegisterWrite_8(RF24_RX_PW_P2,0x00);
-	NRF24L01_RegisterWrite_8(RF24_RX_PW_P3,0x00);
-	NRF24L01_RegisterWrite_8(RF24_RX_PW_P4,0x00);
-	NRF24L01_RegisterWrite_8(RF24_RX_PW_P5,0x00);
-	NRF24L01_RegisterWrite_8(RF24_DYNPD,0x00);
-	NRF24L01_RegisterWrite_8(RF24_FEATURE,0x00);
+	if(psRadio->psHAL->pfnGetTimeUs)
+	{
+		return psRadio->psHAL->pfnGetTimeUs(psRadio->pvHALContext);
+	}
+
+	return 0;
 }
 
+
 /* PS:
- * 
- * Function		: 	NRF24L01_GetStatus
- * 
- * Arguments	: 	None.
- * 
- * Return		: 	Status register value.
- * 
- * Description	: 	Gets the status register of the module
- * 
+ *
+ * Function		: 	_NRF24L01_WaitIRQ
+ *
+ * Arguments	: 	psRadio		:	Radio instance
+ * 					ulTimeoutUs	:	Time limit, PDLIB_NRF24_HAL_WAIT_FOREVER for none
+ *
+ * Return		: 	1 if IRQ is active (or the backend cannot wait for it), 0 on timeout
+ *
+ * Description	: 	Lets the blocking APIs sleep on the IRQ pin instead of polling
+ * 					STATUS over SPI.
+ *
  */
 
-unsigned char 
-NRF24L01_GetStatus()
+static int
+_NRF24L01_WaitIRQ(tNRF24L01 *psRadio, unsigned long ulTimeoutUs)
 {
-	NRF24L01_RegisterRead_8(RF24_NOP);
-	return g_ucStatus;
+	if(psRadio->psHAL->pfnWaitIRQ)
+	{
+		return psRadio->psHAL->pfnWaitIRQ(psRadio->pvHALContext, ulTimeoutUs);
+	}
+
+	return 1;
 }
 
+
 /* PS:
- * 
- * Function		: 	NRF24L01_SetAirDataRate
- * 
- * Arguments	: 	ucDataRate	:	1 for 1 Mbps
- * 									2 for 2 Mbps
- * 
- * Return		: 	None
- * 
- * Description	: 	Sets the air data rate (default 2Mbps)
- * 
+ *
+ * Function		: 	_NRF24L01_IRQActive
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	1 if IRQ is known to be active, 0 if it is not or the backend
+ * 					cannot read it
+ *
+ * Description	: 	IRQ active means a flag is already set, so a write clearing it
+ * 					cannot lose one which is set during the transaction.
+ *
  */
- 
-void
-NRF24L01_SetAirDataRate(unsigned char ucDataRate)
-{
-	unsigned char ucCurrentVal = NRF24L01_RegisterRead_8(RF24_RF_SETUP);
 
-	ucDataRate--;	// 0 for 1 Mbps, 1 for 2 Mbps
-
-	if(ucDataRate)
-	{
-		ucCurrentVal |= (ucDataRate << 3);
-	}else
+static int
+_NRF24L01_IRQActive(tNRF24L01 *psRadio)
+{
+	if(psRadio->psHAL->pfnGetIRQ)
 	{
-		ucCurrentVal &= ~(ucDataRate << 3);
+		return psRadio->psHAL->pfnGetIRQ(psRadio->pvHALContext);
 	}
-	
-	NRF24L01_RegisterWrite_8(RF24_RF_SETUP, ucCurrentVal);
+
+	return 0;
 }
- 
- 
- 
+
+#endif
+
+
 /* PS:
- * 
- * Function		: 	NRF24L01_SetRFChannel
- * 
- * Arguments	: 	ucRFChannel	:	RF channel value (only 0:6 bits valid)
- * 
+ *
+ * Function		: 	_NRF24L01_StateInit
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
  * Return		: 	None
- * 
- * Description	: 	Sets the RF channel frequency based on the below
- * 					formula,
- * 						2400 + ucRFChannel (MHz)
- * 
+ *
+ * Description	: 	Resets the driver state of the instance. Does not touch the radio.
+ *
  */
- 
-void
-NRF24L01_SetRFChannel(unsigned char ucRFChannel)
+
+static void
+_NRF24L01_StateInit(tNRF24L01 *psRadio)
 {
-	NRF24L01_RegisterWrite_8(RF24_RF_CH, ucRFChannel);
+	psRadio->uiInternalStates = 0x00;
+
+	NRF24L01_SetPowerPolicy(psRadio, NRF24L01_CONF_POWER_POLICY, 0);
+
+	psRadio->psTxHandle = NULL;
+	psRadio->ucBeaconState = BEACON_IDLE;
+
+#ifdef NRF24L01_CONF_TRANSACTION_STATS
+	NRF24L01_ResetTransactionCount(psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_PROFILE
+	NRF24L01_ResetProfile(psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_TRACE
+	NRF24L01_TraceReset(psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_TX_QUEUE
+	psRadio->uiTxQueueHead = 0;
+	psRadio->uiTxQueueTail = 0;
+	psRadio->ucTxQueueActive = 0;
+	psRadio->ucTxQueueFifo = 0;
+	psRadio->ucTxQueueRetries = 0;
+	NRF24L01_ResetTxQueueStats(psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_TX_STREAM
+	psRadio->ucStreamState = STREAM_STOPPED;
+	psRadio->uiStreamHead = 0;
+	psRadio->uiStreamTail = 0;
+	NRF24L01_ResetStreamStats(psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_RX_QUEUE
+	psRadio->uiRxQueueHead = 0;
+	psRadio->uiRxQueueTail = 0;
+	NRF24L01_ResetRxQueueStats(psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_SPI_ENGINE
+	psRadio->uiEngineHead = 0;
+	psRadio->uiEngineTail = 0;
+	psRadio->ucEngineBusy = 0;
+	psRadio->ucBusHeld = 0;
+	psRadio->uiEngineTx = 0;
+	psRadio->uiEngineRx = 0;
+	NRF24L01_ResetSPIEngineStats(psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_ADDRESS_BOOK
+	NRF24L01_AddressBookClear(psRadio);
+#endif
 }
- 
- 
- 
+
+
 /* PS:
- * 
- * Function		: 	NRF24L01_SetPAGain
- * 
- * Arguments	: 	ucPAGain	: Only bits 0:1 are valid.
- * 
- * Return		: 	None
- * 
- * Description	: 	Sets the power amplifier gain based on the ucPAGain.
- * 					0 = 0 dBm (default)
- * 					-6 = -6 dBm
- * 					-12 = -12 dBm
- * 					-18 = -18 dBm
- * 
+ *
+ * Function		: 	NRF24L01_CalibrateSPIClock
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ulMaxBitRate	:	Highest SPI bit rate to try, in Hz. Limited to
+ * 										NRF24L01_CONF_SPI_MAX_BITRATE.
+ *
+ * Return		: 	The selected SPI bit rate in Hz. ZERO if no bit rate down to
+ * 					PDLIB_SPI_DEFAULT_BITRATE was stable, the SPI then runs at
+ * 					PDLIB_SPI_DEFAULT_BITRATE. Always ZERO with NRF24L01_CONF_HAL.
+ *
+ * Description	: 	Starting from ulMaxBitRate, the bit rate is lowered in 1/8 steps
+ * 					until NRF24L01_CONF_SPI_CALIBRATION_ROUNDS write/read-back rounds of
+ * 					the TX address register all succeed. The TX address is restored
+ * 					afterwards.
+ *
+ * 					Signal integrity depends on the wiring, so this is worth running on
+ * 					every board rather than assuming the radio limit is reachable.
+ *
  */
- 
-void
-NRF24L01_SetPAGain(int iPAGain)
+
+unsigned long
+NRF24L01_CalibrateSPIClock(tNRF24L01 *psRadio, unsigned long ulMaxBitRate)
 {
-	unsigned char ucCurrentVal = NRF24L01_RegisterRead_8(RF24_RF_SETUP);
+	unsigned long ulStableBitRate = 0;
+#if defined(PDLIB_SPI) && !defined(NRF24L01_CONF_HAL)
+	unsigned char ucSavedAddr[5];
+	unsigned long ulBitRate;
+	unsigned long ulActualBitRate;
 
-	if(iPAGain < -18)
-	{
-		iPAGain = -18;
-	}else if(iPAGain > 0)
+	if((0 == ulMaxBitRate) || (ulMaxBitRate > NRF24L01_CONF_SPI_MAX_BITRATE))
 	{
-		iPAGain = 0;
+		ulMaxBitRate = NRF24L01_CONF_SPI_MAX_BITRATE;
 	}
 
-	 /* PS:
-	  * 				11 = 0 dBm (default)
+	/* PS: Read the TX address at a known good rate so that it can be restored */
+	pdlibSPI_SetBitRate(RADIO_SSI(psRadio), PDLIB_SPI_DEFAULT_BITRATE);
+	NRF24L01_RegisterRead_Multi(psRadio, RF24_TX_ADDR, ucSavedAddr, 5);
+
+	ulBitRate = ulMaxBitRate;
+
+	do
+	{
+		if(ulBitRate < PDLIB_SPI_DEFAULT_BITRATE)
+		{
+			ulBitRate = PDLIB_SPI_DEFAULT_BITRATE;
+		}
+
+		ulActualBitRate = pdlibSPI_SetBitRate(RADIO_SSI(psRadio), ulBitRate);
+
+		if(_NRF24L01_IsSPIClockStable(psRadio))
+		{
+			ulStableBitRate = ulActualBitRate;
+			break;
+		}
+
+		ulBitRate = (ulActualBitRate / 8) * 7;
+
+	}while(ulActualBitRate > PDLIB_SPI_DEFAULT_BITRATE);
+
+	if(0 == ulStableBitRate)
+	{
+		/* PS: Nothing qualified, back to the rate the TX address was read at */
+		ulActualBitRate = pdlibSPI_SetBitRate(RADIO_SSI(psRadio), PDLIB_SPI_DEFAULT_BITRATE);
+	}
+
+	psRadio->ulSPIBitRate = ulActualBitRate;
+
+	NRF24L01_RegisterWrite_Multi(psRadio, RF24_TX_ADDR, ucSavedAddr, 5);
+#else
+	(void)psRadio;
+	(void)ulMaxBitRate;
+#endif
+
+	return ulStableBitRate;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetSPIBitRate
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	Current SPI bit rate in Hz
+ *
+ * Description	: 	Returns the bit rate selected by NRF24L01_Init or
+ * 					NRF24L01_CalibrateSPIClock.
+ *
+ */
+
+unsigned long
+NRF24L01_GetSPIBitRate(tNRF24L01 *psRadio)
+{
+	return psRadio->ulSPIBitRate;
+}
+
+
+#if defined(PDLIB_SPI) && !defined(NRF24L01_CONF_HAL)
+/* PS:
+ *
+ * Function		: 	_NRF24L01_IsSPIClockStable
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	1 if all the write/read-back rounds succeeded, 0 otherwise
+ *
+ * Description	: 	Writes a different pattern to the TX address register in every
+ * 					round and reads it back. The MSB of the status register is always
+ * 					0, so a set MSB means MISO did not settle either.
+ *
+ */
+
+static int
+_NRF24L01_IsSPIClockStable(tNRF24L01 *psRadio)
+{
+	unsigned char ucPattern[5];
+	unsigned char ucReadBack[5];
+	int iRound;
+	int i;
+
+	for(iRound = 0; iRound < NRF24L01_CONF_SPI_CALIBRATION_ROUNDS; iRound++)
+	{
+		for(i = 0; i < 5; i++)
+		{
+			ucPattern[i] = (unsigned char)(((iRound + i) & 0x01) ? 0xAA : 0x55) ^ (unsigned char)(iRound * 0x11 + i);
+		}
+
+		NRF24L01_RegisterWrite_Multi(psRadio, RF24_TX_ADDR, ucPattern, 5);
+		NRF24L01_RegisterRead_Multi(psRadio, RF24_TX_ADDR, ucReadBack, 5);
+
+		if(psRadio->ucStatus & BIT7)
+		{
+			return 0;
+		}
+
+		for(i = 0; i < 5; i++)
+		{
+			if(ucPattern[i] != ucReadBack[i])
+			{
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+#endif
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_InterruptInit
+ *
+ * Arguments	:	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	:	Registers the IRQ pin as an interrupt
+ *
+ */
+
+#ifdef NRF24L01_CONF_INTERRUPT_PIN
+
+#ifdef PART_LM4F120H5QR
+
+void NRF24L01_InterruptInit(tNRF24L01 *psRadio,
+							unsigned long ulIRQBase,
+							unsigned long ulIRQPin,
+							unsigned long ulIRQPeriph,
+							unsigned long ulInterrupt){
+
+	/* PS: The IRQ pin is not kept in the instance, the application routes its interrupt to the radio */
+	(void)psRadio;
+
+	/* PS: Configure the CE pin to be GPIO output */
+	ROM_SysCtlPeripheralEnable(ulIRQPeriph);
+
+	ROM_GPIOPinTypeGPIOInput(ulIRQBase, ulIRQPin);
+	ROM_GPIOPinIntClear(ulIRQBase, ulIRQPin);
+	ROM_GPIOIntTypeSet(ulIRQBase, ulIRQPin, GPIO_LOW_LEVEL);
+	ROM_GPIOPinIntEnable(ulIRQBase, ulIRQPin);
+
+	ROM_IntEnable(ulInterrupt);
+	ROM_IntMasterEnable();
+}
+
+#ifdef NRF24L01_CONF_STATIC_WIRING
+/* PS:
+ *
+ * Function		: 	NRF24L01_InterruptInitStatic
+ *
+ * Arguments	:	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	:	NRF24L01_InterruptInit with the IRQ pin of NRF24L01_CONF_WIRING_HEADER
+ *
+ */
+
+void
+NRF24L01_InterruptInitStatic(tNRF24L01 *psRadio)
+{
+	NRF24L01_InterruptInit(psRadio, NRF24L01_CONF_IRQ_BASE, NRF24L01_CONF_IRQ_PIN, NRF24L01_CONF_IRQ_PERIPH,
+						   NRF24L01_CONF_IRQ_INT);
+}
+#endif
+#endif
+
+#endif
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RegisterInit
+ *
+ * Arguments	:	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	:	This function will reset the CE pin and reset all the registers
+ * 					(see NRF24L01_GetDefaultConfig), back-to-back in one batch.
+ * 					The register shadow is loaded with the same values.
+ *
+ */
+
+void
+NRF24L01_RegisterInit(tNRF24L01 *psRadio)
+{
+	tNRF24L01Config sConfig;
+
+	NRF24L01_FlushTX(psRadio);
+	NRF24L01_FlushRX(psRadio);
+
+	_NRF24L01_CELow(psRadio);
+
+	/* PS: Nothing is known about the registers yet, all of them are written */
+	NRF24L01_GetDefaultConfig(&sConfig);
+	_NRF24L01_ApplyConfig(psRadio, &sConfig, 1);
+
+	NRF24L01_RegisterWrite_8(psRadio, RF24_STATUS, 0x70);
+}
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_GetStatus
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 
+ * Return		: 	Status register value.
+ * 
+ * Description	: 	Reads the status register of the module. This costs one SPI
+ * 					transaction, use NRF24L01_GetLastStatus if the status clocked out
+ * 					by the previous transaction is recent enough.
+ * 
+ */
+
+unsigned char 
+NRF24L01_GetStatus(tNRF24L01 *psRadio)
+{
+	PROFILE_START(psRadio);
+
+	_NRF24L01_Transaction(psRadio, RF24_NOP, NULL, NULL, 0);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_GET_STATUS);
+
+	return psRadio->ucStatus;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetLastStatus
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pulSequence [out]	:	Sequence number of the returned status (can be NULL)
+ *
+ * Return		: 	Status register value captured by the last SPI transaction.
+ *
+ * Description	: 	Every SPI transaction clocks out the status register with the
+ * 					command byte. This returns that value without talking to the
+ * 					module. The sequence number is incremented on every capture, so
+ * 					comparing two sequence numbers tells how old a status is.
+ *
+ * 					The interrupt flags are cleared in this copy when the driver
+ * 					clears them, and the pipe number is set to 'RX FIFO empty' after
+ * 					a payload is read, so that a stale copy never reports data.
+ *
+ */
+
+unsigned char
+NRF24L01_GetLastStatus(tNRF24L01 *psRadio, unsigned long *pulSequence)
+{
+	if(pulSequence)
+	{
+		*pulSequence = psRadio->ulStatusSequence;
+	}
+
+	return psRadio->ucStatus;
+}
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_SetAirDataRate
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucDataRate	:	1 for 1 Mbps
+ * 									2 for 2 Mbps
+ * 
+ * Return		: 	None
+ * 
+ * Description	: 	Sets the air data rate (default 2Mbps)
+ * 
+ */
+ 
+void
+NRF24L01_SetAirDataRate(tNRF24L01 *psRadio, unsigned char ucDataRate)
+{
+	// 0 for 1 Mbps, 1 for 2 Mbps
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_RF_SETUP, RF24_RF_DR, ((1 == ucDataRate) ? 0 : RF24_RF_DR));
+}
+ 
+ 
+ 
+/* PS:
+ * 
+ * Function		: 	NRF24L01_SetRFChannel
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucRFChannel	:	RF channel value (only 0:6 bits valid)
+ * 
+ * Return		: 	None
+ * 
+ * Description	: 	Sets the RF channel frequency based on the below
+ * 					formula,
+ * 						2400 + ucRFChannel (MHz)
+ * 
+ */
+ 
+void
+NRF24L01_SetRFChannel(tNRF24L01 *psRadio, unsigned char ucRFChannel)
+{
+	NRF24L01_RegisterWrite_8(psRadio, RF24_RF_CH, (ucRFChannel & 0x7F));
+}
+ 
+ 
+ 
+/* PS:
+ * 
+ * Function		: 	NRF24L01_SetPAGain
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucPAGain	: Only bits 0:1 are valid.
+ * 
+ * Return		: 	None
+ * 
+ * Description	: 	Sets the power amplifier gain based on the ucPAGain.
+ * 					0 = 0 dBm (default)
+ * 					-6 = -6 dBm
+ * 					-12 = -12 dBm
+ * 					-18 = -18 dBm
+ * 
+ */
+ 
+void
+NRF24L01_SetPAGain(tNRF24L01 *psRadio, int iPAGain)
+{
+	if(iPAGain < -18)
+	{
+		iPAGain = -18;
+	}else if(iPAGain > 0)
+	{
+		iPAGain = 0;
+	}
+
+	 /* PS:
+	  * 				11 = 0 dBm (default)
 	  *					10 = -6 dBm
 	  *					01 = -12 dBm
 	  *					00 = -18 dBm
@@ -428,23 +1158,16 @@ NRF24L01_SetPAGain(int iPAGain)
 
 	iPAGain = 3 - (-1*(iPAGain) / 6);
 
-	if(ucCurrentVal)
-	{
-		ucCurrentVal |= ((iPAGain && 0x03) << 1);
-	}else
-	{
-		ucCurrentVal &= ~((iPAGain && 0x03) << 1);
-	}
-	
-	NRF24L01_RegisterWrite_8(RF24_RF_SETUP, ucCurrentVal);
-} 
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_RF_SETUP, (0x03 << 1), ((iPAGain & 0x03) << 1));
+}
  
  
 /* PS:
  * 
  * Function		: 	NRF24L01_SetLNAGain
  * 
- * Arguments	: 	ucLNAGain	:	0 - Disable LNA gain
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucLNAGain	:	0 - Disable LNA gain
  * 									1 - Enable LNA gain
  * 
  * Return		: 	None
@@ -454,19 +1177,9 @@ NRF24L01_SetPAGain(int iPAGain)
  */
  
 void
-NRF24L01_SetLNAGain(unsigned char ucLNAGain)
+NRF24L01_SetLNAGain(tNRF24L01 *psRadio, unsigned char ucLNAGain)
 {
-	unsigned char ucCurrentVal = NRF24L01_RegisterRead_8(RF24_RF_SETUP);
-	
-	if(ucCurrentVal)
-	{
-		ucCurrentVal |= (ucLNAGain << 0);
-	}else
-	{
-		ucCurrentVal &= ~(ucLNAGain << 0);
-	}
-
-	NRF24L01_RegisterWrite_8(RF24_RF_SETUP, ucCurrentVal);
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_RF_SETUP, RF24_LNA_HCURR, (ucLNAGain ? RF24_LNA_HCURR : 0));
 }
 
 
@@ -474,26 +1187,20 @@ NRF24L01_SetLNAGain(unsigned char ucLNAGain)
  *
  * Function		: 	NRF24L01_SetARC
  *
- * Arguments	: 	val			:	Minimum is 0(disbaled), Maximum is 15.
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					val			:	Minimum is 0(disbaled), Maximum is 15.
  *
  * Return		: 	None
  *
  * Description	: 	Set automatic retransmission count.
  *
  */
-void NRF24L01_SetARC(unsigned char val){
-	unsigned char cur_val = 0;
-
+void NRF24L01_SetARC(tNRF24L01 *psRadio, unsigned char val){
 	if(val > 15){
 		val = 15;
 	}
 
-	val &= 0x0F;
-
-	cur_val = NRF24L01_RegisterRead_8(RF24_SETUP_RETR);
-	cur_val &= 0xF0;
-	cur_val |= val;
-	NRF24L01_RegisterWrite_8(RF24_SETUP_RETR, cur_val);
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_SETUP_RETR, 0x0F, (val & 0x0F));
 }
 
 
@@ -501,7 +1208,8 @@ void NRF24L01_SetARC(unsigned char val){
  *
  * Function		: 	NRF24L01_SetARD
  *
- * Arguments	: 	usVal		:	Minimum is 250, Maximum is 4000. (in microseconds)
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					usVal		:	Minimum is 250, Maximum is 4000. (in microseconds)
  *
  * Return		: 	None
  *
@@ -509,13 +1217,14 @@ void NRF24L01_SetARC(unsigned char val){
  * 					a multiple of 250. It will be rounded up to the nearest 250 multiple.
  *
  */
-void NRF24L01_SetARD(unsigned short usVal){
+void NRF24L01_SetARD(tNRF24L01 *psRadio, unsigned short usVal){
 
 	unsigned char reg_val = 0;
-	unsigned char cur_val = 0;
 
 	if(usVal < 250){
 		usVal = 250;
+	}else if(usVal > 4000){
+		usVal = 4000;
 	}
 
 	// 250 - 0x0000
@@ -526,10 +1235,7 @@ void NRF24L01_SetARD(unsigned short usVal){
 
 	reg_val = ((usVal << 4) & 0xF0);
 
-	cur_val = NRF24L01_RegisterRead_8(RF24_SETUP_RETR);
-	cur_val &= 0x0F;
-	cur_val |= reg_val;
-	NRF24L01_RegisterWrite_8(RF24_SETUP_RETR, cur_val);
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_SETUP_RETR, 0xF0, reg_val);
 }
 
 
@@ -537,14 +1243,15 @@ void NRF24L01_SetARD(unsigned short usVal){
  *
  * Function		: 	NRF24L01_SetAddressWidth
  *
- * Arguments	: 	ucVal		:	Minimum 3, Maximum 5
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucVal		:	Minimum 3, Maximum 5
  *
  * Return		: 	None
  *
  * Description	: 	Set the address width for TX/RX address
  *
  */
-void NRF24L01_SetAddressWidth(unsigned char ucVal){
+void NRF24L01_SetAddressWidth(tNRF24L01 *psRadio, unsigned char ucVal){
 	unsigned char ucWidth = 3;
 
 	if(ucVal > 5){
@@ -561,7 +1268,7 @@ void NRF24L01_SetAddressWidth(unsigned char ucVal){
 
 	ucWidth -= 2;
 
-	NRF24L01_RegisterWrite_8(RF24_SETUP_AW, ucWidth);
+	NRF24L01_RegisterWrite_8(psRadio, RF24_SETUP_AW, ucWidth);
 }
 
 
@@ -570,7 +1277,7 @@ void NRF24L01_SetAddressWidth(unsigned char ucVal){
  * 
  * Function		: 	NRF24L01_PowerDown
  * 
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  * 
  * Return		: 	None
  * 
@@ -579,23 +1286,20 @@ void NRF24L01_SetAddressWidth(unsigned char ucVal){
  */
  
 void
-NRF24L01_PowerDown()
+NRF24L01_PowerDown(tNRF24L01 *psRadio)
 {
-	unsigned char ucCurrentVal = NRF24L01_RegisterRead_8(RF24_CONFIG);
-	ucCurrentVal &= (~RF24_PWR_UP);
-	
-	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucCurrentVal);
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_CONFIG, RF24_PWR_UP, 0);
 	
-	_NRF24L01_CELow();
+	_NRF24L01_CELow(psRadio);
 
-	internal_states &= (~INTERNAL_STATE_POWER_UP);
+	psRadio->uiInternalStates &= (~INTERNAL_STATE_POWER_UP);
 }
 
 /* PS:
  * 
  * Function		: 	NRF24L01_PowerUp
  * 
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  * 
  * Return		: 	None
  * 
@@ -604,35 +1308,292 @@ NRF24L01_PowerDown()
  */
  
 void
-NRF24L01_PowerUp()
+NRF24L01_PowerUp(tNRF24L01 *psRadio)
 {
-	unsigned char ucCurrentVal = NRF24L01_RegisterRead_8(RF24_CONFIG);
-	ucCurrentVal |= (RF24_PWR_UP);
-	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucCurrentVal);
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_CONFIG, 0, RF24_PWR_UP);
+
+	/* PS: Every power down drops CE, so out of it the module is in Standby I */
+	if(0 == (psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP))
+	{
+		psRadio->uiInternalStates |= INTERNAL_STATE_STAND_BY;
+	}
 
-	internal_states |= INTERNAL_STATE_POWER_UP;
+	psRadio->uiInternalStates |= INTERNAL_STATE_POWER_UP;
 }
 
 
 /* PS:
- * 
- * Function		: 	NRF24L01_FlushTX
- * 
- * Arguments	: 	None
- * 
+ *
+ * Function		: 	NRF24L01_SetPowerPolicy
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucPolicy		:	PDLIB_NRF24_POWER_ALWAYS_ON
+ * 										PDLIB_NRF24_POWER_IDLE_TIMEOUT
+ * 										PDLIB_NRF24_POWER_DOWN_AFTER_TX
+ * 					ulIdleTimeoutMs	:	Idle time before power down, in ms (only for
+ * 										PDLIB_NRF24_POWER_IDLE_TIMEOUT)
+ *
  * Return		: 	None
+ *
+ * Description	: 	Selects what happens when a TX is over (NRF24L01_DisableTxMode,
+ * 					NRF24L01_AttemptTx).
+ *
+ * 					Coming out of Power Down costs TPD2STBY_US (1.5 ms) before the
+ * 					next packet can go on air, which is more than the packet itself at
+ * 					both air data rates. PDLIB_NRF24_POWER_ALWAYS_ON avoids it at the
+ * 					cost of the Standby I current. PDLIB_NRF24_POWER_IDLE_TIMEOUT
+ * 					keeps bursts fast and powers down when traffic stops, it needs
+ * 					NRF24L01_Tick to be called. See NRF24L01_EstimateTxTime.
+ *
+ */
+
+void
+NRF24L01_SetPowerPolicy(tNRF24L01 *psRadio, unsigned char ucPolicy, unsigned long ulIdleTimeoutMs)
+{
+	if(ucPolicy > PDLIB_NRF24_POWER_DOWN_AFTER_TX)
+	{
+		ucPolicy = PDLIB_NRF24_POWER_ALWAYS_ON;
+	}
+
+	psRadio->ucPowerPolicy = ucPolicy;
+	psRadio->ulPowerIdleTimeout = ulIdleTimeoutMs;
+	psRadio->ulPowerIdleTime = 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_Tick
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ulElapsedMs	:	Time since the previous call, in ms
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Time base of the driver. With PDLIB_NRF24_POWER_IDLE_TIMEOUT the
+ * 					module is powered down once it has been in Standby I for the idle
+ * 					timeout. An asynchronous TX is timed out after
+ * 					NRF24L01_CONF_TX_TIMEOUT_MS, and without NRF24L01_CONF_INTERRUPT_PIN
+ * 					its completion is checked here (one SPI transaction per tick).
+ * 					The period of a beacon (NRF24L01_BeaconStart) is counted here.
+ *
+ * 					This can talk to the module, so call it from the same context as
+ * 					the other APIs (eg. the main loop or a periodic timer). With
+ * 					NRF24L01_CONF_INTERRUPT_PIN the IRQ handler completes the same TX
+ * 					and beacon transmissions: on the Stellaris the interrupts are
+ * 					masked while this runs, with a NRF24L01_CONF_HAL backend the IRQ
+ * 					handler must not run at the same time (eg. call both from one
+ * 					thread).
+ *
+ */
+
+void
+NRF24L01_Tick(tNRF24L01 *psRadio, unsigned long ulElapsedMs)
+{
+	tNRF24L01TxHandle *psHandle;
+#if defined(NRF24L01_CONF_INTERRUPT_PIN) && defined(PART_LM4F120H5QR)
+	tBoolean bMasked;
+#endif
+	PROFILE_START(psRadio);
+
+#if defined(NRF24L01_CONF_INTERRUPT_PIN) && defined(PART_LM4F120H5QR)
+	/* PS: The IRQ handler neither completes the TX nor moves the beacon on under us, nor
+	 * starts a SPI frame while this one holds CSN low. The SPI engine finishes its descriptor
+	 * first, the SSI interrupt is masked as well from here on */
+#ifdef NRF24L01_CONF_SPI_ENGINE
+	bMasked = _NRF24L01_EngineMaskIdle(psRadio);
+#else
+	bMasked = ROM_IntMasterDisable();
+#endif
+#endif
+
+#ifndef NRF24L01_CONF_INTERRUPT_PIN
+	if(psRadio->psTxHandle)
+	{
+		/* PS: No IRQ pin, check the TX flags once per tick */
+		NRF24L01_TxAsyncService(psRadio);
+	}
+#endif
+
+	psHandle = psRadio->psTxHandle;
+
+	if(psHandle)
+	{
+		psHandle->ulElapsedMs += ulElapsedMs;
+
+		if(psHandle->ulElapsedMs >= NRF24L01_CONF_TX_TIMEOUT_MS)
+		{
+			/* PS: Only the one who takes the handle completes it */
+			psHandle = _NRF24L01_TxAsyncTake(psRadio);
+
+			if(psHandle)
+			{
+				_NRF24L01_TxAsyncComplete(psRadio, psHandle, PDLIB_NRF24_TX_TIMEOUT);
+			}
+		}
+	}
+
+	if(BEACON_IDLE != psRadio->ucBeaconState)
+	{
+#ifndef NRF24L01_CONF_INTERRUPT_PIN
+		if(BEACON_TX == psRadio->ucBeaconState)
+		{
+			NRF24L01_BeaconService(psRadio);
+		}
+#endif
+
+		psRadio->ulBeaconElapsedMs += ulElapsedMs;
+
+		if((BEACON_WAIT == psRadio->ucBeaconState) && (psRadio->ulBeaconElapsedMs >= psRadio->ulBeaconPeriodMs))
+		{
+			_NRF24L01_BeaconFire(psRadio);
+		}
+	}
+
+	/* PS: A beacon waiting for its period is not idle */
+	if((PDLIB_NRF24_POWER_IDLE_TIMEOUT == psRadio->ucPowerPolicy) &&
+	   (BEACON_IDLE == psRadio->ucBeaconState) &&
+	   (psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP) &&
+	   (psRadio->uiInternalStates & INTERNAL_STATE_STAND_BY))
+	{
+		psRadio->ulPowerIdleTime += ulElapsedMs;
+
+		if(psRadio->ulPowerIdleTime >= psRadio->ulPowerIdleTimeout)
+		{
+			NRF24L01_PowerDown(psRadio);
+		}
+	}
+
+#if defined(NRF24L01_CONF_INTERRUPT_PIN) && defined(PART_LM4F120H5QR)
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#endif
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_TICK);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EstimateTxTime
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucPolicy	:	Power policy to estimate for (PDLIB_NRF24_POWER_*)
+ * 					uiLength	:	Payload length in bytes
+ *
+ * Return		: 	Estimated time per packet in microseconds
+ *
+ * Description	: 	Latency model of one packet sent back to back with the current
+ * 					settings (SPI bit rate, air data rate, address width, CRC and
+ * 					auto ack of pipe 0), without retransmissions:
+ *
+ * 						SPI upload		(1 + uiLength) bytes at the SPI bit rate (left
+ * 										out with a NRF24L01_CONF_HAL backend, which
+ * 										does not tell its bit rate)
+ * 						Power up		TPD2STBY_US if the policy powers down between
+ * 										packets (PDLIB_NRF24_POWER_IDLE_TIMEOUT is
+ * 										assumed to see packets within the timeout)
+ * 						TX settling		TSTBY2A_US
+ * 						Packet on air	preamble, address, 9 bit packet control field,
+ * 										payload and CRC at the air data rate
+ * 						ACK				TSTBY2A_US and an empty packet, if auto ack is
+ * 										enabled on pipe 0
+ *
+ * 					Eg. 32 bytes at 2 Mbps with ACK, 4 MHz SPI and the other settings
+ * 					from NRF24L01_RegisterInit: about 0.52 ms per packet with
+ * 					PDLIB_NRF24_POWER_ALWAYS_ON and 2.02 ms with
+ * 					PDLIB_NRF24_POWER_DOWN_AFTER_TX.
+ *
+ */
+
+unsigned long
+NRF24L01_EstimateTxTime(tNRF24L01 *psRadio, unsigned char ucPolicy, unsigned int uiLength)
+{
+	unsigned long ulTime = 0;
+	unsigned long ulBitsPerUs;
+	unsigned long ulOverheadBits;
+	unsigned char ucCRCBytes = 0;
+
+	/* PS: Air data rate in bits per microsecond */
+	ulBitsPerUs = ((psRadio->ucShadow[RF24_RF_SETUP] & RF24_RF_DR) ? 2 : 1);
+
+	if(psRadio->ucShadow[RF24_CONFIG] & RF24_EN_CRC)
+	{
+		ucCRCBytes = ((psRadio->ucShadow[RF24_CONFIG] & RF24_CRCO) ? 2 : 1);
+	}
+
+	/* PS: Preamble, address, CRC and the packet control field */
+	ulOverheadBits = (8 * (1 + (psRadio->ucShadow[RF24_SETUP_AW] & 0x03) + 2 + ucCRCBytes)) + 9;
+
+	if(psRadio->ulSPIBitRate > 0)
+	{
+		ulTime += ((8000000UL / (psRadio->ulSPIBitRate / 100)) * (1 + uiLength)) / 100;
+	}
+
+	if(PDLIB_NRF24_POWER_DOWN_AFTER_TX == ucPolicy)
+	{
+		ulTime += TPD2STBY_US;
+	}
+
+	ulTime += TSTBY2A_US;
+	ulTime += ((ulOverheadBits + (8 * uiLength)) / ulBitsPerUs);
+
+	if(psRadio->ucShadow[RF24_EN_AA] & RF24_ENAA_P0)
+	{
+		ulTime += TSTBY2A_US;
+		ulTime += (ulOverheadBits / ulBitsPerUs);
+	}
+
+	return ulTime;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_ApplyPowerPolicy
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Called when a TX is over and the module is in Standby I.
+ *
+ */
+
+static void
+_NRF24L01_ApplyPowerPolicy(tNRF24L01 *psRadio)
+{
+	psRadio->ulPowerIdleTime = 0;
+
+	if(PDLIB_NRF24_POWER_DOWN_AFTER_TX == psRadio->ucPowerPolicy)
+	{
+		NRF24L01_PowerDown(psRadio);
+	}
+}
+
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_FlushTX
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 
+ * Return		: 	None
+ * 
+ * Description	: 	Flush tx.
  * 
- * Description	: 	Flush tx.
- * 
  */
  
 void
-NRF24L01_FlushTX()
+NRF24L01_FlushTX(tNRF24L01 *psRadio)
 {
-	NRF24L01_SendCommand(RF24_FLUSH_TX, NULL, 0);
-#ifdef PDLIB_DEBUG
-	PrintString("TX buffer flushed \n\r");
-#endif
+	PROFILE_START(psRadio);
+
+	NRF24L01_SendCommand(psRadio, RF24_FLUSH_TX, NULL, 0);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_FLUSH_TX);
 }
 
 
@@ -640,7 +1601,7 @@ NRF24L01_FlushTX()
  * 
  * Function		: 	NRF24L01_FlushRX
  * 
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  * 
  * Return		: 	None
  * 
@@ -649,9 +1610,13 @@ NRF24L01_FlushTX()
  */
  
 void
-NRF24L01_FlushRX()
+NRF24L01_FlushRX(tNRF24L01 *psRadio)
 {
-	NRF24L01_SendCommand(RF24_FLUSH_RX, NULL, 0);
+	PROFILE_START(psRadio);
+
+	NRF24L01_SendCommand(psRadio, RF24_FLUSH_RX, NULL, 0);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_FLUSH_RX);
 }
 
 
@@ -659,7 +1624,7 @@ NRF24L01_FlushRX()
  * 
  * Function		: 	NRF24L01_EnableRxMode
  * 
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  * 
  * Return		: 	None
  * 
@@ -668,21 +1633,21 @@ NRF24L01_FlushRX()
  */
 
 void
-NRF24L01_EnableRxMode()
+NRF24L01_EnableRxMode(tNRF24L01 *psRadio)
 {
-	unsigned char ucCurrentVal = NRF24L01_GetStatus();
-
-	NRF24L01_PowerUp();
+	PROFILE_START(psRadio);
 
 	// PS: Clear RX_DR interrupt TODO: Why?
-	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+	NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_DATA_READY);
 
-	ucCurrentVal = NRF24L01_RegisterRead_8(RF24_CONFIG);
-	ucCurrentVal |= (RF24_PRIM_RX | RF24_PWR_UP);
-	
-	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucCurrentVal);
+	// PS: Power up and set to RX mode in one write
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_CONFIG, 0, (RF24_PRIM_RX | RF24_PWR_UP));
+
+	psRadio->uiInternalStates |= INTERNAL_STATE_POWER_UP;
 	
-	_NRF24L01_CEHigh();
+	_NRF24L01_CEHigh(psRadio);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ENABLE_RX_MODE);
 }
 
 
@@ -690,16 +1655,16 @@ NRF24L01_EnableRxMode()
  *
  * Function		: 	NRF24L01_DisableRxMode
  *
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  *
  * Return		: 	None
  *
  * Description	: 	Put the module into Standby I state with RX mode. Inline function.
  *
  */
-void NRF24L01_DisableRxMode()
+void NRF24L01_DisableRxMode(tNRF24L01 *psRadio)
 {
-	_NRF24L01_CELow();
+	_NRF24L01_CELow(psRadio);
 }
 
 
@@ -708,7 +1673,7 @@ void NRF24L01_DisableRxMode()
  * 
  * Function		: 	NRF24L01_EnableTxMode
  * 
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  * 
  * Return		: 	None
  * 
@@ -717,95 +1682,4578 @@ void NRF24L01_DisableRxMode()
  */
 
 void
-NRF24L01_EnableTxMode()
+NRF24L01_EnableTxMode(tNRF24L01 *psRadio)
+{
+	PROFILE_START(psRadio);
+
+	// PS: Clear TX_DS and MAX_RT interrupts TODO: why?
+	NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+	// PS: Power up and set to TX mode in one write
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_CONFIG, RF24_PRIM_RX, RF24_PWR_UP);
+
+	psRadio->uiInternalStates |= INTERNAL_STATE_POWER_UP;
+
+	_NRF24L01_CEHigh(psRadio);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ENABLE_TX_MODE);
+}
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_DisableTxMode
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Put the module into Standby I state with TX mode. The power
+ * 					policy (NRF24L01_SetPowerPolicy) may power the module down.
+ *
+ */
+void NRF24L01_DisableTxMode(tNRF24L01 *psRadio)
+{
+	_NRF24L01_CELow(psRadio);
+
+	// PS: Clear TX_DS and MAX_RT interrupts TODO: why?
+	NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+	_NRF24L01_ApplyPowerPolicy(psRadio);
+}
+
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_IsDataReadyRx
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcPipeNo [out] : Pipe number which contains the RX payload
+ * 
+ * Return		: 	PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ * 					PDLIB_NRF24_ERROR				:	Data is not in RX FIFO
+ * 					PDLIB_NRF24_SUCCESS				:	Data is in RX FIFO
+ * 
+ * Description	: 	Get the state of RX data.
+ * 					If the return is 'PDLIB_NRF24_SUCCESS' then the pcPipeNo will contain the pipe which has data.
+ *
+ * 					This follows the RX FIFO (RX_P_NO), not RX_DR. RX_DR is cleared after
+ * 					the first payload is read while more payloads can still be waiting.
+ *
+ * 					When the last status has no pipe number and the backend reports
+ * 					IRQ active (pfnGetIRQ), the module is asked with the write which
+ * 					clears RX_DR instead of a NOP. The payload stays in the RX FIFO and
+ * 					RX_P_NO keeps telling its pipe until it is read.
+ * 
+ */
+ 
+int
+NRF24L01_IsDataReadyRx(tNRF24L01 *psRadio, char *pcPipeNo)
+{
+	int ret = PDLIB_NRF24_ERROR;
+	PROFILE_START(psRadio);
+
+	if(NULL == pcPipeNo)
+	{
+		ret = PDLIB_NRF24_INVALID_ARGUMENT;
+	}else
+	{
+		// PS: Only reading or flushing the RX FIFO empties it, so a pipe number in the last status is still valid
+		ret = _NRF24L01_DecodeDataReady(psRadio->ucStatus, pcPipeNo);
+
+		if(PDLIB_NRF24_SUCCESS != ret)
+		{
+#ifdef NRF24L01_CONF_HAL
+			// PS: With IRQ active a flag is already set, the write acknowledging RX_DR reads RX_P_NO as well as a NOP
+			if(_NRF24L01_IRQActive(psRadio))
+			{
+				NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_DATA_READY);
+
+				ret = _NRF24L01_DecodeDataReady(psRadio->ucStatus, pcPipeNo);
+			}
+#endif
+
+			// PS: A payload which came in during the write lost its RX_DR, RX_P_NO still tells it
+			if(PDLIB_NRF24_SUCCESS != ret)
+			{
+				ret = _NRF24L01_DecodeDataReady(NRF24L01_GetStatus(psRadio), pcPipeNo);
+			}
+		}
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_IS_DATA_READY_RX);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_DecodeDataReady
+ *
+ * Arguments	: 	ucStatus		:	Status register value
+ * 					pcPipeNo [out]	:	Pipe number which contains the RX payload
+ *
+ * Return		: 	PDLIB_NRF24_ERROR				:	Data is not in RX FIFO
+ * 					PDLIB_NRF24_SUCCESS				:	Data is in RX FIFO
+ *
+ * Description	: 	Decodes RX_P_NO of a status register value.
+ *
+ */
+
+static int
+_NRF24L01_DecodeDataReady(unsigned char ucStatus, char *pcPipeNo)
+{
+	int ret = PDLIB_NRF24_ERROR;
+
+	*pcPipeNo = ((ucStatus & ( BIT3 | BIT2 | BIT1)) >> 1);
+
+	// *pcPipeNo will be 7 if the RX fifo is empty
+	if(*pcPipeNo < 6)
+	{
+		ret = PDLIB_NRF24_SUCCESS;
+	}else
+	{
+		// Reset the value in the pipe number
+		*pcPipeNo = 0xFF;
+		ret = PDLIB_NRF24_ERROR;
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_WaitForDataRx
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcPipeNo [out] : Pipe number which contains the RX payload
+ *
+ * Return		: 	PDLIB_NRF24_ERROR	:	Invalid input argument
+ * 					PDLIB_NRF24_SUCCESS	:	Data is in RX FIFO
+ *
+ * Description	: 	Wait until any RX pipe has data
+ *
+ */
+
+int NRF24L01_WaitForDataRx(tNRF24L01 *psRadio, char *pcPipeNo)
 {
-	unsigned char ucCurrentVal = 0;
+	int iRet = PDLIB_NRF24_ERROR;
+	PROFILE_START(psRadio);
+
+	TRACE(psRadio, PDLIB_NRF24_TRACE_WAIT_RX, 0, 0, psRadio->ucStatus);
+
+	NRF24L01_EnableRxMode(psRadio);
+
+	while(iRet == PDLIB_NRF24_ERROR)
+	{
+		iRet = NRF24L01_IsDataReadyRx(psRadio, pcPipeNo);
+
+#ifdef NRF24L01_CONF_HAL
+		if(iRet == PDLIB_NRF24_ERROR)
+		{
+			_NRF24L01_WaitIRQ(psRadio, PDLIB_NRF24_HAL_WAIT_FOREVER);
+		}
+#endif
+	}
+
+
+	NRF24L01_DisableRxMode(psRadio);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_WAIT_FOR_DATA_RX);
+
+	return iRet;
+}
+
 
-	// PS: Power up the device
-	NRF24L01_PowerUp();
 
-	// PS: Clear TX_DS and MAX_RT interrupts TODO: why?
-	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsTxFifoFull
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	0	:	TX FIFO is NOT full
+ * 					1	:	TX FIFO is full
+ *
+ * Description	: 	Get the state of TX FIFO
+ *
+ */
+
+int
+NRF24L01_IsTxFifoFull(tNRF24L01 *psRadio)
+{
+	unsigned char ucTxFifo;
+
+	ucTxFifo = NRF24L01_RegisterRead_8(psRadio, RF24_FIFO_STATUS);
+
+	return ((ucTxFifo & RF24_FIFO_FULL) ? 1 : 0);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsTxFifoEmpty
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	0	:	TX FIFO is NOT empty
+ * 					1	:	TX FIFO is empty
+ *
+ * Description	: 	Get the state of TX FIFO
+ *
+ */
+
+int NRF24L01_IsTxFifoEmpty(tNRF24L01 *psRadio)
+{
+	unsigned char ucTxFifo;
+	ucTxFifo = NRF24L01_RegisterRead_8(psRadio, RF24_FIFO_STATUS);
+
+	return ((ucTxFifo & RF24_TX_EMPTY) ? 1 : 0);
+}
+
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_GetRxDataAmount
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucDataPipe	:	Index of the pipe
+ * 
+ * Return		: 	Available number of bytes.
+ * 
+ * Description	: 	Reading the number of data bytes available
+ * 					in the specified pipe (for static payload mode).
+ *
+ * 					For dynamic payload mode this will tell
+ * 					the top most RX_FIFO payload length.
+ * 
+ */
+
+char
+NRF24L01_GetRxDataAmount(tNRF24L01 *psRadio, unsigned char ucDataPipe)
+{
+	char reg;
+	char ret = 0;
+	PROFILE_START(psRadio);
+
+	if((INTERNAL_STATE_DYNPL & psRadio->uiInternalStates) == 0){
+		if(ucDataPipe < 6)
+		{
+			ret = (psRadio->ucShadow[RF24_RX_PW_P0 + ucDataPipe] & 0x3F);
+		}else
+		{
+			ret = 0;
+		}
+	}else{
+		NRF24L01_SendRcvCommand(psRadio, RF24_R_RX_PL_WID, &reg, 1);
+
+		ret = reg;
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_GET_RX_DATA_AMOUNT);
+
+	return ret;
+}
+	
+	
+/* PS:
+ * 
+ * Function		: 	NRF24L01_SetTXAddress
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					address	:	Buffer which contains the five bytes to put to address.
+ * 
+ * Return		: 	None
+ * 
+ * Description	: 	Set the address of the module for TX mode. The data
+ * 					packet which is transmitted from this RF module will
+ * 					contain this address as destination address. Only the
+ * 					bytes of the address width (NRF24L01_SetAddressWidth) are
+ * 					written, so set the width first.
+ * 
+ */
+ 
+void 
+NRF24L01_SetTXAddress(tNRF24L01 *psRadio, unsigned char* address)
+{
+	NRF24L01_RegisterWrite_Multi(psRadio, RF24_TX_ADDR, (unsigned char*)address, ADDRESS_WIDTH(psRadio, RF24_TX_ADDR));
+}
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_WaitForTxComplete
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					busy_wait :	If this is 1 then the function will wait until DS or RT
+ * 								bit in status register become '1'.
+ *
+ * 								If this is '0' the state of DS and RT interrupts will return.
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS			:	TX completed successfully
+ *					PDLIB_NRF24_TX_ARC_REACHED	:	Maximum retransmissions elapsed
+ *					PDLIB_NRF24_ERROR			:	None of the TX interrupts asserted (only when busy_wait = 0)
+ *					PDLIB_NRF24_TX_TIMEOUT		:	No IRQ within NRF24L01_CONF_TX_TIMEOUT_MS (only with a
+ *													NRF24L01_CONF_HAL backend which can wait for IRQ)
+ *
+ * Description	: 	The function can wait until the
+ * 						-TX payload is successfully delivered (If ACK is available)
+ * 						or
+ * 						-TX payload has successfully transmitted.
+ *
+ *					This function will return 0 or a negative error code.
+ */
+
+int
+NRF24L01_WaitForTxComplete(tNRF24L01 *psRadio, char busy_wait)
+{
+	int ret = PDLIB_NRF24_SUCCESS;
+	PROFILE_START(psRadio);
+
+	// PS: TX_DS and MAX_RT stay set until they are cleared, the last status is enough if it has them
+	if((psRadio->ucStatus & (RF24_MAX_RT | RF24_TX_DS)) == 0)
+	{
+		NRF24L01_GetStatus(psRadio);
+	}
+
+	if(busy_wait){
+		while((psRadio->ucStatus & (RF24_MAX_RT | RF24_TX_DS)) == 0)
+		{
+#ifdef NRF24L01_CONF_HAL
+			if(0 == _NRF24L01_WaitIRQ(psRadio, NRF24L01_CONF_TX_TIMEOUT_MS * 1000UL))
+			{
+				PROFILE_END(psRadio, PDLIB_NRF24_PROF_WAIT_FOR_TX_COMPLETE);
+				return PDLIB_NRF24_TX_TIMEOUT;
+			}
+#endif
+			NRF24L01_GetStatus(psRadio);
+		}
+	}else{
+		if((psRadio->ucStatus & (RF24_MAX_RT | RF24_TX_DS)) == 0){
+			ret = PDLIB_NRF24_ERROR;
+		}
+	}
+
+
+	if(psRadio->ucStatus & RF24_MAX_RT)
+	{
+		TRACE(psRadio, PDLIB_NRF24_TRACE_MAX_RT, 0, 0, psRadio->ucStatus);
+		ret = PDLIB_NRF24_TX_ARC_REACHED;
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_WAIT_FOR_TX_COMPLETE);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetInterruptState
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	PDLIB_NRF24_ERROR			:	No interrupts asserted
+ *					PDLIB_INTERRUPT_MAX_RT		:	Maximum retransmissions elapsed
+ *					PDLIB_INTERRUPT_DATA_READY	:	Data ready on RX FIFO
+ *					PDLIB_INTERRUPT_DATA_SENT	:	Data sent
+ *
+ * Description	: 	This function can be used to check the interrupt status
+ * 					of the module.
+ */
+
+char
+NRF24L01_GetInterruptState(tNRF24L01 *psRadio)
+{
+	char state;
+	PROFILE_START(psRadio);
+
+	state = NRF24L01_GetStatus(psRadio);
+
+	state &= (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT);
+	state = (state >> 4);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_GET_INTERRUPT_STATE);
+
+	return state;
+
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ClearInterruptFlag
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					PDLIB_INTERRUPT_MAX_RT		:	Maximum retransmissions elapsed interrupt
+ *					PDLIB_INTERRUPT_DATA_READY	:	Data ready on RX FIFO interrupt
+ *					PDLIB_INTERRUPT_DATA_SENT	:	Data sent interrupt
+ *
+ * Return		:	Interrupt state before clearing (same encoding as NRF24L01_GetInterruptState)
+ *
+ * Description	: 	This function will clear the interrupt associated with the BM.
+ * 					The other status bits are read only and writing '0' to an interrupt
+ * 					flag has no effect, so the status register is not read first.
+ * 					Passing all the flags reads and clears the interrupts in one
+ * 					SPI transaction.
+ */
+
+char
+NRF24L01_ClearInterruptFlag(tNRF24L01 *psRadio, char interrupt_bm)
+{
+	unsigned char status = 0;
+	char state;
+	PROFILE_START(psRadio);
+
+	if(interrupt_bm & PDLIB_INTERRUPT_MAX_RT){
+		status |= RF24_MAX_RT;
+	}
+
+	if(interrupt_bm & PDLIB_INTERRUPT_DATA_READY){
+		status |= RF24_RX_DR;
+	}
+
+	if(interrupt_bm & PDLIB_INTERRUPT_DATA_SENT){
+		status |= RF24_TX_DS;
+	}
+
+	// PS: The status clocked out with the command byte is the state before clearing
+	state = _NRF24L01_Transaction(psRadio, (RF24_W_REGISTER | RF24_STATUS), &status, NULL, 1);
+	state = ((state & (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT)) >> 4);
+
+	psRadio->ucStatus &= (~status);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_CLEAR_INTERRUPT_FLAG);
+
+	return state;
+}
+
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_WaitForTxDone
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS			:	TX completed successfully
+ *					PDLIB_NRF24_TX_ARC_REACHED	:	Maximum retransmissions elapsed
+ *					PDLIB_NRF24_TX_TIMEOUT		:	No IRQ within NRF24L01_CONF_TX_TIMEOUT_MS
+ *
+ * Description	: 	NRF24L01_WaitForTxComplete for NRF24L01_AttemptTx, TX_DS and
+ * 					MAX_RT are cleared when it returns (except on a timeout).
+ *
+ * 					NRF24L01_EnableTxMode read the status just before CE went high,
+ * 					so the first poll is not needed. When the backend reports IRQ
+ * 					active (pfnGetIRQ) and RX_DR is not set, TX_DS or MAX_RT is, and
+ * 					the write which clears them reads them in the same transaction.
+ *
+ */
+
+static int
+_NRF24L01_WaitForTxDone(tNRF24L01 *psRadio)
+{
+	int ret = PDLIB_NRF24_SUCCESS;
+	char state = 0;
+	unsigned char ucCleared = 0;
+
+	while(0 == (state & (PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT)))
+	{
+#ifdef NRF24L01_CONF_HAL
+		if(0 == _NRF24L01_WaitIRQ(psRadio, NRF24L01_CONF_TX_TIMEOUT_MS * 1000UL))
+		{
+			return PDLIB_NRF24_TX_TIMEOUT;
+		}
+
+		if(_NRF24L01_IRQActive(psRadio) && (0 == (psRadio->ucStatus & RF24_RX_DR)))
+		{
+			state = NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+			ucCleared = 1;
+			continue;
+		}
+#endif
+		state = ((NRF24L01_GetStatus(psRadio) & (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT)) >> 4);
+	}
+
+	if(state & PDLIB_INTERRUPT_MAX_RT)
+	{
+		TRACE(psRadio, PDLIB_NRF24_TRACE_MAX_RT, 0, 0, (psRadio->ucStatus | (state << 4)));
+		ret = PDLIB_NRF24_TX_ARC_REACHED;
+	}
+
+	if(0 == ucCleared)
+	{
+		NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AttemptTx
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS			:	TX completed successfully
+ *					PDLIB_NRF24_TX_ARC_REACHED	:	Maximum retransmissions elapsed
+ *
+ * Description	: 	This function will attempt to TX whatever data available in the
+ * 					TX payload. It waits until the TX is done or maximum retransmissions
+ * 					occur.
+ *
+ * 					Module will be in Standby I or Power Down mode when it returns,
+ * 					depending on the power policy (NRF24L01_SetPowerPolicy).
+ */
+
+int NRF24L01_AttemptTx(tNRF24L01 *psRadio)
+{
+	int ret = PDLIB_NRF24_SUCCESS;
+	PROFILE_START(psRadio);
+
+	TRACE(psRadio, PDLIB_NRF24_TRACE_ATTEMPT_TX, 0, 0, psRadio->ucStatus);
+
+	NRF24L01_EnableTxMode(psRadio);
+
+	ret = _NRF24L01_WaitForTxDone(psRadio);
+
+	if(PDLIB_NRF24_TX_TIMEOUT == ret)
+	{
+		NRF24L01_DisableTxMode(psRadio);
+	}else
+	{
+		// PS: TX_DS and MAX_RT are already cleared by the wait
+		_NRF24L01_CELow(psRadio);
+		_NRF24L01_ApplyPowerPolicy(psRadio);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ATTEMPT_TX);
+
+	return ret;
+}
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_SetRXAddress
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucDataPipe	:	Data pipe number
+ * 					pucAddress	:	Buffer which contains the one/five bytes to put to address.
+ * 
+ * Return		: 	None
+ * 
+ * Description	: 	Set the RX address. P0 and P1 pipes have 5 byte address
+ * 					other pipes have 1 byte address(LSB). Other bytes are taken from
+ * 					the P1 pipe address. P0 and P1 take the bytes of the address
+ * 					width (NRF24L01_SetAddressWidth), so set the width first.
+ * 
+ */
+ 
+void 
+NRF24L01_SetRxAddress(	tNRF24L01 *psRadio,
+						unsigned char ucDataPipe,
+						unsigned char *pucAddress)
+{
+	if(pucAddress)
+	{
+		switch(ucDataPipe)
+		{
+			case 0:
+			case 1:
+				NRF24L01_RegisterWrite_Multi(psRadio, (RF24_RX_ADDR_P0 + ucDataPipe), pucAddress,
+											 ADDRESS_WIDTH(psRadio, (RF24_RX_ADDR_P0 + ucDataPipe)));
+				break;
+			case 2:
+			case 3:
+			case 4:
+			case 5:
+				NRF24L01_RegisterWrite_8(psRadio, (RF24_RX_ADDR_P0 + ucDataPipe),pucAddress[0]);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_SetRXPacketSize
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucDataPipe		:	Data pipe number
+ * 					ucPacketSize	:	Packet size. (Maximum is 32)
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Set the packet size for a RX pipe.
+ *
+ */
+
+void
+NRF24L01_SetRXPacketSize(	tNRF24L01 *psRadio,
+							unsigned char ucDataPipe,
+							unsigned char ucPacketSize)
+{
+	if((ucDataPipe < 6) && (ucPacketSize <= 32))
+	{
+		NRF24L01_RegisterWrite_8(psRadio, (RF24_RX_PW_P0 + ucDataPipe), ucPacketSize);
+	}
+
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_CarrierDetect
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	'1' - There is a carrier signal
+ * 					'0' - There is no carrier signal
+ *
+ * Description	: 	Check whether there is any RF carrier in the current frequency channel
+ *
+ */
+
+unsigned char NRF24L01_CarrierDetect(tNRF24L01 *psRadio){
+	unsigned char ucTemp = NRF24L01_RegisterRead_8(psRadio, RF24_CD);
+	return (ucTemp & 0x01);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SetTxPayload
+ * 
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pucData		:	Buffer which contains the data to be written to TX fifo
+ * 					uiLength	:	Length of the data buffer
+ * 
+ * Return		: 	PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ * 					PDLIB_NRF24_SUCCESS			: Success
+ * 
+ * Description	: 	Set the TX payload. 
+ * 
+ */
+ 
+int
+NRF24L01_SetTxPayload(	tNRF24L01 *psRadio,
+						char* pcData,
+						unsigned int uiLength)
+{
+	int ret;
+	PROFILE_START(psRadio);
+
+	ret = _NRF24L01_WriteTxPayload(psRadio, RF24_W_TX_PAYLOAD, pcData, uiLength);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SET_TX_PAYLOAD);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SetTxPayloadNoAck
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Buffer which contains the data to be written to TX fifo
+ * 					uiLength	:	Length of the data buffer
+ *
+ * Return		: 	PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ * 					PDLIB_NRF24_SUCCESS			: Success
+ * 					PDLIB_NRF24_ERROR			: Invalid arguments, or W_TX_PAYLOAD_NOACK
+ * 												  could not be enabled (module not in Standby I)
+ *
+ * Description	: 	Set a TX payload which is sent without asking for an ACK
+ * 					(W_TX_PAYLOAD_NOACK): no ACK wait, no retransmission, TX_DS as
+ * 					soon as it is on air. Other payloads in the TX FIFO keep their own
+ * 					setting. Enables the command (NRF24L01_EnableFeatureNoAckTx) on
+ * 					first use.
+ *
+ */
+
+int
+NRF24L01_SetTxPayloadNoAck(	tNRF24L01 *psRadio,
+							char* pcData,
+							unsigned int uiLength)
+{
+	int ret = PDLIB_NRF24_ERROR;
+	PROFILE_START(psRadio);
+
+	if(PDLIB_NRF24_SUCCESS == _NRF24L01_NoAckReady(psRadio))
+	{
+		ret = _NRF24L01_WriteTxPayload(psRadio, RF24_W_TX_PAYLOAD_NOACK, pcData, uiLength);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SET_TX_PAYLOAD);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_WriteTxPayload
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucCommand	:	RF24_W_TX_PAYLOAD or RF24_W_TX_PAYLOAD_NOACK
+ * 					pcData		:	Payload
+ * 					uiLength	:	Length of the payload
+ *
+ * Return		: 	Same as NRF24L01_SetTxPayload
+ *
+ */
+
+static int
+_NRF24L01_WriteTxPayload(tNRF24L01 *psRadio, unsigned char ucCommand, char *pcData, unsigned int uiLength)
+{
+	if((NULL == pcData) || (0 == uiLength))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	// PS: The module drops the payload if the TX fifo is full, the status of the write tells it
+	NRF24L01_SendCommand(psRadio, ucCommand, pcData, uiLength);
+
+	if(psRadio->ucStatus & RF24_TX_FULL)
+	{
+		TRACE(psRadio, PDLIB_NRF24_TRACE_TX_FIFO_FULL, ucCommand, uiLength, psRadio->ucStatus);
+		return PDLIB_NRF24_TX_FIFO_FULL;
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EnableFeatureAckPL
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Enable payload with ACK
+ *
+ */
+
+void
+NRF24L01_EnableFeatureAckPL(tNRF24L01 *psRadio)
+{
+	if((psRadio->uiInternalStates & INTERNAL_STATE_STAND_BY) || (0 == (psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP)))
+	{
+		/* PS: Enable dynpl for pipe0 */
+		NRF24L01_EnableFeatureDynPL(psRadio, 0x00);
+
+		/* PS: Check whether retransmission delay is sufficient */
+		if(0 == ((psRadio->ucShadow[RF24_SETUP_RETR] & 0xF0) >> 4)){
+			NRF24L01_SetARD(psRadio, 500);
+		}
+
+		/* PS: Enable auto ack payload */
+		_NRF24L01_RegisterUpdate_8(psRadio, RF24_FEATURE, 0, RF24_EN_ACK_PAY);
+
+		psRadio->uiInternalStates |= INTERNAL_STATE_ACKPL;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EnableFeatureDynPL
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pipe : Pipe number to enable the feature
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Enable dynamic payload
+ *
+ */
+
+void
+NRF24L01_EnableFeatureDynPL(tNRF24L01 *psRadio, unsigned char pipe)
+{
+	if((psRadio->uiInternalStates & INTERNAL_STATE_STAND_BY) || (0 == (psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP)))
+	{
+		/* PS: Check whether features register is activated */
+		if(0 == (psRadio->uiInternalStates & INTERNAL_STATE_FEATURE_ENABLED))
+		{
+			char data = 0x73;
+			NRF24L01_SendCommand(psRadio, RF24_ACTIVATE, &data, 1);
+
+			psRadio->uiInternalStates |= INTERNAL_STATE_FEATURE_ENABLED;
+		}
+
+		/* PS: Enable DYN-PL feature */
+		_NRF24L01_RegisterUpdate_8(psRadio, RF24_FEATURE, 0, RF24_EN_DPL);
+
+		if(pipe < 6)
+		{
+			/* PS: Enable DYN-PD for 'pipe' */
+			_NRF24L01_RegisterUpdate_8(psRadio, RF24_DYNPD, 0, (1 << pipe));
+		}
+
+		psRadio->uiInternalStates |= INTERNAL_STATE_DYNPL;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EnableFeatureNoAckTx
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Enable W_TX_PAYLOAD_NOACK command
+ *
+ */
+
+
+void
+NRF24L01_EnableFeatureNoAckTx(tNRF24L01 *psRadio)
+{
+	if((psRadio->uiInternalStates & INTERNAL_STATE_STAND_BY) || (0 == (psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP)))
+	{
+		/* PS: Check whether features register is activated */
+		if(0 == (psRadio->uiInternalStates & INTERNAL_STATE_FEATURE_ENABLED))
+		{
+			char data = 0x73;
+			NRF24L01_SendCommand(psRadio, RF24_ACTIVATE, &data, 1);
+
+			psRadio->uiInternalStates |= INTERNAL_STATE_FEATURE_ENABLED;
+		}
+
+		/* PS: Enable DYN-ACK feature */
+		_NRF24L01_RegisterUpdate_8(psRadio, RF24_FEATURE, 0, RF24_EN_DYN_ACK);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_NoAckReady
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS if W_TX_PAYLOAD_NOACK can be used, PDLIB_NRF24_ERROR
+ * 					if EN_DYN_ACK is off and the module is not in a state to write it
+ *
+ * Description	: 	Enables W_TX_PAYLOAD_NOACK on first use. The shadow of FEATURE tells
+ * 					whether it is on, so later calls cost no SPI transaction.
+ *
+ */
+
+static int
+_NRF24L01_NoAckReady(tNRF24L01 *psRadio)
+{
+	if(0 == (psRadio->ucShadow[RF24_FEATURE] & RF24_EN_DYN_ACK))
+	{
+		NRF24L01_EnableFeatureNoAckTx(psRadio);
+	}
+
+	return ((psRadio->ucShadow[RF24_FEATURE] & RF24_EN_DYN_ACK) ? PDLIB_NRF24_SUCCESS : PDLIB_NRF24_ERROR);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetData
+ *
+ * Arguments	:	psRadio	:	Radio instance
+ * 					pipe				:	Pipe number
+ * 					pcData [out]		:	Allocated buffer to store the RX data
+ * 					length	[in/out]	:	Length in bytes of pcData (only used in dynamic payload mode) // TODO
+ *
+ * Return		:
+ * 					Positive	:	Number of bytes read
+ *
+ * Description	:
+ * 					This function will read the length amount of data from the RX FIFO
+ * 					If the available data amount is more than the specified value this
+ * 					will return an error.
+ *
+ * 					Payload is automatically deleted from the FIFO once it is read.
+ *
+ * 					This will clear the data ready status bit in the module.
+ *
+ */
+
+int
+NRF24L01_GetData(	tNRF24L01 *psRadio,
+					char pipe,
+					char* pcData,
+					char *length)
+{
+	int ret = PDLIB_NRF24_SUCCESS; // Amount of data read
+	char cTemp;
+	PROFILE_START(psRadio);
+
+	// Check whether dynamic payload is available TODO
+
+	if(NULL == pcData)
+	{
+		ret = PDLIB_NRF24_INVALID_ARGUMENT;
+	}else{
+
+		// PS: Validate pipe, Check FIFO status, Get packet size, Read data
+		if(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(psRadio, &cTemp)){
+
+			// PS: A valid pipe number in the status means the RX FIFO is not empty
+			if(pipe == cTemp){
+				// PS: Check whether data is available
+				cTemp = NRF24L01_GetRxDataAmount(psRadio, pipe);
+
+				if((*length) >= cTemp){
+					(*length) = cTemp;
+				}else{
+					// PS: If the actual buffer size is smaller than the available data, we can miss data.
+					ret = PDLIB_NRF24_BUFFER_TOO_SMALL;
+				}
+
+				if(PDLIB_NRF24_SUCCESS == ret){
+
+					// PS: Read RX payload
+					NRF24L01_ReadRxPayload(psRadio, pcData, cTemp);
+
+					// TODO: Check whether we need to check the actual FIFO state before clearing the interrupt.
+					// Clear RX_DR
+					NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_DATA_READY);
+
+					ret = cTemp;
+				}
+			}else{
+				ret = PDLIB_NRF24_INVALID_ARGUMENT;
+			}
+		}else{
+			ret = PDLIB_NRF24_ERROR;
+		}
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_GET_DATA);
+
+	return ret;
+}
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ReadRxPayload
+ *
+ * Arguments	:	psRadio	:	Radio instance
+ * 					pcData [out]	:	Allocated buffer to store the RX data
+ * 					cLength	[in]	:	Required data amount. This should be a valid data amount. (TODO: Verify whether this is neccessary to be valid)
+ *
+ * Return		:	None
+ *
+ * Description	:
+ * 					This function will read the cLength amount of data from the RX FIFO.
+ *
+ * 					This function will not perform any validation of data sizes, buffer size, etc.
+ *
+ * 					Payload is automatically deleted from the FIFO once it is read.
+ *
+ */
+
+void
+NRF24L01_ReadRxPayload(	tNRF24L01 *psRadio,
+						char* pcData,
+						char cLength)
+{
+	PROFILE_START(psRadio);
+
+	NRF24L01_SendRcvCommand(psRadio, RF24_R_RX_PAYLOAD, pcData, cLength);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_READ_RX_PAYLOAD);
+}
+ 
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SetAckPayload
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pucData		:	Buffer which contains the data to be written to TX fifo
+ * 					pipe		:	Which pipe to use (0~5)
+ * 					uiLength	:	Length of the data buffer
+ *
+ * Return		: 	PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ * 					PDLIB_NRF24_SUCCESS			: Success
+ *
+ * Description	: 	Set the Ack payload.
+ *
+ */
+
+int
+NRF24L01_SetAckPayload(	tNRF24L01 *psRadio,
+						char* pcData,
+						char pipe,
+						unsigned int uiLength)
+{
+	int ret = PDLIB_NRF24_SUCCESS;
+	char address = pipe;
+	PROFILE_START(psRadio);
+
+	if(((unsigned char)pipe <= PDLIB_NRF24_PIPE5) && pcData && uiLength > 0)
+	{
+		address = address & 0x07;
+		address |= RF24_W_ACK_PAYLOAD;
+
+		// PS: The module drops the payload if the TX fifo is full, the status of the write tells it
+		NRF24L01_SendCommand(psRadio, address , pcData, uiLength);
+
+		if(psRadio->ucStatus & RF24_TX_FULL)
+		{
+			ret = PDLIB_NRF24_TX_FIFO_FULL;
+			TRACE(psRadio, PDLIB_NRF24_TRACE_TX_FIFO_FULL, address, uiLength, psRadio->ucStatus);
+		}
+	}else
+	{
+		ret = PDLIB_NRF24_ERROR;
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SET_ACK_PAYLOAD);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_
+ *
+ * Arguments	:
+ *
+ * Return		: 	None
+ *
+ * Description	:
+ *
+ */
+
+char
+NRF24L01_GetAckDataAmount(tNRF24L01 *psRadio)
+{
+	char data_amount = 0;
+
+	NRF24L01_SendRcvCommand(psRadio, RF24_R_RX_PL_WID,&data_amount,1);
+
+	return data_amount;
+}
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_
+ * 
+ * Arguments	: 	
+ * 
+ * Return		: 	None
+ * 
+ * Description	: 	
+ * 
+ */
+
+
+// ----------------  Normal user level functions ------------------ //
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendData
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Data packet to send
+ * 					ulLength	:	Length of the packet
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS			: Success
+ * 					PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ *					PDLIB_NRF24_TX_ARC_REACHED	: Maximum retransmissions elapsed
+ *
+ * Description	: 	The function will send the specified data using
+ * 					current configuration. (current air data rate,
+ * 					current power, current TX address, ... )
+ *
+ * 					The function will return after the data is successfully transmitted or
+ * 					maximum retransmissions were done. The module will be in Standby I or
+ * 					Power Down state when this function returns (see NRF24L01_SetPowerPolicy).
+ *
+ */
+
+int NRF24L01_SendData(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength)
+{
+	int ret;
+	PROFILE_START(psRadio);
+
+	ret = NRF24L01_SubmitData(psRadio, pcData, uiLength);
+
+	if(ret == PDLIB_NRF24_SUCCESS)
+	{
+
+		ret = NRF24L01_AttemptTx(psRadio);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SEND_DATA);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendDataNoAck
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Data packet to send
+ * 					uiLength	:	Length of the packet
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS			: Success
+ * 					PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ * 					PDLIB_NRF24_ERROR			: See NRF24L01_SetTxPayloadNoAck
+ *
+ * Description	: 	Fire-and-forget version of NRF24L01_SendData. The packet asks the
+ * 					PRX not to ACK it, so the function returns as soon as it is on air,
+ * 					even with auto ACK enabled. Whether it arrived is not known.
+ *
+ */
+
+int NRF24L01_SendDataNoAck(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength)
+{
+	int ret;
+	PROFILE_START(psRadio);
+
+	ret = NRF24L01_SetTxPayloadNoAck(psRadio, pcData, uiLength);
+
+	if(ret == PDLIB_NRF24_SUCCESS)
+	{
+		ret = NRF24L01_AttemptTx(psRadio);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SEND_DATA);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SubmitData
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Data packet to send
+ * 					ulLength	:	Length of the packet
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS			: Success
+ * 					PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ *
+ * Description	: 	The function will send the specified data using
+ * 					current configuration. (current air data rate,
+ * 					current power, current TX address, ... )
+ *
+ * 					This function will write data to payload buffer and make
+ * 					sure correct addresses are there for automatic ack if available.
+ *
+ * 					The module needs to be Powered-Up and put into TX mode in order
+ * 					to perform the transmission.
+ *
+ */
+
+int NRF24L01_SubmitData(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength)
+{
+	int ret;
+	PROFILE_START(psRadio);
+
+	_NRF24L01_SetAckAddress(psRadio);
+
+	ret = NRF24L01_SetTxPayload(psRadio, pcData, uiLength);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SUBMIT_DATA);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SetAckAddress
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	If auto ack is enabled on pipe 0, the RX address of pipe 0 is set
+ * 					to the TX address so that the ACK can be received. Both are taken
+ * 					from the address shadow, nothing is written when they already match.
+ *
+ */
+
+static void
+_NRF24L01_SetAckAddress(tNRF24L01 *psRadio)
+{
+	_NRF24L01_SetTarget(psRadio, psRadio->ucAddressShadow[RF24_TX_ADDR - RF24_RX_ADDR_P0]);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SetTarget
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pucAddress	:	Five byte address of the PRX, LSByte first
+ *
+ * Return		: 	Number of address registers written (0 to 2)
+ *
+ * Description	: 	Makes pucAddress the TX address and, with auto ack on pipe 0, the
+ * 					RX address of pipe 0. Each of them is compared with the address
+ * 					shadow and written only if it differs, both in one batch. Nothing
+ * 					is read back.
+ *
+ * 					The module takes address bytes LSByte first and keeps the bytes a
+ * 					shorter write does not reach, so only the bytes up to the last one
+ * 					which differs are clocked: nodes which share the upper bytes of
+ * 					their addresses cost one data byte per register. Bytes past the
+ * 					address width are neither compared nor written, the module would
+ * 					not take them and the shadow keeps what the module holds.
+ *
+ */
+
+static int
+_NRF24L01_SetTarget(tNRF24L01 *psRadio, const unsigned char *pucAddress)
+{
+	static const unsigned char ucRegisters[2] = { RF24_TX_ADDR, RF24_RX_ADDR_P0 };
+	unsigned char ucBatch[2 * 7];
+	unsigned char ucWrite[2] = { 0, 0 };		// Bytes to write, from the LSByte
+	unsigned char *pucShadow;
+	unsigned int uiWidth = ADDRESS_WIDTH(psRadio, RF24_TX_ADDR);
+	unsigned int uiBytes = 0;
+	unsigned int uiRegister;
+	unsigned int uiIndex;
+	int iWrites = 0;
+
+	for(uiRegister = 0; uiRegister < 2; uiRegister++)
+	{
+		// PS: Check the Auto Ack feature and make sure the data pipe 0 has the correct PTX address
+		if((RF24_RX_ADDR_P0 == ucRegisters[uiRegister]) && !(psRadio->ucShadow[RF24_EN_AA] & RF24_ENAA_P0))
+		{
+			break;
+		}
+
+		pucShadow = psRadio->ucAddressShadow[ucRegisters[uiRegister] - RF24_RX_ADDR_P0];
+
+		for(uiIndex = 0; uiIndex < uiWidth; uiIndex++)
+		{
+			if(pucAddress[uiIndex] != pucShadow[uiIndex])
+			{
+				ucWrite[uiRegister] = (unsigned char)(uiIndex + 1);
+			}
+		}
+
+		if(ucWrite[uiRegister])
+		{
+			uiBytes = _NRF24L01_BatchAdd(ucBatch, uiBytes, (RF24_W_REGISTER | ucRegisters[uiRegister]), pucAddress, ucWrite[uiRegister]);
+			iWrites++;
+		}
+	}
+
+	if(0 == uiBytes)
+	{
+		return 0;
+	}
+
+	_NRF24L01_WriteBatch(psRadio, ucBatch, uiBytes);
+
+	for(uiRegister = 0; uiRegister < 2; uiRegister++)
+	{
+		if(ucWrite[uiRegister])
+		{
+			pucShadow = psRadio->ucAddressShadow[ucRegisters[uiRegister] - RF24_RX_ADDR_P0];
+
+			for(uiIndex = 0; uiIndex < ucWrite[uiRegister]; uiIndex++)
+			{
+				pucShadow[uiIndex] = pucAddress[uiIndex];
+			}
+		}
+	}
+
+	return iWrites;
+}
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendDataTo
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Data packet to send
+ * 					ulLength	:	Length of the packet
+ * 					pcTxAddr	:	TX address
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS			: Success
+ * 					PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ *					PDLIB_NRF24_TX_ARC_REACHED	: Maximum retransmissions elapsed
+ *
+ * Description	: 	The function will send the specified data using
+ * 					current configuration but to the specified address. (current air data rate,
+ * 					current power, ... )
+ *
+ * 					The function will return after the data is successfully transmitted or
+ * 					maximum retransmissions were done.
+ *
+ * 					This function will change the TX address in the module (and the RX
+ * 					address of pipe 0 for the ACK). Addresses which are already set are
+ * 					not written again, see also NRF24L01_SelectNode.
+ *
+ */
+
+int NRF24L01_SendDataTo(tNRF24L01 *psRadio, unsigned char *address, char *pcData, unsigned int uiLength)
+{
+	int iRet;
+	PROFILE_START(psRadio);
+
+	_NRF24L01_SetTarget(psRadio, address);
+
+	iRet = NRF24L01_SendData(psRadio, pcData, uiLength);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SEND_DATA_TO);
+
+	return iRet;
+}
+
+
+
+
+#ifdef NRF24L01_CONF_ADDRESS_BOOK
+
+// ----------------------- Address book ---------------------- //
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AddressBookAdd
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pucAddress	:	Five byte address of a PRX, LSByte first
+ *
+ * Return		: 	Zero or positive				:	Node number to pass to NRF24L01_SelectNode
+ *					PDLIB_NRF24_INVALID_ARGUMENT	:	pucAddress is NULL
+ *					PDLIB_NRF24_ERROR				:	NRF24L01_CONF_ADDRESS_BOOK_SIZE addresses are
+ *														registered already
+ *
+ * Description	: 	Registers the address of a node the radio will send to. Node
+ * 					numbers are given out from 0 in the order of registration.
+ * 					Nothing is written to the module.
+ *
+ */
+
+int
+NRF24L01_AddressBookAdd(tNRF24L01 *psRadio, const unsigned char *pucAddress)
+{
+	unsigned int uiIndex;
+
+	if(NULL == pucAddress)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(psRadio->ucAddressBookCount >= NRF24L01_CONF_ADDRESS_BOOK_SIZE)
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	for(uiIndex = 0; uiIndex < 5; uiIndex++)
+	{
+		psRadio->ucAddressBook[psRadio->ucAddressBookCount][uiIndex] = pucAddress[uiIndex];
+	}
+
+	return psRadio->ucAddressBookCount++;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AddressBookClear
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Forgets every registered address. The addresses set in the module
+ * 					stay as they are.
+ *
+ */
+
+void
+NRF24L01_AddressBookClear(tNRF24L01 *psRadio)
+{
+	psRadio->ucAddressBookCount = 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SelectNode
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucNode	:	Node number of NRF24L01_AddressBookAdd
+ *
+ * Return		: 	Zero or positive				:	Number of address registers written (0 to 2)
+ *					PDLIB_NRF24_INVALID_ARGUMENT	:	ucNode is not registered
+ *
+ * Description	: 	Makes the node the target of the following transmissions: its
+ * 					address becomes the TX address and, with auto ack on pipe 0, the
+ * 					RX address of pipe 0. Registers are compared with the address
+ * 					shadow and only written if they differ, back-to-back, without
+ * 					reading anything back. Switching to another node costs two
+ * 					SPI transactions with auto ack and one without, selecting the
+ * 					current node none. Only the address bytes up to the last one
+ * 					which differs are written, one for nodes which differ in the
+ * 					LSByte only.
+ *
+ * 					The TX functions which follow (NRF24L01_SendData,
+ * 					NRF24L01_SendDataAsync, ...) find pipe 0 set already and add no
+ * 					SPI transaction for it. After a reset of the module restore the
+ * 					shadow first (NRF24L01_RestoreShadow).
+ *
+ */
+
+int
+NRF24L01_SelectNode(tNRF24L01 *psRadio, unsigned char ucNode)
+{
+	int iReturn = PDLIB_NRF24_INVALID_ARGUMENT;
+	PROFILE_START(psRadio);
+
+	if(ucNode < psRadio->ucAddressBookCount)
+	{
+		iReturn = _NRF24L01_SetTarget(psRadio, psRadio->ucAddressBook[ucNode]);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SELECT_NODE);
+
+	return iReturn;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendDataToNode
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucNode	:	Node number of NRF24L01_AddressBookAdd
+ * 					pcData		:	Data packet to send
+ * 					uiLength	:	Length of the packet
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS				: Success
+ * 					PDLIB_NRF24_TX_FIFO_FULL 		: Tx FIFO full
+ *					PDLIB_NRF24_TX_ARC_REACHED		: Maximum retransmissions elapsed
+ *					PDLIB_NRF24_INVALID_ARGUMENT	: ucNode is not registered
+ *
+ * Description	: 	NRF24L01_SelectNode followed by NRF24L01_SendData. Profiled as
+ * 					NRF24L01_SendDataTo.
+ *
+ */
+
+int
+NRF24L01_SendDataToNode(tNRF24L01 *psRadio, unsigned char ucNode, char *pcData, unsigned int uiLength)
+{
+	int iRet;
+	PROFILE_START(psRadio);
+
+	iRet = NRF24L01_SelectNode(psRadio, ucNode);
+
+	if(iRet >= 0)
+	{
+		iRet = NRF24L01_SendData(psRadio, pcData, uiLength);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SEND_DATA_TO);
+
+	return iRet;
+}
+
+#endif
+
+
+
+
+// ----------------------- Asynchronous TX ---------------------- //
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendDataAsync
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Data packet to send
+ * 					uiLength	:	Length of the packet
+ * 					psHandle	:	Handle of this TX, must stay valid until it is over
+ * 					pfnCallback	:	Called with the result when the TX is over (can be NULL)
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS				: TX started
+ * 					PDLIB_NRF24_BUSY				: Another asynchronous TX is not over
+ * 					PDLIB_NRF24_TX_FIFO_FULL 		: Tx FIFO full
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: psHandle is NULL
+ *
+ * Description	: 	Non-blocking version of NRF24L01_SendData. Writes the payload,
+ * 					starts the TX and returns. psHandle->iResult stays
+ * 					PDLIB_NRF24_TX_PENDING until the TX is over, then becomes
+ *
+ * 						PDLIB_NRF24_SUCCESS			: TX_DS
+ * 						PDLIB_NRF24_TX_ARC_REACHED	: MAX_RT, the payload is flushed
+ * 						PDLIB_NRF24_TX_TIMEOUT		: Neither within NRF24L01_CONF_TX_TIMEOUT_MS
+ *
+ * 					and psHandle->ucRetries has the retransmission count. The TX is
+ * 					driven by NRF24L01_TxAsyncService from the IRQ handler, or by
+ * 					NRF24L01_Tick without NRF24L01_CONF_INTERRUPT_PIN. Neither waits
+ * 					on the module.
+ *
+ */
+
+int
+NRF24L01_SendDataAsync(	tNRF24L01 *psRadio,
+						char *pcData,
+						unsigned int uiLength,
+						tNRF24L01TxHandle *psHandle,
+						tNRF24L01Callback pfnCallback)
+{
+	int ret;
+	PROFILE_START(psRadio);
+
+	ret = _NRF24L01_SendDataAsync(psRadio, RF24_W_TX_PAYLOAD, pcData, uiLength, psHandle, pfnCallback);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SEND_DATA_ASYNC);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendDataAsyncNoAck
+ *
+ * Arguments	: 	Same as NRF24L01_SendDataAsync
+ *
+ * Return		:	Same as NRF24L01_SendDataAsync, and PDLIB_NRF24_ERROR if
+ * 					W_TX_PAYLOAD_NOACK could not be enabled (see NRF24L01_SetTxPayloadNoAck)
+ *
+ * Description	: 	Non-blocking version of NRF24L01_SendDataNoAck. The handle
+ * 					completes with PDLIB_NRF24_SUCCESS once the packet is on air.
+ *
+ */
+
+int
+NRF24L01_SendDataAsyncNoAck(tNRF24L01 *psRadio,
+							char *pcData,
+							unsigned int uiLength,
+							tNRF24L01TxHandle *psHandle,
+							tNRF24L01Callback pfnCallback)
+{
+	int ret;
+	PROFILE_START(psRadio);
+
+	ret = _NRF24L01_SendDataAsync(psRadio, RF24_W_TX_PAYLOAD_NOACK, pcData, uiLength, psHandle, pfnCallback);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SEND_DATA_ASYNC);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SendDataAsync
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucCommand	:	RF24_W_TX_PAYLOAD or RF24_W_TX_PAYLOAD_NOACK
+ * 					(others as NRF24L01_SendDataAsync)
+ *
+ * Return		:	Same as NRF24L01_SendDataAsync
+ *
+ */
+
+static int
+_NRF24L01_SendDataAsync(tNRF24L01 *psRadio,
+						unsigned char ucCommand,
+						char *pcData,
+						unsigned int uiLength,
+						tNRF24L01TxHandle *psHandle,
+						tNRF24L01Callback pfnCallback)
+{
+	int ret;
+
+	if(NULL == psHandle)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(psRadio->psTxHandle)
+	{
+		return PDLIB_NRF24_BUSY;
+	}
+
+	if(RF24_W_TX_PAYLOAD_NOACK == ucCommand)
+	{
+		ret = NRF24L01_SetTxPayloadNoAck(psRadio, pcData, uiLength);
+	}else
+	{
+		ret = NRF24L01_SubmitData(psRadio, pcData, uiLength);
+	}
+
+	if(PDLIB_NRF24_SUCCESS == ret)
+	{
+		psHandle->iResult = PDLIB_NRF24_TX_PENDING;
+		psHandle->ucRetries = 0;
+		psHandle->ulElapsedMs = 0;
+		psHandle->pfnCallback = pfnCallback;
+
+		/* PS: Visible to the IRQ before the TX can complete */
+		psRadio->psTxHandle = psHandle;
+
+		NRF24L01_EnableTxMode(psRadio);
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_TxAsyncService
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	Interrupt state of the module before TX_DS and MAX_RT were
+ * 					cleared (same encoding as NRF24L01_GetInterruptState). RX_DR
+ * 					is not cleared.
+ *
+ * Description	: 	Call this from the IRQ handler. Reads and clears TX_DS and MAX_RT
+ * 					in one SPI transaction and completes the asynchronous TX.
+ *
+ */
+
+char
+NRF24L01_TxAsyncService(tNRF24L01 *psRadio)
+{
+	char state;
+	tNRF24L01TxHandle *psHandle = NULL;
+	PROFILE_START(psRadio);
+
+	TRACE(psRadio, PDLIB_NRF24_TRACE_ISR, PDLIB_NRF24_TRACE_ISR_TX_ASYNC, 0, psRadio->ucStatus);
+
+	state = NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+	if(state & (PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT))
+	{
+		psHandle = _NRF24L01_TxAsyncTake(psRadio);
+	}
+
+	if(psHandle)
+	{
+		_NRF24L01_TxAsyncComplete(psRadio, psHandle, ((state & PDLIB_INTERRUPT_DATA_SENT) ? PDLIB_NRF24_SUCCESS : PDLIB_NRF24_TX_ARC_REACHED));
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ISR_TX_ASYNC);
+
+	return state;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_TxPoll
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psHandle	:	Handle given to NRF24L01_SendDataAsync
+ *
+ * Return		: 	PDLIB_NRF24_TX_PENDING or the result of the TX
+ *
+ * Description	: 	Does not talk to the module.
+ *
+ */
+
+int
+NRF24L01_TxPoll(tNRF24L01 *psRadio, tNRF24L01TxHandle *psHandle)
+{
+	int ret = PDLIB_NRF24_INVALID_ARGUMENT;
+
+	(void)psRadio;
+
+	if(psHandle)
+	{
+		ret = psHandle->iResult;
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_TxAsyncTake
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	Handle of the asynchronous TX, NULL if there is none
+ *
+ * Description	: 	Swaps the handle for NULL in one step, so of NRF24L01_Tick and
+ * 					the IRQ handler only one gets it and completes the TX. With GCC
+ * 					this is an atomic exchange, other compilers mask the interrupts
+ * 					for the swap only.
+ *
+ */
+
+static tNRF24L01TxHandle *
+_NRF24L01_TxAsyncTake(tNRF24L01 *psRadio)
+{
+	tNRF24L01TxHandle *psHandle;
+#if defined(__GNUC__)
+	psHandle = __atomic_exchange_n(&psRadio->psTxHandle, NULL, __ATOMIC_ACQ_REL);
+#elif defined(PART_LM4F120H5QR)
+	tBoolean bMasked = ROM_IntMasterDisable();
+
+	psHandle = psRadio->psTxHandle;
+	psRadio->psTxHandle = NULL;
+
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#else
+	psHandle = psRadio->psTxHandle;
+	psRadio->psTxHandle = NULL;
+#endif
+
+	return psHandle;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_TxAsyncComplete
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psHandle	:	Handle taken with _NRF24L01_TxAsyncTake
+ * 					iResult	:	Result of the TX
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Records the retransmission count, flushes a failed payload so it
+ * 					is not sent with the next one, leaves TX mode and notifies.
+ *
+ */
+
+static void
+_NRF24L01_TxAsyncComplete(tNRF24L01 *psRadio, tNRF24L01TxHandle *psHandle, int iResult)
+{
+	psHandle->ucRetries = (NRF24L01_RegisterRead_8(psRadio, RF24_OBSERVE_TX) & 0x0F);
+
+	if(PDLIB_NRF24_SUCCESS != iResult)
+	{
+		NRF24L01_FlushTX(psRadio);
+	}
+
+	NRF24L01_DisableTxMode(psRadio);
+
+	TRACE(psRadio, PDLIB_NRF24_TRACE_TX_DONE, psHandle->ucRetries, 0, (unsigned char)iResult);
+
+	psHandle->iResult = iResult;
+
+	if(psHandle->pfnCallback)
+	{
+		psHandle->pfnCallback(psRadio, iResult);
+	}
+}
+
+
+// ----------------------- Beacon ---------------------- //
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BeaconStart
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Payload sent every time
+ * 					uiLength	:	Length of the payload (1 to 32)
+ * 					ucNoAck		:	1 to send with W_TX_PAYLOAD_NOACK (no ACK, no retransmissions)
+ * 					ulCount		:	Transmissions to make, 0 until NRF24L01_BeaconStop
+ * 					ulPeriodMs	:	Time from the start of one transmission to the next, counted by
+ * 									NRF24L01_Tick. 0 sends them back to back.
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS				: First transmission started
+ * 					PDLIB_NRF24_BUSY				: A beacon or an asynchronous TX is not over
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid arguments
+ * 					PDLIB_NRF24_ERROR				: See NRF24L01_SetTxPayloadNoAck
+ *
+ * Description	: 	Uploads the payload once and sets REUSE_TX_PL, after that every
+ * 					transmission is started with a CE pulse only. The payload is not
+ * 					written over SPI again, a repeat costs the CE pulse and the one SPI
+ * 					transaction clearing TX_DS or MAX_RT.
+ *
+ * 					NRF24L01_BeaconService, called from the IRQ handler (or by
+ * 					NRF24L01_Tick without NRF24L01_CONF_INTERRUPT_PIN), counts the
+ * 					transmissions and starts the next one. The beacon ends by itself
+ * 					after ulCount transmissions, see NRF24L01_IsBeaconActive.
+ *
+ * 					A reused payload keeps its packet ID, so a receiver with auto ack
+ * 					takes every repeat for a retransmission of the first and drops it
+ * 					(after sending the ACK). Beacons for listeners are sent with ucNoAck.
+ *
+ * 					Waits TPD2STBY_US if the module was powered down. Other APIs
+ * 					talking to the module must not be used until the beacon is over.
+ *
+ */
+
+int
+NRF24L01_BeaconStart(	tNRF24L01 *psRadio,
+						char *pcData,
+						unsigned int uiLength,
+						unsigned char ucNoAck,
+						unsigned long ulCount,
+						unsigned long ulPeriodMs)
+{
+	unsigned char ucCommand = RF24_W_TX_PAYLOAD;
+	unsigned char ucPoweredUp;
+
+	if((NULL == pcData) || (0 == uiLength) || (uiLength > 32))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if((BEACON_IDLE != psRadio->ucBeaconState) || psRadio->psTxHandle)
+	{
+		return PDLIB_NRF24_BUSY;
+	}
+
+	// PS: REUSE_TX_PL and FEATURE can only be written out of TX/RX mode
+	_NRF24L01_CELow(psRadio);
+
+	if(ucNoAck)
+	{
+		if(PDLIB_NRF24_SUCCESS != _NRF24L01_NoAckReady(psRadio))
+		{
+			return PDLIB_NRF24_ERROR;
+		}
+
+		ucCommand = RF24_W_TX_PAYLOAD_NOACK;
+	}else
+	{
+		_NRF24L01_SetAckAddress(psRadio);
+	}
+
+	// PS: The payload to reuse is the one on top of the TX FIFO
+	NRF24L01_FlushTX(psRadio);
+	_NRF24L01_WriteTxPayload(psRadio, ucCommand, pcData, uiLength);
+	NRF24L01_SendCommand(psRadio, RF24_REUSE_TX_PL, NULL, 0);
+
+	NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+	ucPoweredUp = (psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP) ? 1 : 0;
+
+	_NRF24L01_RegisterUpdate_8(psRadio, RF24_CONFIG, RF24_PRIM_RX, RF24_PWR_UP);
+	psRadio->uiInternalStates |= INTERNAL_STATE_POWER_UP;
+
+	if(!ucPoweredUp)
+	{
+		// PS: A CE pulse during the crystal start-up is lost. The IRQ wait moves a simulated clock.
+#ifdef NRF24L01_CONF_HAL
+		if(0 != _NRF24L01_WaitIRQ(psRadio, TPD2STBY_US))
+#endif
+		{
+			_NRF24L01_SpinUs(psRadio, TPD2STBY_US);
+		}
+	}
+
+	psRadio->ucBeaconLength = (unsigned char)uiLength;
+	psRadio->ulBeaconCount = ulCount;
+	psRadio->ulBeaconPeriodMs = ulPeriodMs;
+	psRadio->sBeaconStats.ulFired = 0;
+	psRadio->sBeaconStats.ulSent = 0;
+	psRadio->sBeaconStats.ulMaxRT = 0;
+	psRadio->sBeaconStats.ulBytesSaved = 0;
+
+	_NRF24L01_BeaconFire(psRadio);
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BeaconService
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	Interrupt state of the module before TX_DS and MAX_RT were
+ * 					cleared (same encoding as NRF24L01_GetInterruptState).
+ *
+ * Description	: 	Call this from the IRQ handler. Reads and clears TX_DS and MAX_RT
+ * 					in one SPI transaction. When a transmission is over the next one
+ * 					is started right away (no period), left to NRF24L01_Tick, or the
+ * 					beacon ends once ulCount transmissions were made.
+ *
+ * 					MAX_RT does not drop the payload, the next transmission sends it
+ * 					again.
+ *
+ */
+
+char
+NRF24L01_BeaconService(tNRF24L01 *psRadio)
+{
+	char state;
+	PROFILE_START(psRadio);
+
+	TRACE(psRadio, PDLIB_NRF24_TRACE_ISR, PDLIB_NRF24_TRACE_ISR_BEACON, 0, psRadio->ucStatus);
+
+	state = NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+	if((BEACON_TX == psRadio->ucBeaconState) && (state & (PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT)))
+	{
+		if(state & PDLIB_INTERRUPT_DATA_SENT)
+		{
+			psRadio->sBeaconStats.ulSent++;
+		}else
+		{
+			TRACE(psRadio, PDLIB_NRF24_TRACE_MAX_RT, 0, 0, psRadio->ucStatus);
+			psRadio->sBeaconStats.ulMaxRT++;
+		}
+
+		if(psRadio->ulBeaconCount && (psRadio->sBeaconStats.ulFired >= psRadio->ulBeaconCount))
+		{
+			_NRF24L01_BeaconEnd(psRadio);
+		}else if((0 == psRadio->ulBeaconPeriodMs) || (psRadio->ulBeaconElapsedMs >= psRadio->ulBeaconPeriodMs))
+		{
+			_NRF24L01_BeaconFire(psRadio);
+		}else
+		{
+			psRadio->ucBeaconState = BEACON_WAIT;
+		}
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ISR_BEACON);
+
+	return state;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsBeaconActive
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	1 from NRF24L01_BeaconStart until the last transmission is over
+ * 					or NRF24L01_BeaconStop, 0 otherwise
+ *
+ */
+
+int
+NRF24L01_IsBeaconActive(tNRF24L01 *psRadio)
+{
+	return ((BEACON_IDLE != psRadio->ucBeaconState) ? 1 : 0);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BeaconStop
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Cancels the beacon. A transmission on air is cut short. FLUSH_TX
+ * 					ends the reuse of the payload, so the TX FIFO is empty and the
+ * 					other TX APIs can be used again. The module goes to Standby I, or
+ * 					Power Down depending on the power policy (NRF24L01_SetPowerPolicy).
+ *
+ */
+
+void
+NRF24L01_BeaconStop(tNRF24L01 *psRadio)
+{
+#ifdef PART_LM4F120H5QR
+	tBoolean bMasked = ROM_IntMasterDisable();
+#endif
+
+	if(BEACON_IDLE != psRadio->ucBeaconState)
+	{
+		_NRF24L01_BeaconEnd(psRadio);
+	}
+
+#ifdef PART_LM4F120H5QR
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#endif
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetBeaconStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psStats [out]	:	Statistics of the current or last beacon
+ *
+ * Return		: 	None
+ *
+ * Description	: 	ulBytesSaved is (1 + length) for every transmission after the
+ * 					first, what sending the same payload with NRF24L01_SendData would
+ * 					have clocked over SPI on top of the beacon.
+ *
+ */
+
+void
+NRF24L01_GetBeaconStats(tNRF24L01 *psRadio, tNRF24L01BeaconStats *psStats)
+{
+	if(psStats)
+	{
+		*psStats = psRadio->sBeaconStats;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_BeaconFire
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Starts one transmission of the reused payload with a CE pulse.
+ * 					TX_DS and MAX_RT must be clear.
+ *
+ */
+
+static void
+_NRF24L01_BeaconFire(tNRF24L01 *psRadio)
+{
+	if(psRadio->sBeaconStats.ulFired)
+	{
+		psRadio->sBeaconStats.ulBytesSaved += (1 + psRadio->ucBeaconLength);
+	}
+
+	psRadio->sBeaconStats.ulFired++;
+	psRadio->ulBeaconElapsedMs = 0;
+	psRadio->ucBeaconState = BEACON_TX;
+
+	_NRF24L01_CEPulse(psRadio);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_BeaconEnd
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ */
+
+static void
+_NRF24L01_BeaconEnd(tNRF24L01 *psRadio)
+{
+	psRadio->ucBeaconState = BEACON_IDLE;
+
+	_NRF24L01_CELow(psRadio);
+
+	// PS: Also ends REUSE_TX_PL
+	NRF24L01_FlushTX(psRadio);
+
+	NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+	_NRF24L01_ApplyPowerPolicy(psRadio);
+}
+
+
+// ----------------------- TX queue ---------------------- //
+
+#ifdef NRF24L01_CONF_TX_QUEUE
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_QueueData
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Data packet to send
+ * 					uiLength	:	Length of the packet (1 to 32)
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS			: Packet queued
+ * 					PDLIB_NRF24_TX_QUEUE_FULL	: Software queue is full, packet dropped
+ * 					PDLIB_NRF24_ERROR			: Invalid arguments
+ *
+ * Description	: 	Copies the packet to the software TX queue and returns. If the
+ * 					queue is idle the TX FIFO of the module is loaded and the module
+ * 					is put into TX mode, after that NRF24L01_TxQueueService (called
+ * 					from the IRQ handler) keeps the TX FIFO full until the queue is
+ * 					empty. The module is left in Standby I when the queue drains.
+ *
+ * 					Other APIs talking to the module must not be used while the
+ * 					queue is active (see NRF24L01_IsTxQueueActive), the IRQ handler
+ * 					uses the SPI bus.
+ *
+ */
+
+int
+NRF24L01_QueueData(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength)
+{
+	int ret;
+	PROFILE_START(psRadio);
+
+	ret = _NRF24L01_QueueData(psRadio, RF24_W_TX_PAYLOAD, pcData, uiLength);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_QUEUE_DATA);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_QueueDataNoAck
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Data packet to send
+ * 					uiLength	:	Length of the packet (1 to 32)
+ *
+ * Return		:	Same as NRF24L01_QueueData. PDLIB_NRF24_ERROR also when
+ * 					W_TX_PAYLOAD_NOACK is not enabled and the queue is active.
+ *
+ * Description	: 	Queues a packet sent without asking for an ACK
+ * 					(W_TX_PAYLOAD_NOACK), ACKed and unACKed packets can be mixed.
+ * 					The command is enabled on first use, which needs the queue to be
+ * 					idle; call NRF24L01_EnableFeatureNoAckTx at start-up to skip that.
+ *
+ */
+
+int
+NRF24L01_QueueDataNoAck(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength)
+{
+	int ret;
+	PROFILE_START(psRadio);
+
+	ret = _NRF24L01_QueueData(psRadio, RF24_W_TX_PAYLOAD_NOACK, pcData, uiLength);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_QUEUE_DATA);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_QueueData
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucCommand	:	RF24_W_TX_PAYLOAD or RF24_W_TX_PAYLOAD_NOACK
+ * 					pcData		:	Data packet to send
+ * 					uiLength	:	Length of the packet (1 to 32)
+ *
+ * Return		:	Same as NRF24L01_QueueData
+ *
+ */
+
+static int
+_NRF24L01_QueueData(tNRF24L01 *psRadio, unsigned char ucCommand, char *pcData, unsigned int uiLength)
+{
+	int ret = PDLIB_NRF24_SUCCESS;
+	unsigned int uiHead;
+	unsigned int uiNext;
+	unsigned int uiDepth;
+	unsigned int i;
+#ifdef PART_LM4F120H5QR
+	tBoolean bMasked;
+#endif
+
+	if((NULL == pcData) || (0 == uiLength) || (uiLength > 32))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	/* PS: EN_DYN_ACK can not be written while the queue holds CE high */
+	if((RF24_W_TX_PAYLOAD_NOACK == ucCommand) && (0 == (psRadio->ucShadow[RF24_FEATURE] & RF24_EN_DYN_ACK)) &&
+	   (psRadio->ucTxQueueActive || (PDLIB_NRF24_SUCCESS != _NRF24L01_NoAckReady(psRadio))))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	uiHead = psRadio->uiTxQueueHead;
+	uiNext = ((uiHead + 1) % TX_QUEUE_SIZE);
+
+	if(uiNext == psRadio->uiTxQueueTail)
+	{
+		psRadio->sTxQueueStats.ulDropped++;
+		return PDLIB_NRF24_TX_QUEUE_FULL;
+	}
+
+	for(i = 0; i < uiLength; i++)
+	{
+		psRadio->cTxQueueData[uiHead][i] = pcData[i];
+	}
+
+	psRadio->ucTxQueueLength[uiHead] = uiLength;
+	psRadio->ucTxQueueCommand[uiHead] = ucCommand;
+
+	/* PS: Publish the slot only after it is filled */
+	psRadio->uiTxQueueHead = uiNext;
+
+	psRadio->sTxQueueStats.ulQueued++;
+
+	uiDepth = ((uiNext + TX_QUEUE_SIZE - psRadio->uiTxQueueTail) % TX_QUEUE_SIZE);
+
+	if(uiDepth > psRadio->sTxQueueStats.uiHighWater)
+	{
+		psRadio->sTxQueueStats.uiHighWater = uiDepth;
+	}
+
+	/* PS: Start the queue if the IRQ is not already draining it */
+#ifdef PART_LM4F120H5QR
+	bMasked = ROM_IntMasterDisable();
+#endif
+
+	if(0 == psRadio->ucTxQueueActive)
+	{
+		psRadio->ucTxQueueActive = 1;
+		psRadio->ucTxQueueRetries = 0;
+
+		_NRF24L01_SetAckAddress(psRadio);
+
+		/* PS: A failed NRF24L01_SendData leaves its payload behind, so the TX FIFO is checked
+		 * once. Not empty counts as 2, the refill makes it 3 if TX_FULL is set. */
+		psRadio->ucTxQueueFifo = (NRF24L01_RegisterRead_8(psRadio, RF24_FIFO_STATUS) & RF24_TX_EMPTY) ? 0 : 2;
+
+		_NRF24L01_TxQueueRefill(psRadio);
+
+		NRF24L01_EnableTxMode(psRadio);
+	}
+
+#ifdef PART_LM4F120H5QR
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#endif
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_TxQueueService
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	Interrupt state of the module before TX_DS and MAX_RT were
+ * 					cleared (same encoding as NRF24L01_GetInterruptState). RX_DR
+ * 					is not cleared, it is left to the caller (eg. ACK payloads).
+ *
+ * Description	: 	Call this from the IRQ handler. Reads and clears TX_DS and MAX_RT
+ * 					in one SPI transaction and moves queued packets to the TX FIFO.
+ *
+ * 					On MAX_RT the payload stays in the TX FIFO and is retried once the
+ * 					flag is cleared. After NRF24L01_CONF_TX_QUEUE_RETRIES retries the
+ * 					TX FIFO is flushed, which also drops the payloads loaded behind
+ * 					the failing one (counted in ulFlushed), and the queue moves on.
+ *
+ */
+
+char
+NRF24L01_TxQueueService(tNRF24L01 *psRadio)
+{
+	char state;
+	PROFILE_START(psRadio);
+
+	TRACE(psRadio, PDLIB_NRF24_TRACE_ISR, PDLIB_NRF24_TRACE_ISR_TX_QUEUE, 0, psRadio->ucStatus);
+
+	state = NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+	if(state & PDLIB_INTERRUPT_DATA_SENT)
+	{
+		psRadio->sTxQueueStats.ulSent++;
+		psRadio->ucTxQueueRetries = 0;
+
+		/* PS: Two payloads sent before the handler ran give one TX_DS, so the count may stay high */
+		if(psRadio->ucTxQueueFifo)
+		{
+			psRadio->ucTxQueueFifo--;
+		}
+	}
+
+	if(state & PDLIB_INTERRUPT_MAX_RT)
+	{
+		psRadio->sTxQueueStats.ulMaxRT++;
+
+		if(psRadio->ucTxQueueRetries < NRF24L01_CONF_TX_QUEUE_RETRIES)
+		{
+			psRadio->ucTxQueueRetries++;
+			psRadio->sTxQueueStats.ulRetried++;
+		}else
+		{
+			NRF24L01_FlushTX(psRadio);
+
+			psRadio->sTxQueueStats.ulFlushed += psRadio->ucTxQueueFifo;
+			psRadio->ucTxQueueFifo = 0;
+			psRadio->ucTxQueueRetries = 0;
+		}
+	}
+
+	if(psRadio->ucTxQueueActive && (state & (PDLIB_INTERRUPT_DATA_SENT | PDLIB_INTERRUPT_MAX_RT)))
+	{
+		_NRF24L01_TxQueueRefill(psRadio);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ISR_TX_QUEUE);
+
+	return state;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_TxQueueRefill
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Moves packets from the software queue to the TX FIFO until either
+ * 					is full/empty. When both are empty the module goes to Standby I
+ * 					and the queue becomes idle.
+ *
+ * 					The TX FIFO is not read for every payload. ucTxQueueFifo is never
+ * 					below the real number of payloads, so the FIFO is not overfilled,
+ * 					and TX_FULL of the status clocked out by the write which cleared
+ * 					the interrupt brings it back down. FIFO_STATUS is only read when
+ * 					the software queue is empty and the count says the FIFO may still
+ * 					hold payloads.
+ *
+ */
+
+static void
+_NRF24L01_TxQueueRefill(tNRF24L01 *psRadio)
+{
+	unsigned int uiTail = psRadio->uiTxQueueTail;
+
+	/* PS: The last status was sampled after the FIFO last changed. A count of 0 is exact
+	 * (eg. after the flush), the status of FLUSH_TX is not. */
+	if(psRadio->ucTxQueueFifo)
+	{
+		if(psRadio->ucStatus & RF24_TX_FULL)
+		{
+			psRadio->ucTxQueueFifo = 3;
+		}else if(psRadio->ucTxQueueFifo >= 3)
+		{
+			psRadio->ucTxQueueFifo = 2;
+		}
+	}
+
+	while((uiTail != psRadio->uiTxQueueHead) && (psRadio->ucTxQueueFifo < 3))
+	{
+		NRF24L01_SendCommand(psRadio, psRadio->ucTxQueueCommand[uiTail], psRadio->cTxQueueData[uiTail], psRadio->ucTxQueueLength[uiTail]);
+
+		psRadio->ucTxQueueFifo++;
+
+		uiTail = ((uiTail + 1) % TX_QUEUE_SIZE);
+		psRadio->uiTxQueueTail = uiTail;
+
+		psRadio->sTxQueueStats.ulLoaded++;
+	}
+
+	if((uiTail == psRadio->uiTxQueueHead) && psRadio->ucTxQueueFifo)
+	{
+		if(NRF24L01_RegisterRead_8(psRadio, RF24_FIFO_STATUS) & RF24_TX_EMPTY)
+		{
+			psRadio->ucTxQueueFifo = 0;
+		}
+	}
+
+	if((uiTail == psRadio->uiTxQueueHead) && (0 == psRadio->ucTxQueueFifo))
+	{
+		NRF24L01_DisableTxMode(psRadio);
+
+		psRadio->ucTxQueueActive = 0;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FlushTxQueue
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Drops the packets waiting in the software queue. Packets already
+ * 					in the TX FIFO of the module are still sent.
+ *
+ */
+
+void
+NRF24L01_FlushTxQueue(tNRF24L01 *psRadio)
+{
+#ifdef PART_LM4F120H5QR
+	tBoolean bMasked = ROM_IntMasterDisable();
+#endif
+
+	psRadio->uiTxQueueHead = psRadio->uiTxQueueTail;
+
+#ifdef PART_LM4F120H5QR
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#endif
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsTxQueueActive
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	1 if the queue is being sent, 0 if it is idle
+ *
+ * Description	: 	The queue is active from the first NRF24L01_QueueData until both
+ * 					the software queue and the TX FIFO are empty.
+ *
+ */
+
+int
+NRF24L01_IsTxQueueActive(tNRF24L01 *psRadio)
+{
+	return (psRadio->ucTxQueueActive ? 1 : 0);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetTxQueueStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psStats [out]	:	Statistics of the software TX queue
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Copies the queue statistics. uiHighWater close to
+ * 					NRF24L01_CONF_TX_QUEUE_DEPTH or a non zero ulDropped means the
+ * 					queue is too short for the traffic.
+ *
+ */
+
+void
+NRF24L01_GetTxQueueStats(tNRF24L01 *psRadio, tNRF24L01TxQueueStats *psStats)
+{
+	if(psStats)
+	{
+		*psStats = psRadio->sTxQueueStats;
+
+		psStats->uiDepth = ((psRadio->uiTxQueueHead + TX_QUEUE_SIZE - psRadio->uiTxQueueTail) % TX_QUEUE_SIZE);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ResetTxQueueStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Clears the counters and the high-water mark.
+ *
+ */
+
+void
+NRF24L01_ResetTxQueueStats(tNRF24L01 *psRadio)
+{
+	psRadio->sTxQueueStats.uiHighWater = 0;
+	psRadio->sTxQueueStats.ulQueued = 0;
+	psRadio->sTxQueueStats.ulDropped = 0;
+	psRadio->sTxQueueStats.ulLoaded = 0;
+	psRadio->sTxQueueStats.ulSent = 0;
+	psRadio->sTxQueueStats.ulMaxRT = 0;
+	psRadio->sTxQueueStats.ulRetried = 0;
+	psRadio->sTxQueueStats.ulFlushed = 0;
+}
+
+#endif
+
+
+// ----------------------- TX stream ---------------------- //
+
+#ifdef NRF24L01_CONF_TX_STREAM
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_StreamStart
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcBuffer	:	Stream buffer, uiSlots * ucPayloadLength bytes, owned by
+ * 									the application until NRF24L01_StreamStop
+ * 					uiSlots		:	Payloads the buffer holds, a power of two
+ * 					ucPayloadLength	:	Length of every payload (1 to 32)
+ * 					ucNoAck		:	1 to send with W_TX_PAYLOAD_NOACK (no ACK, no retransmission)
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS			: Stream running
+ * 					PDLIB_NRF24_BUSY			: A stream is already running
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid arguments
+ * 					PDLIB_NRF24_ERROR			: See NRF24L01_SetTxPayloadNoAck
+ *
+ * Description	: 	Puts the module into TX mode and keeps CE high until
+ * 					NRF24L01_StreamStop. The module sends whatever is in the TX FIFO
+ * 					back to back and waits in Standby II when the FIFO is empty, so no
+ * 					packet pays for the CE pulse and the Standby I round trip.
+ *
+ * 					Payloads written with NRF24L01_StreamWrite are moved to the TX FIFO
+ * 					by NRF24L01_StreamService, called from the IRQ handler or polled
+ * 					from the main loop at least once every three packets. The TX FIFO
+ * 					running empty while the stream runs is an underrun (see
+ * 					NRF24L01_GetStreamStats), the end of the data counts as one.
+ *
+ * 					Other APIs talking to the module must not be used while the stream
+ * 					runs.
+ *
+ */
+
+int
+NRF24L01_StreamStart(	tNRF24L01 *psRadio,
+						char *pcBuffer,
+						unsigned int uiSlots,
+						unsigned char ucPayloadLength,
+						unsigned char ucNoAck)
+{
+	/* PS: Head and tail run free and wrap at 2^32, which keeps the slot sequence only if
+	 * uiSlots divides 2^32 */
+	if((NULL == pcBuffer) || (0 == uiSlots) || (0 != (uiSlots & (uiSlots - 1))) ||
+	   (0 == ucPayloadLength) || (ucPayloadLength > 32))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(STREAM_STOPPED != psRadio->ucStreamState)
+	{
+		return PDLIB_NRF24_BUSY;
+	}
+
+	psRadio->pcStreamBuffer = pcBuffer;
+	psRadio->uiStreamSlots = uiSlots;
+	psRadio->ucStreamLength = ucPayloadLength;
+	psRadio->uiStreamHead = 0;
+	psRadio->uiStreamTail = 0;
+
+	if(ucNoAck)
+	{
+		// PS: Needs EN_DYN_ACK, which can only be written before CE goes high
+		if(PDLIB_NRF24_SUCCESS != _NRF24L01_NoAckReady(psRadio))
+		{
+			return PDLIB_NRF24_ERROR;
+		}
+
+		psRadio->ucStreamCommand = RF24_W_TX_PAYLOAD_NOACK;
+	}else
+	{
+		_NRF24L01_SetAckAddress(psRadio);
+
+		psRadio->ucStreamCommand = RF24_W_TX_PAYLOAD;
+	}
+
+	// PS: Nothing loaded yet, the empty FIFO is not an underrun
+	psRadio->ucStreamState = STREAM_STARVED;
+
+	NRF24L01_EnableTxMode(psRadio);
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_StreamWrite
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Payload, the length given to NRF24L01_StreamStart
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS			: Payload written
+ * 					PDLIB_NRF24_TX_QUEUE_FULL	: Stream buffer is full, payload dropped
+ * 					PDLIB_NRF24_ERROR			: No stream running or invalid arguments
+ *
+ * Description	: 	Copies the payload to the stream buffer. If the buffer was empty
+ * 					the TX FIFO is topped up right away, otherwise NRF24L01_StreamService
+ * 					loads the payload when the module has room.
+ *
+ */
+
+int
+NRF24L01_StreamWrite(tNRF24L01 *psRadio, char *pcData)
+{
+	unsigned int uiHead;
+	unsigned int uiDepth;
+	char *pcSlot;
+	unsigned char i;
+#ifdef PART_LM4F120H5QR
+	tBoolean bMasked;
+#endif
+	PROFILE_START(psRadio);
+
+	if((NULL == pcData) || (STREAM_STOPPED == psRadio->ucStreamState))
+	{
+		PROFILE_END(psRadio, PDLIB_NRF24_PROF_STREAM_WRITE);
+		return PDLIB_NRF24_ERROR;
+	}
+
+	// PS: Head and tail count payloads and wrap on their own, the slot is the count modulo uiSlots (a power of two)
+	uiHead = psRadio->uiStreamHead;
+	uiDepth = (uiHead - psRadio->uiStreamTail);
+
+	if(uiDepth >= psRadio->uiStreamSlots)
+	{
+		psRadio->sStreamStats.ulDropped++;
+		PROFILE_END(psRadio, PDLIB_NRF24_PROF_STREAM_WRITE);
+		return PDLIB_NRF24_TX_QUEUE_FULL;
+	}
+
+	pcSlot = psRadio->pcStreamBuffer + ((uiHead & (psRadio->uiStreamSlots - 1)) * psRadio->ucStreamLength);
+
+	for(i = 0; i < psRadio->ucStreamLength; i++)
+	{
+		pcSlot[i] = pcData[i];
+	}
+
+	/* PS: Publish the slot only after it is filled */
+	psRadio->uiStreamHead = (uiHead + 1);
+
+	psRadio->sStreamStats.ulWritten++;
+
+	if((uiDepth + 1) > psRadio->sStreamStats.uiHighWater)
+	{
+		psRadio->sStreamStats.uiHighWater = (uiDepth + 1);
+	}
+
+	/* PS: No TX_DS is coming to refill an empty FIFO, and with an empty buffer the FIFO
+	 * may have room the last refill could not fill. Load it from here. */
+#ifdef PART_LM4F120H5QR
+	bMasked = ROM_IntMasterDisable();
+#endif
+
+	if((STREAM_STARVED == psRadio->ucStreamState) || (0 == uiDepth))
+	{
+		_NRF24L01_StreamRefill(psRadio);
+	}
+
+#ifdef PART_LM4F120H5QR
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#endif
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_STREAM_WRITE);
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_StreamService
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	Interrupt state of the module before TX_DS and MAX_RT were
+ * 					cleared (same encoding as NRF24L01_GetInterruptState).
+ *
+ * Description	: 	Call this from the IRQ handler, or from the main loop without one.
+ * 					Reads and clears TX_DS and MAX_RT in one SPI transaction and tops
+ * 					the TX FIFO up from the stream buffer.
+ *
+ * 					On MAX_RT the payload stays in the TX FIFO and is retried once the
+ * 					flag is cleared, the same way the TX queue does it.
+ *
+ */
+
+char
+NRF24L01_StreamService(tNRF24L01 *psRadio)
+{
+	char state;
+	PROFILE_START(psRadio);
+
+	TRACE(psRadio, PDLIB_NRF24_TRACE_ISR, PDLIB_NRF24_TRACE_ISR_STREAM, 0, psRadio->ucStatus);
+
+	state = NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+	if(state & PDLIB_INTERRUPT_DATA_SENT)
+	{
+		psRadio->sStreamStats.ulSent++;
+	}
+
+	if(state & PDLIB_INTERRUPT_MAX_RT)
+	{
+		psRadio->sStreamStats.ulMaxRT++;
+	}
+
+	if(STREAM_STOPPED != psRadio->ucStreamState)
+	{
+		_NRF24L01_StreamRefill(psRadio);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ISR_STREAM);
+
+	return state;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_StreamRefill
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Moves payloads from the stream buffer to the TX FIFO until either is
+ * 					full/empty. FIFO_STATUS is read once per call while the FIFO was
+ * 					found empty (three free slots), once per payload otherwise.
+ *
+ */
+
+static void
+_NRF24L01_StreamRefill(tNRF24L01 *psRadio)
+{
+	unsigned char ucFifoStatus;
+	unsigned char ucFree;
+	unsigned int uiTail = psRadio->uiStreamTail;
+
+	ucFifoStatus = NRF24L01_RegisterRead_8(psRadio, RF24_FIFO_STATUS);
+
+	if(ucFifoStatus & RF24_TX_EMPTY)
+	{
+		if(STREAM_RUNNING == psRadio->ucStreamState)
+		{
+			// PS: The module sat in Standby II, count the gap once
+			psRadio->sStreamStats.ulUnderruns++;
+			psRadio->ucStreamState = STREAM_STARVED;
+
+			TRACE(psRadio, PDLIB_NRF24_TRACE_UNDERRUN, 0, (psRadio->uiStreamHead - uiTail), psRadio->ucStatus);
+		}
+
+		ucFree = 3;
+	}else
+	{
+		ucFree = ((ucFifoStatus & RF24_FIFO_FULL) ? 0 : 1);
+	}
+
+	while(ucFree && (uiTail != psRadio->uiStreamHead))
+	{
+		NRF24L01_SendCommand(psRadio, psRadio->ucStreamCommand,
+							 psRadio->pcStreamBuffer + ((uiTail & (psRadio->uiStreamSlots - 1)) * psRadio->ucStreamLength),
+							 psRadio->ucStreamLength);
+
+		uiTail++;
+		psRadio->uiStreamTail = uiTail;
+
+		psRadio->sStreamStats.ulLoaded++;
+		psRadio->ucStreamState = STREAM_RUNNING;
+
+		if(--ucFree == 0)
+		{
+			// PS: Only one slot was known to be free, there may be more
+			ucFifoStatus = NRF24L01_RegisterRead_8(psRadio, RF24_FIFO_STATUS);
+
+			ucFree = ((ucFifoStatus & RF24_FIFO_FULL) ? 0 : 1);
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsStreamIdle
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	1 if every payload written is out of the stream buffer and the TX
+ * 					FIFO ran empty, 0 otherwise
+ *
+ * Description	: 	Wait for this before NRF24L01_StreamStop to let the stream drain.
+ * 					The empty FIFO is only seen by NRF24L01_StreamService, keep
+ * 					calling it (or let the IRQ do it) while waiting.
+ *
+ */
+
+int
+NRF24L01_IsStreamIdle(tNRF24L01 *psRadio)
+{
+	return (((STREAM_RUNNING != psRadio->ucStreamState) && (psRadio->uiStreamHead == psRadio->uiStreamTail)) ? 1 : 0);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_StreamStop
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Drops CE, flushes the TX FIFO and drops the payloads still in the
+ * 					stream buffer. The module goes to Standby I, or Power Down
+ * 					depending on the power policy (NRF24L01_SetPowerPolicy). The
+ * 					buffer belongs to the application again.
+ *
+ */
+
+void
+NRF24L01_StreamStop(tNRF24L01 *psRadio)
+{
+#ifdef PART_LM4F120H5QR
+	tBoolean bMasked = ROM_IntMasterDisable();
+#endif
+
+	if(STREAM_STOPPED != psRadio->ucStreamState)
+	{
+		psRadio->ucStreamState = STREAM_STOPPED;
+
+		NRF24L01_DisableTxMode(psRadio);
+		NRF24L01_FlushTX(psRadio);
+
+		psRadio->uiStreamTail = psRadio->uiStreamHead;
+	}
+
+#ifdef PART_LM4F120H5QR
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#endif
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetStreamStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psStats [out]	:	Statistics of the TX stream
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Copies the stream statistics. A growing ulUnderruns with payloads
+ * 					waiting (uiHighWater > 0) means NRF24L01_StreamService runs too
+ * 					late, with an empty buffer the producer is too slow.
+ *
+ */
+
+void
+NRF24L01_GetStreamStats(tNRF24L01 *psRadio, tNRF24L01StreamStats *psStats)
+{
+	if(psStats)
+	{
+		*psStats = psRadio->sStreamStats;
+
+		psStats->uiDepth = (psRadio->uiStreamHead - psRadio->uiStreamTail);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ResetStreamStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Clears the counters and the high-water mark.
+ *
+ */
+
+void
+NRF24L01_ResetStreamStats(tNRF24L01 *psRadio)
+{
+	psRadio->sStreamStats.uiHighWater = 0;
+	psRadio->sStreamStats.ulWritten = 0;
+	psRadio->sStreamStats.ulDropped = 0;
+	psRadio->sStreamStats.ulLoaded = 0;
+	psRadio->sStreamStats.ulSent = 0;
+	psRadio->sStreamStats.ulMaxRT = 0;
+	psRadio->sStreamStats.ulUnderruns = 0;
+}
+
+#endif
+
+
+// ----------------------- RX queue ---------------------- //
+
+#ifdef NRF24L01_CONF_RX_QUEUE
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RxQueueService
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	Interrupt state of the module before RX_DR was cleared (same
+ * 					encoding as NRF24L01_GetInterruptState). TX_DS and MAX_RT are
+ * 					not cleared.
+ *
+ * Description	: 	Call this from the IRQ handler. RX_DR is cleared first and then
+ * 					every payload in the RX FIFO is moved to the RX ring, until the
+ * 					RX FIFO is empty. A packet arriving after RX_DR was cleared sets
+ * 					it again, so none is left behind without an interrupt.
+ *
+ * 					If the ring is full the payload is still read (to make space in
+ * 					the RX FIFO) and counted as dropped.
+ *
+ */
+
+char
+NRF24L01_RxQueueService(tNRF24L01 *psRadio)
+{
+	char state;
+	char cLength = 0;
+	unsigned char ucPipe;
+	unsigned int uiHead;
+	unsigned int uiNext;
+	unsigned int uiDepth;
+	tNRF24L01RxSlot sDiscard;
+	tNRF24L01RxSlot *psSlot;
+	PROFILE_START(psRadio);
+
+	TRACE(psRadio, PDLIB_NRF24_TRACE_ISR, PDLIB_NRF24_TRACE_ISR_RX_QUEUE, 0, psRadio->ucStatus);
+
+	/* PS: The status clocked out by this write also tells the pipe of the first payload */
+	state = NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_DATA_READY);
+
+	while(1)
+	{
+		if(psRadio->uiInternalStates & INTERNAL_STATE_DYNPL)
+		{
+			/* PS: The status of R_RX_PL_WID tells the pipe, no separate status read */
+			NRF24L01_SendRcvCommand(psRadio, RF24_R_RX_PL_WID, &cLength, 1);
+		}else if(((psRadio->ucStatus & (BIT3 | BIT2 | BIT1)) >> 1) > 5)
+		{
+			NRF24L01_GetStatus(psRadio);
+		}
+
+		ucPipe = ((psRadio->ucStatus & (BIT3 | BIT2 | BIT1)) >> 1);
+
+		if(ucPipe > 5)
+		{
+			/* PS: RX FIFO is empty */
+			break;
+		}
+
+		if(0 == (psRadio->uiInternalStates & INTERNAL_STATE_DYNPL))
+		{
+			cLength = (psRadio->ucShadow[RF24_RX_PW_P0 + ucPipe] & 0x3F);
+		}
+
+		if((cLength <= 0) || (cLength > 32))
+		{
+			/* PS: Corrupted width, the datasheet asks to flush the RX FIFO */
+			NRF24L01_FlushRX(psRadio);
+			psRadio->sRxQueueStats.ulInvalid++;
+			break;
+		}
+
+		uiHead = psRadio->uiRxQueueHead;
+		uiNext = ((uiHead + 1) % RX_QUEUE_SIZE);
+
+		if(uiNext == psRadio->uiRxQueueTail)
+		{
+			psSlot = &sDiscard;
+			psRadio->sRxQueueStats.ulDropped++;
+		}else
+		{
+			psSlot = &psRadio->sRxQueue[uiHead];
+		}
+
+		NRF24L01_ReadRxPayload(psRadio, psSlot->cData, cLength);
+
+		if(psSlot != &sDiscard)
+		{
+			psSlot->ucLength = cLength;
+			psSlot->ucPipe = ucPipe;
+
+			/* PS: Publish the slot only after it is filled */
+			psRadio->uiRxQueueHead = uiNext;
+
+			psRadio->sRxQueueStats.ulReceived++;
+
+			uiDepth = ((uiNext + RX_QUEUE_SIZE - psRadio->uiRxQueueTail) % RX_QUEUE_SIZE);
+
+			if(uiDepth > psRadio->sRxQueueStats.uiHighWater)
+			{
+				psRadio->sRxQueueStats.uiHighWater = uiDepth;
+			}
+		}
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ISR_RX_QUEUE);
+
+	return state;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RxQueueGet
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData [out]	:	Buffer to copy the payload to
+ * 					uiSize			:	Size of pcData
+ * 					pcPipeNo [out]	:	Pipe the payload was received on (can be NULL)
+ *
+ * Return		: 	Positive						:	Number of bytes copied
+ * 					PDLIB_NRF24_ERROR				:	Ring is empty
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	pcData is smaller than the payload,
+ * 														the payload is left in the ring
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	pcData is NULL
+ *
+ * Description	: 	Takes the oldest payload out of the RX ring. Does not use the SPI
+ * 					bus, so it can be called at any pace from the application.
+ *
+ */
+
+int
+NRF24L01_RxQueueGet(tNRF24L01 *psRadio, char *pcData, unsigned int uiSize, char *pcPipeNo)
+{
+	int ret;
+	unsigned int uiTail = psRadio->uiRxQueueTail;
+	unsigned int i;
+	tNRF24L01RxSlot *psSlot;
+	PROFILE_START(psRadio);
+
+	if(NULL == pcData)
+	{
+		ret = PDLIB_NRF24_INVALID_ARGUMENT;
+	}else if(uiTail == psRadio->uiRxQueueHead)
+	{
+		ret = PDLIB_NRF24_ERROR;
+	}else
+	{
+		psSlot = &psRadio->sRxQueue[uiTail];
+
+		if(uiSize < psSlot->ucLength)
+		{
+			ret = PDLIB_NRF24_BUFFER_TOO_SMALL;
+		}else
+		{
+			for(i = 0; i < psSlot->ucLength; i++)
+			{
+				pcData[i] = psSlot->cData[i];
+			}
+
+			if(pcPipeNo)
+			{
+				*pcPipeNo = psSlot->ucPipe;
+			}
+
+			ret = psSlot->ucLength;
+
+			/* PS: Release the slot only after it is copied */
+			psRadio->uiRxQueueTail = ((uiTail + 1) % RX_QUEUE_SIZE);
+		}
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_RX_QUEUE_GET);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RxQueueCount
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	Number of payloads waiting in the RX ring
+ *
+ * Description	: 	Number of payloads waiting in the RX ring
+ *
+ */
+
+int
+NRF24L01_RxQueueCount(tNRF24L01 *psRadio)
+{
+	return ((psRadio->uiRxQueueHead + RX_QUEUE_SIZE - psRadio->uiRxQueueTail) % RX_QUEUE_SIZE);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FlushRxQueue
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Drops every payload waiting in the RX ring.
+ *
+ */
+
+void
+NRF24L01_FlushRxQueue(tNRF24L01 *psRadio)
+{
+	psRadio->uiRxQueueTail = psRadio->uiRxQueueHead;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetRxQueueStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psStats [out]	:	Statistics of the RX ring
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Copies the ring statistics. A non zero ulDropped means the
+ * 					application does not keep up or NRF24L01_CONF_RX_QUEUE_DEPTH
+ * 					is too small for the bursts.
+ *
+ */
+
+void
+NRF24L01_GetRxQueueStats(tNRF24L01 *psRadio, tNRF24L01RxQueueStats *psStats)
+{
+	if(psStats)
+	{
+		*psStats = psRadio->sRxQueueStats;
+
+		psStats->uiDepth = NRF24L01_RxQueueCount(psRadio);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ResetRxQueueStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Clears the counters and the high-water mark.
+ *
+ */
+
+void
+NRF24L01_ResetRxQueueStats(tNRF24L01 *psRadio)
+{
+	psRadio->sRxQueueStats.uiHighWater = 0;
+	psRadio->sRxQueueStats.ulReceived = 0;
+	psRadio->sRxQueueStats.ulDropped = 0;
+	psRadio->sRxQueueStats.ulInvalid = 0;
+}
+
+#endif
+
+
+// ----------------------- SPI engine ---------------------- //
+
+#ifdef NRF24L01_CONF_SPI_ENGINE
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SPIEngineSubmit
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psOp	:	Transaction to run. Must stay valid until its pfnComplete
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Queued (started if the engine was idle)
+ *					PDLIB_NRF24_BUSY				:	NRF24L01_CONF_SPI_ENGINE_DEPTH descriptors wait already
+ *					PDLIB_NRF24_INVALID_ARGUMENT	:	psOp is NULL
+ *					PDLIB_NRF24_ERROR				:	The backend has no SSI FIFO functions
+ *
+ * Description	: 	Queues one SPI transaction and returns at once. The transactions
+ * 					run in the order they were submitted, one CSN low period each:
+ * 					the command and the data go to the TX FIFO (at most
+ * 					ENGINE_FIFO_DEPTH bytes in flight) and NRF24L01_SPIEngineService,
+ * 					called from the SSI interrupt, drains the RX FIFO, tops the TX
+ * 					FIFO up and raises CSN when the last byte is in. The next
+ * 					descriptor starts from the same interrupt, without a round trip
+ * 					through the application.
+ *
+ * 					Can be called from the completion callback and from interrupts
+ * 					which do not preempt the SSI interrupt. The blocking functions
+ * 					of the driver wait for the engine to go idle (built-in SSI code)
+ * 					and must not be used while it runs on a backend. A descriptor
+ * 					submitted while a blocking function holds CSN low waits until
+ * 					it raises CSN.
+ *
+ */
+
+int
+NRF24L01_SPIEngineSubmit(tNRF24L01 *psRadio, tNRF24L01SPIOp *psOp)
+{
+	unsigned int uiHead;
+	unsigned int uiNext;
+	unsigned int uiDepth;
+	int iReturn = PDLIB_NRF24_SUCCESS;
+
+	if(NULL == psOp)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+#ifdef NRF24L01_CONF_HAL
+	if(!psRadio->psHAL->pfnFifoPut || !psRadio->psHAL->pfnFifoGet || !psRadio->psHAL->pfnFifoInt || !psRadio->psHAL->pfnSetCSN)
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+#endif
+
+	/* PS: Keeps the SSI interrupt out while the queue and the busy flag are looked at */
+	_NRF24L01_EngineInt(psRadio, 0);
+
+	uiHead = psRadio->uiEngineHead;
+	uiNext = ((uiHead + 1) % ENGINE_QUEUE_SIZE);
+
+	if(uiNext == psRadio->uiEngineTail)
+	{
+		psRadio->sEngineStats.ulRejected++;
+		iReturn = PDLIB_NRF24_BUSY;
+	}else
+	{
+		psRadio->psEngineQueue[uiHead] = psOp;
+		psRadio->uiEngineHead = uiNext;
+		psRadio->sEngineStats.ulSubmitted++;
+
+		uiDepth = ((uiNext + ENGINE_QUEUE_SIZE - psRadio->uiEngineTail) % ENGINE_QUEUE_SIZE);
+
+		if(uiDepth > psRadio->sEngineStats.uiHighWater)
+		{
+			psRadio->sEngineStats.uiHighWater = uiDepth;
+		}
+
+		/* PS: A blocking transaction holding CSN low starts the queue when it raises CSN */
+		if(!psRadio->ucEngineBusy && !psRadio->ucBusHeld)
+		{
+			_NRF24L01_EngineStart(psRadio);
+		}
+	}
+
+	if(psRadio->ucEngineBusy)
+	{
+		_NRF24L01_EngineInt(psRadio, 1);
+	}
+
+	return iReturn;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SPIEngineService
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Call this from the SSI interrupt handler (RX FIFO half full or
+ * 					RX timeout). Moves the received bytes to the descriptor, refills
+ * 					the TX FIFO and completes the transaction once all of its bytes
+ * 					are in: CSN high, ucStatus set and stored as the last status,
+ * 					pfnComplete called. The next queued descriptor is started before
+ * 					returning. The interrupt is masked when the queue runs empty.
+ *
+ */
+
+void
+NRF24L01_SPIEngineService(tNRF24L01 *psRadio)
+{
+	tNRF24L01SPIOp *psOp;
+	unsigned char ucData;
+	PROFILE_START(psRadio);
+
+#ifndef NRF24L01_CONF_HAL
+	pdlibSPI_ClearRxInt(RADIO_SSI(psRadio));
+#endif
+
+	psRadio->sEngineStats.ulServices++;
+
+	while(psRadio->ucEngineBusy)
+	{
+		psOp = psRadio->psEngineQueue[psRadio->uiEngineTail];
+
+		while((psRadio->uiEngineRx < psRadio->uiEngineTx) && _NRF24L01_EngineGet(psRadio, &ucData))
+		{
+			if(0 == psRadio->uiEngineRx)
+			{
+				psOp->ucStatus = ucData;
+			}else if(psOp->pucRxData != NULL)
+			{
+				psOp->pucRxData[psRadio->uiEngineRx - 1] = ucData;
+			}
+
+			psRadio->uiEngineRx++;
+		}
+
+		if(psRadio->uiEngineRx < (psOp->uiLength + 1))
+		{
+			/* PS: Not over, wait for the next interrupt */
+			_NRF24L01_EngineFill(psRadio);
+			break;
+		}
+
+		_NRF24L01_CSNHigh(psRadio);
+
+		_NRF24L01_StatusUpdate(psRadio, psOp->ucCommand, psOp->ucStatus);
+
+		PROFILE_BYTES(psRadio, 1 + psOp->uiLength);
+		TRACE(psRadio, PDLIB_NRF24_TRACE_SPI, psOp->ucCommand, psOp->uiLength, psOp->ucStatus);
+
+		psRadio->sEngineStats.ulCompleted++;
+		psRadio->sEngineStats.ulBytes += (1 + psOp->uiLength);
+
+		/* PS: The descriptor goes back to its owner before the callback, which may submit it again */
+		psRadio->uiEngineTail = ((psRadio->uiEngineTail + 1) % ENGINE_QUEUE_SIZE);
+		psRadio->ucEngineBusy = 0;
+
+		if(psOp->pfnComplete)
+		{
+			psOp->pfnComplete(psRadio, psOp);
+		}
+
+		if(!psRadio->ucEngineBusy && (psRadio->uiEngineTail != psRadio->uiEngineHead))
+		{
+			_NRF24L01_EngineStart(psRadio);
+		}
+	}
+
+	if(!psRadio->ucEngineBusy)
+	{
+		_NRF24L01_EngineInt(psRadio, 0);
+	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_ISR_SPI_ENGINE);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsSPIEngineIdle
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	1 if no transaction runs or waits, 0 otherwise
+ *
+ * Description	: 	-
+ *
+ */
+
+int
+NRF24L01_IsSPIEngineIdle(tNRF24L01 *psRadio)
+{
+	return ((!psRadio->ucEngineBusy && (psRadio->uiEngineTail == psRadio->uiEngineHead)) ? 1 : 0);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetSPIEngineStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psStats [out]	:	Statistics of the SPI engine
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Copies the engine statistics. ulServices over ulCompleted is the
+ * 					number of interrupts a transaction takes.
+ *
+ */
+
+void
+NRF24L01_GetSPIEngineStats(tNRF24L01 *psRadio, tNRF24L01SPIEngineStats *psStats)
+{
+	if(psStats)
+	{
+		*psStats = psRadio->sEngineStats;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ResetSPIEngineStats
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Clears the counters and the high-water mark.
+ *
+ */
+
+void
+NRF24L01_ResetSPIEngineStats(tNRF24L01 *psRadio)
+{
+	psRadio->sEngineStats.uiHighWater = 0;
+	psRadio->sEngineStats.ulSubmitted = 0;
+	psRadio->sEngineStats.ulRejected = 0;
+	psRadio->sEngineStats.ulCompleted = 0;
+	psRadio->sEngineStats.ulServices = 0;
+	psRadio->sEngineStats.ulBytes = 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IRQChainStart
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psChain	:	Chain state, pfnPayload, pfnDone and pvArg set by the caller
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS	:	Chain started
+ *					PDLIB_NRF24_BUSY	:	The chain is still running, or the engine queue is full
+ *					Other				:	See NRF24L01_SPIEngineSubmit
+ *
+ * Description	: 	The work of NRF24L01_RxQueueService without waiting for the SPI:
+ * 					call this from the IRQ handler and return. RX_DR is cleared
+ * 					(the status of that write gives cState and the first pipe), then
+ * 					every payload is read with R_RX_PL_WID (dynamic payload length)
+ * 					or the RX_PW shadow and R_RX_PAYLOAD, each step submitted from
+ * 					the completion of the one before. pfnPayload gets every payload,
+ * 					pfnDone the end of the chain (RX FIFO empty).
+ *
+ * 					TX_DS and MAX_RT are not cleared, check cState in pfnDone. The
+ * 					IRQ line stays low until the chain has cleared RX_DR, so mask the
+ * 					GPIO interrupt when starting the chain and unmask it in pfnDone.
+ * 					A chain which finds the engine queue full ends early, payloads
+ * 					may be left in the RX FIFO for the next start.
+ *
+ */
+
+int
+NRF24L01_IRQChainStart(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain)
+{
+	int iReturn;
+
+	if(NULL == psChain)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(psChain->ucBusy)
+	{
+		return PDLIB_NRF24_BUSY;
+	}
+
+	psChain->ucBusy = 1;
+	psChain->cState = 0;
+	psChain->ucPipe = 0;
+	psChain->ucLength = 0;
+	psChain->uiPayloads = 0;
+	psChain->uiInvalid = 0;
+
+	psChain->ucStep = CHAIN_CLEAR;
+	psChain->ucValue = RF24_RX_DR;
+
+	psChain->sOp.ucCommand = (RF24_W_REGISTER | RF24_STATUS);
+	psChain->sOp.pucTxData = &psChain->ucValue;
+	psChain->sOp.pucRxData = NULL;
+	psChain->sOp.uiLength = 1;
+	psChain->sOp.pfnComplete = _NRF24L01_IRQChainStep;
+	psChain->sOp.pvArg = psChain;
+
+	iReturn = NRF24L01_SPIEngineSubmit(psRadio, &psChain->sOp);
+
+	if(iReturn != PDLIB_NRF24_SUCCESS)
+	{
+		psChain->ucBusy = 0;
+	}
+
+	return iReturn;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_IRQChainStep
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psOp	:	sOp of the chain, just completed
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Completion of every chain transaction, picks the next one.
+ *
+ */
+
+static void
+_NRF24L01_IRQChainStep(tNRF24L01 *psRadio, tNRF24L01SPIOp *psOp)
+{
+	tNRF24L01IRQChain *psChain = (tNRF24L01IRQChain *)psOp->pvArg;
+	unsigned char ucPipe;
+
+	switch(psChain->ucStep)
+	{
+		case CHAIN_CLEAR:
+			psChain->cState = (char)((psOp->ucStatus & (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT)) >> 4);
+			psRadio->ucStatus &= (unsigned char)(~(RF24_RX_DR));
+
+			_NRF24L01_IRQChainNext(psRadio, psChain, psOp->ucStatus);
+			break;
+
+		case CHAIN_STATUS:
+			_NRF24L01_IRQChainNext(psRadio, psChain, psOp->ucStatus);
+			break;
+
+		case CHAIN_WIDTH:
+			/* PS: The status of R_RX_PL_WID tells the pipe, no separate status read */
+			ucPipe = ((psOp->ucStatus & (BIT3 | BIT2 | BIT1)) >> 1);
+
+			if(ucPipe > 5)
+			{
+				_NRF24L01_IRQChainNext(psRadio, psChain, psOp->ucStatus);
+			}else if((0 == psChain->ucValue) || (psChain->ucValue > 32))
+			{
+				/* PS: Corrupted width, the datasheet asks to flush the RX FIFO */
+				psChain->uiInvalid++;
+				_NRF24L01_IRQChainSubmit(psRadio, psChain, CHAIN_FLUSH, RF24_FLUSH_RX, NULL, NULL, 0);
+			}else
+			{
+				psChain->ucPipe = ucPipe;
+				psChain->ucLength = psChain->ucValue;
+				_NRF24L01_IRQChainSubmit(psRadio, psChain, CHAIN_PAYLOAD, RF24_R_RX_PAYLOAD, NULL, (unsigned char *)psChain->cData, psChain->ucLength);
+			}
+			break;
+
+		case CHAIN_PAYLOAD:
+			psChain->uiPayloads++;
+
+			if(psChain->pfnPayload)
+			{
+				psChain->pfnPayload(psRadio, psChain);
+			}
+
+			/* PS: The status of R_RX_PAYLOAD is from before the read, ask again */
+			if(psRadio->uiInternalStates & INTERNAL_STATE_DYNPL)
+			{
+				_NRF24L01_IRQChainSubmit(psRadio, psChain, CHAIN_WIDTH, RF24_R_RX_PL_WID, NULL, &psChain->ucValue, 1);
+			}else
+			{
+				_NRF24L01_IRQChainSubmit(psRadio, psChain, CHAIN_STATUS, RF24_NOP, NULL, NULL, 0);
+			}
+			break;
+
+		default:
+			_NRF24L01_IRQChainNext(psRadio, psChain, (BIT3 | BIT2 | BIT1));
+			break;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_IRQChainNext
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psChain	:	Chain
+ * 					ucStatus	:	Latest STATUS of the module
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Reads the payload the status points to, or ends the chain when
+ * 					the RX FIFO is empty.
+ *
+ */
+
+static void
+_NRF24L01_IRQChainNext(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain, unsigned char ucStatus)
+{
+	unsigned char ucPipe = ((ucStatus & (BIT3 | BIT2 | BIT1)) >> 1);
+
+	if(ucPipe > 5)
+	{
+		/* PS: RX FIFO is empty */
+		psChain->ucBusy = 0;
+
+		if(psChain->pfnDone)
+		{
+			psChain->pfnDone(psRadio, psChain);
+		}
+	}else if(psRadio->uiInternalStates & INTERNAL_STATE_DYNPL)
+	{
+		_NRF24L01_IRQChainSubmit(psRadio, psChain, CHAIN_WIDTH, RF24_R_RX_PL_WID, NULL, &psChain->ucValue, 1);
+	}else
+	{
+		psChain->ucPipe = ucPipe;
+		psChain->ucLength = (psRadio->ucShadow[RF24_RX_PW_P0 + ucPipe] & 0x3F);
+
+		if((0 == psChain->ucLength) || (psChain->ucLength > 32))
+		{
+			psChain->uiInvalid++;
+			_NRF24L01_IRQChainSubmit(psRadio, psChain, CHAIN_FLUSH, RF24_FLUSH_RX, NULL, NULL, 0);
+		}else
+		{
+			_NRF24L01_IRQChainSubmit(psRadio, psChain, CHAIN_PAYLOAD, RF24_R_RX_PAYLOAD, NULL, (unsigned char *)psChain->cData, psChain->ucLength);
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_IRQChainSubmit
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psChain	:	Chain
+ * 					ucStep	:	CHAIN_* of the transaction
+ * 					Others	:	See tNRF24L01SPIOp
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Submits the next chain transaction. If the engine queue is full
+ * 					the chain ends there and pfnDone is called. RX_DR is clear
+ * 					already, so what is left in the RX FIFO waits for the next
+ * 					NRF24L01_IRQChainStart.
+ *
+ */
+
+static void
+_NRF24L01_IRQChainSubmit(	tNRF24L01 *psRadio,
+							tNRF24L01IRQChain *psChain,
+							unsigned char ucStep,
+							unsigned char ucCommand,
+							unsigned char *pucTxData,
+							unsigned char *pucRxData,
+							unsigned int uiLength)
+{
+	psChain->ucStep = ucStep;
+
+	psChain->sOp.ucCommand = ucCommand;
+	psChain->sOp.pucTxData = pucTxData;
+	psChain->sOp.pucRxData = pucRxData;
+	psChain->sOp.uiLength = uiLength;
+
+	if(NRF24L01_SPIEngineSubmit(psRadio, &psChain->sOp) != PDLIB_NRF24_SUCCESS)
+	{
+		psChain->ucBusy = 0;
+
+		if(psChain->pfnDone)
+		{
+			psChain->pfnDone(psRadio, psChain);
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EngineStart
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Starts the descriptor at uiEngineTail: CSN low and the first
+ * 					bytes into the TX FIFO. The caller has checked that neither a
+ * 					descriptor nor a blocking transaction (ucBusHeld) runs.
+ *
+ */
+
+static void
+_NRF24L01_EngineStart(tNRF24L01 *psRadio)
+{
+	psRadio->uiEngineTx = 0;
+	psRadio->uiEngineRx = 0;
+
+#ifdef NRF24L01_CONF_HAL
+	psRadio->psHAL->pfnSetCSN(psRadio->pvHALContext, 0);
+#elif defined(FAST_CSN)
+	FAST_CSN = 0x00;
+#elif defined(PART_LM4F120H5QR)
+	ROM_GPIOPinWrite(psRadio->ulCSNBase, psRadio->ulCSNPin, 0x00);
+#endif
+
+	psRadio->ucEngineBusy = 1;
+
+	_NRF24L01_EngineFill(psRadio);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EngineFill
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Puts the next bytes of the running descriptor in the TX FIFO,
+ * 					at most ENGINE_FIFO_DEPTH not yet received, so the RX FIFO
+ * 					cannot overflow.
+ *
+ */
+
+static void
+_NRF24L01_EngineFill(tNRF24L01 *psRadio)
+{
+	tNRF24L01SPIOp *psOp = psRadio->psEngineQueue[psRadio->uiEngineTail];
+	unsigned int uiWords = (psOp->uiLength + 1);
+	unsigned char ucData;
+
+	while((psRadio->uiEngineTx < uiWords) && ((psRadio->uiEngineTx - psRadio->uiEngineRx) < ENGINE_FIFO_DEPTH))
+	{
+		if(0 == psRadio->uiEngineTx)
+		{
+			ucData = psOp->ucCommand;
+		}else
+		{
+			ucData = ((psOp->pucTxData != NULL) ? psOp->pucTxData[psRadio->uiEngineTx - 1] : RF24_NOP);
+		}
+
+		if(!_NRF24L01_EnginePut(psRadio, ucData))
+		{
+			break;
+		}
+
+		psRadio->uiEngineTx++;
+	}
+}
+
+
+/* PS: SSI FIFO and interrupt access of the engine, the backend or the built-in SSI code */
+
+static int
+_NRF24L01_EnginePut(tNRF24L01 *psRadio, unsigned char ucData)
+{
+#ifdef NRF24L01_CONF_HAL
+	return psRadio->psHAL->pfnFifoPut(psRadio->pvHALContext, ucData);
+#else
+	return (int)pdlibSPI_SendDataNonBlocking(RADIO_SSI(psRadio), ucData);
+#endif
+}
+
+static int
+_NRF24L01_EngineGet(tNRF24L01 *psRadio, unsigned char *pucData)
+{
+#ifdef NRF24L01_CONF_HAL
+	return psRadio->psHAL->pfnFifoGet(psRadio->pvHALContext, pucData);
+#else
+	char cData;
+
+	if(0 == pdlibSPI_ReceiveDataNonBlocking(RADIO_SSI(psRadio), &cData))
+	{
+		return 0;
+	}
+
+	*pucData = (unsigned char)cData;
+
+	return 1;
+#endif
+}
+
+static void
+_NRF24L01_EngineInt(tNRF24L01 *psRadio, unsigned char ucEnable)
+{
+#ifdef NRF24L01_CONF_HAL
+	psRadio->psHAL->pfnFifoInt(psRadio->pvHALContext, ucEnable);
+#else
+	pdlibSPI_EnableRxInt(RADIO_SSI(psRadio), ucEnable);
+#endif
+}
+
+
+#ifdef PART_LM4F120H5QR
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EngineMaskIdle
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	The previous mask, as ROM_IntMasterDisable returns it
+ *
+ * Description	: 	Masks the interrupts once the SPI engine is idle. The busy flag is
+ * 					looked at with the interrupts masked, so no IRQ handler starts a
+ * 					descriptor between the check and whatever the caller does next.
+ * 					They are let in between the checks for the SSI interrupt to
+ * 					finish the running descriptor.
+ *
+ */
+
+static tBoolean
+_NRF24L01_EngineMaskIdle(tNRF24L01 *psRadio)
+{
+	tBoolean bMasked;
+
+	while(1)
+	{
+		bMasked = ROM_IntMasterDisable();
+
+		if(!psRadio->ucEngineBusy)
+		{
+			return bMasked;
+		}
+
+		if(!bMasked)
+		{
+			ROM_IntMasterEnable();
+		}
+	}
+}
+#endif
+
+#endif
+
+
+// ----------------------- Register shadow ---------------------- //
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_RegisterUpdate_8
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucRegister	:	Address of a shadowed register
+ * 					ucClear		:	Bits to clear
+ * 					ucSet		:	Bits to set
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Read-modify-write of a register using the shadow instead of
+ * 					reading the register over SPI. The register is written only
+ * 					if the value changes, so this costs at most one SPI write.
+ *
+ */
+
+static void
+_NRF24L01_RegisterUpdate_8(	tNRF24L01 *psRadio,
+							unsigned char ucRegister,
+							unsigned char ucClear,
+							unsigned char ucSet)
+{
+	unsigned char ucValue = ((psRadio->ucShadow[ucRegister] & (~ucClear)) | ucSet);
+
+	if(ucValue != psRadio->ucShadow[ucRegister])
+	{
+		NRF24L01_RegisterWrite_8(psRadio, ucRegister, ucValue);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_VerifyShadow
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS			:	All shadowed registers match the module
+ * 					PDLIB_NRF24_SHADOW_MISMATCH	:	At least one register differs
+ *
+ * Description	: 	Reads back every shadowed register and address. A mismatch
+ * 					normally means the module has been reset (eg. a brownout), in
+ * 					which case NRF24L01_RestoreShadow will bring back the
+ * 					configuration.
+ *
+ */
+
+int
+NRF24L01_VerifyShadow(tNRF24L01 *psRadio)
+{
+	int ret = PDLIB_NRF24_SUCCESS;
+	unsigned char ucRegister;
+	unsigned char ucAddress[5];
+	unsigned int uiIndex;
+
+	for(ucRegister = 0; ucRegister <= RF24_FEATURE; ucRegister++)
+	{
+		if(IS_SHADOWED(ucRegister) && (NRF24L01_RegisterRead_8(psRadio, ucRegister) != psRadio->ucShadow[ucRegister]))
+		{
+			ret = PDLIB_NRF24_SHADOW_MISMATCH;
+			break;
+		}
+	}
+
+	for(ucRegister = RF24_RX_ADDR_P0; (PDLIB_NRF24_SUCCESS == ret) && (ucRegister <= RF24_TX_ADDR); ucRegister++)
+	{
+		NRF24L01_RegisterRead_Multi(psRadio, ucRegister, ucAddress, ADDRESS_WIDTH(psRadio, ucRegister));
+
+		for(uiIndex = 0; uiIndex < ADDRESS_WIDTH(psRadio, ucRegister); uiIndex++)
+		{
+			if(ucAddress[uiIndex] != psRadio->ucAddressShadow[ucRegister - RF24_RX_ADDR_P0][uiIndex])
+			{
+				ret = PDLIB_NRF24_SHADOW_MISMATCH;
+				break;
+			}
+		}
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RestoreShadow
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Writes every shadowed register and address back to the module.
+ * 					If the module lost the ACTIVATE state (FEATURE and DYNPD are
+ * 					read only until it is sent) the features are activated again.
+ *
+ */
+
+void
+NRF24L01_RestoreShadow(tNRF24L01 *psRadio)
+{
+	unsigned char ucRegister;
+	char data = 0x73;
+
+	for(ucRegister = 0; ucRegister <= RF24_FEATURE; ucRegister++)
+	{
+		if(IS_SHADOWED(ucRegister))
+		{
+			NRF24L01_RegisterWrite_8(psRadio, ucRegister, psRadio->ucShadow[ucRegister]);
+		}
+	}
+
+	for(ucRegister = RF24_RX_ADDR_P0; ucRegister <= RF24_TX_ADDR; ucRegister++)
+	{
+		NRF24L01_RegisterWrite_Multi(psRadio, ucRegister, psRadio->ucAddressShadow[ucRegister - RF24_RX_ADDR_P0],
+									 ADDRESS_WIDTH(psRadio, ucRegister));
+	}
+
+	if((psRadio->ucShadow[RF24_FEATURE] | psRadio->ucShadow[RF24_DYNPD]) &&
+	   (NRF24L01_RegisterRead_8(psRadio, RF24_FEATURE) != psRadio->ucShadow[RF24_FEATURE]))
+	{
+		NRF24L01_SendCommand(psRadio, RF24_ACTIVATE, &data, 1);
+
+		psRadio->uiInternalStates |= INTERNAL_STATE_FEATURE_ENABLED;
+
+		NRF24L01_RegisterWrite_8(psRadio, RF24_FEATURE, psRadio->ucShadow[RF24_FEATURE]);
+		NRF24L01_RegisterWrite_8(psRadio, RF24_DYNPD, psRadio->ucShadow[RF24_DYNPD]);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ReloadShadow
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Reads every shadowed register and address from the module into
+ * 					the shadow. Use this if the registers were written without the
+ * 					driver (eg. NRF24L01_SendCommand with a W_REGISTER command or
+ * 					the SPI engine).
+ *
+ */
+
+void
+NRF24L01_ReloadShadow(tNRF24L01 *psRadio)
+{
+	unsigned char ucRegister;
+
+	for(ucRegister = 0; ucRegister <= RF24_FEATURE; ucRegister++)
+	{
+		if(IS_SHADOWED(ucRegister))
+		{
+			psRadio->ucShadow[ucRegister] = NRF24L01_RegisterRead_8(psRadio, ucRegister);
+		}
+	}
+
+	for(ucRegister = RF24_RX_ADDR_P0; ucRegister <= RF24_TX_ADDR; ucRegister++)
+	{
+		NRF24L01_RegisterRead_Multi(psRadio, ucRegister, psRadio->ucAddressShadow[ucRegister - RF24_RX_ADDR_P0],
+									ADDRESS_WIDTH(psRadio, ucRegister));
+	}
+}
+
+
+// ----------------------- Bulk configuration ---------------------- //
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetDefaultConfig
+ *
+ * Arguments	: 	psConfig [out]	:	Configuration
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The configuration NRF24L01_RegisterInit writes: the reset values
+ * 					of the datasheet, powered down in RX mode with a 1 byte CRC.
+ *
+ */
+
+void
+NRF24L01_GetDefaultConfig(tNRF24L01Config *psConfig)
+{
+	unsigned int uiIndex;
+
+	psConfig->ucConfig = 0x09;
+	psConfig->ucEnAA = 0x3F;
+	psConfig->ucEnRxAddr = 0x03;
+	psConfig->ucSetupAW = 0x03;
+	psConfig->ucSetupRetr = 0x03;
+	psConfig->ucRFChannel = 0x02;
+	psConfig->ucRFSetup = 0x0F;
+	psConfig->ucDynPD = 0x00;
+	psConfig->ucFeature = 0x00;
+
+	for(uiIndex = 0; uiIndex < 6; uiIndex++)
+	{
+		psConfig->ucRxPayloadWidth[uiIndex] = 0x00;
+	}
+
+	for(uiIndex = 0; uiIndex < 5; uiIndex++)
+	{
+		psConfig->ucRxAddrP0[uiIndex] = 0xE7;
+		psConfig->ucRxAddrP1[uiIndex] = 0xC2;
+		psConfig->ucTxAddr[uiIndex] = 0xE7;
+	}
+
+	for(uiIndex = 0; uiIndex < 4; uiIndex++)
+	{
+		psConfig->ucRxAddrP2to5[uiIndex] = (unsigned char)(0xC3 + uiIndex);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetConfig
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psConfig [out]	:	Configuration
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The configuration of the module, from the register shadow (no
+ * 					SPI). Change what is needed and pass it to NRF24L01_ApplyConfig.
+ *
+ */
+
+void
+NRF24L01_GetConfig(tNRF24L01 *psRadio, tNRF24L01Config *psConfig)
+{
+	unsigned int uiIndex;
+
+	psConfig->ucConfig = psRadio->ucShadow[RF24_CONFIG];
+	psConfig->ucEnAA = psRadio->ucShadow[RF24_EN_AA];
+	psConfig->ucEnRxAddr = psRadio->ucShadow[RF24_EN_RXADDR];
+	psConfig->ucSetupAW = psRadio->ucShadow[RF24_SETUP_AW];
+	psConfig->ucSetupRetr = psRadio->ucShadow[RF24_SETUP_RETR];
+	psConfig->ucRFChannel = psRadio->ucShadow[RF24_RF_CH];
+	psConfig->ucRFSetup = psRadio->ucShadow[RF24_RF_SETUP];
+	psConfig->ucDynPD = psRadio->ucShadow[RF24_DYNPD];
+	psConfig->ucFeature = psRadio->ucShadow[RF24_FEATURE];
+
+	for(uiIndex = 0; uiIndex < 6; uiIndex++)
+	{
+		psConfig->ucRxPayloadWidth[uiIndex] = psRadio->ucShadow[RF24_RX_PW_P0 + uiIndex];
+	}
+
+	for(uiIndex = 0; uiIndex < 5; uiIndex++)
+	{
+		psConfig->ucRxAddrP0[uiIndex] = psRadio->ucAddressShadow[RF24_RX_ADDR_P0 - RF24_RX_ADDR_P0][uiIndex];
+		psConfig->ucRxAddrP1[uiIndex] = psRadio->ucAddressShadow[RF24_RX_ADDR_P1 - RF24_RX_ADDR_P0][uiIndex];
+		psConfig->ucTxAddr[uiIndex] = psRadio->ucAddressShadow[RF24_TX_ADDR - RF24_RX_ADDR_P0][uiIndex];
+	}
+
+	for(uiIndex = 0; uiIndex < 4; uiIndex++)
+	{
+		psConfig->ucRxAddrP2to5[uiIndex] = psRadio->ucAddressShadow[RF24_RX_ADDR_P2 - RF24_RX_ADDR_P0 + uiIndex][0];
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ApplyConfig
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psConfig	:	Configuration to bring the module to
+ *
+ * Return		: 	Zero or positive		:	Number of registers written
+ *					PDLIB_NRF24_INVALID_ARGUMENT	:	A value is out of range, nothing written
+ *					PDLIB_NRF24_BUSY				:	The module is in TX mode, nothing written
+ *
+ * Description	: 	Compares the configuration with the register shadow and writes
+ * 					only the registers and addresses which differ, back-to-back in
+ * 					one batch. A channel hop is one SPI transaction, an unchanged
+ * 					configuration none.
+ *
+ * 					The mode stays as it is (PWR_UP and PRIM_RX of ucConfig are
+ * 					ignored, use the mode and power functions). In RX mode CE is
+ * 					dropped for the writes and raised again after them, which
+ * 					costs the RX settling time. ACTIVATE is sent first if FEATURE
+ * 					or DYNPD are set and the features are not active yet.
+ *
+ */
+
+int
+NRF24L01_ApplyConfig(tNRF24L01 *psRadio, const tNRF24L01Config *psConfig)
+{
+	int iReturn;
+	PROFILE_START(psRadio);
+
+	iReturn = _NRF24L01_ApplyConfig(psRadio, psConfig, 0);
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_APPLY_CONFIG);
+
+	return iReturn;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_ApplyConfig
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psConfig	:	Configuration
+ * 					ucForce		:	1 to write every register and the mode bits of
+ * 									CONFIG (NRF24L01_RegisterInit)
+ *
+ * Return		: 	See NRF24L01_ApplyConfig
+ *
+ * Description	: 	Builds the frames of the changed registers and writes them with
+ * 					_NRF24L01_WriteBatch, then updates the shadow and the feature
+ * 					states.
+ *
+ */
+
+static int
+_NRF24L01_ApplyConfig(tNRF24L01 *psRadio, const tNRF24L01Config *psConfig, unsigned char ucForce)
+{
+	unsigned char ucValue[RF24_FEATURE + 1];
+	const unsigned char *pucAddress[7];
+	unsigned char ucBatch[CONFIG_BATCH_SIZE];
+	unsigned char ucActivate = 0x73;
+	unsigned char ucRegister;
+	unsigned char ucWidth;
+	unsigned char ucRxActive;
+	unsigned char ucChanged;
+	unsigned int uiBytes = 0;
+	unsigned int uiIndex;
+	int iWrites = 0;
+
+	if(NULL == psConfig)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if((psConfig->ucRFChannel > 127) || (psConfig->ucSetupAW < 1) || (psConfig->ucSetupAW > 3))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	for(uiIndex = 0; uiIndex < 6; uiIndex++)
+	{
+		if(psConfig->ucRxPayloadWidth[uiIndex] > 32)
+		{
+			return PDLIB_NRF24_INVALID_ARGUMENT;
+		}
+	}
+
+	/* PS: Powered up with CE high: RX, or TX which is not to be disturbed */
+	ucRxActive = ((psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP) && !(psRadio->uiInternalStates & INTERNAL_STATE_STAND_BY));
+
+	if(!ucForce && ucRxActive && !(psRadio->ucShadow[RF24_CONFIG] & RF24_PRIM_RX))
+	{
+		return PDLIB_NRF24_BUSY;
+	}
+
+	ucValue[RF24_CONFIG] = psConfig->ucConfig;
+
+	if(!ucForce)
+	{
+		ucValue[RF24_CONFIG] = ((psConfig->ucConfig & (unsigned char)(~(RF24_PWR_UP | RF24_PRIM_RX))) |
+								(psRadio->ucShadow[RF24_CONFIG] & (RF24_PWR_UP | RF24_PRIM_RX)));
+	}
+
+	ucValue[RF24_EN_AA] = psConfig->ucEnAA;
+	ucValue[RF24_EN_RXADDR] = psConfig->ucEnRxAddr;
+	ucValue[RF24_SETUP_AW] = psConfig->ucSetupAW;
+	ucValue[RF24_SETUP_RETR] = psConfig->ucSetupRetr;
+	ucValue[RF24_RF_CH] = psConfig->ucRFChannel;
+	ucValue[RF24_RF_SETUP] = psConfig->ucRFSetup;
+	ucValue[RF24_DYNPD] = psConfig->ucDynPD;
+	ucValue[RF24_FEATURE] = psConfig->ucFeature;
+
+	for(uiIndex = 0; uiIndex < 6; uiIndex++)
+	{
+		ucValue[RF24_RX_PW_P0 + uiIndex] = psConfig->ucRxPayloadWidth[uiIndex];
+	}
+
+	pucAddress[RF24_RX_ADDR_P0 - RF24_RX_ADDR_P0] = psConfig->ucRxAddrP0;
+	pucAddress[RF24_RX_ADDR_P1 - RF24_RX_ADDR_P0] = psConfig->ucRxAddrP1;
+	pucAddress[RF24_TX_ADDR - RF24_RX_ADDR_P0] = psConfig->ucTxAddr;
+
+	for(uiIndex = 0; uiIndex < 4; uiIndex++)
+	{
+		pucAddress[RF24_RX_ADDR_P2 - RF24_RX_ADDR_P0 + uiIndex] = &psConfig->ucRxAddrP2to5[uiIndex];
+	}
+
+	/* PS: FEATURE and DYNPD are read only until ACTIVATE */
+	if((ucValue[RF24_FEATURE] | ucValue[RF24_DYNPD]) &&
+	   ((ucValue[RF24_FEATURE] != psRadio->ucShadow[RF24_FEATURE]) || (ucValue[RF24_DYNPD] != psRadio->ucShadow[RF24_DYNPD])) &&
+	   (0 == (psRadio->uiInternalStates & INTERNAL_STATE_FEATURE_ENABLED)))
+	{
+		uiBytes = _NRF24L01_BatchAdd(ucBatch, uiBytes, RF24_ACTIVATE, &ucActivate, 1);
+	}
+
+	for(ucRegister = 0; ucRegister <= RF24_FEATURE; ucRegister++)
+	{
+		if(IS_SHADOWED(ucRegister) && (ucForce || (ucValue[ucRegister] != psRadio->ucShadow[ucRegister])))
+		{
+			uiBytes = _NRF24L01_BatchAdd(ucBatch, uiBytes, (RF24_W_REGISTER | ucRegister), &ucValue[ucRegister], 1);
+			iWrites++;
+		}
+	}
+
+	/* PS: Addresses go out by the width being applied. A new width writes the full addresses again,
+	 * the module does not hold the bytes past the old one */
+	for(ucRegister = RF24_RX_ADDR_P0; ucRegister <= RF24_TX_ADDR; ucRegister++)
+	{
+		ucWidth = (IS_FULL_ADDRESS(ucRegister) ? SETUP_AW_BYTES(ucValue[RF24_SETUP_AW]) : 1);
+		ucChanged = (ucForce || (ucWidth != ADDRESS_WIDTH(psRadio, ucRegister)));
+
+		for(uiIndex = 0; uiIndex < ucWidth; uiIndex++)
+		{
+			if(pucAddress[ucRegister - RF24_RX_ADDR_P0][uiIndex] != psRadio->ucAddressShadow[ucRegister - RF24_RX_ADDR_P0][uiIndex])
+			{
+				ucChanged = 1;
+			}
+		}
+
+		if(ucChanged)
+		{
+			uiBytes = _NRF24L01_BatchAdd(ucBatch, uiBytes, (RF24_W_REGISTER | ucRegister), pucAddress[ucRegister - RF24_RX_ADDR_P0], ucWidth);
+			iWrites++;
+		}
+	}
+
+	if(0 == uiBytes)
+	{
+		return 0;
+	}
+
+	if(ucRxActive)
+	{
+		_NRF24L01_CELow(psRadio);
+	}
+
+	_NRF24L01_WriteBatch(psRadio, ucBatch, uiBytes);
+
+	if(RF24_ACTIVATE == ucBatch[1])
+	{
+		psRadio->uiInternalStates |= INTERNAL_STATE_FEATURE_ENABLED;
+	}
+
+	for(ucRegister = 0; ucRegister <= RF24_FEATURE; ucRegister++)
+	{
+		if(IS_SHADOWED(ucRegister))
+		{
+			psRadio->ucShadow[ucRegister] = ucValue[ucRegister];
+		}
+	}
+
+	/* PS: ucShadow holds the new SETUP_AW already */
+	for(ucRegister = RF24_RX_ADDR_P0; ucRegister <= RF24_TX_ADDR; ucRegister++)
+	{
+		for(uiIndex = 0; uiIndex < ADDRESS_WIDTH(psRadio, ucRegister); uiIndex++)
+		{
+			psRadio->ucAddressShadow[ucRegister - RF24_RX_ADDR_P0][uiIndex] = pucAddress[ucRegister - RF24_RX_ADDR_P0][uiIndex];
+		}
+	}
+
+	/* PS: The feature states follow FEATURE, as if set by the NRF24L01_EnableFeature* functions */
+	if(ucValue[RF24_FEATURE] & RF24_EN_DPL)
+	{
+		psRadio->uiInternalStates |= INTERNAL_STATE_DYNPL;
+	}else
+	{
+		psRadio->uiInternalStates &= (~INTERNAL_STATE_DYNPL);
+	}
+
+	if(ucValue[RF24_FEATURE] & RF24_EN_ACK_PAY)
+	{
+		psRadio->uiInternalStates |= INTERNAL_STATE_ACKPL;
+	}else
+	{
+		psRadio->uiInternalStates &= (~INTERNAL_STATE_ACKPL);
+	}
+
+	if(ucForce)
+	{
+		if(ucValue[RF24_CONFIG] & RF24_PWR_UP)
+		{
+			psRadio->uiInternalStates |= INTERNAL_STATE_POWER_UP;
+		}else
+		{
+			psRadio->uiInternalStates &= (~(INTERNAL_STATE_POWER_UP | INTERNAL_STATE_STAND_BY));
+		}
+	}
+
+	if(ucRxActive)
+	{
+		_NRF24L01_CEHigh(psRadio);
+	}
+
+	return iWrites;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_BatchAdd
+ *
+ * Arguments	: 	pucBatch	:	Frames, CONFIG_BATCH_SIZE bytes
+ * 					uiBytes		:	Bytes of pucBatch in use
+ * 					ucCommand	:	Command byte of the frame
+ * 					pucData		:	Data after the command
+ * 					uiLength	:	Data bytes, at most 5
+ *
+ * Return		: 	Bytes of pucBatch in use after the frame
+ *
+ * Description	: 	Appends one frame (length, command, data) to the batch.
+ *
+ */
+
+static unsigned int
+_NRF24L01_BatchAdd(	unsigned char *pucBatch,
+					unsigned int uiBytes,
+					unsigned char ucCommand,
+					const unsigned char *pucData,
+					unsigned int uiLength)
+{
+	unsigned int uiIndex;
+
+	pucBatch[uiBytes++] = (unsigned char)uiLength;
+	pucBatch[uiBytes++] = ucCommand;
+
+	for(uiIndex = 0; uiIndex < uiLength; uiIndex++)
+	{
+		pucBatch[uiBytes++] = pucData[uiIndex];
+	}
+
+	return uiBytes;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_WriteBatch
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pucBatch	:	Frames of _NRF24L01_BatchAdd
+ * 					uiBytes		:	Bytes of pucBatch in use
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Writes the frames back-to-back, one CSN low period each (the
+ * 					module takes one register per W_REGISTER). On the built-in SSI
+ * 					path the command and the data of a frame go out in one burst,
+ * 					with the STATUS as the first byte received.
+ *
+ */
+
+static void
+_NRF24L01_WriteBatch(tNRF24L01 *psRadio, unsigned char *pucBatch, unsigned int uiBytes)
+{
+	unsigned int uiIndex = 0;
+	unsigned int uiLength;
+#if defined(PDLIB_SPI) && !defined(NRF24L01_CONF_HAL) && !defined(NRF24L01_CONF_FAST_SPI)
+	unsigned char ucReply[6];
+#endif
+
+	while(uiIndex < uiBytes)
+	{
+		uiLength = pucBatch[uiIndex];
+
+#if defined(PDLIB_SPI) && !defined(NRF24L01_CONF_HAL) && !defined(NRF24L01_CONF_FAST_SPI)
+		_NRF24L01_CSNLow(psRadio);
+		pdlibSPI_TransferData(RADIO_SSI(psRadio), &pucBatch[uiIndex + 1], ucReply, (1 + uiLength));
+		_NRF24L01_CSNHigh(psRadio);
+
+		_NRF24L01_StatusUpdate(psRadio, pucBatch[uiIndex + 1], ucReply[0]);
+
+		PROFILE_BYTES(psRadio, 1 + uiLength);
+		TRACE(psRadio, PDLIB_NRF24_TRACE_SPI, pucBatch[uiIndex + 1], uiLength, ucReply[0]);
+#else
+		_NRF24L01_Transaction(psRadio, pucBatch[uiIndex + 1], &pucBatch[uiIndex + 2], NULL, uiLength);
+#endif
+
+		uiIndex += (2 + uiLength);
+	}
+}
+
+
+// ----------------------- uDMA payload transfers ---------------------- //
+
+#if defined(PDLIB_SPI) && defined(PDLIB_SPI_CONF_UDMA)
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_DMAInit
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pvControlTable	:	uDMA control table (1024 byte aligned) or NULL
+ * 										if the application has already set it.
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Prepares the uDMA channels of the SSI module given to NRF24L01_Init.
+ * 					pdlibSPI_DMAIntHandler must be registered as the SSI interrupt handler.
+ *
+ */
+
+void
+NRF24L01_DMAInit(tNRF24L01 *psRadio, void *pvControlTable)
+{
+	psRadio->pfnDMACallback = NULL;
+
+	pdlibSPI_ConfigureDMA(RADIO_SSI(psRadio), pvControlTable);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_DMACommand
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucCommand	:	Command to send
+ * 					pucTxData	:	Payload to write (NULL for read commands)
+ * 					pucRxData	:	Buffer to read the payload into (NULL for write commands)
+ * 					uiLength	:	Length of the payload
+ * 					pfnCallback	:	Called when the command is over
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS	:	Command started (or completed)
+ * 					PDLIB_NRF24_BUSY	:	Another uDMA transfer is running
+ *
+ * Description	: 	The command byte is sent by the CPU, which also captures the status.
+ * 					The payload is then moved by the uDMA and CSN is released from the
+ * 					SSI interrupt. Payloads shorter than NRF24L01_CONF_DMA_THRESHOLD are
+ * 					moved by the CPU and the callback is called before returning.
+ *
+ */
+
+static int
+_NRF24L01_DMACommand(	tNRF24L01 *psRadio,
+						unsigned char ucCommand,
+						unsigned char *pucTxData,
+						unsigned char *pucRxData,
+						unsigned int uiLength,
+						tNRF24L01Callback pfnCallback)
+{
+	if(pdlibSPI_IsDMABusy(RADIO_SSI(psRadio)))
+	{
+		return PDLIB_NRF24_BUSY;
+	}
+
+	_NRF24L01_CSNLow(psRadio);
+
+	_NRF24L01_StatusUpdate(psRadio, ucCommand, pdlibSPI_TransferByte(RADIO_SSI(psRadio), ucCommand));
+
+	PROFILE_BYTES(psRadio, 1 + uiLength);
+	TRACE(psRadio, PDLIB_NRF24_TRACE_SPI, ucCommand, uiLength, psRadio->ucStatus);
+
+	if(uiLength < NRF24L01_CONF_DMA_THRESHOLD)
+	{
+		pdlibSPI_TransferData(RADIO_SSI(psRadio), pucTxData, pucRxData, uiLength);
+
+		_NRF24L01_CSNHigh(psRadio);
 
-	// PS: Set to TX mode
-	ucCurrentVal = NRF24L01_RegisterRead_8(RF24_CONFIG);
-	ucCurrentVal &= (~RF24_PRIM_RX);
-	
-	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucCurrentVal);
+		if(pfnCallback)
+		{
+			pfnCallback(psRadio, PDLIB_NRF24_SUCCESS);
+		}
+	}else
+	{
+		psRadio->pfnDMACallback = pfnCallback;
 
-	_NRF24L01_CEHigh();
+		pdlibSPI_TransferDataDMA(RADIO_SSI(psRadio), pucTxData, pucRxData, uiLength, _NRF24L01_DMACommand_Complete, psRadio);
+	}
 
-#ifdef PDLIB_DEBUG
-	PrintString("TX mode enabled\n\r");
-#endif
+	return PDLIB_NRF24_SUCCESS;
 }
 
+
 /* PS:
  *
- * Function		: 	NRF24L01_DisableTxMode
+ * Function		: 	_NRF24L01_DMACommand_Complete
  *
- * Arguments	: 	None
+ * Arguments	: 	pvArg	:	The instance which started the transfer
  *
  * Return		: 	None
  *
- * Description	: 	Put the module into Standby I state with TX mode.
+ * Description	: 	uDMA completion, called from the SSI interrupt. Ends the SPI
+ * 					command and notifies the caller.
  *
  */
-void NRF24L01_DisableTxMode()
+
+static void
+_NRF24L01_DMACommand_Complete(void *pvArg)
 {
-	unsigned char ucCurrentVal = NRF24L01_GetStatus();
+	tNRF24L01 *psRadio = (tNRF24L01 *)pvArg;
+	tNRF24L01Callback pfnCallback = psRadio->pfnDMACallback;
 
-	_NRF24L01_CELow();
+	psRadio->pfnDMACallback = NULL;
 
-	// PS: Clear TX_DS and MAX_RT interrupts TODO: why?
-	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+	_NRF24L01_CSNHigh(psRadio);
 
-#ifdef PDLIB_DEBUG
-	PrintString("TX mode disabled\n\r");
-#endif
+	if(pfnCallback)
+	{
+		pfnCallback(psRadio, PDLIB_NRF24_SUCCESS);
+	}
 }
 
 
 /* PS:
- * 
- * Function		: 	NRF24L01_IsDataReadyRx
- * 
- * Arguments	: 	pcPipeNo [out] : Pipe number which contains the RX payload
- * 
- * Return		: 	PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
- * 					PDLIB_NRF24_ERROR				:	Data is not in RX FIFO
- * 					PDLIB_NRF24_SUCCESS				:	Data is in RX FIFO
- * 
- * Description	: 	Get the state of RX data.
- * 					If the return is 'PDLIB_NRF24_SUCCESS' then the pcPipeNo will contain the pipe which has data.
- * 
+ *
+ * Function		: 	NRF24L01_SetTxPayloadDMA
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Buffer which contains the data to be written to TX fifo
+ * 					uiLength	:	Length of the data buffer
+ * 					pfnCallback	:	Called when the payload is written (can be NULL)
+ *
+ * Return		: 	PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ * 					PDLIB_NRF24_BUSY			: Another uDMA transfer is running
+ * 					PDLIB_NRF24_ERROR			: Invalid arguments
+ * 					PDLIB_NRF24_SUCCESS			: Transfer started
+ *
+ * Description	: 	Non-blocking version of NRF24L01_SetTxPayload. pcData must stay
+ * 					valid until pfnCallback is called.
+ *
  */
- 
+
 int
-NRF24L01_IsDataReadyRx(char *pcPipeNo)
+NRF24L01_SetTxPayloadDMA(	tNRF24L01 *psRadio,
+							char* pcData,
+							unsigned int uiLength,
+							tNRF24L01Callback pfnCallback)
 {
 	int ret = PDLIB_NRF24_ERROR;
-	char cDataReady;
 
-	if(NULL == pcPipeNo)
-	{
-		ret = PDLIB_NRF24_INVALID_ARGUMENT;
-	}else
+	if(pcData && uiLength > 0)
 	{
-		NRF24L01_GetStatus();
-
-		cDataReady = ((g_ucStatus & RF24_RX_DR) ? 1 : 0);
-		*pcPipeNo = ((g_ucStatus & ( BIT3 | BIT2 | BIT1)) >> 1);
-
-		// *pcPipeNo will be 7 if the RX fifo is empty
-		if(cDataReady && (*pcPipeNo < 6))
+		if(pdlibSPI_IsDMABusy(RADIO_SSI(psRadio)))
 		{
-			ret = PDLIB_NRF24_SUCCESS;
+			ret = PDLIB_NRF24_BUSY;
+		}else if(NRF24L01_IsTxFifoFull(psRadio))
+		{
+			ret = PDLIB_NRF24_TX_FIFO_FULL;
 		}else
 		{
-			// Reset the value in the pipe number
-			*pcPipeNo = 0xFF;
-			ret = PDLIB_NRF24_ERROR;
+			ret = _NRF24L01_DMACommand(psRadio, RF24_W_TX_PAYLOAD, (unsigned char*)pcData, NULL, uiLength, pfnCallback);
 		}
 	}
 
@@ -815,916 +6263,1189 @@ NRF24L01_IsDataReadyRx(char *pcPipeNo)
 
 /* PS:
  *
- * Function		: 	NRF24L01_WaitForDataRx
+ * Function		: 	NRF24L01_SetAckPayloadDMA
  *
- * Arguments	: 	pcPipeNo [out] : Pipe number which contains the RX payload
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					pcData		:	Buffer which contains the data to be written to TX fifo
+ * 					pipe		:	Which pipe to use (0~5)
+ * 					uiLength	:	Length of the data buffer
+ * 					pfnCallback	:	Called when the payload is written (can be NULL)
  *
- * Return		: 	PDLIB_NRF24_ERROR	:	Invalid input argument
- * 					PDLIB_NRF24_SUCCESS	:	Data is in RX FIFO
+ * Return		: 	PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ * 					PDLIB_NRF24_BUSY			: Another uDMA transfer is running
+ * 					PDLIB_NRF24_ERROR			: Invalid arguments
+ * 					PDLIB_NRF24_SUCCESS			: Transfer started
  *
- * Description	: 	Wait until any RX pipe has data
+ * Description	: 	Non-blocking version of NRF24L01_SetAckPayload. pcData must stay
+ * 					valid until pfnCallback is called.
  *
  */
 
-int NRF24L01_WaitForDataRx(char *pcPipeNo)
+int
+NRF24L01_SetAckPayloadDMA(	tNRF24L01 *psRadio,
+							char* pcData,
+							char pipe,
+							unsigned int uiLength,
+							tNRF24L01Callback pfnCallback)
 {
-	int iRet = PDLIB_NRF24_ERROR;
-
-	NRF24L01_EnableRxMode();
-
-#ifdef PDLIB_DEBUG
-	PrintString("Waiting for data...\n\r");
-
-	/*
-		PrintRegValue("CONFIG: ",NRF24L01_RegisterRead_8(RF24_CONFIG));
-		PrintRegValue("EN_RXADDR: ",NRF24L01_RegisterRead_8(RF24_EN_RXADDR));
-		PrintRegValue("EN_AA: ",NRF24L01_RegisterRead_8(RF24_EN_AA));
-		PrintRegValue("RX_PW_P0: ",NRF24L01_RegisterRead_8(RF24_RX_PW_P0));*/
-#endif
-
+	int ret = PDLIB_NRF24_ERROR;
 
-	while(iRet == PDLIB_NRF24_ERROR)
+	if(((unsigned char)pipe <= PDLIB_NRF24_PIPE5) && pcData && uiLength > 0)
 	{
-		iRet = NRF24L01_IsDataReadyRx(pcPipeNo);
+		if(pdlibSPI_IsDMABusy(RADIO_SSI(psRadio)))
+		{
+			ret = PDLIB_NRF24_BUSY;
+		}else if(NRF24L01_IsTxFifoFull(psRadio))
+		{
+			ret = PDLIB_NRF24_TX_FIFO_FULL;
+		}else
+		{
+			ret = _NRF24L01_DMACommand(psRadio, (RF24_W_ACK_PAYLOAD | (pipe & 0x07)), (unsigned char*)pcData, NULL, uiLength, pfnCallback);
+		}
 	}
 
-
-	NRF24L01_DisableRxMode();
-
-	return iRet;
+	return ret;
 }
 
 
-
 /* PS:
  *
- * Function		: 	NRF24L01_IsTxFifoFull
+ * Function		: 	NRF24L01_ReadRxPayloadDMA
  *
- * Arguments	: 	None
+ * Arguments	:	psRadio	:	Radio instance
+ * 					pcData [out]	:	Allocated buffer to store the RX data
+ * 					cLength	[in]	:	Required data amount
+ * 					pfnCallback		:	Called when the payload is read (can be NULL)
  *
- * Return		: 	0	:	TX FIFO is NOT full
- * 					1	:	TX FIFO is full
+ * Return		: 	PDLIB_NRF24_BUSY			: Another uDMA transfer is running
+ * 					PDLIB_NRF24_ERROR			: Invalid arguments
+ * 					PDLIB_NRF24_SUCCESS			: Transfer started
  *
- * Description	: 	Get the state of TX FIFO
+ * Description	: 	Non-blocking version of NRF24L01_ReadRxPayload. pcData is valid
+ * 					only after pfnCallback is called.
  *
  */
 
 int
-NRF24L01_IsTxFifoFull()
+NRF24L01_ReadRxPayloadDMA(	tNRF24L01 *psRadio,
+							char* pcData,
+							char cLength,
+							tNRF24L01Callback pfnCallback)
 {
-	unsigned char ucTxFifo;
+	int ret = PDLIB_NRF24_ERROR;
 
-	ucTxFifo = NRF24L01_RegisterRead_8(RF24_FIFO_STATUS);
+	if(pcData && cLength > 0)
+	{
+		ret = _NRF24L01_DMACommand(psRadio, RF24_R_RX_PAYLOAD, NULL, (unsigned char*)pcData, cLength, pfnCallback);
+	}
 
-	return ((ucTxFifo & RF24_FIFO_FULL) ? 1 : 0);
+	return ret;
 }
 
 
 /* PS:
  *
- * Function		: 	NRF24L01_IsTxFifoEmpty
+ * Function		: 	NRF24L01_IsTransferBusy
  *
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  *
- * Return		: 	0	:	TX FIFO is NOT empty
- * 					1	:	TX FIFO is empty
+ * Return		: 	1 if a uDMA payload transfer is running, 0 otherwise
  *
- * Description	: 	Get the state of TX FIFO
+ * Description	: 	Any other API will wait until the running transfer is over.
  *
  */
 
-int NRF24L01_IsTxFifoEmpty()
+int
+NRF24L01_IsTransferBusy(tNRF24L01 *psRadio)
 {
-	unsigned char ucTxFifo;
-	ucTxFifo = NRF24L01_RegisterRead_8(RF24_FIFO_STATUS);
-
-	return ((ucTxFifo & RF24_TX_EMPTY) ? 1 : 0);
+	return pdlibSPI_IsDMABusy(RADIO_SSI(psRadio));
 }
 
+#endif
+
+
+// ----------------------- Register Read/Write functions ---------------------- //
+
 
 /* PS:
- * 
- * Function		: 	NRF24L01_GetRxDataAmount
- * 
- * Arguments	: 	ucDataPipe	:	Index of the pipe
- * 
- * Return		: 	Available number of bytes.
- * 
- * Description	: 	Reading the number of data bytes available
- * 					in the specified pipe (for static payload mode).
  *
- * 					For dynamic payload mode this will tell
- * 					the top most RX_FIFO payload length.
- * 
+ * Function		: 	_NRF24L01_Transaction
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucCommand	:	Command byte
+ * 					pucTxData	:	Data to send after the command (NULL to send RF24_NOP)
+ * 					pucRxData	:	Buffer for the data received after the command (NULL to discard)
+ * 					uiLength	:	Number of data bytes after the command
+ *
+ * Return		: 	Status register value
+ *
+ * Description	: 	One SPI transaction (one CSN low period). A backend gets the
+ * 					caller's buffers as they are. The built-in SSI code copies the
+ * 					command and the data into one frame and clocks it out as one
+ * 					burst, so the bus does not stop between the command byte and
+ * 					the data (as _NRF24L01_WriteBatch). The status register clocked
+ * 					out with the command byte is stored by _NRF24L01_StatusUpdate.
+ *
  */
 
-char
-NRF24L01_GetRxDataAmount(unsigned char ucDataPipe)
+/* PS: Command byte and the longest data of a command (a payload) */
+#define TRANSACTION_FRAME	33
+
+static unsigned char
+_NRF24L01_Transaction(	tNRF24L01 *psRadio,
+						unsigned char ucCommand,
+						unsigned char *pucTxData,
+						unsigned char *pucRxData,
+						unsigned int uiLength)
 {
-	char reg;
-	char ret = 0;
+	unsigned char ucStatus = 0;
+
+#ifdef NRF24L01_CONF_HAL
+	/* PS: The backend frames CSN, so that it can move the whole transaction in one go */
+	ucStatus = psRadio->psHAL->pfnTransfer(psRadio->pvHALContext, ucCommand, pucTxData, pucRxData, uiLength);
+#elif defined(NRF24L01_CONF_FAST_SPI)
+	ucStatus = _NRF24L01_FastTransaction(psRadio, ucCommand, pucTxData, pucRxData, uiLength);
+#else
+#ifdef PDLIB_SPI
+	unsigned char ucFrame[TRANSACTION_FRAME];
+	unsigned int uiBurst = ((uiLength < (TRANSACTION_FRAME - 1)) ? uiLength : (TRANSACTION_FRAME - 1));
 
-	if((INTERNAL_STATE_DYNPL & internal_states) == 0){
-		if(ucDataPipe < 6)
-		{
-			reg = NRF24L01_RegisterRead_8(RF24_RX_PW_P0 + ucDataPipe);
-			ret = (reg & 0x3F);
-		}else
-		{
-			ret = 0;
-		}
-	}else{
-		NRF24L01_SendRcvCommand(RF24_R_RX_PL_WID, &reg, 1);
+	ucFrame[0] = ucCommand;
 
-		ret = reg;
+	if(pucTxData != NULL)
+	{
+		memcpy(&ucFrame[1], pucTxData, uiBurst);
+	}else
+	{
+		memset(&ucFrame[1], PDLIB_SPI_FILL_BYTE, uiBurst);
 	}
+#endif
 
-	return ret;
-}
-	
-	
-/* PS:
- * 
- * Function		: 	NRF24L01_SetTXAddress
- * 
- * Arguments	: 	address	:	Buffer which contains the five bytes to put to address.
- * 
- * Return		: 	None
- * 
- * Description	: 	Set the address of the module for TX mode. The data
- * 					packet which is transmitted from this RF module will
- * 					contain this address as destination address.
- * 
- */
- 
-void 
-NRF24L01_SetTXAddress(unsigned char* address)
-{
-	NRF24L01_RegisterWrite_Multi(RF24_TX_ADDR, (unsigned char*)address, 5);
+	_NRF24L01_CSNLow(psRadio);
+
+#ifdef PDLIB_SPI
+	/* PS: In place, a byte is received only after it was sent */
+	pdlibSPI_TransferData(RADIO_SSI(psRadio), ucFrame, ucFrame, (1 + uiBurst));
+
+	if(uiLength > uiBurst)
+	{
+		pdlibSPI_TransferData(RADIO_SSI(psRadio), ((pucTxData != NULL) ? &pucTxData[uiBurst] : NULL),
+							  ((pucRxData != NULL) ? &pucRxData[uiBurst] : NULL), (uiLength - uiBurst));
+	}
+#endif
+
+	_NRF24L01_CSNHigh(psRadio);
+
+#ifdef PDLIB_SPI
+	ucStatus = ucFrame[0];
+
+	if(pucRxData != NULL)
+	{
+		memcpy(pucRxData, &ucFrame[1], uiBurst);
+	}
+#endif
+#endif
+
+	_NRF24L01_StatusUpdate(psRadio, ucCommand, ucStatus);
+
+	PROFILE_BYTES(psRadio, 1 + uiLength);
+	TRACE(psRadio, PDLIB_NRF24_TRACE_SPI, ucCommand, uiLength, ucStatus);
+
+	return ucStatus;
 }
 
+
+#ifdef NRF24L01_CONF_FAST_SPI
+
 /* PS:
  *
- * Function		: 	NRF24L01_WaitForTxComplete
- *
- * Arguments	: 	busy_wait :	If this is 1 then the function will wait until DS or RT
- * 								bit in status register become '1'.
+ * Function		: 	_NRF24L01_FastTransaction
  *
- * 								If this is '0' the state of DS and RT interrupts will return.
+ * Arguments	: 	See _NRF24L01_Transaction
  *
- * Return		: 	PDLIB_NRF24_SUCCESS			:	TX completed successfully
- *					PDLIB_NRF24_TX_ARC_REACHED	:	Maximum retransmissions elapsed
- *					PDLIB_NRF24_ERROR			:	None of the TX interrupts asserted (only when busy_wait = 0)
+ * Return		: 	STATUS clocked out with the command byte
  *
- * Description	: 	The function can wait until the
- * 						-TX payload is successfully delivered (If ACK is available)
- * 						or
- * 						-TX payload has successfully transmitted.
+ * Description	: 	_NRF24L01_Transaction of NRF24L01_CONF_FAST_SPI. The SSI data and
+ * 					status registers are read and written directly, with the base
+ * 					fixed at build time. The command byte leads the burst: the data
+ * 					follows it into the TX FIFO without waiting for the status, and at
+ * 					most FAST_SSI_FIFO_DEPTH words are in flight so the RX FIFO cannot
+ * 					overflow. The last word received means the frame is clocked out.
  *
- *					This function will return 0 or a negative error code.
  */
 
-int
-NRF24L01_WaitForTxComplete(char busy_wait)
+static unsigned char
+_NRF24L01_FastTransaction(	tNRF24L01 *psRadio,
+							unsigned char ucCommand,
+							unsigned char *pucTxData,
+							unsigned char *pucRxData,
+							unsigned int uiLength)
 {
-	int ret = PDLIB_NRF24_SUCCESS;
+	unsigned int uiWords = (uiLength + 1);
+	unsigned int uiTx = 1;
+	unsigned int uiRx = 0;
+	unsigned long ulData;
+	unsigned char ucStatus = 0;
 
-	NRF24L01_GetStatus();
+	_NRF24L01_CSNLow(psRadio);
 
-#ifdef PDLIB_DEBUG
-	PrintRegValue("Current status :",g_ucStatus);
-#endif
+	FAST_SSI_DR = ucCommand;
 
-	if(busy_wait){
-		while((g_ucStatus & (RF24_MAX_RT | RF24_TX_DS)) == 0)
+	while(uiRx < uiWords)
+	{
+		while((uiTx < uiWords) && ((uiTx - uiRx) < FAST_SSI_FIFO_DEPTH) && (FAST_SSI_SR & SSI_SR_TNF))
 		{
-			NRF24L01_GetStatus();
-		}
-	}else{
-		if((g_ucStatus & (RF24_MAX_RT | RF24_TX_DS)) == 0){
-			ret = PDLIB_NRF24_ERROR;
+			FAST_SSI_DR = ((pucTxData != NULL) ? pucTxData[uiTx - 1] : PDLIB_SPI_FILL_BYTE);
+			uiTx++;
 		}
-	}
 
+		while((uiRx < uiTx) && (FAST_SSI_SR & SSI_SR_RNE))
+		{
+			ulData = FAST_SSI_DR;
+
+			if(0 == uiRx)
+			{
+				ucStatus = (unsigned char)ulData;
+			}else if(pucRxData != NULL)
+			{
+				pucRxData[uiRx - 1] = (unsigned char)ulData;
+			}
 
-	if(g_ucStatus & RF24_MAX_RT)
-	{
-#ifdef PDLIB_DEBUG
-		PrintRegValue("Maximum retransmissions reached!!! : status >> ",g_ucStatus);
-#endif
-		ret = PDLIB_NRF24_TX_ARC_REACHED;
+			uiRx++;
+		}
 	}
 
-	return ret;
+	_NRF24L01_CSNHigh(psRadio);
+
+	return ucStatus;
 }
 
+#endif
+
 
 /* PS:
  *
- * Function		: 	NRF24L01_GetInterruptState
+ * Function		: 	_NRF24L01_StatusUpdate
  *
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucCommand	:	Command byte of the transaction
+ * 					ucStatus	:	Status register clocked out with the command byte
  *
- * Return		: 	PDLIB_NRF24_ERROR			:	No interrupts asserted
- *					PDLIB_INTERRUPT_MAX_RT		:	Maximum retransmissions elapsed
- *					PDLIB_INTERRUPT_DATA_READY	:	Data ready on RX FIFO
- *					PDLIB_INTERRUPT_DATA_SENT	:	Data sent
+ * Return		: 	None
+ *
+ * Description	: 	Stores the status of every transaction (see NRF24L01_GetLastStatus)
+ * 					and counts the transaction against its path.
+ *
+ * 					The status is sampled before the command takes effect. A payload
+ * 					read or RX flush can empty the RX FIFO, so the pipe number is set
+ * 					to 'RX FIFO empty' to make the next reader poll the module.
  *
- * Description	: 	This function can be used to check the interrupt status
- * 					of the module.
  */
 
-char
-NRF24L01_GetInterruptState()
+static void
+_NRF24L01_StatusUpdate(tNRF24L01 *psRadio, unsigned char ucCommand, unsigned char ucStatus)
 {
-	char state = NRF24L01_GetStatus();
-
-	state &= (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT);
-	state = (state >> 4);
+	if((RF24_R_RX_PAYLOAD == ucCommand) || (RF24_FLUSH_RX == ucCommand))
+	{
+		ucStatus |= (BIT3 | BIT2 | BIT1);
+	}
 
-	return state;
+	psRadio->ucStatus = ucStatus;
+	psRadio->ulStatusSequence++;
 
+#ifdef NRF24L01_CONF_TRANSACTION_STATS
+	if(RF24_NOP == ucCommand)
+	{
+		psRadio->ulTransactionCount[PDLIB_NRF24_PATH_STATUS]++;
+	}else if(ucCommand < RF24_W_REGISTER)
+	{
+		psRadio->ulTransactionCount[PDLIB_NRF24_PATH_REGISTER_READ]++;
+	}else if(ucCommand <= (RF24_W_REGISTER | RF24_REGISTER_MASK))
+	{
+		psRadio->ulTransactionCount[PDLIB_NRF24_PATH_REGISTER_WRITE]++;
+	}else if((RF24_R_RX_PAYLOAD == ucCommand) || (RF24_R_RX_PL_WID == ucCommand))
+	{
+		psRadio->ulTransactionCount[PDLIB_NRF24_PATH_RX_PAYLOAD]++;
+	}else if((RF24_W_TX_PAYLOAD == ucCommand) || (RF24_W_TX_PAYLOAD_NOACK == ucCommand) ||
+			 (RF24_REUSE_TX_PL == ucCommand) || (RF24_W_ACK_PAYLOAD == (ucCommand & 0xF8)))
+	{
+		psRadio->ulTransactionCount[PDLIB_NRF24_PATH_TX_PAYLOAD]++;
+	}else
+	{
+		psRadio->ulTransactionCount[PDLIB_NRF24_PATH_CONTROL]++;
+	}
+#endif
 }
 
 
+#ifdef NRF24L01_CONF_TRANSACTION_STATS
+
 /* PS:
  *
- * Function		: 	NRF24L01_GetInterruptState
+ * Function		: 	NRF24L01_GetTransactionCount
  *
- * Arguments	: 	PDLIB_INTERRUPT_MAX_RT		:	Maximum retransmissions elapsed interrupt
- *					PDLIB_INTERRUPT_DATA_READY	:	Data ready on RX FIFO interrupt
- *					PDLIB_INTERRUPT_DATA_SENT	:	Data sent interrupt
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucPath	:	One of PDLIB_NRF24_PATH_*
  *
- * Return		:	None
+ * Return		: 	Number of SPI transactions on the path since NRF24L01_Init or
+ * 					NRF24L01_ResetTransactionCount
+ *
+ * Description	: 	Used to check how many SPI transactions a piece of code costs,
+ * 					eg. PDLIB_NRF24_PATH_STATUS counts the NOPs sent only to read
+ * 					the status.
  *
- * Description	: 	This function will clear the interrupt associated with the BM
  */
 
-void
-NRF24L01_ClearInterruptFlag(char interrupt_bm)
+unsigned long
+NRF24L01_GetTransactionCount(tNRF24L01 *psRadio, unsigned char ucPath)
 {
-	char status = NRF24L01_GetStatus();
-
-	status &= ~(RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT);
-
-	if(interrupt_bm & PDLIB_INTERRUPT_MAX_RT){
-		status |= RF24_MAX_RT;
-	}
+	unsigned long ulCount = 0;
 
-	if(interrupt_bm & PDLIB_INTERRUPT_DATA_READY){
-		status |= RF24_RX_DR;
-	}
-
-	if(interrupt_bm & PDLIB_INTERRUPT_DATA_SENT){
-		status |= RF24_TX_DS;
+	if(ucPath < PDLIB_NRF24_PATH_COUNT)
+	{
+		ulCount = psRadio->ulTransactionCount[ucPath];
 	}
 
-	NRF24L01_RegisterWrite_8(RF24_STATUS, status);
+	return ulCount;
 }
 
 
-
 /* PS:
  *
- * Function		: 	NRF24L01_AttemptTx
- *
- * Arguments	: 	None
+ * Function		: 	NRF24L01_ResetTransactionCount
  *
- * Return		: 	PDLIB_NRF24_SUCCESS			:	TX completed successfully
- *					PDLIB_NRF24_TX_ARC_REACHED	:	Maximum retransmissions elapsed
+ * Arguments	: 	psRadio	:	Radio instance
  *
- * Description	: 	This function will attempt to TX whatever data available in the
- * 					TX payload. It waits until the TX is done or maximum retransmissions
- * 					occur.
+ * Return		: 	None
+ *
+ * Description	: 	Clears the SPI transaction counters of all the paths.
  *
- * 					Module will be in Power Down mode when it returns.
  */
 
-int NRF24L01_AttemptTx()
+void
+NRF24L01_ResetTransactionCount(tNRF24L01 *psRadio)
 {
-	int ret = PDLIB_NRF24_SUCCESS;
+	unsigned char ucPath;
 
-#ifdef PDLIB_DEBUG
-	PrintString("Attempting TX...\n\r");
-#endif
+	for(ucPath = 0; ucPath < PDLIB_NRF24_PATH_COUNT; ucPath++)
+	{
+		psRadio->ulTransactionCount[ucPath] = 0;
+	}
+}
 
-	NRF24L01_EnableTxMode();
+#endif
 
-	ret = NRF24L01_WaitForTxComplete(1);
 
-	NRF24L01_DisableTxMode();
+#ifdef NRF24L01_CONF_PROFILE
 
-	NRF24L01_PowerDown();
+/* PS: Names used by NRF24L01_DumpProfile, in PDLIB_NRF24_PROF_* order */
+static const char * const g_pcProfileNames[PDLIB_NRF24_PROF_COUNT] =
+{
+	"SendData",
+	"SendDataTo",
+	"SubmitData",
+	"SetTxPayload",
+	"AttemptTx",
+	"WaitForTxComplete",
+	"SendDataAsync",
+	"QueueData",
+	"GetData",
+	"ReadRxPayload",
+	"IsDataReadyRx",
+	"WaitForDataRx",
+	"GetRxDataAmount",
+	"SetAckPayload",
+	"RxQueueGet",
+	"EnableTxMode",
+	"EnableRxMode",
+	"FlushTX",
+	"FlushRX",
+	"GetStatus",
+	"GetInterruptState",
+	"ClearInterruptFlag",
+	"RegisterRead_8",
+	"RegisterRead_Multi",
+	"RegisterWrite_8",
+	"RegisterWrite_Multi",
+	"SendCommand",
+	"SendRcvCommand",
+	"Tick",
+	"ISR TxAsyncService",
+	"ISR TxQueueService",
+	"ISR RxQueueService",
+	"StreamWrite",
+	"ISR StreamService",
+	"ISR BeaconService",
+	"ISR SPIEngineService",
+	"ApplyConfig",
+	"SelectNode"
+};
+
+static unsigned int _NRF24L01_ProfileAppend(char *pcLine, unsigned int uiPos, unsigned long long ullValue, char cEnd);
+static unsigned int _NRF24L01_ProfileAppendText(char *pcLine, unsigned int uiPos, const char *pcText);
 
-	return ret;
-}
 
 /* PS:
- * 
- * Function		: 	NRF24L01_SetRXAddress
- * 
- * Arguments	: 	ucDataPipe	:	Data pipe number
- * 					pucAddress	:	Buffer which contains the one/five bytes to put to address.
- * 
- * Return		: 	None
- * 
- * Description	: 	Set the RX address. P0 and P1 pipes have 5 byte address
- * 					other pipes have 1 byte address(LSB). Other bytes are taken from
- * 					the P1 pipe address.
- * 
+ *
+ * Function		: 	NRF24L01_GetProfile
+ *
+ * Arguments	: 	psRadio		:	Radio instance
+ * 					ucFunction	:	One of PDLIB_NRF24_PROF_*
+ * 					psProfile [out]	:	Copy of the profile
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Copied
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Unknown function or psProfile is NULL
+ *
+ * Description	: 	Profile of the function since NRF24L01_Init or NRF24L01_ResetProfile.
+ * 					Times include the driver functions called from it (eg. SendData
+ * 					includes SubmitData and AttemptTx) and, for a call interrupted by
+ * 					the IRQ handler, the IRQ services too. ulMin is ~0 until the first
+ * 					call.
+ *
+ * 					The counters are updated without masking interrupts. Read them from
+ * 					the context which calls the driver, or accept a torn copy.
+ *
  */
- 
-void 
-NRF24L01_SetRxAddress(	unsigned char ucDataPipe,
-						unsigned char *pucAddress)
+
+int
+NRF24L01_GetProfile(tNRF24L01 *psRadio, unsigned char ucFunction, tNRF24L01Profile *psProfile)
 {
-	if(pucAddress)
+	int ret = PDLIB_NRF24_INVALID_ARGUMENT;
+
+	if((ucFunction < PDLIB_NRF24_PROF_COUNT) && (NULL != psProfile))
 	{
-		switch(ucDataPipe)
-		{
-			case 0:
-			case 1:
-				NRF24L01_RegisterWrite_Multi((RF24_RX_ADDR_P0 + ucDataPipe), pucAddress, 5);
-				break;
-			case 2:
-			case 3:
-			case 4:
-			case 5:
-				NRF24L01_RegisterWrite_8((RF24_RX_ADDR_P0 + ucDataPipe),pucAddress[0]);
-				break;
-			default:
-				break;
-		}
+		*psProfile = psRadio->sProfile[ucFunction];
+		ret = PDLIB_NRF24_SUCCESS;
 	}
+
+	return ret;
 }
 
 
 /* PS:
- * 
- * Function		: 	NRF24L01_SetRXPacketSize
  *
- * Arguments	: 	ucDataPipe		:	Data pipe number
- * 					ucPacketSize	:	Packet size. (Maximum is 32)
+ * Function		: 	NRF24L01_ResetProfile
+ *
+ * Arguments	: 	psRadio	:	Radio instance
  *
  * Return		: 	None
  *
- * Description	: 	Set the packet size for a RX pipe.
+ * Description	: 	Clears the profiles of all the functions and starts the clock
+ * 					(see _NRF24L01_CycleInit).
  *
  */
 
 void
-NRF24L01_SetRXPacketSize(	unsigned char ucDataPipe,
-							unsigned char ucPacketSize)
+NRF24L01_ResetProfile(tNRF24L01 *psRadio)
 {
-	if(ucPacketSize < 32)
+	unsigned char ucFunction;
+
+	for(ucFunction = 0; ucFunction < PDLIB_NRF24_PROF_COUNT; ucFunction++)
 	{
-		NRF24L01_RegisterWrite_8((RF24_RX_PW_P0 + ucDataPipe), ucPacketSize);
+		psRadio->sProfile[ucFunction].ulCalls = 0;
+		psRadio->sProfile[ucFunction].ullTotal = 0;
+		psRadio->sProfile[ucFunction].ulMin = ~0UL;
+		psRadio->sProfile[ucFunction].ulMax = 0;
+		psRadio->sProfile[ucFunction].ullBytes = 0;
 	}
 
+	psRadio->ullProfileBytes = 0;
+
+	_NRF24L01_CycleInit();
 }
 
 
 /* PS:
  *
- * Function		: 	NRF24L01_CarrierDetect
+ * Function		: 	NRF24L01_GetProfileTickRate
  *
  * Arguments	: 	None
  *
- * Return		: 	'1' - There is a carrier signal
- * 					'0' - There is no carrier signal
+ * Return		: 	Profile ticks per second
  *
- * Description	: 	Check whether there is any RF carrier in the current frequency channel
+ * Description	: 	The system clock on the LM4F120H5QR (DWT counts CPU cycles),
+ * 					1000000000 on host builds (nanoseconds).
  *
  */
 
-unsigned char NRF24L01_CarrierDetect(){
-	unsigned char ucTemp = NRF24L01_RegisterRead_8(RF24_CD);
-	return (ucTemp & 0x01);
+unsigned long
+NRF24L01_GetProfileTickRate(void)
+{
+	return _NRF24L01_CycleRate();
 }
 
 
 /* PS:
  *
- * Function		: 	NRF24L01_SetTxPayload
- * 
- * Arguments	: 	pucData		:	Buffer which contains the data to be written to TX fifo
- * 					uiLength	:	Length of the data buffer
- * 
- * Return		: 	PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
- * 					PDLIB_NRF24_SUCCESS			: Success
- * 
- * Description	: 	Set the TX payload. 
- * 
+ * Function		: 	NRF24L01_GetProfileName
+ *
+ * Arguments	: 	ucFunction	:	One of PDLIB_NRF24_PROF_*
+ *
+ * Return		: 	Name of the function, NULL if unknown
+ *
+ * Description	: 	Name printed by NRF24L01_DumpProfile
+ *
  */
- 
-int
-NRF24L01_SetTxPayload(	char* pcData,
-						unsigned int uiLength)
+
+const char *
+NRF24L01_GetProfileName(unsigned char ucFunction)
 {
-	int ret = PDLIB_NRF24_SUCCESS;
+	const char *pcName = NULL;
 
-	if(pcData && uiLength > 0)
-	{
-		// PS: Check whether TX fifo is full
-		if(NRF24L01_IsTxFifoFull())
-		{
-			ret = PDLIB_NRF24_TX_FIFO_FULL;
-#ifdef PDLIB_DEBUG
-			PrintString("TX FIFO is full\n\r");
-#endif
-		}else
-		{
-			NRF24L01_SendCommand(RF24_W_TX_PAYLOAD, pcData, uiLength);
-		}
-	}else
+	if(ucFunction < PDLIB_NRF24_PROF_COUNT)
 	{
-		ret = PDLIB_NRF24_ERROR;
+		pcName = g_pcProfileNames[ucFunction];
 	}
 
-
-	return ret;
+	return pcName;
 }
 
 
 /* PS:
  *
- * Function		: 	NRF24L01_EnableFeatureAckPL
+ * Function		: 	NRF24L01_DumpProfile
  *
- * Arguments	: 	None
+ * Arguments	: 	psRadio		:	Radio instance
+ * 					pfnPrint	:	Prints one line, without the line ending
+ * 					pvArg		:	Passed to pfnPrint
  *
  * Return		: 	None
  *
- * Description	: 	Enable payload with ACK
+ * Description	: 	Prints the tick rate, a header and one comma separated line for
+ * 					every function called at least once:
+ *
+ * 						function,calls,total,min,max,avg,spi_bytes
+ *
+ * 					No printf is used, so pfnPrint can be a plain UART string print
+ * 					(eg. PrintString of uart_debug plus "\n\r").
  *
  */
 
 void
-NRF24L01_EnableFeatureAckPL()
+NRF24L01_DumpProfile(tNRF24L01 *psRadio, void (*pfnPrint)(void *pvArg, const char *pcLine), void *pvArg)
 {
-	char data = 0x73;
+	char cLine[128];
+	unsigned int uiPos;
+	unsigned char ucFunction;
+	tNRF24L01Profile sProfile;
 
-	if((internal_states & INTERNAL_STATE_STAND_BY) || (0 == (internal_states & INTERNAL_STATE_POWER_UP)))
-	{
-		/* PS: Enable dynpl for pipe0 */
-		NRF24L01_EnableFeatureDynPL(0x00);
+	uiPos = _NRF24L01_ProfileAppendText(cLine, 0, "# ticks per second ");
+	_NRF24L01_ProfileAppend(cLine, uiPos, NRF24L01_GetProfileTickRate(), '\0');
+	pfnPrint(pvArg, cLine);
 
-		/* PS: Check whether retransmission delay is sufficient */
-		data = NRF24L01_RegisterRead_8(RF24_SETUP_RETR);
+	pfnPrint(pvArg, "function,calls,total,min,max,avg,spi_bytes");
+
+	for(ucFunction = 0; ucFunction < PDLIB_NRF24_PROF_COUNT; ucFunction++)
+	{
+		NRF24L01_GetProfile(psRadio, ucFunction, &sProfile);
 
-		if(0 == ((data & 0xF0) >> 4)){
-			NRF24L01_SetARD(500);
+		if(0 == sProfile.ulCalls)
+		{
+			continue;
 		}
 
-		/* PS: Enable auto ack payload */
-		data = NRF24L01_RegisterRead_8(RF24_FEATURE);
-		NRF24L01_RegisterWrite_8(RF24_FEATURE, (data | RF24_EN_ACK_PAY));
+		uiPos = _NRF24L01_ProfileAppendText(cLine, 0, g_pcProfileNames[ucFunction]);
+		cLine[uiPos++] = ',';
+
+		uiPos = _NRF24L01_ProfileAppend(cLine, uiPos, sProfile.ulCalls, ',');
+		uiPos = _NRF24L01_ProfileAppend(cLine, uiPos, sProfile.ullTotal, ',');
+		uiPos = _NRF24L01_ProfileAppend(cLine, uiPos, sProfile.ulMin, ',');
+		uiPos = _NRF24L01_ProfileAppend(cLine, uiPos, sProfile.ulMax, ',');
+		uiPos = _NRF24L01_ProfileAppend(cLine, uiPos, sProfile.ullTotal / sProfile.ulCalls, ',');
+		uiPos = _NRF24L01_ProfileAppend(cLine, uiPos, sProfile.ullBytes, '\0');
+
+		pfnPrint(pvArg, cLine);
+	}
+}
+
 
-		internal_states |= INTERNAL_STATE_ACKPL;
+/* PS: Decimal followed by cEnd */
+static unsigned int
+_NRF24L01_ProfileAppend(char *pcLine, unsigned int uiPos, unsigned long long ullValue, char cEnd)
+{
+	char cDigits[20];
+	unsigned int uiCount = 0;
+
+	do
+	{
+		cDigits[uiCount++] = (char)('0' + (ullValue % 10));
+		ullValue /= 10;
+	}while(ullValue);
+
+	while(uiCount)
+	{
+		pcLine[uiPos++] = cDigits[--uiCount];
+	}
+
+	pcLine[uiPos++] = cEnd;
+
+	return uiPos;
+}
+
+
+/* PS: Text without its terminator */
+static unsigned int
+_NRF24L01_ProfileAppendText(char *pcLine, unsigned int uiPos, const char *pcText)
+{
+	while(*pcText)
+	{
+		pcLine[uiPos++] = *pcText++;
 	}
+
+	return uiPos;
 }
 
 
 /* PS:
  *
- * Function		: 	NRF24L01_EnableFeatureDynPL
+ * Function		: 	_NRF24L01_ProfileStart
  *
- * Arguments	: 	pipe : Pipe number to enable the feature
+ * Arguments	: 	psRadio	:	Radio instance
  *
- * Return		: 	None
+ * Return		: 	Start mark of the call (see PROFILE_START)
  *
- * Description	: 	Enable dynamic payload
+ * Description	: 	Samples the clock and the SPI byte count at the start of a call.
  *
  */
 
-void
-NRF24L01_EnableFeatureDynPL(unsigned char pipe)
+static tNRF24L01ProfileMark
+_NRF24L01_ProfileStart(tNRF24L01 *psRadio)
 {
-	char data = 0x73;
+	tNRF24L01ProfileMark sMark;
 
-	if((internal_states & INTERNAL_STATE_STAND_BY) || (0 == (internal_states & INTERNAL_STATE_POWER_UP)))
-	{
-		/* PS: Check whether features register is activated */
-		if(0 == (internal_states & INTERNAL_STATE_FEATURE_ENABLED))
-		{
-			char data = 0x73;
-			NRF24L01_SendCommand(RF24_ACTIVATE, &data, 1);
+	sMark.ullBytes = psRadio->ullProfileBytes;
+	sMark.ulStart = _NRF24L01_CycleNow();
 
-			internal_states |= INTERNAL_STATE_FEATURE_ENABLED;
-		}
+	return sMark;
+}
 
-		/* PS: Check whether DYN-PL feature is activated */
-		data = NRF24L01_RegisterRead_8(RF24_FEATURE);
 
-		if(0 == (data & RF24_EN_DPL)){
-			NRF24L01_RegisterWrite_8(RF24_FEATURE, (data | RF24_EN_DPL));
-		}
+/* PS:
+ *
+ * Function		: 	_NRF24L01_ProfileEnd
+ *
+ * Arguments	: 	psRadio		:	Radio instance
+ * 					ucFunction	:	One of PDLIB_NRF24_PROF_*
+ * 					psMark		:	Start mark of the call
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Adds the call to the profile of the function.
+ *
+ */
 
-		if(pipe <= 6)
-		{
-			/* PS: Check whether DYN-PD for 'pipe' is activated */
-			data = NRF24L01_RegisterRead_8(RF24_DYNPD);
+static void
+_NRF24L01_ProfileEnd(tNRF24L01 *psRadio, unsigned char ucFunction, tNRF24L01ProfileMark *psMark)
+{
+	unsigned long ulTicks = _NRF24L01_CycleNow() - psMark->ulStart;
+	tNRF24L01Profile *psProfile = &psRadio->sProfile[ucFunction];
 
-			if(0 == (data & pipe)){
-				NRF24L01_RegisterWrite_8(RF24_DYNPD, (data | (1 << pipe)));
-			}
-		}
+	psProfile->ulCalls++;
+	psProfile->ullTotal += ulTicks;
+	psProfile->ullBytes += (psRadio->ullProfileBytes - psMark->ullBytes);
+
+	if(ulTicks < psProfile->ulMin)
+	{
+		psProfile->ulMin = ulTicks;
+	}
 
-		internal_states |= INTERNAL_STATE_DYNPL;
+	if(ulTicks > psProfile->ulMax)
+	{
+		psProfile->ulMax = ulTicks;
 	}
 }
 
+#endif
+
+
+#ifdef CYCLE_CLOCK
+
+// ----------------------- Cycle clock ---------------------- //
+
 
 /* PS:
  *
- * Function		: 	NRF24L01_EnableFeatureNoAckTx
+ * Function		: 	_NRF24L01_CycleInit
  *
  * Arguments	: 	None
  *
  * Return		: 	None
  *
- * Description	: 	Enable W_TX_PAYLOAD_NOACK command
+ * Description	: 	Starts the DWT cycle counter on the LM4F120H5QR. It is not reset, so
+ * 					that a debugger or another user of it is not disturbed.
  *
  */
 
-
-void
-NRF24L01_EnableFeatureNoAckTx()
+static void
+_NRF24L01_CycleInit(void)
 {
-	char data = 0x73;
+#ifdef PART_LM4F120H5QR
+	HWREG(CYCLE_DEMCR) |= CYCLE_DEMCR_TRCENA;
+	HWREG(CYCLE_DWT_CTRL) |= CYCLE_DWT_CYCCNTENA;
+#endif
+}
 
-	if((internal_states & INTERNAL_STATE_STAND_BY) || (0 == (internal_states & INTERNAL_STATE_POWER_UP)))
-	{
-		/* PS: Check whether features register is activated */
-		if(0 == (internal_states & INTERNAL_STATE_FEATURE_ENABLED))
-		{
-			char data = 0x73;
-			NRF24L01_SendCommand(RF24_ACTIVATE, &data, 1);
 
-			internal_states |= INTERNAL_STATE_FEATURE_ENABLED;
-		}
+/* PS:
+ *
+ * Function		: 	_NRF24L01_CycleNow
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Current tick. Wraps, only differences are used.
+ *
+ * Description	: 	DWT CYCCNT on the LM4F120H5QR, the monotonic clock in nanoseconds
+ * 					on host builds.
+ *
+ */
+
+static unsigned long
+_NRF24L01_CycleNow(void)
+{
+#ifdef PART_LM4F120H5QR
+	return HWREG(CYCLE_DWT_CYCCNT);
+#else
+	struct timespec sNow;
 
-		/* PS: Check whether DYN-PL feature is activated */
-		data = NRF24L01_RegisterRead_8(RF24_FEATURE);
+	clock_gettime(CLOCK_MONOTONIC, &sNow);
 
-		if(0 == (data & RF24_EN_DYN_ACK)){
-			NRF24L01_RegisterWrite_8(RF24_FEATURE, (data | RF24_EN_DYN_ACK));
-		}
-	}
+	return ((unsigned long)sNow.tv_sec * 1000000000UL) + (unsigned long)sNow.tv_nsec;
+#endif
 }
 
 
-// PS: Implement TX reuse feature
-		// TODO
-
 /* PS:
  *
- * Function		: 	NRF24L01_GetData
- *
- * Arguments	:	pipe				:	Pipe number
- * 					pcData [out]		:	Allocated buffer to store the RX data
- * 					length	[in/out]	:	Length in bytes of pcData (only used in dynamic payload mode) // TODO
- *
- * Return		:
- * 					Positive	:	Number of bytes read
+ * Function		: 	_NRF24L01_CycleRate
  *
- * Description	:
- * 					This function will read the length amount of data from the RX FIFO
- * 					If the available data amount is more than the specified value this
- * 					will return an error.
+ * Arguments	: 	None
  *
- * 					Payload is automatically deleted from the FIFO once it is read.
+ * Return		: 	Ticks per second of _NRF24L01_CycleNow
  *
- * 					This will clear the data ready status bit in the module.
+ * Description	: 	The system clock on the LM4F120H5QR, 1000000000 on host builds.
  *
  */
 
-int
-NRF24L01_GetData(	char pipe,
-					char* pcData,
-					char *length)
+static unsigned long
+_NRF24L01_CycleRate(void)
 {
-	int ret = PDLIB_NRF24_SUCCESS; // Amount of data read
-	char cFifoStatus;
-	char cTemp;
-
-	// Check whether dynamic payload is available TODO
-
-	if(NULL == pcData)
-	{
-		ret = PDLIB_NRF24_INVALID_ARGUMENT;
-	}else{
+#ifdef PART_LM4F120H5QR
+	return ROM_SysCtlClockGet();
+#else
+	return 1000000000UL;
+#endif
+}
 
-		// PS: Validate pipe, Check FIFO status, Get packet size, Read data
-		if(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(&cTemp)){
+#endif
 
-			if(pipe == cTemp){
-				// Get FIFO status
-				cFifoStatus = NRF24L01_RegisterRead_8(RF24_FIFO_STATUS);
 
-				// Check whether FIFO is empty
-				if(0 == (cFifoStatus & RF24_RX_EMPTY)){
+#ifdef NRF24L01_CONF_TRACE
 
-					// PS: Check whether data is available
-					cTemp = NRF24L01_GetRxDataAmount(pipe);
+// ----------------------- Trace ---------------------- //
 
-					if((*length) >= cTemp){
-						(*length) = cTemp;
-					}else{
-						// PS: If the actual buffer size is smaller than the available data, we can miss data.
-						ret = PDLIB_NRF24_BUFFER_TOO_SMALL;
-					}
+#define TRACE_MASK		(NRF24L01_CONF_TRACE_DEPTH - 1)
 
-					if(PDLIB_NRF24_SUCCESS == ret){
+static unsigned long _NRF24L01_TraceNow(tNRF24L01 *psRadio);
+static unsigned long _NRF24L01_TraceReserve(tNRF24L01 *psRadio);
+static void _NRF24L01_TraceEncode(unsigned char *pucFrame, const tNRF24L01TraceEntry *psEntry);
 
-						// PS: Read RX payload
-						NRF24L01_ReadRxPayload(pcData, cTemp);
 
-						// TODO: Check whether we need to check the actual FIFO state before clearing the interrupt.
-						// Clear RX_DR
-						NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+/* PS:
+ *
+ * Function		: 	NRF24L01_TraceReset
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Empties the trace ring. Called by NRF24L01_Init. Nothing must be
+ * 					writing to the ring (no driver call, no IRQ service) meanwhile.
+ *
+ */
 
-						ret = cTemp;
-					}
+void
+NRF24L01_TraceReset(tNRF24L01 *psRadio)
+{
+	unsigned int uiIndex;
 
-				}else{
-					ret = PDLIB_NRF24_ERROR;
-				}
-			}else{
-				ret = PDLIB_NRF24_INVALID_ARGUMENT;
-			}
-		}else{
-			ret = PDLIB_NRF24_ERROR;
-		}
+	for(uiIndex = 0; uiIndex < NRF24L01_CONF_TRACE_DEPTH; uiIndex++)
+	{
+		psRadio->sTrace[uiIndex].ulSequence = 0;
 	}
 
-	return ret;
+	psRadio->ulTraceHead = 0;
+	psRadio->ulTraceTail = 0;
+	psRadio->ulTraceLost = 0;
+	psRadio->ucTraceClockSent = 0;
+
+	_NRF24L01_CycleInit();
 }
 
+
 /* PS:
  *
- * Function		: 	NRF24L01_ReadRxPayload
- *
- * Arguments	:	pcData [out]	:	Allocated buffer to store the RX data
- * 					cLength	[in]	:	Required data amount. This should be a valid data amount. (TODO: Verify whether this is neccessary to be valid)
- *
- * Return		:	None
+ * Function		: 	NRF24L01_TraceMark
  *
- * Description	:
- * 					This function will read the cLength amount of data from the RX FIFO.
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucMark	:	Any value, stored in ucCommand
  *
- * 					This function will not perform any validation of data sizes, buffer size, etc.
+ * Return		: 	None
  *
- * 					Payload is automatically deleted from the FIFO once it is read.
+ * Description	: 	Adds a PDLIB_NRF24_TRACE_MARK entry, to find application events
+ * 					in the timeline.
  *
  */
 
 void
-NRF24L01_ReadRxPayload(	char* pcData,
-						char cLength)
+NRF24L01_TraceMark(tNRF24L01 *psRadio, unsigned char ucMark)
 {
-	NRF24L01_SendRcvCommand(RF24_R_RX_PAYLOAD, pcData, cLength);
+	_NRF24L01_Trace(psRadio, PDLIB_NRF24_TRACE_MARK, ucMark, 0, psRadio->ucStatus);
 }
- 
+
 
 /* PS:
  *
- * Function		: 	NRF24L01_SetAckPayload
+ * Function		: 	NRF24L01_TraceRead
  *
- * Arguments	: 	pucData		:	Buffer which contains the data to be written to TX fifo
- * 					pipe		:	Which pipe to use (0~5)
- * 					uiLength	:	Length of the data buffer
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					psEntries [out]	:	Entries read, oldest first
+ * 					uiCount			:	Size of psEntries
  *
- * Return		: 	PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
- * 					PDLIB_NRF24_SUCCESS			: Success
+ * Return		: 	Number of entries read
  *
- * Description	: 	Set the Ack payload.
+ * Description	: 	Takes the finished entries out of the ring. An entry still being
+ * 					written stops the read, it is returned by the next call. Entries
+ * 					overwritten before they were read are skipped and counted (see
+ * 					NRF24L01_TraceGetLost).
+ *
+ * 					One reader only, from a context which may be interrupted by the
+ * 					writers (eg. the main loop).
  *
  */
 
-int
-NRF24L01_SetAckPayload(	char* pcData,
-						char pipe,
-						unsigned int uiLength)
+unsigned int
+NRF24L01_TraceRead(tNRF24L01 *psRadio, tNRF24L01TraceEntry *psEntries, unsigned int uiCount)
 {
-	int ret = PDLIB_NRF24_SUCCESS;
-	char address = pipe;
+	unsigned int uiRead = 0;
+	unsigned long ulTail = psRadio->ulTraceTail;
+	unsigned long ulHead;
+	unsigned long ulSequence;
+	volatile tNRF24L01TraceEntry *psSlot;
 
-	if(pipe < 5 && pcData && uiLength > 0)
+	while(uiRead < uiCount)
 	{
-		// PS: Check whether TX fifo is full
-		if(NRF24L01_IsTxFifoFull())
+		psSlot = &psRadio->sTrace[ulTail & TRACE_MASK];
+		ulSequence = psSlot->ulSequence;
+
+		if(ulSequence == (ulTail + 1))
 		{
-			ret = PDLIB_NRF24_TX_FIFO_FULL;
-#ifdef PDLIB_DEBUG
-			PrintString("TX FIFO is full\n\r");
-#endif
-		}else
+			psEntries[uiRead].ulSequence = ulSequence;
+			psEntries[uiRead].ulTime = psSlot->ulTime;
+			psEntries[uiRead].ucType = psSlot->ucType;
+			psEntries[uiRead].ucCommand = psSlot->ucCommand;
+			psEntries[uiRead].ucLength = psSlot->ucLength;
+			psEntries[uiRead].ucStatus = psSlot->ucStatus;
+
+			/* PS: A writer which took the slot meanwhile changes the sequence first */
+			if(psSlot->ulSequence == ulSequence)
+			{
+				uiRead++;
+				ulTail++;
+			}
+		}else if((long)(ulSequence - (ulTail + 1)) > 0)
 		{
-			address = address & 0x07;
-			address |= RF24_W_ACK_PAYLOAD;
+			/* PS: The writers lapped the reader, go on from the oldest entry still in the ring */
+			ulHead = psRadio->ulTraceHead;
 
-			NRF24L01_SendCommand(address , pcData, uiLength);
+			psRadio->ulTraceLost += ((ulHead - NRF24L01_CONF_TRACE_DEPTH) - ulTail);
+			ulTail = (ulHead - NRF24L01_CONF_TRACE_DEPTH);
+		}else
+		{
+			/* PS: Not written yet */
+			break;
 		}
-	}else
-	{
-		ret = PDLIB_NRF24_ERROR;
 	}
 
+	psRadio->ulTraceTail = ulTail;
 
-	return ret;
+	return uiRead;
 }
 
 
 /* PS:
  *
- * Function		: 	NRF24L01_
+ * Function		: 	NRF24L01_TraceGetLost
  *
- * Arguments	:
+ * Arguments	: 	psRadio	:	Radio instance
  *
- * Return		: 	None
+ * Return		: 	Entries overwritten before NRF24L01_TraceRead reached them, since
+ * 					the previous call
  *
- * Description	:
+ * Description	: 	Same context as NRF24L01_TraceRead.
  *
  */
 
-char
-NRF24L01_GetAckDataAmount()
+unsigned long
+NRF24L01_TraceGetLost(tNRF24L01 *psRadio)
 {
-	char data_amount = 0;
+	unsigned long ulLost = psRadio->ulTraceLost;
 
-	NRF24L01_SendRcvCommand(RF24_R_RX_PL_WID,&data_amount,1);
+	psRadio->ulTraceLost = 0;
 
-	return data_amount;
+	return ulLost;
 }
 
-/* PS:
- * 
- * Function		: 	NRF24L01_
- * 
- * Arguments	: 	
- * 
- * Return		: 	None
- * 
- * Description	: 	
- * 
- */
-
-
-// ----------------  Normal user level functions ------------------ //
 
 /* PS:
  *
- * Function		: 	NRF24L01_SendData
+ * Function		: 	NRF24L01_TraceDrain
  *
- * Arguments	: 	pcData		:	Data packet to send
- * 					ulLength	:	Length of the packet
+ * Arguments	: 	psRadio		:	Radio instance
+ * 					pfnWrite	:	Writes binary data, eg. to the UART
+ * 					pvArg		:	Passed to pfnWrite
+ * 					uiMaxEntries:	Most entries to write in this call
  *
- * Return		:	PDLIB_NRF24_SUCCESS			: Success
- * 					PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
- *					PDLIB_NRF24_TX_ARC_REACHED	: Maximum retransmissions elapsed
+ * Return		: 	Number of entries written
  *
- * Description	: 	The function will send the specified data using
- * 					current configuration. (current air data rate,
- * 					current power, current TX address, ... )
+ * Description	: 	Background export of the trace. Call it from the main loop, it
+ * 					writes PDLIB_NRF24_TRACE_FRAME_SIZE byte frames (see
+ * 					PDLIB_NRF24_TRACE_FRAME_START) and returns when the ring is empty
+ * 					or uiMaxEntries were written. The first call after a reset starts
+ * 					with a PDLIB_NRF24_TRACE_CLOCK frame, lost entries are reported by
+ * 					a PDLIB_NRF24_TRACE_LOST frame where they were lost.
  *
- * 					The function will return after the data is successfully transmitted or
- * 					maximum retransmissions were done. The module will be in Power Down state
- * 					when this function returns.
+ * 					example/host/pdlib_nrf24l01_trace decodes the frames into a timeline.
  *
  */
 
-int NRF24L01_SendData(char *pcData, unsigned int uiLength)
+unsigned int
+NRF24L01_TraceDrain(tNRF24L01 *psRadio,
+					void (*pfnWrite)(void *pvArg, const unsigned char *pucData, unsigned int uiLength),
+					void *pvArg,
+					unsigned int uiMaxEntries)
 {
-	int ret;
+	unsigned int uiDrained = 0;
+	unsigned char ucFrame[PDLIB_NRF24_TRACE_FRAME_SIZE];
+	tNRF24L01TraceEntry sEntry;
 
-	ret = NRF24L01_SubmitData(pcData, uiLength);
+	if(0 == psRadio->ucTraceClockSent)
+	{
+		sEntry.ulSequence = 0;
+		sEntry.ulTime = NRF24L01_GetTraceTickRate(psRadio);
+		sEntry.ucType = PDLIB_NRF24_TRACE_CLOCK;
+		sEntry.ucCommand = 0;
+		sEntry.ucLength = 0;
+		sEntry.ucStatus = 0;
 
-	if(ret == PDLIB_NRF24_SUCCESS)
+		_NRF24L01_TraceEncode(ucFrame, &sEntry);
+		pfnWrite(pvArg, ucFrame, PDLIB_NRF24_TRACE_FRAME_SIZE);
+
+		psRadio->ucTraceClockSent = 1;
+	}
+
+	while((uiDrained < uiMaxEntries) && NRF24L01_TraceRead(psRadio, &sEntry, 1))
 	{
+		if(psRadio->ulTraceLost)
+		{
+			tNRF24L01TraceEntry sLost;
+
+			sLost.ulSequence = 0;
+			sLost.ulTime = NRF24L01_TraceGetLost(psRadio);
+			sLost.ucType = PDLIB_NRF24_TRACE_LOST;
+			sLost.ucCommand = 0;
+			sLost.ucLength = 0;
+			sLost.ucStatus = 0;
+
+			_NRF24L01_TraceEncode(ucFrame, &sLost);
+			pfnWrite(pvArg, ucFrame, PDLIB_NRF24_TRACE_FRAME_SIZE);
+		}
+
+		_NRF24L01_TraceEncode(ucFrame, &sEntry);
+		pfnWrite(pvArg, ucFrame, PDLIB_NRF24_TRACE_FRAME_SIZE);
 
-		ret = NRF24L01_AttemptTx();
+		uiDrained++;
 	}
 
-	return ret;
+	return uiDrained;
 }
 
 
 /* PS:
  *
- * Function		: 	NRF24L01_SubmitData
+ * Function		: 	NRF24L01_GetTraceTickRate
  *
- * Arguments	: 	pcData		:	Data packet to send
- * 					ulLength	:	Length of the packet
+ * Arguments	: 	psRadio	:	Radio instance
  *
- * Return		:	PDLIB_NRF24_SUCCESS			: Success
- * 					PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
+ * Return		: 	Ticks per second of ulTime in the trace entries
  *
- * Description	: 	The function will send the specified data using
- * 					current configuration. (current air data rate,
- * 					current power, current TX address, ... )
+ * Description	: 	1000000 if the backend has a microsecond clock (the simulated
+ * 					clock for a simulated radio), the rate of the cycle clock otherwise
+ * 					(DWT on the LM4F120H5QR).
  *
- * 					This function will write data to payload buffer and make
- * 					sure correct addresses are there for automatic ack if available.
+ */
+
+unsigned long
+NRF24L01_GetTraceTickRate(tNRF24L01 *psRadio)
+{
+#ifdef NRF24L01_CONF_HAL
+	if(psRadio->psHAL->pfnGetTimeUs)
+	{
+		return 1000000UL;
+	}
+#endif
+
+	return _NRF24L01_CycleRate();
+}
+
+
+/* PS:
  *
- * 					The module needs to be Powered-Up and put into TX mode in order
- * 					to perform the transmission.
+ * Function		: 	_NRF24L01_Trace
+ *
+ * Arguments	: 	psRadio		:	Radio instance
+ * 					ucType		:	PDLIB_NRF24_TRACE_*
+ * 					ucCommand	:	SPI command byte or argument of the event
+ * 					uiLength	:	Data bytes after the command byte
+ * 					ucStatus	:	STATUS clocked out with the command byte
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Adds an entry. Lock-free: the slot is reserved with one atomic
+ * 					increment, so the IRQ services can trace while the interrupted
+ * 					code is tracing too. When the ring is full the oldest entry is
+ * 					overwritten.
  *
  */
 
-int NRF24L01_SubmitData(char *pcData, unsigned int uiLength)
+static void
+_NRF24L01_Trace(tNRF24L01 *psRadio, unsigned char ucType, unsigned char ucCommand, unsigned int uiLength, unsigned char ucStatus)
 {
-	int ret;
-	unsigned char address[5];
-	unsigned char cTemp;
-
-	// PS: Check the Auto Ack feature and make sure the data pipe 0 has the correct PTX address
-	cTemp = NRF24L01_RegisterRead_8(RF24_EN_AA);
+	unsigned long ulIndex = _NRF24L01_TraceReserve(psRadio);
+	volatile tNRF24L01TraceEntry *psSlot = &psRadio->sTrace[ulIndex & TRACE_MASK];
 
-	if(cTemp & RF24_ENAA_P0){
-		NRF24L01_RegisterRead_Multi(RF24_TX_ADDR, address, 5);
-		NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, address);
-	}
+	/* PS: The reader takes a slot only while its sequence is the expected one */
+	psSlot->ulSequence = 0;
 
-	ret = NRF24L01_SetTxPayload(pcData, uiLength);
+	psSlot->ulTime = _NRF24L01_TraceNow(psRadio);
+	psSlot->ucType = ucType;
+	psSlot->ucCommand = ucCommand;
+	psSlot->ucLength = (unsigned char)uiLength;
+	psSlot->ucStatus = ucStatus;
 
-	return ret;
+	psSlot->ulSequence = (ulIndex + 1);
 }
 
+
 /* PS:
  *
- * Function		: 	NRF24L01_SendDataTo
- *
- * Arguments	: 	pcData		:	Data packet to send
- * 					ulLength	:	Length of the packet
- * 					pcTxAddr	:	TX address
- *
- * Return		:	PDLIB_NRF24_SUCCESS			: Success
- * 					PDLIB_NRF24_TX_FIFO_FULL 	: Tx FIFO full
- *					PDLIB_NRF24_TX_ARC_REACHED	: Maximum retransmissions elapsed
+ * Function		: 	_NRF24L01_TraceReserve
  *
- * Description	: 	The function will send the specified data using
- * 					current configuration but to the specified address. (current air data rate,
- * 					current power, ... )
+ * Arguments	: 	psRadio	:	Radio instance
  *
- * 					The function will return after the data is successfully transmitted or
- * 					maximum retransmissions were done.
+ * Return		: 	Index of the reserved entry
  *
- * 					This function will change the TX address in the module.
+ * Description	: 	With GCC this is one LDREX/STREX loop on the Cortex-M4 (an atomic
+ * 					add on hosts). Other compilers mask the interrupts for the
+ * 					increment only.
  *
  */
 
-int NRF24L01_SendDataTo(unsigned char *address, char *pcData, unsigned int uiLength)
+static unsigned long
+_NRF24L01_TraceReserve(tNRF24L01 *psRadio)
 {
-	int iRet;
+	unsigned long ulIndex;
+#if defined(__GNUC__)
+	ulIndex = __atomic_fetch_add(&psRadio->ulTraceHead, 1UL, __ATOMIC_RELAXED);
+#elif defined(PART_LM4F120H5QR)
+	tBoolean bMasked = ROM_IntMasterDisable();
 
-	NRF24L01_SetTXAddress(address);
+	ulIndex = psRadio->ulTraceHead++;
 
-	iRet = NRF24L01_SendData(pcData, uiLength);
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#else
+	ulIndex = psRadio->ulTraceHead++;
+#endif
 
-	return iRet;
+	return ulIndex;
 }
 
 
+/* PS: Clock of the entries, see NRF24L01_GetTraceTickRate */
+static unsigned long
+_NRF24L01_TraceNow(tNRF24L01 *psRadio)
+{
+#ifdef NRF24L01_CONF_HAL
+	if(psRadio->psHAL->pfnGetTimeUs)
+	{
+		return psRadio->psHAL->pfnGetTimeUs(psRadio->pvHALContext);
+	}
+#endif
+
+	return _NRF24L01_CycleNow();
+}
 
 
+/* PS: Frame of NRF24L01_TraceDrain, multi byte fields little endian */
+static void
+_NRF24L01_TraceEncode(unsigned char *pucFrame, const tNRF24L01TraceEntry *psEntry)
+{
+	pucFrame[0] = PDLIB_NRF24_TRACE_FRAME_START;
+	pucFrame[1] = (unsigned char)(psEntry->ulSequence);
+	pucFrame[2] = (unsigned char)(psEntry->ulSequence >> 8);
+	pucFrame[3] = (unsigned char)(psEntry->ulSequence >> 16);
+	pucFrame[4] = (unsigned char)(psEntry->ulSequence >> 24);
+	pucFrame[5] = (unsigned char)(psEntry->ulTime);
+	pucFrame[6] = (unsigned char)(psEntry->ulTime >> 8);
+	pucFrame[7] = (unsigned char)(psEntry->ulTime >> 16);
+	pucFrame[8] = (unsigned char)(psEntry->ulTime >> 24);
+	pucFrame[9] = psEntry->ucType;
+	pucFrame[10] = psEntry->ucCommand;
+	pucFrame[11] = psEntry->ucLength;
+	pucFrame[12] = psEntry->ucStatus;
+}
 
-// ----------------------- Register Read/Write functions ---------------------- //
+#endif
 
 
 /* PS:
  * 
  * Function		: 	NRF24L01_RegisterWrite_8
  * 
- * Arguments	: 	ucRegister	:	Address of the register
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucRegister	:	Address of the register
  * 					ucValue		:	Value to write to the register
  * 
  * Return		: 	None
  * 
  * Description	: 	This function will write 1 byte of data to an 8 bit
  * 					register. The function will update the Status
- * 					variable too.
+ * 					variable and the register shadow too.
  * 
  */
  
 void
-NRF24L01_RegisterWrite_8(unsigned char ucRegister, unsigned char ucValue)
+NRF24L01_RegisterWrite_8(tNRF24L01 *psRadio, unsigned char ucRegister, unsigned char ucValue)
 {
-	unsigned char ucData[2];
-	
-	ucData[0] = (RF24_W_REGISTER | ucRegister);
-	ucData[1] = ucValue;
-	
-	_NRF24L01_CSNLow();
-	
-#ifdef PDLIB_SPI
-	/* PS: Send address */
-	g_ucStatus = pdlibSPI_TransferByte(ucData[0]);
+	PROFILE_START(psRadio);
 
-	/* PS: Send data */
-	pdlibSPI_TransferByte(ucData[1]);
-#endif
+	_NRF24L01_Transaction(psRadio, (RF24_W_REGISTER | ucRegister), &ucValue, NULL, 1);
+
+	if(IS_SHADOWED(ucRegister))
+	{
+		psRadio->ucShadow[ucRegister] = ucValue;
+	}else if(IS_ADDRESS(ucRegister))
+	{
+		psRadio->ucAddressShadow[ucRegister - RF24_RX_ADDR_P0][0] = ucValue;
+	}else if(RF24_STATUS == ucRegister)
+	{
+		// PS: Interrupt flags written with '1' are cleared now
+		psRadio->ucStatus &= ~(ucValue & (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT));
+	}
 
-	_NRF24L01_CSNHigh();
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_REGISTER_WRITE_8);
 }
 
 
@@ -1732,7 +7453,8 @@ NRF24L01_RegisterWrite_8(unsigned char ucRegister, unsigned char ucValue)
  * 
  * Function		: 	NRF24L01_RegisterWrite_Multi
  * 
- * Arguments	: 	ucRegister	:	Address of the register
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucRegister	:	Address of the register
  * 					pucData		:	Value to write to the register
  * 					uiLength	:	Length of the data field
  * 
@@ -1740,34 +7462,37 @@ NRF24L01_RegisterWrite_8(unsigned char ucRegister, unsigned char ucValue)
  * 
  * Description	: 	This function will write more than one byte of data 
  * 					to an the specified register. 
- * 					Function will update the Status	variable too.
+ * 					Function will update the Status	variable and the
+ * 					address shadow too.
  * 
  */
  
 void
-NRF24L01_RegisterWrite_Multi(	unsigned char ucRegister,
+NRF24L01_RegisterWrite_Multi(	tNRF24L01 *psRadio,
+								unsigned char ucRegister,
 								unsigned char *pucData,
 								unsigned int uiLength)
 {
+	unsigned int uiIndex;
+	PROFILE_START(psRadio);
+
 	if(NULL != pucData)
 	{
-		unsigned char *pucBuffer = (unsigned char*) malloc(sizeof(unsigned char) * (uiLength));
-		
-		if(NULL != pucBuffer)
-		{
-			memcpy(pucBuffer, pucData, uiLength);
-
-			_NRF24L01_CSNLow();
+		_NRF24L01_Transaction(psRadio, (RF24_W_REGISTER | ucRegister), pucData, NULL, uiLength);
 
-#ifdef PDLIB_SPI
-			g_ucStatus = pdlibSPI_TransferByte(RF24_W_REGISTER | ucRegister);
-			pdlibSPI_SendData(pucBuffer, uiLength);
-#endif
-			_NRF24L01_CSNHigh();
-
-			free(pucBuffer);
+		if((1 == uiLength) && IS_SHADOWED(ucRegister))
+		{
+			psRadio->ucShadow[ucRegister] = pucData[0];
+		}else if(IS_ADDRESS(ucRegister))
+		{
+			for(uiIndex = 0; (uiIndex < uiLength) && (uiIndex < ADDRESS_WIDTH(psRadio, ucRegister)); uiIndex++)
+			{
+				psRadio->ucAddressShadow[ucRegister - RF24_RX_ADDR_P0][uiIndex] = pucData[uiIndex];
+			}
 		}
 	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_REGISTER_WRITE_MULTI);
 }
 
 
@@ -1775,7 +7500,8 @@ NRF24L01_RegisterWrite_Multi(	unsigned char ucRegister,
  * 
  * Function		: 	NRF24L01_RegisterRead_8
  * 
- * Arguments	: 	ucRegister	:	Address of the register
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucRegister	:	Address of the register
  * 
  * Return		: 	The value in the 8 bit register
  * 
@@ -1786,19 +7512,14 @@ NRF24L01_RegisterWrite_Multi(	unsigned char ucRegister,
  */
  
 unsigned char
-NRF24L01_RegisterRead_8(unsigned char ucRegister)
+NRF24L01_RegisterRead_8(tNRF24L01 *psRadio, unsigned char ucRegister)
 {
-	unsigned char ucData;
+	unsigned char ucData = 0;
+	PROFILE_START(psRadio);
 
-	_NRF24L01_CSNLow();
-
-#ifdef PDLIB_SPI
-	g_ucStatus = pdlibSPI_TransferByte(RF24_R_REGISTER | ucRegister);
-	
-	ucData = pdlibSPI_TransferByte(RF24_NOP);
-#endif
+	_NRF24L01_Transaction(psRadio, (RF24_R_REGISTER | ucRegister), NULL, &ucData, 1);
 
-	_NRF24L01_CSNHigh();
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_REGISTER_READ_8);
 
 	return ucData;
 }
@@ -1808,7 +7529,8 @@ NRF24L01_RegisterRead_8(unsigned char ucRegister)
  *
  * Function		: 	NRF24L01_RegisterRead_Multi
  *
- * Arguments	: 	ucRegister	:	Address of the register
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucRegister	:	Address of the register
  * 					pucBuffer	: 	Buffer to store the reply
  * 					uiLength	:	Length of the buffer
  *
@@ -1821,26 +7543,19 @@ NRF24L01_RegisterRead_8(unsigned char ucRegister)
  */
 
 unsigned char
-NRF24L01_RegisterRead_Multi(	unsigned char ucRegister,
+NRF24L01_RegisterRead_Multi(	tNRF24L01 *psRadio,
+								unsigned char ucRegister,
 								unsigned char *pucBuffer,
 								unsigned int uiLength)
 {
-	int i;
-
-	_NRF24L01_CSNLow();
-
-#ifdef PDLIB_SPI
-	g_ucStatus = pdlibSPI_TransferByte(RF24_R_REGISTER | ucRegister);
+	unsigned char ucStatus;
+	PROFILE_START(psRadio);
 
-	for(i = 0; i<uiLength; i++)
-	{
-		pucBuffer[i] = pdlibSPI_TransferByte(RF24_NOP);
-	}
-#endif
+	ucStatus = _NRF24L01_Transaction(psRadio, (RF24_R_REGISTER | ucRegister), NULL, pucBuffer, uiLength);
 
-	_NRF24L01_CSNHigh();
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_REGISTER_READ_MULTI);
 
-	return g_ucStatus;
+	return ucStatus;
 }
 
 
@@ -1848,7 +7563,8 @@ NRF24L01_RegisterRead_Multi(	unsigned char ucRegister,
  *
  * Function		: 	NRF24L01_SendCommand
  *
- * Arguments	: 	ucCommand	:	Command to send.
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucCommand	:	Command to send.
  * 					pucData		:	Data associated with the command
  * 					uiLength	:	Length of the data field
  *
@@ -1859,34 +7575,27 @@ NRF24L01_RegisterRead_Multi(	unsigned char ucRegister,
  * 					If there is no payload for the command set the pucData NULL and
  * 					make the uiLength as 0
  *
+ * 					The data is streamed from the caller's buffer after the command
+ * 					byte, no heap or copy is used.
+ *
  */
 
 void
-NRF24L01_SendCommand(	unsigned char ucCommand,
+NRF24L01_SendCommand(	tNRF24L01 *psRadio,
+						unsigned char ucCommand,
 						char *pcData,
 						unsigned int uiLength)
 {
-	unsigned char *pucBuffer = (unsigned char*) malloc(sizeof(unsigned char) * (uiLength + 1));
+	PROFILE_START(psRadio);
 
-	if(NULL != pucBuffer)
+	if(NULL == pcData)
 	{
-		pucBuffer[0] = ucCommand;
-
-		if(NULL != pcData)
-		{
-			memcpy(&pucBuffer[1], pcData, uiLength);
-		}
-
-		_NRF24L01_CSNLow();
-
-#ifdef PDLIB_SPI
-		pdlibSPI_SendData(pucBuffer, uiLength+1);
-#endif
+		uiLength = 0;
+	}
 
-		_NRF24L01_CSNHigh();
+	_NRF24L01_Transaction(psRadio, ucCommand, (unsigned char*)pcData, NULL, uiLength);
 
-		free(pucBuffer);
-	}
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SEND_COMMAND);
 }
 
 
@@ -1894,7 +7603,8 @@ NRF24L01_SendCommand(	unsigned char ucCommand,
  *
  * Function		: 	NRF24L01_SendRcvCommand
  *
- * Arguments	: 	ucCommand	:	Command to send.
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ucCommand	:	Command to send.
  * 					pucData		:	Buffer to get data
  * 					uiLength	:	Length of the buffer
  *
@@ -1907,23 +7617,15 @@ NRF24L01_SendCommand(	unsigned char ucCommand,
  *
  */
 
-void NRF24L01_SendRcvCommand(unsigned char ucCommand, char *pcData, unsigned int uiLength)
+void NRF24L01_SendRcvCommand(tNRF24L01 *psRadio, unsigned char ucCommand, char *pcData, unsigned int uiLength)
 {
-	if(pcData){
-		int i = 0;
-
-		_NRF24L01_CSNLow();
+	PROFILE_START(psRadio);
 
-#ifdef PDLIB_SPI
-		g_ucStatus = pdlibSPI_TransferByte(ucCommand);
-
-		for(i = 0; i < uiLength; i++)
-		{
-			pcData[i] = pdlibSPI_TransferByte(RF24_NOP);
-		}
-#endif
-		_NRF24L01_CSNHigh();
+	if(pcData){
+		_NRF24L01_Transaction(psRadio, ucCommand, NULL, (unsigned char*)pcData, uiLength);
 	}
+
+	PROFILE_END(psRadio, PDLIB_NRF24_PROF_SEND_RCV_COMMAND);
 }
 
 
@@ -1934,7 +7636,7 @@ void NRF24L01_SendRcvCommand(unsigned char ucCommand, char *pcData, unsigned int
  *
  * Function		: 	_NRF24L01_CELow
  *
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  *
  * Return		: 	None
  *
@@ -1943,16 +7645,22 @@ void NRF24L01_SendRcvCommand(unsigned char ucCommand, char *pcData, unsigned int
  */
 
 static void
-_NRF24L01_CELow()
+_NRF24L01_CELow(tNRF24L01 *psRadio)
 {
-#ifdef PART_LM4F120H5QR
-	ROM_GPIOPinWrite(g_ulCEBase, g_ulCEPin, 0x00);
+#ifdef NRF24L01_CONF_HAL
+	psRadio->psHAL->pfnSetCE(psRadio->pvHALContext, 0);
+#elif defined(FAST_CE)
+	FAST_CE = 0x00;
+#elif defined(PART_LM4F120H5QR)
+	ROM_GPIOPinWrite(psRadio->ulCEBase, psRadio->ulCEPin, 0x00);
 #endif
 
-	if(internal_states & INTERNAL_STATE_POWER_UP){
-		internal_states |= INTERNAL_STATE_STAND_BY;
+	TRACE(psRadio, PDLIB_NRF24_TRACE_CE, 0, 0, psRadio->ucStatus);
+
+	if(psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP){
+		psRadio->uiInternalStates |= INTERNAL_STATE_STAND_BY;
 	}else{
-		internal_states &= (~INTERNAL_STATE_STAND_BY);
+		psRadio->uiInternalStates &= (~INTERNAL_STATE_STAND_BY);
 	}
 }
 
@@ -1961,7 +7669,7 @@ _NRF24L01_CELow()
  *
  * Function		: 	_NRF24L01_CEHigh
  *
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  *
  * Return		: 	None
  *
@@ -1970,56 +7678,202 @@ _NRF24L01_CELow()
  */
 
 static void
-_NRF24L01_CEHigh()
+_NRF24L01_CEHigh(tNRF24L01 *psRadio)
 {
-#ifdef PART_LM4F120H5QR
-	ROM_GPIOPinWrite(g_ulCEBase, g_ulCEPin, 0xFF);
+#ifdef NRF24L01_CONF_HAL
+	psRadio->psHAL->pfnSetCE(psRadio->pvHALContext, 1);
+#elif defined(FAST_CE)
+	FAST_CE = 0xFF;
+#elif defined(PART_LM4F120H5QR)
+	ROM_GPIOPinWrite(psRadio->ulCEBase, psRadio->ulCEPin, 0xFF);
 #endif
 
-	if(internal_states & INTERNAL_STATE_POWER_UP){
-		internal_states &= (~INTERNAL_STATE_STAND_BY);
+	TRACE(psRadio, PDLIB_NRF24_TRACE_CE, 1, 0, psRadio->ucStatus);
+
+	if(psRadio->uiInternalStates & INTERNAL_STATE_POWER_UP){
+		psRadio->uiInternalStates &= (~INTERNAL_STATE_STAND_BY);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_CEPulse
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Holds CE high for THCE_US, which starts one TX from Standby I.
+ * 					Held much longer, a module reusing its payload would send it
+ * 					again, so the pulse is timed by spinning and not by sleeping.
+ * 					A backend without a clock gets the time its two CE calls take.
+ *
+ */
+
+static void
+_NRF24L01_CEPulse(tNRF24L01 *psRadio)
+{
+	_NRF24L01_CEHigh(psRadio);
+
+	_NRF24L01_SpinUs(psRadio, THCE_US);
+
+	_NRF24L01_CELow(psRadio);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SpinUs
+ *
+ * Arguments	: 	psRadio	:	Radio instance
+ * 					ulUs		:	Time to wait
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Busy waits on the clock of the backend, or on SysCtlDelay. A clock
+ * 					which only moves with the radio (the simulator) does not move here,
+ * 					the wait then ends after SPIN_GUARD reads.
+ *
+ */
+
+static void
+_NRF24L01_SpinUs(tNRF24L01 *psRadio, unsigned long ulUs)
+{
+#ifdef NRF24L01_CONF_HAL
+	unsigned long ulStart;
+	unsigned long ulGuard = SPIN_GUARD;
+
+	if(psRadio->psHAL->pfnGetTimeUs)
+	{
+		ulStart = psRadio->psHAL->pfnGetTimeUs(psRadio->pvHALContext);
+
+		while(((psRadio->psHAL->pfnGetTimeUs(psRadio->pvHALContext) - ulStart) < ulUs) && --ulGuard)
+		{
+		}
 	}
+#elif defined(PART_LM4F120H5QR)
+	(void)psRadio;
+
+	// PS: Three cycles per SysCtlDelay count
+	ROM_SysCtlDelay(((ROM_SysCtlClockGet() / 3000000) * ulUs) + 1);
+#endif
 }
 
 
+#ifndef NRF24L01_CONF_HAL
 /* PS:
  *
  * Function		: 	_NRF24L01_CSNLow
  *
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  *
  * Return		: 	None
  *
- * Description	: 	This function drives the CSN pin low
+ * Description	: 	This function drives the CSN pin low. If a uDMA payload transfer
+ * 					or SPI engine transactions are running it waits until they are
+ * 					over, therefore must not be called from an interrupt with a
+ * 					higher priority than the SSI interrupt. Until _NRF24L01_CSNHigh
+ * 					the SPI engine starts no descriptor.
  *
  */
 
 static void
-_NRF24L01_CSNLow()
+_NRF24L01_CSNLow(tNRF24L01 *psRadio)
 {
-#ifdef PART_LM4F120H5QR
-	ROM_GPIOPinWrite(g_ulCSNBase, g_ulCSNPin, 0x00);
+#if defined(NRF24L01_CONF_SPI_ENGINE) && defined(PART_LM4F120H5QR)
+	tBoolean bMasked;
+#endif
+
+#if defined(PDLIB_SPI) && defined(PDLIB_SPI_CONF_UDMA)
+	/* PS: Wait for a running uDMA payload transfer, it releases CSN when it is over */
+	while(pdlibSPI_IsDMABusy(RADIO_SSI(psRadio)));
+#endif
+
+#if defined(NRF24L01_CONF_SPI_ENGINE) && defined(PART_LM4F120H5QR)
+	/* PS: Wait for the SPI engine, the SSI interrupt starts the queued transactions back-to-back.
+	 * The check, ucBusHeld and the CSN edge are one step, so an IRQ handler cannot start a
+	 * descriptor under this transaction (NRF24L01_SPIEngineSubmit leaves it queued) */
+	bMasked = _NRF24L01_EngineMaskIdle(psRadio);
+
+	psRadio->ucBusHeld = 1;
+#elif defined(NRF24L01_CONF_SPI_ENGINE)
+	while(psRadio->ucEngineBusy);
+
+	psRadio->ucBusHeld = 1;
+#endif
+
+#ifdef FAST_CSN
+	(void)psRadio;
+	FAST_CSN = 0x00;
+#elif defined(PART_LM4F120H5QR)
+	ROM_GPIOPinWrite(psRadio->ulCSNBase, psRadio->ulCSNPin, 0x00);
+#endif
+
+#if defined(NRF24L01_CONF_SPI_ENGINE) && defined(PART_LM4F120H5QR)
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
 #endif
 }
+#endif
 
 
 /* PS:
  *
  * Function		: 	_NRF24L01_CSNHigh
  *
- * Arguments	: 	None
+ * Arguments	: 	psRadio	:	Radio instance
  *
  * Return		: 	None
  *
- * Description	: 	This function drives the CSN pin high
+ * Description	: 	This function drives the CSN pin high. With NRF24L01_CONF_SPI_ENGINE
+ * 					the descriptors submitted during a blocking transaction start
+ * 					here.
  *
  */
 
 static void
-_NRF24L01_CSNHigh()
+_NRF24L01_CSNHigh(tNRF24L01 *psRadio)
 {
-#ifdef PART_LM4F120H5QR
-	ROM_GPIOPinWrite(g_ulCSNBase, g_ulCSNPin, 0xFF);
+#ifdef NRF24L01_CONF_HAL
+	if(psRadio->psHAL->pfnSetCSN)
+	{
+		psRadio->psHAL->pfnSetCSN(psRadio->pvHALContext, 1);
+	}
+#else
+#if defined(NRF24L01_CONF_SPI_ENGINE) && defined(PART_LM4F120H5QR)
+	tBoolean bMasked = ROM_IntMasterDisable();
+#endif
+
+#ifdef FAST_CSN
+	(void)psRadio;
+	FAST_CSN = 0xFF;
+#elif defined(PART_LM4F120H5QR)
+	ROM_GPIOPinWrite(psRadio->ulCSNBase, psRadio->ulCSNPin, 0xFF);
+#endif
+
+#ifdef NRF24L01_CONF_SPI_ENGINE
+	/* PS: End of a blocking transaction, start the descriptors submitted meanwhile */
+	if(psRadio->ucBusHeld)
+	{
+		psRadio->ucBusHeld = 0;
+
+		if(!psRadio->ucEngineBusy && (psRadio->uiEngineTail != psRadio->uiEngineHead))
+		{
+			_NRF24L01_EngineStart(psRadio);
+			_NRF24L01_EngineInt(psRadio, 1);
+		}
+	}
+#endif
+
+#if defined(NRF24L01_CONF_SPI_ENGINE) && defined(PART_LM4F120H5QR)
+	if(!bMasked)
+	{
+		ROM_IntMasterEnable();
+	}
+#endif
 #endif
 }
 
@@ -7,6 +7,139 @@
 
 //#define NRF24L01_CONF_INTERRUPT_PIN
 
+/* PS: Access the radio through a backend (tNRF24L01HAL, see NRF24L01_InitHAL) instead of
+ * the built-in Stellaris SSI/GPIO code */
+//#define NRF24L01_CONF_HAL
+
+/* PS: Count the SPI transactions of every path (see NRF24L01_GetTransactionCount) */
+//#define NRF24L01_CONF_TRANSACTION_STATS
+
+/* PS: Call count, time and SPI bytes of the public functions and the IRQ services (see
+ * NRF24L01_GetProfile). Timed with the DWT cycle counter on the LM4F120H5QR and with the
+ * monotonic clock (nanoseconds) on host builds. Nothing is compiled in without it. */
+//#define NRF24L01_CONF_PROFILE
+
+/* PS: Binary trace of the SPI transactions and radio events of every radio (see NRF24L01_TraceDrain) */
+//#define NRF24L01_CONF_TRACE
+
+/* PS: Entries the trace ring holds, a power of two. The oldest are overwritten. */
+#ifndef NRF24L01_CONF_TRACE_DEPTH
+#define NRF24L01_CONF_TRACE_DEPTH		64
+#endif
+
+/* PS: Software TX queue refilled from the IRQ (see NRF24L01_QueueData). Needs NRF24L01_CONF_INTERRUPT_PIN */
+//#define NRF24L01_CONF_TX_QUEUE
+
+/* PS: Number of payloads the software TX queue can hold */
+#ifndef NRF24L01_CONF_TX_QUEUE_DEPTH
+#define NRF24L01_CONF_TX_QUEUE_DEPTH	8
+#endif
+
+/* PS: MAX_RT the TX queue retries before it flushes the TX FIFO (0 flushes on the first one) */
+#ifndef NRF24L01_CONF_TX_QUEUE_RETRIES
+#define NRF24L01_CONF_TX_QUEUE_RETRIES	3
+#endif
+
+/* PS: Streaming TX with CE held high, fed from a buffer of the application (see NRF24L01_StreamStart) */
+//#define NRF24L01_CONF_TX_STREAM
+
+/* PS: RX ring drained from the IRQ (see NRF24L01_RxQueueService). Needs NRF24L01_CONF_INTERRUPT_PIN */
+//#define NRF24L01_CONF_RX_QUEUE
+
+/* PS: Number of payloads the RX ring can hold */
+#ifndef NRF24L01_CONF_RX_QUEUE_DEPTH
+#define NRF24L01_CONF_RX_QUEUE_DEPTH	8
+#endif
+
+/* PS: SPI transactions queued as descriptors and moved from the SSI interrupt (see NRF24L01_SPIEngineSubmit).
+ * Needs the built-in SSI code without uDMA, or a backend with the FIFO functions of tNRF24L01HAL. */
+//#define NRF24L01_CONF_SPI_ENGINE
+
+/* PS: Number of descriptors the SPI engine can hold */
+#ifndef NRF24L01_CONF_SPI_ENGINE_DEPTH
+#define NRF24L01_CONF_SPI_ENGINE_DEPTH	8
+#endif
+
+/* PS: Addresses of the nodes a PTX talks to, registered once and selected by number (see NRF24L01_SelectNode) */
+//#define NRF24L01_CONF_ADDRESS_BOOK
+
+/* PS: Number of addresses the address book can hold */
+#ifndef NRF24L01_CONF_ADDRESS_BOOK_SIZE
+#define NRF24L01_CONF_ADDRESS_BOOK_SIZE	8
+#endif
+
+/* PS: Power policy after NRF24L01_Init (see NRF24L01_SetPowerPolicy) */
+#ifndef NRF24L01_CONF_POWER_POLICY
+#define NRF24L01_CONF_POWER_POLICY		PDLIB_NRF24_POWER_ALWAYS_ON
+#endif
+
+/* PS: An asynchronous TX not over after this time is reported as PDLIB_NRF24_TX_TIMEOUT (see NRF24L01_Tick) */
+#ifndef NRF24L01_CONF_TX_TIMEOUT_MS
+#define NRF24L01_CONF_TX_TIMEOUT_MS		100
+#endif
+
+/* PS: SPI clock limit of the radio (8 MHz for nRF24L01, 10 MHz for nRF24L01+) */
+#ifndef NRF24L01_CONF_SPI_MAX_BITRATE
+#define NRF24L01_CONF_SPI_MAX_BITRATE	8000000
+#endif
+
+/* PS: Number of write/read-back rounds used to qualify a SPI bit rate (NRF24L01_CalibrateSPIClock) */
+#ifndef NRF24L01_CONF_SPI_CALIBRATION_ROUNDS
+#define NRF24L01_CONF_SPI_CALIBRATION_ROUNDS	8
+#endif
+
+/* PS: Payloads shorter than this are moved by the CPU even when uDMA is used (PDLIB_SPI_CONF_UDMA) */
+#ifndef NRF24L01_CONF_DMA_THRESHOLD
+#define NRF24L01_CONF_DMA_THRESHOLD		8
+#endif
+
+/* PS: The built-in SSI code moves the bytes and drives CE/CSN by writing the SSI and GPIO
+ * registers itself instead of calling the ROM. The wiring below is fixed at build time and
+ * used by every instance, NRF24L01_Init must be given the same. */
+//#define NRF24L01_CONF_FAST_SPI
+
+/* PS: The wiring below comes from NRF24L01_CONF_WIRING_HEADER and is the only one. The instances
+ * do not store it, NRF24L01_InitStatic replaces NRF24L01_Init and CE/CSN are driven with constant
+ * stores. Define PDLIB_SPI_CONF_SSI as NRF24L01_CONF_SSI as well to fix pdlib_spi to the module. */
+//#define NRF24L01_CONF_STATIC_WIRING
+
+#ifdef NRF24L01_CONF_STATIC_WIRING
+#ifndef NRF24L01_CONF_WIRING_HEADER
+#define NRF24L01_CONF_WIRING_HEADER		"pdlib_nrf24l01_wiring.h"
+#endif
+
+#include NRF24L01_CONF_WIRING_HEADER
+#endif
+
+/* PS: Wiring for NRF24L01_CONF_FAST_SPI and NRF24L01_CONF_STATIC_WIRING: SSI index as for
+ * NRF24L01_Init, GPIO port base, pin and peripheral of CE, CSN and IRQ, interrupt of IRQ and
+ * the SPI bit rate (PDLIB_NRF24_SPI_BITRATE_AUTO to calibrate) */
+#ifndef NRF24L01_CONF_SSI
+#define NRF24L01_CONF_SSI				3
+#endif
+
+#ifndef NRF24L01_CONF_CE_BASE
+#define NRF24L01_CONF_CE_BASE			GPIO_PORTE_BASE
+#define NRF24L01_CONF_CE_PIN			GPIO_PIN_1
+#define NRF24L01_CONF_CE_PERIPH			SYSCTL_PERIPH_GPIOE
+#endif
+
+#ifndef NRF24L01_CONF_CSN_BASE
+#define NRF24L01_CONF_CSN_BASE			GPIO_PORTE_BASE
+#define NRF24L01_CONF_CSN_PIN			GPIO_PIN_2
+#define NRF24L01_CONF_CSN_PERIPH		SYSCTL_PERIPH_GPIOE
+#endif
+
+#ifndef NRF24L01_CONF_IRQ_BASE
+#define NRF24L01_CONF_IRQ_BASE			GPIO_PORTE_BASE
+#define NRF24L01_CONF_IRQ_PIN			GPIO_PIN_3
+#define NRF24L01_CONF_IRQ_PERIPH		SYSCTL_PERIPH_GPIOE
+#define NRF24L01_CONF_IRQ_INT			INT_GPIOE
+#endif
+
+#ifndef NRF24L01_CONF_SPI_BITRATE
+#define NRF24L01_CONF_SPI_BITRATE		PDLIB_NRF24_SPI_BITRATE_AUTO
+#endif
 
 #define PDLIB_NRF24_SUCCESS				0
 #define PDLIB_NRF24_ERROR				-1
@@ -14,6 +147,20 @@
 #define PDLIB_NRF24_TX_ARC_REACHED		-3
 #define PDLIB_NRF24_INVALID_ARGUMENT	-4
 #define PDLIB_NRF24_BUFFER_TOO_SMALL	-5
+#define PDLIB_NRF24_BUSY				-6
+#define PDLIB_NRF24_SHADOW_MISMATCH		-7
+#define PDLIB_NRF24_TX_QUEUE_FULL		-8
+#define PDLIB_NRF24_TX_TIMEOUT			-9
+
+#define PDLIB_NRF24_TX_PENDING			1
+
+/* PS: Pass as the SPI bit rate of NRF24L01_Init to probe the fastest stable clock */
+#define PDLIB_NRF24_SPI_BITRATE_AUTO	0
+
+/* PS: Power policies */
+#define PDLIB_NRF24_POWER_ALWAYS_ON		0	// Stay in Standby I between packets
+#define PDLIB_NRF24_POWER_IDLE_TIMEOUT	1	// Power down after being idle for a while (see NRF24L01_Tick)
+#define PDLIB_NRF24_POWER_DOWN_AFTER_TX	2	// Power down after every TX
 
 #define PDLIB_NRF24_PIPE0	0
 #define PDLIB_NRF24_PIPE1	1
@@ -26,73 +173,558 @@
 #define PDLIB_INTERRUPT_DATA_SENT	1 << 1
 #define PDLIB_INTERRUPT_DATA_READY	1 << 2
 
+/* PS: SPI transaction paths (see NRF24L01_GetTransactionCount) */
+#define PDLIB_NRF24_PATH_STATUS			0	// NOP, only to read the status
+#define PDLIB_NRF24_PATH_REGISTER_READ	1
+#define PDLIB_NRF24_PATH_REGISTER_WRITE	2
+#define PDLIB_NRF24_PATH_RX_PAYLOAD		3	// R_RX_PAYLOAD, R_RX_PL_WID
+#define PDLIB_NRF24_PATH_TX_PAYLOAD		4	// W_TX_PAYLOAD, W_ACK_PAYLOAD, W_TX_PAYLOAD_NOACK, REUSE_TX_PL
+#define PDLIB_NRF24_PATH_CONTROL		5	// FLUSH_TX, FLUSH_RX, ACTIVATE
+#define PDLIB_NRF24_PATH_COUNT			6
+
+/* PS: Profiled functions (see NRF24L01_GetProfile). The NoAck variants count as their ACK siblings. */
+#define PDLIB_NRF24_PROF_SEND_DATA				0
+#define PDLIB_NRF24_PROF_SEND_DATA_TO			1
+#define PDLIB_NRF24_PROF_SUBMIT_DATA			2
+#define PDLIB_NRF24_PROF_SET_TX_PAYLOAD			3
+#define PDLIB_NRF24_PROF_ATTEMPT_TX				4
+#define PDLIB_NRF24_PROF_WAIT_FOR_TX_COMPLETE	5
+#define PDLIB_NRF24_PROF_SEND_DATA_ASYNC		6
+#define PDLIB_NRF24_PROF_QUEUE_DATA				7
+#define PDLIB_NRF24_PROF_GET_DATA				8
+#define PDLIB_NRF24_PROF_READ_RX_PAYLOAD		9
+#define PDLIB_NRF24_PROF_IS_DATA_READY_RX		10
+#define PDLIB_NRF24_PROF_WAIT_FOR_DATA_RX		11
+#define PDLIB_NRF24_PROF_GET_RX_DATA_AMOUNT		12
+#define PDLIB_NRF24_PROF_SET_ACK_PAYLOAD		13
+#define PDLIB_NRF24_PROF_RX_QUEUE_GET			14
+#define PDLIB_NRF24_PROF_ENABLE_TX_MODE			15
+#define PDLIB_NRF24_PROF_ENABLE_RX_MODE			16
+#define PDLIB_NRF24_PROF_FLUSH_TX				17
+#define PDLIB_NRF24_PROF_FLUSH_RX				18
+#define PDLIB_NRF24_PROF_GET_STATUS				19
+#define PDLIB_NRF24_PROF_GET_INTERRUPT_STATE	20
+#define PDLIB_NRF24_PROF_CLEAR_INTERRUPT_FLAG	21
+#define PDLIB_NRF24_PROF_REGISTER_READ_8		22
+#define PDLIB_NRF24_PROF_REGISTER_READ_MULTI	23
+#define PDLIB_NRF24_PROF_REGISTER_WRITE_8		24
+#define PDLIB_NRF24_PROF_REGISTER_WRITE_MULTI	25
+#define PDLIB_NRF24_PROF_SEND_COMMAND			26
+#define PDLIB_NRF24_PROF_SEND_RCV_COMMAND		27
+#define PDLIB_NRF24_PROF_TICK					28
+#define PDLIB_NRF24_PROF_ISR_TX_ASYNC			29	// NRF24L01_TxAsyncService
+#define PDLIB_NRF24_PROF_ISR_TX_QUEUE			30	// NRF24L01_TxQueueService
+#define PDLIB_NRF24_PROF_ISR_RX_QUEUE			31	// NRF24L01_RxQueueService
+#define PDLIB_NRF24_PROF_STREAM_WRITE			32
+#define PDLIB_NRF24_PROF_ISR_STREAM				33	// NRF24L01_StreamService
+#define PDLIB_NRF24_PROF_ISR_BEACON				34	// NRF24L01_BeaconService
+#define PDLIB_NRF24_PROF_ISR_SPI_ENGINE			35	// NRF24L01_SPIEngineService
+#define PDLIB_NRF24_PROF_APPLY_CONFIG			36
+#define PDLIB_NRF24_PROF_SELECT_NODE			37
+#define PDLIB_NRF24_PROF_COUNT					38
+
+/* PS: Trace entry types (ucType of tNRF24L01TraceEntry) */
+#define PDLIB_NRF24_TRACE_SPI			0	// ucCommand, ucLength and ucStatus of one SPI transaction
+#define PDLIB_NRF24_TRACE_CE			1	// ucCommand: new CE level
+#define PDLIB_NRF24_TRACE_ATTEMPT_TX	2	// NRF24L01_AttemptTx started
+#define PDLIB_NRF24_TRACE_WAIT_RX		3	// NRF24L01_WaitForDataRx started
+#define PDLIB_NRF24_TRACE_TX_FIFO_FULL	4	// ucCommand: payload command dropped by the module, ucStatus: STATUS
+#define PDLIB_NRF24_TRACE_MAX_RT		5	// ucStatus: STATUS
+#define PDLIB_NRF24_TRACE_TX_DONE		6	// Asynchronous TX over. ucCommand: retries, ucStatus: PDLIB_NRF24_* result
+#define PDLIB_NRF24_TRACE_ISR			7	// ucCommand: PDLIB_NRF24_TRACE_ISR_*
+#define PDLIB_NRF24_TRACE_MARK			8	// ucCommand: NRF24L01_TraceMark argument
+#define PDLIB_NRF24_TRACE_CLOCK			9	// Only in NRF24L01_TraceDrain output. ulTime: ticks per second
+#define PDLIB_NRF24_TRACE_LOST			10	// Only in NRF24L01_TraceDrain output. ulTime: entries overwritten before drained
+#define PDLIB_NRF24_TRACE_UNDERRUN		11	// Stream found the TX FIFO empty. ucLength: payloads waiting in the stream buffer
+
+#define PDLIB_NRF24_TRACE_ISR_TX_ASYNC	0	// NRF24L01_TxAsyncService
+#define PDLIB_NRF24_TRACE_ISR_TX_QUEUE	1	// NRF24L01_TxQueueService
+#define PDLIB_NRF24_TRACE_ISR_RX_QUEUE	2	// NRF24L01_RxQueueService
+#define PDLIB_NRF24_TRACE_ISR_STREAM	3	// NRF24L01_StreamService
+#define PDLIB_NRF24_TRACE_ISR_BEACON	4	// NRF24L01_BeaconService
+
+/* PS: Frame of NRF24L01_TraceDrain: this byte, then ulSequence and ulTime (little endian),
+ * ucType, ucCommand, ucLength and ucStatus */
+#define PDLIB_NRF24_TRACE_FRAME_START	0xA5
+#define PDLIB_NRF24_TRACE_FRAME_SIZE	13
+
+#ifdef NRF24L01_CONF_HAL
+#include "pdlib_nrf24l01_hal.h"
+
+#ifdef PDLIB_SPI_CONF_UDMA
+#error "uDMA payload transfers (PDLIB_SPI_CONF_UDMA) need the built-in SSI code, undefine NRF24L01_CONF_HAL"
+#endif
+#endif
+
+#if defined(NRF24L01_CONF_SPI_ENGINE) && defined(PDLIB_SPI_CONF_UDMA)
+#error "The SPI engine (NRF24L01_CONF_SPI_ENGINE) and uDMA payload transfers (PDLIB_SPI_CONF_UDMA) both own the SSI interrupt"
+#endif
+
+/* PS: Driver instance, one for every radio (see struct _NRF24L01Instance) */
+typedef struct _NRF24L01Instance tNRF24L01;
+
+/* PS: Completion callback of the non-blocking APIs. iResult is a PDLIB_NRF24_* code */
+typedef void (*tNRF24L01Callback)(tNRF24L01 *psRadio, int iResult);
+
+/* PS: Asynchronous TX handle (see NRF24L01_SendDataAsync). Owned by the caller */
+typedef struct
+{
+	volatile int iResult;			// PDLIB_NRF24_TX_PENDING until the TX is over
+	unsigned char ucRetries;		// ARC_CNT of OBSERVE_TX when the TX was over
+	unsigned long ulElapsedMs;		// Time counted by NRF24L01_Tick
+	tNRF24L01Callback pfnCallback;
+}tNRF24L01TxHandle;
+
+/* PS: Software TX queue statistics (see NRF24L01_GetTxQueueStats) */
+typedef struct
+{
+	unsigned int uiDepth;			// Payloads waiting in the software queue
+	unsigned int uiHighWater;		// Highest uiDepth seen
+	unsigned long ulQueued;			// Payloads accepted by NRF24L01_QueueData
+	unsigned long ulDropped;		// Payloads rejected because the queue was full
+	unsigned long ulLoaded;			// Payloads moved to the TX FIFO of the module
+	unsigned long ulSent;			// TX_DS interrupts
+	unsigned long ulMaxRT;			// MAX_RT interrupts
+	unsigned long ulRetried;		// MAX_RT after which the payload was retried
+	unsigned long ulFlushed;		// Payloads dropped from the TX FIFO after NRF24L01_CONF_TX_QUEUE_RETRIES
+}tNRF24L01TxQueueStats;
+
+/* PS: TX stream statistics (see NRF24L01_GetStreamStats) */
+typedef struct
+{
+	unsigned int uiDepth;			// Payloads waiting in the stream buffer
+	unsigned int uiHighWater;		// Highest uiDepth seen
+	unsigned long ulWritten;		// Payloads accepted by NRF24L01_StreamWrite
+	unsigned long ulDropped;		// Payloads rejected because the stream buffer was full
+	unsigned long ulLoaded;			// Payloads moved to the TX FIFO of the module
+	unsigned long ulSent;			// TX_DS interrupts
+	unsigned long ulMaxRT;			// MAX_RT interrupts (the payload is retried)
+	unsigned long ulUnderruns;		// Times the TX FIFO ran empty while the stream was running
+}tNRF24L01StreamStats;
+
+/* PS: Beacon statistics (see NRF24L01_GetBeaconStats) */
+typedef struct
+{
+	unsigned long ulFired;			// Transmissions started, the first one included
+	unsigned long ulSent;			// TX_DS interrupts
+	unsigned long ulMaxRT;			// MAX_RT interrupts (the payload stays for the next one)
+	unsigned long ulBytesSaved;		// SPI bytes of the W_TX_PAYLOAD the repeats did not need
+}tNRF24L01BeaconStats;
+
+/* PS: Register image of the configuration (see NRF24L01_ApplyConfig), register values as in the datasheet */
+typedef struct
+{
+	unsigned char ucConfig;				// CONFIG. PWR_UP and PRIM_RX are only taken by NRF24L01_RegisterInit
+	unsigned char ucEnAA;				// EN_AA
+	unsigned char ucEnRxAddr;			// EN_RXADDR
+	unsigned char ucSetupAW;			// SETUP_AW, 1 to 3
+	unsigned char ucSetupRetr;			// SETUP_RETR
+	unsigned char ucRFChannel;			// RF_CH, 0 to 127
+	unsigned char ucRFSetup;			// RF_SETUP
+	unsigned char ucRxPayloadWidth[6];	// RX_PW_P0 to RX_PW_P5, 0 to 32
+	unsigned char ucDynPD;				// DYNPD
+	unsigned char ucFeature;			// FEATURE
+	unsigned char ucRxAddrP0[5];		// LSByte first
+	unsigned char ucRxAddrP1[5];
+	unsigned char ucRxAddrP2to5[4];		// LSByte of pipes 2 to 5, the rest is from pipe 1
+	unsigned char ucTxAddr[5];
+}tNRF24L01Config;
+
+/* PS: One SPI transaction of the SPI engine (see NRF24L01_SPIEngineSubmit). Owned by the caller,
+ * untouched by the engine from the completion callback on, so the callback may submit it again. */
+typedef struct _NRF24L01SPIOp tNRF24L01SPIOp;
+
+typedef void (*tNRF24L01SPIOpCallback)(tNRF24L01 *psRadio, tNRF24L01SPIOp *psOp);
+
+struct _NRF24L01SPIOp
+{
+	unsigned char ucCommand;
+	unsigned char *pucTxData;				// Data after the command, NULL sends RF24_NOP
+	unsigned char *pucRxData;				// Data received after the command, NULL discards it
+	unsigned int uiLength;					// Data bytes after the command
+	tNRF24L01SPIOpCallback pfnComplete;		// Called from the SSI interrupt after CSN went high, may be NULL
+	void *pvArg;
+	unsigned char ucStatus;					// STATUS clocked out with the command, set before pfnComplete
+};
+
+/* PS: SPI engine statistics (see NRF24L01_GetSPIEngineStats) */
+typedef struct
+{
+	unsigned int uiHighWater;		// Most descriptors waiting at once, the running one included
+	unsigned long ulSubmitted;		// Descriptors accepted by NRF24L01_SPIEngineSubmit
+	unsigned long ulRejected;		// Descriptors rejected because the queue was full
+	unsigned long ulCompleted;		// Transactions over
+	unsigned long ulServices;		// NRF24L01_SPIEngineService calls
+	unsigned long ulBytes;			// SPI bytes, command bytes included
+}tNRF24L01SPIEngineStats;
+
+/* PS: IRQ service run as a chain of SPI engine transactions (see NRF24L01_IRQChainStart). Owned by the caller */
+typedef struct _NRF24L01IRQChain tNRF24L01IRQChain;
+
+typedef void (*tNRF24L01IRQChainCallback)(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain);
+
+struct _NRF24L01IRQChain
+{
+	tNRF24L01IRQChainCallback pfnPayload;	// Every payload read, from the SSI interrupt. May be NULL
+	tNRF24L01IRQChainCallback pfnDone;		// End of the chain, from the SSI interrupt. May be NULL
+	void *pvArg;
+
+	char cState;							// Interrupt state when the chain started (as NRF24L01_GetInterruptState)
+	unsigned char ucPipe;					// Pipe and length of cData, valid in pfnPayload
+	unsigned char ucLength;
+	char cData[32];
+	unsigned int uiPayloads;				// Payloads read by this run
+	unsigned int uiInvalid;					// Dynamic payload widths above 32 (RX FIFO flushed)
+
+	/* PS: Private to the driver */
+	volatile unsigned char ucBusy;
+	unsigned char ucStep;
+	unsigned char ucValue;
+	tNRF24L01SPIOp sOp;
+};
+
+/* PS: RX ring statistics (see NRF24L01_GetRxQueueStats) */
+typedef struct
+{
+	unsigned int uiDepth;			// Payloads waiting in the ring
+	unsigned int uiHighWater;		// Highest uiDepth seen
+	unsigned long ulReceived;		// Payloads moved from the RX FIFO to the ring
+	unsigned long ulDropped;		// Payloads read from the RX FIFO while the ring was full
+	unsigned long ulInvalid;		// Dynamic payload widths above 32 (RX FIFO flushed)
+}tNRF24L01RxQueueStats;
+
+/* PS: Profile of one function (see NRF24L01_GetProfile). Times are in ticks of
+ * NRF24L01_GetProfileTickRate and include the functions called from it. */
+typedef struct
+{
+	unsigned long ulCalls;
+	unsigned long long ullTotal;
+	unsigned long ulMin;
+	unsigned long ulMax;
+	unsigned long long ullBytes;	// SPI bytes moved, command bytes included
+}tNRF24L01Profile;
+
+/* PS: One trace entry. ucCommand is the SPI command byte, register commands carry the
+ * register in the low bits. ulSequence counts the entries from 1 and is written last. */
+typedef struct
+{
+	unsigned long ulSequence;
+	unsigned long ulTime;			// Ticks of NRF24L01_GetTraceTickRate
+	unsigned char ucType;			// PDLIB_NRF24_TRACE_*
+	unsigned char ucCommand;
+	unsigned char ucLength;			// Data bytes after the command byte
+	unsigned char ucStatus;			// STATUS clocked out with the command byte
+}tNRF24L01TraceEntry;
+
+/* PS: One payload of the RX ring */
+typedef struct
+{
+	char cData[32];
+	unsigned char ucLength;
+	unsigned char ucPipe;
+}tNRF24L01RxSlot;
+
+/* PS: Everything the driver knows about one radio. Allocated by the application (static or
+ * on the stack of a task) and passed to every API. Instances share no mutable state, so
+ * radios on different SSI modules can be driven from different interrupt contexts.
+ * The members are private to the driver. */
+struct _NRF24L01Instance
+{
+#ifdef NRF24L01_CONF_HAL
+	const tNRF24L01HAL *psHAL;
+	void *pvHALContext;
+#endif
+
+#ifndef NRF24L01_CONF_STATIC_WIRING
+	unsigned long ulCEBase;
+	unsigned long ulCEPin;
+	unsigned long ulCSNBase;
+	unsigned long ulCSNPin;
+	unsigned char ucSSI;
+#endif
+	unsigned long ulSPIBitRate;
+
+	unsigned int uiInternalStates;
+	unsigned char ucStatus;					// STATUS returned by the last SPI transaction
+	unsigned long ulStatusSequence;			// Incremented on every ucStatus update
+	unsigned char ucShadow[RF24_FEATURE + 1];	// Last value written to each shadowed register
+	unsigned char ucAddressShadow[7][5];	// RX_ADDR_P0 to RX_ADDR_P5 and TX_ADDR, LSByte first (one byte for pipes 2 to 5)
+
+#ifdef NRF24L01_CONF_TRANSACTION_STATS
+	unsigned long ulTransactionCount[PDLIB_NRF24_PATH_COUNT];
+#endif
+
+#ifdef NRF24L01_CONF_TRACE
+	volatile tNRF24L01TraceEntry sTrace[NRF24L01_CONF_TRACE_DEPTH];
+	volatile unsigned long ulTraceHead;		// Entries reserved by the writers
+	unsigned long ulTraceTail;				// Entries read by NRF24L01_TraceRead
+	unsigned long ulTraceLost;				// Overwritten before they were read
+	unsigned char ucTraceClockSent;
+#endif
+
+#ifdef NRF24L01_CONF_PROFILE
+	tNRF24L01Profile sProfile[PDLIB_NRF24_PROF_COUNT];
+	unsigned long long ullProfileBytes;		// SPI bytes moved since NRF24L01_ResetProfile
+#endif
+
+	unsigned char ucPowerPolicy;
+	unsigned long ulPowerIdleTimeout;
+	volatile unsigned long ulPowerIdleTime;
+
+	tNRF24L01TxHandle * volatile psTxHandle;
+
+	/* PS: Beacon (see NRF24L01_BeaconStart) */
+	volatile unsigned char ucBeaconState;
+	unsigned char ucBeaconLength;
+	unsigned long ulBeaconCount;			// Transmissions to make, 0 until stopped
+	unsigned long ulBeaconPeriodMs;
+	volatile unsigned long ulBeaconElapsedMs;	// Since the last transmission started, by NRF24L01_Tick
+	tNRF24L01BeaconStats sBeaconStats;
+
+#ifdef NRF24L01_CONF_TX_QUEUE
+	/* PS: One slot more than the depth, so that head == tail only when empty */
+	char cTxQueueData[NRF24L01_CONF_TX_QUEUE_DEPTH + 1][32];
+	unsigned char ucTxQueueLength[NRF24L01_CONF_TX_QUEUE_DEPTH + 1];
+	unsigned char ucTxQueueCommand[NRF24L01_CONF_TX_QUEUE_DEPTH + 1];	// W_TX_PAYLOAD or W_TX_PAYLOAD_NOACK
+	volatile unsigned int uiTxQueueHead;		// Written by NRF24L01_QueueData
+	volatile unsigned int uiTxQueueTail;		// Written by _NRF24L01_TxQueueRefill
+	volatile unsigned char ucTxQueueActive;
+	unsigned char ucTxQueueFifo;				// Payloads in the TX FIFO, never less than the real number
+	unsigned char ucTxQueueRetries;				// MAX_RT of the payload at the head of the TX FIFO
+	tNRF24L01TxQueueStats sTxQueueStats;
+#endif
+
+#ifdef NRF24L01_CONF_TX_STREAM
+	char *pcStreamBuffer;					// uiStreamSlots payloads of ucStreamLength bytes
+	unsigned int uiStreamSlots;				// Power of two
+	unsigned char ucStreamLength;
+	unsigned char ucStreamCommand;			// W_TX_PAYLOAD or W_TX_PAYLOAD_NOACK
+	volatile unsigned int uiStreamHead;		// Payloads written, by NRF24L01_StreamWrite
+	volatile unsigned int uiStreamTail;		// Payloads loaded, by _NRF24L01_StreamRefill
+	volatile unsigned char ucStreamState;
+	tNRF24L01StreamStats sStreamStats;
+#endif
+
+#ifdef NRF24L01_CONF_RX_QUEUE
+	tNRF24L01RxSlot sRxQueue[NRF24L01_CONF_RX_QUEUE_DEPTH + 1];
+	volatile unsigned int uiRxQueueHead;		// Written by NRF24L01_RxQueueService
+	volatile unsigned int uiRxQueueTail;		// Written by NRF24L01_RxQueueGet
+	tNRF24L01RxQueueStats sRxQueueStats;
+#endif
+
+#ifdef PDLIB_SPI_CONF_UDMA
+	tNRF24L01Callback pfnDMACallback;
+#endif
+
+#ifdef NRF24L01_CONF_ADDRESS_BOOK
+	unsigned char ucAddressBook[NRF24L01_CONF_ADDRESS_BOOK_SIZE][5];	// LSByte first
+	unsigned char ucAddressBookCount;
+#endif
+
+#ifdef NRF24L01_CONF_SPI_ENGINE
+	tNRF24L01SPIOp *psEngineQueue[NRF24L01_CONF_SPI_ENGINE_DEPTH + 1];
+	volatile unsigned int uiEngineHead;		// Written by NRF24L01_SPIEngineSubmit
+	volatile unsigned int uiEngineTail;		// Written when the running transaction is over
+	volatile unsigned char ucEngineBusy;	// CSN is low for the descriptor at uiEngineTail
+	volatile unsigned char ucBusHeld;		// CSN is low for a blocking transaction, descriptors wait
+	unsigned int uiEngineTx;				// Bytes of it queued to the TX FIFO, command included
+	unsigned int uiEngineRx;				// Bytes of it taken from the RX FIFO
+	tNRF24L01SPIEngineStats sEngineStats;
+#endif
+};
+
 /* PS: Function prototypes */
 
 /* PS: Basic APIs */
-void NRF24L01_Init(unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph, unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph, unsigned char ucSSIIndex);
-int NRF24L01_SendData(char *pcData, unsigned int uiLength);
-int NRF24L01_SendDataTo(unsigned char *address, char *pcData, unsigned int uiLength);
-int NRF24L01_WaitForDataRx(char *pcPipeNo);
-char NRF24L01_GetRxDataAmount(unsigned char ucDataPipe);
-int NRF24L01_GetData(char pipe, char* pcData, char *length);
+#ifdef NRF24L01_CONF_HAL
+void NRF24L01_InitHAL(tNRF24L01 *psRadio, const tNRF24L01HAL *psHAL, void *pvContext);
+unsigned long NRF24L01_GetTimeUs(tNRF24L01 *psRadio);
+#elif defined(NRF24L01_CONF_STATIC_WIRING)
+void NRF24L01_InitStatic(tNRF24L01 *psRadio);
+#else
+void NRF24L01_Init(tNRF24L01 *psRadio, unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph, unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph, unsigned char ucSSIIndex, unsigned long ulSPIBitRate);
+#endif
+int NRF24L01_SendData(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength);
+int NRF24L01_SendDataNoAck(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength);
+int NRF24L01_SendDataTo(tNRF24L01 *psRadio, unsigned char *address, char *pcData, unsigned int uiLength);
+int NRF24L01_WaitForDataRx(tNRF24L01 *psRadio, char *pcPipeNo);
+char NRF24L01_GetRxDataAmount(tNRF24L01 *psRadio, unsigned char ucDataPipe);
+int NRF24L01_GetData(tNRF24L01 *psRadio, char pipe, char* pcData, char *length);
 
 /* Intermediate APIs */
 /* PS: Configuration APIs */
 
-void NRF24L01_RegisterInit();
+void NRF24L01_RegisterInit(tNRF24L01 *psRadio);
+unsigned long NRF24L01_CalibrateSPIClock(tNRF24L01 *psRadio, unsigned long ulMaxBitRate);
+unsigned long NRF24L01_GetSPIBitRate(tNRF24L01 *psRadio);
 
 #ifdef NRF24L01_CONF_INTERRUPT_PIN
-void NRF24L01_InterruptInit(unsigned long ulIRQBase, unsigned long ulIRQPin, unsigned long ulIRQPeriph, unsigned long ulInterrupt);
-#endif
-
-void NRF24L01_PowerDown();
-void NRF24L01_PowerUp();
-void NRF24L01_SetAirDataRate(unsigned char ucDataRate);
-void NRF24L01_SetLNAGain(unsigned char ucLNAGain);
-void NRF24L01_SetPAGain(int iPAGain);
-void NRF24L01_SetRFChannel(unsigned char ucRFChannel);
-void NRF24L01_SetARC(unsigned char ucVal);
-void NRF24L01_SetARD(unsigned short ucVal);
-void NRF24L01_SetAddressWidth(unsigned char ucVal);
-unsigned char NRF24L01_GetStatus();
-
-void NRF24L01_EnableFeatureDynPL(unsigned char pipe);
-void NRF24L01_EnableFeatureAckPL();
-void NRF24L01_EnableFeatureNoAckTx();
-char NRF24L01_GetInterruptState();
-void NRF24L01_ClearInterruptFlag(char interrupt_bm);
+void NRF24L01_InterruptInit(tNRF24L01 *psRadio, unsigned long ulIRQBase, unsigned long ulIRQPin, unsigned long ulIRQPeriph, unsigned long ulInterrupt);
+#ifdef NRF24L01_CONF_STATIC_WIRING
+void NRF24L01_InterruptInitStatic(tNRF24L01 *psRadio);
+#endif
+#endif
+
+void NRF24L01_PowerDown(tNRF24L01 *psRadio);
+void NRF24L01_PowerUp(tNRF24L01 *psRadio);
+void NRF24L01_SetPowerPolicy(tNRF24L01 *psRadio, unsigned char ucPolicy, unsigned long ulIdleTimeoutMs);
+void NRF24L01_Tick(tNRF24L01 *psRadio, unsigned long ulElapsedMs);
+unsigned long NRF24L01_EstimateTxTime(tNRF24L01 *psRadio, unsigned char ucPolicy, unsigned int uiLength);
+void NRF24L01_SetAirDataRate(tNRF24L01 *psRadio, unsigned char ucDataRate);
+void NRF24L01_SetLNAGain(tNRF24L01 *psRadio, unsigned char ucLNAGain);
+void NRF24L01_SetPAGain(tNRF24L01 *psRadio, int iPAGain);
+void NRF24L01_SetRFChannel(tNRF24L01 *psRadio, unsigned char ucRFChannel);
+void NRF24L01_SetARC(tNRF24L01 *psRadio, unsigned char ucVal);
+void NRF24L01_SetARD(tNRF24L01 *psRadio, unsigned short ucVal);
+void NRF24L01_SetAddressWidth(tNRF24L01 *psRadio, unsigned char ucVal);
+unsigned char NRF24L01_GetStatus(tNRF24L01 *psRadio);
+unsigned char NRF24L01_GetLastStatus(tNRF24L01 *psRadio, unsigned long *pulSequence);
+
+void NRF24L01_EnableFeatureDynPL(tNRF24L01 *psRadio, unsigned char pipe);
+void NRF24L01_EnableFeatureAckPL(tNRF24L01 *psRadio);
+void NRF24L01_EnableFeatureNoAckTx(tNRF24L01 *psRadio);
+char NRF24L01_GetInterruptState(tNRF24L01 *psRadio);
+char NRF24L01_ClearInterruptFlag(tNRF24L01 *psRadio, char interrupt_bm);
 
 /* TX mode related */
-void NRF24L01_FlushTX();
-void NRF24L01_SetTXAddress(unsigned char* address);
-int NRF24L01_SetTxPayload(char* pcData, unsigned int uiLength);
-int NRF24L01_SubmitData(char *pcData, unsigned int uiLength);
-void NRF24L01_EnableTxMode();
-void NRF24L01_DisableTxMode();
-int NRF24L01_IsTxFifoFull();
-int NRF24L01_IsTxFifoEmpty();
-int NRF24L01_AttemptTx();
-int NRF24L01_WaitForTxComplete(char busy_wait);
-char NRF24L01_GetAckDataAmount();
+void NRF24L01_FlushTX(tNRF24L01 *psRadio);
+void NRF24L01_SetTXAddress(tNRF24L01 *psRadio, unsigned char* address);
+int NRF24L01_SetTxPayload(tNRF24L01 *psRadio, char* pcData, unsigned int uiLength);
+int NRF24L01_SetTxPayloadNoAck(tNRF24L01 *psRadio, char* pcData, unsigned int uiLength);
+int NRF24L01_SubmitData(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength);
+void NRF24L01_EnableTxMode(tNRF24L01 *psRadio);
+void NRF24L01_DisableTxMode(tNRF24L01 *psRadio);
+int NRF24L01_IsTxFifoFull(tNRF24L01 *psRadio);
+int NRF24L01_IsTxFifoEmpty(tNRF24L01 *psRadio);
+int NRF24L01_AttemptTx(tNRF24L01 *psRadio);
+int NRF24L01_WaitForTxComplete(tNRF24L01 *psRadio, char busy_wait);
+char NRF24L01_GetAckDataAmount(tNRF24L01 *psRadio);
+
+/* PS: Asynchronous TX */
+int NRF24L01_SendDataAsync(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength, tNRF24L01TxHandle *psHandle, tNRF24L01Callback pfnCallback);
+int NRF24L01_SendDataAsyncNoAck(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength, tNRF24L01TxHandle *psHandle, tNRF24L01Callback pfnCallback);
+char NRF24L01_TxAsyncService(tNRF24L01 *psRadio);
+int NRF24L01_TxPoll(tNRF24L01 *psRadio, tNRF24L01TxHandle *psHandle);
+
+/* PS: Beacon (REUSE_TX_PL) */
+int NRF24L01_BeaconStart(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength, unsigned char ucNoAck, unsigned long ulCount, unsigned long ulPeriodMs);
+char NRF24L01_BeaconService(tNRF24L01 *psRadio);
+int NRF24L01_IsBeaconActive(tNRF24L01 *psRadio);
+void NRF24L01_BeaconStop(tNRF24L01 *psRadio);
+void NRF24L01_GetBeaconStats(tNRF24L01 *psRadio, tNRF24L01BeaconStats *psStats);
+
+#ifdef NRF24L01_CONF_TX_QUEUE
+/* PS: Software TX queue */
+int NRF24L01_QueueData(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength);
+int NRF24L01_QueueDataNoAck(tNRF24L01 *psRadio, char *pcData, unsigned int uiLength);
+char NRF24L01_TxQueueService(tNRF24L01 *psRadio);
+void NRF24L01_FlushTxQueue(tNRF24L01 *psRadio);
+int NRF24L01_IsTxQueueActive(tNRF24L01 *psRadio);
+void NRF24L01_GetTxQueueStats(tNRF24L01 *psRadio, tNRF24L01TxQueueStats *psStats);
+void NRF24L01_ResetTxQueueStats(tNRF24L01 *psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_TX_STREAM
+/* PS: Streaming TX */
+int NRF24L01_StreamStart(tNRF24L01 *psRadio, char *pcBuffer, unsigned int uiSlots, unsigned char ucPayloadLength, unsigned char ucNoAck);
+int NRF24L01_StreamWrite(tNRF24L01 *psRadio, char *pcData);
+char NRF24L01_StreamService(tNRF24L01 *psRadio);
+int NRF24L01_IsStreamIdle(tNRF24L01 *psRadio);
+void NRF24L01_StreamStop(tNRF24L01 *psRadio);
+void NRF24L01_GetStreamStats(tNRF24L01 *psRadio, tNRF24L01StreamStats *psStats);
+void NRF24L01_ResetStreamStats(tNRF24L01 *psRadio);
+#endif
 
 /* RX mode related */
-void NRF24L01_FlushRX();
-void NRF24L01_SetRxAddress(unsigned char ucDataPipe, unsigned char *pucAddress);
-void NRF24L01_SetRXPacketSize(unsigned char ucDataPipe, unsigned char ucPacketSize);
-void NRF24L01_EnableRxMode();
-void NRF24L01_DisableRxMode();
-int NRF24L01_IsDataReadyRx(char *pcPipeNo);
-void NRF24L01_ReadRxPayload(char* pcData, char cLength);
-int NRF24L01_SetAckPayload(char* pcData, char pipe, unsigned int uiLength);
-unsigned char NRF24L01_CarrierDetect();
+void NRF24L01_FlushRX(tNRF24L01 *psRadio);
+void NRF24L01_SetRxAddress(tNRF24L01 *psRadio, unsigned char ucDataPipe, unsigned char *pucAddress);
+void NRF24L01_SetRXPacketSize(tNRF24L01 *psRadio, unsigned char ucDataPipe, unsigned char ucPacketSize);
+void NRF24L01_EnableRxMode(tNRF24L01 *psRadio);
+void NRF24L01_DisableRxMode(tNRF24L01 *psRadio);
+int NRF24L01_IsDataReadyRx(tNRF24L01 *psRadio, char *pcPipeNo);
+void NRF24L01_ReadRxPayload(tNRF24L01 *psRadio, char* pcData, char cLength);
+int NRF24L01_SetAckPayload(tNRF24L01 *psRadio, char* pcData, char pipe, unsigned int uiLength);
+unsigned char NRF24L01_CarrierDetect(tNRF24L01 *psRadio);
+
+#ifdef NRF24L01_CONF_RX_QUEUE
+/* PS: RX ring */
+char NRF24L01_RxQueueService(tNRF24L01 *psRadio);
+int NRF24L01_RxQueueGet(tNRF24L01 *psRadio, char *pcData, unsigned int uiSize, char *pcPipeNo);
+int NRF24L01_RxQueueCount(tNRF24L01 *psRadio);
+void NRF24L01_FlushRxQueue(tNRF24L01 *psRadio);
+void NRF24L01_GetRxQueueStats(tNRF24L01 *psRadio, tNRF24L01RxQueueStats *psStats);
+void NRF24L01_ResetRxQueueStats(tNRF24L01 *psRadio);
+#endif
 
 /* PS: Advanced APIs, Register level access */
-unsigned char NRF24L01_RegisterRead_8(unsigned char ucRegister);
-unsigned char NRF24L01_RegisterRead_Multi(unsigned char ucRegister, unsigned char *pucBuffer, unsigned int uiLength);
-void NRF24L01_RegisterWrite_8(unsigned char ucRegister, unsigned char ucValue);
-void NRF24L01_RegisterWrite_Multi(unsigned char ucRegister, unsigned char *pucData, unsigned int uiLength);
-void NRF24L01_SendCommand(unsigned char ucCommand, char *pcData, unsigned int uiLength);
-void NRF24L01_SendRcvCommand(unsigned char ucCommand, char *pcData, unsigned int uiLength);
+unsigned char NRF24L01_RegisterRead_8(tNRF24L01 *psRadio, unsigned char ucRegister);
+unsigned char NRF24L01_RegisterRead_Multi(tNRF24L01 *psRadio, unsigned char ucRegister, unsigned char *pucBuffer, unsigned int uiLength);
+void NRF24L01_RegisterWrite_8(tNRF24L01 *psRadio, unsigned char ucRegister, unsigned char ucValue);
+void NRF24L01_RegisterWrite_Multi(tNRF24L01 *psRadio, unsigned char ucRegister, unsigned char *pucData, unsigned int uiLength);
+void NRF24L01_SendCommand(tNRF24L01 *psRadio, unsigned char ucCommand, char *pcData, unsigned int uiLength);
+void NRF24L01_SendRcvCommand(tNRF24L01 *psRadio, unsigned char ucCommand, char *pcData, unsigned int uiLength);
+
+/* PS: Register shadow */
+int NRF24L01_VerifyShadow(tNRF24L01 *psRadio);
+void NRF24L01_RestoreShadow(tNRF24L01 *psRadio);
+void NRF24L01_ReloadShadow(tNRF24L01 *psRadio);
+
+/* PS: Bulk configuration */
+void NRF24L01_GetDefaultConfig(tNRF24L01Config *psConfig);
+void NRF24L01_GetConfig(tNRF24L01 *psRadio, tNRF24L01Config *psConfig);
+int NRF24L01_ApplyConfig(tNRF24L01 *psRadio, const tNRF24L01Config *psConfig);
+
+#ifdef NRF24L01_CONF_TRANSACTION_STATS
+/* PS: SPI transaction counters */
+unsigned long NRF24L01_GetTransactionCount(tNRF24L01 *psRadio, unsigned char ucPath);
+void NRF24L01_ResetTransactionCount(tNRF24L01 *psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_TRACE
+/* PS: Trace ring */
+void NRF24L01_TraceReset(tNRF24L01 *psRadio);
+void NRF24L01_TraceMark(tNRF24L01 *psRadio, unsigned char ucMark);
+unsigned int NRF24L01_TraceRead(tNRF24L01 *psRadio, tNRF24L01TraceEntry *psEntries, unsigned int uiCount);
+unsigned long NRF24L01_TraceGetLost(tNRF24L01 *psRadio);
+unsigned int NRF24L01_TraceDrain(tNRF24L01 *psRadio, void (*pfnWrite)(void *pvArg, const unsigned char *pucData, unsigned int uiLength), void *pvArg, unsigned int uiMaxEntries);
+unsigned long NRF24L01_GetTraceTickRate(tNRF24L01 *psRadio);
+#endif
+
+#ifdef NRF24L01_CONF_PROFILE
+/* PS: Function profile */
+int NRF24L01_GetProfile(tNRF24L01 *psRadio, unsigned char ucFunction, tNRF24L01Profile *psProfile);
+void NRF24L01_ResetProfile(tNRF24L01 *psRadio);
+unsigned long NRF24L01_GetProfileTickRate(void);
+const char *NRF24L01_GetProfileName(unsigned char ucFunction);
+void NRF24L01_DumpProfile(tNRF24L01 *psRadio, void (*pfnPrint)(void *pvArg, const char *pcLine), void *pvArg);
+#endif
+
+#ifdef NRF24L01_CONF_ADDRESS_BOOK
+/* PS: Address book */
+int NRF24L01_AddressBookAdd(tNRF24L01 *psRadio, const unsigned char *pucAddress);
+void NRF24L01_AddressBookClear(tNRF24L01 *psRadio);
+int NRF24L01_SelectNode(tNRF24L01 *psRadio, unsigned char ucNode);
+int NRF24L01_SendDataToNode(tNRF24L01 *psRadio, unsigned char ucNode, char *pcData, unsigned int uiLength);
+#endif
+
+#ifdef NRF24L01_CONF_SPI_ENGINE
+/* PS: Interrupt driven SPI engine */
+int NRF24L01_SPIEngineSubmit(tNRF24L01 *psRadio, tNRF24L01SPIOp *psOp);
+void NRF24L01_SPIEngineService(tNRF24L01 *psRadio);
+int NRF24L01_IsSPIEngineIdle(tNRF24L01 *psRadio);
+void NRF24L01_GetSPIEngineStats(tNRF24L01 *psRadio, tNRF24L01SPIEngineStats *psStats);
+void NRF24L01_ResetSPIEngineStats(tNRF24L01 *psRadio);
+int NRF24L01_IRQChainStart(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain);
+#endif
+
+#ifdef PDLIB_SPI_CONF_UDMA
+/* PS: uDMA payload transfers */
+void NRF24L01_DMAInit(tNRF24L01 *psRadio, void *pvControlTable);
+int NRF24L01_SetTxPayloadDMA(tNRF24L01 *psRadio, char* pcData, unsigned int uiLength, tNRF24L01Callback pfnCallback);
+int NRF24L01_SetAckPayloadDMA(tNRF24L01 *psRadio, char* pcData, char pipe, unsigned int uiLength, tNRF24L01Callback pfnCallback);
+int NRF24L01_ReadRxPayloadDMA(tNRF24L01 *psRadio, char* pcData, char cLength, tNRF24L01Callback pfnCallback);
+int NRF24L01_IsTransferBusy(tNRF24L01 *psRadio);
+#endif
 
 #endif
 
@@ -0,0 +1,211 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * NRF24L01_CONF_HAL backend for the LM4F120H5QR. SPI goes through
+ * pdlib_spi, CE/CSN/IRQ are GPIO pins. Behaves the same as the built-in
+ * code of the driver, it is for applications which want every radio
+ * behind the backend interface (eg. a board with a simulated radio in
+ * its test build).
+ *
+ * Git repo:
+ *
+ * https://github.com/pradeepa-s/pdlib_nrf24l01.git
+ *
+ */
+
+#include <stdio.h>
+#include "pdlib_nrf24l01_hal_stellaris.h"
+#include "pdlib_spi.h"
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/rom.h"
+#include "driverlib/gpio.h"
+
+static unsigned char _NRF24L01_StellarisTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+												 unsigned char *pucRxData, unsigned int uiLength);
+static void _NRF24L01_StellarisSetCE(void *pvContext, unsigned char ucLevel);
+static void _NRF24L01_StellarisSetCSN(void *pvContext, unsigned char ucLevel);
+static int _NRF24L01_StellarisWaitIRQ(void *pvContext, unsigned long ulTimeoutUs);
+static int _NRF24L01_StellarisGetIRQ(void *pvContext);
+
+/* PS: There is no free running microsecond clock without taking a timer from the application */
+const tNRF24L01HAL g_sNRF24L01StellarisHAL =
+{
+	_NRF24L01_StellarisTransfer,
+	_NRF24L01_StellarisSetCE,
+	_NRF24L01_StellarisSetCSN,
+	_NRF24L01_StellarisWaitIRQ,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	_NRF24L01_StellarisGetIRQ
+};
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_StellarisHALInit
+ *
+ * Arguments	: 	psContext	:	Context to fill, pass it to NRF24L01_InitHAL
+ * 					ulCEBase, ulCEPin, ulCEPeriph		:	CE pin
+ * 					ulCSNBase, ulCSNPin, ulCSNPeriph	:	CSN pin
+ * 					ulIRQBase, ulIRQPin, ulIRQPeriph	:	IRQ pin, ulIRQBase 0 if not connected
+ * 					ucSSIIndex	:	The index of the SSI module
+ * 					ulSPIBitRate:	SPI bit rate in Hz (see pdlibSPI_SetBitRate)
+ *
+ * Return		: 	Actual SPI bit rate in Hz
+ *
+ * Description	: 	Configures the SSI module and the pins. CE is left low and CSN
+ * 					high. The IRQ pin is only read, use NRF24L01_InterruptInit or
+ * 					the GPIO driver to raise an interrupt from it.
+ *
+ */
+
+unsigned long
+NRF24L01_StellarisHALInit(	tNRF24L01StellarisHAL *psContext,
+							unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph,
+							unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph,
+							unsigned long ulIRQBase, unsigned long ulIRQPin, unsigned long ulIRQPeriph,
+							unsigned char ucSSIIndex, unsigned long ulSPIBitRate)
+{
+	psContext->ulCEBase = ulCEBase;
+	psContext->ulCEPin = ulCEPin;
+	psContext->ulCSNBase = ulCSNBase;
+	psContext->ulCSNPin = ulCSNPin;
+	psContext->ulIRQBase = ulIRQBase;
+	psContext->ulIRQPin = ulIRQPin;
+	psContext->ucSSI = ucSSIIndex;
+
+	psContext->ulSPIBitRate = pdlibSPI_ConfigureSPIInterface(ucSSIIndex, ulSPIBitRate);
+
+	ROM_SysCtlPeripheralEnable(ulCEPeriph);
+	ROM_GPIOPinTypeGPIOOutput(ulCEBase, ulCEPin);
+	ROM_GPIOPinWrite(ulCEBase, ulCEPin, 0x00);
+
+	ROM_SysCtlPeripheralEnable(ulCSNPeriph);
+	ROM_GPIOPinTypeGPIOOutput(ulCSNBase, ulCSNPin);
+	ROM_GPIOPinWrite(ulCSNBase, ulCSNPin, 0xFF);
+
+	if(ulIRQBase)
+	{
+		ROM_SysCtlPeripheralEnable(ulIRQPeriph);
+		ROM_GPIOPinTypeGPIOInput(ulIRQBase, ulIRQPin);
+	}
+
+	return psContext->ulSPIBitRate;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_StellarisTransfer
+ *
+ * Arguments	: 	See pfnTransfer in pdlib_nrf24l01_hal.h
+ *
+ * Return		: 	Status register value
+ *
+ * Description	: 	CSN low, command byte, burst of the data bytes, CSN high.
+ *
+ */
+
+static unsigned char
+_NRF24L01_StellarisTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+							unsigned char *pucRxData, unsigned int uiLength)
+{
+	tNRF24L01StellarisHAL *psContext = (tNRF24L01StellarisHAL *)pvContext;
+	unsigned char ucStatus;
+
+	ROM_GPIOPinWrite(psContext->ulCSNBase, psContext->ulCSNPin, 0x00);
+
+	ucStatus = pdlibSPI_TransferByte(psContext->ucSSI, ucCommand);
+
+	if(uiLength > 0)
+	{
+		pdlibSPI_TransferData(psContext->ucSSI, pucTxData, pucRxData, uiLength);
+	}
+
+	ROM_GPIOPinWrite(psContext->ulCSNBase, psContext->ulCSNPin, 0xFF);
+
+	return ucStatus;
+}
+
+
+static void
+_NRF24L01_StellarisSetCE(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01StellarisHAL *psContext = (tNRF24L01StellarisHAL *)pvContext;
+
+	ROM_GPIOPinWrite(psContext->ulCEBase, psContext->ulCEPin, ucLevel ? 0xFF : 0x00);
+}
+
+
+static void
+_NRF24L01_StellarisSetCSN(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01StellarisHAL *psContext = (tNRF24L01StellarisHAL *)pvContext;
+
+	ROM_GPIOPinWrite(psContext->ulCSNBase, psContext->ulCSNPin, ucLevel ? 0xFF : 0x00);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_StellarisWaitIRQ
+ *
+ * Arguments	: 	See pfnWaitIRQ in pdlib_nrf24l01_hal.h
+ *
+ * Return		: 	1 if IRQ is low (or not connected), 0 on timeout
+ *
+ * Description	: 	Polls the IRQ pin. The timeout is counted with SysCtlDelay,
+ * 					so it is approximate.
+ *
+ */
+
+static int
+_NRF24L01_StellarisWaitIRQ(void *pvContext, unsigned long ulTimeoutUs)
+{
+	tNRF24L01StellarisHAL *psContext = (tNRF24L01StellarisHAL *)pvContext;
+	int bForever = (PDLIB_NRF24_HAL_WAIT_FOREVER == ulTimeoutUs);
+	unsigned long ulDelayPerUs;
+
+	if(0 == psContext->ulIRQBase)
+	{
+		return 1;
+	}
+
+	/* PS: SysCtlDelay takes 3 cycles per loop */
+	ulDelayPerUs = SysCtlClockGet() / 3000000;
+
+	while(ROM_GPIOPinRead(psContext->ulIRQBase, psContext->ulIRQPin))
+	{
+		if(!bForever)
+		{
+			if(0 == ulTimeoutUs)
+			{
+				return 0;
+			}
+
+			ulTimeoutUs--;
+			ROM_SysCtlDelay(ulDelayPerUs);
+		}
+	}
+
+	return 1;
+}
+
+
+static int
+_NRF24L01_StellarisGetIRQ(void *pvContext)
+{
+	tNRF24L01StellarisHAL *psContext = (tNRF24L01StellarisHAL *)pvContext;
+
+	if(0 == psContext->ulIRQBase)
+	{
+		return 0;
+	}
+
+	return ROM_GPIOPinRead(psContext->ulIRQBase, psContext->ulIRQPin) ? 0 : 1;
+}
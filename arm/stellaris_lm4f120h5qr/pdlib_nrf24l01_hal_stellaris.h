@@ -0,0 +1,27 @@
+#ifndef _PDLIB_NRF24L01_HAL_STELLARIS
+#define _PDLIB_NRF24L01_HAL_STELLARIS
+
+#include "pdlib_nrf24l01_hal.h"
+
+/* PS: Context of a radio connected to the LM4F120H5QR. Filled by NRF24L01_StellarisHALInit */
+typedef struct
+{
+	unsigned long ulCEBase;
+	unsigned long ulCEPin;
+	unsigned long ulCSNBase;
+	unsigned long ulCSNPin;
+	unsigned long ulIRQBase;		// 0 if the IRQ pin is not connected
+	unsigned long ulIRQPin;
+	unsigned char ucSSI;
+	unsigned long ulSPIBitRate;		// Actual SPI bit rate
+}tNRF24L01StellarisHAL;
+
+extern const tNRF24L01HAL g_sNRF24L01StellarisHAL;
+
+unsigned long NRF24L01_StellarisHALInit(tNRF24L01StellarisHAL *psContext,
+										unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph,
+										unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph,
+										unsigned long ulIRQBase, unsigned long ulIRQPin, unsigned long ulIRQPeriph,
+										unsigned char ucSSIIndex, unsigned long ulSPIBitRate);
+
+#endif
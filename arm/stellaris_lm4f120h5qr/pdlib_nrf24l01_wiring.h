@@ -0,0 +1,34 @@
+#ifndef _PDLIB_NRF24L01_WIRING
+#define _PDLIB_NRF24L01_WIRING
+
+/* PS: Wiring of the radio for NRF24L01_CONF_STATIC_WIRING. Copy it next to the project (or
+ * point NRF24L01_CONF_WIRING_HEADER to a copy) and change it to match the board. The values
+ * below are the wiring of the Launchpad examples. */
+
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+
+/* PS: SSI module index as for NRF24L01_Init (SSI3 on PD0-PD3). Define PDLIB_SPI_CONF_SSI the same. */
+#define NRF24L01_CONF_SSI				3
+
+#define NRF24L01_CONF_CE_BASE			GPIO_PORTE_BASE
+#define NRF24L01_CONF_CE_PIN			GPIO_PIN_1
+#define NRF24L01_CONF_CE_PERIPH			SYSCTL_PERIPH_GPIOE
+
+#define NRF24L01_CONF_CSN_BASE			GPIO_PORTE_BASE
+#define NRF24L01_CONF_CSN_PIN			GPIO_PIN_2
+#define NRF24L01_CONF_CSN_PERIPH		SYSCTL_PERIPH_GPIOE
+
+/* PS: Used by NRF24L01_InterruptInitStatic (NRF24L01_CONF_INTERRUPT_PIN) */
+#define NRF24L01_CONF_IRQ_BASE			GPIO_PORTE_BASE
+#define NRF24L01_CONF_IRQ_PIN			GPIO_PIN_3
+#define NRF24L01_CONF_IRQ_PERIPH		SYSCTL_PERIPH_GPIOE
+#define NRF24L01_CONF_IRQ_INT			INT_GPIOE
+
+/* PS: SPI bit rate in Hz, PDLIB_NRF24_SPI_BITRATE_AUTO to calibrate it (see NRF24L01_Init) */
+#define NRF24L01_CONF_SPI_BITRATE		PDLIB_NRF24_SPI_BITRATE_AUTO
+
+#endif
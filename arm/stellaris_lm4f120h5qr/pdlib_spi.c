@@ -23,6 +23,19 @@
  * 				Added function to get one byte(blocking and none blocking)
  * 				Added function to send data(blocking)
  * 
+ * 2026-10-18 : Added FIFO burst transfer (pdlibSPI_TransferData)
+ * 				pdlibSPI_SendData keeps the SSI FIFO full instead of
+ * 				waiting for every byte
+ * 				Added uDMA transfers with a completion callback
+ * 				(PDLIB_SPI_CONF_UDMA)
+ * 				SPI bit rate is a parameter of pdlibSPI_ConfigureSPIInterface
+ * 				and can be changed using pdlibSPI_SetBitRate
+ * 				Every function takes the SSI module index, so that several
+ * 				SSI modules can be used at the same time. uDMA state is
+ * 				kept per SSI module
+ * 				Added non-blocking byte put and the RX interrupt of the
+ * 				SSI module, for transfers moved from the SSI interrupt
+ * 
  */
 
 #include <stdio.h>
@@ -30,9 +43,15 @@
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "inc/hw_ssi.h"
+#include "driverlib/sysctl.h"
 #include "driverlib/gpio.h"
 #include "driverlib/ssi.h"
 #include "driverlib/rom.h"
+#include "inc/hw_ints.h"
+
+#ifdef PDLIB_SPI_CONF_UDMA
+#include "driverlib/udma.h"
+#endif
 
 #define SSIPERIPH   0
 #define SSIBASE     1
@@ -44,12 +63,34 @@
 #define SSITX       4
 #define GPIOBASE    5
 #define GPIOPINS    6
+
+/* PS: Depth of the SSI TX and RX FIFOs */
+#define SSI_FIFO_DEPTH	8
+
+/* PS: SSI clock prescaler (CPSDVSR) limits, must be an even number */
+#define SSI_CPSDVSR_MIN	2
+#define SSI_CPSDVSR_MAX	254
+
+/* PS: SSI serial clock rate (SCR + 1) limit */
+#define SSI_SCR_DIV_MAX	256
  
-/* PS: Variable to track which SSI module is being used */
-static unsigned char g_SSI = 6;
+/* PS: Number of entries in the SSI module tables */
+#define SSI_MODULE_COUNT	5
+
+/* PS: With PDLIB_SPI_CONF_SSI every function works on that module whatever index it is given.
+ * The index is then a constant, the table lookups fold into it and the checks go away. */
+#ifdef PDLIB_SPI_CONF_SSI
+#if (PDLIB_SPI_CONF_SSI >= SSI_MODULE_COUNT)
+#error "PDLIB_SPI_CONF_SSI must be 0 to 4"
+#endif
+
+#define SSI_SELECT(ucSSI)	((ucSSI) = PDLIB_SPI_CONF_SSI)
+#else
+#define SSI_SELECT(ucSSI)
+#endif
 
 /* PS: SSI Base and SSI Peripheral defines mapping */
-static const unsigned long g_SSIModule[5][2] =
+static const unsigned long g_SSIModule[SSI_MODULE_COUNT][2] =
 {
 	 {SYSCTL_PERIPH_SSI0, SSI0_BASE},
 	 {SYSCTL_PERIPH_SSI1, SSI1_BASE},
@@ -59,7 +100,7 @@ static const unsigned long g_SSIModule[5][2] =
 };
 
 /* PS: GPIO configurations for SSI modules*/
-static const unsigned long g_GPIOConfigure[5][7] =
+static const unsigned long g_GPIOConfigure[SSI_MODULE_COUNT][7] =
 {
 	 {SYSCTL_PERIPH_GPIOA, GPIO_PA2_SSI0CLK, GPIO_PA3_SSI0FSS, GPIO_PA4_SSI0RX, GPIO_PA5_SSI0TX, GPIO_PORTA_BASE, GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 | GPIO_PIN_2},
 	 {SYSCTL_PERIPH_GPIOF, GPIO_PF2_SSI1CLK, GPIO_PF3_SSI1FSS, GPIO_PF0_SSI1RX, GPIO_PF1_SSI1TX, GPIO_PORTF_BASE, GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_0 | GPIO_PIN_1},
@@ -68,31 +109,68 @@ static const unsigned long g_GPIOConfigure[5][7] =
 	 {SYSCTL_PERIPH_GPIOD, GPIO_PD0_SSI1CLK, GPIO_PD1_SSI1FSS, GPIO_PD2_SSI1RX, GPIO_PD3_SSI1TX, GPIO_PORTD_BASE, GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3}
 };
 
+/* PS: Interrupt of every SSI module */
+static const unsigned long g_SSIInterrupt[SSI_MODULE_COUNT] =
+{
+	 INT_SSI0, INT_SSI1, INT_SSI2, INT_SSI3, INT_SSI1
+};
+
 /* PS: RX data */
 char g_plRxData[256];
 
+#ifdef PDLIB_SPI_CONF_UDMA
+
+#define DMARXCHANNEL	0
+#define DMATXCHANNEL	1
+#define DMAINTERRUPT	2
+
+/* PS: uDMA channels and interrupt for SSI modules */
+static const unsigned long g_SSIDMAConfigure[SSI_MODULE_COUNT][3] =
+{
+	 {UDMA_CH10_SSI0RX, UDMA_CH11_SSI0TX, INT_SSI0},
+	 {UDMA_CH24_SSI1RX, UDMA_CH25_SSI1TX, INT_SSI1},
+	 {UDMA_CH12_SSI2RX, UDMA_CH13_SSI2TX, INT_SSI2},
+	 {UDMA_CH14_SSI3RX, UDMA_CH15_SSI3TX, INT_SSI3},
+	 {UDMA_CH24_SSI1RX, UDMA_CH25_SSI1TX, INT_SSI1}
+};
+
+/* PS: Source of TX data for read only transfers, sink of RX data for write only transfers */
+static unsigned char g_ucDMATxFill = PDLIB_SPI_FILL_BYTE;
+static unsigned char g_ucDMARxSink;
+
+/* PS: State of the running uDMA transfer of every SSI module */
+static volatile unsigned char g_ucDMABusy[SSI_MODULE_COUNT];
+static tpdlibSPICallback g_pfnDMACallback[SSI_MODULE_COUNT];
+static void *g_pvDMACallbackArg[SSI_MODULE_COUNT];
+
+#endif
+
 #ifdef PART_LM4F120H5QR
 
 /* PS:
  * 
  * Function		: 	pdlibSPI_ConfigureSPIInterface
  * 
- * Arguments	: 	ucSSI - SSI module index (0,1,2,3,4,5) [5 is for SSI1 with GPIO PORTD]
+ * Arguments	: 	ucSSI 		- SSI module index (0,1,2,3,4) [4 is for SSI1 with GPIO PORTD]
+ * 					ulBitRate	- Required SPI bit rate in Hz
  * 
- * Return		: 	None
+ * Return		: 	Actual SPI bit rate in Hz (see pdlibSPI_SetBitRate). ZERO if the
+ * 					SSI index is invalid.
  * 
  * Description	: 	The function will setup the SSI module to make it same as Freescale SPI module.
  * 					GPIO configurations required and Clock configurations also done in the function.
  * 
  */
 
-void
-pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI)
+unsigned long
+pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI, unsigned long ulBitRate)
 {
-	g_SSI = ucSSI;
+	unsigned long ulActualBitRate = 0;
+
+	SSI_SELECT(ucSSI);
 
 #ifdef PART_LM4F120H5QR
-	if(g_SSI < 6)
+	if(ucSSI < SSI_MODULE_COUNT)
 	{
 		 /* Enable clock for SSI */
 		ROM_SysCtlPeripheralEnable(g_SSIModule[ucSSI][SSIPERIPH]);
@@ -111,11 +189,12 @@ pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI)
 		
 		ROM_GPIOPinTypeSSI(g_GPIOConfigure[ucSSI][GPIOBASE], g_GPIOConfigure[ucSSI][GPIOPINS]);
 		
-		/* Configure SSI */
+		/* Configure SSI, the clock is refined by pdlibSPI_SetBitRate */
 		ROM_SSIClockSourceSet(g_SSIModule[ucSSI][SSIBASE], SSI_CLOCK_SYSTEM);
 		ROM_SSIConfigSetExpClk(g_SSIModule[ucSSI][SSIBASE], SysCtlClockGet(), SSI_FRF_MOTO_MODE_0,
-								SSI_MODE_MASTER, 500000, 8);
-		ROM_SSIEnable(g_SSIModule[ucSSI][SSIBASE]);
+								SSI_MODE_MASTER, PDLIB_SPI_DEFAULT_BITRATE, 8);
+
+		ulActualBitRate = pdlibSPI_SetBitRate(ucSSI, ulBitRate);
 		
 		/* Clear initial data */
 		while(ROM_SSIDataGetNonBlocking(g_SSIModule[ucSSI][SSIBASE], (unsigned long*)&g_plRxData[0]));
@@ -128,6 +207,86 @@ pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI)
 */
 	}
 #endif
+
+	return ulActualBitRate;
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_SetBitRate
+ *
+ * Arguments	: 	ucSSI		- SSI module index (see pdlibSPI_ConfigureSPIInterface)
+ * 					ulBitRate	- Required SPI bit rate in Hz
+ *
+ * Return		: 	Actual SPI bit rate in Hz. ZERO if the SSI index is invalid.
+ *
+ * Description	: 	The SSI bit rate is SysClk / (CPSDVSR * (1 + SCR)) where CPSDVSR is an
+ * 					even number from 2 to 254 and SCR is from 0 to 255. The function selects
+ * 					the fastest rate which is NOT above ulBitRate. (SSIConfigSetExpClk may
+ * 					round the rate up.) The rate is limited to SysClk / 2, which is the
+ * 					maximum for an SSI master, and to SysClk / (254 * 256) at the low end.
+ *
+ * 					The SSI module is disabled while the prescaler is changed, therefore
+ * 					this must not be called during a transfer.
+ *
+ */
+
+unsigned long
+pdlibSPI_SetBitRate(unsigned char ucSSI, unsigned long ulBitRate)
+{
+	unsigned long ulActualBitRate = 0;
+	unsigned long ulSysClk;
+	unsigned long ulDivider;
+	unsigned long ulPreDiv;
+	unsigned long ulSCRDiv;
+	unsigned long ulBase;
+
+	SSI_SELECT(ucSSI);
+
+	if(ucSSI < SSI_MODULE_COUNT)
+	{
+#ifdef PART_LM4F120H5QR
+		ulBase = g_SSIModule[ucSSI][SSIBASE];
+		ulSysClk = SysCtlClockGet();
+
+		if((ulBitRate == 0) || (ulBitRate > (ulSysClk / SSI_CPSDVSR_MIN)))
+		{
+			ulBitRate = ulSysClk / SSI_CPSDVSR_MIN;
+		}
+
+		/* PS: Smallest total divider which does not exceed the required rate */
+		ulDivider = (ulSysClk + ulBitRate - 1) / ulBitRate;
+
+		for(ulPreDiv = SSI_CPSDVSR_MIN; ulPreDiv <= SSI_CPSDVSR_MAX; ulPreDiv += 2)
+		{
+			ulSCRDiv = (ulDivider + ulPreDiv - 1) / ulPreDiv;
+
+			if(ulSCRDiv <= SSI_SCR_DIV_MAX)
+			{
+				break;
+			}
+		}
+
+		if(ulPreDiv > SSI_CPSDVSR_MAX)
+		{
+			ulPreDiv = SSI_CPSDVSR_MAX;
+			ulSCRDiv = SSI_SCR_DIV_MAX;
+		}
+
+		ROM_SSIDisable(ulBase);
+
+		HWREG(ulBase + SSI_O_CPSR) = ulPreDiv;
+		HWREG(ulBase + SSI_O_CR0) = ((HWREG(ulBase + SSI_O_CR0) & ~SSI_CR0_SCR_M) |
+									 ((ulSCRDiv - 1) << SSI_CR0_SCR_S));
+
+		ROM_SSIEnable(ulBase);
+
+		ulActualBitRate = ulSysClk / (ulPreDiv * ulSCRDiv);
+#endif
+	}
+
+	return ulActualBitRate;
 }
 
 
@@ -135,35 +294,108 @@ pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI)
  * 
  * Function		: 	pdlibSPI_SendData
  * 
- * Arguments	: 	pucData 		- Char array of data to be sent. 
+ * Arguments	: 	ucSSI			- SSI module index
+ * 					pucData 		- Char array of data to be sent. 
  * 					uiLength		- Length of the data array
  * 
  * Return		: 	If success the function will return the number of data
  * 					bytes it has written to the SPI module. 
  * 					If failed the function will return ZERO.
  * 
- * Description	: 	The function will submit data byte by byte to the SPI module
- * 					for transmission and will wait until the total transmission
- * 					is over. The function is a blocking function.
+ * Description	: 	The function will submit the data to the SPI module as a
+ * 					burst (see pdlibSPI_TransferData) and will wait until the
+ * 					total transmission is over. Received bytes are discarded.
+ * 					The function is a blocking function.
  * 
  */
 
 int
-pdlibSPI_SendData(unsigned char *pucData, unsigned int uiLength)
+pdlibSPI_SendData(unsigned char ucSSI, unsigned char *pucData, unsigned int uiLength)
 {
 	int iIndex = 0;
+
+	SSI_SELECT(ucSSI);
+
 	/* Validate parameters */
-	if((pucData != NULL) && (uiLength > 0) && (g_SSI < 5))
+	if((pucData != NULL) && (uiLength > 0) && (ucSSI < SSI_MODULE_COUNT))
+	{
+		iIndex = pdlibSPI_TransferData(ucSSI, pucData, NULL, uiLength);
+	}
+	
+	return iIndex;
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_TransferData
+ *
+ * Arguments	: 	ucSSI		- SSI module index
+ * 					pucTxData	- Data to be sent. If NULL, PDLIB_SPI_FILL_BYTE is sent
+ * 								  for every byte (ie. read only transfer)
+ * 					pucRxData	- Buffer to store the received data. If NULL, the
+ * 								  received data is discarded (ie. write only transfer)
+ * 					uiLength	- Number of bytes to transfer
+ *
+ * Return		: 	Number of bytes transferred.
+ *
+ * Description	: 	Full duplex burst transfer. The TX FIFO is kept filled while
+ * 					the RX FIFO is drained as words arrive, so the bytes are
+ * 					clocked out back-to-back without an idle gap between them.
+ *
+ * 					At most SSI_FIFO_DEPTH words are kept in flight, therefore the
+ * 					RX FIFO can never overflow. The function returns only after
+ * 					the last byte is received, which means the whole frame has
+ * 					been clocked out.
+ *
+ */
+
+unsigned int
+pdlibSPI_TransferData(unsigned char ucSSI, unsigned char *pucTxData, unsigned char *pucRxData, unsigned int uiLength)
+{
+	unsigned int uiTxIndex = 0;
+	unsigned int uiRxIndex = 0;
+	unsigned long ulBase;
+	unsigned long ulData;
+
+	SSI_SELECT(ucSSI);
+
+	/* Validate parameters */
+	if((uiLength > 0) && (ucSSI < SSI_MODULE_COUNT))
 	{
 #ifdef PART_LM4F120H5QR
-			while(iIndex < uiLength)
+		ulBase = g_SSIModule[ucSSI][SSIBASE];
+
+		while(uiRxIndex < uiLength)
+		{
+			/* PS: Top up the TX FIFO */
+			while((uiTxIndex < uiLength) && ((uiTxIndex - uiRxIndex) < SSI_FIFO_DEPTH))
 			{
-				pdlibSPI_TransferByte(pucData[iIndex++]);
+				ulData = (pucTxData != NULL) ? pucTxData[uiTxIndex] : PDLIB_SPI_FILL_BYTE;
+
+				if(0 == ROM_SSIDataPutNonBlocking(ulBase, ulData))
+				{
+					break;
+				}
+
+				uiTxIndex++;
 			}
+
+			/* PS: Drain the RX FIFO */
+			while((uiRxIndex < uiTxIndex) && ROM_SSIDataGetNonBlocking(ulBase, &ulData))
+			{
+				if(pucRxData != NULL)
+				{
+					pucRxData[uiRxIndex] = (unsigned char)(ulData & 0xFF);
+				}
+
+				uiRxIndex++;
+			}
+		}
 #endif
 	}
-	
-	return iIndex;
+
+	return uiRxIndex;
 }
 
 
@@ -171,35 +403,35 @@ pdlibSPI_SendData(unsigned char *pucData, unsigned int uiLength)
  * 
  * Function		: 	pdlibSPI_TransferByte
  *
- * Arguments	: 	ucData	:	Data byte to transfer
+ * Arguments	: 	ucSSI	:	SSI module index
+ * 					ucData	:	Data byte to transfer
  *
  * Return		: 	Function will return whatever data received from the module during the transfer.
  *
  * Description	: 	The function will submit a data byte the SPI module
- * 					for transmission and will wait until the total transmission
- * 					is over. Then it will read the TX buffer and read one byte out from the buffer.
- * 					This will clear the TX buffer.
+ * 					for transmission and will wait until the received byte
+ * 					arrives in the RX FIFO, which happens only after the total
+ * 					transmission is over. Then it will read one byte out from
+ * 					the RX FIFO.
  *
  */
 
 unsigned char
-pdlibSPI_TransferByte(unsigned char ucData)
+pdlibSPI_TransferByte(unsigned char ucSSI, unsigned char ucData)
 {
-	unsigned long ulRxData;
+	unsigned long ulRxData = PDLIB_SPI_FILL_BYTE;
+
+	SSI_SELECT(ucSSI);
+
 	/* Validate parameters */
-	if(g_SSI < 5)
+	if(ucSSI < SSI_MODULE_COUNT)
 	{
 #ifdef PART_LM4F120H5QR
 
-			ROM_SSIDataPut(g_SSIModule[g_SSI][SSIBASE], ucData);
+			ROM_SSIDataPut(g_SSIModule[ucSSI][SSIBASE], ucData);
 
-			/* Wait until current transmission is over */
-			while(ROM_SSIBusy(g_SSIModule[g_SSI][SSIBASE]));
-
-			ROM_SSIDataGet(g_SSIModule[g_SSI][SSIBASE], &ulRxData);
-
-			/* Wait until current transmission is over */
-			while(ROM_SSIBusy(g_SSIModule[g_SSI][SSIBASE]));
+			/* Blocks until the byte is clocked in, ie. transmission is over */
+			ROM_SSIDataGet(g_SSIModule[ucSSI][SSIBASE], &ulRxData);
 #endif
 	}
 
@@ -211,7 +443,7 @@ pdlibSPI_TransferByte(unsigned char ucData)
  *
  * Function		: 	pdlibSPI_ReceiveDataBlocking
  * 
- * Arguments	: 	None
+ * Arguments	: 	ucSSI - SSI module index
  * 
  * Return		: 	Returns the byte value read
  * 
@@ -222,11 +454,16 @@ pdlibSPI_TransferByte(unsigned char ucData)
  */
 
 unsigned char
-pdlibSPI_ReceiveDataBlocking()
+pdlibSPI_ReceiveDataBlocking(unsigned char ucSSI)
 {
-	unsigned long ulRxData;
+	unsigned long ulRxData = PDLIB_SPI_FILL_BYTE;
 
-	ROM_SSIDataGet(g_SSIModule[g_SSI][SSIBASE], &ulRxData);
+	SSI_SELECT(ucSSI);
+
+	if(ucSSI < SSI_MODULE_COUNT)
+	{
+		ROM_SSIDataGet(g_SSIModule[ucSSI][SSIBASE], &ulRxData);
+	}
 	
 	return ((unsigned char)(ulRxData & 0xFF));
 }
@@ -235,7 +472,8 @@ pdlibSPI_ReceiveDataBlocking()
  * 
  * Function		: 	pdlibSPI_ReceiveDataNonBlocking
  * 
- * Arguments	: 	pcData - Pre allocated 'char' value to receive data
+ * Arguments	: 	ucSSI  - SSI module index
+ * 					pcData - Pre allocated 'char' value to receive data
  * 
  * Return		: 	unsigned int value, which contains the number of bytes read.
  * 
@@ -248,15 +486,17 @@ pdlibSPI_ReceiveDataBlocking()
 
 
 unsigned int 
-pdlibSPI_ReceiveDataNonBlocking(char *pcData)
+pdlibSPI_ReceiveDataNonBlocking(unsigned char ucSSI, char *pcData)
 {
 	unsigned int iReturn = 0;
 	unsigned long ulRxData;
-	
+
+	SSI_SELECT(ucSSI);
+
 	/* Validate the arguments */
-	if(pcData != NULL)
+	if((pcData != NULL) && (ucSSI < SSI_MODULE_COUNT))
 	{
-		iReturn = ROM_SSIDataGetNonBlocking(g_SSIModule[g_SSI][SSIBASE], &ulRxData);
+		iReturn = ROM_SSIDataGetNonBlocking(g_SSIModule[ucSSI][SSIBASE], &ulRxData);
 	}
 	
 	if(iReturn > 0)
@@ -267,4 +507,303 @@ pdlibSPI_ReceiveDataNonBlocking(char *pcData)
 	return iReturn;
 }
 
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_SendDataNonBlocking
+ *
+ * Arguments	: 	ucSSI  - SSI module index
+ * 					ucData - Byte to send
+ *
+ * Return		: 	1 if the byte was put in the TX FIFO, 0 if the FIFO is full
+ *
+ * Description	: 	The function will not wait for space in the TX FIFO. The byte
+ * 					received for it must be taken from the RX FIFO by the caller.
+ *
+ */
+
+unsigned int
+pdlibSPI_SendDataNonBlocking(unsigned char ucSSI, unsigned char ucData)
+{
+	unsigned int iReturn = 0;
+
+	SSI_SELECT(ucSSI);
+
+	if(ucSSI < SSI_MODULE_COUNT)
+	{
+		iReturn = (ROM_SSIDataPutNonBlocking(g_SSIModule[ucSSI][SSIBASE], ucData) ? 1 : 0);
+	}
+
+	return iReturn;
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_EnableRxInt
+ *
+ * Arguments	: 	ucSSI		- SSI module index
+ * 					ucEnable	- 1 to enable, 0 to mask
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The SSI interrupt is raised when the RX FIFO is half full, or
+ * 					when received bytes have waited for 32 bit times (RX timeout).
+ * 					Enabling also enables the interrupt of the SSI module in the
+ * 					NVIC. The handler has to call pdlibSPI_ClearRxInt.
+ *
+ */
+
+void
+pdlibSPI_EnableRxInt(unsigned char ucSSI, unsigned char ucEnable)
+{
+	SSI_SELECT(ucSSI);
+
+	if(ucSSI < SSI_MODULE_COUNT)
+	{
+		if(ucEnable)
+		{
+			ROM_SSIIntEnable(g_SSIModule[ucSSI][SSIBASE], SSI_RXFF | SSI_RXTO);
+			ROM_IntEnable(g_SSIInterrupt[ucSSI]);
+		}else
+		{
+			ROM_SSIIntDisable(g_SSIModule[ucSSI][SSIBASE], SSI_RXFF | SSI_RXTO);
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_ClearRxInt
+ *
+ * Arguments	: 	ucSSI - SSI module index
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Clears the RX timeout interrupt. The RX FIFO half full interrupt
+ * 					clears itself once the FIFO is drained.
+ *
+ */
+
+void
+pdlibSPI_ClearRxInt(unsigned char ucSSI)
+{
+	SSI_SELECT(ucSSI);
+
+	if(ucSSI < SSI_MODULE_COUNT)
+	{
+		ROM_SSIIntClear(g_SSIModule[ucSSI][SSIBASE], SSI_RXTO);
+	}
+}
+
+#ifdef PDLIB_SPI_CONF_UDMA
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_ConfigureDMA
+ *
+ * Arguments	: 	ucSSI			- SSI module index
+ * 					pvControlTable	- uDMA channel control table (must be 1024 byte aligned).
+ * 									  Pass NULL if the application has already set the
+ * 									  control table using uDMAControlBaseSet().
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The function will enable the uDMA controller and assign the RX and TX
+ * 					channels of the SSI module.
+ * 					It will also enable the SSI interrupt, which is raised when a uDMA
+ * 					transfer completes. pdlibSPI_DMAIntHandler should be registered as
+ * 					the handler of that interrupt.
+ *
+ */
+
+void
+pdlibSPI_ConfigureDMA(unsigned char ucSSI, void *pvControlTable)
+{
+	SSI_SELECT(ucSSI);
+
+	if(ucSSI < SSI_MODULE_COUNT)
+	{
+		ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+		ROM_uDMAEnable();
+
+		if(pvControlTable != NULL)
+		{
+			ROM_uDMAControlBaseSet(pvControlTable);
+		}
+
+		uDMAChannelAssign(g_SSIDMAConfigure[ucSSI][DMARXCHANNEL]);
+		uDMAChannelAssign(g_SSIDMAConfigure[ucSSI][DMATXCHANNEL]);
+
+		ROM_uDMAChannelAttributeDisable(g_SSIDMAConfigure[ucSSI][DMARXCHANNEL], UDMA_ATTR_ALL);
+		ROM_uDMAChannelAttributeDisable(g_SSIDMAConfigure[ucSSI][DMATXCHANNEL], UDMA_ATTR_ALL);
+
+		g_ucDMABusy[ucSSI] = 0;
+
+		ROM_IntEnable(g_SSIDMAConfigure[ucSSI][DMAINTERRUPT]);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_TransferDataDMA
+ *
+ * Arguments	: 	ucSSI		- SSI module index
+ * 					pucTxData	- Data to be sent. If NULL, PDLIB_SPI_FILL_BYTE is sent
+ * 					pucRxData	- Buffer to store the received data. If NULL, the
+ * 								  received data is discarded
+ * 					uiLength	- Number of bytes to transfer (Maximum is 1024)
+ * 					pfnCallback	- Function to call when the transfer is over (can be NULL)
+ * 					pvArg		- Argument passed to pfnCallback
+ *
+ * Return		: 	Number of bytes queued for the transfer. ZERO if the transfer
+ * 					could not be started (uDMA busy or invalid arguments).
+ *
+ * Description	: 	Same as pdlibSPI_TransferData but the bytes are moved by the uDMA
+ * 					controller. The function returns immediately; the CPU is free (or
+ * 					can sleep) while the frame is clocked out. pfnCallback is called
+ * 					from pdlibSPI_DMAIntHandler once the last byte is received.
+ *
+ * 					The buffers must stay valid until pfnCallback is called.
+ * 					Transfers on different SSI modules may run at the same time.
+ *
+ */
+
+unsigned int
+pdlibSPI_TransferDataDMA(unsigned char ucSSI, unsigned char *pucTxData, unsigned char *pucRxData, unsigned int uiLength,
+						 tpdlibSPICallback pfnCallback, void *pvArg)
+{
+	unsigned long ulBase;
+	unsigned long ulRxChannel;
+	unsigned long ulTxChannel;
+	unsigned long ulData;
+
+	SSI_SELECT(ucSSI);
+
+	if((ucSSI >= SSI_MODULE_COUNT) || (uiLength == 0) || (uiLength > 1024) || g_ucDMABusy[ucSSI])
+	{
+		return 0;
+	}
+
+	ulBase = g_SSIModule[ucSSI][SSIBASE];
+	ulRxChannel = g_SSIDMAConfigure[ucSSI][DMARXCHANNEL] & 0xFF;
+	ulTxChannel = g_SSIDMAConfigure[ucSSI][DMATXCHANNEL] & 0xFF;
+
+	/* PS: Make sure there are no stale words in the RX FIFO */
+	while(ROM_SSIDataGetNonBlocking(ulBase, &ulData));
+
+	g_ucDMABusy[ucSSI] = 1;
+	g_pfnDMACallback[ucSSI] = pfnCallback;
+	g_pvDMACallbackArg[ucSSI] = pvArg;
+
+	/* PS: RX channel, SSI data register to the buffer */
+	ROM_uDMAChannelControlSet(ulRxChannel | UDMA_PRI_SELECT,
+							  UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_ARB_4 |
+							  ((pucRxData != NULL) ? UDMA_DST_INC_8 : UDMA_DST_INC_NONE));
+	ROM_uDMAChannelTransferSet(ulRxChannel | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+							   (void *)(ulBase + SSI_O_DR),
+							   (pucRxData != NULL) ? (void *)pucRxData : (void *)&g_ucDMARxSink,
+							   uiLength);
+
+	/* PS: TX channel, buffer to the SSI data register */
+	ROM_uDMAChannelControlSet(ulTxChannel | UDMA_PRI_SELECT,
+							  UDMA_SIZE_8 | UDMA_DST_INC_NONE | UDMA_ARB_4 |
+							  ((pucTxData != NULL) ? UDMA_SRC_INC_8 : UDMA_SRC_INC_NONE));
+	ROM_uDMAChannelTransferSet(ulTxChannel | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+							   (pucTxData != NULL) ? (void *)pucTxData : (void *)&g_ucDMATxFill,
+							   (void *)(ulBase + SSI_O_DR),
+							   uiLength);
+
+	/* PS: RX first, so that no received word is missed */
+	ROM_uDMAChannelEnable(ulRxChannel);
+	ROM_uDMAChannelEnable(ulTxChannel);
+
+	ROM_SSIDMAEnable(ulBase, SSI_DMA_RX | SSI_DMA_TX);
+
+	return uiLength;
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_IsDMABusy
+ *
+ * Arguments	: 	ucSSI - SSI module index
+ *
+ * Return		: 	1 if a uDMA transfer is running, 0 otherwise
+ *
+ * Description	: 	Other transfers must not be started on the SSI module while
+ * 					this returns 1.
+ *
+ */
+
+int
+pdlibSPI_IsDMABusy(unsigned char ucSSI)
+{
+	SSI_SELECT(ucSSI);
+
+	return (((ucSSI < SSI_MODULE_COUNT) && g_ucDMABusy[ucSSI]) ? 1 : 0);
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_DMAIntHandler
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	None
+ *
+ * Description	: 	SSI interrupt handler. Should be registered in the interrupt vector
+ * 					of every SSI module in use. The transfer is complete once the RX
+ * 					channel has stopped, ie. the last byte is clocked in. The TX channel
+ * 					completes earlier and that interrupt is ignored.
+ *
+ * 					Every SSI module with a running transfer is checked, so one handler
+ * 					serves all modules. A transfer which is not over is left untouched.
+ *
+ */
+
+void
+pdlibSPI_DMAIntHandler()
+{
+	tpdlibSPICallback pfnCallback;
+	unsigned long ulRxChannel;
+	unsigned char ucSSI;
+
+#ifdef PDLIB_SPI_CONF_SSI
+	for(ucSSI = PDLIB_SPI_CONF_SSI; ucSSI <= PDLIB_SPI_CONF_SSI; ucSSI++)
+#else
+	for(ucSSI = 0; ucSSI < SSI_MODULE_COUNT; ucSSI++)
+#endif
+	{
+		if(!g_ucDMABusy[ucSSI])
+		{
+			continue;
+		}
+
+		ulRxChannel = g_SSIDMAConfigure[ucSSI][DMARXCHANNEL] & 0xFF;
+
+		if(UDMA_MODE_STOP == ROM_uDMAChannelModeGet(ulRxChannel | UDMA_PRI_SELECT))
+		{
+			ROM_SSIDMADisable(g_SSIModule[ucSSI][SSIBASE], SSI_DMA_RX | SSI_DMA_TX);
+
+			pfnCallback = g_pfnDMACallback[ucSSI];
+			g_pfnDMACallback[ucSSI] = NULL;
+
+			/* PS: Released before the callback, so the callback can chain another transfer */
+			g_ucDMABusy[ucSSI] = 0;
+
+			if(pfnCallback != NULL)
+			{
+				pfnCallback(g_pvDMACallbackArg[ucSSI]);
+			}
+		}
+	}
+}
+
+#endif
+
 #endif
@@ -1,12 +1,37 @@
 #ifndef _PDLIB_SPI
 #define _PDLIB_SPI
 
+/* PS: Byte clocked out when there is no TX data (read only transfers) */
+#define PDLIB_SPI_FILL_BYTE		0xFF
 
+/* PS: Bit rate used while the SSI module is being configured */
+#define PDLIB_SPI_DEFAULT_BITRATE	500000
 
-void pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI);
-unsigned char pdlibSPI_ReceiveDataBlocking();
-unsigned int pdlibSPI_ReceiveDataNonBlocking(char *pcData);
-unsigned char pdlibSPI_TransferByte(unsigned char ucData);
-int pdlibSPI_SendData(unsigned char *pucData, unsigned int uiLength);
+/* Configurations */
+
+//#define PDLIB_SPI_CONF_UDMA
+
+/* PS: Only this SSI module (0 to 4) is used, the index arguments are ignored */
+//#define PDLIB_SPI_CONF_SSI	3
+
+typedef void (*tpdlibSPICallback)(void *pvArg);
+
+unsigned long pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI, unsigned long ulBitRate);
+unsigned long pdlibSPI_SetBitRate(unsigned char ucSSI, unsigned long ulBitRate);
+unsigned char pdlibSPI_ReceiveDataBlocking(unsigned char ucSSI);
+unsigned int pdlibSPI_ReceiveDataNonBlocking(unsigned char ucSSI, char *pcData);
+unsigned int pdlibSPI_SendDataNonBlocking(unsigned char ucSSI, unsigned char ucData);
+void pdlibSPI_EnableRxInt(unsigned char ucSSI, unsigned char ucEnable);
+void pdlibSPI_ClearRxInt(unsigned char ucSSI);
+unsigned char pdlibSPI_TransferByte(unsigned char ucSSI, unsigned char ucData);
+int pdlibSPI_SendData(unsigned char ucSSI, unsigned char *pucData, unsigned int uiLength);
+unsigned int pdlibSPI_TransferData(unsigned char ucSSI, unsigned char *pucTxData, unsigned char *pucRxData, unsigned int uiLength);
+
+#ifdef PDLIB_SPI_CONF_UDMA
+void pdlibSPI_ConfigureDMA(unsigned char ucSSI, void *pvControlTable);
+unsigned int pdlibSPI_TransferDataDMA(unsigned char ucSSI, unsigned char *pucTxData, unsigned char *pucRxData, unsigned int uiLength, tpdlibSPICallback pfnCallback, void *pvArg);
+int pdlibSPI_IsDMABusy(unsigned char ucSSI);
+void pdlibSPI_DMAIntHandler();
+#endif
 
 #endif
@@ -0,0 +1,684 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Simulated RF medium for simulated radios (pdlib_nrf24l01_sim). Every
+ * radio added to an air shares its time, and a packet sent by one radio
+ * reaches every other radio; the radio itself decides whether it listens
+ * on that channel, data rate, address width and address.
+ *
+ * 	NRF24L01_AirInit(&sAir, &sConfig);
+ * 	NRF24L01_SimInit(&sSim[i]);
+ * 	NRF24L01_AirAddRadio(&sAir, &sSim[i]);
+ * 	NRF24L01_InitHAL(&sRadio[i], &g_sNRF24L01SimHAL, &sSim[i]);
+ *
+ * On the way a packet can be lost (per link, NRF24L01_AirSetLinkLoss),
+ * hit by bit errors and delayed by a fixed latency. Packets overlapping
+ * in time on the same channel collide and are lost for every receiver,
+ * ACKs included. ACKs go back over the same air (NRF24L01_SimReceiveAck),
+ * so a lost or late ACK makes the PTX retransmit like on real radios.
+ *
+ * Random numbers come from a seeded generator, so a run repeats exactly.
+ * Carrier detect (CD) of a radio is set while a packet of its channel is
+ * on air or waiting for delivery.
+ *
+ * Git repo:
+ *
+ * https://github.com/pradeepa-s/pdlib_nrf24l01.git
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_air.h"
+
+#define AIR_NEVER			(~0ULL)
+#define AIR_NOBODY			0xFF
+
+static int _NRF24L01_AirTransmit(void *pvAir, tNRF24L01Sim *psSim, unsigned char ucEvent,
+								 const tNRF24L01SimPacket *psPacket, tNRF24L01SimPacket *psAck);
+static void _NRF24L01_AirAdvance(void *pvAir, unsigned long long ullTimeUs);
+static unsigned long long _NRF24L01_AirNextEvent(void *pvAir);
+
+static tNRF24L01AirPacket *_NRF24L01_AirPut(tNRF24L01Air *psAir, unsigned char ucFrom, const tNRF24L01SimPacket *psPacket);
+static void _NRF24L01_AirDeliver(tNRF24L01Air *psAir, tNRF24L01AirPacket *psEntry);
+static int _NRF24L01_AirLink(tNRF24L01Air *psAir, unsigned char ucFrom, unsigned char ucTo, tNRF24L01SimPacket *psPacket);
+static void _NRF24L01_AirUpdateCarrier(tNRF24L01Air *psAir);
+static int _NRF24L01_AirFind(tNRF24L01Air *psAir, tNRF24L01Sim *psSim);
+static unsigned long _NRF24L01_AirRandom(tNRF24L01Air *psAir);
+static int _NRF24L01_AirChance(tNRF24L01Air *psAir, unsigned long ulPPM);
+
+const tNRF24L01SimAir g_sNRF24L01Air =
+{
+	_NRF24L01_AirTransmit,
+	_NRF24L01_AirAdvance,
+	_NRF24L01_AirNextEvent
+};
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AirInit
+ *
+ * Arguments	: 	psAir		:	Air to initialize
+ * 					psConfig	:	Loss, bit errors, latency, collisions and seed
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Empty air at time 0. Every link gets psConfig->ulLossPPM.
+ *
+ */
+
+void
+NRF24L01_AirInit(tNRF24L01Air *psAir, const tNRF24L01AirConfig *psConfig)
+{
+	int iFrom;
+	int iTo;
+
+	memset(psAir, 0, sizeof(tNRF24L01Air));
+
+	psAir->sConfig = *psConfig;
+
+	for(iFrom = 0; iFrom < PDLIB_NRF24_AIR_MAX_RADIOS; iFrom++)
+	{
+		for(iTo = 0; iTo < PDLIB_NRF24_AIR_MAX_RADIOS; iTo++)
+		{
+			psAir->ulLinkLossPPM[iFrom][iTo] = psConfig->ulLossPPM;
+		}
+	}
+
+	/* PS: xorshift must not start from 0 */
+	psAir->ulRandom = psConfig->ulSeed ? psConfig->ulSeed : 0x2545F491;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AirAddRadio
+ *
+ * Arguments	: 	psAir	:	Air
+ * 					psSim	:	Simulated radio (NRF24L01_SimInit done)
+ *
+ * Return		: 	Index of the radio on the air, -1 if the air is full
+ *
+ * Description	: 	Attaches the radio. From now on the time of the radio is the
+ * 					time of the air.
+ *
+ */
+
+int
+NRF24L01_AirAddRadio(tNRF24L01Air *psAir, tNRF24L01Sim *psSim)
+{
+	if(psAir->ucRadioCount >= PDLIB_NRF24_AIR_MAX_RADIOS)
+	{
+		return -1;
+	}
+
+	if(psSim->ullTimeUs > psAir->ullTimeUs)
+	{
+		_NRF24L01_AirAdvance(psAir, psSim->ullTimeUs);
+	}
+
+	psAir->psRadio[psAir->ucRadioCount] = psSim;
+
+	NRF24L01_SimAttach(psSim, &g_sNRF24L01Air, psAir);
+	NRF24L01_SimRun(psSim, psAir->ullTimeUs);
+
+	return psAir->ucRadioCount++;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AirSetLinkLoss
+ *
+ * Arguments	: 	psAir		:	Air
+ * 					iFrom		:	Index of the sending radio
+ * 					iTo			:	Index of the receiving radio
+ * 					ulLossPPM	:	Chance of losing a packet or ACK, parts per million
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Links are one way, set both directions for a far away node.
+ *
+ */
+
+void
+NRF24L01_AirSetLinkLoss(tNRF24L01Air *psAir, int iFrom, int iTo, unsigned long ulLossPPM)
+{
+	if((iFrom >= 0) && (iFrom < PDLIB_NRF24_AIR_MAX_RADIOS) && (iTo >= 0) && (iTo < PDLIB_NRF24_AIR_MAX_RADIOS))
+	{
+		psAir->ulLinkLossPPM[iFrom][iTo] = ulLossPPM;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AirRun
+ *
+ * Arguments	: 	psAir		:	Air
+ * 					ullTimeUs	:	Time to run to
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Runs every radio and delivers every packet up to ullTimeUs, in
+ * 					time order. A delivery goes before a radio event of the same time.
+ * 					For the main loop of a simulation; the radios run the air by
+ * 					themselves while the driver talks to them or waits.
+ *
+ */
+
+void
+NRF24L01_AirRun(tNRF24L01Air *psAir, unsigned long long ullTimeUs)
+{
+	_NRF24L01_AirAdvance(psAir, ullTimeUs);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AirNextEvent
+ *
+ * Arguments	: 	psAir	:	Air
+ *
+ * Return		: 	Time of the earliest radio event or delivery, ~0 if none
+ *
+ */
+
+unsigned long long
+NRF24L01_AirNextEvent(tNRF24L01Air *psAir)
+{
+	return _NRF24L01_AirNextEvent(psAir);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AirGetTimeUs
+ *
+ * Arguments	: 	psAir	:	Air
+ *
+ * Return		: 	Time of the air in microseconds
+ *
+ */
+
+unsigned long long
+NRF24L01_AirGetTimeUs(tNRF24L01Air *psAir)
+{
+	return psAir->ullTimeUs;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AirGetStats
+ *
+ * Arguments	: 	psAir	:	Air
+ * 					iRadio	:	Index from NRF24L01_AirAddRadio
+ * 					psStats	:	Filled with the counters of the radio as a sender
+ *
+ * Return		: 	None
+ *
+ */
+
+void
+NRF24L01_AirGetStats(tNRF24L01Air *psAir, int iRadio, tNRF24L01AirStats *psStats)
+{
+	memset(psStats, 0, sizeof(tNRF24L01AirStats));
+
+	if((iRadio >= 0) && (iRadio < psAir->ucRadioCount))
+	{
+		*psStats = psAir->sStats[iRadio];
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AirResetStats
+ *
+ * Arguments	: 	psAir	:	Air
+ *
+ * Return		: 	None
+ *
+ */
+
+void
+NRF24L01_AirResetStats(tNRF24L01Air *psAir)
+{
+	memset(psAir->sStats, 0, sizeof(psAir->sStats));
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AirTransmit
+ *
+ * Arguments	: 	See pfnTransmit in pdlib_nrf24l01_sim.h
+ *
+ * Return		: 	0, ACKs are delivered later with NRF24L01_SimReceiveAck
+ *
+ * Description	: 	START puts the packet on air, END schedules its delivery after
+ * 					the latency.
+ *
+ */
+
+static int
+_NRF24L01_AirTransmit(void *pvAir, tNRF24L01Sim *psSim, unsigned char ucEvent,
+					  const tNRF24L01SimPacket *psPacket, tNRF24L01SimPacket *psAck)
+{
+	tNRF24L01Air *psAir = (tNRF24L01Air *)pvAir;
+	int iFrom = _NRF24L01_AirFind(psAir, psSim);
+	int iIndex;
+
+	/* PS: ACKs go on air as packets of their own */
+	(void)psAck;
+
+	if(iFrom < 0)
+	{
+		return 0;
+	}
+
+	if(PDLIB_NRF24_SIM_AIR_START == ucEvent)
+	{
+		_NRF24L01_AirPut(psAir, (unsigned char)iFrom, psPacket);
+		return 0;
+	}
+
+	for(iIndex = 0; iIndex < PDLIB_NRF24_AIR_MAX_PACKETS; iIndex++)
+	{
+		if(psAir->sPacket[iIndex].ucUsed && !psAir->sPacket[iIndex].ucIsAck &&
+		   (iFrom == psAir->sPacket[iIndex].ucFrom) && (AIR_NEVER == psAir->sPacket[iIndex].ullDeliverUs))
+		{
+			psAir->sPacket[iIndex].ullDeliverUs = psPacket->ullEndUs + psAir->sConfig.ulLatencyUs;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+
+static void
+_NRF24L01_AirAdvance(void *pvAir, unsigned long long ullTimeUs)
+{
+	tNRF24L01Air *psAir = (tNRF24L01Air *)pvAir;
+	tNRF24L01AirPacket *psEntry;
+	tNRF24L01Sim *psNext;
+	unsigned long long ullNext;
+	unsigned long long ullEvent;
+	int iIndex;
+
+	for(;;)
+	{
+		ullNext = AIR_NEVER;
+		psNext = NULL;
+		psEntry = NULL;
+
+		for(iIndex = 0; iIndex < psAir->ucRadioCount; iIndex++)
+		{
+			ullEvent = NRF24L01_SimNextEvent(psAir->psRadio[iIndex]);
+
+			if(ullEvent < ullNext)
+			{
+				ullNext = ullEvent;
+				psNext = psAir->psRadio[iIndex];
+			}
+		}
+
+		for(iIndex = 0; iIndex < PDLIB_NRF24_AIR_MAX_PACKETS; iIndex++)
+		{
+			if(psAir->sPacket[iIndex].ucUsed && (psAir->sPacket[iIndex].ullDeliverUs <= ullNext) &&
+			   (psAir->sPacket[iIndex].ullDeliverUs != AIR_NEVER))
+			{
+				ullNext = psAir->sPacket[iIndex].ullDeliverUs;
+				psEntry = &psAir->sPacket[iIndex];
+			}
+		}
+
+		if((AIR_NEVER == ullNext) || (ullNext > ullTimeUs))
+		{
+			break;
+		}
+
+		if(ullNext > psAir->ullTimeUs)
+		{
+			psAir->ullTimeUs = ullNext;
+		}
+
+		if(psEntry)
+		{
+			_NRF24L01_AirDeliver(psAir, psEntry);
+		}else
+		{
+			NRF24L01_SimRun(psNext, ullNext);
+		}
+	}
+
+	if(ullTimeUs > psAir->ullTimeUs)
+	{
+		psAir->ullTimeUs = ullTimeUs;
+	}
+
+	for(iIndex = 0; iIndex < psAir->ucRadioCount; iIndex++)
+	{
+		NRF24L01_SimRun(psAir->psRadio[iIndex], psAir->ullTimeUs);
+	}
+}
+
+
+static unsigned long long
+_NRF24L01_AirNextEvent(void *pvAir)
+{
+	tNRF24L01Air *psAir = (tNRF24L01Air *)pvAir;
+	unsigned long long ullNext = AIR_NEVER;
+	unsigned long long ullEvent;
+	int iIndex;
+
+	for(iIndex = 0; iIndex < psAir->ucRadioCount; iIndex++)
+	{
+		ullEvent = NRF24L01_SimNextEvent(psAir->psRadio[iIndex]);
+
+		if(ullEvent < ullNext)
+		{
+			ullNext = ullEvent;
+		}
+	}
+
+	for(iIndex = 0; iIndex < PDLIB_NRF24_AIR_MAX_PACKETS; iIndex++)
+	{
+		if(psAir->sPacket[iIndex].ucUsed && (psAir->sPacket[iIndex].ullDeliverUs < ullNext))
+		{
+			ullNext = psAir->sPacket[iIndex].ullDeliverUs;
+		}
+	}
+
+	return ullNext;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AirPut
+ *
+ * Arguments	: 	psAir		:	Air
+ * 					ucFrom		:	Index of the sender
+ * 					psPacket	:	Packet, ullStartUs and ullEndUs set
+ *
+ * Return		: 	The entry, NULL if the air is full (the packet is lost)
+ *
+ * Description	: 	Marks every packet it overlaps on the channel as collided.
+ *
+ */
+
+static tNRF24L01AirPacket *
+_NRF24L01_AirPut(tNRF24L01Air *psAir, unsigned char ucFrom, const tNRF24L01SimPacket *psPacket)
+{
+	tNRF24L01AirPacket *psEntry = NULL;
+	tNRF24L01AirPacket *psOther;
+	int iIndex;
+
+	psAir->sStats[ucFrom].ulSent++;
+
+	for(iIndex = 0; iIndex < PDLIB_NRF24_AIR_MAX_PACKETS; iIndex++)
+	{
+		if(!psAir->sPacket[iIndex].ucUsed)
+		{
+			psEntry = &psAir->sPacket[iIndex];
+			break;
+		}
+	}
+
+	if(NULL == psEntry)
+	{
+		psAir->sStats[ucFrom].ulLost++;
+		return NULL;
+	}
+
+	memset(psEntry, 0, sizeof(tNRF24L01AirPacket));
+	psEntry->sPacket = *psPacket;
+	psEntry->ullDeliverUs = AIR_NEVER;
+	psEntry->ucFrom = ucFrom;
+	psEntry->ucTo = AIR_NOBODY;
+	psEntry->ucUsed = 1;
+
+	if(psAir->sConfig.ucCollisions)
+	{
+		for(iIndex = 0; iIndex < PDLIB_NRF24_AIR_MAX_PACKETS; iIndex++)
+		{
+			psOther = &psAir->sPacket[iIndex];
+
+			if((psOther != psEntry) && psOther->ucUsed && (psOther->sPacket.ucChannel == psPacket->ucChannel) &&
+			   (psOther->sPacket.ullStartUs < psPacket->ullEndUs) && (psPacket->ullStartUs < psOther->sPacket.ullEndUs))
+			{
+				psOther->ucCollided = 1;
+				psEntry->ucCollided = 1;
+			}
+		}
+	}
+
+	_NRF24L01_AirUpdateCarrier(psAir);
+
+	return psEntry;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AirDeliver
+ *
+ * Arguments	: 	psAir	:	Air
+ * 					psEntry	:	Packet due now
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Hands a packet to every other radio, an ACK to the radio waiting
+ * 					for it. An ACK sent back is put on air here.
+ *
+ */
+
+static void
+_NRF24L01_AirDeliver(tNRF24L01Air *psAir, tNRF24L01AirPacket *psEntry)
+{
+	tNRF24L01AirPacket sEntry = *psEntry;
+	tNRF24L01AirPacket *psAckEntry;
+	tNRF24L01SimPacket sPacket;
+	tNRF24L01SimPacket sAck;
+	tNRF24L01Sim *psSim;
+	int iTo;
+
+	psEntry->ucUsed = 0;
+	_NRF24L01_AirUpdateCarrier(psAir);
+
+	if(sEntry.ucCollided)
+	{
+		psAir->sStats[sEntry.ucFrom].ulCollided++;
+		return;
+	}
+
+	/* PS: The receivers see the packet later by the latency */
+	sEntry.sPacket.ullStartUs += psAir->sConfig.ulLatencyUs;
+	sEntry.sPacket.ullEndUs += psAir->sConfig.ulLatencyUs;
+
+	for(iTo = 0; iTo < psAir->ucRadioCount; iTo++)
+	{
+		if(iTo == sEntry.ucFrom)
+		{
+			continue;
+		}
+
+		if(sEntry.ucIsAck && (iTo != sEntry.ucTo))
+		{
+			continue;
+		}
+
+		psSim = psAir->psRadio[iTo];
+
+		NRF24L01_SimRun(psSim, psAir->ullTimeUs);
+
+		if(!sEntry.ucIsAck && !NRF24L01_SimIsListening(psSim, sEntry.sPacket.ucChannel, sEntry.sPacket.ucDataRate))
+		{
+			continue;
+		}
+
+		sPacket = sEntry.sPacket;
+
+		if(!_NRF24L01_AirLink(psAir, sEntry.ucFrom, (unsigned char)iTo, &sPacket))
+		{
+			continue;
+		}
+
+		psAir->sStats[sEntry.ucFrom].ulDelivered++;
+
+		if(sEntry.ucIsAck)
+		{
+			NRF24L01_SimReceiveAck(psSim, &sPacket);
+		}else if(NRF24L01_SimReceive(psSim, &sPacket, &sAck))
+		{
+			psAckEntry = _NRF24L01_AirPut(psAir, (unsigned char)iTo, &sAck);
+
+			if(psAckEntry)
+			{
+				psAckEntry->ucIsAck = 1;
+				psAckEntry->ucTo = sEntry.ucFrom;
+				psAckEntry->ullDeliverUs = sAck.ullEndUs + psAir->sConfig.ulLatencyUs;
+			}
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AirLink
+ *
+ * Arguments	: 	psAir		:	Air
+ * 					ucFrom		:	Sender
+ * 					ucTo		:	Receiver
+ * 					psPacket	:	Copy of the packet for this receiver, bit errors go in here
+ *
+ * Return		: 	1 if the packet reaches the receiver, 0 if it is lost
+ *
+ * Description	: 	A bit error in a packet with CRC fails the CRC. Without CRC the
+ * 					payload is delivered with the wrong bits.
+ *
+ */
+
+static int
+_NRF24L01_AirLink(tNRF24L01Air *psAir, unsigned char ucFrom, unsigned char ucTo, tNRF24L01SimPacket *psPacket)
+{
+	unsigned long ulBits;
+	unsigned long ulBit;
+	unsigned char ucCorrupted = 0;
+
+	if(_NRF24L01_AirChance(psAir, psAir->ulLinkLossPPM[ucFrom][ucTo]))
+	{
+		psAir->sStats[ucFrom].ulLost++;
+		return 0;
+	}
+
+	if(0 == psAir->sConfig.ulBitErrorPPM)
+	{
+		return 1;
+	}
+
+	/* PS: Address, packet control field, payload and CRC can all be hit */
+	ulBits = (8 * (psPacket->ucAddressWidth + psPacket->ucLength + psPacket->ucCRCLength)) + 9;
+
+	for(ulBit = 0; ulBit < ulBits; ulBit++)
+	{
+		if(_NRF24L01_AirChance(psAir, psAir->sConfig.ulBitErrorPPM))
+		{
+			ucCorrupted = 1;
+
+			if((0 == psPacket->ucCRCLength) && (ulBit < (8UL * psPacket->ucLength)))
+			{
+				psPacket->ucPayload[ulBit / 8] ^= (unsigned char)(1 << (ulBit % 8));
+			}
+		}
+	}
+
+	if(ucCorrupted)
+	{
+		psAir->sStats[ucFrom].ulCorrupted++;
+
+		if(psPacket->ucCRCLength)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+
+static void
+_NRF24L01_AirUpdateCarrier(tNRF24L01Air *psAir)
+{
+	int iRadio;
+	int iIndex;
+	tNRF24L01Sim *psSim;
+
+	for(iRadio = 0; iRadio < psAir->ucRadioCount; iRadio++)
+	{
+		psSim = psAir->psRadio[iRadio];
+		psSim->ucCarrier = 0;
+
+		for(iIndex = 0; iIndex < PDLIB_NRF24_AIR_MAX_PACKETS; iIndex++)
+		{
+			if(psAir->sPacket[iIndex].ucUsed && (psAir->sPacket[iIndex].ucFrom != iRadio) &&
+			   (psAir->sPacket[iIndex].sPacket.ucChannel == psSim->ucRegister[RF24_RF_CH]))
+			{
+				psSim->ucCarrier = 1;
+				break;
+			}
+		}
+	}
+}
+
+
+static int
+_NRF24L01_AirFind(tNRF24L01Air *psAir, tNRF24L01Sim *psSim)
+{
+	int iIndex;
+
+	for(iIndex = 0; iIndex < psAir->ucRadioCount; iIndex++)
+	{
+		if(psAir->psRadio[iIndex] == psSim)
+		{
+			return iIndex;
+		}
+	}
+
+	return -1;
+}
+
+
+/* PS: xorshift32, only the low 32 bits are kept on hosts with a 64 bit long */
+static unsigned long
+_NRF24L01_AirRandom(tNRF24L01Air *psAir)
+{
+	unsigned long ulX = psAir->ulRandom;
+
+	ulX ^= (ulX << 13) & 0xFFFFFFFFUL;
+	ulX ^= ulX >> 17;
+	ulX ^= (ulX << 5) & 0xFFFFFFFFUL;
+
+	psAir->ulRandom = ulX & 0xFFFFFFFFUL;
+
+	return psAir->ulRandom;
+}
+
+
+static int
+_NRF24L01_AirChance(tNRF24L01Air *psAir, unsigned long ulPPM)
+{
+	if(0 == ulPPM)
+	{
+		return 0;
+	}
+
+	return (_NRF24L01_AirRandom(psAir) % 1000000UL) < ulPPM;
+}
@@ -0,0 +1,70 @@
+#ifndef _PDLIB_NRF24L01_AIR
+#define _PDLIB_NRF24L01_AIR
+
+#include "pdlib_nrf24l01_sim.h"
+
+/* PS: Simulated RF medium connecting simulated radios (pdlib_nrf24l01_sim), for host builds.
+ * See pdlib_nrf24l01_air.c. */
+
+/* PS: Radios one air can connect */
+#ifndef PDLIB_NRF24_AIR_MAX_RADIOS
+#define PDLIB_NRF24_AIR_MAX_RADIOS		16
+#endif
+
+/* PS: Packets and ACKs on air or waiting to be delivered */
+#define PDLIB_NRF24_AIR_MAX_PACKETS		(4 * PDLIB_NRF24_AIR_MAX_RADIOS)
+
+typedef struct
+{
+	unsigned long ulLossPPM;		// Chance of a packet or ACK not reaching a radio, parts per million (see NRF24L01_AirSetLinkLoss)
+	unsigned long ulBitErrorPPM;	// Chance of every bit being received wrong, parts per million
+	unsigned long ulLatencyUs;		// From the end of a packet on air to the receiver having it
+	unsigned char ucCollisions;		// 1: packets overlapping on a channel are lost for every receiver
+	unsigned long ulSeed;			// Same seed, same run
+}tNRF24L01AirConfig;
+
+/* PS: Counters of one radio as a sender, reset by NRF24L01_AirResetStats */
+typedef struct
+{
+	unsigned long ulSent;			// Packets and ACKs put on air
+	unsigned long ulCollided;		// Lost to a collision
+	unsigned long ulLost;			// Lost to the link loss, counted per receiver
+	unsigned long ulCorrupted;		// Bit errors, counted per receiver (lost with CRC, delivered with errors without)
+	unsigned long ulDelivered;		// Handed to a radio listening on the channel and data rate
+}tNRF24L01AirStats;
+
+typedef struct
+{
+	tNRF24L01SimPacket sPacket;
+	unsigned long long ullDeliverUs;	// ~0 while the packet is still on air
+	unsigned char ucUsed;
+	unsigned char ucFrom;
+	unsigned char ucTo;					// Radio waiting for the ACK, only for ACKs
+	unsigned char ucIsAck;
+	unsigned char ucCollided;
+}tNRF24L01AirPacket;
+
+typedef struct
+{
+	tNRF24L01AirConfig sConfig;
+	tNRF24L01Sim *psRadio[PDLIB_NRF24_AIR_MAX_RADIOS];
+	unsigned char ucRadioCount;
+	unsigned long ulLinkLossPPM[PDLIB_NRF24_AIR_MAX_RADIOS][PDLIB_NRF24_AIR_MAX_RADIOS];
+	tNRF24L01AirPacket sPacket[PDLIB_NRF24_AIR_MAX_PACKETS];
+	unsigned long long ullTimeUs;
+	unsigned long ulRandom;
+	tNRF24L01AirStats sStats[PDLIB_NRF24_AIR_MAX_RADIOS];
+}tNRF24L01Air;
+
+extern const tNRF24L01SimAir g_sNRF24L01Air;
+
+void NRF24L01_AirInit(tNRF24L01Air *psAir, const tNRF24L01AirConfig *psConfig);
+int NRF24L01_AirAddRadio(tNRF24L01Air *psAir, tNRF24L01Sim *psSim);
+void NRF24L01_AirSetLinkLoss(tNRF24L01Air *psAir, int iFrom, int iTo, unsigned long ulLossPPM);
+void NRF24L01_AirRun(tNRF24L01Air *psAir, unsigned long long ullTimeUs);
+unsigned long long NRF24L01_AirNextEvent(tNRF24L01Air *psAir);
+unsigned long long NRF24L01_AirGetTimeUs(tNRF24L01Air *psAir);
+void NRF24L01_AirGetStats(tNRF24L01Air *psAir, int iRadio, tNRF24L01AirStats *psStats);
+void NRF24L01_AirResetStats(tNRF24L01Air *psAir);
+
+#endif
@@ -0,0 +1,586 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Throughput and latency benchmark. Sends a number of packets from a PTX
+ * radio with NRF24L01_SendData for every combination of payload size, air
+ * data rate, ARD, ARC, static/dynamic payload and ACK/no ACK, and prints one
+ * CSV line per combination. ack is 1 with auto ACK, 0 with auto ACK off and 2
+ * for payloads sent with NRF24L01_SendDataNoAck (auto ACK left on):
+ *
+ * 	bench,rate_kbps,payload,dynamic,ack,ard_us,arc,packets,sent,failed,received,
+ * 	retries,pps,goodput_Bps,spi_us,lat_min_us,lat_p50_us,lat_p90_us,lat_p99_us,
+ * 	lat_max_us,h256,h512,h1k,h2k,h4k,h8k,h16k,h_more
+ *
+ * The latency of a packet is NRF24L01_SendData plus clearing TX_DS/MAX_RT,
+ * which is what an application pays per packet. pps and goodput are over
+ * the sum of the latencies, so time spent reading the PRX is not counted.
+ * spi_us is the time the PTX backend spent in SPI transfers per packet.
+ * hN counts latencies below N us.
+ *
+ * The PRX (optional) is read after every packet. Without it, received is
+ * the number of TX_DS. Lines starting with '#' are comments.
+ *
+ * The platform gives a microsecond clock and a line printer, and puts
+ * g_sNRF24L01BenchHAL in front of the backend of the PTX:
+ *
+ * 	NRF24L01_BenchInit(&sBench, &g_sNRF24L01SimHAL, &sSim, GetTimeUs, PrintLine, NULL);
+ * 	NRF24L01_InitHAL(&sPTX, &g_sNRF24L01BenchHAL, &sBench);
+ * 	NRF24L01_BenchRun(&sBench, &sPTX, &sPRX, &g_sNRF24L01BenchDefaultSweep);
+ *
+ * Git repo:
+ *
+ * https://github.com/pradeepa-s/pdlib_nrf24l01.git
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_bench.h"
+
+static unsigned char _NRF24L01_BenchTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+											 unsigned char *pucRxData, unsigned int uiLength);
+static void _NRF24L01_BenchSetCE(void *pvContext, unsigned char ucLevel);
+static void _NRF24L01_BenchSetCSN(void *pvContext, unsigned char ucLevel);
+static int _NRF24L01_BenchWaitIRQ(void *pvContext, unsigned long ulTimeoutUs);
+static unsigned long _NRF24L01_BenchGetTimeUs(void *pvContext);
+static int _NRF24L01_BenchGetIRQ(void *pvContext);
+
+static void _NRF24L01_BenchConfigure(tNRF24L01 *psPTX, tNRF24L01 *psPRX, tNRF24L01BenchResult *psResult,
+									 unsigned char ucDataRate);
+static void _NRF24L01_BenchMeasure(tNRF24L01Bench *psBench, tNRF24L01 *psPTX, tNRF24L01 *psPRX);
+static void _NRF24L01_BenchPrint(tNRF24L01Bench *psBench);
+static unsigned int _NRF24L01_BenchAppend(char *pcLine, unsigned int uiPos, unsigned long ulValue);
+
+const tNRF24L01HAL g_sNRF24L01BenchHAL =
+{
+	_NRF24L01_BenchTransfer,
+	_NRF24L01_BenchSetCE,
+	_NRF24L01_BenchSetCSN,
+	_NRF24L01_BenchWaitIRQ,
+	_NRF24L01_BenchGetTimeUs,
+	NULL,
+	NULL,
+	NULL,
+	_NRF24L01_BenchGetIRQ
+};
+
+static const unsigned char g_pucBenchDataRate[] = {0, 1};
+static const unsigned short g_pusBenchARD[] = {250, 500, 1000};
+static const unsigned char g_pucBenchARC[] = {0, 3, 15};
+
+const tNRF24L01BenchSweep g_sNRF24L01BenchDefaultSweep =
+{
+	1, 32, 1,
+	g_pucBenchDataRate, sizeof(g_pucBenchDataRate),
+	g_pusBenchARD, sizeof(g_pusBenchARD) / sizeof(g_pusBenchARD[0]),
+	g_pucBenchARC, sizeof(g_pucBenchARC),
+	PDLIB_NRF24_BENCH_STATIC | PDLIB_NRF24_BENCH_DYNAMIC | PDLIB_NRF24_BENCH_ACK | PDLIB_NRF24_BENCH_NOACK |
+	PDLIB_NRF24_BENCH_NOACK_TX,
+	100
+};
+
+/* PS: ucAck of the results, in the order they are run, and the mode bit enabling each */
+static const unsigned char g_pucBenchAck[] = {1, 0, 2};
+static const unsigned char g_pucBenchAckMode[] = {PDLIB_NRF24_BENCH_ACK, PDLIB_NRF24_BENCH_NOACK, PDLIB_NRF24_BENCH_NOACK_TX};
+
+static const char g_pcBenchTitle[] = "# pdlib_nrf24l01 benchmark, packets per combination ";
+
+static const char g_pcBenchHeader[] =
+	"bench,rate_kbps,payload,dynamic,ack,ard_us,arc,packets,sent,failed,received,retries,pps,goodput_Bps,spi_us,"
+	"lat_min_us,lat_p50_us,lat_p90_us,lat_p99_us,lat_max_us,h256,h512,h1k,h2k,h4k,h8k,h16k,h_more";
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BenchInit
+ *
+ * Arguments	: 	psBench			:	Benchmark
+ * 					psHAL			:	Backend of the PTX
+ * 					pvHALContext	:	Its context
+ * 					pfnGetTimeUs	:	Free running microsecond clock
+ * 					pfnPrint		:	Prints one line, without the line ending
+ * 					pvArg			:	Passed to pfnGetTimeUs and pfnPrint
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Call before NRF24L01_InitHAL of the PTX, which gets
+ * 					g_sNRF24L01BenchHAL and psBench.
+ *
+ */
+
+void
+NRF24L01_BenchInit(	tNRF24L01Bench *psBench,
+					const tNRF24L01HAL *psHAL,
+					void *pvHALContext,
+					unsigned long (*pfnGetTimeUs)(void *pvArg),
+					void (*pfnPrint)(void *pvArg, const char *pcLine),
+					void *pvArg)
+{
+	psBench->psHAL = psHAL;
+	psBench->pvHALContext = pvHALContext;
+	psBench->pfnGetTimeUs = pfnGetTimeUs;
+	psBench->pfnPrint = pfnPrint;
+	psBench->pfnResult = NULL;
+	psBench->pvArg = pvArg;
+	psBench->ulSPITimeUs = 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BenchRun
+ *
+ * Arguments	: 	psBench	:	Benchmark
+ * 					psPTX	:	Radio sending, initialized with g_sNRF24L01BenchHAL
+ * 					psPRX	:	Radio receiving (any backend), NULL if there is none
+ * 					psSweep	:	What to run, g_sNRF24L01BenchDefaultSweep for all
+ *
+ * Return		: 	Number of combinations run
+ *
+ * Description	: 	Static payload runs go first, the driver cannot turn dynamic
+ * 					payload off again. Dynamic payload needs auto ACK on the pipe
+ * 					(datasheet, DYNPD), so it is not run without ACK.
+ *
+ * 					The radios are left with the last combination.
+ *
+ */
+
+int
+NRF24L01_BenchRun(tNRF24L01Bench *psBench, tNRF24L01 *psPTX, tNRF24L01 *psPRX, const tNRF24L01BenchSweep *psSweep)
+{
+	tNRF24L01BenchResult *psResult = &psBench->sResult;
+	unsigned char ucDynamic;
+	unsigned char ucAckIndex;
+	unsigned char ucAck;
+	unsigned char ucRate;
+	unsigned char ucARD;
+	unsigned char ucARC;
+	unsigned char ucARDCount;
+	unsigned char ucARCCount;
+	unsigned int uiPayload;
+	unsigned int uiPos;
+	int iCount = 0;
+
+	uiPos = sizeof(g_pcBenchTitle) - 1;
+	memcpy(psBench->cLine, g_pcBenchTitle, uiPos);
+	uiPos = _NRF24L01_BenchAppend(psBench->cLine, uiPos, (psSweep->uiPackets > PDLIB_NRF24_BENCH_MAX_PACKETS) ?
+															PDLIB_NRF24_BENCH_MAX_PACKETS : psSweep->uiPackets);
+	psBench->cLine[uiPos - 1] = '\0';
+	psBench->pfnPrint(psBench->pvArg, psBench->cLine);
+	psBench->pfnPrint(psBench->pvArg, g_pcBenchHeader);
+
+	NRF24L01_SetPowerPolicy(psPTX, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+
+	for(ucDynamic = 0; ucDynamic < 2; ucDynamic++)
+	{
+		if(0 == (psSweep->ucModes & (ucDynamic ? PDLIB_NRF24_BENCH_DYNAMIC : PDLIB_NRF24_BENCH_STATIC)))
+		{
+			continue;
+		}
+
+		for(ucAckIndex = 0; ucAckIndex < sizeof(g_pucBenchAck); ucAckIndex++)
+		{
+			ucAck = g_pucBenchAck[ucAckIndex];
+
+			/* PS: Dynamic payload length needs auto ACK on the pipe */
+			if((0 == (psSweep->ucModes & g_pucBenchAckMode[ucAckIndex])) || (ucDynamic && (0 == ucAck)))
+			{
+				continue;
+			}
+
+			/* PS: ARD and ARC mean nothing without ACK */
+			ucARDCount = (1 == ucAck) ? psSweep->ucARDCount : 1;
+			ucARCCount = (1 == ucAck) ? psSweep->ucARCCount : 1;
+
+			for(ucRate = 0; ucRate < psSweep->ucDataRateCount; ucRate++)
+			{
+				for(ucARD = 0; ucARD < ucARDCount; ucARD++)
+				{
+					for(ucARC = 0; ucARC < ucARCCount; ucARC++)
+					{
+						for(uiPayload = psSweep->ucPayloadMin; uiPayload <= psSweep->ucPayloadMax;
+							uiPayload += (psSweep->ucPayloadStep ? psSweep->ucPayloadStep : 1))
+						{
+							memset(psResult, 0, sizeof(tNRF24L01BenchResult));
+							psResult->ucPayload = (unsigned char)uiPayload;
+							psResult->ucDynamic = ucDynamic;
+							psResult->ucAck = ucAck;
+							psResult->usARD = (1 == ucAck) ? psSweep->pusARD[ucARD] : 0;
+							psResult->ucARC = (1 == ucAck) ? psSweep->pucARC[ucARC] : 0;
+							psResult->uiPackets = (psSweep->uiPackets > PDLIB_NRF24_BENCH_MAX_PACKETS) ?
+												  PDLIB_NRF24_BENCH_MAX_PACKETS : psSweep->uiPackets;
+
+							_NRF24L01_BenchConfigure(psPTX, psPRX, psResult, psSweep->pucDataRate[ucRate]);
+							_NRF24L01_BenchMeasure(psBench, psPTX, psPRX);
+							_NRF24L01_BenchPrint(psBench);
+
+							if(psBench->pfnResult)
+							{
+								psBench->pfnResult(psBench->pvArg, psResult);
+							}
+
+							iCount++;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	psBench->pfnPrint(psBench->pvArg, "# done");
+
+	return iCount;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_BenchConfigure
+ *
+ * Arguments	: 	psPTX		:	Radio sending
+ * 					psPRX		:	Radio receiving, can be NULL
+ * 					psResult	:	Combination to set up, uiRateKbps is filled
+ * 					ucDataRate	:	Value for NRF24L01_SetAirDataRate
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The PRX leaves RX mode while it is changed, registers are not
+ * 					written in RX mode.
+ *
+ */
+
+static void
+_NRF24L01_BenchConfigure(tNRF24L01 *psPTX, tNRF24L01 *psPRX, tNRF24L01BenchResult *psResult, unsigned char ucDataRate)
+{
+	unsigned char ucEnAA = psResult->ucAck ? 0x3F : 0x00;
+
+	if(psPRX)
+	{
+		NRF24L01_DisableRxMode(psPRX);
+
+		NRF24L01_SetAirDataRate(psPRX, ucDataRate);
+		NRF24L01_RegisterWrite_8(psPRX, RF24_EN_AA, ucEnAA);
+
+		if(psResult->ucDynamic)
+		{
+			NRF24L01_EnableFeatureDynPL(psPRX, PDLIB_NRF24_PIPE0);
+		}else
+		{
+			NRF24L01_SetRXPacketSize(psPRX, PDLIB_NRF24_PIPE0, psResult->ucPayload);
+		}
+
+		NRF24L01_FlushRX(psPRX);
+		NRF24L01_ClearInterruptFlag(psPRX, PDLIB_INTERRUPT_DATA_READY | PDLIB_INTERRUPT_DATA_SENT | PDLIB_INTERRUPT_MAX_RT);
+		NRF24L01_EnableRxMode(psPRX);
+	}
+
+	NRF24L01_SetAirDataRate(psPTX, ucDataRate);
+	NRF24L01_RegisterWrite_8(psPTX, RF24_EN_AA, ucEnAA);
+
+	if(1 == psResult->ucAck)
+	{
+		NRF24L01_SetARD(psPTX, psResult->usARD);
+		NRF24L01_SetARC(psPTX, psResult->ucARC);
+	}
+
+	if(psResult->ucDynamic)
+	{
+		NRF24L01_EnableFeatureDynPL(psPTX, PDLIB_NRF24_PIPE0);
+	}
+
+	NRF24L01_FlushTX(psPTX);
+	NRF24L01_ClearInterruptFlag(psPTX, PDLIB_INTERRUPT_DATA_READY | PDLIB_INTERRUPT_DATA_SENT | PDLIB_INTERRUPT_MAX_RT);
+
+	/* PS: What the chip does, whatever NRF24L01_SetAirDataRate was given */
+	psResult->uiRateKbps = (NRF24L01_RegisterRead_8(psPTX, RF24_RF_SETUP) & (RF24_RF_DR)) ? 2000 : 1000;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_BenchMeasure
+ *
+ * Arguments	: 	psBench	:	Benchmark, psBench->sResult is set up
+ * 					psPTX	:	Radio sending
+ * 					psPRX	:	Radio receiving, can be NULL
+ *
+ * Return		: 	None
+ *
+ */
+
+static void
+_NRF24L01_BenchMeasure(tNRF24L01Bench *psBench, tNRF24L01 *psPTX, tNRF24L01 *psPRX)
+{
+	tNRF24L01BenchResult *psResult = &psBench->sResult;
+	unsigned long *pulLatency = psBench->ulLatencyUs;
+	unsigned long ulSPIUs = 0;
+	unsigned long ulSPIStart;
+	unsigned long ulStart;
+	unsigned long ulBytes = 0;
+	unsigned long ulValue;
+	unsigned int uiPacket;
+	unsigned int uiIndex;
+	unsigned int uiBucket;
+	char cData[32];
+	char cLength;
+	char cPipe;
+	int iRet;
+
+	for(uiPacket = 0; uiPacket < psResult->uiPackets; uiPacket++)
+	{
+		for(uiIndex = 0; uiIndex < psResult->ucPayload; uiIndex++)
+		{
+			cData[uiIndex] = (char)(uiPacket + uiIndex);
+		}
+
+		ulSPIStart = psBench->ulSPITimeUs;
+		ulStart = psBench->pfnGetTimeUs(psBench->pvArg);
+
+		if(2 == psResult->ucAck)
+		{
+			iRet = NRF24L01_SendDataNoAck(psPTX, cData, psResult->ucPayload);
+		}else
+		{
+			iRet = NRF24L01_SendData(psPTX, cData, psResult->ucPayload);
+		}
+
+		/* PS: A failed payload would go again with the next one */
+		if(PDLIB_NRF24_SUCCESS != iRet)
+		{
+			NRF24L01_FlushTX(psPTX);
+		}
+
+		NRF24L01_ClearInterruptFlag(psPTX, PDLIB_INTERRUPT_DATA_SENT | PDLIB_INTERRUPT_MAX_RT);
+
+		pulLatency[uiPacket] = psBench->pfnGetTimeUs(psBench->pvArg) - ulStart;
+		ulSPIUs += psBench->ulSPITimeUs - ulSPIStart;
+
+		if(PDLIB_NRF24_SUCCESS == iRet)
+		{
+			psResult->uiSent++;
+		}else
+		{
+			psResult->uiFailed++;
+		}
+
+		if(1 == psResult->ucAck)
+		{
+			psResult->ulRetries += (NRF24L01_RegisterRead_8(psPTX, RF24_OBSERVE_TX) & 0x0F);
+		}
+
+		if(psPRX)
+		{
+			while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(psPRX, &cPipe))
+			{
+				cLength = sizeof(cData);
+				iRet = NRF24L01_GetData(psPRX, cPipe, cData, &cLength);
+
+				if(iRet <= 0)
+				{
+					NRF24L01_FlushRX(psPRX);
+					NRF24L01_ClearInterruptFlag(psPRX, PDLIB_INTERRUPT_DATA_READY);
+					break;
+				}
+
+				psResult->uiReceived++;
+				ulBytes += (unsigned long)iRet;
+			}
+		}else if(PDLIB_NRF24_SUCCESS == iRet)
+		{
+			psResult->uiReceived++;
+			ulBytes += psResult->ucPayload;
+		}
+	}
+
+	if(0 == psResult->uiPackets)
+	{
+		return;
+	}
+
+	/* PS: Insertion sort, a few hundred samples at most */
+	for(uiPacket = 1; uiPacket < psResult->uiPackets; uiPacket++)
+	{
+		ulValue = pulLatency[uiPacket];
+
+		for(uiIndex = uiPacket; (uiIndex > 0) && (pulLatency[uiIndex - 1] > ulValue); uiIndex--)
+		{
+			pulLatency[uiIndex] = pulLatency[uiIndex - 1];
+		}
+
+		pulLatency[uiIndex] = ulValue;
+	}
+
+	for(uiPacket = 0; uiPacket < psResult->uiPackets; uiPacket++)
+	{
+		psResult->ulBusyUs += pulLatency[uiPacket];
+
+		for(uiBucket = 0; uiBucket < (PDLIB_NRF24_BENCH_BUCKETS - 1); uiBucket++)
+		{
+			if(pulLatency[uiPacket] < (256UL << uiBucket))
+			{
+				break;
+			}
+		}
+
+		psResult->uiHistogram[uiBucket]++;
+	}
+
+	psResult->ulLatencyUs[0] = pulLatency[0];
+	psResult->ulLatencyUs[1] = pulLatency[((psResult->uiPackets - 1) * 50) / 100];
+	psResult->ulLatencyUs[2] = pulLatency[((psResult->uiPackets - 1) * 90) / 100];
+	psResult->ulLatencyUs[3] = pulLatency[((psResult->uiPackets - 1) * 99) / 100];
+	psResult->ulLatencyUs[4] = pulLatency[psResult->uiPackets - 1];
+
+	psResult->ulSPIUs = ulSPIUs / psResult->uiPackets;
+
+	if(psResult->ulBusyUs)
+	{
+		psResult->ulPacketsPerSecond = (unsigned long)(((unsigned long long)psResult->uiSent * 1000000) / psResult->ulBusyUs);
+		psResult->ulGoodput = (unsigned long)(((unsigned long long)ulBytes * 1000000) / psResult->ulBusyUs);
+	}
+}
+
+
+static void
+_NRF24L01_BenchPrint(tNRF24L01Bench *psBench)
+{
+	tNRF24L01BenchResult *psResult = &psBench->sResult;
+	char *pcLine = psBench->cLine;
+	unsigned int uiPos = 0;
+	unsigned int uiIndex;
+
+	memcpy(pcLine, "bench,", 6);
+	uiPos = 6;
+
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->uiRateKbps);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ucPayload);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ucDynamic);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ucAck);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->usARD);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ucARC);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->uiPackets);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->uiSent);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->uiFailed);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->uiReceived);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ulRetries);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ulPacketsPerSecond);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ulGoodput);
+	uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ulSPIUs);
+
+	for(uiIndex = 0; uiIndex < 5; uiIndex++)
+	{
+		uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->ulLatencyUs[uiIndex]);
+	}
+
+	for(uiIndex = 0; uiIndex < PDLIB_NRF24_BENCH_BUCKETS; uiIndex++)
+	{
+		uiPos = _NRF24L01_BenchAppend(pcLine, uiPos, psResult->uiHistogram[uiIndex]);
+	}
+
+	/* PS: No separator after the last field */
+	pcLine[uiPos - 1] = '\0';
+
+	psBench->pfnPrint(psBench->pvArg, pcLine);
+}
+
+
+/* PS: Decimal and a comma, without printf so it fits the targets which only have uart_debug */
+static unsigned int
+_NRF24L01_BenchAppend(char *pcLine, unsigned int uiPos, unsigned long ulValue)
+{
+	char cDigits[10];
+	unsigned int uiCount = 0;
+
+	do
+	{
+		cDigits[uiCount++] = (char)('0' + (ulValue % 10));
+		ulValue /= 10;
+	}while(ulValue && (uiCount < sizeof(cDigits)));
+
+	while(uiCount)
+	{
+		pcLine[uiPos++] = cDigits[--uiCount];
+	}
+
+	pcLine[uiPos++] = ',';
+
+	return uiPos;
+}
+
+
+static unsigned char
+_NRF24L01_BenchTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+						unsigned char *pucRxData, unsigned int uiLength)
+{
+	tNRF24L01Bench *psBench = (tNRF24L01Bench *)pvContext;
+	unsigned long ulStart = psBench->pfnGetTimeUs(psBench->pvArg);
+	unsigned char ucStatus;
+
+	ucStatus = psBench->psHAL->pfnTransfer(psBench->pvHALContext, ucCommand, pucTxData, pucRxData, uiLength);
+
+	psBench->ulSPITimeUs += psBench->pfnGetTimeUs(psBench->pvArg) - ulStart;
+
+	return ucStatus;
+}
+
+
+static void
+_NRF24L01_BenchSetCE(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01Bench *psBench = (tNRF24L01Bench *)pvContext;
+
+	psBench->psHAL->pfnSetCE(psBench->pvHALContext, ucLevel);
+}
+
+
+static void
+_NRF24L01_BenchSetCSN(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01Bench *psBench = (tNRF24L01Bench *)pvContext;
+
+	if(psBench->psHAL->pfnSetCSN)
+	{
+		psBench->psHAL->pfnSetCSN(psBench->pvHALContext, ucLevel);
+	}
+}
+
+
+static int
+_NRF24L01_BenchWaitIRQ(void *pvContext, unsigned long ulTimeoutUs)
+{
+	tNRF24L01Bench *psBench = (tNRF24L01Bench *)pvContext;
+
+	/* PS: Without one the driver polls STATUS, same as IRQ active */
+	if(NULL == psBench->psHAL->pfnWaitIRQ)
+	{
+		return 1;
+	}
+
+	return psBench->psHAL->pfnWaitIRQ(psBench->pvHALContext, ulTimeoutUs);
+}
+
+
+static int
+_NRF24L01_BenchGetIRQ(void *pvContext)
+{
+	tNRF24L01Bench *psBench = (tNRF24L01Bench *)pvContext;
+
+	if(NULL == psBench->psHAL->pfnGetIRQ)
+	{
+		return 0;
+	}
+
+	return psBench->psHAL->pfnGetIRQ(psBench->pvHALContext);
+}
+
+
+/* PS: The clock of the benchmark, the backend may have none */
+static unsigned long
+_NRF24L01_BenchGetTimeUs(void *pvContext)
+{
+	tNRF24L01Bench *psBench = (tNRF24L01Bench *)pvContext;
+
+	return psBench->pfnGetTimeUs(psBench->pvArg);
+}
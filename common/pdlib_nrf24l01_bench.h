@@ -0,0 +1,102 @@
+#ifndef _PDLIB_NRF24L01_BENCH
+#define _PDLIB_NRF24L01_BENCH
+
+#include "pdlib_nrf24l01.h"
+
+/* PS: Throughput and latency benchmark of the driver, see pdlib_nrf24l01_bench.c.
+ * Needs NRF24L01_CONF_HAL: the SPI time is measured by sitting between the driver and
+ * the backend of the PTX. */
+
+#ifndef NRF24L01_CONF_HAL
+#error "The benchmark needs NRF24L01_CONF_HAL"
+#endif
+
+/* PS: Latency samples kept for the percentiles, packets per configuration are limited to it */
+#ifndef PDLIB_NRF24_BENCH_MAX_PACKETS
+#define PDLIB_NRF24_BENCH_MAX_PACKETS	256
+#endif
+
+/* PS: Latency histogram, bucket i counts latencies below (256 << i) us, the last one the rest */
+#define PDLIB_NRF24_BENCH_BUCKETS		8
+
+/* PS: ucModes of tNRF24L01BenchSweep */
+#define PDLIB_NRF24_BENCH_STATIC		(1 << 0)	// Static payload length (RX_PW)
+#define PDLIB_NRF24_BENCH_DYNAMIC		(1 << 1)	// Dynamic payload length (DPL)
+#define PDLIB_NRF24_BENCH_ACK			(1 << 2)	// Auto ACK and retransmissions
+#define PDLIB_NRF24_BENCH_NOACK			(1 << 3)	// Auto ACK off on both radios
+#define PDLIB_NRF24_BENCH_NOACK_TX		(1 << 4)	// Auto ACK on, payloads sent with W_TX_PAYLOAD_NOACK
+
+/* PS: What to sweep. Every combination is run, ARD and ARC only with ACK. */
+typedef struct
+{
+	unsigned char ucPayloadMin;			// 1 to 32
+	unsigned char ucPayloadMax;
+	unsigned char ucPayloadStep;
+	const unsigned char *pucDataRate;	// Values for NRF24L01_SetAirDataRate
+	unsigned char ucDataRateCount;
+	const unsigned short *pusARD;		// Values for NRF24L01_SetARD
+	unsigned char ucARDCount;
+	const unsigned char *pucARC;		// Values for NRF24L01_SetARC
+	unsigned char ucARCCount;
+	unsigned char ucModes;				// PDLIB_NRF24_BENCH_*
+	unsigned int uiPackets;				// Per combination, up to PDLIB_NRF24_BENCH_MAX_PACKETS
+}tNRF24L01BenchSweep;
+
+/* PS: Result of one combination */
+typedef struct
+{
+	unsigned int uiRateKbps;			// Read back from RF_SETUP
+	unsigned char ucPayload;
+	unsigned char ucDynamic;
+	unsigned char ucAck;				// 1: ACK, 0: auto ACK off, 2: W_TX_PAYLOAD_NOACK
+	unsigned short usARD;
+	unsigned char ucARC;
+	unsigned int uiPackets;
+	unsigned int uiSent;				// NRF24L01_SendData succeeded (TX_DS)
+	unsigned int uiFailed;
+	unsigned int uiReceived;			// Read from the PRX, uiSent without a PRX
+	unsigned long ulRetries;			// ARC_CNT summed over the packets
+	unsigned long ulBusyUs;				// Sum of the latencies
+	unsigned long ulPacketsPerSecond;	// Sent packets over ulBusyUs
+	unsigned long ulGoodput;			// Received payload bytes per second over ulBusyUs
+	unsigned long ulSPIUs;				// SPI time per packet
+	unsigned long ulLatencyUs[5];		// Min, p50, p90, p99, max
+	unsigned int uiHistogram[PDLIB_NRF24_BENCH_BUCKETS];
+}tNRF24L01BenchResult;
+
+typedef struct
+{
+	/* PS: Free running microsecond clock, mandatory */
+	unsigned long (*pfnGetTimeUs)(void *pvArg);
+
+	/* PS: Prints one line without the line ending, mandatory */
+	void (*pfnPrint)(void *pvArg, const char *pcLine);
+
+	/* PS: Called after every combination, may be NULL */
+	void (*pfnResult)(void *pvArg, const tNRF24L01BenchResult *psResult);
+
+	void *pvArg;
+
+	/* PS: Backend of the PTX, the driver talks to it through g_sNRF24L01BenchHAL */
+	const tNRF24L01HAL *psHAL;
+	void *pvHALContext;
+	unsigned long ulSPITimeUs;
+
+	unsigned long ulLatencyUs[PDLIB_NRF24_BENCH_MAX_PACKETS];
+	tNRF24L01BenchResult sResult;
+	char cLine[320];
+}tNRF24L01Bench;
+
+/* PS: Backend which times the SPI transfers of the backend given to NRF24L01_BenchInit.
+ * Pass the tNRF24L01Bench as its context to NRF24L01_InitHAL. */
+extern const tNRF24L01HAL g_sNRF24L01BenchHAL;
+
+/* PS: Payload 1 to 32, both data rates, ARD 250/500/1000 us, ARC 0/3/15, all modes, 100 packets */
+extern const tNRF24L01BenchSweep g_sNRF24L01BenchDefaultSweep;
+
+void NRF24L01_BenchInit(tNRF24L01Bench *psBench, const tNRF24L01HAL *psHAL, void *pvHALContext,
+						unsigned long (*pfnGetTimeUs)(void *pvArg), void (*pfnPrint)(void *pvArg, const char *pcLine),
+						void *pvArg);
+int NRF24L01_BenchRun(tNRF24L01Bench *psBench, tNRF24L01 *psPTX, tNRF24L01 *psPRX, const tNRF24L01BenchSweep *psSweep);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef _PDLIB_NRF24L01_HAL
+#define _PDLIB_NRF24L01_HAL
+
+/* PS: Backend interface of the driver, used when NRF24L01_CONF_HAL is defined.
+ *
+ * A backend is a constant table of functions plus a context pointer owned by the
+ * backend (pins, file descriptors, ...). Several radios can share one table, each
+ * with its own context. See NRF24L01_InitHAL.
+ *
+ * Backends shipped with the library:
+ *
+ * 	Stellaris LM4F120H5QR	: arm/stellaris_lm4f120h5qr/pdlib_nrf24l01_hal_stellaris.c
+ * 	Linux spidev + GPIO		: linux/pdlib_nrf24l01_hal_linux.c
+ * 	In-process fake			: common/pdlib_nrf24l01_hal_fake.c
+ * 	Simulated chip			: common/pdlib_nrf24l01_sim.c
+ * 	Fake SSI with FIFOs		: common/pdlib_nrf24l01_ssi_fake.c (in front of another backend)
+ */
+
+/* PS: Pass as the timeout of pfnWaitIRQ to wait without a limit */
+#define PDLIB_NRF24_HAL_WAIT_FOREVER	0
+
+typedef struct
+{
+	/* PS: One SPI transaction, CSN low for the whole of it. The command byte is followed by
+	 * uiLength data bytes. pucTxData NULL sends RF24_NOP, pucRxData NULL discards the data.
+	 * Returns the STATUS register clocked out with the command byte. Mandatory. */
+	unsigned char (*pfnTransfer)(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+								 unsigned char *pucRxData, unsigned int uiLength);
+
+	/* PS: Drives CE, 0 is low. Mandatory. */
+	void (*pfnSetCE)(void *pvContext, unsigned char ucLevel);
+
+	/* PS: Drives CSN, 0 is low. pfnTransfer frames CSN itself, the driver only parks CSN
+	 * high at init. NULL if the SPI controller owns the chip select (eg. spidev). */
+	void (*pfnSetCSN)(void *pvContext, unsigned char ucLevel);
+
+	/* PS: Waits until the IRQ pin is low (active) or ulTimeoutUs is over.
+	 * Returns 1 if IRQ is active, 0 on timeout. NULL to make the driver poll STATUS. */
+	int (*pfnWaitIRQ)(void *pvContext, unsigned long ulTimeoutUs);
+
+	/* PS: Free running microsecond clock, wraps around. NULL if there is none. */
+	unsigned long (*pfnGetTimeUs)(void *pvContext);
+
+	/* PS: SSI FIFOs for the interrupt driven SPI engine (NRF24L01_CONF_SPI_ENGINE), NULL if the
+	 * backend has none. pfnFifoPut queues one byte, 0 if the TX FIFO is full. pfnFifoGet takes one
+	 * received byte, 0 if the RX FIFO is empty. pfnFifoInt enables (1) or masks (0) the interrupt
+	 * raised while received bytes wait, its handler calls NRF24L01_SPIEngineService. The engine
+	 * frames CSN with pfnSetCSN. */
+	int (*pfnFifoPut)(void *pvContext, unsigned char ucData);
+	int (*pfnFifoGet)(void *pvContext, unsigned char *pucData);
+	void (*pfnFifoInt)(void *pvContext, unsigned char ucEnable);
+
+	/* PS: Reads the IRQ pin without waiting. Returns 1 if IRQ is active, 0 if it is not or
+	 * cannot be read. With it the driver reads and clears a flag in one write instead of a
+	 * NOP and a write. NULL if the backend cannot read the pin. */
+	int (*pfnGetIRQ)(void *pvContext);
+}tNRF24L01HAL;
+
+#endif
@@ -0,0 +1,275 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * NRF24L01_CONF_HAL backend which keeps the radio in RAM. Registers read
+ * back what was written, STATUS flags clear on write-1 and IRQ follows
+ * STATUS and the CONFIG masks. There is no RF side: payloads are only
+ * recorded. It counts transfers and SPI bytes, so the SPI cost of a
+ * driver call can be measured on any machine.
+ *
+ * Tests which need other answers install a handler
+ * (NRF24L01_FakeHALSetHandler) or change the register file directly.
+ *
+ * Git repo:
+ *
+ * https://github.com/pradeepa-s/pdlib_nrf24l01.git
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_hal_fake.h"
+
+#define FAKE_DEFAULT_BITRATE	8000000
+
+static unsigned char _NRF24L01_FakeTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+											unsigned char *pucRxData, unsigned int uiLength);
+static void _NRF24L01_FakeSetCE(void *pvContext, unsigned char ucLevel);
+static void _NRF24L01_FakeSetCSN(void *pvContext, unsigned char ucLevel);
+static int _NRF24L01_FakeWaitIRQ(void *pvContext, unsigned long ulTimeoutUs);
+static unsigned long _NRF24L01_FakeGetTimeUs(void *pvContext);
+static int _NRF24L01_FakeGetIRQ(void *pvContext);
+static unsigned char _NRF24L01_FakeRegisterFile(void *pvArg, unsigned char ucCommand, unsigned char *pucTxData,
+												unsigned char *pucRxData, unsigned int uiLength);
+
+const tNRF24L01HAL g_sNRF24L01FakeHAL =
+{
+	_NRF24L01_FakeTransfer,
+	_NRF24L01_FakeSetCE,
+	_NRF24L01_FakeSetCSN,
+	_NRF24L01_FakeWaitIRQ,
+	_NRF24L01_FakeGetTimeUs,
+	NULL,
+	NULL,
+	NULL,
+	_NRF24L01_FakeGetIRQ
+};
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FakeHALInit
+ *
+ * Arguments	: 	psFake	:	Fake radio, pass it to NRF24L01_InitHAL as the context
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Resets the registers to their datasheet reset values, CE low,
+ * 					CSN high, counters and clock zero.
+ *
+ */
+
+void
+NRF24L01_FakeHALInit(tNRF24L01FakeHAL *psFake)
+{
+	unsigned char ucPipe;
+
+	memset(psFake, 0, sizeof(tNRF24L01FakeHAL));
+
+	psFake->ucRegister[RF24_CONFIG][0] = 0x08;
+	psFake->ucRegister[RF24_EN_AA][0] = 0x3F;
+	psFake->ucRegister[RF24_EN_RXADDR][0] = 0x03;
+	psFake->ucRegister[RF24_SETUP_AW][0] = 0x03;
+	psFake->ucRegister[RF24_SETUP_RETR][0] = 0x03;
+	psFake->ucRegister[RF24_RF_CH][0] = 0x02;
+	psFake->ucRegister[RF24_RF_SETUP][0] = 0x0F;
+	psFake->ucRegister[RF24_STATUS][0] = 0x0E;
+	psFake->ucRegister[RF24_FIFO_STATUS][0] = 0x11;
+
+	memset(psFake->ucRegister[RF24_RX_ADDR_P0], 0xE7, 5);
+	memset(psFake->ucRegister[RF24_RX_ADDR_P1], 0xC2, 5);
+	memset(psFake->ucRegister[RF24_TX_ADDR], 0xE7, 5);
+
+	for(ucPipe = 2; ucPipe < 6; ucPipe++)
+	{
+		psFake->ucRegister[RF24_RX_ADDR_P0 + ucPipe][0] = 0xC1 + ucPipe;
+	}
+
+	psFake->ucCSN = 1;
+	psFake->ulSPIBitRate = FAKE_DEFAULT_BITRATE;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FakeHALSetHandler
+ *
+ * Arguments	: 	psFake		:	Fake radio
+ * 					pfnHandler	:	Called for every transfer instead of the register file, NULL to restore it
+ * 					pvArg		:	Passed to pfnHandler
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Lets a test script the answers of the radio. The clock and the
+ * 					counters keep running.
+ *
+ */
+
+void
+NRF24L01_FakeHALSetHandler(tNRF24L01FakeHAL *psFake, tNRF24L01FakeHandler pfnHandler, void *pvArg)
+{
+	psFake->pfnHandler = pfnHandler;
+	psFake->pvHandlerArg = pvArg;
+}
+
+
+static unsigned char
+_NRF24L01_FakeTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+					   unsigned char *pucRxData, unsigned int uiLength)
+{
+	tNRF24L01FakeHAL *psFake = (tNRF24L01FakeHAL *)pvContext;
+
+	psFake->ulTransfers++;
+	psFake->ulBytes += uiLength + 1;
+	psFake->ulTimeUs += (unsigned long)(((unsigned long long)(uiLength + 1) * 8 * 1000000) / psFake->ulSPIBitRate);
+
+	if(psFake->pfnHandler)
+	{
+		return psFake->pfnHandler(psFake->pvHandlerArg, ucCommand, pucTxData, pucRxData, uiLength);
+	}
+
+	return _NRF24L01_FakeRegisterFile(psFake, ucCommand, pucTxData, pucRxData, uiLength);
+}
+
+
+static void
+_NRF24L01_FakeSetCE(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01FakeHAL *psFake = (tNRF24L01FakeHAL *)pvContext;
+
+	if(ucLevel && !psFake->ucCE)
+	{
+		psFake->ulCEPulses++;
+	}
+
+	psFake->ucCE = ucLevel ? 1 : 0;
+}
+
+
+static void
+_NRF24L01_FakeSetCSN(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01FakeHAL *psFake = (tNRF24L01FakeHAL *)pvContext;
+
+	psFake->ucCSN = ucLevel ? 1 : 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_FakeWaitIRQ
+ *
+ * Arguments	: 	See pfnWaitIRQ in pdlib_nrf24l01_hal.h
+ *
+ * Return		: 	1 if IRQ is active, 0 otherwise
+ *
+ * Description	: 	Nothing changes the fake while the caller waits, so it never
+ * 					blocks. On a timeout the clock is moved forward by ulTimeoutUs.
+ *
+ */
+
+static int
+_NRF24L01_FakeWaitIRQ(void *pvContext, unsigned long ulTimeoutUs)
+{
+	tNRF24L01FakeHAL *psFake = (tNRF24L01FakeHAL *)pvContext;
+	unsigned char ucFlags;
+
+	/* PS: IRQ is low while a flag is set and not masked in CONFIG */
+	ucFlags = psFake->ucRegister[RF24_STATUS][0] & ~psFake->ucRegister[RF24_CONFIG][0] &
+			  (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT);
+
+	if(ucFlags)
+	{
+		return 1;
+	}
+
+	psFake->ulTimeUs += ulTimeoutUs;
+
+	return 0;
+}
+
+
+static unsigned long
+_NRF24L01_FakeGetTimeUs(void *pvContext)
+{
+	return ((tNRF24L01FakeHAL *)pvContext)->ulTimeUs;
+}
+
+
+static int
+_NRF24L01_FakeGetIRQ(void *pvContext)
+{
+	tNRF24L01FakeHAL *psFake = (tNRF24L01FakeHAL *)pvContext;
+
+	return (psFake->ucRegister[RF24_STATUS][0] & ~psFake->ucRegister[RF24_CONFIG][0] &
+			(RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT)) ? 1 : 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_FakeRegisterFile
+ *
+ * Arguments	: 	pvArg	:	Fake radio
+ * 					Others as pfnTransfer in pdlib_nrf24l01_hal.h
+ *
+ * Return		: 	Status register value
+ *
+ * Description	: 	Default handler. Register reads and writes, write-1-to-clear
+ * 					STATUS flags and read only registers. Payload writes are
+ * 					recorded, payload reads return zeros.
+ *
+ */
+
+static unsigned char
+_NRF24L01_FakeRegisterFile(void *pvArg, unsigned char ucCommand, unsigned char *pucTxData,
+						   unsigned char *pucRxData, unsigned int uiLength)
+{
+	tNRF24L01FakeHAL *psFake = (tNRF24L01FakeHAL *)pvArg;
+	unsigned char ucStatus = psFake->ucRegister[RF24_STATUS][0];
+	unsigned char ucRegister = ucCommand & RF24_REGISTER_MASK;
+	unsigned int uiIndex;
+
+	if(ucCommand <= (RF24_R_REGISTER | RF24_REGISTER_MASK))
+	{
+		if(pucRxData && (ucRegister <= RF24_FEATURE))
+		{
+			for(uiIndex = 0; uiIndex < uiLength; uiIndex++)
+			{
+				pucRxData[uiIndex] = (uiIndex < 5) ? psFake->ucRegister[ucRegister][uiIndex] : 0;
+			}
+		}
+	}else if(ucCommand <= (RF24_W_REGISTER | RF24_REGISTER_MASK))
+	{
+		if(pucTxData && (uiLength > 0) && (ucRegister <= RF24_FEATURE))
+		{
+			if(RF24_STATUS == ucRegister)
+			{
+				psFake->ucRegister[RF24_STATUS][0] &= ~(pucTxData[0] & (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT));
+			}else if((RF24_OBSERVE_TX != ucRegister) && (RF24_CD != ucRegister) && (RF24_FIFO_STATUS != ucRegister))
+			{
+				for(uiIndex = 0; (uiIndex < uiLength) && (uiIndex < 5); uiIndex++)
+				{
+					psFake->ucRegister[ucRegister][uiIndex] = pucTxData[uiIndex];
+				}
+			}
+		}
+	}else if(((ucCommand & 0xF8) == RF24_W_ACK_PAYLOAD) || (RF24_W_TX_PAYLOAD == ucCommand) ||
+			 (RF24_W_TX_PAYLOAD_NOACK == ucCommand))
+	{
+		psFake->ucLastPayloadLength = (uiLength > 32) ? 32 : (unsigned char)uiLength;
+
+		if(pucTxData)
+		{
+			memcpy(psFake->ucLastPayload, pucTxData, psFake->ucLastPayloadLength);
+		}
+	}else if(pucRxData)
+	{
+		/* PS: R_RX_PAYLOAD, R_RX_PL_WID and unknown commands */
+		memset(pucRxData, 0, uiLength);
+	}
+
+	return ucStatus;
+}
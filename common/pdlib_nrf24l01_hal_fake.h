@@ -0,0 +1,34 @@
+#ifndef _PDLIB_NRF24L01_HAL_FAKE
+#define _PDLIB_NRF24L01_HAL_FAKE
+
+#include "nRF24L01.h"
+#include "pdlib_nrf24l01_hal.h"
+
+/* PS: Replaces the register file of the fake. Returns the STATUS to clock out with the command */
+typedef unsigned char (*tNRF24L01FakeHandler)(void *pvArg, unsigned char ucCommand, unsigned char *pucTxData,
+											  unsigned char *pucRxData, unsigned int uiLength);
+
+/* PS: In-process fake radio (see NRF24L01_FakeHALInit). All members can be read and
+ * changed by the test between driver calls. */
+typedef struct
+{
+	unsigned char ucRegister[RF24_FEATURE + 1][5];	// Register file, LSByte first
+	unsigned char ucLastPayload[32];				// Last W_TX_PAYLOAD / W_ACK_PAYLOAD / W_TX_PAYLOAD_NOACK
+	unsigned char ucLastPayloadLength;
+	unsigned char ucCE;
+	unsigned char ucCSN;
+	unsigned long ulTimeUs;				// Fake clock, advanced by the SPI time of every transfer
+	unsigned long ulSPIBitRate;			// Used to advance the clock
+	unsigned long ulTransfers;			// pfnTransfer calls
+	unsigned long ulBytes;				// SPI bytes moved, command bytes included
+	unsigned long ulCEPulses;			// CE low to high edges
+	tNRF24L01FakeHandler pfnHandler;	// NULL for the register file
+	void *pvHandlerArg;
+}tNRF24L01FakeHAL;
+
+extern const tNRF24L01HAL g_sNRF24L01FakeHAL;
+
+void NRF24L01_FakeHALInit(tNRF24L01FakeHAL *psFake);
+void NRF24L01_FakeHALSetHandler(tNRF24L01FakeHAL *psFake, tNRF24L01FakeHandler pfnHandler, void *pvArg);
+
+#endif
@@ -0,0 +1,1523 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Simulated nRF24L01 for host builds. It is a NRF24L01_CONF_HAL backend,
+ * so the driver runs unchanged on top of it:
+ *
+ * 	NRF24L01_SimInit(&sSim);
+ * 	NRF24L01_InitHAL(&sRadio, &g_sNRF24L01SimHAL, &sSim);
+ *
+ * Modelled:
+ *
+ * 	- Every register of nRF24L01.h with its reset value, read only and
+ * 	  write-1-to-clear bits, 3 to 5 byte addresses (P2 to P5 share P1).
+ * 	- 3 deep TX and RX FIFOs, FIFO_STATUS, TX_FULL and RX_P_NO.
+ * 	- STATUS flags and the IRQ pin with the CONFIG masks.
+ * 	- ACTIVATE: FEATURE, DYNPD, R_RX_PL_WID, W_ACK_PAYLOAD and
+ * 	  W_TX_PAYLOAD_NOACK do nothing until it is sent.
+ * 	- Static and dynamic payload lengths, ACK payloads, NO_ACK packets,
+ * 	  REUSE_TX_PL, PID based duplicate detection.
+ * 	- Power Down, Start up, Standby I/II, TX/RX settling, TX and RX with
+ * 	  the datasheet timings, auto retransmit from SETUP_RETR (ARD measured
+ * 	  from the end of a packet, ARC, OBSERVE_TX counters, MAX_RT blocking
+ * 	  the FIFO until it is cleared).
+ * 	- Air time of every packet from the address width, CRC length and
+ * 	  air data rate. SPI transactions take the time of their bytes at
+ * 	  ulSPIBitRate.
+ *
+ * Time only moves when the driver talks to the chip (SPI time) or waits
+ * for IRQ, so the result of a run does not depend on the host machine.
+ * Commands the chip would ignore or misbehave on (eg. W_REGISTER while in
+ * TX) are done anyway and counted in ulViolations.
+ *
+ * A lone radio hears nothing and gets no ACK. tNRF24L01SimAir connects
+ * radios (see NRF24L01_SimAttach), or a test can hand packets straight
+ * to NRF24L01_SimReceive.
+ *
+ * Git repo:
+ *
+ * https://github.com/pradeepa-s/pdlib_nrf24l01.git
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_sim.h"
+
+#define SIM_NEVER				(~0ULL)
+#define SIM_DEFAULT_BITRATE		8000000
+
+/* PS: ucTxFlags */
+#define SIM_TX_NOACK			0x01
+#define SIM_TX_ACK_PAYLOAD		0x02
+#define SIM_TX_PIPE_SHIFT		4
+
+#define SIM_STATUS_FLAGS		((RF24_RX_DR) | (RF24_TX_DS) | (RF24_MAX_RT))
+
+static unsigned char _NRF24L01_SimTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+										   unsigned char *pucRxData, unsigned int uiLength);
+static void _NRF24L01_SimSetCE(void *pvContext, unsigned char ucLevel);
+static void _NRF24L01_SimSetCSN(void *pvContext, unsigned char ucLevel);
+static int _NRF24L01_SimWaitIRQ(void *pvContext, unsigned long ulTimeoutUs);
+static unsigned long _NRF24L01_SimGetTimeUs(void *pvContext);
+static int _NRF24L01_SimReadIRQ(void *pvContext);
+
+static void _NRF24L01_SimElapse(tNRF24L01Sim *psSim, unsigned long long ullTimeUs);
+static void _NRF24L01_SimSetState(tNRF24L01Sim *psSim, unsigned char ucState, unsigned long long ullDurationUs);
+static void _NRF24L01_SimEvaluate(tNRF24L01Sim *psSim);
+static void _NRF24L01_SimTimeout(tNRF24L01Sim *psSim);
+static void _NRF24L01_SimStartTx(tNRF24L01Sim *psSim);
+static void _NRF24L01_SimEndTx(tNRF24L01Sim *psSim);
+static void _NRF24L01_SimTxDone(tNRF24L01Sim *psSim, unsigned char ucDelivered);
+static int _NRF24L01_SimTxReady(tNRF24L01Sim *psSim);
+static void _NRF24L01_SimTxPop(tNRF24L01Sim *psSim, unsigned char ucIndex);
+static int _NRF24L01_SimRxPush(tNRF24L01Sim *psSim, unsigned char ucPipe, const unsigned char *pucData, unsigned char ucLength);
+static void _NRF24L01_SimRxPop(tNRF24L01Sim *psSim);
+static unsigned char _NRF24L01_SimStatus(tNRF24L01Sim *psSim);
+static unsigned char _NRF24L01_SimFifoStatus(tNRF24L01Sim *psSim);
+static unsigned char _NRF24L01_SimAddressWidth(tNRF24L01Sim *psSim);
+static unsigned char _NRF24L01_SimCRCLength(tNRF24L01Sim *psSim);
+static unsigned char _NRF24L01_SimDataRate(tNRF24L01Sim *psSim);
+static unsigned long _NRF24L01_SimARDUs(tNRF24L01Sim *psSim);
+static int _NRF24L01_SimIsStandby(tNRF24L01Sim *psSim);
+static void _NRF24L01_SimViolation(tNRF24L01Sim *psSim, const char *pcWhat);
+static void _NRF24L01_SimReadRegister(tNRF24L01Sim *psSim, unsigned char ucRegister, unsigned char *pucData, unsigned int uiLength);
+static void _NRF24L01_SimWriteRegister(tNRF24L01Sim *psSim, unsigned char ucRegister, unsigned char *pucData, unsigned int uiLength);
+static void _NRF24L01_SimCommand(tNRF24L01Sim *psSim, unsigned char ucCommand, unsigned char *pucTxData,
+								 unsigned char *pucRxData, unsigned int uiLength);
+static unsigned short _NRF24L01_SimCRC(const unsigned char *pucData, unsigned char ucLength);
+
+const tNRF24L01HAL g_sNRF24L01SimHAL =
+{
+	_NRF24L01_SimTransfer,
+	_NRF24L01_SimSetCE,
+	_NRF24L01_SimSetCSN,
+	_NRF24L01_SimWaitIRQ,
+	_NRF24L01_SimGetTimeUs,
+	NULL,
+	NULL,
+	NULL,
+	_NRF24L01_SimReadIRQ
+};
+
+/* PS: Writable bits of every register, 0 for read only and reserved */
+static const unsigned char g_ucWriteMask[RF24_FEATURE + 1] =
+{
+	0x7F, 0x3F, 0x3F, 0x03, 0xFF, 0x7F, 0x3F, 0x70,		// CONFIG to STATUS
+	0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,		// OBSERVE_TX to RX_ADDR_P5
+	0xFF, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x00,		// TX_ADDR to FIFO_STATUS
+	0x00, 0x00, 0x00, 0x00, 0x3F, 0x07					// Reserved, DYNPD, FEATURE
+};
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimInit
+ *
+ * Arguments	: 	psSim	:	Simulated radio, pass it to NRF24L01_InitHAL as the context
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Puts the chip into its power on state: reset register values,
+ * 					Power Down, empty FIFOs, CE low, CSN high. Time and counters
+ * 					start from zero and the radio is not on any air.
+ *
+ */
+
+void
+NRF24L01_SimInit(tNRF24L01Sim *psSim)
+{
+	unsigned char ucPipe;
+
+	memset(psSim, 0, sizeof(tNRF24L01Sim));
+
+	psSim->ucRegister[RF24_CONFIG] = 0x08;
+	psSim->ucRegister[RF24_EN_AA] = 0x3F;
+	psSim->ucRegister[RF24_EN_RXADDR] = 0x03;
+	psSim->ucRegister[RF24_SETUP_AW] = 0x03;
+	psSim->ucRegister[RF24_SETUP_RETR] = 0x03;
+	psSim->ucRegister[RF24_RF_CH] = 0x02;
+	psSim->ucRegister[RF24_RF_SETUP] = 0x0F;
+
+	memset(psSim->ucAddress[0], 0xE7, 5);
+	memset(psSim->ucAddress[1], 0xC2, 5);
+	memset(psSim->ucAddress[6], 0xE7, 5);
+
+	for(ucPipe = 2; ucPipe < 6; ucPipe++)
+	{
+		psSim->ucAddress[ucPipe][0] = 0xC1 + ucPipe;
+	}
+
+	for(ucPipe = 0; ucPipe < 6; ucPipe++)
+	{
+		psSim->ucLastRxPID[ucPipe] = 0xFF;
+	}
+
+	psSim->ucCSN = 1;
+	psSim->ulSPIBitRate = SIM_DEFAULT_BITRATE;
+	psSim->ucState = PDLIB_NRF24_SIM_POWER_DOWN;
+	psSim->ullDeadlineUs = SIM_NEVER;
+	psSim->pcLastViolation = "";
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimAttach
+ *
+ * Arguments	: 	psSim	:	Simulated radio
+ * 					psAir	:	Air the radio sends on and is advanced by, NULL to detach
+ * 					pvAir	:	Passed to the functions of psAir
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The air owns the time of the radios attached to it: every wait
+ * 					of one radio runs all of them (pfnAdvance).
+ *
+ */
+
+void
+NRF24L01_SimAttach(tNRF24L01Sim *psSim, const tNRF24L01SimAir *psAir, void *pvAir)
+{
+	psSim->psAir = psAir;
+	psSim->pvAir = pvAir;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimRun
+ *
+ * Arguments	: 	psSim		:	Simulated radio
+ * 					ullTimeUs	:	Time to run to
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Runs the state machine of this radio only, up to ullTimeUs. Time
+ * 					never goes back. Meant for an air implementation (pfnAdvance),
+ * 					the backend functions advance the time by themselves.
+ *
+ */
+
+void
+NRF24L01_SimRun(tNRF24L01Sim *psSim, unsigned long long ullTimeUs)
+{
+	while(psSim->ullDeadlineUs <= ullTimeUs)
+	{
+		if(psSim->ullDeadlineUs > psSim->ullTimeUs)
+		{
+			psSim->ullTimeUs = psSim->ullDeadlineUs;
+		}
+
+		_NRF24L01_SimTimeout(psSim);
+	}
+
+	if(ullTimeUs > psSim->ullTimeUs)
+	{
+		psSim->ullTimeUs = ullTimeUs;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimNextEvent
+ *
+ * Arguments	: 	psSim	:	Simulated radio
+ *
+ * Return		: 	Time of the next state change of the radio, ~0 if it waits for
+ * 					the driver or the air
+ *
+ */
+
+unsigned long long
+NRF24L01_SimNextEvent(tNRF24L01Sim *psSim)
+{
+	return psSim->ullDeadlineUs;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimReceive
+ *
+ * Arguments	: 	psSim		:	Simulated radio
+ * 					psPacket	:	Packet which reached the radio, ullEndUs is when it is over
+ * 					psAck		:	Filled with the ACK if one is sent, may be NULL
+ *
+ * Return		: 	1 if the radio sends an ACK, 0 otherwise
+ *
+ * Description	: 	The radio takes the packet only if it was in RX for the whole
+ * 					packet on the same channel, data rate, address width and CRC, the
+ * 					address matches an enabled pipe and the length matches RX_PW_Px
+ * 					(or the pipe has dynamic payload). Auto ACK, ACK payloads and
+ * 					duplicate detection work as on the chip. The radio is run up to
+ * 					the end of the packet first.
+ *
+ */
+
+int
+NRF24L01_SimReceive(tNRF24L01Sim *psSim, const tNRF24L01SimPacket *psPacket, tNRF24L01SimPacket *psAck)
+{
+	unsigned char ucPipe;
+	unsigned char ucIndex;
+	unsigned char ucWidth;
+	unsigned char ucAutoAck;
+	unsigned char ucDynamic;
+	unsigned short usCRC;
+	tNRF24L01SimPacket sAck;
+
+	NRF24L01_SimRun(psSim, psPacket->ullEndUs);
+
+	ucWidth = _NRF24L01_SimAddressWidth(psSim);
+
+	if((PDLIB_NRF24_SIM_RX != psSim->ucState) || (psSim->ullStateStartUs > psPacket->ullStartUs) ||
+	   (psPacket->ucChannel != psSim->ucRegister[RF24_RF_CH]) ||
+	   (psPacket->ucDataRate != _NRF24L01_SimDataRate(psSim)) ||
+	   (psPacket->ucCRCLength != _NRF24L01_SimCRCLength(psSim)) ||
+	   (psPacket->ucAddressWidth != ucWidth))
+	{
+		return 0;
+	}
+
+	/* PS: Pipe with a matching address. P2 to P5 have only their LSByte, the rest comes from P1 */
+	for(ucPipe = 0; ucPipe < 6; ucPipe++)
+	{
+		if(0 == (psSim->ucRegister[RF24_EN_RXADDR] & (1 << ucPipe)))
+		{
+			continue;
+		}
+
+		if(psPacket->ucAddress[0] != psSim->ucAddress[ucPipe][0])
+		{
+			continue;
+		}
+
+		for(ucIndex = 1; ucIndex < ucWidth; ucIndex++)
+		{
+			if(psPacket->ucAddress[ucIndex] != psSim->ucAddress[(ucPipe < 2) ? ucPipe : 1][ucIndex])
+			{
+				break;
+			}
+		}
+
+		if(ucIndex == ucWidth)
+		{
+			break;
+		}
+	}
+
+	if(ucPipe >= 6)
+	{
+		return 0;
+	}
+
+	ucDynamic = (psSim->ucRegister[RF24_FEATURE] & (RF24_EN_DPL)) && (psSim->ucRegister[RF24_DYNPD] & (1 << ucPipe));
+
+	/* PS: A static pipe reads RX_PW_Px bytes, any other length fails the CRC */
+	if(!ucDynamic && ((psPacket->ucLength != psSim->ucRegister[RF24_RX_PW_P0 + ucPipe]) || (0 == psPacket->ucLength)))
+	{
+		return 0;
+	}
+
+	ucAutoAck = (psSim->ucRegister[RF24_EN_AA] & (1 << ucPipe)) && !psPacket->ucNoAck;
+	usCRC = _NRF24L01_SimCRC(psPacket->ucPayload, psPacket->ucLength);
+
+	if(ucAutoAck && (psPacket->ucPID == psSim->ucLastRxPID[ucPipe]) && (usCRC == psSim->usLastRxCRC[ucPipe]))
+	{
+		/* PS: The PTX missed our ACK and sent it again, ACK it without storing */
+		psSim->sStats.ulDuplicates++;
+	}else
+	{
+		if(0 == _NRF24L01_SimRxPush(psSim, ucPipe, psPacket->ucPayload, psPacket->ucLength))
+		{
+			/* PS: No ACK either, the PTX sends it again */
+			psSim->sStats.ulRxOverflows++;
+			return 0;
+		}
+
+		psSim->ucRegister[RF24_STATUS] |= (RF24_RX_DR);
+		psSim->sStats.ulPacketsReceived++;
+		psSim->ucLastRxPID[ucPipe] = psPacket->ucPID;
+		psSim->usLastRxCRC[ucPipe] = usCRC;
+	}
+
+	if(!ucAutoAck)
+	{
+		return 0;
+	}
+
+	memset(&sAck, 0, sizeof(sAck));
+	memcpy(sAck.ucAddress, psPacket->ucAddress, 5);
+	sAck.ucAddressWidth = psPacket->ucAddressWidth;
+	sAck.ucPID = psPacket->ucPID;
+	sAck.ucNoAck = 1;
+	sAck.ucChannel = psPacket->ucChannel;
+	sAck.ucDataRate = psPacket->ucDataRate;
+	sAck.ucCRCLength = psPacket->ucCRCLength;
+
+	/* PS: First ACK payload waiting for this pipe */
+	if(psSim->ucActivated && (psSim->ucRegister[RF24_FEATURE] & (RF24_EN_ACK_PAY)))
+	{
+		for(ucIndex = 0; ucIndex < psSim->ucTxCount; ucIndex++)
+		{
+			if((psSim->ucTxFlags[ucIndex] & SIM_TX_ACK_PAYLOAD) &&
+			   ((psSim->ucTxFlags[ucIndex] >> SIM_TX_PIPE_SHIFT) == ucPipe))
+			{
+				sAck.ucLength = psSim->ucTxLength[ucIndex];
+				memcpy(sAck.ucPayload, psSim->ucTxPayload[ucIndex], sAck.ucLength);
+				_NRF24L01_SimTxPop(psSim, ucIndex);
+
+				break;
+			}
+		}
+	}
+
+	sAck.ullStartUs = psPacket->ullEndUs + PDLIB_NRF24_SIM_TSTBY2A_US;
+	sAck.ullEndUs = sAck.ullStartUs + NRF24L01_SimAirTimeUs(sAck.ucDataRate, sAck.ucAddressWidth,
+															 sAck.ucCRCLength, sAck.ucLength);
+
+	psSim->sAck = sAck;
+	psSim->sStats.ulAcksSent++;
+	psSim->sStats.ullAirTimeUs += sAck.ullEndUs - sAck.ullStartUs;
+
+	_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_ACK_TX,
+						  (sAck.ullEndUs > psSim->ullTimeUs) ? (sAck.ullEndUs - psSim->ullTimeUs) : 0);
+
+	if(psAck)
+	{
+		*psAck = sAck;
+	}
+
+	return 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimReceiveAck
+ *
+ * Arguments	: 	psSim	:	Simulated radio waiting for an ACK
+ * 					psAck	:	ACK which reached the radio, ullEndUs is when it is over
+ *
+ * Return		: 	1 if the radio takes the ACK, 0 otherwise
+ *
+ * Description	: 	For an air which delivers ACKs later than the end of the packet
+ * 					(pfnTransmit returned 0). The ACK counts only if the radio is
+ * 					still waiting, it has the PID of the packet, the address of
+ * 					RX_ADDR_P0 and it is over within ARD from the end of the packet.
+ * 					The radio is run up to the end of the ACK first.
+ *
+ * 					The radio stops listening ARD - 130us after the packet to settle
+ * 					for the retransmission, but an ACK over by ARD still counts then
+ * 					(as with an ACK given by pfnTransmit); the retransmission is
+ * 					called off.
+ *
+ */
+
+int
+NRF24L01_SimReceiveAck(tNRF24L01Sim *psSim, const tNRF24L01SimPacket *psAck)
+{
+	unsigned char ucRetransmit;
+
+	NRF24L01_SimRun(psSim, psAck->ullEndUs);
+
+	/* PS: Settling right after the ACK window of sOnAir, not for a later packet */
+	ucRetransmit = (PDLIB_NRF24_SIM_TX_SETTLING == psSim->ucState) && (psSim->ucRegister[RF24_OBSERVE_TX] & 0x0F) &&
+				   (psSim->ullStateStartUs == (psSim->sOnAir.ullEndUs + _NRF24L01_SimARDUs(psSim) - PDLIB_NRF24_SIM_TSTBY2A_US));
+
+	if(((PDLIB_NRF24_SIM_ACK_WAIT != psSim->ucState) && !ucRetransmit) || psSim->ucAckPending ||
+	   (psAck->ucPID != psSim->sOnAir.ucPID) || (psAck->ucChannel != psSim->sOnAir.ucChannel) ||
+	   (psAck->ucDataRate != psSim->sOnAir.ucDataRate) || (psAck->ucAddressWidth != psSim->sOnAir.ucAddressWidth) ||
+	   (0 != memcmp(psAck->ucAddress, psSim->ucAddress[0], psAck->ucAddressWidth)) ||
+	   (psAck->ullEndUs > (psSim->sOnAir.ullEndUs + _NRF24L01_SimARDUs(psSim))))
+	{
+		return 0;
+	}
+
+	if(ucRetransmit)
+	{
+		psSim->ucRegister[RF24_OBSERVE_TX]--;
+		psSim->sStats.ulRetransmits--;
+
+		_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_ACK_WAIT, 0);
+	}
+
+	psSim->sAck = *psAck;
+	psSim->ucAckPending = 1;
+
+	/* PS: Taken on the next run, the ACK is over */
+	psSim->ullDeadlineUs = psSim->ullTimeUs;
+
+	return 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimIsListening
+ *
+ * Arguments	: 	psSim		:	Simulated radio
+ * 					ucChannel	:	RF channel
+ * 					ucDataRate	:	PDLIB_NRF24_SIM_RATE_*
+ *
+ * Return		: 	1 if the radio is in RX on the channel and data rate
+ *
+ */
+
+int
+NRF24L01_SimIsListening(tNRF24L01Sim *psSim, unsigned char ucChannel, unsigned char ucDataRate)
+{
+	return (PDLIB_NRF24_SIM_RX == psSim->ucState) && (ucChannel == psSim->ucRegister[RF24_RF_CH]) &&
+		   (ucDataRate == _NRF24L01_SimDataRate(psSim));
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimGetIRQ
+ *
+ * Arguments	: 	psSim	:	Simulated radio
+ *
+ * Return		: 	Level of the IRQ pin, 0 is active
+ *
+ */
+
+unsigned char
+NRF24L01_SimGetIRQ(tNRF24L01Sim *psSim)
+{
+	unsigned char ucFlags;
+
+	/* PS: A MASK_ bit in CONFIG keeps its flag off the pin, MASK_x and x are the same bit */
+	ucFlags = psSim->ucRegister[RF24_STATUS] & ~psSim->ucRegister[RF24_CONFIG] & SIM_STATUS_FLAGS;
+
+	return ucFlags ? 0 : 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimAirTimeUs
+ *
+ * Arguments	: 	ucDataRate		:	PDLIB_NRF24_SIM_RATE_*
+ * 					ucAddressWidth	:	3 to 5 bytes
+ * 					ucCRCLength		:	0 to 2 bytes
+ * 					ucLength		:	Payload length
+ *
+ * Return		: 	Time on air of one packet in microseconds, rounded up
+ *
+ * Description	: 	1 byte preamble, address, 9 bit packet control field, payload
+ * 					and CRC.
+ *
+ */
+
+unsigned long
+NRF24L01_SimAirTimeUs(unsigned char ucDataRate, unsigned char ucAddressWidth,
+					  unsigned char ucCRCLength, unsigned char ucLength)
+{
+	unsigned long ulBits = (8 * (1 + ucAddressWidth + ucLength + ucCRCLength)) + 9;
+
+	if(PDLIB_NRF24_SIM_RATE_2MBPS == ucDataRate)
+	{
+		return (ulBits + 1) / 2;
+	}
+
+	if(PDLIB_NRF24_SIM_RATE_250KBPS == ucDataRate)
+	{
+		return ulBits * 4;
+	}
+
+	return ulBits;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimGetStats
+ *
+ * Arguments	: 	psSim	:	Simulated radio
+ * 					psStats	:	Filled with the counters
+ *
+ * Return		: 	None
+ *
+ * Description	: 	ullStateTimeUs includes the time spent so far in the current state.
+ *
+ */
+
+void
+NRF24L01_SimGetStats(tNRF24L01Sim *psSim, tNRF24L01SimStats *psStats)
+{
+	*psStats = psSim->sStats;
+
+	psStats->ullStateTimeUs[psSim->ucState] += psSim->ullTimeUs - psSim->ullStateStartUs;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SimResetStats
+ *
+ * Arguments	: 	psSim	:	Simulated radio
+ *
+ * Return		: 	None
+ *
+ */
+
+void
+NRF24L01_SimResetStats(tNRF24L01Sim *psSim)
+{
+	memset(&psSim->sStats, 0, sizeof(tNRF24L01SimStats));
+
+	psSim->ullStateStartUs = psSim->ullTimeUs;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SimTransfer
+ *
+ * Arguments	: 	See pfnTransfer in pdlib_nrf24l01_hal.h
+ *
+ * Return		: 	Status register value at the start of the transaction
+ *
+ * Description	: 	The command takes effect when CSN goes high, after the SPI time
+ * 					of its bytes.
+ *
+ */
+
+static unsigned char
+_NRF24L01_SimTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+					  unsigned char *pucRxData, unsigned int uiLength)
+{
+	tNRF24L01Sim *psSim = (tNRF24L01Sim *)pvContext;
+	unsigned long long ullSPITimeUs;
+	unsigned char ucStatus;
+
+	ucStatus = _NRF24L01_SimStatus(psSim);
+
+	ullSPITimeUs = (((unsigned long long)(uiLength + 1) * 8 * 1000000) + psSim->ulSPIBitRate - 1) / psSim->ulSPIBitRate;
+
+	psSim->sStats.ulTransfers++;
+	psSim->sStats.ulSPIBytes += uiLength + 1;
+	psSim->sStats.ullSPITimeUs += ullSPITimeUs;
+
+	_NRF24L01_SimElapse(psSim, psSim->ullTimeUs + ullSPITimeUs);
+
+	_NRF24L01_SimCommand(psSim, ucCommand, pucTxData, pucRxData, uiLength);
+
+	return ucStatus;
+}
+
+
+static void
+_NRF24L01_SimSetCE(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01Sim *psSim = (tNRF24L01Sim *)pvContext;
+
+	ucLevel = ucLevel ? 1 : 0;
+
+	if(ucLevel && !psSim->ucCE)
+	{
+		psSim->sStats.ulCEPulses++;
+	}
+
+	psSim->ucCE = ucLevel;
+
+	_NRF24L01_SimEvaluate(psSim);
+}
+
+
+static void
+_NRF24L01_SimSetCSN(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01Sim *psSim = (tNRF24L01Sim *)pvContext;
+
+	psSim->ucCSN = ucLevel ? 1 : 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SimWaitIRQ
+ *
+ * Arguments	: 	See pfnWaitIRQ in pdlib_nrf24l01_hal.h
+ *
+ * Return		: 	1 if IRQ is active, 0 on timeout
+ *
+ * Description	: 	Jumps from event to event (of every radio on the air) until IRQ
+ * 					or the timeout. A wait without a limit and with nothing pending
+ * 					returns 0 after PDLIB_NRF24_SIM_IDLE_STEP_US, as on the chip
+ * 					waiting for a packet nobody sends never ends.
+ *
+ */
+
+static int
+_NRF24L01_SimWaitIRQ(void *pvContext, unsigned long ulTimeoutUs)
+{
+	tNRF24L01Sim *psSim = (tNRF24L01Sim *)pvContext;
+	unsigned long long ullLimit = SIM_NEVER;
+	unsigned long long ullNext;
+
+	if(PDLIB_NRF24_HAL_WAIT_FOREVER != ulTimeoutUs)
+	{
+		ullLimit = psSim->ullTimeUs + ulTimeoutUs;
+	}
+
+	while(NRF24L01_SimGetIRQ(psSim))
+	{
+		if(psSim->psAir && psSim->psAir->pfnNextEvent)
+		{
+			ullNext = psSim->psAir->pfnNextEvent(psSim->pvAir);
+		}else
+		{
+			ullNext = psSim->ullDeadlineUs;
+		}
+
+		if(ullNext <= psSim->ullTimeUs)
+		{
+			ullNext = psSim->ullTimeUs + 1;
+		}
+
+		if(SIM_NEVER == ullNext)
+		{
+			if(SIM_NEVER == ullLimit)
+			{
+				_NRF24L01_SimElapse(psSim, psSim->ullTimeUs + PDLIB_NRF24_SIM_IDLE_STEP_US);
+				return 0;
+			}
+
+			ullNext = ullLimit;
+		}
+
+		if(ullNext >= ullLimit)
+		{
+			_NRF24L01_SimElapse(psSim, ullLimit);
+			return NRF24L01_SimGetIRQ(psSim) ? 0 : 1;
+		}
+
+		_NRF24L01_SimElapse(psSim, ullNext);
+	}
+
+	return 1;
+}
+
+
+static unsigned long
+_NRF24L01_SimGetTimeUs(void *pvContext)
+{
+	return (unsigned long)((tNRF24L01Sim *)pvContext)->ullTimeUs;
+}
+
+
+static int
+_NRF24L01_SimReadIRQ(void *pvContext)
+{
+	return NRF24L01_SimGetIRQ((tNRF24L01Sim *)pvContext) ? 0 : 1;
+}
+
+
+static void
+_NRF24L01_SimElapse(tNRF24L01Sim *psSim, unsigned long long ullTimeUs)
+{
+	if(psSim->psAir && psSim->psAir->pfnAdvance)
+	{
+		psSim->psAir->pfnAdvance(psSim->pvAir, ullTimeUs);
+	}else
+	{
+		NRF24L01_SimRun(psSim, ullTimeUs);
+	}
+}
+
+
+static void
+_NRF24L01_SimSetState(tNRF24L01Sim *psSim, unsigned char ucState, unsigned long long ullDurationUs)
+{
+	psSim->sStats.ullStateTimeUs[psSim->ucState] += psSim->ullTimeUs - psSim->ullStateStartUs;
+
+	psSim->ucState = ucState;
+	psSim->ullStateStartUs = psSim->ullTimeUs;
+	psSim->ullDeadlineUs = (SIM_NEVER == ullDurationUs) ? SIM_NEVER : (psSim->ullTimeUs + ullDurationUs);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SimEvaluate
+ *
+ * Arguments	: 	psSim	:	Simulated radio
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Follows a change of PWR_UP, PRIM_RX, CE, the TX FIFO or MAX_RT.
+ * 					Timed states finish first, except that PWR_UP low stops
+ * 					everything. A packet being sent ends even if CE goes low.
+ *
+ */
+
+static void
+_NRF24L01_SimEvaluate(tNRF24L01Sim *psSim)
+{
+	unsigned char ucPrimRx = psSim->ucRegister[RF24_CONFIG] & (RF24_PRIM_RX);
+
+	if(0 == (psSim->ucRegister[RF24_CONFIG] & (RF24_PWR_UP)))
+	{
+		if(PDLIB_NRF24_SIM_POWER_DOWN != psSim->ucState)
+		{
+			_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_POWER_DOWN, SIM_NEVER);
+		}
+
+		return;
+	}
+
+	switch(psSim->ucState)
+	{
+		case PDLIB_NRF24_SIM_POWER_DOWN:
+			_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_START_UP, PDLIB_NRF24_SIM_TPD2STBY_US);
+			break;
+
+		case PDLIB_NRF24_SIM_STANDBY_I:
+		case PDLIB_NRF24_SIM_STANDBY_II:
+			if(!psSim->ucCE)
+			{
+				if(PDLIB_NRF24_SIM_STANDBY_I != psSim->ucState)
+				{
+					_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_STANDBY_I, SIM_NEVER);
+				}
+			}else if(ucPrimRx)
+			{
+				_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_RX_SETTLING, PDLIB_NRF24_SIM_TSTBY2A_US);
+			}else if(_NRF24L01_SimTxReady(psSim))
+			{
+				/* PS: ARC_CNT counts the retransmissions of one packet, a new one starts from 0 */
+				psSim->ucRegister[RF24_OBSERVE_TX] &= 0xF0;
+
+				_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_TX_SETTLING, PDLIB_NRF24_SIM_TSTBY2A_US);
+			}else if(PDLIB_NRF24_SIM_STANDBY_II != psSim->ucState)
+			{
+				_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_STANDBY_II, SIM_NEVER);
+			}
+			break;
+
+		case PDLIB_NRF24_SIM_RX_SETTLING:
+		case PDLIB_NRF24_SIM_RX:
+			if(!psSim->ucCE || !ucPrimRx)
+			{
+				_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_STANDBY_I, SIM_NEVER);
+				_NRF24L01_SimEvaluate(psSim);
+			}
+			break;
+
+		default:
+			/* PS: START_UP, TX_SETTLING, TX, ACK_WAIT and ACK_TX end on their deadline */
+			break;
+	}
+}
+
+
+static void
+_NRF24L01_SimTimeout(tNRF24L01Sim *psSim)
+{
+	switch(psSim->ucState)
+	{
+		case PDLIB_NRF24_SIM_START_UP:
+			_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_STANDBY_I, SIM_NEVER);
+			_NRF24L01_SimEvaluate(psSim);
+			break;
+
+		case PDLIB_NRF24_SIM_TX_SETTLING:
+			_NRF24L01_SimStartTx(psSim);
+			break;
+
+		case PDLIB_NRF24_SIM_TX:
+			_NRF24L01_SimEndTx(psSim);
+			break;
+
+		case PDLIB_NRF24_SIM_ACK_WAIT:
+			if(psSim->ucAckPending)
+			{
+				psSim->ucAckPending = 0;
+				psSim->sStats.ulAcksReceived++;
+
+				if(psSim->sAck.ucLength > 0)
+				{
+					if(_NRF24L01_SimRxPush(psSim, 0, psSim->sAck.ucPayload, psSim->sAck.ucLength))
+					{
+						psSim->ucRegister[RF24_STATUS] |= (RF24_RX_DR);
+						psSim->sStats.ulPacketsReceived++;
+					}else
+					{
+						psSim->sStats.ulRxOverflows++;
+					}
+				}
+
+				_NRF24L01_SimTxDone(psSim, 1);
+			}else if((psSim->ucRegister[RF24_OBSERVE_TX] & 0x0F) < (psSim->ucRegister[RF24_SETUP_RETR] & 0x0F))
+			{
+				psSim->ucRegister[RF24_OBSERVE_TX]++;
+				psSim->sStats.ulRetransmits++;
+
+				_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_TX_SETTLING, PDLIB_NRF24_SIM_TSTBY2A_US);
+			}else
+			{
+				_NRF24L01_SimTxDone(psSim, 0);
+			}
+			break;
+
+		case PDLIB_NRF24_SIM_RX_SETTLING:
+			_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_RX, SIM_NEVER);
+			break;
+
+		case PDLIB_NRF24_SIM_ACK_TX:
+			if(psSim->sAck.ucLength > 0)
+			{
+				psSim->ucRegister[RF24_STATUS] |= (RF24_TX_DS);
+			}
+
+			_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_RX, SIM_NEVER);
+			_NRF24L01_SimEvaluate(psSim);
+			break;
+
+		default:
+			psSim->ullDeadlineUs = SIM_NEVER;
+			break;
+	}
+}
+
+
+static void
+_NRF24L01_SimStartTx(tNRF24L01Sim *psSim)
+{
+	tNRF24L01SimPacket *psPacket = &psSim->sOnAir;
+	unsigned long ulAirTimeUs;
+
+	/* PS: Flushed while settling */
+	if(!_NRF24L01_SimTxReady(psSim))
+	{
+		_NRF24L01_SimSetState(psSim, psSim->ucCE ? PDLIB_NRF24_SIM_STANDBY_II : PDLIB_NRF24_SIM_STANDBY_I, SIM_NEVER);
+		return;
+	}
+
+	memset(psPacket, 0, sizeof(tNRF24L01SimPacket));
+	memcpy(psPacket->ucAddress, psSim->ucAddress[6], 5);
+	psPacket->ucAddressWidth = _NRF24L01_SimAddressWidth(psSim);
+	psPacket->ucLength = psSim->ucTxLength[0];
+	memcpy(psPacket->ucPayload, psSim->ucTxPayload[0], psPacket->ucLength);
+	psPacket->ucPID = psSim->ucPID;
+	psPacket->ucNoAck = psSim->ucTxFlags[0] & SIM_TX_NOACK;
+	psPacket->ucChannel = psSim->ucRegister[RF24_RF_CH];
+	psPacket->ucDataRate = _NRF24L01_SimDataRate(psSim);
+	psPacket->ucCRCLength = _NRF24L01_SimCRCLength(psSim);
+
+	ulAirTimeUs = NRF24L01_SimAirTimeUs(psPacket->ucDataRate, psPacket->ucAddressWidth,
+										psPacket->ucCRCLength, psPacket->ucLength);
+
+	psPacket->ullStartUs = psSim->ullTimeUs;
+	psPacket->ullEndUs = psSim->ullTimeUs + ulAirTimeUs;
+
+	psSim->sStats.ulPacketsSent++;
+	psSim->sStats.ullAirTimeUs += ulAirTimeUs;
+
+	_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_TX, ulAirTimeUs);
+
+	if(psSim->psAir && psSim->psAir->pfnTransmit)
+	{
+		psSim->psAir->pfnTransmit(psSim->pvAir, psSim, PDLIB_NRF24_SIM_AIR_START, psPacket, NULL);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SimEndTx
+ *
+ * Arguments	: 	psSim	:	Simulated radio
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The PTX waits for an ACK if auto ACK is on for pipe 0 and the
+ * 					packet is not NO_ACK. The ACK is heard only on RX_ADDR_P0 and only
+ * 					if it is over before ARD; otherwise the packet is sent again ARD
+ * 					after the end of this one.
+ *
+ */
+
+static void
+_NRF24L01_SimEndTx(tNRF24L01Sim *psSim)
+{
+	unsigned long ulARDUs = _NRF24L01_SimARDUs(psSim);
+	unsigned char ucWaitAck;
+	int iAck = 0;
+
+	ucWaitAck = !psSim->sOnAir.ucNoAck && (psSim->ucRegister[RF24_EN_AA] & (RF24_ENAA_P0));
+
+	if(psSim->psAir && psSim->psAir->pfnTransmit)
+	{
+		iAck = psSim->psAir->pfnTransmit(psSim->pvAir, psSim, PDLIB_NRF24_SIM_AIR_END,
+										 &psSim->sOnAir, ucWaitAck ? &psSim->sAck : NULL);
+	}
+
+	if(!ucWaitAck)
+	{
+		_NRF24L01_SimTxDone(psSim, 1);
+		return;
+	}
+
+	psSim->ucAckPending = 0;
+
+	if(iAck && (0 == memcmp(psSim->ucAddress[0], psSim->ucAddress[6], _NRF24L01_SimAddressWidth(psSim))))
+	{
+		if(psSim->sAck.ullEndUs <= psSim->ullTimeUs)
+		{
+			psSim->sAck.ullEndUs = psSim->ullTimeUs + PDLIB_NRF24_SIM_TSTBY2A_US +
+								   NRF24L01_SimAirTimeUs(psSim->sAck.ucDataRate, psSim->sAck.ucAddressWidth,
+														 psSim->sAck.ucCRCLength, psSim->sAck.ucLength);
+		}
+
+		psSim->ucAckPending = (psSim->sAck.ullEndUs <= (psSim->ullTimeUs + ulARDUs));
+	}
+
+	if(psSim->ucAckPending)
+	{
+		_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_ACK_WAIT, psSim->sAck.ullEndUs - psSim->ullTimeUs);
+	}else if((psSim->ucRegister[RF24_OBSERVE_TX] & 0x0F) < (psSim->ucRegister[RF24_SETUP_RETR] & 0x0F))
+	{
+		/* PS: Settles for the retransmission within ARD */
+		_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_ACK_WAIT, ulARDUs - PDLIB_NRF24_SIM_TSTBY2A_US);
+	}else
+	{
+		/* PS: Last try, listens for the whole ARD */
+		_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_ACK_WAIT, ulARDUs);
+	}
+}
+
+
+static void
+_NRF24L01_SimTxDone(tNRF24L01Sim *psSim, unsigned char ucDelivered)
+{
+	if(ucDelivered)
+	{
+		psSim->ucRegister[RF24_STATUS] |= (RF24_TX_DS);
+
+		if(!psSim->ucTxReuse)
+		{
+			_NRF24L01_SimTxPop(psSim, 0);
+		}
+	}else
+	{
+		psSim->ucRegister[RF24_STATUS] |= (RF24_MAX_RT);
+		psSim->sStats.ulMaxRetransmits++;
+
+		if((psSim->ucRegister[RF24_OBSERVE_TX] & 0xF0) != 0xF0)
+		{
+			psSim->ucRegister[RF24_OBSERVE_TX] += 0x10;
+		}
+	}
+
+	_NRF24L01_SimSetState(psSim, PDLIB_NRF24_SIM_STANDBY_I, SIM_NEVER);
+	_NRF24L01_SimEvaluate(psSim);
+}
+
+
+/* PS: The top of the TX FIFO can go on air. MAX_RT blocks the FIFO until it is cleared. */
+static int
+_NRF24L01_SimTxReady(tNRF24L01Sim *psSim)
+{
+	return (psSim->ucTxCount > 0) && (0 == (psSim->ucRegister[RF24_STATUS] & (RF24_MAX_RT)));
+}
+
+
+static void
+_NRF24L01_SimTxPop(tNRF24L01Sim *psSim, unsigned char ucIndex)
+{
+	for(; (ucIndex + 1) < psSim->ucTxCount; ucIndex++)
+	{
+		memcpy(psSim->ucTxPayload[ucIndex], psSim->ucTxPayload[ucIndex + 1], 32);
+		psSim->ucTxLength[ucIndex] = psSim->ucTxLength[ucIndex + 1];
+		psSim->ucTxFlags[ucIndex] = psSim->ucTxFlags[ucIndex + 1];
+	}
+
+	psSim->ucTxCount--;
+
+	/* PS: A new packet at the top gets a new PID */
+	psSim->ucPID = (psSim->ucPID + 1) & 0x03;
+}
+
+
+static int
+_NRF24L01_SimRxPush(tNRF24L01Sim *psSim, unsigned char ucPipe, const unsigned char *pucData, unsigned char ucLength)
+{
+	if(psSim->ucRxCount >= PDLIB_NRF24_SIM_FIFO_DEPTH)
+	{
+		return 0;
+	}
+
+	memcpy(psSim->ucRxPayload[psSim->ucRxCount], pucData, ucLength);
+	psSim->ucRxLength[psSim->ucRxCount] = ucLength;
+	psSim->ucRxPipe[psSim->ucRxCount] = ucPipe;
+	psSim->ucRxCount++;
+
+	return 1;
+}
+
+
+static void
+_NRF24L01_SimRxPop(tNRF24L01Sim *psSim)
+{
+	unsigned char ucIndex;
+
+	for(ucIndex = 0; (ucIndex + 1) < psSim->ucRxCount; ucIndex++)
+	{
+		memcpy(psSim->ucRxPayload[ucIndex], psSim->ucRxPayload[ucIndex + 1], 32);
+		psSim->ucRxLength[ucIndex] = psSim->ucRxLength[ucIndex + 1];
+		psSim->ucRxPipe[ucIndex] = psSim->ucRxPipe[ucIndex + 1];
+	}
+
+	psSim->ucRxCount--;
+}
+
+
+static unsigned char
+_NRF24L01_SimStatus(tNRF24L01Sim *psSim)
+{
+	unsigned char ucStatus = psSim->ucRegister[RF24_STATUS] & SIM_STATUS_FLAGS;
+
+	ucStatus |= (psSim->ucRxCount ? (psSim->ucRxPipe[0] << 1) : 0x0E);
+
+	if(psSim->ucTxCount >= PDLIB_NRF24_SIM_FIFO_DEPTH)
+	{
+		ucStatus |= (RF24_TX_FULL);
+	}
+
+	return ucStatus;
+}
+
+
+static unsigned char
+_NRF24L01_SimFifoStatus(tNRF24L01Sim *psSim)
+{
+	unsigned char ucFifo = 0;
+
+	if(psSim->ucTxReuse)
+	{
+		ucFifo |= (RF24_TX_REUSE);
+	}
+
+	if(psSim->ucTxCount >= PDLIB_NRF24_SIM_FIFO_DEPTH)
+	{
+		ucFifo |= (RF24_FIFO_FULL);
+	}else if(0 == psSim->ucTxCount)
+	{
+		ucFifo |= (RF24_TX_EMPTY);
+	}
+
+	if(psSim->ucRxCount >= PDLIB_NRF24_SIM_FIFO_DEPTH)
+	{
+		ucFifo |= (RF24_RX_FULL);
+	}else if(0 == psSim->ucRxCount)
+	{
+		ucFifo |= (RF24_RX_EMPTY);
+	}
+
+	return ucFifo;
+}
+
+
+static unsigned char
+_NRF24L01_SimAddressWidth(tNRF24L01Sim *psSim)
+{
+	unsigned char ucAW = psSim->ucRegister[RF24_SETUP_AW] & 0x03;
+
+	/* PS: 00 is illegal, taken as 3 bytes */
+	return (ucAW ? ucAW : 1) + 2;
+}
+
+
+static unsigned char
+_NRF24L01_SimCRCLength(tNRF24L01Sim *psSim)
+{
+	/* PS: CRC is forced on while auto ACK is on for any pipe */
+	if((psSim->ucRegister[RF24_CONFIG] & (RF24_EN_CRC)) || psSim->ucRegister[RF24_EN_AA])
+	{
+		return (psSim->ucRegister[RF24_CONFIG] & (RF24_CRCO)) ? 2 : 1;
+	}
+
+	return 0;
+}
+
+
+static unsigned char
+_NRF24L01_SimDataRate(tNRF24L01Sim *psSim)
+{
+	if(psSim->ucRegister[RF24_RF_SETUP] & (RF24_RF_DR_LOW))
+	{
+		return PDLIB_NRF24_SIM_RATE_250KBPS;
+	}
+
+	return (psSim->ucRegister[RF24_RF_SETUP] & (RF24_RF_DR_HIGH)) ? PDLIB_NRF24_SIM_RATE_2MBPS : PDLIB_NRF24_SIM_RATE_1MBPS;
+}
+
+
+static unsigned long
+_NRF24L01_SimARDUs(tNRF24L01Sim *psSim)
+{
+	return 250UL * (((psSim->ucRegister[RF24_SETUP_RETR] >> 4) & 0x0F) + 1);
+}
+
+
+static int
+_NRF24L01_SimIsStandby(tNRF24L01Sim *psSim)
+{
+	return (PDLIB_NRF24_SIM_POWER_DOWN == psSim->ucState) || (PDLIB_NRF24_SIM_START_UP == psSim->ucState) ||
+		   (PDLIB_NRF24_SIM_STANDBY_I == psSim->ucState) || (PDLIB_NRF24_SIM_STANDBY_II == psSim->ucState);
+}
+
+
+static void
+_NRF24L01_SimViolation(tNRF24L01Sim *psSim, const char *pcWhat)
+{
+	psSim->sStats.ulViolations++;
+	psSim->pcLastViolation = pcWhat;
+}
+
+
+static void
+_NRF24L01_SimReadRegister(tNRF24L01Sim *psSim, unsigned char ucRegister, unsigned char *pucData, unsigned int uiLength)
+{
+	unsigned int uiIndex;
+	unsigned char ucBytes = 1;
+	unsigned char *pucSource = &psSim->ucRegister[ucRegister];
+	unsigned char ucValue;
+
+	memset(pucData, 0, uiLength);
+
+	if(ucRegister > RF24_FEATURE)
+	{
+		return;
+	}
+
+	if((ucRegister >= RF24_RX_ADDR_P0) && (ucRegister <= RF24_TX_ADDR))
+	{
+		pucSource = psSim->ucAddress[ucRegister - RF24_RX_ADDR_P0];
+
+		/* PS: Only the bytes of the address width are clocked out */
+		if((RF24_RX_ADDR_P0 == ucRegister) || (RF24_RX_ADDR_P1 == ucRegister) || (RF24_TX_ADDR == ucRegister))
+		{
+			ucBytes = _NRF24L01_SimAddressWidth(psSim);
+		}
+	}
+
+	switch(ucRegister)
+	{
+		case RF24_STATUS:
+			ucValue = _NRF24L01_SimStatus(psSim);
+			pucSource = &ucValue;
+			break;
+
+		case RF24_FIFO_STATUS:
+			ucValue = _NRF24L01_SimFifoStatus(psSim);
+			pucSource = &ucValue;
+			break;
+
+		case RF24_CD:
+			ucValue = psSim->ucCarrier ? 1 : 0;
+			pucSource = &ucValue;
+			break;
+
+		case RF24_DYNPD:
+		case RF24_FEATURE:
+			if(!psSim->ucActivated)
+			{
+				return;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	for(uiIndex = 0; (uiIndex < uiLength) && (uiIndex < ucBytes); uiIndex++)
+	{
+		pucData[uiIndex] = pucSource[uiIndex];
+	}
+}
+
+
+static void
+_NRF24L01_SimWriteRegister(tNRF24L01Sim *psSim, unsigned char ucRegister, unsigned char *pucData, unsigned int uiLength)
+{
+	unsigned int uiIndex;
+
+	if((0 == uiLength) || (ucRegister > RF24_FEATURE) || (0 == g_ucWriteMask[ucRegister]))
+	{
+		_NRF24L01_SimViolation(psSim, "W_REGISTER to a read only or reserved register");
+		return;
+	}
+
+	/* PS: Everybody clears STATUS flags in RX/TX, the datasheet only allows the rest in standby */
+	if((RF24_STATUS != ucRegister) && !_NRF24L01_SimIsStandby(psSim))
+	{
+		_NRF24L01_SimViolation(psSim, "W_REGISTER outside Power Down and Standby");
+	}
+
+	if(((RF24_DYNPD == ucRegister) || (RF24_FEATURE == ucRegister)) && !psSim->ucActivated)
+	{
+		_NRF24L01_SimViolation(psSim, "W_REGISTER to FEATURE/DYNPD without ACTIVATE");
+		return;
+	}
+
+	switch(ucRegister)
+	{
+		case RF24_STATUS:
+			psSim->ucRegister[RF24_STATUS] &= ~(pucData[0] & SIM_STATUS_FLAGS);
+			break;
+
+		case RF24_SETUP_AW:
+			if(0 == (pucData[0] & 0x03))
+			{
+				_NRF24L01_SimViolation(psSim, "Illegal address width");
+			}
+
+			psSim->ucRegister[ucRegister] = pucData[0] & g_ucWriteMask[ucRegister];
+			break;
+
+		case RF24_RF_CH:
+			psSim->ucRegister[ucRegister] = pucData[0] & g_ucWriteMask[ucRegister];
+
+			/* PS: PLOS_CNT restarts with a channel write */
+			psSim->ucRegister[RF24_OBSERVE_TX] &= 0x0F;
+			break;
+
+		case RF24_RX_ADDR_P0:
+		case RF24_RX_ADDR_P1:
+		case RF24_TX_ADDR:
+			/* PS: Bytes past the address width are not taken */
+			for(uiIndex = 0; (uiIndex < uiLength) && (uiIndex < _NRF24L01_SimAddressWidth(psSim)); uiIndex++)
+			{
+				psSim->ucAddress[ucRegister - RF24_RX_ADDR_P0][uiIndex] = pucData[uiIndex];
+			}
+
+			psSim->ucRegister[ucRegister] = pucData[0];
+			break;
+
+		case RF24_RX_ADDR_P2:
+		case RF24_RX_ADDR_P3:
+		case RF24_RX_ADDR_P4:
+		case RF24_RX_ADDR_P5:
+			psSim->ucAddress[ucRegister - RF24_RX_ADDR_P0][0] = pucData[0];
+			psSim->ucRegister[ucRegister] = pucData[0];
+			break;
+
+		case RF24_RX_PW_P0:
+		case RF24_RX_PW_P1:
+		case RF24_RX_PW_P2:
+		case RF24_RX_PW_P3:
+		case RF24_RX_PW_P4:
+		case RF24_RX_PW_P5:
+			if((pucData[0] & 0x3F) > 32)
+			{
+				_NRF24L01_SimViolation(psSim, "RX_PW_Px over 32");
+			}
+
+			psSim->ucRegister[ucRegister] = pucData[0] & g_ucWriteMask[ucRegister];
+			break;
+
+		default:
+			psSim->ucRegister[ucRegister] = pucData[0] & g_ucWriteMask[ucRegister];
+			break;
+	}
+
+	_NRF24L01_SimEvaluate(psSim);
+}
+
+
+static void
+_NRF24L01_SimCommand(tNRF24L01Sim *psSim, unsigned char ucCommand, unsigned char *pucTxData,
+					 unsigned char *pucRxData, unsigned int uiLength)
+{
+	unsigned char ucData[32];
+	unsigned char ucLength;
+	unsigned char ucFlags = 0;
+
+	/* PS: NULL TX data clocks out NOP bytes */
+	memset(ucData, RF24_NOP, sizeof(ucData));
+
+	if(pucTxData)
+	{
+		memcpy(ucData, pucTxData, (uiLength > 32) ? 32 : uiLength);
+	}
+
+	if(ucCommand <= (RF24_R_REGISTER | RF24_REGISTER_MASK))
+	{
+		if(pucRxData)
+		{
+			_NRF24L01_SimReadRegister(psSim, ucCommand & RF24_REGISTER_MASK, pucRxData, uiLength);
+		}
+
+		return;
+	}
+
+	if(ucCommand <= (RF24_W_REGISTER | RF24_REGISTER_MASK))
+	{
+		_NRF24L01_SimWriteRegister(psSim, ucCommand & RF24_REGISTER_MASK, ucData, (uiLength > 32) ? 32 : uiLength);
+		return;
+	}
+
+	if(pucRxData)
+	{
+		memset(pucRxData, 0, uiLength);
+	}
+
+	if((ucCommand & 0xF8) == RF24_W_ACK_PAYLOAD)
+	{
+		if((ucCommand & 0x07) > 5)
+		{
+			_NRF24L01_SimViolation(psSim, "W_ACK_PAYLOAD to a pipe over 5");
+			return;
+		}
+
+		ucFlags = SIM_TX_ACK_PAYLOAD | ((ucCommand & 0x07) << SIM_TX_PIPE_SHIFT);
+		ucCommand = RF24_W_ACK_PAYLOAD;
+	}
+
+	switch(ucCommand)
+	{
+		case RF24_R_RX_PAYLOAD:
+			if(0 == psSim->ucRxCount)
+			{
+				_NRF24L01_SimViolation(psSim, "R_RX_PAYLOAD with the RX FIFO empty");
+				break;
+			}
+
+			if(pucRxData)
+			{
+				ucLength = (uiLength < psSim->ucRxLength[0]) ? (unsigned char)uiLength : psSim->ucRxLength[0];
+				memcpy(pucRxData, psSim->ucRxPayload[0], ucLength);
+			}
+
+			_NRF24L01_SimRxPop(psSim);
+			break;
+
+		case RF24_R_RX_PL_WID:
+			if(!psSim->ucActivated)
+			{
+				_NRF24L01_SimViolation(psSim, "R_RX_PL_WID without ACTIVATE");
+				break;
+			}
+
+			if(pucRxData && (uiLength > 0) && psSim->ucRxCount)
+			{
+				pucRxData[0] = psSim->ucRxLength[0];
+			}
+			break;
+
+		case RF24_W_TX_PAYLOAD_NOACK:
+			if(!psSim->ucActivated || (0 == (psSim->ucRegister[RF24_FEATURE] & (RF24_EN_DYN_ACK))))
+			{
+				_NRF24L01_SimViolation(psSim, "W_TX_PAYLOAD_NOACK without EN_DYN_ACK");
+				break;
+			}
+
+			ucFlags = SIM_TX_NOACK;
+
+			/* Falls through - the rest is W_TX_PAYLOAD */
+
+		case RF24_W_ACK_PAYLOAD:
+			if((RF24_W_ACK_PAYLOAD == ucCommand) && !psSim->ucActivated)
+			{
+				_NRF24L01_SimViolation(psSim, "W_ACK_PAYLOAD without ACTIVATE");
+				break;
+			}
+
+			/* Falls through */
+
+		case RF24_W_TX_PAYLOAD:
+			if((0 == uiLength) || (uiLength > 32))
+			{
+				_NRF24L01_SimViolation(psSim, "Payload length not 1 to 32");
+				break;
+			}
+
+			if(psSim->ucTxCount >= PDLIB_NRF24_SIM_FIFO_DEPTH)
+			{
+				_NRF24L01_SimViolation(psSim, "Payload written to a full TX FIFO");
+				break;
+			}
+
+			memcpy(psSim->ucTxPayload[psSim->ucTxCount], ucData, uiLength);
+			psSim->ucTxLength[psSim->ucTxCount] = (unsigned char)uiLength;
+			psSim->ucTxFlags[psSim->ucTxCount] = ucFlags;
+			psSim->ucTxCount++;
+
+			/* PS: A new payload ends the reuse */
+			if(psSim->ucTxReuse)
+			{
+				psSim->ucTxReuse = 0;
+				_NRF24L01_SimTxPop(psSim, 0);
+			}
+
+			_NRF24L01_SimEvaluate(psSim);
+			break;
+
+		case RF24_FLUSH_TX:
+			psSim->ucTxCount = 0;
+			psSim->ucTxReuse = 0;
+			psSim->ucPID = (psSim->ucPID + 1) & 0x03;
+			break;
+
+		case RF24_FLUSH_RX:
+			psSim->ucRxCount = 0;
+			break;
+
+		case RF24_REUSE_TX_PL:
+			if((PDLIB_NRF24_SIM_TX == psSim->ucState) || (PDLIB_NRF24_SIM_ACK_WAIT == psSim->ucState))
+			{
+				_NRF24L01_SimViolation(psSim, "REUSE_TX_PL during a transmission");
+			}
+
+			psSim->ucTxReuse = 1;
+			_NRF24L01_SimEvaluate(psSim);
+			break;
+
+		case RF24_ACTIVATE:
+			if((uiLength > 0) && (0x73 == ucData[0]))
+			{
+				if(!_NRF24L01_SimIsStandby(psSim))
+				{
+					_NRF24L01_SimViolation(psSim, "ACTIVATE outside Power Down and Standby");
+				}
+
+				psSim->ucActivated = !psSim->ucActivated;
+			}
+			break;
+
+		case RF24_NOP:
+			break;
+
+		default:
+			_NRF24L01_SimViolation(psSim, "Unknown command");
+			break;
+	}
+}
+
+
+/* PS: CRC-16-CCITT of the payload, only used to tell a retransmission from a new packet */
+static unsigned short
+_NRF24L01_SimCRC(const unsigned char *pucData, unsigned char ucLength)
+{
+	unsigned short usCRC = 0xFFFF;
+	unsigned char ucBit;
+
+	while(ucLength--)
+	{
+		usCRC ^= (unsigned short)(*pucData++) << 8;
+
+		for(ucBit = 0; ucBit < 8; ucBit++)
+		{
+			usCRC = (usCRC & 0x8000) ? ((usCRC << 1) ^ 0x1021) : (usCRC << 1);
+		}
+	}
+
+	return usCRC;
+}
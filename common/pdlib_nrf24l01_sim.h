@@ -0,0 +1,153 @@
+#ifndef _PDLIB_NRF24L01_SIM
+#define _PDLIB_NRF24L01_SIM
+
+#include "nRF24L01.h"
+#include "pdlib_nrf24l01_hal.h"
+
+/* PS: Simulated nRF24L01 behind the backend interface (NRF24L01_CONF_HAL), for host builds.
+ * See pdlib_nrf24l01_sim.c for what is modelled. */
+
+/* PS: Datasheet timings in microseconds (nRF24L01 Product Specification, table 13) */
+#define PDLIB_NRF24_SIM_TPD2STBY_US		1500	// Power down to Standby I
+#define PDLIB_NRF24_SIM_TSTBY2A_US		130		// Standby to TX/RX settling
+
+#define PDLIB_NRF24_SIM_FIFO_DEPTH		3
+
+/* PS: Chip states (datasheet section 6.1). ACK_WAIT is the PTX listening for an ACK,
+ * ACK_TX the PRX sending one. */
+#define PDLIB_NRF24_SIM_POWER_DOWN		0
+#define PDLIB_NRF24_SIM_START_UP		1
+#define PDLIB_NRF24_SIM_STANDBY_I		2
+#define PDLIB_NRF24_SIM_STANDBY_II		3
+#define PDLIB_NRF24_SIM_TX_SETTLING		4
+#define PDLIB_NRF24_SIM_TX				5
+#define PDLIB_NRF24_SIM_ACK_WAIT		6
+#define PDLIB_NRF24_SIM_RX_SETTLING		7
+#define PDLIB_NRF24_SIM_RX				8
+#define PDLIB_NRF24_SIM_ACK_TX			9
+#define PDLIB_NRF24_SIM_STATE_COUNT		10
+
+/* PS: Air data rates of tNRF24L01SimPacket */
+#define PDLIB_NRF24_SIM_RATE_1MBPS		0
+#define PDLIB_NRF24_SIM_RATE_2MBPS		1
+#define PDLIB_NRF24_SIM_RATE_250KBPS	2
+
+/* PS: ucEvent of pfnTransmit */
+#define PDLIB_NRF24_SIM_AIR_START		0
+#define PDLIB_NRF24_SIM_AIR_END			1
+
+/* PS: Wait of pfnWaitIRQ when nothing at all is pending */
+#define PDLIB_NRF24_SIM_IDLE_STEP_US	1000
+
+/* PS: A packet on air */
+typedef struct
+{
+	unsigned char ucAddress[5];			// LSByte first
+	unsigned char ucAddressWidth;		// 3 to 5
+	unsigned char ucPayload[32];
+	unsigned char ucLength;				// 0 to 32, 0 for an empty ACK
+	unsigned char ucPID;				// 2 bit packet ID
+	unsigned char ucNoAck;				// NO_ACK flag of the packet control field
+	unsigned char ucChannel;
+	unsigned char ucDataRate;			// PDLIB_NRF24_SIM_RATE_*
+	unsigned char ucCRCLength;			// 0, 1 or 2 bytes
+	unsigned long long ullStartUs;
+	unsigned long long ullEndUs;
+}tNRF24L01SimPacket;
+
+typedef struct _NRF24L01Sim tNRF24L01Sim;
+
+/* PS: Connects radios (see NRF24L01_SimAttach). Without one nothing is heard and no ACK comes back. */
+typedef struct
+{
+	/* PS: The radio starts (PDLIB_NRF24_SIM_AIR_START) or finishes (PDLIB_NRF24_SIM_AIR_END)
+	 * sending psPacket. On END, returns 1 and fills psAck if an ACK reaches the sender
+	 * (only asked for when the sender waits for one). An air which delivers the ACK later
+	 * returns 0 and calls NRF24L01_SimReceiveAck. */
+	int (*pfnTransmit)(void *pvAir, tNRF24L01Sim *psSim, unsigned char ucEvent,
+					   const tNRF24L01SimPacket *psPacket, tNRF24L01SimPacket *psAck);
+
+	/* PS: Runs every radio on the air up to ullTimeUs, in time order. NULL runs only the caller. */
+	void (*pfnAdvance)(void *pvAir, unsigned long long ullTimeUs);
+
+	/* PS: Time of the earliest pending event of any radio on the air, ~0 if none. May be NULL. */
+	unsigned long long (*pfnNextEvent)(void *pvAir);
+}tNRF24L01SimAir;
+
+/* PS: Counters of the simulator, reset by NRF24L01_SimResetStats */
+typedef struct
+{
+	unsigned long ulTransfers;			// SPI transactions
+	unsigned long ulSPIBytes;			// Command bytes included
+	unsigned long long ullSPITimeUs;	// Time spent clocking SPI
+	unsigned long ulCEPulses;			// CE low to high edges
+	unsigned long ulPacketsSent;		// Transmissions on air, retransmissions included
+	unsigned long ulRetransmits;
+	unsigned long ulAcksReceived;
+	unsigned long ulMaxRetransmits;		// MAX_RT events
+	unsigned long ulPacketsReceived;	// Into the RX FIFO
+	unsigned long ulDuplicates;			// Same PID and CRC as the last packet, ACKed and discarded
+	unsigned long ulRxOverflows;		// Lost, RX FIFO full
+	unsigned long ulAcksSent;
+	unsigned long long ullAirTimeUs;	// Time on air sending, ACKs included
+	unsigned long ulViolations;			// Commands the chip would ignore or misbehave on (see pcLastViolation)
+	unsigned long long ullStateTimeUs[PDLIB_NRF24_SIM_STATE_COUNT];
+}tNRF24L01SimStats;
+
+struct _NRF24L01Sim
+{
+	unsigned long long ullTimeUs;		// Simulated time
+	unsigned long ulSPIBitRate;			// Used to charge the time of SPI transactions
+
+	unsigned char ucRegister[RF24_FEATURE + 1];
+	unsigned char ucAddress[7][5];		// RX_ADDR_P0 to P5 (P2 to P5 only byte 0) and TX_ADDR
+	unsigned char ucActivated;			// ACTIVATE state, FEATURE and DYNPD are read only without it
+	unsigned char ucCE;
+	unsigned char ucCSN;
+
+	unsigned char ucState;				// PDLIB_NRF24_SIM_*
+	unsigned long long ullStateStartUs;
+	unsigned long long ullDeadlineUs;	// End of the current timed state, ~0 if none
+
+	unsigned char ucTxPayload[PDLIB_NRF24_SIM_FIFO_DEPTH][32];
+	unsigned char ucTxLength[PDLIB_NRF24_SIM_FIFO_DEPTH];
+	unsigned char ucTxFlags[PDLIB_NRF24_SIM_FIFO_DEPTH];	// NO_ACK, ACK payload and its pipe
+	unsigned char ucTxCount;
+	unsigned char ucTxReuse;
+
+	unsigned char ucRxPayload[PDLIB_NRF24_SIM_FIFO_DEPTH][32];
+	unsigned char ucRxLength[PDLIB_NRF24_SIM_FIFO_DEPTH];
+	unsigned char ucRxPipe[PDLIB_NRF24_SIM_FIFO_DEPTH];
+	unsigned char ucRxCount;
+
+	unsigned char ucPID;				// PID of the packet at the top of the TX FIFO
+	unsigned char ucLastRxPID[6];		// Duplicate detection per pipe, 0xFF if none
+	unsigned short usLastRxCRC[6];
+	unsigned char ucCarrier;			// Carrier detect, set by the air
+	tNRF24L01SimPacket sOnAir;			// Packet being sent
+	tNRF24L01SimPacket sAck;			// ACK on its way to the PTX
+	unsigned char ucAckPending;
+
+	const tNRF24L01SimAir *psAir;
+	void *pvAir;
+
+	tNRF24L01SimStats sStats;
+	const char *pcLastViolation;
+};
+
+extern const tNRF24L01HAL g_sNRF24L01SimHAL;
+
+void NRF24L01_SimInit(tNRF24L01Sim *psSim);
+void NRF24L01_SimAttach(tNRF24L01Sim *psSim, const tNRF24L01SimAir *psAir, void *pvAir);
+void NRF24L01_SimRun(tNRF24L01Sim *psSim, unsigned long long ullTimeUs);
+unsigned long long NRF24L01_SimNextEvent(tNRF24L01Sim *psSim);
+int NRF24L01_SimReceive(tNRF24L01Sim *psSim, const tNRF24L01SimPacket *psPacket, tNRF24L01SimPacket *psAck);
+int NRF24L01_SimReceiveAck(tNRF24L01Sim *psSim, const tNRF24L01SimPacket *psAck);
+int NRF24L01_SimIsListening(tNRF24L01Sim *psSim, unsigned char ucChannel, unsigned char ucDataRate);
+unsigned char NRF24L01_SimGetIRQ(tNRF24L01Sim *psSim);
+unsigned long NRF24L01_SimAirTimeUs(unsigned char ucDataRate, unsigned char ucAddressWidth,
+									unsigned char ucCRCLength, unsigned char ucLength);
+void NRF24L01_SimGetStats(tNRF24L01Sim *psSim, tNRF24L01SimStats *psStats);
+void NRF24L01_SimResetStats(tNRF24L01Sim *psSim);
+
+#endif
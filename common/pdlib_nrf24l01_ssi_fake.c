@@ -0,0 +1,371 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * NRF24L01_CONF_HAL backend which plays the SSI module for the SPI engine
+ * (NRF24L01_CONF_SPI_ENGINE): an 8 byte TX FIFO, an 8 byte RX FIFO and an
+ * RX interrupt, in front of another backend which plays the chip (eg. the
+ * simulated chip). Nothing moves on its own: NRF24L01_SSIFakeRun clocks
+ * bytes from the TX FIFO to the RX FIFO, as the SSI would in the time of
+ * those bytes, and then calls the interrupt handler if it is enabled and
+ * received bytes wait (RX FIFO half full or RX timeout on the target).
+ *
+ * The backend behind only knows whole transactions, so the bytes of a CSN
+ * low period are mapped onto them:
+ *
+ * 	- Reads (R_REGISTER, R_RX_PL_WID, R_RX_PAYLOAD) run at the command
+ * 	  byte, reading ahead as much as the command can return (5, 1 and 32
+ * 	  bytes). The bytes clocked after it return the data read.
+ * 	- Other commands take the status with a NOP at the command byte and
+ * 	  run when CSN goes high, with the bytes clocked in between.
+ *
+ * The blocking calls of the driver (pfnTransfer) go straight through.
+ *
+ * Git repo:
+ *
+ * https://github.com/pradeepa-s/pdlib_nrf24l01.git
+ *
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_ssi_fake.h"
+
+static unsigned char _NRF24L01_SSIFakeTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+											   unsigned char *pucRxData, unsigned int uiLength);
+static void _NRF24L01_SSIFakeSetCE(void *pvContext, unsigned char ucLevel);
+static void _NRF24L01_SSIFakeSetCSN(void *pvContext, unsigned char ucLevel);
+static int _NRF24L01_SSIFakeWaitIRQ(void *pvContext, unsigned long ulTimeoutUs);
+static unsigned long _NRF24L01_SSIFakeGetTimeUs(void *pvContext);
+static int _NRF24L01_SSIFakeFifoPut(void *pvContext, unsigned char ucData);
+static int _NRF24L01_SSIFakeFifoGet(void *pvContext, unsigned char *pucData);
+static void _NRF24L01_SSIFakeFifoInt(void *pvContext, unsigned char ucEnable);
+static int _NRF24L01_SSIFakeGetIRQ(void *pvContext);
+static unsigned char _NRF24L01_SSIFakeClock(tNRF24L01SSIFake *psFake, unsigned char ucData);
+
+const tNRF24L01HAL g_sNRF24L01SSIFakeHAL =
+{
+	_NRF24L01_SSIFakeTransfer,
+	_NRF24L01_SSIFakeSetCE,
+	_NRF24L01_SSIFakeSetCSN,
+	_NRF24L01_SSIFakeWaitIRQ,
+	_NRF24L01_SSIFakeGetTimeUs,
+	_NRF24L01_SSIFakeFifoPut,
+	_NRF24L01_SSIFakeFifoGet,
+	_NRF24L01_SSIFakeFifoInt,
+	_NRF24L01_SSIFakeGetIRQ
+};
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SSIFakeInit
+ *
+ * Arguments	: 	psFake	:	Fake SSI, pass it to NRF24L01_InitHAL as the context
+ * 					psHAL	:	Backend of the chip
+ * 					pvHALContext	:	Its context
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Empty FIFOs, CSN high, interrupt masked, no handler.
+ *
+ */
+
+void
+NRF24L01_SSIFakeInit(tNRF24L01SSIFake *psFake, const tNRF24L01HAL *psHAL, void *pvHALContext)
+{
+	memset(psFake, 0, sizeof(tNRF24L01SSIFake));
+
+	psFake->psHAL = psHAL;
+	psFake->pvHALContext = pvHALContext;
+	psFake->ucCSN = 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SSIFakeSetISR
+ *
+ * Arguments	: 	psFake	:	Fake SSI
+ * 					pfnISR	:	SSI interrupt handler, NULL for none
+ * 					pvArg	:	Its argument
+ *
+ * Return		: 	None
+ *
+ * Description	: 	-
+ *
+ */
+
+void
+NRF24L01_SSIFakeSetISR(tNRF24L01SSIFake *psFake, tNRF24L01SSIFakeISR pfnISR, void *pvArg)
+{
+	psFake->pfnISR = pfnISR;
+	psFake->pvISRArg = pvArg;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SSIFakeRun
+ *
+ * Arguments	: 	psFake	:	Fake SSI
+ * 					uiBytes	:	Most bytes to clock
+ *
+ * Return		: 	Bytes clocked
+ *
+ * Description	: 	Clocks bytes from the TX FIFO until it is empty or uiBytes are
+ * 					done. A byte received with the RX FIFO full is lost (counted in
+ * 					ulOverruns). Then calls the interrupt handler once if the
+ * 					interrupt is enabled and the RX FIFO is not empty.
+ *
+ */
+
+unsigned int
+NRF24L01_SSIFakeRun(tNRF24L01SSIFake *psFake, unsigned int uiBytes)
+{
+	unsigned int uiDone = 0;
+	unsigned char ucData;
+
+	while((uiDone < uiBytes) && psFake->ucTxCount)
+	{
+		ucData = _NRF24L01_SSIFakeClock(psFake, psFake->ucTxFifo[psFake->ucTxHead]);
+
+		psFake->ucTxHead = ((psFake->ucTxHead + 1) % PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH);
+		psFake->ucTxCount--;
+
+		if(psFake->ucRxCount < PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH)
+		{
+			psFake->ucRxFifo[(psFake->ucRxHead + psFake->ucRxCount) % PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH] = ucData;
+			psFake->ucRxCount++;
+		}else
+		{
+			psFake->ulOverruns++;
+		}
+
+		psFake->ulBytes++;
+		uiDone++;
+	}
+
+	if(psFake->ucIntEnabled && psFake->ucRxCount && psFake->pfnISR)
+	{
+		psFake->ulInterrupts++;
+		psFake->pfnISR(psFake->pvISRArg);
+	}
+
+	return uiDone;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_SSIFakeClock
+ *
+ * Arguments	: 	psFake	:	Fake SSI
+ * 					ucData	:	MOSI byte
+ *
+ * Return		: 	MISO byte
+ *
+ * Description	: 	One byte on the bus. With CSN high the chip does not drive
+ * 					MISO and the byte reads 0xFF.
+ *
+ */
+
+static unsigned char
+_NRF24L01_SSIFakeClock(tNRF24L01SSIFake *psFake, unsigned char ucData)
+{
+	unsigned int uiAhead = 0;
+	unsigned char ucMISO = 0x00;
+
+	if(psFake->ucCSN)
+	{
+		return 0xFF;
+	}
+
+	if(0 == psFake->uiFrameLength)
+	{
+		if(ucData <= (RF24_R_REGISTER | RF24_REGISTER_MASK))
+		{
+			uiAhead = 5;
+		}else if(RF24_R_RX_PL_WID == ucData)
+		{
+			uiAhead = 1;
+		}else if(RF24_R_RX_PAYLOAD == ucData)
+		{
+			uiAhead = 32;
+		}
+
+		memset(psFake->ucReply, 0, sizeof(psFake->ucReply));
+
+		if(uiAhead)
+		{
+			psFake->ucReply[0] = psFake->psHAL->pfnTransfer(psFake->pvHALContext, ucData, NULL, &psFake->ucReply[1], uiAhead);
+			psFake->ucExecuted = 1;
+		}else
+		{
+			psFake->ucReply[0] = psFake->psHAL->pfnTransfer(psFake->pvHALContext, RF24_NOP, NULL, NULL, 0);
+			psFake->ucExecuted = 0;
+		}
+
+		psFake->uiReplyLength = (1 + uiAhead);
+	}
+
+	if(psFake->uiFrameLength < psFake->uiReplyLength)
+	{
+		ucMISO = psFake->ucReply[psFake->uiFrameLength];
+	}
+
+	if(psFake->uiFrameLength < sizeof(psFake->ucFrame))
+	{
+		psFake->ucFrame[psFake->uiFrameLength] = ucData;
+	}
+
+	psFake->uiFrameLength++;
+
+	return ucMISO;
+}
+
+
+/* PS: Backend functions */
+
+static unsigned char
+_NRF24L01_SSIFakeTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+						  unsigned char *pucRxData, unsigned int uiLength)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+
+	return psFake->psHAL->pfnTransfer(psFake->pvHALContext, ucCommand, pucTxData, pucRxData, uiLength);
+}
+
+static void
+_NRF24L01_SSIFakeSetCE(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+
+	psFake->psHAL->pfnSetCE(psFake->pvHALContext, ucLevel);
+}
+
+static void
+_NRF24L01_SSIFakeSetCSN(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+	unsigned int uiLength;
+
+	if(ucLevel && !psFake->ucCSN && psFake->uiFrameLength)
+	{
+		/* PS: End of the frame, a write command runs now with the data clocked */
+		if(!psFake->ucExecuted)
+		{
+			uiLength = (psFake->uiFrameLength - 1);
+
+			if(uiLength > (sizeof(psFake->ucFrame) - 1))
+			{
+				uiLength = (sizeof(psFake->ucFrame) - 1);
+			}
+
+			psFake->psHAL->pfnTransfer(psFake->pvHALContext, psFake->ucFrame[0], &psFake->ucFrame[1], NULL, uiLength);
+		}
+
+		psFake->ulFrames++;
+	}
+
+	if(!ucLevel)
+	{
+		psFake->uiFrameLength = 0;
+		psFake->uiReplyLength = 0;
+		psFake->ucExecuted = 0;
+	}
+
+	psFake->ucCSN = (ucLevel ? 1 : 0);
+
+	if(psFake->psHAL->pfnSetCSN)
+	{
+		psFake->psHAL->pfnSetCSN(psFake->pvHALContext, ucLevel);
+	}
+}
+
+static int
+_NRF24L01_SSIFakeWaitIRQ(void *pvContext, unsigned long ulTimeoutUs)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+
+	if(NULL == psFake->psHAL->pfnWaitIRQ)
+	{
+		return 0;
+	}
+
+	return psFake->psHAL->pfnWaitIRQ(psFake->pvHALContext, ulTimeoutUs);
+}
+
+static int
+_NRF24L01_SSIFakeGetIRQ(void *pvContext)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+
+	if(NULL == psFake->psHAL->pfnGetIRQ)
+	{
+		return 0;
+	}
+
+	return psFake->psHAL->pfnGetIRQ(psFake->pvHALContext);
+}
+
+static unsigned long
+_NRF24L01_SSIFakeGetTimeUs(void *pvContext)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+
+	if(NULL == psFake->psHAL->pfnGetTimeUs)
+	{
+		return 0;
+	}
+
+	return psFake->psHAL->pfnGetTimeUs(psFake->pvHALContext);
+}
+
+static int
+_NRF24L01_SSIFakeFifoPut(void *pvContext, unsigned char ucData)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+
+	if(psFake->ucTxCount >= PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH)
+	{
+		return 0;
+	}
+
+	/* PS: The bus ran dry inside the frame, SCK stopped between two of its bytes */
+	if(!psFake->ucCSN && psFake->uiFrameLength && (0 == psFake->ucTxCount))
+	{
+		psFake->ulGaps++;
+	}
+
+	psFake->ucTxFifo[(psFake->ucTxHead + psFake->ucTxCount) % PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH] = ucData;
+	psFake->ucTxCount++;
+
+	return 1;
+}
+
+static int
+_NRF24L01_SSIFakeFifoGet(void *pvContext, unsigned char *pucData)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+
+	if(0 == psFake->ucRxCount)
+	{
+		return 0;
+	}
+
+	*pucData = psFake->ucRxFifo[psFake->ucRxHead];
+
+	psFake->ucRxHead = ((psFake->ucRxHead + 1) % PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH);
+	psFake->ucRxCount--;
+
+	return 1;
+}
+
+static void
+_NRF24L01_SSIFakeFifoInt(void *pvContext, unsigned char ucEnable)
+{
+	tNRF24L01SSIFake *psFake = (tNRF24L01SSIFake *)pvContext;
+
+	psFake->ucIntEnabled = (ucEnable ? 1 : 0);
+}
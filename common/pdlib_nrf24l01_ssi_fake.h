@@ -0,0 +1,52 @@
+#ifndef _PDLIB_NRF24L01_SSI_FAKE
+#define _PDLIB_NRF24L01_SSI_FAKE
+
+#include "nRF24L01.h"
+#include "pdlib_nrf24l01_hal.h"
+
+/* PS: Fake SSI module with TX/RX FIFOs and an RX interrupt, in front of another backend (the chip).
+ * For host builds of the SPI engine (NRF24L01_CONF_SPI_ENGINE), see pdlib_nrf24l01_ssi_fake.c. */
+
+#define PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH		8
+
+/* PS: The SSI interrupt handler, calls NRF24L01_SPIEngineService */
+typedef void (*tNRF24L01SSIFakeISR)(void *pvArg);
+
+typedef struct
+{
+	const tNRF24L01HAL *psHAL;			// Backend of the chip behind the SSI
+	void *pvHALContext;
+
+	unsigned char ucTxFifo[PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH];
+	unsigned char ucTxHead;
+	unsigned char ucTxCount;
+	unsigned char ucRxFifo[PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH];
+	unsigned char ucRxHead;
+	unsigned char ucRxCount;
+
+	unsigned char ucCSN;
+	unsigned char ucIntEnabled;
+	unsigned char ucExecuted;			// The command of the frame went to the backend at its first byte
+	unsigned char ucFrame[33];			// MOSI bytes of the CSN low period
+	unsigned int uiFrameLength;			// Bytes clocked in the CSN low period
+	unsigned char ucReply[33];			// MISO bytes of the CSN low period
+	unsigned int uiReplyLength;
+
+	tNRF24L01SSIFakeISR pfnISR;
+	void *pvISRArg;
+
+	unsigned long ulBytes;				// Bytes clocked
+	unsigned long ulFrames;				// CSN low periods with at least one byte
+	unsigned long ulInterrupts;			// pfnISR calls
+	unsigned long ulOverruns;			// Bytes lost to a full RX FIFO
+	unsigned long ulGaps;				// Bytes queued with CSN low after the TX FIFO ran empty in the frame
+}tNRF24L01SSIFake;
+
+/* PS: Pass the tNRF24L01SSIFake as its context to NRF24L01_InitHAL */
+extern const tNRF24L01HAL g_sNRF24L01SSIFakeHAL;
+
+void NRF24L01_SSIFakeInit(tNRF24L01SSIFake *psFake, const tNRF24L01HAL *psHAL, void *pvHALContext);
+void NRF24L01_SSIFakeSetISR(tNRF24L01SSIFake *psFake, tNRF24L01SSIFakeISR pfnISR, void *pvArg);
+unsigned int NRF24L01_SSIFakeRun(tNRF24L01SSIFake *psFake, unsigned int uiBytes);
+
+#endif
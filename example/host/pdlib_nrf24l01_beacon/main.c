@@ -0,0 +1,237 @@
+/*
+ * main.c
+ *
+ * Beacon (REUSE_TX_PL) on the simulated air at 2 Mbps. One PTX sends the
+ * same payload to one PRX count times, first packet by packet with
+ * NRF24L01_SendDataAsync, then as a beacon (NRF24L01_BeaconStart), and
+ * prints the SPI traffic of the PTX for both:
+ *
+ * 	packet	-- the payload is written over SPI for every transmission
+ * 	beacon	-- written once, every repeat is a CE pulse
+ *
+ * pdlib_nrf24l01_beacon [count] [payload] [period_ms] [noack] [loss_ppm]
+ *
+ * With a period the main loop calls NRF24L01_Tick every millisecond of
+ * simulated time, which paces both modes. noack defaults to 1: with auto
+ * ACK the PRX takes the repeats of a beacon for retransmissions (same PID
+ * and CRC), ACKs them and keeps only the first.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_air.h"
+
+#define MODE_PACKET		0
+#define MODE_BEACON		1
+
+static tNRF24L01Air g_sAir;
+static tNRF24L01Sim g_sSimPTX;
+static tNRF24L01Sim g_sSimPRX;
+static tNRF24L01 g_sPTX;
+static tNRF24L01 g_sPRX;
+static tNRF24L01TxHandle g_sHandle;
+static unsigned long g_ulReceived;
+static unsigned char g_ucBusy;
+
+static void
+TxDone(tNRF24L01 *psRadio, int iResult)
+{
+	(void)psRadio;
+	(void)iResult;
+
+	g_ucBusy = 0;
+}
+
+static void
+ServicePRX(unsigned int uiPayload)
+{
+	char cData[32];
+	char cLength;
+	char cPipe;
+
+	NRF24L01_ClearInterruptFlag(&g_sPRX, PDLIB_INTERRUPT_DATA_READY);
+
+	while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(&g_sPRX, &cPipe))
+	{
+		cLength = (char)uiPayload;
+
+		/* PS: Returns the length read */
+		if(NRF24L01_GetData(&g_sPRX, cPipe, cData, &cLength) <= 0)
+		{
+			break;
+		}
+
+		g_ulReceived++;
+	}
+}
+
+static void
+Run(unsigned char ucMode, unsigned long ulCount, unsigned int uiPayload, unsigned long ulPeriodMs, unsigned char ucNoAck)
+{
+	static const char * const pcModeNames[] = { "packet", "beacon" };
+	tNRF24L01BeaconStats sStats;
+	tNRF24L01SimStats sSimStats;
+	char cData[32];
+	unsigned long ulSent = 0;
+	unsigned long ulSinceLastMs = 0;
+	unsigned long long ullStartUs;
+	unsigned long long ullNextTickUs;
+	unsigned long long ullNext;
+	unsigned long long ullElapsedUs;
+	unsigned char ucDone = 0;
+
+	memset(cData, 0x55, sizeof(cData));
+	memset(&sStats, 0, sizeof(sStats));
+	g_ulReceived = 0;
+	g_ucBusy = 0;
+
+	NRF24L01_SimResetStats(&g_sSimPTX);
+
+	ullStartUs = NRF24L01_AirGetTimeUs(&g_sAir);
+	ullNextTickUs = ullStartUs + 1000;
+
+	if(MODE_BEACON == ucMode)
+	{
+		NRF24L01_BeaconStart(&g_sPTX, cData, uiPayload, ucNoAck, ulCount, ulPeriodMs);
+	}
+
+	while(!ucDone)
+	{
+		/* PS: What the IRQ handlers and the main loops would do now */
+		if(0 == NRF24L01_SimGetIRQ(&g_sSimPRX))
+		{
+			ServicePRX(uiPayload);
+		}
+
+		if(MODE_PACKET == ucMode)
+		{
+			if(g_ucBusy && (0 == NRF24L01_SimGetIRQ(&g_sSimPTX)))
+			{
+				NRF24L01_TxAsyncService(&g_sPTX);
+			}
+
+			if(!g_ucBusy && (ulSent < ulCount) && (0 == ulSent || ulSinceLastMs >= ulPeriodMs))
+			{
+				if(PDLIB_NRF24_SUCCESS == (ucNoAck ?
+											NRF24L01_SendDataAsyncNoAck(&g_sPTX, cData, uiPayload, &g_sHandle, TxDone) :
+											NRF24L01_SendDataAsync(&g_sPTX, cData, uiPayload, &g_sHandle, TxDone)))
+				{
+					g_ucBusy = 1;
+					ulSent++;
+					ulSinceLastMs = 0;
+				}
+			}
+
+			ucDone = (!g_ucBusy && (ulSent == ulCount));
+		}else
+		{
+			if(0 == NRF24L01_SimGetIRQ(&g_sSimPTX))
+			{
+				NRF24L01_BeaconService(&g_sPTX);
+			}
+
+			ucDone = !NRF24L01_IsBeaconActive(&g_sPTX);
+		}
+
+		if(ucDone)
+		{
+			break;
+		}
+
+		if(ulPeriodMs && (NRF24L01_AirGetTimeUs(&g_sAir) >= ullNextTickUs))
+		{
+			ullNextTickUs += 1000;
+			ulSinceLastMs++;
+
+			NRF24L01_Tick(&g_sPTX, 1);
+			continue;
+		}
+
+		/* PS: Jump to whatever happens next */
+		ullNext = NRF24L01_AirNextEvent(&g_sAir);
+
+		if(ulPeriodMs && (ullNextTickUs < ullNext))
+		{
+			ullNext = ullNextTickUs;
+		}
+
+		if(ullNext <= NRF24L01_AirGetTimeUs(&g_sAir))
+		{
+			ullNext = NRF24L01_AirGetTimeUs(&g_sAir) + 1;
+		}
+
+		NRF24L01_AirRun(&g_sAir, ullNext);
+	}
+
+	ullElapsedUs = NRF24L01_AirGetTimeUs(&g_sAir) - ullStartUs;
+
+	/* PS: The last payload may still be on its way to the PRX */
+	NRF24L01_AirRun(&g_sAir, NRF24L01_AirGetTimeUs(&g_sAir) + 1000);
+	ServicePRX(uiPayload);
+
+	if(MODE_BEACON == ucMode)
+	{
+		NRF24L01_GetBeaconStats(&g_sPTX, &sStats);
+		ulSent = sStats.ulFired;
+	}
+
+	NRF24L01_SimGetStats(&g_sSimPTX, &sSimStats);
+
+	printf("%-8s %6lu %8lu %10llu %9lu %9lu %9lu %11lu\n", pcModeNames[ucMode], ulSent, g_ulReceived, ullElapsedUs,
+		   sSimStats.ulTransfers, sSimStats.ulSPIBytes, sSimStats.ulCEPulses, sStats.ulBytesSaved);
+}
+
+int main(int argc, char *argv[])
+{
+	tNRF24L01AirConfig sConfig;
+	unsigned char ucAddress[5] = { 0xE7, 0xE7, 0xE7, 0xE7, 0xE7 };
+	unsigned long ulCount = 1000;
+	unsigned int uiPayload = 32;
+	unsigned long ulPeriodMs = 0;
+	unsigned char ucNoAck = 1;
+
+	memset(&sConfig, 0, sizeof(sConfig));
+	sConfig.ulSeed = 1;
+
+	if(argc > 1) ulCount = strtoul(argv[1], NULL, 0);
+	if(argc > 2) uiPayload = (unsigned int)strtoul(argv[2], NULL, 0);
+	if(argc > 3) ulPeriodMs = strtoul(argv[3], NULL, 0);
+	if(argc > 4) ucNoAck = (strtoul(argv[4], NULL, 0) ? 1 : 0);
+	if(argc > 5) sConfig.ulLossPPM = strtoul(argv[5], NULL, 0);
+
+	if((0 == ulCount) || (uiPayload < 1) || (uiPayload > 32))
+	{
+		fprintf(stderr, "usage: %s [count] [payload 1-32] [period_ms] [noack 0/1] [loss_ppm]\n", argv[0]);
+		return 1;
+	}
+
+	NRF24L01_AirInit(&g_sAir, &sConfig);
+	NRF24L01_SimInit(&g_sSimPTX);
+	NRF24L01_SimInit(&g_sSimPRX);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimPTX);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimPRX);
+
+	NRF24L01_InitHAL(&g_sPTX, &g_sNRF24L01SimHAL, &g_sSimPTX);
+	NRF24L01_InitHAL(&g_sPRX, &g_sNRF24L01SimHAL, &g_sSimPRX);
+	NRF24L01_SetPowerPolicy(&g_sPTX, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+	NRF24L01_SetPowerPolicy(&g_sPRX, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+
+	NRF24L01_SetAirDataRate(&g_sPTX, 2);
+	NRF24L01_SetAirDataRate(&g_sPRX, 2);
+	NRF24L01_SetTXAddress(&g_sPTX, ucAddress);
+	NRF24L01_SetRxAddress(&g_sPRX, PDLIB_NRF24_PIPE0, ucAddress);
+	NRF24L01_SetRXPacketSize(&g_sPRX, PDLIB_NRF24_PIPE0, (unsigned char)uiPayload);
+	NRF24L01_EnableRxMode(&g_sPRX);
+
+	printf("%lu transmissions of %u bytes at 2 Mbps, period %lu ms, %s, loss %lu ppm\n\n",
+		   ulCount, uiPayload, ulPeriodMs, ucNoAck ? "no ACK" : "ACK", sConfig.ulLossPPM);
+	printf("mode       sent received   time(us) transfers spi_bytes ce_pulses bytes_saved\n");
+
+	Run(MODE_PACKET, ulCount, uiPayload, ulPeriodMs, ucNoAck);
+	Run(MODE_BEACON, ulCount, uiPayload, ulPeriodMs, ucNoAck);
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * main.c
+ *
+ * Benchmark sweep (common/pdlib_nrf24l01_bench.c) on a simulated link: a PTX
+ * and a PRX on the simulated air. Prints CSV on stdout.
+ *
+ * pdlib_nrf24l01_bench [packets] [loss_ppm]
+ *
+ * Times are simulated, so they are the same on every PC and show what the
+ * driver and the chip cost, not how fast the PC is.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_air.h"
+#include "pdlib_nrf24l01_bench.h"
+
+static tNRF24L01Air g_sAir;
+static tNRF24L01Sim g_sSimPTX;
+static tNRF24L01Sim g_sSimPRX;
+static tNRF24L01 g_sPTX;
+static tNRF24L01 g_sPRX;
+static tNRF24L01Bench g_sBench;
+
+static unsigned long
+GetTimeUs(void *pvArg)
+{
+	(void)pvArg;
+
+	return (unsigned long)NRF24L01_AirGetTimeUs(&g_sAir);
+}
+
+static void
+PrintLine(void *pvArg, const char *pcLine)
+{
+	(void)pvArg;
+
+	puts(pcLine);
+}
+
+int main(int argc, char *argv[])
+{
+	tNRF24L01AirConfig sConfig;
+	tNRF24L01BenchSweep sSweep = g_sNRF24L01BenchDefaultSweep;
+
+	memset(&sConfig, 0, sizeof(sConfig));
+	sConfig.ucCollisions = 1;
+	sConfig.ulSeed = 1;
+
+	if(argc > 1) sSweep.uiPackets = (unsigned int)strtoul(argv[1], NULL, 0);
+	if(argc > 2) sConfig.ulLossPPM = strtoul(argv[2], NULL, 0);
+
+	NRF24L01_AirInit(&g_sAir, &sConfig);
+
+	NRF24L01_SimInit(&g_sSimPTX);
+	NRF24L01_SimInit(&g_sSimPRX);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimPTX);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimPRX);
+
+	/* PS: The benchmark sits between the PTX and its backend to time the SPI */
+	NRF24L01_BenchInit(&g_sBench, &g_sNRF24L01SimHAL, &g_sSimPTX, GetTimeUs, PrintLine, NULL);
+	NRF24L01_InitHAL(&g_sPTX, &g_sNRF24L01BenchHAL, &g_sBench);
+	NRF24L01_InitHAL(&g_sPRX, &g_sNRF24L01SimHAL, &g_sSimPRX);
+
+	NRF24L01_BenchRun(&g_sBench, &g_sPTX, &g_sPRX, &sSweep);
+
+#ifdef NRF24L01_CONF_PROFILE
+	/* PS: CPU time of the driver on the PTX over the whole sweep */
+	NRF24L01_DumpProfile(&g_sPTX, PrintLine, 0);
+#endif
+
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * main.c
+ *
+ * Round-robin polling on the simulated air: one hub (PTX) sends a short
+ * poll to N nodes (PRX, each on its own pipe 0 address) in turn, with auto
+ * ACK, and prints the polls per second and the SPI traffic of the hub for
+ * two ways of switching the target:
+ *
+ * 	readback	-- what the driver did per packet before the address shadow:
+ * 				   write TX_ADDR, read it back, write RX_ADDR_P0
+ * 	book		-- NRF24L01_SelectNode, addresses registered once with
+ * 				   NRF24L01_AddressBookAdd
+ *
+ * pdlib_nrf24l01_poll [nodes] [rounds] [payload] [loss_ppm]
+ *
+ * Build with NRF24L01_CONF_ADDRESS_BOOK. Both modes send with
+ * NRF24L01_SendDataAsync and must poll every node the same number of times.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_air.h"
+
+#ifndef NRF24L01_CONF_ADDRESS_BOOK
+#error "Build with NRF24L01_CONF_ADDRESS_BOOK"
+#endif
+
+#define MAX_NODES		(PDLIB_NRF24_AIR_MAX_RADIOS - 1)
+
+#if MAX_NODES > NRF24L01_CONF_ADDRESS_BOOK_SIZE
+#undef MAX_NODES
+#define MAX_NODES		NRF24L01_CONF_ADDRESS_BOOK_SIZE
+#endif
+
+#define MODE_READBACK	0
+#define MODE_BOOK		1
+
+typedef struct
+{
+	tNRF24L01 sRadio;
+	tNRF24L01Sim sSim;
+	unsigned char ucAddress[5];
+	unsigned long ulReceived;
+}tNode;
+
+static tNRF24L01Air g_sAir;
+static tNRF24L01Sim g_sSimHub;
+static tNRF24L01 g_sHub;
+static tNode g_sNode[MAX_NODES];
+static tNRF24L01TxHandle g_sHandle;
+static unsigned int g_uiNodes;
+static unsigned int g_uiPayload;
+static unsigned char g_ucBusy;
+static int g_iResult;
+
+static void
+TxDone(tNRF24L01 *psRadio, int iResult)
+{
+	(void)psRadio;
+
+	g_ucBusy = 0;
+	g_iResult = iResult;
+}
+
+static void
+ServiceNode(tNode *psNode)
+{
+	char cData[32];
+	char cLength;
+	char cPipe;
+
+	NRF24L01_ClearInterruptFlag(&psNode->sRadio, PDLIB_INTERRUPT_DATA_READY);
+
+	while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(&psNode->sRadio, &cPipe))
+	{
+		cLength = (char)g_uiPayload;
+
+		/* PS: Returns the length read */
+		if(NRF24L01_GetData(&psNode->sRadio, cPipe, cData, &cLength) <= 0)
+		{
+			break;
+		}
+
+		psNode->ulReceived++;
+	}
+}
+
+/* PS: Runs the air until the asynchronous TX of the hub is over, servicing every IRQ on the way */
+static void
+WaitForHub(void)
+{
+	unsigned long long ullNext;
+	unsigned int uiIndex;
+
+	while(g_ucBusy)
+	{
+		for(uiIndex = 0; uiIndex < g_uiNodes; uiIndex++)
+		{
+			if(0 == NRF24L01_SimGetIRQ(&g_sNode[uiIndex].sSim))
+			{
+				ServiceNode(&g_sNode[uiIndex]);
+			}
+		}
+
+		if(0 == NRF24L01_SimGetIRQ(&g_sSimHub))
+		{
+			NRF24L01_TxAsyncService(&g_sHub);
+			continue;
+		}
+
+		/* PS: Jump to whatever happens next */
+		ullNext = NRF24L01_AirNextEvent(&g_sAir);
+
+		if(ullNext <= NRF24L01_AirGetTimeUs(&g_sAir))
+		{
+			ullNext = NRF24L01_AirGetTimeUs(&g_sAir) + 1;
+		}
+
+		NRF24L01_AirRun(&g_sAir, ullNext);
+	}
+}
+
+static void
+Run(unsigned char ucMode, unsigned long ulRounds)
+{
+	static const char * const pcModeNames[] = { "readback", "book" };
+	tNRF24L01SimStats sSimStats;
+	unsigned char ucReadBack[5];
+	char cData[32];
+	unsigned long ulRound;
+	unsigned long ulPolls = 0;
+	unsigned long ulAcked = 0;
+	unsigned long ulReceived = 0;
+	unsigned long long ullStartUs;
+	unsigned long long ullElapsedUs;
+	unsigned int uiIndex;
+
+	memset(cData, 0x5A, sizeof(cData));
+
+	for(uiIndex = 0; uiIndex < g_uiNodes; uiIndex++)
+	{
+		g_sNode[uiIndex].ulReceived = 0;
+	}
+
+	NRF24L01_SimResetStats(&g_sSimHub);
+	ullStartUs = NRF24L01_AirGetTimeUs(&g_sAir);
+
+	for(ulRound = 0; ulRound < ulRounds; ulRound++)
+	{
+		for(uiIndex = 0; uiIndex < g_uiNodes; uiIndex++)
+		{
+			if(MODE_READBACK == ucMode)
+			{
+				NRF24L01_SetTXAddress(&g_sHub, g_sNode[uiIndex].ucAddress);
+				NRF24L01_RegisterRead_Multi(&g_sHub, RF24_TX_ADDR, ucReadBack, 5);
+				NRF24L01_SetRxAddress(&g_sHub, PDLIB_NRF24_PIPE0, ucReadBack);
+			}else
+			{
+				NRF24L01_SelectNode(&g_sHub, (unsigned char)uiIndex);
+			}
+
+			/* PS: The PID repeats every 4 packets, so with 4 or 8 nodes the payload has to
+			 * change from round to round or the node drops it as a retransmission */
+			cData[0] = (char)ulRound;
+
+			if(PDLIB_NRF24_SUCCESS != NRF24L01_SendDataAsync(&g_sHub, cData, g_uiPayload, &g_sHandle, TxDone))
+			{
+				continue;
+			}
+
+			g_ucBusy = 1;
+			ulPolls++;
+
+			WaitForHub();
+
+			if(PDLIB_NRF24_SUCCESS == g_iResult)
+			{
+				ulAcked++;
+			}
+		}
+	}
+
+	ullElapsedUs = NRF24L01_AirGetTimeUs(&g_sAir) - ullStartUs;
+
+	for(uiIndex = 0; uiIndex < g_uiNodes; uiIndex++)
+	{
+		ulReceived += g_sNode[uiIndex].ulReceived;
+	}
+
+	NRF24L01_SimGetStats(&g_sSimHub, &sSimStats);
+
+	printf("%-8s %7lu %7lu %8lu %10llu %10llu %9lu %9lu %11llu\n", pcModeNames[ucMode], ulPolls, ulAcked, ulReceived,
+		   ullElapsedUs, (ullElapsedUs ? ((unsigned long long)ulPolls * 1000000) / ullElapsedUs : 0),
+		   sSimStats.ulTransfers, sSimStats.ulSPIBytes, sSimStats.ullSPITimeUs);
+}
+
+int main(int argc, char *argv[])
+{
+	tNRF24L01AirConfig sConfig;
+	unsigned long ulRounds = 1000;
+	unsigned int uiIndex;
+	tNode *psNode;
+
+	g_uiNodes = MAX_NODES;
+	g_uiPayload = 4;
+
+	memset(&sConfig, 0, sizeof(sConfig));
+	sConfig.ulSeed = 1;
+
+	if(argc > 1) g_uiNodes = (unsigned int)strtoul(argv[1], NULL, 0);
+	if(argc > 2) ulRounds = strtoul(argv[2], NULL, 0);
+	if(argc > 3) g_uiPayload = (unsigned int)strtoul(argv[3], NULL, 0);
+	if(argc > 4) sConfig.ulLossPPM = strtoul(argv[4], NULL, 0);
+
+	if((g_uiNodes < 1) || (g_uiNodes > MAX_NODES) || (0 == ulRounds) || (g_uiPayload < 1) || (g_uiPayload > 32))
+	{
+		fprintf(stderr, "usage: %s [nodes 1-%d] [rounds] [payload 1-32] [loss_ppm]\n", argv[0], MAX_NODES);
+		return 1;
+	}
+
+	/* PS: Every radio is on the air before the driver talks to it */
+	NRF24L01_AirInit(&g_sAir, &sConfig);
+	NRF24L01_SimInit(&g_sSimHub);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimHub);
+
+	for(uiIndex = 0; uiIndex < g_uiNodes; uiIndex++)
+	{
+		NRF24L01_SimInit(&g_sNode[uiIndex].sSim);
+		NRF24L01_AirAddRadio(&g_sAir, &g_sNode[uiIndex].sSim);
+	}
+
+	NRF24L01_InitHAL(&g_sHub, &g_sNRF24L01SimHAL, &g_sSimHub);
+	NRF24L01_SetPowerPolicy(&g_sHub, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+	NRF24L01_SetAirDataRate(&g_sHub, 2);
+
+	/* PS: Node i listens on C2:C2:C2:C2:i on pipe 0, the hub registers every address once */
+	for(uiIndex = 0; uiIndex < g_uiNodes; uiIndex++)
+	{
+		psNode = &g_sNode[uiIndex];
+
+		memset(psNode->ucAddress, 0xC2, 5);
+		psNode->ucAddress[0] = (unsigned char)uiIndex;
+
+		NRF24L01_InitHAL(&psNode->sRadio, &g_sNRF24L01SimHAL, &psNode->sSim);
+		NRF24L01_SetPowerPolicy(&psNode->sRadio, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+		NRF24L01_SetAirDataRate(&psNode->sRadio, 2);
+		NRF24L01_SetRxAddress(&psNode->sRadio, PDLIB_NRF24_PIPE0, psNode->ucAddress);
+		NRF24L01_SetRXPacketSize(&psNode->sRadio, PDLIB_NRF24_PIPE0, (unsigned char)g_uiPayload);
+		NRF24L01_EnableRxMode(&psNode->sRadio);
+
+		NRF24L01_AddressBookAdd(&g_sHub, psNode->ucAddress);
+	}
+
+	/* PS: Let the nodes come out of power down */
+	NRF24L01_AirRun(&g_sAir, NRF24L01_AirGetTimeUs(&g_sAir) + 2000);
+
+	printf("%u nodes, %lu rounds, %u byte polls at 2 Mbps with auto ACK, loss %lu ppm\n\n",
+		   g_uiNodes, ulRounds, g_uiPayload, sConfig.ulLossPPM);
+	printf("mode       polls   acked received   time(us)    polls/s transfers spi_bytes spi_time(us)\n");
+
+	Run(MODE_READBACK, ulRounds);
+	Run(MODE_BOOK, ulRounds);
+
+	return 0;
+}
@@ -0,0 +1,275 @@
+/*
+ * main.c
+ *
+ * SPI engine (NRF24L01_CONF_SPI_ENGINE) on the fake SSI module
+ * (common/pdlib_nrf24l01_ssi_fake.c) in front of a simulated chip. Build
+ * with NRF24L01_CONF_HAL and NRF24L01_CONF_SPI_ENGINE.
+ *
+ * A PTX sends bursts of 1 to 3 payloads to a PRX, which reads them with
+ * NRF24L01_IRQChainStart, static and then dynamic payload length. Every
+ * payload must arrive once, in order and unchanged. The descriptor order
+ * and the full queue are checked by the engine group of the host tests
+ * (test/host/test_engine.c).
+ *
+ * pdlib_nrf24l01_spi_engine [bursts] [fifo_bytes]
+ *
+ * fifo_bytes is how many bytes the SSI clocks between two looks at its
+ * interrupt (1 to 8). Prints the engine statistics and PASS or FAIL.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pdlib_nrf24l01.h"
+#include "nRF24L01.h"
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_air.h"
+#include "pdlib_nrf24l01_ssi_fake.h"
+
+#ifndef NRF24L01_CONF_SPI_ENGINE
+#error "Build with NRF24L01_CONF_SPI_ENGINE"
+#endif
+
+/* PS: Steps of NRF24L01_SSIFakeRun before a test gives up */
+#define RUN_GUARD		100000
+
+static tNRF24L01Air g_sAir;
+static tNRF24L01Sim g_sSimPTX;
+static tNRF24L01Sim g_sSimPRX;
+static tNRF24L01SSIFake g_sSSI;
+static tNRF24L01 g_sPTX;
+static tNRF24L01 g_sPRX;
+static tNRF24L01IRQChain g_sChain;
+
+static unsigned int g_uiFifoBytes = 4;
+static unsigned int g_uiErrors;
+
+static unsigned long g_ulExpected;
+static unsigned long g_ulReceived;
+static unsigned char g_ucDynamic;
+
+static void
+Fail(const char *pcWhat, unsigned long ulValue)
+{
+	printf("error: %s (%lu)\n", pcWhat, ulValue);
+	g_uiErrors++;
+}
+
+/* PS: What the SSI interrupt handler of a target would do */
+static void
+SSIIntHandler(void *pvArg)
+{
+	NRF24L01_SPIEngineService((tNRF24L01 *)pvArg);
+}
+
+/* PS: The SSI runs until the engine is idle */
+static int
+RunEngine(void)
+{
+	unsigned long ulSteps = 0;
+
+	while(!NRF24L01_IsSPIEngineIdle(&g_sPRX) && (ulSteps < RUN_GUARD))
+	{
+		NRF24L01_SSIFakeRun(&g_sSSI, g_uiFifoBytes);
+		ulSteps++;
+	}
+
+	return NRF24L01_IsSPIEngineIdle(&g_sPRX);
+}
+
+static unsigned int
+PayloadLength(unsigned long ulSequence)
+{
+	return (g_ucDynamic ? (unsigned int)(1 + (ulSequence * 7) % 32) : 32);
+}
+
+static void
+PayloadFill(unsigned long ulSequence, char *pcData)
+{
+	unsigned int i;
+
+	for(i = 0; i < 32; i++)
+	{
+		pcData[i] = (char)(ulSequence * 31 + i);
+	}
+}
+
+static void
+ChainPayload(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain)
+{
+	char cData[32];
+
+	(void)psRadio;
+
+	PayloadFill(g_ulExpected, cData);
+
+	if(psChain->ucLength != PayloadLength(g_ulExpected))
+	{
+		Fail("payload length", g_ulExpected);
+	}else if(memcmp(cData, psChain->cData, psChain->ucLength))
+	{
+		Fail("payload data", g_ulExpected);
+	}
+
+	if(psChain->ucPipe != PDLIB_NRF24_PIPE0)
+	{
+		Fail("pipe", psChain->ucPipe);
+	}
+
+	g_ulExpected++;
+	g_ulReceived++;
+}
+
+static void
+TestChain(const char *pcName, unsigned long ulBursts)
+{
+	tNRF24L01SPIEngineStats sStats;
+	unsigned long ulSent = 0;
+	unsigned long ulBurst;
+	unsigned long ulInterrupts = g_sSSI.ulInterrupts;
+	unsigned int uiCount;
+	unsigned int i;
+	char cData[32];
+
+	g_ulExpected = 0;
+	g_ulReceived = 0;
+	NRF24L01_ResetSPIEngineStats(&g_sPRX);
+
+	for(ulBurst = 0; ulBurst < ulBursts; ulBurst++)
+	{
+		/* PS: The RX FIFO of the chip holds three */
+		uiCount = (unsigned int)(1 + ulBurst % 3);
+
+		for(i = 0; i < uiCount; i++)
+		{
+			PayloadFill(ulSent, cData);
+
+			if(NRF24L01_SendData(&g_sPTX, cData, PayloadLength(ulSent)) != PDLIB_NRF24_SUCCESS)
+			{
+				Fail("send", ulSent);
+			}
+
+			ulSent++;
+		}
+
+		/* PS: Let the last ACK finish */
+		NRF24L01_AirRun(&g_sAir, NRF24L01_AirGetTimeUs(&g_sAir) + 500);
+
+		if(NRF24L01_SimGetIRQ(&g_sSimPRX) != 0)
+		{
+			Fail("no IRQ on the PRX", ulBurst);
+			continue;
+		}
+
+		/* PS: What the IRQ handler of a target would do, the GPIO interrupt stays masked until pfnDone */
+		if(NRF24L01_IRQChainStart(&g_sPRX, &g_sChain) != PDLIB_NRF24_SUCCESS)
+		{
+			Fail("chain start", ulBurst);
+		}
+
+		if(!RunEngine() || g_sChain.ucBusy)
+		{
+			Fail("chain stuck", ulBurst);
+		}
+
+		if(g_sChain.uiPayloads != uiCount)
+		{
+			Fail("payloads of the chain", g_sChain.uiPayloads);
+		}
+
+		if(0 == (g_sChain.cState & PDLIB_INTERRUPT_DATA_READY))
+		{
+			Fail("chain state", (unsigned long)g_sChain.cState);
+		}
+
+		if(NRF24L01_SimGetIRQ(&g_sSimPRX) != 1)
+		{
+			Fail("IRQ still low after the chain", ulBurst);
+		}
+	}
+
+	if(g_ulReceived != ulSent)
+	{
+		Fail("received", g_ulReceived);
+	}
+
+	NRF24L01_GetSPIEngineStats(&g_sPRX, &sStats);
+
+	printf("%-8s %6lu %8lu %9lu %9lu %8lu %10lu %10.2f %9u\n", pcName, ulSent, g_ulReceived,
+		   sStats.ulCompleted, sStats.ulBytes, sStats.ulServices, g_sSSI.ulInterrupts - ulInterrupts,
+		   sStats.ulCompleted ? ((double)sStats.ulServices / (double)sStats.ulCompleted) : 0.0, sStats.uiHighWater);
+}
+
+int main(int argc, char *argv[])
+{
+	tNRF24L01AirConfig sConfig;
+	unsigned char ucAddress[5] = { 0xE7, 0xE7, 0xE7, 0xE7, 0xE7 };
+	unsigned long ulBursts = 100;
+
+	if(argc > 1) ulBursts = strtoul(argv[1], NULL, 0);
+	if(argc > 2) g_uiFifoBytes = (unsigned int)strtoul(argv[2], NULL, 0);
+
+	if((0 == ulBursts) || (g_uiFifoBytes < 1) || (g_uiFifoBytes > PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH))
+	{
+		fprintf(stderr, "usage: %s [bursts] [fifo_bytes 1-8]\n", argv[0]);
+		return 1;
+	}
+
+	memset(&sConfig, 0, sizeof(sConfig));
+	sConfig.ulSeed = 1;
+
+	NRF24L01_AirInit(&g_sAir, &sConfig);
+	NRF24L01_SimInit(&g_sSimPTX);
+	NRF24L01_SimInit(&g_sSimPRX);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimPTX);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimPRX);
+
+	NRF24L01_SSIFakeInit(&g_sSSI, &g_sNRF24L01SimHAL, &g_sSimPRX);
+	NRF24L01_SSIFakeSetISR(&g_sSSI, SSIIntHandler, &g_sPRX);
+
+	NRF24L01_InitHAL(&g_sPTX, &g_sNRF24L01SimHAL, &g_sSimPTX);
+	NRF24L01_InitHAL(&g_sPRX, &g_sNRF24L01SSIFakeHAL, &g_sSSI);
+	NRF24L01_SetPowerPolicy(&g_sPTX, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+	NRF24L01_SetPowerPolicy(&g_sPRX, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+
+	NRF24L01_SetAirDataRate(&g_sPTX, 2);
+	NRF24L01_SetAirDataRate(&g_sPRX, 2);
+	NRF24L01_SetTXAddress(&g_sPTX, ucAddress);
+	NRF24L01_SetRxAddress(&g_sPRX, PDLIB_NRF24_PIPE0, ucAddress);
+	NRF24L01_SetRXPacketSize(&g_sPRX, PDLIB_NRF24_PIPE0, 32);
+	NRF24L01_EnableRxMode(&g_sPRX);
+
+	memset(&g_sChain, 0, sizeof(g_sChain));
+	g_sChain.pfnPayload = ChainPayload;
+
+	printf("%lu bursts of 1 to 3 payloads, %u bytes per SSI step, engine depth %u\n\n",
+		   ulBursts, g_uiFifoBytes, NRF24L01_CONF_SPI_ENGINE_DEPTH);
+
+	printf("mode       sent received  transfers spi_bytes services interrupts  svc/xfer high_water\n");
+
+	g_ucDynamic = 0;
+	TestChain("static", ulBursts);
+
+	/* PS: The features are only written outside RX mode */
+	NRF24L01_PowerDown(&g_sPRX);
+	NRF24L01_EnableFeatureDynPL(&g_sPTX, PDLIB_NRF24_PIPE0);
+	NRF24L01_EnableFeatureDynPL(&g_sPRX, PDLIB_NRF24_PIPE0);
+	NRF24L01_EnableRxMode(&g_sPRX);
+
+	/* PS: Start-up of the PRX from Power Down */
+	NRF24L01_AirRun(&g_sAir, NRF24L01_AirGetTimeUs(&g_sAir) + 2000);
+
+	g_ucDynamic = 1;
+	TestChain("dynamic", ulBursts);
+
+	printf("\nssi: %lu bytes, %lu frames, %lu overruns\n", g_sSSI.ulBytes, g_sSSI.ulFrames, g_sSSI.ulOverruns);
+
+	if(g_sSSI.ulOverruns)
+	{
+		Fail("RX FIFO overruns", g_sSSI.ulOverruns);
+	}
+
+	printf("%s\n", g_uiErrors ? "FAIL" : "PASS");
+
+	return (g_uiErrors ? 1 : 0);
+}
@@ -0,0 +1,340 @@
+/*
+ * main.c
+ *
+ * Star network on the simulated air: N PTX nodes send periodic payloads to
+ * one PRX, which listens on pipes 1 to 5. Prints goodput, retransmissions,
+ * failures and latency (submit to TX_DS or MAX_RT) of every node, then one
+ * line per node in CSV.
+ *
+ * pdlib_nrf24l01_star [nodes] [interval_us] [seconds] [payload] [loss_ppm] [seed]
+ *
+ * The SPI transactions of all radios are run one after the other on the
+ * shared time line (one host thread drives every radio), so with many nodes
+ * the SPI time of one node delays the others a little. Real nodes have their
+ * own MCU and SPI bus.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_air.h"
+
+#define MAX_NODES		(PDLIB_NRF24_AIR_MAX_RADIOS - 1)
+#define MAX_SAMPLES		8192
+
+typedef struct
+{
+	tNRF24L01 sRadio;
+	tNRF24L01Sim sSim;
+	tNRF24L01TxHandle sHandle;
+	unsigned char ucBusy;
+	unsigned long ulSequence;
+	unsigned long long ullNextSendUs;
+	unsigned long long ullSubmitUs;
+
+	unsigned long ulSubmitted;
+	unsigned long ulSent;
+	unsigned long ulFailed;
+	unsigned long ulRetries;
+	unsigned long ulReceived;			// Counted by the PRX
+	unsigned long ulLatencyCount;
+	unsigned long ulLatencyUs[MAX_SAMPLES];
+}tNode;
+
+/* PS: Node 0 is the PRX */
+static tNode g_sNode[MAX_NODES + 1];
+static tNRF24L01Air g_sAir;
+static unsigned int g_uiNodes;
+static unsigned int g_uiPayload;
+
+static void
+PipeAddress(unsigned char ucPipe, unsigned char *pucAddress)
+{
+	memset(pucAddress, 0xC2, 5);
+
+	/* PS: P2 to P5 share the upper bytes of P1 */
+	if(ucPipe > 1)
+	{
+		pucAddress[0] = 0xC1 + ucPipe;
+	}
+}
+
+static void
+TxDone(tNRF24L01 *psRadio, int iResult)
+{
+	tNode *psNode = (tNode *)psRadio;		// sRadio is the first member
+	unsigned long long ullNow = NRF24L01_AirGetTimeUs(&g_sAir);
+
+	psNode->ucBusy = 0;
+	psNode->ulRetries += psNode->sHandle.ucRetries;
+
+	if(PDLIB_NRF24_SUCCESS == iResult)
+	{
+		psNode->ulSent++;
+	}else
+	{
+		psNode->ulFailed++;
+	}
+
+	if(psNode->ulLatencyCount < MAX_SAMPLES)
+	{
+		psNode->ulLatencyUs[psNode->ulLatencyCount++] = (unsigned long)(ullNow - psNode->ullSubmitUs);
+	}
+}
+
+static void
+Send(tNode *psNode, unsigned int uiIndex, unsigned long ulIntervalUs)
+{
+	char cData[32];
+	unsigned long long ullNow = NRF24L01_AirGetTimeUs(&g_sAir);
+
+	/* PS: Node, sequence number and send time, the rest is padding */
+	memset(cData, 0, sizeof(cData));
+	cData[0] = (char)uiIndex;
+	memcpy(&cData[1], &psNode->ulSequence, 4);
+
+	if(g_uiPayload >= 13)
+	{
+		memcpy(&cData[5], &ullNow, 8);
+	}
+
+	psNode->ullSubmitUs = ullNow;
+
+	if(PDLIB_NRF24_SUCCESS == NRF24L01_SendDataAsync(&psNode->sRadio, cData, g_uiPayload, &psNode->sHandle, TxDone))
+	{
+		psNode->ucBusy = 1;
+		psNode->ulSequence++;
+		psNode->ulSubmitted++;
+	}
+
+	/* PS: +-25% jitter so the nodes do not lock to each other */
+	psNode->ullNextSendUs = ullNow + ulIntervalUs - (ulIntervalUs / 4) + (rand() % ((ulIntervalUs / 2) + 1));
+}
+
+static void
+ServicePRX(void)
+{
+	tNode *psPRX = &g_sNode[0];
+	char cData[32];
+	char cLength;
+	char cPipe;
+
+	NRF24L01_ClearInterruptFlag(&psPRX->sRadio, PDLIB_INTERRUPT_DATA_READY);
+
+	while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(&psPRX->sRadio, &cPipe))
+	{
+		cLength = (char)g_uiPayload;
+
+		/* PS: Returns the length read */
+		if(NRF24L01_GetData(&psPRX->sRadio, cPipe, cData, &cLength) <= 0)
+		{
+			break;
+		}
+
+		if(((unsigned char)cData[0] >= 1) && ((unsigned char)cData[0] <= g_uiNodes))
+		{
+			g_sNode[(unsigned char)cData[0]].ulReceived++;
+		}
+	}
+}
+
+static int
+CompareUL(const void *pvA, const void *pvB)
+{
+	unsigned long ulA = *(const unsigned long *)pvA;
+	unsigned long ulB = *(const unsigned long *)pvB;
+
+	return (ulA > ulB) - (ulA < ulB);
+}
+
+static unsigned long
+Percentile(tNode *psNode, unsigned int uiPercent)
+{
+	unsigned long ulIndex;
+
+	if(0 == psNode->ulLatencyCount)
+	{
+		return 0;
+	}
+
+	ulIndex = ((psNode->ulLatencyCount - 1) * uiPercent) / 100;
+
+	return psNode->ulLatencyUs[ulIndex];
+}
+
+int main(int argc, char *argv[])
+{
+	tNRF24L01AirConfig sConfig;
+	tNRF24L01AirStats sAirStats;
+	tNRF24L01SimStats sSimStats;
+	unsigned char ucAddress[5];
+	unsigned long ulIntervalUs = 10000;
+	unsigned long ulSeconds = 10;
+	unsigned long long ullEndUs;
+	unsigned long long ullNow;
+	unsigned long long ullNext;
+	unsigned int uiIndex;
+	tNode *psNode;
+
+	g_uiNodes = 4;
+	g_uiPayload = 16;
+
+	memset(&sConfig, 0, sizeof(sConfig));
+	sConfig.ucCollisions = 1;
+	sConfig.ulSeed = 1;
+
+	if(argc > 1) g_uiNodes = (unsigned int)strtoul(argv[1], NULL, 0);
+	if(argc > 2) ulIntervalUs = strtoul(argv[2], NULL, 0);
+	if(argc > 3) ulSeconds = strtoul(argv[3], NULL, 0);
+	if(argc > 4) g_uiPayload = (unsigned int)strtoul(argv[4], NULL, 0);
+	if(argc > 5) sConfig.ulLossPPM = strtoul(argv[5], NULL, 0);
+	if(argc > 6) sConfig.ulSeed = strtoul(argv[6], NULL, 0);
+
+	if((g_uiNodes < 1) || (g_uiNodes > MAX_NODES) || (g_uiPayload < 5) || (g_uiPayload > 32) || (ulIntervalUs < 4) || (0 == ulSeconds))
+	{
+		fprintf(stderr, "usage: %s [nodes 1-%d] [interval_us] [seconds] [payload 5-32] [loss_ppm] [seed]\n", argv[0], MAX_NODES);
+		return 1;
+	}
+
+	srand((unsigned int)sConfig.ulSeed);
+
+	/* PS: Every radio is on the air before the driver talks to it */
+	NRF24L01_AirInit(&g_sAir, &sConfig);
+
+	for(uiIndex = 0; uiIndex <= g_uiNodes; uiIndex++)
+	{
+		NRF24L01_SimInit(&g_sNode[uiIndex].sSim);
+		NRF24L01_AirAddRadio(&g_sAir, &g_sNode[uiIndex].sSim);
+		NRF24L01_InitHAL(&g_sNode[uiIndex].sRadio, &g_sNRF24L01SimHAL, &g_sNode[uiIndex].sSim);
+		NRF24L01_SetPowerPolicy(&g_sNode[uiIndex].sRadio, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+	}
+
+	/* PS: PRX, pipes 1 to 5 */
+	psNode = &g_sNode[0];
+	NRF24L01_RegisterWrite_8(&psNode->sRadio, RF24_EN_RXADDR, 0x3E);
+
+	for(uiIndex = 1; uiIndex < 6; uiIndex++)
+	{
+		NRF24L01_SetRXPacketSize(&psNode->sRadio, uiIndex, g_uiPayload);
+	}
+
+	NRF24L01_EnableRxMode(&psNode->sRadio);
+
+	/* PS: PTX i sends to pipe 1 + (i % 5), P0 takes the ACKs */
+	for(uiIndex = 1; uiIndex <= g_uiNodes; uiIndex++)
+	{
+		psNode = &g_sNode[uiIndex];
+
+		PipeAddress(1 + (uiIndex % 5), ucAddress);
+		NRF24L01_SetTXAddress(&psNode->sRadio, ucAddress);
+		NRF24L01_SetRxAddress(&psNode->sRadio, 0, ucAddress);
+
+		psNode->ullNextSendUs = NRF24L01_AirGetTimeUs(&g_sAir) + (rand() % ulIntervalUs);
+	}
+
+	for(uiIndex = 0; uiIndex <= g_uiNodes; uiIndex++)
+	{
+		NRF24L01_SimResetStats(&g_sNode[uiIndex].sSim);
+	}
+
+	NRF24L01_AirResetStats(&g_sAir);
+
+	ullEndUs = NRF24L01_AirGetTimeUs(&g_sAir) + (unsigned long long)ulSeconds * 1000000;
+
+	for(;;)
+	{
+		ullNow = NRF24L01_AirGetTimeUs(&g_sAir);
+
+		if(ullNow >= ullEndUs)
+		{
+			break;
+		}
+
+		/* PS: What the IRQ handlers and the main loops of the nodes would do now */
+		if(0 == NRF24L01_SimGetIRQ(&g_sNode[0].sSim))
+		{
+			ServicePRX();
+		}
+
+		for(uiIndex = 1; uiIndex <= g_uiNodes; uiIndex++)
+		{
+			psNode = &g_sNode[uiIndex];
+
+			if(psNode->ucBusy && (0 == NRF24L01_SimGetIRQ(&psNode->sSim)))
+			{
+				NRF24L01_TxAsyncService(&psNode->sRadio);
+			}
+
+			if(!psNode->ucBusy && (psNode->ullNextSendUs <= NRF24L01_AirGetTimeUs(&g_sAir)))
+			{
+				Send(psNode, uiIndex, ulIntervalUs);
+			}
+		}
+
+		/* PS: Jump to whatever happens next */
+		ullNext = NRF24L01_AirNextEvent(&g_sAir);
+
+		for(uiIndex = 1; uiIndex <= g_uiNodes; uiIndex++)
+		{
+			if(!g_sNode[uiIndex].ucBusy && (g_sNode[uiIndex].ullNextSendUs < ullNext))
+			{
+				ullNext = g_sNode[uiIndex].ullNextSendUs;
+			}
+		}
+
+		if(ullNext > ullEndUs)
+		{
+			ullNext = ullEndUs;
+		}
+
+		if(ullNext <= NRF24L01_AirGetTimeUs(&g_sAir))
+		{
+			ullNext = NRF24L01_AirGetTimeUs(&g_sAir) + 1;
+		}
+
+		NRF24L01_AirRun(&g_sAir, ullNext);
+	}
+
+	printf("%u nodes, %u byte payload, interval %lu us, %lu s, loss %lu ppm, seed %lu\n\n",
+		   g_uiNodes, g_uiPayload, ulIntervalUs, ulSeconds, sConfig.ulLossPPM, sConfig.ulSeed);
+	printf("node submitted    sent  failed received goodput(B/s) retries collided  p50(us)  p90(us)  p99(us)  max(us)\n");
+
+	for(uiIndex = 1; uiIndex <= g_uiNodes; uiIndex++)
+	{
+		psNode = &g_sNode[uiIndex];
+
+		qsort(psNode->ulLatencyUs, psNode->ulLatencyCount, sizeof(unsigned long), CompareUL);
+		NRF24L01_AirGetStats(&g_sAir, uiIndex, &sAirStats);
+
+		printf("%4u %9lu %7lu %7lu %8lu %13lu %7lu %8lu %8lu %8lu %8lu %8lu\n",
+			   uiIndex, psNode->ulSubmitted, psNode->ulSent, psNode->ulFailed, psNode->ulReceived,
+			   (psNode->ulReceived * g_uiPayload) / ulSeconds, psNode->ulRetries, sAirStats.ulCollided,
+			   Percentile(psNode, 50), Percentile(psNode, 90), Percentile(psNode, 99), Percentile(psNode, 100));
+	}
+
+	NRF24L01_SimGetStats(&g_sNode[0].sSim, &sSimStats);
+	printf("\nPRX: %lu received, %lu duplicates, %lu RX FIFO overflows, %lu ACKs sent, %lu violations\n\n",
+		   sSimStats.ulPacketsReceived, sSimStats.ulDuplicates, sSimStats.ulRxOverflows, sSimStats.ulAcksSent,
+		   sSimStats.ulViolations);
+
+	/* PS: Machine readable */
+	printf("csv,node,submitted,sent,failed,received,goodput_Bps,retries,sim_retransmits,collided,lost,p50_us,p90_us,p99_us,max_us\n");
+
+	for(uiIndex = 1; uiIndex <= g_uiNodes; uiIndex++)
+	{
+		psNode = &g_sNode[uiIndex];
+
+		NRF24L01_AirGetStats(&g_sAir, uiIndex, &sAirStats);
+		NRF24L01_SimGetStats(&psNode->sSim, &sSimStats);
+
+		printf("csv,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+			   uiIndex, psNode->ulSubmitted, psNode->ulSent, psNode->ulFailed, psNode->ulReceived,
+			   (psNode->ulReceived * g_uiPayload) / ulSeconds, psNode->ulRetries, sSimStats.ulRetransmits,
+			   sAirStats.ulCollided, sAirStats.ulLost,
+			   Percentile(psNode, 50), Percentile(psNode, 90), Percentile(psNode, 99), Percentile(psNode, 100));
+	}
+
+	return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * main.c
+ *
+ * Streaming TX (NRF24L01_CONF_TX_STREAM) on the simulated air at 2 Mbps.
+ * One PTX sends the same number of payloads to one PRX four ways and
+ * prints the goodput of each:
+ *
+ * 	packet			-- NRF24L01_SendDataAsync per payload, CE pulsed around every packet
+ * 	packet-noack	-- NRF24L01_SendDataAsyncNoAck per payload
+ * 	stream-ack		-- stream with auto ACK, CE held high
+ * 	stream-noack	-- stream with W_TX_PAYLOAD_NOACK, CE held high
+ *
+ * pdlib_nrf24l01_stream [packets] [payload] [interval_us] [loss_ppm]
+ *
+ * interval_us paces the producer of the streams, 0 writes as fast as the
+ * stream buffer takes it. A producer slower than the air shows up as
+ * underruns.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_air.h"
+
+#ifndef NRF24L01_CONF_TX_STREAM
+#error "Build with NRF24L01_CONF_TX_STREAM"
+#endif
+
+#define STREAM_SLOTS	8
+
+#define MODE_PACKET			0
+#define MODE_PACKET_NOACK	1
+#define MODE_STREAM_ACK		2
+#define MODE_STREAM_NOACK	3
+
+#define IS_STREAM(mode)		((mode) >= MODE_STREAM_ACK)
+
+static tNRF24L01Air g_sAir;
+static tNRF24L01Sim g_sSimPTX;
+static tNRF24L01Sim g_sSimPRX;
+static tNRF24L01 g_sPTX;
+static tNRF24L01 g_sPRX;
+static tNRF24L01TxHandle g_sHandle;
+static char g_cStreamBuffer[STREAM_SLOTS * 32];
+static unsigned long g_ulReceived;
+static unsigned char g_ucBusy;
+
+static void
+TxDone(tNRF24L01 *psRadio, int iResult)
+{
+	(void)psRadio;
+	(void)iResult;
+
+	g_ucBusy = 0;
+}
+
+static void
+ServicePRX(unsigned int uiPayload)
+{
+	char cData[32];
+	char cLength;
+	char cPipe;
+
+	NRF24L01_ClearInterruptFlag(&g_sPRX, PDLIB_INTERRUPT_DATA_READY);
+
+	while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(&g_sPRX, &cPipe))
+	{
+		cLength = (char)uiPayload;
+
+		/* PS: Returns the length read */
+		if(NRF24L01_GetData(&g_sPRX, cPipe, cData, &cLength) <= 0)
+		{
+			break;
+		}
+
+		g_ulReceived++;
+	}
+}
+
+static void
+Run(unsigned char ucMode, unsigned long ulPackets, unsigned int uiPayload, unsigned long ulIntervalUs)
+{
+	static const char * const pcModeNames[] = { "packet", "packet-noack", "stream-ack", "stream-noack" };
+	tNRF24L01StreamStats sStats;
+	tNRF24L01SimStats sSimStats;
+	char cData[32];
+	unsigned long ulWritten = 0;
+	unsigned long long ullStartUs;
+	unsigned long long ullNextWriteUs;
+	unsigned long long ullNext;
+	unsigned long long ullElapsedUs;
+	unsigned char ucDone = 0;
+
+	memset(cData, 0x55, sizeof(cData));
+	memset(&sStats, 0, sizeof(sStats));
+	g_ulReceived = 0;
+	g_ucBusy = 0;
+
+	NRF24L01_SimResetStats(&g_sSimPTX);
+
+	if(IS_STREAM(ucMode))
+	{
+		NRF24L01_ResetStreamStats(&g_sPTX);
+		NRF24L01_StreamStart(&g_sPTX, g_cStreamBuffer, STREAM_SLOTS, (unsigned char)uiPayload, (MODE_STREAM_NOACK == ucMode));
+	}
+
+	ullStartUs = NRF24L01_AirGetTimeUs(&g_sAir);
+	ullNextWriteUs = ullStartUs;
+
+	while(!ucDone)
+	{
+		/* PS: What the IRQ handlers and the main loops would do now */
+		if(0 == NRF24L01_SimGetIRQ(&g_sSimPRX))
+		{
+			ServicePRX(uiPayload);
+		}
+
+		if(!IS_STREAM(ucMode))
+		{
+			if(g_ucBusy && (0 == NRF24L01_SimGetIRQ(&g_sSimPTX)))
+			{
+				NRF24L01_TxAsyncService(&g_sPTX);
+			}
+
+			if(!g_ucBusy && (ulWritten < ulPackets))
+			{
+				if(PDLIB_NRF24_SUCCESS == ((MODE_PACKET_NOACK == ucMode) ?
+											NRF24L01_SendDataAsyncNoAck(&g_sPTX, cData, uiPayload, &g_sHandle, TxDone) :
+											NRF24L01_SendDataAsync(&g_sPTX, cData, uiPayload, &g_sHandle, TxDone)))
+				{
+					g_ucBusy = 1;
+					ulWritten++;
+				}
+			}
+
+			ucDone = (!g_ucBusy && (ulWritten == ulPackets));
+		}else
+		{
+			if(0 == NRF24L01_SimGetIRQ(&g_sSimPTX))
+			{
+				NRF24L01_StreamService(&g_sPTX);
+			}
+
+			while((ulWritten < ulPackets) && (ullNextWriteUs <= NRF24L01_AirGetTimeUs(&g_sAir)))
+			{
+				if(PDLIB_NRF24_SUCCESS != NRF24L01_StreamWrite(&g_sPTX, cData))
+				{
+					break;
+				}
+
+				ulWritten++;
+				ullNextWriteUs += ulIntervalUs;
+			}
+
+			ucDone = ((ulWritten == ulPackets) && NRF24L01_IsStreamIdle(&g_sPTX));
+		}
+
+		if(ucDone)
+		{
+			break;
+		}
+
+		/* PS: Jump to whatever happens next */
+		ullNext = NRF24L01_AirNextEvent(&g_sAir);
+
+		if(IS_STREAM(ucMode) && (ulWritten < ulPackets) && (ullNextWriteUs < ullNext))
+		{
+			ullNext = ullNextWriteUs;
+		}
+
+		if(ullNext <= NRF24L01_AirGetTimeUs(&g_sAir))
+		{
+			ullNext = NRF24L01_AirGetTimeUs(&g_sAir) + 1;
+		}
+
+		NRF24L01_AirRun(&g_sAir, ullNext);
+	}
+
+	ullElapsedUs = NRF24L01_AirGetTimeUs(&g_sAir) - ullStartUs;
+
+	/* PS: The last payloads may still be on their way to the PRX */
+	NRF24L01_AirRun(&g_sAir, NRF24L01_AirGetTimeUs(&g_sAir) + 1000);
+	ServicePRX(uiPayload);
+
+	if(IS_STREAM(ucMode))
+	{
+		NRF24L01_GetStreamStats(&g_sPTX, &sStats);
+		NRF24L01_StreamStop(&g_sPTX);
+	}
+
+	NRF24L01_SimGetStats(&g_sSimPTX, &sSimStats);
+
+	printf("%-12s %8lu %8lu %10llu %11llu %9lu %11lu\n", pcModeNames[ucMode], ulWritten, g_ulReceived, ullElapsedUs,
+		   ullElapsedUs ? ((unsigned long long)g_ulReceived * uiPayload * 8000ULL) / ullElapsedUs : 0ULL,
+		   sStats.ulUnderruns, sSimStats.ulRetransmits);
+}
+
+int main(int argc, char *argv[])
+{
+	tNRF24L01AirConfig sConfig;
+	unsigned char ucAddress[5] = { 0xE7, 0xE7, 0xE7, 0xE7, 0xE7 };
+	unsigned long ulPackets = 1000;
+	unsigned int uiPayload = 32;
+	unsigned long ulIntervalUs = 0;
+	unsigned char ucMode;
+
+	memset(&sConfig, 0, sizeof(sConfig));
+	sConfig.ulSeed = 1;
+
+	if(argc > 1) ulPackets = strtoul(argv[1], NULL, 0);
+	if(argc > 2) uiPayload = (unsigned int)strtoul(argv[2], NULL, 0);
+	if(argc > 3) ulIntervalUs = strtoul(argv[3], NULL, 0);
+	if(argc > 4) sConfig.ulLossPPM = strtoul(argv[4], NULL, 0);
+
+	if((0 == ulPackets) || (uiPayload < 1) || (uiPayload > 32))
+	{
+		fprintf(stderr, "usage: %s [packets] [payload 1-32] [interval_us] [loss_ppm]\n", argv[0]);
+		return 1;
+	}
+
+	NRF24L01_AirInit(&g_sAir, &sConfig);
+	NRF24L01_SimInit(&g_sSimPTX);
+	NRF24L01_SimInit(&g_sSimPRX);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimPTX);
+	NRF24L01_AirAddRadio(&g_sAir, &g_sSimPRX);
+
+	NRF24L01_InitHAL(&g_sPTX, &g_sNRF24L01SimHAL, &g_sSimPTX);
+	NRF24L01_InitHAL(&g_sPRX, &g_sNRF24L01SimHAL, &g_sSimPRX);
+	NRF24L01_SetPowerPolicy(&g_sPTX, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+	NRF24L01_SetPowerPolicy(&g_sPRX, PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+
+	NRF24L01_SetAirDataRate(&g_sPTX, 2);
+	NRF24L01_SetAirDataRate(&g_sPRX, 2);
+	NRF24L01_SetTXAddress(&g_sPTX, ucAddress);
+	NRF24L01_SetRxAddress(&g_sPRX, PDLIB_NRF24_PIPE0, ucAddress);
+	NRF24L01_SetRXPacketSize(&g_sPRX, PDLIB_NRF24_PIPE0, (unsigned char)uiPayload);
+	NRF24L01_EnableRxMode(&g_sPRX);
+
+	printf("%lu packets of %u bytes at 2 Mbps, producer interval %lu us, loss %lu ppm\n\n",
+		   ulPackets, uiPayload, ulIntervalUs, sConfig.ulLossPPM);
+	printf("mode          written received   time(us) goodput(kbps) underruns retransmits\n");
+
+	for(ucMode = MODE_PACKET; ucMode <= MODE_STREAM_NOACK; ucMode++)
+	{
+		Run(ucMode, ulPackets, uiPayload, ulIntervalUs);
+	}
+
+	return 0;
+}
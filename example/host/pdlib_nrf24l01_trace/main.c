@@ -0,0 +1,320 @@
+/*
+ * main.c
+ *
+ * Decoder of the binary trace written by NRF24L01_TraceDrain (build the
+ * driver with NRF24L01_CONF_TRACE). Turns a dump into a timeline, one line
+ * per SPI transaction or radio event, with the commands, registers and
+ * STATUS flags spelled out.
+ *
+ * pdlib_nrf24l01_trace decode [file]		-- file or stdin, eg. a capture of the UART
+ * pdlib_nrf24l01_trace demo [packets]		-- writes the trace of a simulated PTX to stdout
+ *
+ * pdlib_nrf24l01_trace demo 3 | pdlib_nrf24l01_trace decode
+ *
+ * Frames are found by their start byte and checked by their type, so a capture
+ * which starts in the middle of a frame or has UART noise resynchronises.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_air.h"
+
+#ifndef NRF24L01_CONF_TRACE
+#error "Build with NRF24L01_CONF_TRACE"
+#endif
+
+static const char * const g_pcRegisterNames[] =
+{
+	"CONFIG", "EN_AA", "EN_RXADDR", "SETUP_AW", "SETUP_RETR", "RF_CH", "RF_SETUP", "STATUS",
+	"OBSERVE_TX", "CD", "RX_ADDR_P0", "RX_ADDR_P1", "RX_ADDR_P2", "RX_ADDR_P3", "RX_ADDR_P4", "RX_ADDR_P5",
+	"TX_ADDR", "RX_PW_P0", "RX_PW_P1", "RX_PW_P2", "RX_PW_P3", "RX_PW_P4", "RX_PW_P5", "FIFO_STATUS",
+	"0x18", "0x19", "0x1A", "0x1B", "DYNPD", "FEATURE", "0x1E", "0x1F"
+};
+
+static const char * const g_pcISRNames[] =
+{
+	"TxAsyncService", "TxQueueService", "RxQueueService", "StreamService", "BeaconService"
+};
+
+static const char *
+ResultName(signed char cResult)
+{
+	switch(cResult)
+	{
+		case PDLIB_NRF24_SUCCESS:			return "SUCCESS";
+		case PDLIB_NRF24_TX_ARC_REACHED:	return "TX_ARC_REACHED";
+		case PDLIB_NRF24_TX_TIMEOUT:		return "TX_TIMEOUT";
+		default:							return "ERROR";
+	}
+}
+
+static void
+CommandName(unsigned char ucCommand, char *pcText)
+{
+	if(ucCommand < RF24_W_REGISTER)
+	{
+		sprintf(pcText, "R_REGISTER %s", g_pcRegisterNames[ucCommand & RF24_REGISTER_MASK]);
+	}else if(ucCommand <= (RF24_W_REGISTER | RF24_REGISTER_MASK))
+	{
+		sprintf(pcText, "W_REGISTER %s", g_pcRegisterNames[ucCommand & RF24_REGISTER_MASK]);
+	}else if(RF24_W_ACK_PAYLOAD == (ucCommand & 0xF8))
+	{
+		sprintf(pcText, "W_ACK_PAYLOAD P%u", ucCommand & 0x07);
+	}else
+	{
+		switch(ucCommand)
+		{
+			case RF24_R_RX_PAYLOAD:			strcpy(pcText, "R_RX_PAYLOAD"); break;
+			case RF24_W_TX_PAYLOAD:			strcpy(pcText, "W_TX_PAYLOAD"); break;
+			case RF24_W_TX_PAYLOAD_NOACK:	strcpy(pcText, "W_TX_PAYLOAD_NOACK"); break;
+			case RF24_FLUSH_TX:				strcpy(pcText, "FLUSH_TX"); break;
+			case RF24_FLUSH_RX:				strcpy(pcText, "FLUSH_RX"); break;
+			case RF24_REUSE_TX_PL:			strcpy(pcText, "REUSE_TX_PL"); break;
+			case RF24_ACTIVATE:				strcpy(pcText, "ACTIVATE"); break;
+			case RF24_R_RX_PL_WID:			strcpy(pcText, "R_RX_PL_WID"); break;
+			case RF24_NOP:					strcpy(pcText, "NOP"); break;
+			default:						sprintf(pcText, "0x%02X", ucCommand); break;
+		}
+	}
+}
+
+static void
+StatusText(unsigned char ucStatus, char *pcText)
+{
+	unsigned char ucPipe = ((ucStatus >> 1) & 0x07);
+
+	sprintf(pcText, "STATUS 0x%02X%s%s%s%s", ucStatus,
+			(ucStatus & RF24_RX_DR) ? " RX_DR" : "",
+			(ucStatus & RF24_TX_DS) ? " TX_DS" : "",
+			(ucStatus & RF24_MAX_RT) ? " MAX_RT" : "",
+			(ucStatus & RF24_TX_FULL) ? " TX_FULL" : "");
+
+	if(ucPipe < 6)
+	{
+		sprintf(pcText + strlen(pcText), " RX_P%u", ucPipe);
+	}
+}
+
+static int
+Decode(FILE *psFile)
+{
+	unsigned char ucFrame[PDLIB_NRF24_TRACE_FRAME_SIZE];
+	unsigned int uiHave = 0;
+	int iByte;
+	unsigned long ulRate = 1000000;
+	unsigned long ulSequence;
+	unsigned long ulTime;
+	unsigned long ulLastTime = 0;
+	unsigned long long ullTicks = 0;
+	unsigned long ulEntries = 0;
+	unsigned long ulSkipped = 0;
+	unsigned char ucStarted = 0;
+	unsigned char ucType;
+	char cCommand[40];
+	char cStatus[64];
+
+	printf("%14s %12s %8s  event\n", "time_us", "delta_us", "seq");
+
+	while(EOF != (iByte = fgetc(psFile)))
+	{
+		if((0 == uiHave) && (PDLIB_NRF24_TRACE_FRAME_START != iByte))
+		{
+			ulSkipped++;
+			continue;
+		}
+
+		ucFrame[uiHave++] = (unsigned char)iByte;
+
+		if(uiHave < PDLIB_NRF24_TRACE_FRAME_SIZE)
+		{
+			continue;
+		}
+
+		ucType = ucFrame[9];
+
+		if(ucType > PDLIB_NRF24_TRACE_UNDERRUN)
+		{
+			/* PS: Not a frame, look for the next start byte after this one */
+			unsigned int uiIndex;
+
+			for(uiIndex = 1; (uiIndex < uiHave) && (PDLIB_NRF24_TRACE_FRAME_START != ucFrame[uiIndex]); uiIndex++);
+
+			ulSkipped += uiIndex;
+			memmove(ucFrame, ucFrame + uiIndex, uiHave - uiIndex);
+			uiHave -= uiIndex;
+			continue;
+		}
+
+		uiHave = 0;
+
+		ulSequence = ucFrame[1] | (ucFrame[2] << 8) | (ucFrame[3] << 16) | ((unsigned long)ucFrame[4] << 24);
+		ulTime = ucFrame[5] | (ucFrame[6] << 8) | (ucFrame[7] << 16) | ((unsigned long)ucFrame[8] << 24);
+
+		if(PDLIB_NRF24_TRACE_CLOCK == ucType)
+		{
+			ulRate = ulTime ? ulTime : 1000000;
+			printf("# clock %lu ticks per second\n", ulRate);
+			continue;
+		}
+
+		if(PDLIB_NRF24_TRACE_LOST == ucType)
+		{
+			printf("# %lu entries lost\n", ulTime);
+			continue;
+		}
+
+		/* PS: The clock of the target wraps at 32 bits, the difference does not */
+		if(ucStarted)
+		{
+			ullTicks += (unsigned long)(ulTime - ulLastTime);
+		}
+
+		printf("%14.3f %12.3f %8lu  ", (double)ullTicks * 1e6 / ulRate,
+				ucStarted ? (double)(unsigned long)(ulTime - ulLastTime) * 1e6 / ulRate : 0.0, ulSequence);
+
+		ulLastTime = ulTime;
+		ucStarted = 1;
+		ulEntries++;
+
+		StatusText(ucFrame[12], cStatus);
+
+		switch(ucType)
+		{
+			case PDLIB_NRF24_TRACE_SPI:
+				CommandName(ucFrame[10], cCommand);
+				printf("SPI %-24s %2u bytes  %s\n", cCommand, ucFrame[11], cStatus);
+				break;
+			case PDLIB_NRF24_TRACE_CE:
+				printf("CE %s\n", ucFrame[10] ? "high" : "low");
+				break;
+			case PDLIB_NRF24_TRACE_ATTEMPT_TX:
+				printf("AttemptTx\n");
+				break;
+			case PDLIB_NRF24_TRACE_WAIT_RX:
+				printf("WaitForDataRx\n");
+				break;
+			case PDLIB_NRF24_TRACE_TX_FIFO_FULL:
+				CommandName(ucFrame[10], cCommand);
+				printf("TX FIFO full, %s of %u bytes dropped  %s\n", cCommand, ucFrame[11], cStatus);
+				break;
+			case PDLIB_NRF24_TRACE_MAX_RT:
+				printf("MAX_RT  %s\n", cStatus);
+				break;
+			case PDLIB_NRF24_TRACE_TX_DONE:
+				printf("TX done %s, %u retries\n", ResultName((signed char)ucFrame[12]), ucFrame[10]);
+				break;
+			case PDLIB_NRF24_TRACE_ISR:
+				printf("ISR %s\n", (ucFrame[10] < (sizeof(g_pcISRNames) / sizeof(g_pcISRNames[0]))) ? g_pcISRNames[ucFrame[10]] : "?");
+				break;
+			case PDLIB_NRF24_TRACE_UNDERRUN:
+				printf("stream underrun, %u payloads waiting  %s\n", ucFrame[11], cStatus);
+				break;
+			case PDLIB_NRF24_TRACE_MARK:
+				printf("mark %u\n", ucFrame[10]);
+				break;
+		}
+	}
+
+	printf("# %lu entries, %lu bytes skipped\n", ulEntries, ulSkipped);
+
+	return 0;
+}
+
+/* PS: Demo: a simulated PTX sends to a simulated PRX, the trace of the PTX goes to stdout */
+
+static void
+WriteTrace(void *pvArg, const unsigned char *pucData, unsigned int uiLength)
+{
+	fwrite(pucData, 1, uiLength, (FILE *)pvArg);
+}
+
+static int
+Demo(unsigned int uiPackets)
+{
+	static tNRF24L01Air sAir;
+	static tNRF24L01Sim sSimPTX;
+	static tNRF24L01Sim sSimPRX;
+	static tNRF24L01 sPTX;
+	static tNRF24L01 sPRX;
+	tNRF24L01AirConfig sConfig;
+	char cPayload[8] = "trace";
+	char cLength;
+	char cPipe;
+	unsigned int uiIndex;
+
+	memset(&sConfig, 0, sizeof(sConfig));
+	sConfig.ulSeed = 1;
+
+	NRF24L01_AirInit(&sAir, &sConfig);
+	NRF24L01_SimInit(&sSimPTX);
+	NRF24L01_SimInit(&sSimPRX);
+	NRF24L01_AirAddRadio(&sAir, &sSimPTX);
+	NRF24L01_AirAddRadio(&sAir, &sSimPRX);
+
+	NRF24L01_InitHAL(&sPTX, &g_sNRF24L01SimHAL, &sSimPTX);
+	NRF24L01_InitHAL(&sPRX, &g_sNRF24L01SimHAL, &sSimPRX);
+
+	NRF24L01_SetRXPacketSize(&sPRX, 0, sizeof(cPayload));
+	NRF24L01_EnableRxMode(&sPRX);
+
+	/* PS: Only the sends are traced */
+	NRF24L01_TraceDrain(&sPTX, WriteTrace, stdout, ~0U);
+
+	for(uiIndex = 0; uiIndex < uiPackets; uiIndex++)
+	{
+		NRF24L01_TraceMark(&sPTX, (unsigned char)uiIndex);
+
+		cPayload[7] = (char)uiIndex;
+		NRF24L01_SendData(&sPTX, cPayload, sizeof(cPayload));
+		NRF24L01_ClearInterruptFlag(&sPTX, PDLIB_INTERRUPT_DATA_SENT | PDLIB_INTERRUPT_MAX_RT);
+
+		while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(&sPRX, &cPipe))
+		{
+			cLength = sizeof(cPayload);
+			NRF24L01_GetData(&sPRX, cPipe, cPayload, &cLength);
+		}
+
+		/* PS: What the main loop of a target would do between packets */
+		NRF24L01_TraceDrain(&sPTX, WriteTrace, stdout, ~0U);
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *psFile = stdin;
+	int iRet = 1;
+
+	if((argc > 1) && (0 == strcmp(argv[1], "decode")))
+	{
+		if(argc > 2)
+		{
+			psFile = fopen(argv[2], "rb");
+
+			if(NULL == psFile)
+			{
+				perror(argv[2]);
+				return 1;
+			}
+		}
+
+		iRet = Decode(psFile);
+
+		if(stdin != psFile)
+		{
+			fclose(psFile);
+		}
+	}else if((argc > 1) && (0 == strcmp(argv[1], "demo")))
+	{
+		iRet = Demo((argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : 3);
+	}else
+	{
+		fprintf(stderr, "usage: %s decode [file] | demo [packets]\n", argv[0]);
+	}
+
+	return iRet;
+}
@@ -16,6 +16,9 @@
 
 void ReceiveDataISR();
 
+/* PS: Driver instance of the radio */
+static tNRF24L01 g_sRadio;
+
 int main(void) {
 	//int status;
 	//char pipe;
@@ -33,21 +36,21 @@ int main(void) {
 //	InitUARTDebug();
 
 	/* PS: Initialize the module, need to provide CE pin, CSN pin and SSI module information */
-	NRF24L01_Init(GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03);
+	NRF24L01_Init(&g_sRadio, GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03, PDLIB_NRF24_SPI_BITRATE_AUTO);
 
 	/* PS: Initialize interrupt */
-	NRF24L01_InterruptInit(GPIO_PORTE_BASE, GPIO_PIN_3, SYSCTL_PERIPH_GPIOE, INT_GPIOE);
+	NRF24L01_InterruptInit(&g_sRadio, GPIO_PORTE_BASE, GPIO_PIN_3, SYSCTL_PERIPH_GPIOE, INT_GPIOE);
 
 	/* Set the address */
-	NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, address);
+	NRF24L01_SetRxAddress(&g_sRadio, PDLIB_NRF24_PIPE0, address);
 
 	/* Enable ack payload */
-	NRF24L01_EnableFeatureAckPL();
+	NRF24L01_EnableFeatureAckPL(&g_sRadio);
 
 	/* Set the first ack payload */
-	NRF24L01_SetAckPayload(data, 0x00, 17);
+	NRF24L01_SetAckPayload(&g_sRadio, data, 0x00, 17);
 
-	NRF24L01_EnableRxMode();
+	NRF24L01_EnableRxMode(&g_sRadio);
 
 	while(1)
 	{
@@ -86,31 +89,31 @@ void ReceiveDataISR(){
 		ROM_GPIOPinIntClear(GPIO_PORTE_BASE, GPIO_PIN_3);
 
 		// Check which pipe contains data
-		status = NRF24L01_IsDataReadyRx(&pipe_no);
+		status = NRF24L01_IsDataReadyRx(&g_sRadio, &pipe_no);
 
 		if(PDLIB_NRF24_SUCCESS == status)
 		{
 			// Get data amount in the pipe
-			temp = NRF24L01_GetRxDataAmount(pipe_no);
+			temp = NRF24L01_GetRxDataAmount(&g_sRadio, pipe_no);
 		//	PrintRegValue("Data Available in: ",pipe_no);
 		//	PrintRegValue("Data amount available : ",temp);
 			memset(data,0x00,32);
 
 			// Get data from the pipe
-			status = NRF24L01_GetData(pipe_no, data, &temp);
+			status = NRF24L01_GetData(&g_sRadio, pipe_no, data, &temp);
 		//	PrintString("Data Read: ");
 		//	PrintString((const char*)data);
 		//	PrintString("\n\r");
 
 			/* Put the next ack payload */
-			NRF24L01_SetAckPayload(data_ack, 0x00, 17);
+			NRF24L01_SetAckPayload(&g_sRadio, data_ack, 0x00, 17);
 		}
 
 		/* Check whether ACK payload is properly sent */
-		interrupt_flag = NRF24L01_GetInterruptState();
+		interrupt_flag = NRF24L01_GetInterruptState(&g_sRadio);
 
 		if(PDLIB_INTERRUPT_DATA_SENT & interrupt_flag){
-			NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_SENT | PDLIB_INTERRUPT_MAX_RT);
+			NRF24L01_ClearInterruptFlag(&g_sRadio, PDLIB_INTERRUPT_DATA_SENT | PDLIB_INTERRUPT_MAX_RT);
 		}
 	}
 
@@ -11,10 +11,12 @@
 #include "driverlib/rom.h"
 //#include "uart_debug.h"
 #include "inc/hw_ints.h"
-#include <stdlib.h>
 
 void TransmitDataISR();
 
+/* PS: Driver instance of the radio */
+static tNRF24L01 g_sRadio;
+
 int main(void) {
 	int status;
 	unsigned char address[5] = {0xDE, 0xAD, 0xBE, 0xEF, 0x01};
@@ -29,44 +31,44 @@ int main(void) {
 	//InitUARTDebug();
 
 	/* PS: Initialize the module, need to provide CE pin, CSN pin and SSI module information */
-	NRF24L01_Init(GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03);
+	NRF24L01_Init(&g_sRadio, GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03, PDLIB_NRF24_SPI_BITRATE_AUTO);
 
 	/* PS: Initialize interrupt */
-	NRF24L01_InterruptInit(GPIO_PORTE_BASE, GPIO_PIN_3, SYSCTL_PERIPH_GPIOE, INT_GPIOE);
+	NRF24L01_InterruptInit(&g_sRadio, GPIO_PORTE_BASE, GPIO_PIN_3, SYSCTL_PERIPH_GPIOE, INT_GPIOE);
 
 	/* Enable Ack payload */
-	NRF24L01_EnableFeatureAckPL();
+	NRF24L01_EnableFeatureAckPL(&g_sRadio);
 
 	/* Set the address */
-	NRF24L01_SetTXAddress(address);
+	NRF24L01_SetTXAddress(&g_sRadio, address);
 
 	while(1)
 	{
-		if(0 == NRF24L01_IsTxFifoFull()){
+		if(0 == NRF24L01_IsTxFifoFull(&g_sRadio)){
 			/* Send data */
-			status = NRF24L01_SubmitData(data, 23);
+			status = NRF24L01_SubmitData(&g_sRadio, data, 23);
 
 			if(PDLIB_NRF24_SUCCESS == status){
-				NRF24L01_EnableTxMode();
+				NRF24L01_EnableTxMode(&g_sRadio);
 			}
 		}
 
-		status = NRF24L01_RegisterRead_8(0x00);
-		status = NRF24L01_GetStatus();
+		status = NRF24L01_RegisterRead_8(&g_sRadio, 0x00);
+		status = NRF24L01_GetStatus(&g_sRadio);
 #if 0
 		/* Send data */
-		status = NRF24L01_SendData(data, 23);
+		status = NRF24L01_SendData(&g_sRadio, data, 23);
 
 		if(PDLIB_NRF24_TX_FIFO_FULL == status)
 		{
 			/* If TX Fifo is full, we can flush it */
-			NRF24L01_FlushTX();
+			NRF24L01_FlushTX(&g_sRadio);
 		}else if(PDLIB_NRF24_TX_ARC_REACHED == status)
 		{
 			while(status == PDLIB_NRF24_TX_ARC_REACHED)
 			{
 				/* Automatic retransmission count reached, we'll attempt the TX continuously until the TX completes */
-				status = NRF24L01_AttemptTx();
+				status = NRF24L01_AttemptTx(&g_sRadio);
 			}
 		}
 #endif
@@ -86,7 +88,7 @@ void TransmitDataISR(){
 	long interrupts;
 	char interrupt_flag = 0;
 	char pipe = 0;
-	char *data = NULL;
+	char data[32];
 
 	// Disable global interrupts
 	ROM_IntMasterDisable();
@@ -107,29 +109,24 @@ void TransmitDataISR(){
 		 * the interrupt is due to Data-Sent/Rcv or ARC reached.
 		 */
 
-		interrupt_flag = NRF24L01_GetInterruptState();
+		interrupt_flag = NRF24L01_GetInterruptState(&g_sRadio);
 
 		if(interrupt_flag & PDLIB_INTERRUPT_DATA_READY){
 			/* Data ready in PTX device means it is an ACK payload
 			 * Get the pipe address, data amount and data. */
-			status = NRF24L01_IsDataReadyRx(&pipe);
+			status = NRF24L01_IsDataReadyRx(&g_sRadio, &pipe);
 
 			if(PDLIB_NRF24_SUCCESS == status){
-				status = NRF24L01_GetAckDataAmount(pipe);
-
-				if(status > 0){
+				status = NRF24L01_GetAckDataAmount(&g_sRadio);
 
-					data = (char *)malloc(sizeof(char) * status);
+				if((status > 0) && (status <= 32)){
 
-					if(data){
-						NRF24L01_ReadRxPayload(data, status);
+					NRF24L01_ReadRxPayload(&g_sRadio, data, status);
 
-						/* Clear interrupt */
-						NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+					/* Clear interrupt */
+					NRF24L01_ClearInterruptFlag(&g_sRadio, PDLIB_INTERRUPT_DATA_READY);
 
-						//PrintString(data);
-						free(data);
-					}
+					//PrintString(data);
 				}
 			}
 		}
@@ -137,19 +134,18 @@ void TransmitDataISR(){
 		if(interrupt_flag & PDLIB_INTERRUPT_MAX_RT){
 
 			// Retry transmission
-			NRF24L01_EnableTxMode();
+			NRF24L01_EnableTxMode(&g_sRadio);
 
 		}
 
 		if(interrupt_flag & PDLIB_INTERRUPT_DATA_SENT){
 
-			if(0 == NRF24L01_IsTxFifoEmpty()){
+			if(0 == NRF24L01_IsTxFifoEmpty(&g_sRadio)){
 				// Since TX FIFO is not empty we'll retry sending the rest of the data
-				NRF24L01_EnableTxMode();
+				NRF24L01_EnableTxMode(&g_sRadio);
 			}else{
-				// No data in the FIFO we'll disable the TX mode
-				NRF24L01_DisableTxMode();
-				NRF24L01_PowerDown();
+				// No data in the FIFO we'll disable the TX mode (power policy decides on power down)
+				NRF24L01_DisableTxMode(&g_sRadio);
 			}
 		}
 	}
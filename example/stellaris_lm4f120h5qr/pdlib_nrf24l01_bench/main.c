@@ -0,0 +1,98 @@
+/*
+ * main.c
+ *
+ * Benchmark sweep (common/pdlib_nrf24l01_bench.c) with two radios on one
+ * Launchpad, results on UART0 (uart_debug, 9600 baud) as CSV.
+ *
+ * Build with NRF24L01_CONF_HAL and add pdlib_nrf24l01_hal_stellaris.c and
+ * common/pdlib_nrf24l01_bench.c to the project.
+ *
+ * 	PTX	: SSI3 (PD0-PD3), CE PE1, CSN PE2, IRQ PE3
+ * 	PRX	: SSI0 (PA2-PA5), CE PA6, CSN PA7
+ *
+ * SSI2 is not used: PB6/PB7 are tied to PD0/PD1 on the Launchpad.
+ */
+
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_hal_stellaris.h"
+#include "pdlib_nrf24l01_bench.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/rom.h"
+
+void InitUARTDebug(void);
+void PrintString(const char *string_val);
+
+/* PS: Driver instances and backends of the radios */
+static tNRF24L01 g_sPTX;
+static tNRF24L01 g_sPRX;
+static tNRF24L01StellarisHAL g_sPTXHAL;
+static tNRF24L01StellarisHAL g_sPRXHAL;
+static tNRF24L01Bench g_sBench;
+
+/* PS: Microsecond clock from TIMER0, a free running 32 bit down counter */
+static unsigned long g_ulTicksPerUs;
+static unsigned long g_ulLastTicks;
+static unsigned long long g_ullTicks;
+
+static unsigned long
+GetTimeUs(void *pvArg)
+{
+	unsigned long ulNow = ROM_TimerValueGet(TIMER0_BASE, TIMER_A);
+
+	/* PS: Called far more often than the counter wraps (53 s at 80 MHz) */
+	g_ullTicks += (g_ulLastTicks - ulNow);
+	g_ulLastTicks = ulNow;
+
+	return (unsigned long)(g_ullTicks / g_ulTicksPerUs);
+}
+
+static void
+PrintLine(void *pvArg, const char *pcLine)
+{
+	PrintString(pcLine);
+	PrintString("\n\r");
+}
+
+int main(void) {
+
+	/* PS: Set the clock frequency of the processor */
+	ROM_SysCtlClockSet(SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ | SYSCTL_SYSDIV_5);
+
+	InitUARTDebug();
+
+	ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+	ROM_TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
+	ROM_TimerLoadSet(TIMER0_BASE, TIMER_A, 0xFFFFFFFF);
+	ROM_TimerEnable(TIMER0_BASE, TIMER_A);
+
+	g_ulTicksPerUs = ROM_SysCtlClockGet() / 1000000;
+	g_ulLastTicks = ROM_TimerValueGet(TIMER0_BASE, TIMER_A);
+
+	NRF24L01_StellarisHALInit(&g_sPTXHAL, GPIO_PORTE_BASE, GPIO_PIN_1, SYSCTL_PERIPH_GPIOE,
+							  GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE,
+							  GPIO_PORTE_BASE, GPIO_PIN_3, SYSCTL_PERIPH_GPIOE, 0x03, NRF24L01_CONF_SPI_MAX_BITRATE);
+
+	NRF24L01_StellarisHALInit(&g_sPRXHAL, GPIO_PORTA_BASE, GPIO_PIN_6, SYSCTL_PERIPH_GPIOA,
+							  GPIO_PORTA_BASE, GPIO_PIN_7, SYSCTL_PERIPH_GPIOA,
+							  0, 0, 0, 0x00, NRF24L01_CONF_SPI_MAX_BITRATE);
+
+	/* PS: The benchmark sits between the PTX and its backend to time the SPI */
+	NRF24L01_BenchInit(&g_sBench, &g_sNRF24L01StellarisHAL, &g_sPTXHAL, GetTimeUs, PrintLine, 0);
+	NRF24L01_InitHAL(&g_sPTX, &g_sNRF24L01BenchHAL, &g_sBench);
+	NRF24L01_InitHAL(&g_sPRX, &g_sNRF24L01StellarisHAL, &g_sPRXHAL);
+
+	NRF24L01_BenchRun(&g_sBench, &g_sPTX, &g_sPRX, &g_sNRF24L01BenchDefaultSweep);
+
+#ifdef NRF24L01_CONF_PROFILE
+	/* PS: CPU time of the driver on the PTX over the whole sweep */
+	NRF24L01_DumpProfile(&g_sPTX, PrintLine, 0);
+#endif
+
+	while(1)
+	{
+	}
+}
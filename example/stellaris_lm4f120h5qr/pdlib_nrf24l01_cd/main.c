@@ -14,6 +14,9 @@
 #include "inc/hw_ints.h"
 //#include "uart_debug.h"
 
+/* PS: Driver instance of the radio */
+static tNRF24L01 g_sRadio;
+
 int main(void) {
 	unsigned char address[5] = {0xDE, 0xAD, 0xBE, 0xEF, 0x01};
 
@@ -26,11 +29,11 @@ int main(void) {
 	//InitUARTDebug();
 
 	/* PS: Initialize the module, need to provide CE pin, CSN pin and SSI module information */
-	NRF24L01_Init(GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03);
+	NRF24L01_Init(&g_sRadio, GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03, PDLIB_NRF24_SPI_BITRATE_AUTO);
 
 	/* Set the address */
-	NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, address);
-	NRF24L01_EnableRxMode();
+	NRF24L01_SetRxAddress(&g_sRadio, PDLIB_NRF24_PIPE0, address);
+	NRF24L01_EnableRxMode(&g_sRadio);
 	ROM_SysCtlDelay(ROM_SysCtlClockGet() / 60);
 
 	int i = 0;
@@ -40,14 +43,14 @@ int main(void) {
 		for(i=0; i<64; i++){
 
 			/* PS: Change RF channel */
-			NRF24L01_SetRFChannel(i);
+			NRF24L01_SetRFChannel(&g_sRadio, i);
 			ROM_SysCtlDelay(ROM_SysCtlClockGet() / 30);
 
-			if(NRF24L01_CarrierDetect()){
+			if(NRF24L01_CarrierDetect(&g_sRadio)){
 				/* PS: Carrier detected on current RF channel */
 				//PrintRegValue("Detected: ",i);
 
-				NRF24L01_FlushRX();
+				NRF24L01_FlushRX(&g_sRadio);
 			}else{
 				//PrintRegValue("None: ",i);
 			}
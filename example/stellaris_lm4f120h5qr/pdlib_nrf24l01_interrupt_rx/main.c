@@ -16,6 +16,9 @@
 
 void ReceiveDataISR();
 
+/* PS: Driver instance of the radio */
+static tNRF24L01 g_sRadio;
+
 int main(void) {
 	//int status;
 	//char pipe;
@@ -33,31 +36,31 @@ int main(void) {
 	//InitUARTDebug();
 
 	/* PS: Initialize the module, need to provide CE pin, CSN pin and SSI module information */
-	NRF24L01_Init(GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03);
+	NRF24L01_Init(&g_sRadio, GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03, PDLIB_NRF24_SPI_BITRATE_AUTO);
 
 	/* PS: Initialize interrupt */
-	NRF24L01_InterruptInit(GPIO_PORTE_BASE, GPIO_PIN_3, SYSCTL_PERIPH_GPIOE, INT_GPIOE);
+	NRF24L01_InterruptInit(&g_sRadio, GPIO_PORTE_BASE, GPIO_PIN_3, SYSCTL_PERIPH_GPIOE, INT_GPIOE);
 
 	/* Set the address */
-	NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, address);
+	NRF24L01_SetRxAddress(&g_sRadio, PDLIB_NRF24_PIPE0, address);
 
 	/* Set the packet size */
-	NRF24L01_SetRXPacketSize(PDLIB_NRF24_PIPE0, 23);
+	NRF24L01_SetRXPacketSize(&g_sRadio, PDLIB_NRF24_PIPE0, 23);
 
-	NRF24L01_EnableRxMode();
+	NRF24L01_EnableRxMode(&g_sRadio);
 
 	while(1)
 	{
 		/* Receive data */
-		/*status = NRF24L01_WaitForDataRx(&pipe);
+		/*status = NRF24L01_WaitForDataRx(&g_sRadio, &pipe);
 
 		if(PDLIB_NRF24_SUCCESS == status)
 		{
-			temp = NRF24L01_GetRxDataAmount(pipe);
+			temp = NRF24L01_GetRxDataAmount(&g_sRadio, pipe);
 			PrintRegValue("Data Available in: ",pipe);
 			PrintRegValue("Data amount available : ",temp);
 			memset(data,0x00,32);
-			status = NRF24L01_GetData(pipe, data, &temp);
+			status = NRF24L01_GetData(&g_sRadio, pipe, data, &temp);
 			PrintString("Data Read: ");
 			PrintString((const char*)data);
 			PrintString("\n\r");
@@ -95,19 +98,17 @@ void ReceiveDataISR(){
 		// Clear the interrupt
 		ROM_GPIOPinIntClear(GPIO_PORTE_BASE, GPIO_PIN_3);
 
-		// Check which pipe contains data
-		status = NRF24L01_IsDataReadyRx(&pipe_no);
-
-		if(PDLIB_NRF24_SUCCESS == status)
+		// Read every payload in the RX FIFO, more than one can arrive before the ISR runs
+		while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(&g_sRadio, &pipe_no))
 		{
 			// Get data amount in the pipe
-			temp = NRF24L01_GetRxDataAmount(pipe_no);
+			temp = NRF24L01_GetRxDataAmount(&g_sRadio, pipe_no);
 			//PrintRegValue("Data Available in: ",pipe_no);
 			//PrintRegValue("Data amount available : ",temp);
 			memset(data,0x00,32);
 
 			// Get data from the pipe
-			status = NRF24L01_GetData(pipe_no, data, &temp);
+			status = NRF24L01_GetData(&g_sRadio, pipe_no, data, &temp);
 			//PrintString("Data Read: ");
 			//PrintString((const char*)data);
 			//PrintString("\n\r");
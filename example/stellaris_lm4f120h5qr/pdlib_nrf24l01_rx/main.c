@@ -14,6 +14,9 @@
 #include "inc/hw_ints.h"
 //#include "uart_debug.h"
 
+/* PS: Driver instance of the radio */
+static tNRF24L01 g_sRadio;
+
 int main(void) {
 	int status;
 	char pipe;
@@ -31,26 +34,26 @@ int main(void) {
 	//InitUARTDebug();
 
 	/* PS: Initialize the module, need to provide CE pin, CSN pin and SSI module information */
-	NRF24L01_Init(GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03);
+	NRF24L01_Init(&g_sRadio, GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03, PDLIB_NRF24_SPI_BITRATE_AUTO);
 
 	/* Set the address */
-	NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, address);
+	NRF24L01_SetRxAddress(&g_sRadio, PDLIB_NRF24_PIPE0, address);
 
 	/* Set the packet size */
-	NRF24L01_SetRXPacketSize(PDLIB_NRF24_PIPE0, 23);
+	NRF24L01_SetRXPacketSize(&g_sRadio, PDLIB_NRF24_PIPE0, 23);
 
 	while(1)
 	{
 		/* Receive data */
-		status = NRF24L01_WaitForDataRx(&pipe);
+		status = NRF24L01_WaitForDataRx(&g_sRadio, &pipe);
 
 		if(PDLIB_NRF24_SUCCESS == status)
 		{
-			temp = NRF24L01_GetRxDataAmount(pipe);
+			temp = NRF24L01_GetRxDataAmount(&g_sRadio, pipe);
 			//PrintRegValue("Data Available in: ",pipe);
 			//PrintRegValue("Data amount available : ",temp);
 			memset(data,0x00,32);
-			status = NRF24L01_GetData(pipe, data, &temp);
+			status = NRF24L01_GetData(&g_sRadio, pipe, data, &temp);
 			//PrintString("Data Read: ");
 			//PrintString((const char*)data);
 			//PrintString("\n\r");
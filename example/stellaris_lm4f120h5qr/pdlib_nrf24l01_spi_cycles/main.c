@@ -0,0 +1,184 @@
+/*
+ * main.c
+ *
+ * CPU cycles of one SPI transaction on the byte path of the ROM (what the
+ * driver does without NRF24L01_CONF_FAST_SPI, done here by hand) against the
+ * direct register path of NRF24L01_CONF_FAST_SPI, counted with the DWT cycle
+ * counter. Results on UART0 (uart_debug, 9600 baud) as CSV:
+ *
+ * 	path,data_bytes,cycles		-- fastest of RUNS transactions
+ * 	path,per_byte,cycles		-- (cycles of 32 bytes - cycles of 0 bytes) / 32
+ *
+ * Build with NRF24L01_CONF_FAST_SPI. The radio is wired as in the other
+ * examples, which is the default wiring of NRF24L01_CONF_FAST_SPI:
+ *
+ * 	SSI3 (PD0-PD3), CE PE1, CSN PE2
+ *
+ * Also builds with NRF24L01_CONF_STATIC_WIRING (the SPI bit rate then comes from the wiring header).
+ *
+ * The fast path is timed through NRF24L01_SendCommand/NRF24L01_SendRcvCommand,
+ * so its counts also hold the status bookkeeping of the driver.
+ */
+
+#include "pdlib_nrf24l01.h"
+#include "pdlib_spi.h"
+#include "nRF24L01.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/rom.h"
+
+#ifndef NRF24L01_CONF_FAST_SPI
+#error "Build with NRF24L01_CONF_FAST_SPI"
+#endif
+
+void InitUARTDebug(void);
+void PrintString(const char *string_val);
+
+/* PS: DWT cycle counter of the Cortex-M4 */
+#define DEMCR				0xE000EDFC
+#define DEMCR_TRCENA		(1UL << 24)
+#define DWT_CTRL			0xE0001000
+#define DWT_CYCCNTENA		(1UL << 0)
+#define DWT_CYCCNT			0xE0001004
+
+/* PS: Transactions timed per length, the fastest counts */
+#define RUNS				16
+
+#define PATH_ROM			0
+#define PATH_FAST			1
+
+static tNRF24L01 g_sRadio;
+static unsigned char g_ucBuffer[32];
+
+static void
+PrintNumber(unsigned long ulValue)
+{
+	char cText[11];
+	int i = 10;
+
+	cText[i] = '\0';
+
+	do
+	{
+		cText[--i] = '0' + (ulValue % 10);
+		ulValue /= 10;
+	}while(ulValue && i);
+
+	PrintString(&cText[i]);
+}
+
+static void
+PrintResult(unsigned char ucPath, const char *pcWhat, unsigned long ulCycles)
+{
+	PrintString((PATH_ROM == ucPath) ? "rom," : "fast,");
+	PrintString(pcWhat);
+	PrintString(",");
+	PrintNumber(ulCycles);
+	PrintString("\n\r");
+}
+
+/* PS: The byte path of the driver without NRF24L01_CONF_FAST_SPI */
+static void
+RomTransaction(unsigned char ucCommand, unsigned char *pucTxData, unsigned char *pucRxData, unsigned int uiLength)
+{
+	ROM_GPIOPinWrite(NRF24L01_CONF_CSN_BASE, NRF24L01_CONF_CSN_PIN, 0x00);
+
+	pdlibSPI_TransferByte(NRF24L01_CONF_SSI, ucCommand);
+
+	if(uiLength > 0)
+	{
+		pdlibSPI_TransferData(NRF24L01_CONF_SSI, pucTxData, pucRxData, uiLength);
+	}
+
+	ROM_GPIOPinWrite(NRF24L01_CONF_CSN_BASE, NRF24L01_CONF_CSN_PIN, 0xFF);
+}
+
+/* PS: A read of uiLength bytes (NOP for 0) or a 32 byte payload write, the TX FIFO is flushed after it */
+static unsigned long
+Measure(unsigned char ucPath, unsigned int uiLength, unsigned char ucWrite)
+{
+	unsigned long ulBest = 0xFFFFFFFF;
+	unsigned long ulStart;
+	unsigned long ulCycles;
+	unsigned char ucCommand;
+	int i;
+
+	ucCommand = (ucWrite ? RF24_W_TX_PAYLOAD : ((uiLength > 0) ? (RF24_R_REGISTER | RF24_RX_ADDR_P0) : RF24_NOP));
+
+	for(i = 0; i < RUNS; i++)
+	{
+		ulStart = HWREG(DWT_CYCCNT);
+
+		if(PATH_ROM == ucPath)
+		{
+			RomTransaction(ucCommand, (ucWrite ? g_ucBuffer : 0), (ucWrite ? 0 : g_ucBuffer), uiLength);
+		}else if(ucWrite)
+		{
+			NRF24L01_SendCommand(&g_sRadio, ucCommand, (char *)g_ucBuffer, uiLength);
+		}else if(uiLength > 0)
+		{
+			NRF24L01_SendRcvCommand(&g_sRadio, ucCommand, (char *)g_ucBuffer, uiLength);
+		}else
+		{
+			NRF24L01_SendCommand(&g_sRadio, ucCommand, 0, 0);
+		}
+
+		ulCycles = HWREG(DWT_CYCCNT) - ulStart;
+
+		if(ulCycles < ulBest)
+		{
+			ulBest = ulCycles;
+		}
+
+		if(ucWrite)
+		{
+			NRF24L01_FlushTX(&g_sRadio);
+		}
+	}
+
+	return ulBest;
+}
+
+int main(void) {
+	unsigned char ucPath;
+	unsigned long ulZero;
+	unsigned long ulFull;
+
+	/* PS: Set the clock frequency of the processor */
+	ROM_SysCtlClockSet(SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ | SYSCTL_SYSDIV_5);
+
+	InitUARTDebug();
+
+	HWREG(DEMCR) |= DEMCR_TRCENA;
+	HWREG(DWT_CTRL) |= DWT_CYCCNTENA;
+
+#ifdef NRF24L01_CONF_STATIC_WIRING
+	NRF24L01_InitStatic(&g_sRadio);
+#else
+	NRF24L01_Init(&g_sRadio, NRF24L01_CONF_CE_BASE, NRF24L01_CONF_CE_PIN, NRF24L01_CONF_CE_PERIPH,
+				  NRF24L01_CONF_CSN_BASE, NRF24L01_CONF_CSN_PIN, NRF24L01_CONF_CSN_PERIPH, NRF24L01_CONF_SSI,
+				  NRF24L01_CONF_SPI_MAX_BITRATE);
+#endif
+
+	PrintString("path,data_bytes,cycles\n\r");
+
+	for(ucPath = PATH_ROM; ucPath <= PATH_FAST; ucPath++)
+	{
+		ulZero = Measure(ucPath, 0, 0);
+		PrintResult(ucPath, "0", ulZero);
+		PrintResult(ucPath, "1", Measure(ucPath, 1, 0));
+		PrintResult(ucPath, "5", Measure(ucPath, 5, 0));
+
+		ulFull = Measure(ucPath, 32, 1);
+		PrintResult(ucPath, "32", ulFull);
+		PrintResult(ucPath, "per_byte", (ulFull - ulZero) / 32);
+	}
+
+	PrintString("# done\n\r");
+
+	while(1)
+	{
+	}
+}
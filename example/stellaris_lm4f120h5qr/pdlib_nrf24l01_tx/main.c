@@ -11,6 +11,9 @@
 #include "driverlib/rom.h"
 //#include "uart_debug.h"
 
+/* PS: Driver instance of the radio */
+static tNRF24L01 g_sRadio;
+
 int main(void) {
 	int status;
 	unsigned char address[5] = {0xDE, 0xAD, 0xBE, 0xEF, 0x01};
@@ -25,26 +28,26 @@ int main(void) {
 	//InitUARTDebug();
 
 	/* PS: Initialize the module, need to provide CE pin, CSN pin and SSI module information */
-	NRF24L01_Init(GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03);
+	NRF24L01_Init(&g_sRadio, GPIO_PORTE_BASE,GPIO_PIN_1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, 0x03, PDLIB_NRF24_SPI_BITRATE_AUTO);
 
 	/* Set the address */
-	NRF24L01_SetTXAddress(address);
+	NRF24L01_SetTXAddress(&g_sRadio, address);
 
 	while(1)
 	{
 		/* Send data */
-		status = NRF24L01_SendData(data, 23);
+		status = NRF24L01_SendData(&g_sRadio, data, 23);
 
 		if(PDLIB_NRF24_TX_FIFO_FULL == status)
 		{
 			/* If TX Fifo is full, we can flush it */
-			NRF24L01_FlushTX();
+			NRF24L01_FlushTX(&g_sRadio);
 		}else if(PDLIB_NRF24_TX_ARC_REACHED == status)
 		{
 			while(status == PDLIB_NRF24_TX_ARC_REACHED)
 			{
 				/* Automatic retransmission count reached, we'll attempt the TX continuously until the TX completes */
-				status = NRF24L01_AttemptTx();
+				status = NRF24L01_AttemptTx(&g_sRadio);
 			}
 		}
 
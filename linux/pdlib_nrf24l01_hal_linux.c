@@ -0,0 +1,399 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * NRF24L01_CONF_HAL backend for Linux. SPI goes through spidev, every
+ * driver transaction is one SPI_IOC_MESSAGE ioctl (command byte and data
+ * in one message, the kernel holds CS for the whole of it). CE is a GPIO
+ * character device line handle and IRQ is a GPIO line event, so waiting
+ * for IRQ sleeps in poll() instead of reading STATUS over SPI.
+ *
+ * Uses the GPIO character device ABI v1 (Linux 4.8 or newer).
+ *
+ * Git repo:
+ *
+ * https://github.com/pradeepa-s/pdlib_nrf24l01.git
+ *
+ */
+
+/* PS: clock_gettime with -std=c99 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_hal_linux.h"
+
+/* PS: Longest data phase sent from the NOP fill buffer (payloads and addresses fit) */
+#define LINUX_FILL_SIZE		32
+
+static unsigned char _NRF24L01_LinuxTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+											 unsigned char *pucRxData, unsigned int uiLength);
+static void _NRF24L01_LinuxSetCE(void *pvContext, unsigned char ucLevel);
+static int _NRF24L01_LinuxWaitIRQ(void *pvContext, unsigned long ulTimeoutUs);
+static unsigned long _NRF24L01_LinuxGetTimeUs(void *pvContext);
+static int _NRF24L01_LinuxGetIRQ(void *pvContext);
+
+/* PS: spidev owns the chip select, there is no CSN function */
+const tNRF24L01HAL g_sNRF24L01LinuxHAL =
+{
+	_NRF24L01_LinuxTransfer,
+	_NRF24L01_LinuxSetCE,
+	NULL,
+	_NRF24L01_LinuxWaitIRQ,
+	_NRF24L01_LinuxGetTimeUs,
+	NULL,
+	NULL,
+	NULL,
+	_NRF24L01_LinuxGetIRQ
+};
+
+static const unsigned char g_ucNOPFill[LINUX_FILL_SIZE] =
+{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_LinuxHALOpen
+ *
+ * Arguments	: 	psContext	:	Context to fill, pass it to NRF24L01_InitHAL
+ * 					pcSPIDevice	:	spidev node, eg. "/dev/spidev0.0"
+ * 					ulSPIBitRate:	SPI bit rate in Hz
+ * 					pcGPIOChip	:	GPIO character device, eg. "/dev/gpiochip0"
+ * 					uiCELine	:	Line offset of CE on pcGPIOChip
+ * 					iIRQLine	:	Line offset of IRQ on pcGPIOChip, -1 if not connected
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS	:	Ready to use
+ * 					PDLIB_NRF24_ERROR	:	A device could not be opened or configured
+ * 											(errno is in psContext->iLastError)
+ *
+ * Description	: 	Opens and configures SPI mode 0, 8 bit words, MSB first. CE is
+ * 					requested as an output driven low, IRQ as an input reporting
+ * 					falling edges. Nothing is left open on failure.
+ *
+ */
+
+int
+NRF24L01_LinuxHALOpen(	tNRF24L01LinuxHAL *psContext,
+						const char *pcSPIDevice,
+						unsigned long ulSPIBitRate,
+						const char *pcGPIOChip,
+						unsigned int uiCELine,
+						int iIRQLine)
+{
+	unsigned char ucMode = SPI_MODE_0;
+	unsigned char ucBits = 8;
+	unsigned int uiSpeed = (unsigned int)ulSPIBitRate;
+	struct gpiohandle_request sCERequest;
+	struct gpioevent_request sIRQRequest;
+	int iChipFd;
+
+	memset(psContext, 0, sizeof(tNRF24L01LinuxHAL));
+	psContext->iSPIFd = -1;
+	psContext->iCEFd = -1;
+	psContext->iIRQFd = -1;
+	psContext->ulSPIBitRate = ulSPIBitRate;
+
+	psContext->iSPIFd = open(pcSPIDevice, O_RDWR);
+
+	if((psContext->iSPIFd < 0) ||
+	   (ioctl(psContext->iSPIFd, SPI_IOC_WR_MODE, &ucMode) < 0) ||
+	   (ioctl(psContext->iSPIFd, SPI_IOC_WR_BITS_PER_WORD, &ucBits) < 0) ||
+	   (ioctl(psContext->iSPIFd, SPI_IOC_WR_MAX_SPEED_HZ, &uiSpeed) < 0))
+	{
+		psContext->iLastError = errno;
+		NRF24L01_LinuxHALClose(psContext);
+		return PDLIB_NRF24_ERROR;
+	}
+
+	iChipFd = open(pcGPIOChip, O_RDWR);
+
+	if(iChipFd < 0)
+	{
+		psContext->iLastError = errno;
+		NRF24L01_LinuxHALClose(psContext);
+		return PDLIB_NRF24_ERROR;
+	}
+
+	memset(&sCERequest, 0, sizeof(sCERequest));
+	sCERequest.lineoffsets[0] = uiCELine;
+	sCERequest.lines = 1;
+	sCERequest.flags = GPIOHANDLE_REQUEST_OUTPUT;
+	sCERequest.default_values[0] = 0;
+	strncpy(sCERequest.consumer_label, "nrf24l01-ce", sizeof(sCERequest.consumer_label) - 1);
+
+	if(ioctl(iChipFd, GPIO_GET_LINEHANDLE_IOCTL, &sCERequest) < 0)
+	{
+		psContext->iLastError = errno;
+		close(iChipFd);
+		NRF24L01_LinuxHALClose(psContext);
+		return PDLIB_NRF24_ERROR;
+	}
+
+	psContext->iCEFd = sCERequest.fd;
+
+	if(iIRQLine >= 0)
+	{
+		memset(&sIRQRequest, 0, sizeof(sIRQRequest));
+		sIRQRequest.lineoffset = (unsigned int)iIRQLine;
+		sIRQRequest.handleflags = GPIOHANDLE_REQUEST_INPUT;
+		sIRQRequest.eventflags = GPIOEVENT_REQUEST_FALLING_EDGE;
+		strncpy(sIRQRequest.consumer_label, "nrf24l01-irq", sizeof(sIRQRequest.consumer_label) - 1);
+
+		if(ioctl(iChipFd, GPIO_GET_LINEEVENT_IOCTL, &sIRQRequest) < 0)
+		{
+			psContext->iLastError = errno;
+			close(iChipFd);
+			NRF24L01_LinuxHALClose(psContext);
+			return PDLIB_NRF24_ERROR;
+		}
+
+		psContext->iIRQFd = sIRQRequest.fd;
+	}
+
+	/* PS: The line handles stay valid after the chip is closed */
+	close(iChipFd);
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_LinuxHALClose
+ *
+ * Arguments	: 	psContext	:	Context filled by NRF24L01_LinuxHALOpen
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Releases the SPI device and the GPIO lines.
+ *
+ */
+
+void
+NRF24L01_LinuxHALClose(tNRF24L01LinuxHAL *psContext)
+{
+	if(psContext->iIRQFd >= 0)
+	{
+		close(psContext->iIRQFd);
+		psContext->iIRQFd = -1;
+	}
+
+	if(psContext->iCEFd >= 0)
+	{
+		close(psContext->iCEFd);
+		psContext->iCEFd = -1;
+	}
+
+	if(psContext->iSPIFd >= 0)
+	{
+		close(psContext->iSPIFd);
+		psContext->iSPIFd = -1;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_LinuxTransfer
+ *
+ * Arguments	: 	See pfnTransfer in pdlib_nrf24l01_hal.h
+ *
+ * Return		: 	Status register value. 0xFF if the ioctl failed (bit 7 of
+ * 					STATUS always reads 0 on a working bus).
+ *
+ * Description	: 	The command byte and the data are two segments of one message,
+ * 					ie. one system call and one CS low period per transaction.
+ *
+ */
+
+static unsigned char
+_NRF24L01_LinuxTransfer(void *pvContext, unsigned char ucCommand, unsigned char *pucTxData,
+						unsigned char *pucRxData, unsigned int uiLength)
+{
+	tNRF24L01LinuxHAL *psContext = (tNRF24L01LinuxHAL *)pvContext;
+	struct spi_ioc_transfer sTransfer[2];
+	unsigned char ucStatus = 0xFF;
+
+	memset(sTransfer, 0, sizeof(sTransfer));
+
+	sTransfer[0].tx_buf = (unsigned long)&ucCommand;
+	sTransfer[0].rx_buf = (unsigned long)&ucStatus;
+	sTransfer[0].len = 1;
+	sTransfer[0].speed_hz = (unsigned int)psContext->ulSPIBitRate;
+	sTransfer[0].bits_per_word = 8;
+
+	if(uiLength > 0)
+	{
+		if(pucTxData != NULL)
+		{
+			sTransfer[1].tx_buf = (unsigned long)pucTxData;
+		}else if(uiLength <= LINUX_FILL_SIZE)
+		{
+			sTransfer[1].tx_buf = (unsigned long)g_ucNOPFill;
+		}
+
+		sTransfer[1].rx_buf = (unsigned long)pucRxData;
+		sTransfer[1].len = uiLength;
+		sTransfer[1].speed_hz = (unsigned int)psContext->ulSPIBitRate;
+		sTransfer[1].bits_per_word = 8;
+	}
+
+	if(ioctl(psContext->iSPIFd, SPI_IOC_MESSAGE((uiLength > 0) ? 2 : 1), sTransfer) < 0)
+	{
+		psContext->iLastError = errno;
+		return 0xFF;
+	}
+
+	return ucStatus;
+}
+
+
+static void
+_NRF24L01_LinuxSetCE(void *pvContext, unsigned char ucLevel)
+{
+	tNRF24L01LinuxHAL *psContext = (tNRF24L01LinuxHAL *)pvContext;
+	struct gpiohandle_data sData;
+
+	memset(&sData, 0, sizeof(sData));
+	sData.values[0] = ucLevel ? 1 : 0;
+
+	if(ioctl(psContext->iCEFd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &sData) < 0)
+	{
+		psContext->iLastError = errno;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_LinuxWaitIRQ
+ *
+ * Arguments	: 	See pfnWaitIRQ in pdlib_nrf24l01_hal.h
+ *
+ * Return		: 	1 if IRQ is low (or not connected), 0 on timeout
+ *
+ * Description	: 	IRQ is level triggered (low while any flag is set) but the
+ * 					kernel reports edges. The level is checked first, then the
+ * 					thread sleeps until a falling edge. Edges left over from
+ * 					interrupts that were already handled are read and ignored.
+ *
+ */
+
+static int
+_NRF24L01_LinuxWaitIRQ(void *pvContext, unsigned long ulTimeoutUs)
+{
+	tNRF24L01LinuxHAL *psContext = (tNRF24L01LinuxHAL *)pvContext;
+	struct gpiohandle_data sData;
+	struct gpioevent_data sEvent;
+	struct pollfd sPoll;
+	unsigned long ulStart;
+	unsigned long ulElapsed;
+	int iTimeoutMs;
+
+	if(psContext->iIRQFd < 0)
+	{
+		return 1;
+	}
+
+	ulStart = _NRF24L01_LinuxGetTimeUs(pvContext);
+
+	while(1)
+	{
+		memset(&sData, 0, sizeof(sData));
+
+		if(ioctl(psContext->iIRQFd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &sData) < 0)
+		{
+			psContext->iLastError = errno;
+			return 1;
+		}
+
+		if(0 == sData.values[0])
+		{
+			return 1;
+		}
+
+		if(PDLIB_NRF24_HAL_WAIT_FOREVER == ulTimeoutUs)
+		{
+			iTimeoutMs = -1;
+		}else
+		{
+			ulElapsed = _NRF24L01_LinuxGetTimeUs(pvContext) - ulStart;
+
+			if(ulElapsed >= ulTimeoutUs)
+			{
+				return 0;
+			}
+
+			iTimeoutMs = (int)((ulTimeoutUs - ulElapsed + 999) / 1000);
+		}
+
+		sPoll.fd = psContext->iIRQFd;
+		sPoll.events = POLLIN | POLLPRI;
+		sPoll.revents = 0;
+
+		if(poll(&sPoll, 1, iTimeoutMs) < 0)
+		{
+			if(errno != EINTR)
+			{
+				psContext->iLastError = errno;
+				return 1;
+			}
+		}else if(sPoll.revents)
+		{
+			if(read(psContext->iIRQFd, &sEvent, sizeof(sEvent)) < 0)
+			{
+				psContext->iLastError = errno;
+			}
+		}
+	}
+}
+
+
+static int
+_NRF24L01_LinuxGetIRQ(void *pvContext)
+{
+	tNRF24L01LinuxHAL *psContext = (tNRF24L01LinuxHAL *)pvContext;
+	struct gpiohandle_data sData;
+
+	if(psContext->iIRQFd < 0)
+	{
+		return 0;
+	}
+
+	memset(&sData, 0, sizeof(sData));
+
+	if(ioctl(psContext->iIRQFd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &sData) < 0)
+	{
+		psContext->iLastError = errno;
+		return 0;
+	}
+
+	return (0 == sData.values[0]) ? 1 : 0;
+}
+
+
+static unsigned long
+_NRF24L01_LinuxGetTimeUs(void *pvContext)
+{
+	struct timespec sNow;
+
+	(void)pvContext;
+
+	clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+	return (unsigned long)sNow.tv_sec * 1000000UL + (unsigned long)(sNow.tv_nsec / 1000);
+}
@@ -0,0 +1,22 @@
+#ifndef _PDLIB_NRF24L01_HAL_LINUX
+#define _PDLIB_NRF24L01_HAL_LINUX
+
+#include "pdlib_nrf24l01_hal.h"
+
+/* PS: Context of a radio on a Linux SPI bus. Filled by NRF24L01_LinuxHALOpen */
+typedef struct
+{
+	int iSPIFd;					// /dev/spidevX.Y
+	int iCEFd;					// GPIO line handle of CE (output)
+	int iIRQFd;					// GPIO line event of IRQ (falling edge), -1 if not used
+	unsigned long ulSPIBitRate;
+	int iLastError;				// errno of the last failed system call, 0 if none
+}tNRF24L01LinuxHAL;
+
+extern const tNRF24L01HAL g_sNRF24L01LinuxHAL;
+
+int NRF24L01_LinuxHALOpen(tNRF24L01LinuxHAL *psContext, const char *pcSPIDevice, unsigned long ulSPIBitRate,
+						  const char *pcGPIOChip, unsigned int uiCELine, int iIRQLine);
+void NRF24L01_LinuxHALClose(tNRF24L01LinuxHAL *psContext);
+
+#endif
@@ -0,0 +1,106 @@
+#!/bin/sh
+#
+# Builds the host test suite in every configuration and runs it.
+# Run from anywhere, the exit status is 0 only if every build and every
+# test passed. Binaries go to $OUT (default test/host/out).
+#
+#	test/host/build.sh
+#	CC=clang test/host/build.sh
+#
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+OUT=${OUT:-$ROOT/test/host/out}
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--std=gnu99 -O2 -Wall -Wextra}
+
+DRIVER="$ROOT/arm/stellaris_lm4f120h5qr/pdlib_nrf24l01.c"
+SUITE="$ROOT/test/host/main.c $ROOT/test/host/test_link.c $ROOT/test/host/test_sim.c $ROOT/test/host/test_spi.c $ROOT/test/host/test_dma.c $ROOT/test/host/test_status.c $ROOT/test/host/test_queue.c $ROOT/test/host/test_power.c $ROOT/test/host/test_fake.c $ROOT/test/host/test_config.c $ROOT/test/host/test_stream.c $ROOT/test/host/test_engine.c $ROOT/test/host/test_trace.c $ROOT/test/host/test_profile.c $ROOT/test/host/test_address.c"
+SIM="$ROOT/common/pdlib_nrf24l01_sim.c $ROOT/common/pdlib_nrf24l01_air.c"
+FAKE="$ROOT/common/pdlib_nrf24l01_hal_fake.c"
+SSI="$ROOT/common/pdlib_nrf24l01_ssi_fake.c"
+STELLARIS="$ROOT/arm/stellaris_lm4f120h5qr/pdlib_spi.c $SSI $ROOT/test/host/stellaris/stellaris_fake.c"
+INCLUDES="-I$ROOT/test/host -I$ROOT/common -I$ROOT/arm/stellaris_lm4f120h5qr -I$ROOT/test/host/stellaris"
+
+FAILED=0
+
+# build <name> <flags> <sources>
+build()
+{
+	echo "== $1"
+
+	if ! $CC $CFLAGS $2 $INCLUDES -o "$OUT/$1" $3; then
+		echo "FAIL $1 (build)"
+		FAILED=1
+		return
+	fi
+
+	if ! "$OUT/$1"; then
+		FAILED=1
+	fi
+}
+
+mkdir -p "$OUT" || exit 1
+
+build pdlib_nrf24l01_test_hal \
+	"-DNRF24L01_CONF_HAL -DNRF24L01_CONF_TRANSACTION_STATS" \
+	"$SUITE $DRIVER $SIM $FAKE"
+
+# The queues drained by their IRQ handlers, linked without the heap
+build pdlib_nrf24l01_test_hal_queue \
+	"-DNRF24L01_CONF_HAL -DNRF24L01_CONF_TRANSACTION_STATS -DNRF24L01_CONF_INTERRUPT_PIN -DNRF24L01_CONF_TX_QUEUE -DNRF24L01_CONF_RX_QUEUE -DNRF24L01_CONF_NO_HEAP" \
+	"$SUITE $DRIVER $SIM $FAKE"
+
+# The TX stream, serviced as its IRQ handler would
+build pdlib_nrf24l01_test_hal_stream \
+	"-DNRF24L01_CONF_HAL -DNRF24L01_CONF_TRANSACTION_STATS -DNRF24L01_CONF_TX_STREAM" \
+	"$SUITE $DRIVER $SIM $FAKE"
+
+# The trace ring, small enough for the tests to lap it
+build pdlib_nrf24l01_test_hal_trace \
+	"-DNRF24L01_CONF_HAL -DNRF24L01_CONF_TRANSACTION_STATS -DNRF24L01_CONF_TRACE -DNRF24L01_CONF_TRACE_DEPTH=8" \
+	"$SUITE $DRIVER $SIM $FAKE"
+
+# The function profiles, timed by the host clock
+build pdlib_nrf24l01_test_hal_profile \
+	"-DNRF24L01_CONF_HAL -DNRF24L01_CONF_TRANSACTION_STATS -DNRF24L01_CONF_PROFILE" \
+	"$SUITE $DRIVER $SIM $FAKE"
+
+# The address book of a PTX
+build pdlib_nrf24l01_test_hal_address \
+	"-DNRF24L01_CONF_HAL -DNRF24L01_CONF_TRANSACTION_STATS -DNRF24L01_CONF_ADDRESS_BOOK" \
+	"$SUITE $DRIVER $SIM $FAKE"
+
+# The SPI engine on the fake SSI module
+build pdlib_nrf24l01_test_hal_engine \
+	"-DNRF24L01_CONF_HAL -DNRF24L01_CONF_TRANSACTION_STATS -DNRF24L01_CONF_SPI_ENGINE -DNRF24L01_CONF_INTERRUPT_PIN" \
+	"$SUITE $DRIVER $SIM $FAKE $SSI"
+
+# The built-in SSI code on the Stellaris fake (test/host/stellaris)
+build pdlib_nrf24l01_test_stellaris \
+	"-DPART_LM4F120H5QR -DPDLIB_SPI" \
+	"$SUITE $DRIVER $SIM $STELLARIS"
+
+build pdlib_nrf24l01_test_stellaris_udma \
+	"-DPART_LM4F120H5QR -DPDLIB_SPI -DPDLIB_SPI_CONF_UDMA -DNRF24L01_CONF_NO_HEAP" \
+	"$SUITE $DRIVER $SIM $STELLARIS"
+
+build pdlib_nrf24l01_test_stellaris_engine \
+	"-DPART_LM4F120H5QR -DPDLIB_SPI -DNRF24L01_CONF_SPI_ENGINE" \
+	"$SUITE $DRIVER $SIM $STELLARIS"
+
+# CE, CSN and the SSI registers stored directly, wired as TestBoardInit
+build pdlib_nrf24l01_test_stellaris_fast \
+	"-DPART_LM4F120H5QR -DPDLIB_SPI -DNRF24L01_CONF_FAST_SPI -DPDLIB_SPI_CONF_SSI=3" \
+	"$SUITE $DRIVER $SIM $STELLARIS"
+
+# The wiring of pdlib_nrf24l01_wiring.h, the same as TestBoardInit
+build pdlib_nrf24l01_test_stellaris_static \
+	"-DPART_LM4F120H5QR -DPDLIB_SPI -DNRF24L01_CONF_STATIC_WIRING -DNRF24L01_CONF_INTERRUPT_PIN -DPDLIB_SPI_CONF_SSI=3" \
+	"$SUITE $DRIVER $SIM $STELLARIS"
+
+if [ $FAILED -ne 0 ]; then
+	echo "FAILED"
+	exit 1
+fi
+
+echo "PASSED"
@@ -0,0 +1,142 @@
+/*
+ * main.c
+ *
+ * Host test suite of the driver. Runs every test group built into this
+ * binary, or the groups named on the command line, and prints one PASS or
+ * FAIL line per group. The exit status is 0 only if every check passed.
+ *
+ * pdlib_nrf24l01_test [group ...]
+ *
+ * Which groups are built in depends on the NRF24L01_CONF_* flags of the
+ * build (see build.sh, which builds and runs every configuration).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+typedef struct
+{
+	const char *pcName;
+	void (*pfnRun)(void);
+}tTestGroup;
+
+static const tTestGroup g_sGroups[] =
+{
+#ifdef NRF24L01_CONF_HAL
+	{ "sim", TestSim },
+	{ "power", TestPower },
+	{ "fake", TestFake },
+#endif
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_TRANSACTION_STATS)
+	{ "status", TestStatus },
+	{ "config", TestConfig },
+#endif
+#if defined(NRF24L01_CONF_HAL) && (defined(NRF24L01_CONF_TX_QUEUE) || defined(NRF24L01_CONF_RX_QUEUE))
+	{ "queue", TestQueue },
+#endif
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_TX_STREAM)
+	{ "stream", TestStream },
+#endif
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_TRACE)
+	{ "trace", TestTrace },
+#endif
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_PROFILE)
+	{ "profile", TestProfile },
+#endif
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_ADDRESS_BOOK)
+	{ "address", TestAddress },
+#endif
+#if defined(NRF24L01_CONF_SPI_ENGINE) && (defined(NRF24L01_CONF_HAL) || defined(PART_LM4F120H5QR))
+	{ "engine", TestEngine },
+#endif
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL)
+	{ "spi", TestSPI },
+#endif
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL) && defined(PDLIB_SPI_CONF_UDMA)
+	{ "dma", TestDMA },
+#endif
+	{ NULL, NULL }
+};
+
+static unsigned long g_ulChecks;
+static unsigned long g_ulFailures;
+
+void
+TestCheck(int iPassed, const char *pcText, const char *pcFile, int iLine)
+{
+	g_ulChecks++;
+
+	if(!iPassed)
+	{
+		g_ulFailures++;
+		printf("  %s:%d: CHECK(%s) failed\n", pcFile, iLine, pcText);
+	}
+}
+
+void
+TestCheckEqual(long long llActual, long long llExpected, const char *pcText, const char *pcFile, int iLine)
+{
+	g_ulChecks++;
+
+	if(llActual != llExpected)
+	{
+		g_ulFailures++;
+		printf("  %s:%d: %s is %lld, expected %lld\n", pcFile, iLine, pcText, llActual, llExpected);
+	}
+}
+
+static int
+RunGroup(const tTestGroup *psGroup)
+{
+	unsigned long ulChecks = g_ulChecks;
+	unsigned long ulFailures = g_ulFailures;
+
+	psGroup->pfnRun();
+
+	ulChecks = g_ulChecks - ulChecks;
+	ulFailures = g_ulFailures - ulFailures;
+
+	printf("%s %s (%lu checks, %lu failed)\n", (ulFailures ? "FAIL" : "PASS"), psGroup->pcName, ulChecks, ulFailures);
+
+	return (ulFailures ? 1 : 0);
+}
+
+int main(int argc, char *argv[])
+{
+	const tTestGroup *psGroup;
+	int iFailed = 0;
+	int iArg;
+
+	if(argc < 2)
+	{
+		for(psGroup = g_sGroups; psGroup->pcName; psGroup++)
+		{
+			iFailed |= RunGroup(psGroup);
+		}
+
+		return iFailed;
+	}
+
+	for(iArg = 1; iArg < argc; iArg++)
+	{
+		for(psGroup = g_sGroups; psGroup->pcName; psGroup++)
+		{
+			if(0 == strcmp(argv[iArg], psGroup->pcName))
+			{
+				break;
+			}
+		}
+
+		if(NULL == psGroup->pcName)
+		{
+			printf("FAIL %s (no such group in this build)\n", argv[iArg]);
+			iFailed = 1;
+			continue;
+		}
+
+		iFailed |= RunGroup(psGroup);
+	}
+
+	return iFailed;
+}
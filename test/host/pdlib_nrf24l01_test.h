@@ -0,0 +1,78 @@
+#ifndef _PDLIB_NRF24L01_TEST
+#define _PDLIB_NRF24L01_TEST
+
+#include "pdlib_nrf24l01.h"
+
+/* PS: Host test suite (see main.c and build.sh). A failed check is printed and counted,
+ * the test goes on so one run shows every failure. */
+
+#define CHECK(bCondition)				TestCheck(((bCondition) ? 1 : 0), #bCondition, __FILE__, __LINE__)
+#define CHECK_EQUAL(llActual, llExpected)	TestCheckEqual((long long)(llActual), (long long)(llExpected), #llActual, __FILE__, __LINE__)
+
+void TestCheck(int iPassed, const char *pcText, const char *pcFile, int iLine);
+void TestCheckEqual(long long llActual, long long llExpected, const char *pcText, const char *pcFile, int iLine);
+
+/* PS: Address of the PRX on pipe 1, LSByte first */
+extern unsigned char g_ucTestAddress[5];
+
+#ifdef NRF24L01_CONF_HAL
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_air.h"
+
+/* PS: Radio 0 (PTX) and radio 1 (PRX) on one simulated air, see TestLinkInit */
+#define TEST_PTX	0
+#define TEST_PRX	1
+
+typedef struct
+{
+	tNRF24L01Air sAir;
+	tNRF24L01Sim sSim[2];
+	tNRF24L01 sRadio[2];
+}tTestLink;
+
+void TestLinkInit(tTestLink *psLink, unsigned long ulLossPPM);
+void TestLinkRun(tTestLink *psLink, unsigned long ulUs);
+unsigned long long TestLinkTimeUs(tTestLink *psLink);
+#endif
+
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL)
+#include "pdlib_nrf24l01_sim.h"
+#include "pdlib_nrf24l01_ssi_fake.h"
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "pdlib_spi.h"
+#include "stellaris_fake.h"
+
+/* PS: Wiring of the radio on the Stellaris fake, see TestBoardInit */
+#define TEST_SSI		3
+#define TEST_SSI_BASE	SSI3_BASE
+
+/* PS: One simulated chip behind the fake SSI module, driven by the built-in SSI code */
+typedef struct
+{
+	tNRF24L01Sim sSim;
+	tNRF24L01SSIFake sSSI;
+	tNRF24L01 sRadio;
+}tTestBoard;
+
+void TestBoardInit(tTestBoard *psBoard);
+#endif
+
+/* PS: Test groups, each in its own file */
+void TestSim(void);
+void TestSPI(void);
+void TestDMA(void);
+void TestStatus(void);
+void TestQueue(void);
+void TestPower(void);
+void TestFake(void);
+void TestConfig(void);
+void TestStream(void);
+void TestEngine(void);
+void TestTrace(void);
+void TestProfile(void);
+void TestAddress(void);
+
+#endif
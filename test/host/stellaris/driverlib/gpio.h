@@ -0,0 +1,42 @@
+#ifndef __GPIO_H__
+#define __GPIO_H__
+
+/* PS: Host stand-in of the StellarisWare header (LM4F120H5QR pin map) */
+
+#define GPIO_PIN_0			0x00000001
+#define GPIO_PIN_1			0x00000002
+#define GPIO_PIN_2			0x00000004
+#define GPIO_PIN_3			0x00000008
+#define GPIO_PIN_4			0x00000010
+#define GPIO_PIN_5			0x00000020
+#define GPIO_PIN_6			0x00000040
+#define GPIO_PIN_7			0x00000080
+
+#define GPIO_FALLING_EDGE	0x00000000
+#define GPIO_LOW_LEVEL		0x00000002
+
+#define GPIO_PA2_SSI0CLK	0x00000802
+#define GPIO_PA3_SSI0FSS	0x00000C02
+#define GPIO_PA4_SSI0RX		0x00001002
+#define GPIO_PA5_SSI0TX		0x00001402
+#define GPIO_PB4_SSI2CLK	0x00011002
+#define GPIO_PB5_SSI2FSS	0x00011402
+#define GPIO_PB6_SSI2RX		0x00011802
+#define GPIO_PB7_SSI2TX		0x00011C02
+#define GPIO_PD0_SSI3CLK	0x00030001
+#define GPIO_PD1_SSI3FSS	0x00030401
+#define GPIO_PD2_SSI3RX		0x00030801
+#define GPIO_PD3_SSI3TX		0x00030C01
+#define GPIO_PD0_SSI1CLK	0x00030002
+#define GPIO_PD1_SSI1FSS	0x00030402
+#define GPIO_PD2_SSI1RX		0x00030802
+#define GPIO_PD3_SSI1TX		0x00030C02
+#define GPIO_PF0_SSI1RX		0x00050002
+#define GPIO_PF1_SSI1TX		0x00050402
+#define GPIO_PF2_SSI1CLK	0x00050802
+#define GPIO_PF3_SSI1FSS	0x00050C02
+
+extern void GPIOPinConfigure(unsigned long ulPinConfig);
+extern long GPIOPinIntStatus(unsigned long ulPort, tBoolean bMasked);
+
+#endif
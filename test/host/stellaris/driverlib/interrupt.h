@@ -0,0 +1,11 @@
+#ifndef __INTERRUPT_H__
+#define __INTERRUPT_H__
+
+/* PS: Host stand-in of the StellarisWare header */
+
+extern tBoolean IntMasterEnable(void);
+extern tBoolean IntMasterDisable(void);
+extern void IntEnable(unsigned long ulInterrupt);
+extern void IntDisable(unsigned long ulInterrupt);
+
+#endif
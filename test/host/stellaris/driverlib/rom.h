@@ -0,0 +1,55 @@
+#ifndef __ROM_H__
+#define __ROM_H__
+
+/* PS: Host stand-in of the StellarisWare header. The ROM calls are functions of the fake
+ * (see stellaris_fake.c) instead of entries of the ROM API table. */
+
+#include "inc/hw_types.h"
+
+extern void ROM_SysCtlPeripheralEnable(unsigned long ulPeripheral);
+extern unsigned long ROM_SysCtlClockGet(void);
+extern void ROM_SysCtlDelay(unsigned long ulCount);
+
+extern void ROM_GPIOPinConfigure(unsigned long ulPinConfig);
+extern void ROM_GPIOPinTypeSSI(unsigned long ulPort, unsigned char ucPins);
+extern void ROM_GPIOPinTypeGPIOOutput(unsigned long ulPort, unsigned char ucPins);
+extern void ROM_GPIOPinTypeGPIOInput(unsigned long ulPort, unsigned char ucPins);
+extern void ROM_GPIOPinWrite(unsigned long ulPort, unsigned char ucPins, unsigned char ucVal);
+extern long ROM_GPIOPinRead(unsigned long ulPort, unsigned char ucPins);
+extern void ROM_GPIOIntTypeSet(unsigned long ulPort, unsigned char ucPins, unsigned long ulIntType);
+extern void ROM_GPIOPinIntEnable(unsigned long ulPort, unsigned char ucPins);
+extern void ROM_GPIOPinIntDisable(unsigned long ulPort, unsigned char ucPins);
+extern void ROM_GPIOPinIntClear(unsigned long ulPort, unsigned char ucPins);
+
+extern void ROM_SSIEnable(unsigned long ulBase);
+extern void ROM_SSIDisable(unsigned long ulBase);
+extern void ROM_SSIClockSourceSet(unsigned long ulBase, unsigned long ulSource);
+extern void ROM_SSIConfigSetExpClk(unsigned long ulBase, unsigned long ulSSIClk, unsigned long ulProtocol,
+								   unsigned long ulMode, unsigned long ulBitRate, unsigned long ulDataWidth);
+extern void ROM_SSIDataPut(unsigned long ulBase, unsigned long ulData);
+extern long ROM_SSIDataPutNonBlocking(unsigned long ulBase, unsigned long ulData);
+extern void ROM_SSIDataGet(unsigned long ulBase, unsigned long *pulData);
+extern long ROM_SSIDataGetNonBlocking(unsigned long ulBase, unsigned long *pulData);
+extern tBoolean ROM_SSIBusy(unsigned long ulBase);
+extern void ROM_SSIIntEnable(unsigned long ulBase, unsigned long ulIntFlags);
+extern void ROM_SSIIntDisable(unsigned long ulBase, unsigned long ulIntFlags);
+extern void ROM_SSIIntClear(unsigned long ulBase, unsigned long ulIntFlags);
+extern void ROM_SSIDMAEnable(unsigned long ulBase, unsigned long ulDMAFlags);
+extern void ROM_SSIDMADisable(unsigned long ulBase, unsigned long ulDMAFlags);
+
+extern tBoolean ROM_IntMasterEnable(void);
+extern tBoolean ROM_IntMasterDisable(void);
+extern void ROM_IntEnable(unsigned long ulInterrupt);
+extern void ROM_IntDisable(unsigned long ulInterrupt);
+
+extern void ROM_uDMAEnable(void);
+extern void ROM_uDMAControlBaseSet(void *pControlTable);
+extern void ROM_uDMAChannelAttributeDisable(unsigned long ulChannelNum, unsigned long ulAttr);
+extern void ROM_uDMAChannelControlSet(unsigned long ulChannelStructIndex, unsigned long ulControl);
+extern void ROM_uDMAChannelTransferSet(unsigned long ulChannelStructIndex, unsigned long ulMode,
+									   void *pvSrcAddr, void *pvDstAddr, unsigned long ulTransferSize);
+extern void ROM_uDMAChannelEnable(unsigned long ulChannelNum);
+extern void ROM_uDMAChannelDisable(unsigned long ulChannelNum);
+extern unsigned long ROM_uDMAChannelModeGet(unsigned long ulChannelStructIndex);
+
+#endif
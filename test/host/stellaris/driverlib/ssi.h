@@ -0,0 +1,19 @@
+#ifndef __SSI_H__
+#define __SSI_H__
+
+/* PS: Host stand-in of the StellarisWare header */
+
+#define SSI_TXFF			0x00000008
+#define SSI_RXFF			0x00000004
+#define SSI_RXTO			0x00000002
+#define SSI_RXOR			0x00000001
+
+#define SSI_FRF_MOTO_MODE_0	0x00000000
+#define SSI_MODE_MASTER		0x00000000
+
+#define SSI_DMA_TX			0x00000002
+#define SSI_DMA_RX			0x00000001
+
+#define SSI_CLOCK_SYSTEM	0x00000000
+
+#endif
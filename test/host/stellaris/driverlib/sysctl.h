@@ -0,0 +1,22 @@
+#ifndef __SYSCTL_H__
+#define __SYSCTL_H__
+
+/* PS: Host stand-in of the StellarisWare header */
+
+#define SYSCTL_PERIPH_UDMA	0x00002000
+#define SYSCTL_PERIPH_SSI0	0x10000010
+#define SYSCTL_PERIPH_SSI1	0x10000020
+#define SYSCTL_PERIPH_SSI2	0x10000040
+#define SYSCTL_PERIPH_SSI3	0x10000080
+#define SYSCTL_PERIPH_GPIOA	0x20000001
+#define SYSCTL_PERIPH_GPIOB	0x20000002
+#define SYSCTL_PERIPH_GPIOC	0x20000004
+#define SYSCTL_PERIPH_GPIOD	0x20000008
+#define SYSCTL_PERIPH_GPIOE	0x20000010
+#define SYSCTL_PERIPH_GPIOF	0x20000020
+
+extern unsigned long SysCtlClockGet(void);
+extern void SysCtlPeripheralEnable(unsigned long ulPeripheral);
+extern void SysCtlDelay(unsigned long ulCount);
+
+#endif
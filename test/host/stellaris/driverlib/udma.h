@@ -0,0 +1,55 @@
+#ifndef __UDMA_H__
+#define __UDMA_H__
+
+/* PS: Host stand-in of the StellarisWare header (LM4F120H5QR channel map) */
+
+typedef struct
+{
+	volatile void *pvSrcEndAddr;
+	volatile void *pvDstEndAddr;
+	volatile unsigned long ulControl;
+	volatile unsigned long ulSpare;
+}tDMAControlTable;
+
+#define UDMA_ATTR_USEBURST		0x00000001
+#define UDMA_ATTR_ALTSELECT		0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY	0x00000004
+#define UDMA_ATTR_REQMASK		0x00000008
+#define UDMA_ATTR_ALL			0x0000000F
+
+#define UDMA_MODE_STOP			0x00000000
+#define UDMA_MODE_BASIC			0x00000001
+#define UDMA_MODE_AUTO			0x00000002
+#define UDMA_MODE_PINGPONG		0x00000003
+
+#define UDMA_DST_INC_8			0x00000000
+#define UDMA_DST_INC_16			0x40000000
+#define UDMA_DST_INC_32			0x80000000
+#define UDMA_DST_INC_NONE		0xC0000000
+#define UDMA_SRC_INC_8			0x00000000
+#define UDMA_SRC_INC_16			0x04000000
+#define UDMA_SRC_INC_32			0x08000000
+#define UDMA_SRC_INC_NONE		0x0C000000
+#define UDMA_SIZE_8				0x00000000
+#define UDMA_SIZE_16			0x11000000
+#define UDMA_SIZE_32			0x22000000
+#define UDMA_ARB_1				0x00000000
+#define UDMA_ARB_4				0x00008000
+#define UDMA_ARB_8				0x0000C000
+
+#define UDMA_PRI_SELECT			0x00000000
+#define UDMA_ALT_SELECT			0x00000020
+
+/* PS: Channel number in bits 7:0, encoder of the channel mux in bits 23:16 */
+#define UDMA_CH10_SSI0RX		0x0000000A
+#define UDMA_CH11_SSI0TX		0x0000000B
+#define UDMA_CH12_SSI2RX		0x0002000C
+#define UDMA_CH13_SSI2TX		0x0002000D
+#define UDMA_CH14_SSI3RX		0x0002000E
+#define UDMA_CH15_SSI3TX		0x0002000F
+#define UDMA_CH24_SSI1RX		0x00000018
+#define UDMA_CH25_SSI1TX		0x00000019
+
+extern void uDMAChannelAssign(unsigned long ulMapping);
+
+#endif
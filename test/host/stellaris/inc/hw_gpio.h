@@ -0,0 +1,9 @@
+#ifndef __HW_GPIO_H__
+#define __HW_GPIO_H__
+
+/* PS: Host stand-in of the StellarisWare header */
+
+#define GPIO_O_DATA			0x00000000
+#define GPIO_O_DIR			0x00000400
+
+#endif
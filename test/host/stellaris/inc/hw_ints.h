@@ -0,0 +1,20 @@
+#ifndef __HW_INTS_H__
+#define __HW_INTS_H__
+
+/* PS: Host stand-in of the StellarisWare header (LM4F120H5QR) */
+
+#define INT_GPIOA			16
+#define INT_GPIOB			17
+#define INT_GPIOC			18
+#define INT_GPIOD			19
+#define INT_GPIOE			20
+#define INT_SSI0			23
+#define INT_GPIOF			46
+#define INT_SSI1			50
+#define INT_UDMAERR			63
+#define INT_SSI2			73
+#define INT_SSI3			74
+
+#define NUM_INTERRUPTS		155
+
+#endif
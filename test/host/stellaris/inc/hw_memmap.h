@@ -0,0 +1,18 @@
+#ifndef __HW_MEMMAP_H__
+#define __HW_MEMMAP_H__
+
+/* PS: Host stand-in of the StellarisWare header (LM4F120H5QR) */
+
+#define GPIO_PORTA_BASE		0x40004000
+#define GPIO_PORTB_BASE		0x40005000
+#define GPIO_PORTC_BASE		0x40006000
+#define GPIO_PORTD_BASE		0x40007000
+#define SSI0_BASE			0x40008000
+#define SSI1_BASE			0x40009000
+#define SSI2_BASE			0x4000A000
+#define SSI3_BASE			0x4000B000
+#define GPIO_PORTE_BASE		0x40024000
+#define GPIO_PORTF_BASE		0x40025000
+#define UDMA_BASE			0x400FF000
+
+#endif
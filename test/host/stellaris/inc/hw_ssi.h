@@ -0,0 +1,26 @@
+#ifndef __HW_SSI_H__
+#define __HW_SSI_H__
+
+/* PS: Host stand-in of the StellarisWare header */
+
+#define SSI_O_CR0			0x00000000
+#define SSI_O_CR1			0x00000004
+#define SSI_O_DR			0x00000008
+#define SSI_O_SR			0x0000000C
+#define SSI_O_CPSR			0x00000010
+#define SSI_O_IM			0x00000014
+#define SSI_O_DMACTL		0x00000024
+
+#define SSI_CR0_SCR_M		0x0000FF00
+#define SSI_CR0_SPH			0x00000080
+#define SSI_CR0_SPO			0x00000040
+#define SSI_CR0_SCR_S		8
+
+#define SSI_CR1_SSE			0x00000002
+
+#define SSI_SR_BSY			0x00000010
+#define SSI_SR_RNE			0x00000004
+#define SSI_SR_TNF			0x00000002
+#define SSI_SR_TFE			0x00000001
+
+#endif
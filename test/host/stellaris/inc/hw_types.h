@@ -0,0 +1,21 @@
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+/* PS: Host stand-in of the StellarisWare header, only what the driver and pdlib_spi.c use.
+ * Registers are cells of the fake (see stellaris_fake.c), not memory mapped. */
+
+typedef unsigned char tBoolean;
+
+#ifndef true
+#define true	1
+#endif
+
+#ifndef false
+#define false	0
+#endif
+
+volatile unsigned long *StellarisFakeRegister(unsigned long ulAddress);
+
+#define HWREG(x)	(*StellarisFakeRegister((unsigned long)(x)))
+
+#endif
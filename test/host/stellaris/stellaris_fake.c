@@ -0,0 +1,823 @@
+/*
+ * stellaris_fake.c
+ *
+ * Host fake of the LM4F120H5QR peripherals behind the built-in SSI code of
+ * the driver and pdlib_spi.c, so that code runs against the simulated chip:
+ *
+ * 	- One SSI module (ulSSIBase of StellarisFakeInit) is a tNRF24L01SSIFake.
+ * 	  Every ROM SSI call is one tick and a byte is clocked from its TX FIFO
+ * 	  every STELLARIS_FAKE_TICKS_PER_BYTE ticks, so the bus idles when the
+ * 	  code does not keep the FIFO fed (counted in ulGaps of the SSI fake).
+ * 	- The CE and CSN pins drive the SSI fake, the other pins do nothing.
+ * 	- SysCtlDelay moves the time of the simulated chip.
+ * 	- The uDMA channels of the SSI module move bytes between memory and the
+ * 	  FIFOs on the ticks, and raise the SSI interrupt when they are done.
+ * 	- HWREG reads and writes cells of a small register file, which the SSI
+ * 	  calls use for DMACTL and IM. For NRF24L01_CONF_FAST_SPI the data and
+ * 	  status registers of the SSI module and the DATA registers of the CE/CSN
+ * 	  port are modelled: STELLARIS_FAKE_ACCESSES_PER_TICK accesses of DR and
+ * 	  SR are one tick, SR is computed from the FIFOs and a DR read sees the
+ * 	  head of the RX FIFO. HWREG only hands out the cell, so whether DR or
+ * 	  DATA was read or stored is known at the next call into the fake, where
+ * 	  a store (a value without STELLARIS_FAKE_UNTOUCHED) goes to the TX FIFO
+ * 	  or the pins.
+ * 	- Above the bit rate set by StellarisFakeSetMaxBitRate (from CPSR and
+ * 	  the SCR of CR0) MISO does not settle: bits 7 and 0 of every byte
+ * 	  received are flipped.
+ *
+ * Nothing runs on its own: the ticks come from the ROM SSI calls, the DR
+ * and SR accesses and StellarisFakeRun. A blocking read which can never complete aborts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_ssi.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_ints.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "driverlib/ssi.h"
+#include "driverlib/udma.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "stellaris_fake.h"
+
+#define STELLARIS_FAKE_REGISTERS		64
+
+/* PS: Set in a DR or DATA cell when it is handed out, bytes stored by the code never have it */
+#define STELLARIS_FAKE_UNTOUCHED		0x80000000UL
+
+/* PS: DR and SR accesses per tick, a store or load against a ROM call */
+#define STELLARIS_FAKE_ACCESSES_PER_TICK	4
+
+/* PS: Offsets of the GPIO DATA register, address bits 9:2 mask the pins */
+#define STELLARIS_FAKE_GPIO_DATA_M		0x000003FC
+
+/* PS: uDMA channels and interrupt of every SSI module */
+static const unsigned long g_ulSSIMap[4][4] =
+{
+	{ SSI0_BASE, 10, 11, INT_SSI0 },
+	{ SSI1_BASE, 24, 25, INT_SSI1 },
+	{ SSI2_BASE, 12, 13, INT_SSI2 },
+	{ SSI3_BASE, 14, 15, INT_SSI3 }
+};
+
+typedef struct
+{
+	tNRF24L01SSIFake *psSSI;
+	tNRF24L01Sim *psSim;
+	unsigned long ulSSIBase;
+	unsigned long ulRxChannel;
+	unsigned long ulTxChannel;
+	unsigned long ulSSIInt;
+
+	unsigned long ulCEBase;
+	unsigned long ulCEPin;
+	unsigned long ulCSNBase;
+	unsigned long ulCSNPin;
+
+	unsigned long ulTicks;
+	unsigned long ulMaxBitRate;
+
+	unsigned long ulRegAddress[STELLARIS_FAKE_REGISTERS];
+	unsigned long ulRegValue[STELLARIS_FAKE_REGISTERS];
+	unsigned int uiRegCount;
+	volatile unsigned long *pulAccess;	// DR or DATA cell handed out last, NULL once settled
+	unsigned long ulAccessAddress;
+	unsigned long ulAccesses;			// DR and SR accesses
+
+	tStellarisFakeDMAChannel sDMA[STELLARIS_FAKE_DMA_CHANNELS];
+
+	unsigned char ucIntEnabled[NUM_INTERRUPTS];
+	unsigned char ucMasterDisabled;
+	unsigned char ucSSIPending;			// uDMA done, waits for the interrupt to be taken
+	unsigned char ucInISR;
+	unsigned long ulISRInt;
+	void (*pfnISR)(void);
+}tStellarisFake;
+
+static tStellarisFake g_sFake;
+
+static void _StellarisFakeTick(void);
+static void _StellarisFakeSettle(void);
+static unsigned long _StellarisFakeBitRate(void);
+
+
+/* PS: The SSI module wired to the chip, CE and CSN pins. psSim may be NULL, SysCtlDelay then
+ * does not move any time. Registers, uDMA and interrupts are reset. */
+void
+StellarisFakeInit(tNRF24L01SSIFake *psSSI, tNRF24L01Sim *psSim, unsigned long ulSSIBase,
+				  unsigned long ulCEBase, unsigned long ulCEPin,
+				  unsigned long ulCSNBase, unsigned long ulCSNPin)
+{
+	unsigned int uiIndex;
+
+	memset(&g_sFake, 0, sizeof(g_sFake));
+
+	g_sFake.psSSI = psSSI;
+	g_sFake.psSim = psSim;
+	g_sFake.ulSSIBase = ulSSIBase;
+	g_sFake.ulCEBase = ulCEBase;
+	g_sFake.ulCEPin = ulCEPin;
+	g_sFake.ulCSNBase = ulCSNBase;
+	g_sFake.ulCSNPin = ulCSNPin;
+
+	for(uiIndex = 0; uiIndex < 4; uiIndex++)
+	{
+		if(g_ulSSIMap[uiIndex][0] == ulSSIBase)
+		{
+			g_sFake.ulRxChannel = g_ulSSIMap[uiIndex][1];
+			g_sFake.ulTxChannel = g_ulSSIMap[uiIndex][2];
+			g_sFake.ulSSIInt = g_ulSSIMap[uiIndex][3];
+		}
+	}
+}
+
+/* PS: Handler of one interrupt (the vector table entry) */
+void
+StellarisFakeSetISR(unsigned long ulInterrupt, void (*pfnISR)(void))
+{
+	g_sFake.ulISRInt = ulInterrupt;
+	g_sFake.pfnISR = pfnISR;
+}
+
+/* PS: Highest bit rate the wiring carries, 0 for no limit */
+void
+StellarisFakeSetMaxBitRate(unsigned long ulBitRate)
+{
+	g_sFake.ulMaxBitRate = ulBitRate;
+}
+
+/* PS: Time passing outside the ROM calls, eg. while a uDMA transfer runs */
+void
+StellarisFakeRun(unsigned long ulTicks)
+{
+	_StellarisFakeSettle();
+
+	while(ulTicks--)
+	{
+		_StellarisFakeTick();
+	}
+}
+
+const tStellarisFakeDMAChannel *
+StellarisFakeDMAChannel(unsigned long ulChannel)
+{
+	return &g_sFake.sDMA[ulChannel % STELLARIS_FAKE_DMA_CHANNELS];
+}
+
+/* PS: Cell of a register, added on its first access */
+static volatile unsigned long *
+_StellarisFakeCell(unsigned long ulAddress)
+{
+	unsigned int uiIndex;
+
+	for(uiIndex = 0; uiIndex < g_sFake.uiRegCount; uiIndex++)
+	{
+		if(g_sFake.ulRegAddress[uiIndex] == ulAddress)
+		{
+			return &g_sFake.ulRegValue[uiIndex];
+		}
+	}
+
+	if(g_sFake.uiRegCount >= STELLARIS_FAKE_REGISTERS)
+	{
+		fprintf(stderr, "stellaris_fake: register file full at 0x%08lX\n", ulAddress);
+		abort();
+	}
+
+	g_sFake.ulRegAddress[g_sFake.uiRegCount] = ulAddress;
+	g_sFake.ulRegValue[g_sFake.uiRegCount] = 0;
+
+	return &g_sFake.ulRegValue[g_sFake.uiRegCount++];
+}
+
+/* PS: A DATA register of the CE or CSN port */
+static int
+_StellarisFakeIsPinData(unsigned long ulAddress)
+{
+	unsigned long ulPort = ((ulAddress - GPIO_O_DATA) & ~STELLARIS_FAKE_GPIO_DATA_M);
+
+	return ((ulPort == g_sFake.ulCEBase) || (ulPort == g_sFake.ulCSNBase));
+}
+
+/* PS: Applies the access to the DR or DATA cell handed out last: a DR read takes the head of
+ * the RX FIFO, a DR store goes to the TX FIFO and a DATA store writes the masked pins */
+static void
+_StellarisFakeSettle(void)
+{
+	volatile unsigned long *pulCell = g_sFake.pulAccess;
+	unsigned long ulAddress = g_sFake.ulAccessAddress;
+	unsigned long ulPort;
+	unsigned char ucData;
+
+	if(NULL == pulCell)
+	{
+		return;
+	}
+
+	g_sFake.pulAccess = NULL;
+
+	if(ulAddress == (g_sFake.ulSSIBase + SSI_O_DR))
+	{
+		if(*pulCell & STELLARIS_FAKE_UNTOUCHED)
+		{
+			g_sNRF24L01SSIFakeHAL.pfnFifoGet(g_sFake.psSSI, &ucData);
+		}else
+		{
+			/* PS: A store to a full TX FIFO is lost, as on the part */
+			g_sNRF24L01SSIFakeHAL.pfnFifoPut(g_sFake.psSSI, (unsigned char)(*pulCell & 0xFF));
+		}
+	}else if(!(*pulCell & STELLARIS_FAKE_UNTOUCHED))
+	{
+		ulPort = ((ulAddress - GPIO_O_DATA) & ~STELLARIS_FAKE_GPIO_DATA_M);
+
+		ROM_GPIOPinWrite(ulPort, (unsigned char)(((ulAddress - GPIO_O_DATA) & STELLARIS_FAKE_GPIO_DATA_M) >> 2),
+						 (unsigned char)(*pulCell & 0xFF));
+	}
+}
+
+/* PS: SR of the SSI module from the FIFOs of the SSI fake */
+static unsigned long
+_StellarisFakeSSIStatus(void)
+{
+	unsigned long ulStatus = 0;
+
+	if(g_sFake.psSSI->ucTxCount < PDLIB_NRF24_SSI_FAKE_FIFO_DEPTH)
+	{
+		ulStatus |= SSI_SR_TNF;
+	}
+
+	if(0 == g_sFake.psSSI->ucTxCount)
+	{
+		ulStatus |= SSI_SR_TFE;
+	}else
+	{
+		ulStatus |= SSI_SR_BSY;
+	}
+
+	if(g_sFake.psSSI->ucRxCount)
+	{
+		ulStatus |= SSI_SR_RNE;
+	}
+
+	return ulStatus;
+}
+
+volatile unsigned long *
+StellarisFakeRegister(unsigned long ulAddress)
+{
+	volatile unsigned long *pulCell;
+	unsigned char ucData;
+
+	_StellarisFakeSettle();
+
+	pulCell = _StellarisFakeCell(ulAddress);
+
+	if(g_sFake.psSSI && ((ulAddress == (g_sFake.ulSSIBase + SSI_O_SR)) || (ulAddress == (g_sFake.ulSSIBase + SSI_O_DR))) &&
+	   (0 == (++g_sFake.ulAccesses % STELLARIS_FAKE_ACCESSES_PER_TICK)))
+	{
+		_StellarisFakeTick();
+	}
+
+	if(g_sFake.psSSI && (ulAddress == (g_sFake.ulSSIBase + SSI_O_SR)))
+	{
+		*pulCell = _StellarisFakeSSIStatus();
+	}else if(g_sFake.psSSI && (ulAddress == (g_sFake.ulSSIBase + SSI_O_DR)))
+	{
+		/* PS: What a read returns, the RX FIFO moves only if it was one */
+		ucData = 0;
+
+		if(g_sFake.psSSI->ucRxCount)
+		{
+			ucData = g_sFake.psSSI->ucRxFifo[g_sFake.psSSI->ucRxHead];
+
+			if(g_sFake.ulMaxBitRate && (_StellarisFakeBitRate() > g_sFake.ulMaxBitRate))
+			{
+				ucData ^= 0x81;
+			}
+		}
+
+		*pulCell = (STELLARIS_FAKE_UNTOUCHED | ucData);
+		g_sFake.pulAccess = pulCell;
+		g_sFake.ulAccessAddress = ulAddress;
+	}else if(g_sFake.psSSI && _StellarisFakeIsPinData(ulAddress))
+	{
+		*pulCell = STELLARIS_FAKE_UNTOUCHED;
+		g_sFake.pulAccess = pulCell;
+		g_sFake.ulAccessAddress = ulAddress;
+	}
+
+	return pulCell;
+}
+
+
+/* PS: Takes the SSI interrupt if it is pending, enabled and not masked */
+static void
+_StellarisFakeInterrupt(void)
+{
+	unsigned long ulMask;
+
+	ulMask = HWREG(g_sFake.ulSSIBase + SSI_O_IM);
+
+	if((ulMask & (SSI_RXFF | SSI_RXTO)) && g_sFake.psSSI->ucRxCount)
+	{
+		g_sFake.ucSSIPending = 1;
+	}
+
+	if(!g_sFake.ucSSIPending || g_sFake.ucInISR || g_sFake.ucMasterDisabled ||
+	   !g_sFake.ucIntEnabled[g_sFake.ulSSIInt] || (g_sFake.ulISRInt != g_sFake.ulSSIInt) || !g_sFake.pfnISR)
+	{
+		return;
+	}
+
+	g_sFake.ucSSIPending = 0;
+	g_sFake.ucInISR = 1;
+	g_sFake.pfnISR();
+	g_sFake.ucInISR = 0;
+}
+
+/* PS: The uDMA channels of the SSI module serve the FIFOs */
+static void
+_StellarisFakeDMA(void)
+{
+	tStellarisFakeDMAChannel *psTx = &g_sFake.sDMA[g_sFake.ulTxChannel];
+	tStellarisFakeDMAChannel *psRx = &g_sFake.sDMA[g_sFake.ulRxChannel];
+	unsigned long ulEnabled = HWREG(g_sFake.ulSSIBase + SSI_O_DMACTL);
+	unsigned char *pucData;
+	unsigned char ucData;
+
+	if((ulEnabled & SSI_DMA_TX) && psTx->ucEnabled)
+	{
+		while(psTx->ulDone < psTx->ulSize)
+		{
+			pucData = (unsigned char *)psTx->pvSrc;
+
+			if(UDMA_SRC_INC_NONE != (psTx->ulControl & UDMA_SRC_INC_NONE))
+			{
+				pucData += psTx->ulDone;
+			}
+
+			if(!g_sNRF24L01SSIFakeHAL.pfnFifoPut(g_sFake.psSSI, *pucData))
+			{
+				break;
+			}
+
+			psTx->ulDone++;
+		}
+
+		if(psTx->ulDone >= psTx->ulSize)
+		{
+			psTx->ucEnabled = 0;
+			psTx->ulMode = UDMA_MODE_STOP;
+			g_sFake.ucSSIPending = 1;
+		}
+	}
+
+	if((ulEnabled & SSI_DMA_RX) && psRx->ucEnabled)
+	{
+		while((psRx->ulDone < psRx->ulSize) && g_sNRF24L01SSIFakeHAL.pfnFifoGet(g_sFake.psSSI, &ucData))
+		{
+			pucData = (unsigned char *)psRx->pvDst;
+
+			if(UDMA_DST_INC_NONE != (psRx->ulControl & UDMA_DST_INC_NONE))
+			{
+				pucData += psRx->ulDone;
+			}
+
+			*pucData = ucData;
+			psRx->ulDone++;
+		}
+
+		if(psRx->ulDone >= psRx->ulSize)
+		{
+			psRx->ucEnabled = 0;
+			psRx->ulMode = UDMA_MODE_STOP;
+			g_sFake.ucSSIPending = 1;
+		}
+	}
+}
+
+/* PS: SysClk / (CPSDVSR * (1 + SCR)) */
+static unsigned long
+_StellarisFakeBitRate(void)
+{
+	unsigned long ulPreDiv = HWREG(g_sFake.ulSSIBase + SSI_O_CPSR);
+	unsigned long ulSCR = ((HWREG(g_sFake.ulSSIBase + SSI_O_CR0) & SSI_CR0_SCR_M) >> SSI_CR0_SCR_S);
+
+	if(0 == ulPreDiv)
+	{
+		return 0;
+	}
+
+	return (STELLARIS_FAKE_SYSCLK / (ulPreDiv * (1 + ulSCR)));
+}
+
+static void
+_StellarisFakeTick(void)
+{
+	_StellarisFakeSettle();
+
+	g_sFake.ulTicks++;
+
+	if(0 == (g_sFake.ulTicks % STELLARIS_FAKE_TICKS_PER_BYTE))
+	{
+		NRF24L01_SSIFakeRun(g_sFake.psSSI, 1);
+	}
+
+	_StellarisFakeDMA();
+	_StellarisFakeInterrupt();
+}
+
+
+/* PS: System control */
+
+unsigned long
+SysCtlClockGet(void)
+{
+	return STELLARIS_FAKE_SYSCLK;
+}
+
+void
+SysCtlPeripheralEnable(unsigned long ulPeripheral)
+{
+	(void)ulPeripheral;
+}
+
+/* PS: Three cycles per count */
+void
+SysCtlDelay(unsigned long ulCount)
+{
+	_StellarisFakeSettle();
+
+	if(g_sFake.psSim)
+	{
+		NRF24L01_SimRun(g_sFake.psSim, g_sFake.psSim->ullTimeUs + ((ulCount * 3) / (STELLARIS_FAKE_SYSCLK / 1000000)));
+	}
+}
+
+unsigned long
+ROM_SysCtlClockGet(void)
+{
+	return SysCtlClockGet();
+}
+
+void
+ROM_SysCtlPeripheralEnable(unsigned long ulPeripheral)
+{
+	SysCtlPeripheralEnable(ulPeripheral);
+}
+
+void
+ROM_SysCtlDelay(unsigned long ulCount)
+{
+	_StellarisFakeSettle();
+
+	SysCtlDelay(ulCount);
+}
+
+
+/* PS: GPIO */
+
+void
+GPIOPinConfigure(unsigned long ulPinConfig)
+{
+	(void)ulPinConfig;
+}
+
+void
+ROM_GPIOPinConfigure(unsigned long ulPinConfig)
+{
+	(void)ulPinConfig;
+}
+
+void
+ROM_GPIOPinTypeSSI(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	(void)ucPins;
+}
+
+void
+ROM_GPIOPinTypeGPIOOutput(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	(void)ucPins;
+}
+
+void
+ROM_GPIOPinTypeGPIOInput(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	(void)ucPins;
+}
+
+void
+ROM_GPIOIntTypeSet(unsigned long ulPort, unsigned char ucPins, unsigned long ulIntType)
+{
+	(void)ulPort;
+	(void)ucPins;
+	(void)ulIntType;
+}
+
+void
+ROM_GPIOPinIntEnable(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	(void)ucPins;
+}
+
+void
+ROM_GPIOPinIntClear(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	(void)ucPins;
+}
+
+void
+ROM_GPIOPinWrite(unsigned long ulPort, unsigned char ucPins, unsigned char ucVal)
+{
+	_StellarisFakeSettle();
+
+	if((ulPort == g_sFake.ulCSNBase) && (ucPins & g_sFake.ulCSNPin))
+	{
+		g_sNRF24L01SSIFakeHAL.pfnSetCSN(g_sFake.psSSI, ((ucVal & g_sFake.ulCSNPin) ? 1 : 0));
+	}
+
+	if((ulPort == g_sFake.ulCEBase) && (ucPins & g_sFake.ulCEPin))
+	{
+		g_sNRF24L01SSIFakeHAL.pfnSetCE(g_sFake.psSSI, ((ucVal & g_sFake.ulCEPin) ? 1 : 0));
+	}
+}
+
+
+/* PS: SSI, only ulSSIBase is wired */
+
+void
+ROM_SSIEnable(unsigned long ulBase)
+{
+	HWREG(ulBase + SSI_O_CR1) |= SSI_CR1_SSE;
+}
+
+void
+ROM_SSIDisable(unsigned long ulBase)
+{
+	HWREG(ulBase + SSI_O_CR1) &= ~SSI_CR1_SSE;
+}
+
+void
+ROM_SSIClockSourceSet(unsigned long ulBase, unsigned long ulSource)
+{
+	(void)ulBase;
+	(void)ulSource;
+}
+
+void
+ROM_SSIConfigSetExpClk(unsigned long ulBase, unsigned long ulSSIClk, unsigned long ulProtocol,
+					   unsigned long ulMode, unsigned long ulBitRate, unsigned long ulDataWidth)
+{
+	(void)ulBase;
+	(void)ulSSIClk;
+	(void)ulProtocol;
+	(void)ulMode;
+	(void)ulBitRate;
+	(void)ulDataWidth;
+}
+
+long
+ROM_SSIDataPutNonBlocking(unsigned long ulBase, unsigned long ulData)
+{
+	if(ulBase != g_sFake.ulSSIBase)
+	{
+		return 0;
+	}
+
+	_StellarisFakeTick();
+
+	return g_sNRF24L01SSIFakeHAL.pfnFifoPut(g_sFake.psSSI, (unsigned char)(ulData & 0xFF));
+}
+
+void
+ROM_SSIDataPut(unsigned long ulBase, unsigned long ulData)
+{
+	while((ulBase == g_sFake.ulSSIBase) && !ROM_SSIDataPutNonBlocking(ulBase, ulData));
+}
+
+long
+ROM_SSIDataGetNonBlocking(unsigned long ulBase, unsigned long *pulData)
+{
+	unsigned char ucData;
+
+	if(ulBase != g_sFake.ulSSIBase)
+	{
+		return 0;
+	}
+
+	_StellarisFakeTick();
+
+	if(!g_sNRF24L01SSIFakeHAL.pfnFifoGet(g_sFake.psSSI, &ucData))
+	{
+		return 0;
+	}
+
+	if(g_sFake.ulMaxBitRate && (_StellarisFakeBitRate() > g_sFake.ulMaxBitRate))
+	{
+		ucData ^= 0x81;
+	}
+
+	*pulData = ucData;
+
+	return 1;
+}
+
+void
+ROM_SSIDataGet(unsigned long ulBase, unsigned long *pulData)
+{
+	while(!ROM_SSIDataGetNonBlocking(ulBase, pulData))
+	{
+		if((ulBase != g_sFake.ulSSIBase) || (0 == g_sFake.psSSI->ucTxCount))
+		{
+			fprintf(stderr, "stellaris_fake: ROM_SSIDataGet would block forever\n");
+			abort();
+		}
+	}
+}
+
+tBoolean
+ROM_SSIBusy(unsigned long ulBase)
+{
+	if(ulBase != g_sFake.ulSSIBase)
+	{
+		return false;
+	}
+
+	_StellarisFakeTick();
+
+	return (g_sFake.psSSI->ucTxCount ? true : false);
+}
+
+void
+ROM_SSIIntEnable(unsigned long ulBase, unsigned long ulIntFlags)
+{
+	HWREG(ulBase + SSI_O_IM) |= ulIntFlags;
+}
+
+void
+ROM_SSIIntDisable(unsigned long ulBase, unsigned long ulIntFlags)
+{
+	HWREG(ulBase + SSI_O_IM) &= ~ulIntFlags;
+}
+
+void
+ROM_SSIIntClear(unsigned long ulBase, unsigned long ulIntFlags)
+{
+	(void)ulBase;
+	(void)ulIntFlags;
+}
+
+void
+ROM_SSIDMAEnable(unsigned long ulBase, unsigned long ulDMAFlags)
+{
+	HWREG(ulBase + SSI_O_DMACTL) |= ulDMAFlags;
+}
+
+void
+ROM_SSIDMADisable(unsigned long ulBase, unsigned long ulDMAFlags)
+{
+	HWREG(ulBase + SSI_O_DMACTL) &= ~ulDMAFlags;
+}
+
+
+/* PS: NVIC. IntMasterDisable and IntMasterEnable return whether interrupts were disabled. */
+
+tBoolean
+ROM_IntMasterDisable(void)
+{
+	tBoolean bWasDisabled = (g_sFake.ucMasterDisabled ? true : false);
+
+	g_sFake.ucMasterDisabled = 1;
+
+	return bWasDisabled;
+}
+
+tBoolean
+ROM_IntMasterEnable(void)
+{
+	tBoolean bWasDisabled = (g_sFake.ucMasterDisabled ? true : false);
+
+	g_sFake.ucMasterDisabled = 0;
+	_StellarisFakeInterrupt();
+
+	return bWasDisabled;
+}
+
+void
+ROM_IntEnable(unsigned long ulInterrupt)
+{
+	if(ulInterrupt < NUM_INTERRUPTS)
+	{
+		g_sFake.ucIntEnabled[ulInterrupt] = 1;
+		_StellarisFakeInterrupt();
+	}
+}
+
+void
+ROM_IntDisable(unsigned long ulInterrupt)
+{
+	if(ulInterrupt < NUM_INTERRUPTS)
+	{
+		g_sFake.ucIntEnabled[ulInterrupt] = 0;
+	}
+}
+
+tBoolean
+IntMasterDisable(void)
+{
+	return ROM_IntMasterDisable();
+}
+
+tBoolean
+IntMasterEnable(void)
+{
+	return ROM_IntMasterEnable();
+}
+
+void
+IntEnable(unsigned long ulInterrupt)
+{
+	ROM_IntEnable(ulInterrupt);
+}
+
+void
+IntDisable(unsigned long ulInterrupt)
+{
+	ROM_IntDisable(ulInterrupt);
+}
+
+
+/* PS: uDMA, primary control structures only */
+
+void
+uDMAChannelAssign(unsigned long ulMapping)
+{
+	(void)ulMapping;
+}
+
+void
+ROM_uDMAEnable(void)
+{
+}
+
+void
+ROM_uDMAControlBaseSet(void *pControlTable)
+{
+	(void)pControlTable;
+}
+
+void
+ROM_uDMAChannelAttributeDisable(unsigned long ulChannelNum, unsigned long ulAttr)
+{
+	(void)ulChannelNum;
+	(void)ulAttr;
+}
+
+void
+ROM_uDMAChannelControlSet(unsigned long ulChannelStructIndex, unsigned long ulControl)
+{
+	g_sFake.sDMA[ulChannelStructIndex % STELLARIS_FAKE_DMA_CHANNELS].ulControl = ulControl;
+}
+
+void
+ROM_uDMAChannelTransferSet(unsigned long ulChannelStructIndex, unsigned long ulMode,
+						   void *pvSrcAddr, void *pvDstAddr, unsigned long ulTransferSize)
+{
+	tStellarisFakeDMAChannel *psChannel = &g_sFake.sDMA[ulChannelStructIndex % STELLARIS_FAKE_DMA_CHANNELS];
+
+	psChannel->ulMode = ulMode;
+	psChannel->pvSrc = pvSrcAddr;
+	psChannel->pvDst = pvDstAddr;
+	psChannel->ulSize = ulTransferSize;
+	psChannel->ulDone = 0;
+	psChannel->ulTransfers++;
+}
+
+void
+ROM_uDMAChannelEnable(unsigned long ulChannelNum)
+{
+	g_sFake.sDMA[ulChannelNum % STELLARIS_FAKE_DMA_CHANNELS].ucEnabled = 1;
+}
+
+void
+ROM_uDMAChannelDisable(unsigned long ulChannelNum)
+{
+	g_sFake.sDMA[ulChannelNum % STELLARIS_FAKE_DMA_CHANNELS].ucEnabled = 0;
+}
+
+unsigned long
+ROM_uDMAChannelModeGet(unsigned long ulChannelStructIndex)
+{
+	return g_sFake.sDMA[ulChannelStructIndex % STELLARIS_FAKE_DMA_CHANNELS].ulMode;
+}
@@ -0,0 +1,38 @@
+#ifndef _STELLARIS_FAKE
+#define _STELLARIS_FAKE
+
+#include "pdlib_nrf24l01_ssi_fake.h"
+#include "pdlib_nrf24l01_sim.h"
+
+/* PS: Host fake of the LM4F120H5QR peripherals used by the built-in SSI code of the driver
+ * (PART_LM4F120H5QR without NRF24L01_CONF_HAL) and by pdlib_spi.c. See stellaris_fake.c. */
+
+#define STELLARIS_FAKE_SYSCLK			80000000
+
+/* PS: Calls into the SSI module per byte on the bus, ie. the SPI clock against the CPU */
+#define STELLARIS_FAKE_TICKS_PER_BYTE	4
+
+#define STELLARIS_FAKE_DMA_CHANNELS		32
+
+/* PS: A uDMA channel (primary control structure only) */
+typedef struct
+{
+	unsigned long ulControl;			// ROM_uDMAChannelControlSet
+	unsigned long ulMode;				// UDMA_MODE_STOP once the transfer is done
+	void *pvSrc;
+	void *pvDst;
+	unsigned long ulSize;				// Items of the transfer
+	unsigned long ulDone;				// Items moved
+	unsigned char ucEnabled;
+	unsigned long ulTransfers;			// ROM_uDMAChannelTransferSet calls
+}tStellarisFakeDMAChannel;
+
+void StellarisFakeInit(tNRF24L01SSIFake *psSSI, tNRF24L01Sim *psSim, unsigned long ulSSIBase,
+					   unsigned long ulCEBase, unsigned long ulCEPin,
+					   unsigned long ulCSNBase, unsigned long ulCSNPin);
+void StellarisFakeSetMaxBitRate(unsigned long ulBitRate);
+void StellarisFakeSetISR(unsigned long ulInterrupt, void (*pfnISR)(void));
+void StellarisFakeRun(unsigned long ulTicks);
+const tStellarisFakeDMAChannel *StellarisFakeDMAChannel(unsigned long ulChannel);
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * test_address.c
+ *
+ * The address book (NRF24L01_CONF_ADDRESS_BOOK): NRF24L01_SelectNode leaves
+ * TX_ADDR and RX_ADDR_P0 of the simulated module at the address of the node,
+ * writing only the bytes up to the last one which differs, and only the bytes
+ * of the address width after a SETUP_AW change.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_ADDRESS_BOOK)
+
+/* PS: TX_ADDR and RX_ADDR_P0 of the simulated module both hold the first uiWidth bytes of pucAddress */
+static int
+TestAddressIsTarget(tNRF24L01Sim *psSim, const unsigned char *pucAddress, unsigned int uiWidth)
+{
+	return ((0 == memcmp(psSim->ucAddress[RF24_TX_ADDR - RF24_RX_ADDR_P0], pucAddress, uiWidth)) &&
+			(0 == memcmp(psSim->ucAddress[0], pucAddress, uiWidth)));
+}
+
+/* PS: One 32 byte payload from the PTX, which must arrive at the PRX */
+static void
+TestAddressExchange(tTestLink *psLink)
+{
+	tNRF24L01 *psPRX = &psLink->sRadio[TEST_PRX];
+	char cData[32];
+	char cLength = sizeof(cData);
+	char cPipe;
+
+	memset(cData, 0x3C, sizeof(cData));
+
+	CHECK_EQUAL(NRF24L01_SendData(&psLink->sRadio[TEST_PTX], cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_IsDataReadyRx(psPRX, &cPipe), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_GetData(psPRX, cPipe, cData, &cLength), sizeof(cData));
+}
+
+static void
+TestAddressSelect(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX = &sLink.sRadio[TEST_PTX];
+	tNRF24L01Sim *psSim = &sLink.sSim[TEST_PTX];
+	unsigned char ucPrefix[5];
+	unsigned char ucOther[5] = { 0xA1, 0xB2, 0xC3, 0xD4, 0xE5 };
+	int iPRX;
+	int iPrefix;
+	int iOther;
+
+	TestLinkInit(&sLink, 0);
+
+	/* PS: Same upper four bytes as the PRX, and none in common with it */
+	memcpy(ucPrefix, g_ucTestAddress, sizeof(ucPrefix));
+	ucPrefix[0] ^= 0xFF;
+
+	iPRX = NRF24L01_AddressBookAdd(psPTX, g_ucTestAddress);
+	iPrefix = NRF24L01_AddressBookAdd(psPTX, ucPrefix);
+	iOther = NRF24L01_AddressBookAdd(psPTX, ucOther);
+
+	CHECK_EQUAL(iPRX, 0);
+	CHECK_EQUAL(iPrefix, 1);
+	CHECK_EQUAL(iOther, 2);
+	CHECK_EQUAL(NRF24L01_AddressBookAdd(psPTX, NULL), PDLIB_NRF24_INVALID_ARGUMENT);
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, 3), PDLIB_NRF24_INVALID_ARGUMENT);
+
+	/* PS: The first send set RX_ADDR_P0 for the ACK */
+	TestAddressExchange(&sLink);
+	NRF24L01_SimResetStats(psSim);
+
+	/* PS: The current target, nothing to write */
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iPRX), 0);
+	CHECK_EQUAL(psSim->sStats.ulTransfers, 0);
+	CHECK(TestAddressIsTarget(psSim, g_ucTestAddress, 5));
+
+	/* PS: The LSByte differs, one data byte for each register */
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iPrefix), 2);
+	CHECK_EQUAL(psSim->sStats.ulTransfers, 2);
+	CHECK_EQUAL(psSim->sStats.ulSPIBytes, 2 * 2);
+	CHECK(TestAddressIsTarget(psSim, ucPrefix, 5));
+
+	/* PS: Nothing in common, all five bytes */
+	NRF24L01_SimResetStats(psSim);
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iOther), 2);
+	CHECK_EQUAL(psSim->sStats.ulSPIBytes, 2 * 6);
+	CHECK(TestAddressIsTarget(psSim, ucOther, 5));
+
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iPRX), 2);
+	CHECK(TestAddressIsTarget(psSim, g_ucTestAddress, 5));
+	CHECK_EQUAL(NRF24L01_VerifyShadow(psPTX), PDLIB_NRF24_SUCCESS);
+
+	TestAddressExchange(&sLink);
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+static void
+TestAddressWidth(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX = &sLink.sRadio[TEST_PTX];
+	tNRF24L01Sim *psSim = &sLink.sSim[TEST_PTX];
+	tNRF24L01Config sConfig;
+	unsigned char ucUpper[5];
+	unsigned char ucOther[5] = { 0xA1, 0xB2, 0xC3, 0xD4, 0xE5 };
+	unsigned int uiRadio;
+	int iPRX;
+	int iUpper;
+	int iOther;
+
+	TestLinkInit(&sLink, 0);
+
+	/* PS: 3 byte addresses on both sides */
+	for(uiRadio = 0; uiRadio < 2; uiRadio++)
+	{
+		NRF24L01_GetConfig(&sLink.sRadio[uiRadio], &sConfig);
+		sConfig.ucSetupAW = 0x01;
+		CHECK_EQUAL(NRF24L01_ApplyConfig(&sLink.sRadio[uiRadio], &sConfig), 4);
+	}
+
+	/* PS: Differs from the PRX past the width only, which is the same node now */
+	memcpy(ucUpper, g_ucTestAddress, sizeof(ucUpper));
+	ucUpper[4] ^= 0xFF;
+
+	iPRX = NRF24L01_AddressBookAdd(psPTX, g_ucTestAddress);
+	iUpper = NRF24L01_AddressBookAdd(psPTX, ucUpper);
+	iOther = NRF24L01_AddressBookAdd(psPTX, ucOther);
+
+	TestAddressExchange(&sLink);
+	NRF24L01_SimResetStats(psSim);
+
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iUpper), 0);
+	CHECK_EQUAL(psSim->sStats.ulTransfers, 0);
+
+	/* PS: At most the 3 bytes of the width */
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iOther), 2);
+	CHECK_EQUAL(psSim->sStats.ulSPIBytes, 2 * 4);
+	CHECK(TestAddressIsTarget(psSim, ucOther, 3));
+
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iUpper), 2);
+	CHECK(TestAddressIsTarget(psSim, g_ucTestAddress, 3));
+	CHECK_EQUAL(NRF24L01_VerifyShadow(psPTX), PDLIB_NRF24_SUCCESS);
+
+	TestAddressExchange(&sLink);
+
+	/* PS: Back to 5 bytes, the full addresses are written again and selected as before */
+	NRF24L01_GetConfig(psPTX, &sConfig);
+	sConfig.ucSetupAW = 0x03;
+	CHECK_EQUAL(NRF24L01_ApplyConfig(psPTX, &sConfig), 4);
+
+	NRF24L01_GetConfig(&sLink.sRadio[TEST_PRX], &sConfig);
+	sConfig.ucSetupAW = 0x03;
+	CHECK_EQUAL(NRF24L01_ApplyConfig(&sLink.sRadio[TEST_PRX], &sConfig), 4);
+
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iOther), 2);
+	CHECK(TestAddressIsTarget(psSim, ucOther, 5));
+
+	CHECK_EQUAL(NRF24L01_SelectNode(psPTX, iPRX), 2);
+	CHECK(TestAddressIsTarget(psSim, g_ucTestAddress, 5));
+	CHECK_EQUAL(NRF24L01_VerifyShadow(psPTX), PDLIB_NRF24_SUCCESS);
+
+	TestAddressExchange(&sLink);
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+void
+TestAddress(void)
+{
+	TestAddressSelect();
+	TestAddressWidth();
+}
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * test_config.c
+ *
+ * NRF24L01_GetConfig and NRF24L01_ApplyConfig over the simulated air: the
+ * SPI transactions of a configuration change are only the writes of what
+ * changed (NRF24L01_CONF_TRANSACTION_STATS), and a new address width sizes
+ * the address writes and NRF24L01_VerifyShadow.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_TRANSACTION_STATS)
+
+/* PS: SPI transactions of the radio on every path */
+static unsigned long
+TestConfigTransactions(tNRF24L01 *psRadio)
+{
+	unsigned long ulCount = 0;
+	unsigned char ucPath;
+
+	for(ucPath = 0; ucPath < PDLIB_NRF24_PATH_COUNT; ucPath++)
+	{
+		ulCount += NRF24L01_GetTransactionCount(psRadio, ucPath);
+	}
+
+	return ulCount;
+}
+
+/* PS: One 32 byte payload from the PTX, which must arrive unchanged at the PRX */
+static void
+TestConfigExchange(tTestLink *psLink)
+{
+	tNRF24L01 *psPRX = &psLink->sRadio[TEST_PRX];
+	char cData[32];
+	char cRead[32];
+	char cLength = sizeof(cRead);
+	char cPipe;
+
+	memset(cData, 0xA5, sizeof(cData));
+
+	CHECK_EQUAL(NRF24L01_SendData(&psLink->sRadio[TEST_PTX], cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_IsDataReadyRx(psPRX, &cPipe), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_GetData(psPRX, cPipe, cRead, &cLength), sizeof(cRead));
+	CHECK(0 == memcmp(cData, cRead, sizeof(cRead)));
+}
+
+static void
+TestConfigMinimalWrites(void)
+{
+	tTestLink sLink;
+	tNRF24L01Config sConfig;
+	unsigned int uiRadio;
+	tNRF24L01 *psRadio;
+
+	TestLinkInit(&sLink, 0);
+
+	for(uiRadio = 0; uiRadio < 2; uiRadio++)
+	{
+		psRadio = &sLink.sRadio[uiRadio];
+
+		NRF24L01_GetConfig(psRadio, &sConfig);
+		NRF24L01_ResetTransactionCount(psRadio);
+
+		/* PS: Unchanged, no SPI at all */
+		CHECK_EQUAL(NRF24L01_ApplyConfig(psRadio, &sConfig), 0);
+		CHECK_EQUAL(TestConfigTransactions(psRadio), 0);
+
+		/* PS: A channel hop is one register write, in RX mode as well */
+		sConfig.ucRFChannel = 40;
+
+		CHECK_EQUAL(NRF24L01_ApplyConfig(psRadio, &sConfig), 1);
+		CHECK_EQUAL(TestConfigTransactions(psRadio), 1);
+		CHECK_EQUAL(NRF24L01_GetTransactionCount(psRadio, PDLIB_NRF24_PATH_REGISTER_WRITE), 1);
+		CHECK_EQUAL(sLink.sSim[uiRadio].ucRegister[RF24_RF_CH], 40);
+
+		/* PS: The shadow took it, the same configuration again is free */
+		CHECK_EQUAL(NRF24L01_ApplyConfig(psRadio, &sConfig), 0);
+		CHECK_EQUAL(TestConfigTransactions(psRadio), 1);
+
+		CHECK_EQUAL(NRF24L01_VerifyShadow(psRadio), PDLIB_NRF24_SUCCESS);
+	}
+
+	/* PS: Both on the new channel */
+	TestConfigExchange(&sLink);
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+static void
+TestConfigAddressWidth(void)
+{
+	tTestLink sLink;
+	tNRF24L01Config sConfig;
+	unsigned char ucAddress[5] = { 0x66, 0x77, 0x88, 0x99, 0xAA };
+	unsigned int uiRadio;
+	tNRF24L01 *psRadio;
+
+	TestLinkInit(&sLink, 0);
+
+	for(uiRadio = 0; uiRadio < 2; uiRadio++)
+	{
+		psRadio = &sLink.sRadio[uiRadio];
+
+		NRF24L01_GetConfig(psRadio, &sConfig);
+		NRF24L01_ResetTransactionCount(psRadio);
+
+		/* PS: SETUP_AW and the three full addresses again, at 3 bytes each */
+		sConfig.ucSetupAW = 0x01;
+
+		CHECK_EQUAL(NRF24L01_ApplyConfig(psRadio, &sConfig), 4);
+		CHECK_EQUAL(TestConfigTransactions(psRadio), 4);
+
+		/* PS: The module holds 3 bytes, the shadow is compared over as many */
+		CHECK_EQUAL(NRF24L01_VerifyShadow(psRadio), PDLIB_NRF24_SUCCESS);
+	}
+
+	/* PS: The first 3 bytes of g_ucTestAddress on both sides */
+	TestConfigExchange(&sLink);
+
+	/* PS: An address write is 3 bytes now, the PRX takes its new address in RX mode */
+	NRF24L01_SetTXAddress(&sLink.sRadio[TEST_PTX], ucAddress);
+
+	NRF24L01_GetConfig(&sLink.sRadio[TEST_PRX], &sConfig);
+	memcpy(sConfig.ucRxAddrP1, ucAddress, sizeof(ucAddress));
+	CHECK_EQUAL(NRF24L01_ApplyConfig(&sLink.sRadio[TEST_PRX], &sConfig), 1);
+
+	CHECK(0 == memcmp(sLink.sSim[TEST_PTX].ucAddress[RF24_TX_ADDR - RF24_RX_ADDR_P0], ucAddress, 3));
+	CHECK(0 == memcmp(sLink.sSim[TEST_PRX].ucAddress[RF24_RX_ADDR_P1 - RF24_RX_ADDR_P0], ucAddress, 3));
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].ucAddress[RF24_TX_ADDR - RF24_RX_ADDR_P0][3], g_ucTestAddress[3]);
+
+	CHECK_EQUAL(NRF24L01_VerifyShadow(&sLink.sRadio[TEST_PTX]), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_VerifyShadow(&sLink.sRadio[TEST_PRX]), PDLIB_NRF24_SUCCESS);
+
+	TestConfigExchange(&sLink);
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+void
+TestConfig(void)
+{
+	TestConfigMinimalWrites();
+	TestConfigAddressWidth();
+}
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * test_dma.c
+ *
+ * uDMA payload transfers (PDLIB_SPI_CONF_UDMA) on the Stellaris fake: the
+ * channel descriptors pdlib_spi.c sets up, the transfer running on its own
+ * until the SSI interrupt completes it, and the bytes reaching the chip.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL) && defined(PDLIB_SPI_CONF_UDMA)
+
+#include "inc/hw_ssi.h"
+#include "inc/hw_ints.h"
+#include "driverlib/udma.h"
+
+/* PS: uDMA channels of SSI3 */
+#define TEST_DMA_RX		14
+#define TEST_DMA_TX		15
+
+/* PS: Ticks to clock a payload out, with some to spare */
+#define TEST_DMA_TICKS	((33 + 8) * STELLARIS_FAKE_TICKS_PER_BYTE)
+
+static unsigned int g_uiCallbacks;
+static int g_iResult;
+
+static void
+TestDMACallback(tNRF24L01 *psRadio, int iResult)
+{
+	(void)psRadio;
+
+	g_uiCallbacks++;
+	g_iResult = iResult;
+}
+
+static void
+TestDMAInit(tTestBoard *psBoard)
+{
+	TestBoardInit(psBoard);
+
+	StellarisFakeSetISR(INT_SSI3, pdlibSPI_DMAIntHandler);
+	NRF24L01_DMAInit(&psBoard->sRadio, NULL);
+
+	g_uiCallbacks = 0;
+	g_iResult = PDLIB_NRF24_ERROR;
+}
+
+static void
+TestDMAWrite(void)
+{
+	tTestBoard sBoard;
+	const tStellarisFakeDMAChannel *psTx = StellarisFakeDMAChannel(TEST_DMA_TX);
+	const tStellarisFakeDMAChannel *psRx = StellarisFakeDMAChannel(TEST_DMA_RX);
+	char cPayload[32];
+	unsigned int uiIndex;
+
+	TestDMAInit(&sBoard);
+
+	for(uiIndex = 0; uiIndex < sizeof(cPayload); uiIndex++)
+	{
+		cPayload[uiIndex] = (char)(uiIndex * 3);
+	}
+
+	CHECK_EQUAL(NRF24L01_SetTxPayloadDMA(&sBoard.sRadio, cPayload, sizeof(cPayload), TestDMACallback), PDLIB_NRF24_SUCCESS);
+
+	/* PS: Descriptors, the buffer into the data register and the data register into a sink */
+	CHECK(psTx->pvSrc == cPayload);
+	CHECK(psTx->pvDst == (void *)(TEST_SSI_BASE + SSI_O_DR));
+	CHECK_EQUAL(psTx->ulSize, sizeof(cPayload));
+	CHECK_EQUAL(psTx->ulControl & UDMA_SRC_INC_NONE, UDMA_SRC_INC_8);
+	CHECK_EQUAL(psTx->ulControl & UDMA_DST_INC_NONE, UDMA_DST_INC_NONE);
+	CHECK(psRx->pvSrc == (void *)(TEST_SSI_BASE + SSI_O_DR));
+	CHECK_EQUAL(psRx->ulSize, sizeof(cPayload));
+	CHECK_EQUAL(psRx->ulControl & UDMA_DST_INC_NONE, UDMA_DST_INC_NONE);
+
+	/* PS: Running, CSN held low until the SSI interrupt */
+	CHECK_EQUAL(NRF24L01_IsTransferBusy(&sBoard.sRadio), 1);
+	CHECK_EQUAL(g_uiCallbacks, 0);
+	CHECK_EQUAL(sBoard.sSSI.ucCSN, 0);
+
+	StellarisFakeRun(TEST_DMA_TICKS);
+
+	CHECK_EQUAL(NRF24L01_IsTransferBusy(&sBoard.sRadio), 0);
+	CHECK_EQUAL(g_uiCallbacks, 1);
+	CHECK_EQUAL(g_iResult, PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(sBoard.sSSI.ucCSN, 1);
+	CHECK_EQUAL(psRx->ulMode, UDMA_MODE_STOP);
+
+	CHECK_EQUAL(sBoard.sSim.ucTxCount, 1);
+	CHECK_EQUAL(sBoard.sSim.ucTxLength[0], sizeof(cPayload));
+	CHECK(0 == memcmp(sBoard.sSim.ucTxPayload[0], cPayload, sizeof(cPayload)));
+	CHECK_EQUAL(sBoard.sSSI.ulOverruns, 0);
+	CHECK_EQUAL(sBoard.sSim.sStats.ulViolations, 0);
+}
+
+static void
+TestDMARead(void)
+{
+	tTestBoard sBoard;
+	const tStellarisFakeDMAChannel *psTx = StellarisFakeDMAChannel(TEST_DMA_TX);
+	const tStellarisFakeDMAChannel *psRx = StellarisFakeDMAChannel(TEST_DMA_RX);
+	char cPayload[32];
+	char cRead[32];
+	unsigned int uiIndex;
+
+	TestDMAInit(&sBoard);
+
+	for(uiIndex = 0; uiIndex < sizeof(cPayload); uiIndex++)
+	{
+		cPayload[uiIndex] = (char)(0x80 | uiIndex);
+	}
+
+	memcpy(sBoard.sSim.ucRxPayload[0], cPayload, sizeof(cPayload));
+	sBoard.sSim.ucRxLength[0] = sizeof(cPayload);
+	sBoard.sSim.ucRxPipe[0] = PDLIB_NRF24_PIPE1;
+	sBoard.sSim.ucRxCount = 1;
+
+	memset(cRead, 0, sizeof(cRead));
+
+	CHECK_EQUAL(NRF24L01_ReadRxPayloadDMA(&sBoard.sRadio, cRead, sizeof(cRead), TestDMACallback), PDLIB_NRF24_SUCCESS);
+
+	/* PS: The fill byte out of one cell, the data register into the buffer */
+	CHECK(psRx->pvDst == cRead);
+	CHECK_EQUAL(psRx->ulControl & UDMA_DST_INC_NONE, UDMA_DST_INC_8);
+	CHECK_EQUAL(psTx->ulControl & UDMA_SRC_INC_NONE, UDMA_SRC_INC_NONE);
+	CHECK_EQUAL(*(unsigned char *)psTx->pvSrc, 0xFF);
+
+	/* PS: Another transfer is refused while one runs */
+	CHECK_EQUAL(NRF24L01_ReadRxPayloadDMA(&sBoard.sRadio, cRead, sizeof(cRead), TestDMACallback), PDLIB_NRF24_BUSY);
+
+	StellarisFakeRun(TEST_DMA_TICKS);
+
+	CHECK_EQUAL(g_uiCallbacks, 1);
+	CHECK(0 == memcmp(cPayload, cRead, sizeof(cRead)));
+	CHECK_EQUAL(sBoard.sSim.ucRxCount, 0);
+}
+
+static void
+TestDMAAckPayload(void)
+{
+	tTestBoard sBoard;
+	char cAck[16];
+
+	TestDMAInit(&sBoard);
+	memset(cAck, 0x5A, sizeof(cAck));
+
+	NRF24L01_PowerDown(&sBoard.sRadio);
+	NRF24L01_EnableFeatureDynPL(&sBoard.sRadio, PDLIB_NRF24_PIPE5);
+	NRF24L01_EnableFeatureAckPL(&sBoard.sRadio);
+
+	/* PS: Pipe 5 is valid, pipe 6 is not */
+	CHECK_EQUAL(NRF24L01_SetAckPayloadDMA(&sBoard.sRadio, cAck, PDLIB_NRF24_PIPE5 + 1, sizeof(cAck), TestDMACallback), PDLIB_NRF24_ERROR);
+	CHECK_EQUAL(NRF24L01_SetAckPayloadDMA(&sBoard.sRadio, cAck, PDLIB_NRF24_PIPE5, sizeof(cAck), TestDMACallback), PDLIB_NRF24_SUCCESS);
+
+	StellarisFakeRun(TEST_DMA_TICKS);
+
+	CHECK_EQUAL(g_uiCallbacks, 1);
+	CHECK_EQUAL(NRF24L01_SetAckPayload(&sBoard.sRadio, cAck, PDLIB_NRF24_PIPE5 + 1, sizeof(cAck)), PDLIB_NRF24_ERROR);
+	CHECK_EQUAL(NRF24L01_SetAckPayload(&sBoard.sRadio, cAck, PDLIB_NRF24_PIPE5, sizeof(cAck)), PDLIB_NRF24_SUCCESS);
+
+	CHECK_EQUAL(sBoard.sSim.ucTxCount, 2);
+	CHECK_EQUAL(sBoard.sSim.sStats.ulViolations, 0);
+}
+
+void
+TestDMA(void)
+{
+	TestDMAWrite();
+	TestDMARead();
+	TestDMAAckPayload();
+}
+
+#endif
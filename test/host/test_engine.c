@@ -0,0 +1,435 @@
+/*
+ * test_engine.c
+ *
+ * The SPI engine (NRF24L01_CONF_SPI_ENGINE). On a backend, the PRX behind
+ * the fake SSI module (common/pdlib_nrf24l01_ssi_fake.c): descriptors
+ * complete in the order they were submitted, a full queue refuses the next
+ * one, and an IRQ chain which finds the queue full ends and leaves the rest
+ * of the RX FIFO to the next start. With the built-in SSI code on the
+ * Stellaris fake: a descriptor submitted from an interrupt while a blocking
+ * transaction holds CSN low waits until CSN is high again (ucBusHeld).
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(NRF24L01_CONF_SPI_ENGINE) && (defined(NRF24L01_CONF_HAL) || defined(PART_LM4F120H5QR))
+
+#include "nRF24L01.h"
+
+static unsigned char g_ucTestEngineOrder[NRF24L01_CONF_SPI_ENGINE_DEPTH + 1];
+static unsigned int g_uiTestEngineCompleted;
+
+/* PS: Completion of a descriptor, pvArg is its index */
+static void
+TestEngineOpDone(tNRF24L01 *psRadio, tNRF24L01SPIOp *psOp)
+{
+	(void)psRadio;
+
+	if(g_uiTestEngineCompleted < sizeof(g_ucTestEngineOrder))
+	{
+		g_ucTestEngineOrder[g_uiTestEngineCompleted] = (unsigned char)(size_t)psOp->pvArg;
+	}
+
+	g_uiTestEngineCompleted++;
+}
+
+#endif
+
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_SPI_ENGINE)
+
+#include "pdlib_nrf24l01_ssi_fake.h"
+
+/* PS: Bytes the SSI clocks between two looks at its interrupt */
+#define TEST_ENGINE_FIFO_BYTES	4
+
+/* PS: Steps of NRF24L01_SSIFakeRun before the engine counts as stuck */
+#define TEST_ENGINE_GUARD		100000
+
+/* PS: tTestLink with the PRX behind the fake SSI module */
+typedef struct
+{
+	tTestLink sLink;
+	tNRF24L01SSIFake sSSI;
+}tTestEngine;
+
+static tNRF24L01SPIOp g_sTestEngineFill[NRF24L01_CONF_SPI_ENGINE_DEPTH];
+static unsigned char g_ucTestEngineFill;
+static unsigned char g_ucTestEnginePayload[4];
+static unsigned int g_uiTestEnginePayloads;
+static unsigned int g_uiTestEngineDone;
+
+/* PS: What the SSI interrupt handler of a target would do */
+static void
+TestEngineISR(void *pvArg)
+{
+	NRF24L01_SPIEngineService((tNRF24L01 *)pvArg);
+}
+
+/* PS: As TestLinkInit, the PRX on the fake SSI module */
+static void
+TestEngineInit(tTestEngine *psEngine)
+{
+	tTestLink *psLink = &psEngine->sLink;
+	tNRF24L01AirConfig sConfig;
+	unsigned int uiIndex;
+
+	memset(psEngine, 0, sizeof(tTestEngine));
+	memset(&sConfig, 0, sizeof(sConfig));
+
+	sConfig.ulSeed = 1;
+
+	NRF24L01_AirInit(&psLink->sAir, &sConfig);
+
+	for(uiIndex = 0; uiIndex < 2; uiIndex++)
+	{
+		NRF24L01_SimInit(&psLink->sSim[uiIndex]);
+		NRF24L01_AirAddRadio(&psLink->sAir, &psLink->sSim[uiIndex]);
+	}
+
+	NRF24L01_SSIFakeInit(&psEngine->sSSI, &g_sNRF24L01SimHAL, &psLink->sSim[TEST_PRX]);
+	NRF24L01_SSIFakeSetISR(&psEngine->sSSI, TestEngineISR, &psLink->sRadio[TEST_PRX]);
+
+	NRF24L01_InitHAL(&psLink->sRadio[TEST_PTX], &g_sNRF24L01SimHAL, &psLink->sSim[TEST_PTX]);
+	NRF24L01_InitHAL(&psLink->sRadio[TEST_PRX], &g_sNRF24L01SSIFakeHAL, &psEngine->sSSI);
+
+	for(uiIndex = 0; uiIndex < 2; uiIndex++)
+	{
+		NRF24L01_SetPowerPolicy(&psLink->sRadio[uiIndex], PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+	}
+
+	NRF24L01_SetTXAddress(&psLink->sRadio[TEST_PTX], g_ucTestAddress);
+	NRF24L01_PowerUp(&psLink->sRadio[TEST_PTX]);
+
+	NRF24L01_SetRxAddress(&psLink->sRadio[TEST_PRX], PDLIB_NRF24_PIPE1, g_ucTestAddress);
+	NRF24L01_SetRXPacketSize(&psLink->sRadio[TEST_PRX], PDLIB_NRF24_PIPE1, 32);
+	NRF24L01_EnableRxMode(&psLink->sRadio[TEST_PRX]);
+
+	TestLinkRun(psLink, 2000);
+
+	NRF24L01_SimResetStats(&psLink->sSim[TEST_PTX]);
+	NRF24L01_SimResetStats(&psLink->sSim[TEST_PRX]);
+
+	g_uiTestEngineCompleted = 0;
+	g_ucTestEngineFill = 0;
+	g_uiTestEnginePayloads = 0;
+	g_uiTestEngineDone = 0;
+}
+
+/* PS: The SSI runs until the engine of the PRX is idle */
+static int
+TestEngineRun(tTestEngine *psEngine)
+{
+	tNRF24L01 *psPRX = &psEngine->sLink.sRadio[TEST_PRX];
+	unsigned long ulSteps = 0;
+
+	while(!NRF24L01_IsSPIEngineIdle(psPRX) && (ulSteps < TEST_ENGINE_GUARD))
+	{
+		NRF24L01_SSIFakeRun(&psEngine->sSSI, TEST_ENGINE_FIFO_BYTES);
+		ulSteps++;
+	}
+
+	return NRF24L01_IsSPIEngineIdle(psPRX);
+}
+
+/* PS: Payloads 0, 1, ... from the PTX, byte 0 is the number */
+static void
+TestEngineSend(tTestEngine *psEngine, unsigned int uiCount)
+{
+	char cData[32];
+	unsigned int uiIndex;
+
+	for(uiIndex = 0; uiIndex < uiCount; uiIndex++)
+	{
+		memset(cData, 0, sizeof(cData));
+		cData[0] = (char)uiIndex;
+
+		CHECK_EQUAL(NRF24L01_SendData(&psEngine->sLink.sRadio[TEST_PTX], cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	}
+
+	/* PS: Let the last ACK finish */
+	TestLinkRun(&psEngine->sLink, 500);
+}
+
+static void
+TestEngineChainPayload(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain)
+{
+	unsigned int uiIndex;
+
+	if(g_uiTestEnginePayloads < sizeof(g_ucTestEnginePayload))
+	{
+		g_ucTestEnginePayload[g_uiTestEnginePayloads] = (unsigned char)psChain->cData[0];
+	}
+
+	g_uiTestEnginePayloads++;
+
+	/* PS: Another user of the engine takes every slot before the chain asks for its next step */
+	if(g_ucTestEngineFill)
+	{
+		g_ucTestEngineFill = 0;
+
+		for(uiIndex = 0; uiIndex < NRF24L01_CONF_SPI_ENGINE_DEPTH; uiIndex++)
+		{
+			memset(&g_sTestEngineFill[uiIndex], 0, sizeof(tNRF24L01SPIOp));
+			g_sTestEngineFill[uiIndex].ucCommand = RF24_NOP;
+
+			CHECK_EQUAL(NRF24L01_SPIEngineSubmit(psRadio, &g_sTestEngineFill[uiIndex]), PDLIB_NRF24_SUCCESS);
+		}
+	}
+}
+
+static void
+TestEngineChainDone(tNRF24L01 *psRadio, tNRF24L01IRQChain *psChain)
+{
+	(void)psRadio;
+	(void)psChain;
+
+	g_uiTestEngineDone++;
+}
+
+static void
+TestEngineOrder(void)
+{
+	tTestEngine sEngine;
+	tNRF24L01 *psPRX = &sEngine.sLink.sRadio[TEST_PRX];
+	tNRF24L01SPIOp sOp[NRF24L01_CONF_SPI_ENGINE_DEPTH + 1];
+	tNRF24L01SPIEngineStats sStats;
+	unsigned char ucWrite = 0xA5;
+	unsigned char ucRead = 0;
+	unsigned int uiIndex;
+
+	TestEngineInit(&sEngine);
+	memset(sOp, 0, sizeof(sOp));
+
+	/* PS: The chip takes register writes in Standby only */
+	NRF24L01_DisableRxMode(psPRX);
+
+	/* PS: A register outside the shadow, the engine does not update the shadow */
+	sOp[0].ucCommand = (RF24_W_REGISTER | RF24_RX_ADDR_P2);
+	sOp[0].pucTxData = &ucWrite;
+	sOp[0].uiLength = 1;
+	sOp[1].ucCommand = (RF24_R_REGISTER | RF24_RX_ADDR_P2);
+	sOp[1].pucRxData = &ucRead;
+	sOp[1].uiLength = 1;
+
+	for(uiIndex = 2; uiIndex <= NRF24L01_CONF_SPI_ENGINE_DEPTH; uiIndex++)
+	{
+		sOp[uiIndex].ucCommand = RF24_NOP;
+	}
+
+	/* PS: The SSI stands still, the queue fills up and refuses one more */
+	for(uiIndex = 0; uiIndex <= NRF24L01_CONF_SPI_ENGINE_DEPTH; uiIndex++)
+	{
+		sOp[uiIndex].pfnComplete = TestEngineOpDone;
+		sOp[uiIndex].pvArg = (void *)(size_t)uiIndex;
+
+		CHECK_EQUAL(NRF24L01_SPIEngineSubmit(psPRX, &sOp[uiIndex]),
+					((uiIndex < NRF24L01_CONF_SPI_ENGINE_DEPTH) ? PDLIB_NRF24_SUCCESS : PDLIB_NRF24_BUSY));
+	}
+
+	CHECK_EQUAL(NRF24L01_SPIEngineSubmit(psPRX, NULL), PDLIB_NRF24_INVALID_ARGUMENT);
+	CHECK_EQUAL(NRF24L01_IsSPIEngineIdle(psPRX), 0);
+
+	NRF24L01_GetSPIEngineStats(psPRX, &sStats);
+	CHECK_EQUAL(sStats.ulSubmitted, NRF24L01_CONF_SPI_ENGINE_DEPTH);
+	CHECK_EQUAL(sStats.ulRejected, 1);
+	CHECK_EQUAL(sStats.uiHighWater, NRF24L01_CONF_SPI_ENGINE_DEPTH);
+	CHECK_EQUAL(g_uiTestEngineCompleted, 0);
+
+	CHECK(TestEngineRun(&sEngine));
+
+	/* PS: In order, the read after the write sees it */
+	CHECK_EQUAL(g_uiTestEngineCompleted, NRF24L01_CONF_SPI_ENGINE_DEPTH);
+
+	for(uiIndex = 0; uiIndex < NRF24L01_CONF_SPI_ENGINE_DEPTH; uiIndex++)
+	{
+		CHECK_EQUAL(g_ucTestEngineOrder[uiIndex], uiIndex);
+	}
+
+	CHECK_EQUAL(ucRead, ucWrite);
+	CHECK_EQUAL(sEngine.sLink.sSim[TEST_PRX].ucRegister[RF24_RX_ADDR_P2], ucWrite);
+
+	NRF24L01_GetSPIEngineStats(psPRX, &sStats);
+	CHECK_EQUAL(sStats.ulCompleted, NRF24L01_CONF_SPI_ENGINE_DEPTH);
+	CHECK_EQUAL(sStats.ulBytes, 2 + 2 + (NRF24L01_CONF_SPI_ENGINE_DEPTH - 2));
+
+	/* PS: The last descriptor stored its STATUS, the blocking API goes on from there */
+	CHECK_EQUAL(sOp[NRF24L01_CONF_SPI_ENGINE_DEPTH - 1].ucStatus, NRF24L01_GetLastStatus(psPRX, NULL));
+	CHECK_EQUAL(NRF24L01_RegisterRead_8(psPRX, RF24_RX_ADDR_P2), ucWrite);
+
+	CHECK_EQUAL(sEngine.sSSI.ulOverruns, 0);
+	CHECK_EQUAL(sEngine.sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+static void
+TestEngineChainFull(void)
+{
+	tTestEngine sEngine;
+	tNRF24L01 *psPRX = &sEngine.sLink.sRadio[TEST_PRX];
+	tNRF24L01Sim *psSim = &sEngine.sLink.sSim[TEST_PRX];
+	tNRF24L01IRQChain sChain;
+	tNRF24L01SPIEngineStats sStats;
+
+	TestEngineInit(&sEngine);
+
+	memset(&sChain, 0, sizeof(sChain));
+	sChain.pfnPayload = TestEngineChainPayload;
+	sChain.pfnDone = TestEngineChainDone;
+
+	/* PS: Both payloads in one run */
+	TestEngineSend(&sEngine, 2);
+	CHECK_EQUAL(NRF24L01_SimGetIRQ(psSim), 0);
+
+	CHECK_EQUAL(NRF24L01_IRQChainStart(psPRX, &sChain), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_IRQChainStart(psPRX, &sChain), PDLIB_NRF24_BUSY);
+	CHECK(TestEngineRun(&sEngine));
+
+	CHECK_EQUAL(sChain.ucBusy, 0);
+	CHECK_EQUAL(sChain.uiPayloads, 2);
+	CHECK(sChain.cState & PDLIB_INTERRUPT_DATA_READY);
+	CHECK_EQUAL(g_uiTestEngineDone, 1);
+	CHECK_EQUAL(NRF24L01_SimGetIRQ(psSim), 1);
+	CHECK_EQUAL(psSim->ucRxCount, 0);
+
+	/* PS: The queue is full when the chain submits the step after the first payload */
+	TestEngineSend(&sEngine, 2);
+
+	g_ucTestEngineFill = 1;
+	g_uiTestEnginePayloads = 0;
+	g_uiTestEngineDone = 0;
+	NRF24L01_ResetSPIEngineStats(psPRX);
+
+	CHECK_EQUAL(NRF24L01_IRQChainStart(psPRX, &sChain), PDLIB_NRF24_SUCCESS);
+	CHECK(TestEngineRun(&sEngine));
+
+	/* PS: The chain ended there, pfnDone was told and the second payload waits in the chip */
+	CHECK_EQUAL(sChain.ucBusy, 0);
+	CHECK_EQUAL(sChain.uiPayloads, 1);
+	CHECK_EQUAL(g_uiTestEngineDone, 1);
+	CHECK_EQUAL(psSim->ucRxCount, 1);
+
+	NRF24L01_GetSPIEngineStats(psPRX, &sStats);
+	CHECK_EQUAL(sStats.ulRejected, 1);
+
+	/* PS: The next start reads it */
+	CHECK_EQUAL(NRF24L01_IRQChainStart(psPRX, &sChain), PDLIB_NRF24_SUCCESS);
+	CHECK(TestEngineRun(&sEngine));
+
+	CHECK_EQUAL(sChain.uiPayloads, 1);
+	CHECK_EQUAL(g_uiTestEngineDone, 2);
+	CHECK_EQUAL(psSim->ucRxCount, 0);
+
+	CHECK_EQUAL(g_uiTestEnginePayloads, 2);
+	CHECK_EQUAL(g_ucTestEnginePayload[0], 0);
+	CHECK_EQUAL(g_ucTestEnginePayload[1], 1);
+
+	CHECK_EQUAL(sEngine.sSSI.ulOverruns, 0);
+	CHECK_EQUAL(psSim->sStats.ulViolations, 0);
+}
+
+#endif
+
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_SPI_ENGINE)
+
+#include "inc/hw_ints.h"
+
+/* PS: Ticks of the Stellaris fake before the engine counts as stuck */
+#define TEST_ENGINE_TICKS		10000
+
+static tNRF24L01 *g_psTestEngineRadio;
+static tNRF24L01SPIOp *g_psTestEngineSubmit;
+static int g_iTestEngineSubmit;
+static unsigned char g_ucTestEngineHeld;
+static unsigned char g_ucTestEngineBusy;
+
+/* PS: The SSI interrupt, which also stands in for an IRQ handler submitting a descriptor */
+static void
+TestEngineSSIHandler(void)
+{
+	if(g_psTestEngineSubmit)
+	{
+		g_iTestEngineSubmit = NRF24L01_SPIEngineSubmit(g_psTestEngineRadio, g_psTestEngineSubmit);
+		g_ucTestEngineHeld = g_psTestEngineRadio->ucBusHeld;
+		g_ucTestEngineBusy = g_psTestEngineRadio->ucEngineBusy;
+		g_psTestEngineSubmit = NULL;
+	}
+
+	NRF24L01_SPIEngineService(g_psTestEngineRadio);
+}
+
+static void
+TestEngineBusHeld(void)
+{
+	tTestBoard sBoard;
+	tNRF24L01 *psRadio;
+	tNRF24L01SPIOp sOp;
+	unsigned char ucWrite = 0x5A;
+	unsigned char ucRead[5];
+	unsigned long ulTicks;
+
+	TestBoardInit(&sBoard);
+	psRadio = &sBoard.sRadio;
+
+	g_psTestEngineRadio = psRadio;
+	g_uiTestEngineCompleted = 0;
+	StellarisFakeSetISR(INT_SSI3, TestEngineSSIHandler);
+
+	NRF24L01_SetTXAddress(psRadio, g_ucTestAddress);
+
+	memset(&sOp, 0, sizeof(sOp));
+	sOp.ucCommand = (RF24_W_REGISTER | RF24_RX_ADDR_P2);
+	sOp.pucTxData = &ucWrite;
+	sOp.uiLength = 1;
+	sOp.pfnComplete = TestEngineOpDone;
+
+	/* PS: The interrupt comes with the first byte the blocking read receives */
+	g_psTestEngineSubmit = &sOp;
+	g_iTestEngineSubmit = PDLIB_NRF24_ERROR;
+	pdlibSPI_EnableRxInt(TEST_SSI, 1);
+
+	sBoard.sSSI.ulFrames = 0;
+
+	NRF24L01_RegisterRead_Multi(psRadio, RF24_TX_ADDR, ucRead, sizeof(ucRead));
+
+	/* PS: Queued under the blocking read, not started */
+	CHECK(NULL == g_psTestEngineSubmit);
+	CHECK_EQUAL(g_iTestEngineSubmit, PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(g_ucTestEngineHeld, 1);
+	CHECK_EQUAL(g_ucTestEngineBusy, 0);
+
+	/* PS: The read was not disturbed, raising CSN started the descriptor */
+	CHECK(0 == memcmp(ucRead, g_ucTestAddress, sizeof(ucRead)));
+	CHECK_EQUAL(psRadio->ucBusHeld, 0);
+	CHECK_EQUAL(psRadio->ucEngineBusy, 1);
+
+	for(ulTicks = 0; !NRF24L01_IsSPIEngineIdle(psRadio) && (ulTicks < TEST_ENGINE_TICKS); ulTicks++)
+	{
+		StellarisFakeRun(1);
+	}
+
+	CHECK(NRF24L01_IsSPIEngineIdle(psRadio));
+	CHECK_EQUAL(g_uiTestEngineCompleted, 1);
+	CHECK_EQUAL(sBoard.sSim.ucRegister[RF24_RX_ADDR_P2], ucWrite);
+
+	/* PS: Two CSN low periods, one after the other */
+	CHECK_EQUAL(sBoard.sSSI.ulFrames, 2);
+	CHECK_EQUAL(sBoard.sSSI.ulOverruns, 0);
+	CHECK_EQUAL(sBoard.sSim.sStats.ulViolations, 0);
+}
+
+#endif
+
+#if defined(NRF24L01_CONF_SPI_ENGINE) && (defined(NRF24L01_CONF_HAL) || defined(PART_LM4F120H5QR))
+
+void
+TestEngine(void)
+{
+#ifdef NRF24L01_CONF_HAL
+	TestEngineOrder();
+	TestEngineChainFull();
+#else
+	TestEngineBusHeld();
+#endif
+}
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * test_fake.c
+ *
+ * The driver on the in-process fake backend (pdlib_nrf24l01_hal_fake.c):
+ * SPI cost of register updates and payload writes, a brownout caught by
+ * NRF24L01_VerifyShadow, and a missing module scripted with a handler.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#ifdef NRF24L01_CONF_HAL
+#include "pdlib_nrf24l01_hal_fake.h"
+
+static void
+TestFakeInit(tNRF24L01FakeHAL *psFake, tNRF24L01 *psRadio)
+{
+	NRF24L01_FakeHALInit(psFake);
+	NRF24L01_InitHAL(psRadio, &g_sNRF24L01FakeHAL, psFake);
+
+	psFake->ulTransfers = 0;
+	psFake->ulBytes = 0;
+}
+
+static void
+TestFakeSPICost(void)
+{
+	tNRF24L01FakeHAL sFake;
+	tNRF24L01 sRadio;
+	char cData[32];
+
+	TestFakeInit(&sFake, &sRadio);
+
+	/* PS: A change is one register write, no read-modify-write over SPI */
+	NRF24L01_SetAirDataRate(&sRadio, 1);
+	CHECK_EQUAL(sFake.ulTransfers, 1);
+	CHECK_EQUAL(sFake.ulBytes, 2);
+	CHECK_EQUAL(sFake.ucRegister[RF24_RF_SETUP][0] & RF24_RF_DR, 0);
+
+	/* PS: No change, no SPI */
+	NRF24L01_SetAirDataRate(&sRadio, 1);
+	CHECK_EQUAL(sFake.ulTransfers, 1);
+
+	/* PS: The payload goes out with its command in one transfer */
+	memset(cData, 0x3C, sizeof(cData));
+	CHECK_EQUAL(NRF24L01_SetTxPayload(&sRadio, cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(sFake.ulTransfers, 2);
+	CHECK_EQUAL(sFake.ulBytes, 2 + 1 + sizeof(cData));
+	CHECK_EQUAL(sFake.ucLastPayloadLength, sizeof(cData));
+	CHECK(0 == memcmp(sFake.ucLastPayload, cData, sizeof(cData)));
+}
+
+static void
+TestFakeBrownout(void)
+{
+	tNRF24L01FakeHAL sFake;
+	tNRF24L01 sRadio;
+
+	TestFakeInit(&sFake, &sRadio);
+
+	NRF24L01_SetRFChannel(&sRadio, 76);
+	NRF24L01_SetTXAddress(&sRadio, g_ucTestAddress);
+	CHECK_EQUAL(NRF24L01_VerifyShadow(&sRadio), PDLIB_NRF24_SUCCESS);
+
+	/* PS: The module is back at its reset values, the driver still has the configuration */
+	NRF24L01_FakeHALInit(&sFake);
+	CHECK_EQUAL(NRF24L01_VerifyShadow(&sRadio), PDLIB_NRF24_SHADOW_MISMATCH);
+
+	NRF24L01_RestoreShadow(&sRadio);
+	CHECK_EQUAL(NRF24L01_VerifyShadow(&sRadio), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(sFake.ucRegister[RF24_RF_CH][0], 76);
+	CHECK(0 == memcmp(sFake.ucRegister[RF24_TX_ADDR], g_ucTestAddress, 5));
+}
+
+/* PS: No module on the bus, MISO is pulled up */
+static unsigned char
+TestFakeNoModule(void *pvArg, unsigned char ucCommand, unsigned char *pucTxData,
+				 unsigned char *pucRxData, unsigned int uiLength)
+{
+	(void)pvArg;
+	(void)ucCommand;
+	(void)pucTxData;
+
+	if(pucRxData)
+	{
+		memset(pucRxData, 0xFF, uiLength);
+	}
+
+	return 0xFF;
+}
+
+static void
+TestFakeMissingModule(void)
+{
+	tNRF24L01FakeHAL sFake;
+	tNRF24L01 sRadio;
+	char cPipe;
+
+	TestFakeInit(&sFake, &sRadio);
+	NRF24L01_FakeHALSetHandler(&sFake, TestFakeNoModule, NULL);
+
+	/* PS: RX_P_NO reads 7, no payload is reported */
+	CHECK_EQUAL(NRF24L01_IsDataReadyRx(&sRadio, &cPipe), PDLIB_NRF24_ERROR);
+	CHECK_EQUAL(NRF24L01_VerifyShadow(&sRadio), PDLIB_NRF24_SHADOW_MISMATCH);
+
+	/* PS: The register file answers again once the handler is removed */
+	NRF24L01_FakeHALSetHandler(&sFake, NULL, NULL);
+	CHECK_EQUAL(NRF24L01_VerifyShadow(&sRadio), PDLIB_NRF24_SUCCESS);
+}
+
+void
+TestFake(void)
+{
+	TestFakeSPICost();
+	TestFakeBrownout();
+	TestFakeMissingModule();
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * test_link.c
+ *
+ * Two simulated radios on one simulated air, for the test groups which
+ * need a PTX and a PRX. Without NRF24L01_CONF_HAL, one simulated chip
+ * behind the Stellaris fake instead.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+unsigned char g_ucTestAddress[5] = { 0x11, 0x22, 0x33, 0x44, 0x55 };
+
+#ifdef NRF24L01_CONF_HAL
+
+/* PS: Both radios powered up (PDLIB_NRF24_POWER_ALWAYS_ON) at 2 Mbps, the PRX listening
+ * on pipe 1 at g_ucTestAddress with a 32 byte static payload, the PTX sending to it */
+void
+TestLinkInit(tTestLink *psLink, unsigned long ulLossPPM)
+{
+	tNRF24L01AirConfig sConfig;
+	unsigned int uiIndex;
+
+	memset(psLink, 0, sizeof(tTestLink));
+	memset(&sConfig, 0, sizeof(sConfig));
+
+	sConfig.ulLossPPM = ulLossPPM;
+	sConfig.ulSeed = 1;
+
+	NRF24L01_AirInit(&psLink->sAir, &sConfig);
+
+	for(uiIndex = 0; uiIndex < 2; uiIndex++)
+	{
+		NRF24L01_SimInit(&psLink->sSim[uiIndex]);
+		NRF24L01_AirAddRadio(&psLink->sAir, &psLink->sSim[uiIndex]);
+	}
+
+	for(uiIndex = 0; uiIndex < 2; uiIndex++)
+	{
+		NRF24L01_InitHAL(&psLink->sRadio[uiIndex], &g_sNRF24L01SimHAL, &psLink->sSim[uiIndex]);
+		NRF24L01_SetPowerPolicy(&psLink->sRadio[uiIndex], PDLIB_NRF24_POWER_ALWAYS_ON, 0);
+	}
+
+	NRF24L01_SetTXAddress(&psLink->sRadio[TEST_PTX], g_ucTestAddress);
+	NRF24L01_PowerUp(&psLink->sRadio[TEST_PTX]);
+
+	NRF24L01_SetRxAddress(&psLink->sRadio[TEST_PRX], PDLIB_NRF24_PIPE1, g_ucTestAddress);
+	NRF24L01_SetRXPacketSize(&psLink->sRadio[TEST_PRX], PDLIB_NRF24_PIPE1, 32);
+	NRF24L01_EnableRxMode(&psLink->sRadio[TEST_PRX]);
+
+	/* PS: Out of power down on both sides */
+	TestLinkRun(psLink, 2000);
+
+	NRF24L01_SimResetStats(&psLink->sSim[TEST_PTX]);
+	NRF24L01_SimResetStats(&psLink->sSim[TEST_PRX]);
+}
+
+void
+TestLinkRun(tTestLink *psLink, unsigned long ulUs)
+{
+	NRF24L01_AirRun(&psLink->sAir, NRF24L01_AirGetTimeUs(&psLink->sAir) + ulUs);
+}
+
+unsigned long long
+TestLinkTimeUs(tTestLink *psLink)
+{
+	return NRF24L01_AirGetTimeUs(&psLink->sAir);
+}
+
+#endif
+
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL)
+
+/* PS: SSI3 at 8 MHz, CE on PE1 and CSN on PE2. The counters of the SSI fake and the
+ * simulator start after NRF24L01_Init. */
+void
+TestBoardInit(tTestBoard *psBoard)
+{
+	memset(psBoard, 0, sizeof(tTestBoard));
+
+	NRF24L01_SimInit(&psBoard->sSim);
+	NRF24L01_SSIFakeInit(&psBoard->sSSI, &g_sNRF24L01SimHAL, &psBoard->sSim);
+	StellarisFakeInit(&psBoard->sSSI, &psBoard->sSim, TEST_SSI_BASE,
+					  GPIO_PORTE_BASE, GPIO_PIN_1, GPIO_PORTE_BASE, GPIO_PIN_2);
+
+#ifdef NRF24L01_CONF_STATIC_WIRING
+	/* PS: pdlib_nrf24l01_wiring.h is wired the same, at its own SPI bit rate */
+	NRF24L01_InitStatic(&psBoard->sRadio);
+#ifdef NRF24L01_CONF_INTERRUPT_PIN
+	NRF24L01_InterruptInitStatic(&psBoard->sRadio);
+#endif
+#else
+	NRF24L01_Init(&psBoard->sRadio, GPIO_PORTE_BASE, GPIO_PIN_1, SYSCTL_PERIPH_GPIOE,
+				  GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE, TEST_SSI, 8000000);
+#endif
+
+	psBoard->sSSI.ulBytes = 0;
+	psBoard->sSSI.ulFrames = 0;
+	psBoard->sSSI.ulGaps = 0;
+
+	NRF24L01_SimResetStats(&psBoard->sSim);
+}
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * test_power.c
+ *
+ * The power policies over the simulated air: the time per packet of each
+ * PDLIB_NRF24_POWER_* policy against NRF24L01_EstimateTxTime, and the
+ * power down of PDLIB_NRF24_POWER_IDLE_TIMEOUT counted by NRF24L01_Tick.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#ifdef NRF24L01_CONF_HAL
+
+/* PS: Packets timed per policy */
+#define TEST_POWER_ROUNDS		10
+
+/* PS: Idle timeout of PDLIB_NRF24_POWER_IDLE_TIMEOUT, in ms */
+#define TEST_POWER_IDLE_MS		10
+
+/* PS: Sends one 32 byte payload to the PRX and takes it out of the RX FIFO there. Returns
+ * the simulated time the PTX spent in NRF24L01_SendData, in us. */
+static unsigned long
+TestPowerSend(tTestLink *psLink)
+{
+	tNRF24L01 *psPRX = &psLink->sRadio[TEST_PRX];
+	unsigned long long ullStartUs;
+	unsigned long ulTimeUs;
+	char cData[32];
+	char cLength;
+	char cPipe;
+
+	memset(cData, 0x5A, sizeof(cData));
+
+	ullStartUs = TestLinkTimeUs(psLink);
+	CHECK_EQUAL(NRF24L01_SendData(&psLink->sRadio[TEST_PTX], cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	ulTimeUs = (unsigned long)(TestLinkTimeUs(psLink) - ullStartUs);
+
+	while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(psPRX, &cPipe))
+	{
+		cLength = sizeof(cData);
+		NRF24L01_GetData(psPRX, cPipe, cData, &cLength);
+	}
+
+	return ulTimeUs;
+}
+
+/* PS: The estimate plus the SPI upload, which it leaves out with a HAL backend (no SPI bit
+ * rate known to the driver). The simulator charges the upload at its own bit rate. */
+static unsigned long
+TestPowerEstimate(tTestLink *psLink, unsigned char ucPolicy)
+{
+	tNRF24L01 *psPTX = &psLink->sRadio[TEST_PTX];
+	unsigned long ulTimeUs = NRF24L01_EstimateTxTime(psPTX, ucPolicy, 32);
+
+	if(0 == NRF24L01_GetSPIBitRate(psPTX))
+	{
+		ulTimeUs += (unsigned long)(((1 + 32) * 8 * 1000000ULL) / psLink->sSim[TEST_PTX].ulSPIBitRate);
+	}
+
+	return ulTimeUs;
+}
+
+static int
+TestPowerIsUp(tTestLink *psLink)
+{
+	return ((psLink->sSim[TEST_PTX].ucRegister[RF24_CONFIG] & RF24_PWR_UP) ? 1 : 0);
+}
+
+static void
+TestPowerPolicyTime(unsigned char ucPolicy)
+{
+	tTestLink sLink;
+	unsigned long ulTotalUs = 0;
+	unsigned long ulPacketUs;
+	unsigned long ulEstimateUs;
+	unsigned int uiRound;
+
+	TestLinkInit(&sLink, 0);
+	NRF24L01_SetPowerPolicy(&sLink.sRadio[TEST_PTX], ucPolicy, TEST_POWER_IDLE_MS);
+
+	/* PS: TestLinkInit powered the PTX up, the first packet is not timed */
+	TestPowerSend(&sLink);
+
+	/* PS: Back to back, so PDLIB_NRF24_POWER_IDLE_TIMEOUT never reaches its timeout */
+	for(uiRound = 0; uiRound < TEST_POWER_ROUNDS; uiRound++)
+	{
+		ulTotalUs += TestPowerSend(&sLink);
+		CHECK_EQUAL(TestPowerIsUp(&sLink), (PDLIB_NRF24_POWER_DOWN_AFTER_TX != ucPolicy));
+	}
+
+	ulPacketUs = (ulTotalUs / TEST_POWER_ROUNDS);
+	ulEstimateUs = TestPowerEstimate(&sLink, ucPolicy);
+
+	/* PS: Within 5 %, the rest is the SPI time of the control transactions */
+	CHECK(ulPacketUs >= ulEstimateUs);
+	CHECK((ulPacketUs - ulEstimateUs) <= (ulEstimateUs / 20));
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+}
+
+static void
+TestPowerIdleTimeout(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX;
+	unsigned long ulPacketUs;
+
+	TestLinkInit(&sLink, 0);
+	psPTX = &sLink.sRadio[TEST_PTX];
+
+	NRF24L01_SetPowerPolicy(psPTX, PDLIB_NRF24_POWER_IDLE_TIMEOUT, TEST_POWER_IDLE_MS);
+	TestPowerSend(&sLink);
+
+	/* PS: A packet within the timeout starts the count again */
+	NRF24L01_Tick(psPTX, TEST_POWER_IDLE_MS - 1);
+	CHECK_EQUAL(TestPowerIsUp(&sLink), 1);
+
+	TestPowerSend(&sLink);
+
+	NRF24L01_Tick(psPTX, TEST_POWER_IDLE_MS - 1);
+	CHECK_EQUAL(TestPowerIsUp(&sLink), 1);
+
+	NRF24L01_Tick(psPTX, 1);
+	CHECK_EQUAL(TestPowerIsUp(&sLink), 0);
+
+	/* PS: The next packet pays the power up, as PDLIB_NRF24_POWER_DOWN_AFTER_TX does every time,
+	 * and the module stays up after it */
+	ulPacketUs = TestPowerSend(&sLink);
+
+	CHECK(ulPacketUs >= TestPowerEstimate(&sLink, PDLIB_NRF24_POWER_DOWN_AFTER_TX));
+	CHECK_EQUAL(TestPowerIsUp(&sLink), 1);
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+}
+
+void
+TestPower(void)
+{
+	TestPowerPolicyTime(PDLIB_NRF24_POWER_ALWAYS_ON);
+	TestPowerPolicyTime(PDLIB_NRF24_POWER_IDLE_TIMEOUT);
+	TestPowerPolicyTime(PDLIB_NRF24_POWER_DOWN_AFTER_TX);
+	TestPowerIdleTimeout();
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * test_profile.c
+ *
+ * The function profiles (NRF24L01_CONF_PROFILE): a SendData counts one call
+ * per send with its SPI bytes, min and max bound every call, and
+ * NRF24L01_DumpProfile prints the tick rate, the header and one line for
+ * every function called since NRF24L01_ResetProfile.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_PROFILE)
+
+#define TEST_PROFILE_SENDS		3
+
+typedef struct
+{
+	unsigned int uiLines;
+	unsigned int uiFunctions;
+	int iHeader;
+	int iSendData;
+	int iUnknown;
+}tTestProfileDump;
+
+/* PS: pfnPrint of NRF24L01_DumpProfile */
+static void
+TestProfilePrint(void *pvArg, const char *pcLine)
+{
+	tTestProfileDump *psDump = (tTestProfileDump *)pvArg;
+	const char *pcName;
+	unsigned char ucFunction;
+	unsigned int uiLength;
+
+	psDump->uiLines++;
+
+	if(1 == psDump->uiLines)
+	{
+		return;
+	}
+
+	if(2 == psDump->uiLines)
+	{
+		psDump->iHeader = (0 == strcmp(pcLine, "function,calls,total,min,max,avg,spi_bytes"));
+		return;
+	}
+
+	/* PS: Every other line is "<name>,..." of a known function */
+	for(ucFunction = 0; ucFunction < PDLIB_NRF24_PROF_COUNT; ucFunction++)
+	{
+		pcName = NRF24L01_GetProfileName(ucFunction);
+		uiLength = strlen(pcName);
+
+		if((0 == strncmp(pcLine, pcName, uiLength)) && (',' == pcLine[uiLength]))
+		{
+			psDump->uiFunctions++;
+
+			if(PDLIB_NRF24_PROF_SEND_DATA == ucFunction)
+			{
+				psDump->iSendData = (0 == strncmp(&pcLine[uiLength], ",3,", 3));
+			}
+
+			return;
+		}
+	}
+
+	psDump->iUnknown++;
+}
+
+static void
+TestProfileSendData(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX = &sLink.sRadio[TEST_PTX];
+	tNRF24L01Profile sProfile;
+	tNRF24L01Profile sPayload;
+	tTestProfileDump sDump;
+	char cData[32];
+	unsigned char ucFunction;
+	unsigned int uiCalled = 0;
+	unsigned int uiSend;
+
+	TestLinkInit(&sLink, 0);
+	memset(cData, 0x5A, sizeof(cData));
+
+	NRF24L01_ResetProfile(psPTX);
+
+	CHECK_EQUAL(NRF24L01_GetProfile(psPTX, PDLIB_NRF24_PROF_SEND_DATA, &sProfile), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(sProfile.ulCalls, 0);
+	CHECK_EQUAL(sProfile.ulMin, ~0UL);
+	CHECK_EQUAL(sProfile.ulMax, 0);
+	CHECK_EQUAL(sProfile.ullBytes, 0);
+	CHECK_EQUAL(NRF24L01_GetProfile(psPTX, PDLIB_NRF24_PROF_COUNT, &sProfile), PDLIB_NRF24_INVALID_ARGUMENT);
+	CHECK(NULL == NRF24L01_GetProfileName(PDLIB_NRF24_PROF_COUNT));
+
+	for(uiSend = 0; uiSend < TEST_PROFILE_SENDS; uiSend++)
+	{
+		CHECK_EQUAL(NRF24L01_SendData(psPTX, cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	}
+
+	CHECK_EQUAL(NRF24L01_GetProfile(psPTX, PDLIB_NRF24_PROF_SEND_DATA, &sProfile), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_GetProfile(psPTX, PDLIB_NRF24_PROF_SET_TX_PAYLOAD, &sPayload), PDLIB_NRF24_SUCCESS);
+
+	CHECK_EQUAL(sProfile.ulCalls, TEST_PROFILE_SENDS);
+	CHECK(sProfile.ulMin <= sProfile.ulMax);
+	CHECK(sProfile.ulMax > 0);
+	CHECK(((unsigned long long)sProfile.ulMin * TEST_PROFILE_SENDS) <= sProfile.ullTotal);
+	CHECK(((unsigned long long)sProfile.ulMax * TEST_PROFILE_SENDS) >= sProfile.ullTotal);
+
+	/* PS: W_TX_PAYLOAD and its 32 bytes every send, counted in SendData as well */
+	CHECK_EQUAL(sPayload.ulCalls, TEST_PROFILE_SENDS);
+	CHECK_EQUAL(sPayload.ullBytes, TEST_PROFILE_SENDS * (1 + sizeof(cData)));
+	CHECK(sProfile.ullBytes > sPayload.ullBytes);
+	CHECK(sProfile.ullBytes <= psPTX->ullProfileBytes);
+
+	for(ucFunction = 0; ucFunction < PDLIB_NRF24_PROF_COUNT; ucFunction++)
+	{
+		NRF24L01_GetProfile(psPTX, ucFunction, &sProfile);
+
+		if(sProfile.ulCalls)
+		{
+			uiCalled++;
+		}
+	}
+
+	CHECK(uiCalled >= 2);
+
+	/* PS: Tick rate, header, one line per function called */
+	memset(&sDump, 0, sizeof(sDump));
+	NRF24L01_DumpProfile(psPTX, TestProfilePrint, &sDump);
+
+	CHECK_EQUAL(sDump.uiLines, 2 + uiCalled);
+	CHECK(sDump.iHeader);
+	CHECK_EQUAL(sDump.uiFunctions, uiCalled);
+	CHECK(sDump.iSendData);
+	CHECK_EQUAL(sDump.iUnknown, 0);
+
+	/* PS: A reset leaves only the two fixed lines */
+	NRF24L01_ResetProfile(psPTX);
+
+	memset(&sDump, 0, sizeof(sDump));
+	NRF24L01_DumpProfile(psPTX, TestProfilePrint, &sDump);
+
+	CHECK_EQUAL(sDump.uiLines, 2);
+	CHECK_EQUAL(psPTX->ullProfileBytes, 0);
+}
+
+void
+TestProfile(void)
+{
+	TestProfileSendData();
+}
+
+#endif
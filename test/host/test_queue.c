@@ -0,0 +1,339 @@
+/*
+ * test_queue.c
+ *
+ * The software queues drained by their IRQ handlers over the simulated
+ * air. TX queue (NRF24L01_CONF_TX_QUEUE): order, high-water mark, drops
+ * and the bounded retries on MAX_RT. RX ring (NRF24L01_CONF_RX_QUEUE):
+ * bursts of payloads per IRQ with static and dynamic widths, order, pipe
+ * tags, overruns and bad widths.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(NRF24L01_CONF_HAL) && (defined(NRF24L01_CONF_TX_QUEUE) || defined(NRF24L01_CONF_RX_QUEUE))
+
+#ifdef NRF24L01_CONF_TX_QUEUE
+
+/* PS: Time the air runs between two looks at the IRQ pins */
+#define TEST_QUEUE_STEP_US		20
+
+/* PS: Longest drain of a test, far more than any of them needs */
+#define TEST_QUEUE_LIMIT_US		200000
+
+/* PS: Runs the air and calls the IRQ handler of the PTX while its IRQ is active, the way
+ * the GPIO interrupt would, until the queue is idle. The PRX is read as the payloads come
+ * in, the first byte of each goes to pucReceived. Returns the number of payloads read. */
+static unsigned int
+TestQueueDrain(tTestLink *psLink, unsigned char *pucReceived, unsigned int uiSize)
+{
+	tNRF24L01 *psPTX = &psLink->sRadio[TEST_PTX];
+	tNRF24L01 *psPRX = &psLink->sRadio[TEST_PRX];
+	unsigned long long ullStartUs = TestLinkTimeUs(psLink);
+	unsigned int uiReceived = 0;
+	char cRead[32];
+	char cLength;
+	char cPipe;
+
+	while(NRF24L01_IsTxQueueActive(psPTX) && ((TestLinkTimeUs(psLink) - ullStartUs) < TEST_QUEUE_LIMIT_US))
+	{
+		TestLinkRun(psLink, TEST_QUEUE_STEP_US);
+
+		if(0 == NRF24L01_SimGetIRQ(&psLink->sSim[TEST_PTX]))
+		{
+			NRF24L01_TxQueueService(psPTX);
+		}
+
+		while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(psPRX, &cPipe))
+		{
+			cLength = sizeof(cRead);
+
+			if((NRF24L01_GetData(psPRX, cPipe, cRead, &cLength) > 0) && (uiReceived < uiSize))
+			{
+				pucReceived[uiReceived] = (unsigned char)cRead[0];
+			}
+
+			uiReceived++;
+		}
+	}
+
+	return uiReceived;
+}
+
+static void
+TestTxQueueDrain(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX;
+	tNRF24L01TxQueueStats sStats;
+	unsigned char ucReceived[NRF24L01_CONF_TX_QUEUE_DEPTH + 1];
+	char cData[32];
+	unsigned int uiIndex;
+	unsigned int uiReceived;
+
+	TestLinkInit(&sLink, 0);
+	psPTX = &sLink.sRadio[TEST_PTX];
+
+	NRF24L01_ResetTransactionCount(psPTX);
+
+	/* PS: The first payload goes straight to the TX FIFO, the queue holds the next
+	 * NRF24L01_CONF_TX_QUEUE_DEPTH and drops the rest */
+	for(uiIndex = 0; uiIndex < (NRF24L01_CONF_TX_QUEUE_DEPTH + 4); uiIndex++)
+	{
+		memset(cData, (int)uiIndex, sizeof(cData));
+
+		CHECK_EQUAL(NRF24L01_QueueData(psPTX, cData, sizeof(cData)),
+					((uiIndex <= NRF24L01_CONF_TX_QUEUE_DEPTH) ? PDLIB_NRF24_SUCCESS : PDLIB_NRF24_TX_QUEUE_FULL));
+	}
+
+	NRF24L01_GetTxQueueStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.ulQueued, NRF24L01_CONF_TX_QUEUE_DEPTH + 1);
+	CHECK_EQUAL(sStats.ulDropped, 3);
+	CHECK_EQUAL(sStats.uiHighWater, NRF24L01_CONF_TX_QUEUE_DEPTH);
+	CHECK_EQUAL(sStats.uiDepth, NRF24L01_CONF_TX_QUEUE_DEPTH);
+
+	uiReceived = TestQueueDrain(&sLink, ucReceived, sizeof(ucReceived));
+
+	CHECK_EQUAL(NRF24L01_IsTxQueueActive(psPTX), 0);
+	CHECK_EQUAL(uiReceived, NRF24L01_CONF_TX_QUEUE_DEPTH + 1);
+
+	for(uiIndex = 0; uiIndex < uiReceived; uiIndex++)
+	{
+		CHECK_EQUAL(ucReceived[uiIndex], uiIndex);
+	}
+
+	NRF24L01_GetTxQueueStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.uiDepth, 0);
+	CHECK_EQUAL(sStats.ulLoaded, NRF24L01_CONF_TX_QUEUE_DEPTH + 1);
+	CHECK_EQUAL(sStats.ulSent, NRF24L01_CONF_TX_QUEUE_DEPTH + 1);
+	CHECK_EQUAL(sStats.ulMaxRT, 0);
+	CHECK_EQUAL(sStats.ulFlushed, 0);
+
+	/* PS: The refill does not read FIFO_STATUS for every payload */
+	CHECK(NRF24L01_GetTransactionCount(psPTX, PDLIB_NRF24_PATH_REGISTER_READ) < sStats.ulLoaded);
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(NRF24L01_RegisterRead_8(psPTX, RF24_FIFO_STATUS) & RF24_TX_EMPTY, RF24_TX_EMPTY);
+}
+
+static void
+TestTxQueueMaxRT(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX;
+	tNRF24L01TxQueueStats sStats;
+	unsigned char ucReceived[1];
+	char cData[32];
+	unsigned int uiIndex;
+
+	TestLinkInit(&sLink, 0);
+	psPTX = &sLink.sRadio[TEST_PTX];
+
+	/* PS: Nobody listens. 3 payloads fill the TX FIFO, 2 wait in the queue */
+	NRF24L01_DisableRxMode(&sLink.sRadio[TEST_PRX]);
+
+	for(uiIndex = 0; uiIndex < 5; uiIndex++)
+	{
+		memset(cData, (int)uiIndex, sizeof(cData));
+		CHECK_EQUAL(NRF24L01_QueueData(psPTX, cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	}
+
+	CHECK_EQUAL(TestQueueDrain(&sLink, ucReceived, sizeof(ucReceived)), 0);
+	CHECK_EQUAL(NRF24L01_IsTxQueueActive(psPTX), 0);
+
+	/* PS: Each TX FIFO load gets NRF24L01_CONF_TX_QUEUE_RETRIES retries, then it is flushed */
+	NRF24L01_GetTxQueueStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.ulLoaded, 5);
+	CHECK_EQUAL(sStats.ulSent, 0);
+	CHECK_EQUAL(sStats.ulMaxRT, 2 * (NRF24L01_CONF_TX_QUEUE_RETRIES + 1));
+	CHECK_EQUAL(sStats.ulRetried, 2 * NRF24L01_CONF_TX_QUEUE_RETRIES);
+	CHECK_EQUAL(sStats.ulFlushed, 5);
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(NRF24L01_RegisterRead_8(psPTX, RF24_FIFO_STATUS) & RF24_TX_EMPTY, RF24_TX_EMPTY);
+
+	/* PS: The queue works again once the PRX listens */
+	NRF24L01_EnableRxMode(&sLink.sRadio[TEST_PRX]);
+	TestLinkRun(&sLink, 200);
+
+	memset(cData, 0x55, sizeof(cData));
+	CHECK_EQUAL(NRF24L01_QueueData(psPTX, cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(TestQueueDrain(&sLink, ucReceived, sizeof(ucReceived)), 1);
+	CHECK_EQUAL(ucReceived[0], 0x55);
+}
+
+#endif
+
+#ifdef NRF24L01_CONF_RX_QUEUE
+
+/* PS: Payloads the PTX sends between two calls of the IRQ handler of the PRX */
+#define TEST_QUEUE_BURST		3
+
+/* PS: Payload uiIndex goes to pipe 1 or 2 in turn. The static widths of the pipes differ,
+ * dynamic widths count up with uiIndex. */
+#define TEST_QUEUE_PIPE(uiIndex)					(PDLIB_NRF24_PIPE1 + ((uiIndex) & 1))
+#define TEST_QUEUE_LENGTH(iDynamic, uiIndex)		((iDynamic) ? (1 + (uiIndex)) : ((TEST_QUEUE_PIPE(uiIndex) == PDLIB_NRF24_PIPE1) ? 32 : 8))
+
+/* PS: Address of pipe 2 of the PRX, only the LSByte differs from pipe 1 */
+static void
+TestQueuePipe2Address(unsigned char *pucAddress)
+{
+	memcpy(pucAddress, g_ucTestAddress, 5);
+	pucAddress[0] ^= 0xFF;
+}
+
+/* PS: The PRX listens on pipes 1 and 2, with a static width of 32 and 8 bytes or with
+ * dynamic widths on both sides */
+static void
+TestRxQueueInit(tTestLink *psLink, int iDynamic)
+{
+	tNRF24L01 *psPTX = &psLink->sRadio[TEST_PTX];
+	tNRF24L01 *psPRX = &psLink->sRadio[TEST_PRX];
+	unsigned char ucAddress[5];
+
+	TestQueuePipe2Address(ucAddress);
+
+	NRF24L01_DisableRxMode(psPRX);
+	NRF24L01_SetRxAddress(psPRX, PDLIB_NRF24_PIPE2, ucAddress);
+	NRF24L01_RegisterWrite_8(psPRX, RF24_EN_RXADDR, (RF24_ERX_P0 | RF24_ERX_P1 | RF24_ERX_P2));
+
+	if(iDynamic)
+	{
+		NRF24L01_EnableFeatureDynPL(psPRX, PDLIB_NRF24_PIPE1);
+		NRF24L01_EnableFeatureDynPL(psPRX, PDLIB_NRF24_PIPE2);
+
+		/* PS: Features change only in power down or Standby I */
+		NRF24L01_PowerDown(psPTX);
+		NRF24L01_EnableFeatureDynPL(psPTX, PDLIB_NRF24_PIPE0);
+	}else
+	{
+		NRF24L01_SetRXPacketSize(psPRX, PDLIB_NRF24_PIPE2, 8);
+	}
+
+	NRF24L01_EnableRxMode(psPRX);
+	TestLinkRun(psLink, 200);
+}
+
+/* PS: The PTX sends TEST_QUEUE_BURST payloads starting at uiFirst, the first byte of each
+ * is its index. Then the IRQ handler of the PRX runs once. */
+static void
+TestRxQueueBurst(tTestLink *psLink, int iDynamic, unsigned int uiFirst)
+{
+	tNRF24L01 *psPTX = &psLink->sRadio[TEST_PTX];
+	unsigned char ucAddress[5];
+	char cData[32];
+	unsigned int uiIndex;
+
+	TestQueuePipe2Address(ucAddress);
+
+	for(uiIndex = uiFirst; uiIndex < (uiFirst + TEST_QUEUE_BURST); uiIndex++)
+	{
+		NRF24L01_SetTXAddress(psPTX, ((TEST_QUEUE_PIPE(uiIndex) == PDLIB_NRF24_PIPE1) ? g_ucTestAddress : ucAddress));
+
+		memset(cData, (int)uiIndex, sizeof(cData));
+		CHECK_EQUAL(NRF24L01_SendData(psPTX, cData, TEST_QUEUE_LENGTH(iDynamic, uiIndex)), PDLIB_NRF24_SUCCESS);
+	}
+
+	CHECK_EQUAL(NRF24L01_SimGetIRQ(&psLink->sSim[TEST_PRX]), 0);
+	CHECK(NRF24L01_RxQueueService(&psLink->sRadio[TEST_PRX]) & PDLIB_INTERRUPT_DATA_READY);
+	CHECK(NRF24L01_SimGetIRQ(&psLink->sSim[TEST_PRX]) != 0);
+}
+
+static void
+TestRxQueueRing(int iDynamic)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPRX;
+	tNRF24L01RxQueueStats sStats;
+	char cRead[32];
+	char cPipe;
+	unsigned int uiIndex;
+	unsigned int uiBurst;
+
+	TestLinkInit(&sLink, 0);
+	psPRX = &sLink.sRadio[TEST_PRX];
+
+	TestRxQueueInit(&sLink, iDynamic);
+
+#ifdef NRF24L01_CONF_TRANSACTION_STATS
+	NRF24L01_ResetTransactionCount(psPRX);
+#endif
+
+	/* PS: One IRQ takes the whole burst */
+	TestRxQueueBurst(&sLink, iDynamic, 0);
+	CHECK_EQUAL(NRF24L01_RxQueueCount(psPRX), TEST_QUEUE_BURST);
+
+#ifdef NRF24L01_CONF_TRANSACTION_STATS
+	/* PS: R_RX_PL_WID and R_RX_PAYLOAD per payload and the R_RX_PL_WID which finds the RX FIFO
+	 * empty, the pipes come from their STATUS. Static widths need a NOP after each payload,
+	 * the STATUS of R_RX_PAYLOAD is from before the read. */
+	CHECK_EQUAL(NRF24L01_GetTransactionCount(psPRX, PDLIB_NRF24_PATH_RX_PAYLOAD),
+				(iDynamic ? ((2 * TEST_QUEUE_BURST) + 1) : TEST_QUEUE_BURST));
+	CHECK_EQUAL(NRF24L01_GetTransactionCount(psPRX, PDLIB_NRF24_PATH_STATUS), (iDynamic ? 0 : TEST_QUEUE_BURST));
+#endif
+
+	/* PS: Nobody takes the payloads, the ring overruns */
+	for(uiBurst = 1; uiBurst < 4; uiBurst++)
+	{
+		TestRxQueueBurst(&sLink, iDynamic, (uiBurst * TEST_QUEUE_BURST));
+	}
+
+	NRF24L01_GetRxQueueStats(psPRX, &sStats);
+	CHECK_EQUAL(sStats.uiDepth, NRF24L01_CONF_RX_QUEUE_DEPTH);
+	CHECK_EQUAL(sStats.uiHighWater, NRF24L01_CONF_RX_QUEUE_DEPTH);
+	CHECK_EQUAL(sStats.ulReceived, NRF24L01_CONF_RX_QUEUE_DEPTH);
+	CHECK_EQUAL(sStats.ulDropped, (4 * TEST_QUEUE_BURST) - NRF24L01_CONF_RX_QUEUE_DEPTH);
+	CHECK_EQUAL(sStats.ulInvalid, 0);
+
+	/* PS: The oldest payloads were kept, each with its pipe and width */
+	for(uiIndex = 0; uiIndex < NRF24L01_CONF_RX_QUEUE_DEPTH; uiIndex++)
+	{
+		cPipe = 0xFF;
+
+		CHECK_EQUAL(NRF24L01_RxQueueGet(psPRX, cRead, sizeof(cRead), &cPipe), TEST_QUEUE_LENGTH(iDynamic, uiIndex));
+		CHECK_EQUAL(cPipe, TEST_QUEUE_PIPE(uiIndex));
+		CHECK_EQUAL(cRead[0], uiIndex);
+	}
+
+	CHECK_EQUAL(NRF24L01_RxQueueGet(psPRX, cRead, sizeof(cRead), &cPipe), PDLIB_NRF24_ERROR);
+
+	if(iDynamic)
+	{
+		/* PS: A width over 32 flushes the RX FIFO, the burst is lost and counted once */
+		NRF24L01_SetTXAddress(&sLink.sRadio[TEST_PTX], g_ucTestAddress);
+		memset(cRead, 0, sizeof(cRead));
+
+		for(uiIndex = 0; uiIndex < TEST_QUEUE_BURST; uiIndex++)
+		{
+			CHECK_EQUAL(NRF24L01_SendData(&sLink.sRadio[TEST_PTX], cRead, 4), PDLIB_NRF24_SUCCESS);
+		}
+
+		sLink.sSim[TEST_PRX].ucRxLength[0] = 33;
+		NRF24L01_RxQueueService(psPRX);
+
+		NRF24L01_GetRxQueueStats(psPRX, &sStats);
+		CHECK_EQUAL(sStats.uiDepth, 0);
+		CHECK_EQUAL(sStats.ulInvalid, 1);
+		CHECK_EQUAL(NRF24L01_RegisterRead_8(psPRX, RF24_FIFO_STATUS) & RF24_RX_EMPTY, RF24_RX_EMPTY);
+	}
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+#endif
+
+void
+TestQueue(void)
+{
+#ifdef NRF24L01_CONF_TX_QUEUE
+	TestTxQueueDrain();
+	TestTxQueueMaxRT();
+#endif
+#ifdef NRF24L01_CONF_RX_QUEUE
+	TestRxQueueRing(0);
+	TestRxQueueRing(1);
+#endif
+}
+
+#endif
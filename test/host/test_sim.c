@@ -0,0 +1,356 @@
+/*
+ * test_sim.c
+ *
+ * The simulated chip through the driver: register semantics, a payload
+ * over the air with auto ACK, retransmissions up to MAX_RT, a NO_ACK
+ * payload sent once and never ACKed, dynamic payloads with an ACK payload,
+ * IsDataReadyRx following the RX FIFO, the asynchronous TX completed
+ * exactly once and the period of a beacon counted by NRF24L01_Tick.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#ifdef NRF24L01_CONF_HAL
+
+static void
+TestRegisters(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psRadio;
+
+	TestLinkInit(&sLink, 0);
+	psRadio = &sLink.sRadio[TEST_PTX];
+
+	/* PS: Reserved bits read back as 0 */
+	NRF24L01_RegisterWrite_8(psRadio, RF24_RF_CH, 0xFF);
+	CHECK_EQUAL(NRF24L01_RegisterRead_8(psRadio, RF24_RF_CH), 0x7F);
+
+	/* PS: Both FIFOs empty */
+	CHECK_EQUAL(NRF24L01_RegisterRead_8(psRadio, RF24_FIFO_STATUS), (RF24_TX_EMPTY | RF24_RX_EMPTY));
+
+	/* PS: STATUS flags clear on 1, RX_P_NO reads 7 with the RX FIFO empty */
+	sLink.sSim[TEST_PTX].ucRegister[RF24_STATUS] |= (RF24_TX_DS | RF24_MAX_RT);
+	CHECK_EQUAL(NRF24L01_ClearInterruptFlag(psRadio, PDLIB_INTERRUPT_MAX_RT), (PDLIB_INTERRUPT_DATA_SENT | PDLIB_INTERRUPT_MAX_RT));
+	CHECK_EQUAL(NRF24L01_GetStatus(psRadio), (RF24_TX_DS | 0x0E));
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+}
+
+static void
+TestExchange(void)
+{
+	tTestLink sLink;
+	tNRF24L01SimStats sStats;
+	char cData[32];
+	char cRead[32];
+	char cLength = sizeof(cRead);
+	char cPipe;
+	unsigned int uiIndex;
+
+	TestLinkInit(&sLink, 0);
+
+	for(uiIndex = 0; uiIndex < sizeof(cData); uiIndex++)
+	{
+		cData[uiIndex] = (char)(uiIndex * 7);
+	}
+
+	CHECK_EQUAL(NRF24L01_SendData(&sLink.sRadio[TEST_PTX], cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+
+	/* PS: The ACK came back, the payload waits on pipe 1 */
+	CHECK_EQUAL(NRF24L01_IsDataReadyRx(&sLink.sRadio[TEST_PRX], &cPipe), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(cPipe, PDLIB_NRF24_PIPE1);
+	CHECK_EQUAL(NRF24L01_GetData(&sLink.sRadio[TEST_PRX], cPipe, cRead, &cLength), 32);
+	CHECK(0 == memcmp(cData, cRead, sizeof(cData)));
+	CHECK_EQUAL(NRF24L01_IsDataReadyRx(&sLink.sRadio[TEST_PRX], &cPipe), PDLIB_NRF24_ERROR);
+
+	NRF24L01_SimGetStats(&sLink.sSim[TEST_PTX], &sStats);
+	CHECK_EQUAL(sStats.ulPacketsSent, 1);
+	CHECK_EQUAL(sStats.ulAcksReceived, 1);
+	CHECK_EQUAL(sStats.ulRetransmits, 0);
+
+	NRF24L01_SimGetStats(&sLink.sSim[TEST_PRX], &sStats);
+	CHECK_EQUAL(sStats.ulPacketsReceived, 1);
+	CHECK_EQUAL(sStats.ulAcksSent, 1);
+}
+
+static void
+TestMaxRetransmits(void)
+{
+	tTestLink sLink;
+	tNRF24L01SimStats sStats;
+	unsigned long long ullStartUs;
+	char cData[8];
+
+	TestLinkInit(&sLink, 0);
+	memset(cData, 0x42, sizeof(cData));
+
+	/* PS: Nobody listens. 3 retransmits 250 us apart (the reset SETUP_RETR) */
+	NRF24L01_DisableRxMode(&sLink.sRadio[TEST_PRX]);
+
+	ullStartUs = TestLinkTimeUs(&sLink);
+
+	CHECK_EQUAL(NRF24L01_SendData(&sLink.sRadio[TEST_PTX], cData, sizeof(cData)), PDLIB_NRF24_TX_ARC_REACHED);
+	CHECK((TestLinkTimeUs(&sLink) - ullStartUs) >= (3 * 250));
+
+	NRF24L01_SimGetStats(&sLink.sSim[TEST_PTX], &sStats);
+	CHECK_EQUAL(sStats.ulPacketsSent, 4);
+	CHECK_EQUAL(sStats.ulRetransmits, 3);
+	CHECK_EQUAL(sStats.ulMaxRetransmits, 1);
+	CHECK_EQUAL(sStats.ulAcksReceived, 0);
+}
+
+static void
+TestNoAck(void)
+{
+	tTestLink sLink;
+	tNRF24L01SimStats sStats;
+	tNRF24L01 *psPTX;
+	char cData[32];
+	char cRead[32];
+	char cLength = sizeof(cRead);
+	char cPipe;
+
+	TestLinkInit(&sLink, 0);
+	psPTX = &sLink.sRadio[TEST_PTX];
+	memset(cData, 0x6E, sizeof(cData));
+
+	/* PS: Delivered with auto ACK on, but not ACKed */
+	CHECK_EQUAL(NRF24L01_SendDataNoAck(psPTX, cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	CHECK(sLink.sSim[TEST_PTX].ucRegister[RF24_FEATURE] & RF24_EN_DYN_ACK);
+
+	CHECK_EQUAL(NRF24L01_IsDataReadyRx(&sLink.sRadio[TEST_PRX], &cPipe), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_GetData(&sLink.sRadio[TEST_PRX], cPipe, cRead, &cLength), 32);
+	CHECK(0 == memcmp(cData, cRead, sizeof(cData)));
+
+	NRF24L01_SimGetStats(&sLink.sSim[TEST_PTX], &sStats);
+	CHECK_EQUAL(sStats.ulPacketsSent, 1);
+	CHECK_EQUAL(sStats.ulAcksReceived, 0);
+	CHECK_EQUAL(sStats.ulRetransmits, 0);
+
+	NRF24L01_SimGetStats(&sLink.sSim[TEST_PRX], &sStats);
+	CHECK_EQUAL(sStats.ulPacketsReceived, 1);
+	CHECK_EQUAL(sStats.ulAcksSent, 0);
+
+	/* PS: Nobody listens, still one transmission and no MAX_RT */
+	NRF24L01_DisableRxMode(&sLink.sRadio[TEST_PRX]);
+
+	CHECK_EQUAL(NRF24L01_SendDataNoAck(psPTX, cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+
+	NRF24L01_SimGetStats(&sLink.sSim[TEST_PTX], &sStats);
+	CHECK_EQUAL(sStats.ulPacketsSent, 2);
+	CHECK_EQUAL(sStats.ulRetransmits, 0);
+	CHECK_EQUAL(sStats.ulMaxRetransmits, 0);
+
+	/* PS: A plain payload after it still waits for its ACK */
+	CHECK_EQUAL(NRF24L01_SendData(psPTX, cData, sizeof(cData)), PDLIB_NRF24_TX_ARC_REACHED);
+
+	NRF24L01_SimGetStats(&sLink.sSim[TEST_PTX], &sStats);
+	CHECK_EQUAL(sStats.ulRetransmits, 3);
+	CHECK_EQUAL(sStats.ulMaxRetransmits, 1);
+
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+static void
+TestAckPayload(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX;
+	tNRF24L01 *psPRX;
+	char cData[5] = { 'h', 'e', 'l', 'l', 'o' };
+	char cAck[3] = { 'a', 'c', 'k' };
+	char cRead[32];
+	char cLength = sizeof(cRead);
+	char cPipe;
+
+	TestLinkInit(&sLink, 0);
+	psPTX = &sLink.sRadio[TEST_PTX];
+	psPRX = &sLink.sRadio[TEST_PRX];
+
+	NRF24L01_DisableRxMode(psPRX);
+	NRF24L01_EnableFeatureDynPL(psPRX, PDLIB_NRF24_PIPE1);
+	NRF24L01_EnableFeatureAckPL(psPRX);
+	NRF24L01_EnableRxMode(psPRX);
+
+	/* PS: Features change only in power down or Standby I */
+	NRF24L01_PowerDown(psPTX);
+	NRF24L01_EnableFeatureDynPL(psPTX, PDLIB_NRF24_PIPE0);
+	NRF24L01_EnableFeatureAckPL(psPTX);
+
+	CHECK_EQUAL(NRF24L01_SetAckPayload(psPRX, cAck, PDLIB_NRF24_PIPE1, sizeof(cAck)), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_SendData(psPTX, cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+
+	/* PS: Dynamic width on the PRX */
+	CHECK_EQUAL(NRF24L01_GetData(psPRX, PDLIB_NRF24_PIPE1, cRead, &cLength), sizeof(cData));
+	CHECK(0 == memcmp(cData, cRead, sizeof(cData)));
+
+	/* PS: The ACK payload arrives on pipe 0 of the PTX */
+	CHECK_EQUAL(NRF24L01_IsDataReadyRx(psPTX, &cPipe), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(cPipe, PDLIB_NRF24_PIPE0);
+	CHECK_EQUAL(NRF24L01_GetAckDataAmount(psPTX), sizeof(cAck));
+	NRF24L01_ReadRxPayload(psPTX, cRead, sizeof(cAck));
+	CHECK(0 == memcmp(cAck, cRead, sizeof(cAck)));
+}
+
+static void
+TestDataReadyRx(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPRX;
+	char cData[32];
+	char cRead[32];
+	char cLength;
+	char cPipe;
+	unsigned int uiIndex;
+
+	TestLinkInit(&sLink, 0);
+	psPRX = &sLink.sRadio[TEST_PRX];
+
+	for(uiIndex = 0; uiIndex < 3; uiIndex++)
+	{
+		memset(cData, (int)uiIndex, sizeof(cData));
+		CHECK_EQUAL(NRF24L01_SendData(&sLink.sRadio[TEST_PTX], cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+	}
+
+	/* PS: RX_DR acknowledged, the 3 payloads are still reported by RX_P_NO */
+	NRF24L01_ClearInterruptFlag(psPRX, PDLIB_INTERRUPT_DATA_READY);
+	CHECK_EQUAL(NRF24L01_GetStatus(psPRX) & RF24_RX_DR, 0);
+
+	for(uiIndex = 0; uiIndex < 3; uiIndex++)
+	{
+		CHECK_EQUAL(NRF24L01_IsDataReadyRx(psPRX, &cPipe), PDLIB_NRF24_SUCCESS);
+		CHECK_EQUAL(cPipe, PDLIB_NRF24_PIPE1);
+
+		cLength = sizeof(cRead);
+		CHECK_EQUAL(NRF24L01_GetData(psPRX, cPipe, cRead, &cLength), 32);
+		CHECK_EQUAL(cRead[0], uiIndex);
+	}
+
+	/* PS: Only an empty RX FIFO is reported as no data */
+	CHECK_EQUAL(NRF24L01_IsDataReadyRx(psPRX, &cPipe), PDLIB_NRF24_ERROR);
+	CHECK_EQUAL((unsigned char)cPipe, 0xFF);
+	CHECK_EQUAL(sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+static unsigned int g_uiTestCallbacks;
+static int g_iTestResult;
+
+static void
+TestTxAsyncCallback(tNRF24L01 *psRadio, int iResult)
+{
+	(void)psRadio;
+
+	g_uiTestCallbacks++;
+	g_iTestResult = iResult;
+}
+
+static void
+TestTxAsync(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX;
+	tNRF24L01TxHandle sHandle;
+	char cData[32];
+
+	TestLinkInit(&sLink, 0);
+	psPTX = &sLink.sRadio[TEST_PTX];
+	memset(cData, 0x33, sizeof(cData));
+
+	g_uiTestCallbacks = 0;
+
+	/* PS: Completed by the IRQ handler, a later tick finds nothing to time out */
+	CHECK_EQUAL(NRF24L01_SendDataAsync(psPTX, cData, sizeof(cData), &sHandle, TestTxAsyncCallback), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_TxPoll(psPTX, &sHandle), PDLIB_NRF24_TX_PENDING);
+
+	TestLinkRun(&sLink, 1000);
+	CHECK_EQUAL(NRF24L01_SimGetIRQ(&sLink.sSim[TEST_PTX]), 0);
+
+	NRF24L01_TxAsyncService(psPTX);
+	NRF24L01_Tick(psPTX, NRF24L01_CONF_TX_TIMEOUT_MS);
+
+	CHECK_EQUAL(g_uiTestCallbacks, 1);
+	CHECK_EQUAL(g_iTestResult, PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_TxPoll(psPTX, &sHandle), PDLIB_NRF24_SUCCESS);
+
+	/* PS: Timed out by the tick before the packet is on air, the IRQ which comes after
+	 * that does not complete it again */
+	CHECK_EQUAL(NRF24L01_SendDataAsync(psPTX, cData, sizeof(cData), &sHandle, TestTxAsyncCallback), PDLIB_NRF24_SUCCESS);
+	NRF24L01_Tick(psPTX, NRF24L01_CONF_TX_TIMEOUT_MS);
+
+	CHECK_EQUAL(g_uiTestCallbacks, 2);
+	CHECK_EQUAL(g_iTestResult, PDLIB_NRF24_TX_TIMEOUT);
+
+	TestLinkRun(&sLink, 1000);
+	NRF24L01_TxAsyncService(psPTX);
+
+	CHECK_EQUAL(g_uiTestCallbacks, 2);
+	CHECK_EQUAL(NRF24L01_TxPoll(psPTX, &sHandle), PDLIB_NRF24_TX_TIMEOUT);
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+}
+
+static void
+TestBeaconPeriod(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX;
+	tNRF24L01BeaconStats sStats;
+	unsigned long ulFiredMs[3];
+	unsigned long ulFired = 0;
+	unsigned long ulMs;
+	char cData[32];
+
+	TestLinkInit(&sLink, 0);
+	psPTX = &sLink.sRadio[TEST_PTX];
+	memset(cData, 0x77, sizeof(cData));
+
+	CHECK_EQUAL(NRF24L01_BeaconStart(psPTX, cData, sizeof(cData), 0, 3, 5), PDLIB_NRF24_SUCCESS);
+
+	/* PS: A 1 ms tick, the IRQ handler runs whenever the IRQ is active in between */
+	for(ulMs = 0; (ulMs < 50) && NRF24L01_IsBeaconActive(psPTX); ulMs++)
+	{
+		NRF24L01_GetBeaconStats(psPTX, &sStats);
+
+		if((sStats.ulFired > ulFired) && (ulFired < 3))
+		{
+			ulFiredMs[ulFired++] = ulMs;
+		}
+
+		TestLinkRun(&sLink, 1000);
+
+		if(0 == NRF24L01_SimGetIRQ(&sLink.sSim[TEST_PTX]))
+		{
+			NRF24L01_BeaconService(psPTX);
+		}
+
+		NRF24L01_Tick(psPTX, 1);
+	}
+
+	NRF24L01_GetBeaconStats(psPTX, &sStats);
+	CHECK_EQUAL(NRF24L01_IsBeaconActive(psPTX), 0);
+	CHECK_EQUAL(sStats.ulFired, 3);
+	CHECK_EQUAL(sStats.ulSent, 3);
+	CHECK_EQUAL(sStats.ulMaxRT, 0);
+	CHECK_EQUAL(ulFired, 3);
+
+	/* PS: One transmission every 5 ticks */
+	CHECK_EQUAL(ulFiredMs[1] - ulFiredMs[0], 5);
+	CHECK_EQUAL(ulFiredMs[2] - ulFiredMs[1], 5);
+	CHECK_EQUAL(sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+}
+
+void
+TestSim(void)
+{
+	TestRegisters();
+	TestExchange();
+	TestMaxRetransmits();
+	TestNoAck();
+	TestAckPayload();
+	TestDataReadyRx();
+	TestTxAsync();
+	TestBeaconPeriod();
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * test_spi.c
+ *
+ * The built-in SSI code (PART_LM4F120H5QR with PDLIB_SPI) on the Stellaris
+ * fake: every transaction is one burst, the bus does not stop between the
+ * command byte and its data. SPI clock calibration against wiring which
+ * fails above a bit rate.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(PART_LM4F120H5QR) && !defined(NRF24L01_CONF_HAL)
+
+static void
+TestSPIBurst(void)
+{
+	tTestBoard sBoard;
+	tNRF24L01 *psRadio;
+	unsigned char ucRead[5];
+	char cPayload[32];
+	char cRead[32];
+	unsigned int uiIndex;
+
+	TestBoardInit(&sBoard);
+	psRadio = &sBoard.sRadio;
+
+	for(uiIndex = 0; uiIndex < sizeof(cPayload); uiIndex++)
+	{
+		cPayload[uiIndex] = (char)(0xA0 + uiIndex);
+	}
+
+	/* PS: Register write and read back, 5 data bytes */
+	NRF24L01_SetTXAddress(psRadio, g_ucTestAddress);
+	NRF24L01_RegisterRead_Multi(psRadio, RF24_TX_ADDR, ucRead, sizeof(ucRead));
+	CHECK(0 == memcmp(ucRead, g_ucTestAddress, sizeof(ucRead)));
+
+	/* PS: A 32 byte payload read, put in the RX FIFO of the chip by hand */
+	memcpy(sBoard.sSim.ucRxPayload[0], cPayload, sizeof(cPayload));
+	sBoard.sSim.ucRxLength[0] = sizeof(cPayload);
+	sBoard.sSim.ucRxPipe[0] = PDLIB_NRF24_PIPE1;
+	sBoard.sSim.ucRxCount = 1;
+
+	NRF24L01_ReadRxPayload(psRadio, cRead, sizeof(cRead));
+	CHECK(0 == memcmp(cPayload, cRead, sizeof(cRead)));
+
+	/* PS: A 32 byte payload write, nobody ACKs it */
+	CHECK_EQUAL(NRF24L01_SendData(psRadio, cPayload, sizeof(cPayload)), PDLIB_NRF24_TX_ARC_REACHED);
+
+	CHECK(sBoard.sSSI.ulFrames >= 4);
+	CHECK_EQUAL(sBoard.sSSI.ulOverruns, 0);
+	CHECK_EQUAL(sBoard.sSSI.ulGaps, 0);
+	CHECK_EQUAL(sBoard.sSim.sStats.ulViolations, 0);
+}
+
+static void
+TestSPICalibrate(void)
+{
+	tTestBoard sBoard;
+	tNRF24L01 *psRadio;
+	unsigned char ucRead[5];
+	unsigned long ulBitRate;
+
+	TestBoardInit(&sBoard);
+	psRadio = &sBoard.sRadio;
+
+	NRF24L01_SetTXAddress(psRadio, g_ucTestAddress);
+
+	/* PS: The fastest rate in 1/8 steps from 8 MHz which is not above 3 MHz */
+	StellarisFakeSetMaxBitRate(3000000);
+
+	ulBitRate = NRF24L01_CalibrateSPIClock(psRadio, 8000000);
+	CHECK(ulBitRate <= 3000000);
+	CHECK(ulBitRate > ((3000000 / 8) * 7));
+	CHECK_EQUAL(NRF24L01_GetSPIBitRate(psRadio), ulBitRate);
+
+	/* PS: The TX address is back */
+	NRF24L01_RegisterRead_Multi(psRadio, RF24_TX_ADDR, ucRead, sizeof(ucRead));
+	CHECK(0 == memcmp(ucRead, g_ucTestAddress, sizeof(ucRead)));
+
+	/* PS: Nothing down to PDLIB_SPI_DEFAULT_BITRATE works, that rate is kept */
+	StellarisFakeSetMaxBitRate(PDLIB_SPI_DEFAULT_BITRATE / 2);
+
+	CHECK_EQUAL(NRF24L01_CalibrateSPIClock(psRadio, 8000000), 0);
+	CHECK_EQUAL(NRF24L01_GetSPIBitRate(psRadio), PDLIB_SPI_DEFAULT_BITRATE);
+
+	StellarisFakeSetMaxBitRate(0);
+	CHECK_EQUAL(sBoard.sSim.sStats.ulViolations, 0);
+}
+
+void
+TestSPI(void)
+{
+	TestSPIBurst();
+	TestSPICalibrate();
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * test_status.c
+ *
+ * The status byte clocked out with every command is used. With a backend
+ * which reads the IRQ pin (pfnGetIRQ of the simulator) a SendData and
+ * GetData loop does not need a single NOP read of STATUS
+ * (NRF24L01_CONF_TRANSACTION_STATS).
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_TRANSACTION_STATS)
+
+/* PS: Payloads of the loop */
+#define TEST_STATUS_ROUNDS	10
+
+static void
+TestStatusLoop(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psPTX;
+	tNRF24L01 *psPRX;
+	char cData[32];
+	char cRead[32];
+	char cLength;
+	char cPipe;
+	unsigned int uiRound;
+	unsigned int uiReceived = 0;
+
+	TestLinkInit(&sLink, 0);
+	psPTX = &sLink.sRadio[TEST_PTX];
+	psPRX = &sLink.sRadio[TEST_PRX];
+
+	NRF24L01_ResetTransactionCount(psPTX);
+	NRF24L01_ResetTransactionCount(psPRX);
+
+	for(uiRound = 0; uiRound < TEST_STATUS_ROUNDS; uiRound++)
+	{
+		memset(cData, (int)uiRound, sizeof(cData));
+
+		CHECK_EQUAL(NRF24L01_SendData(psPTX, cData, sizeof(cData)), PDLIB_NRF24_SUCCESS);
+
+		if(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(psPRX, &cPipe))
+		{
+			cLength = sizeof(cRead);
+
+			if(32 == NRF24L01_GetData(psPRX, cPipe, cRead, &cLength))
+			{
+				uiReceived += (0 == memcmp(cData, cRead, sizeof(cRead))) ? 1 : 0;
+			}
+		}
+	}
+
+	CHECK_EQUAL(uiReceived, TEST_STATUS_ROUNDS);
+
+	CHECK_EQUAL(NRF24L01_GetTransactionCount(psPTX, PDLIB_NRF24_PATH_STATUS), 0);
+	CHECK_EQUAL(NRF24L01_GetTransactionCount(psPRX, PDLIB_NRF24_PATH_STATUS), 0);
+
+	/* PS: One payload write per packet on the PTX, one payload read per packet on the PRX */
+	CHECK_EQUAL(NRF24L01_GetTransactionCount(psPTX, PDLIB_NRF24_PATH_TX_PAYLOAD), TEST_STATUS_ROUNDS);
+	CHECK_EQUAL(NRF24L01_GetTransactionCount(psPRX, PDLIB_NRF24_PATH_RX_PAYLOAD), TEST_STATUS_ROUNDS);
+}
+
+void
+TestStatus(void)
+{
+	TestStatusLoop();
+}
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ * test_stream.c
+ *
+ * The TX stream (NRF24L01_CONF_TX_STREAM) over the simulated air: payloads
+ * arrive in order, a stalled producer is counted as an underrun, the
+ * stream buffer keeps its slot order when the head and tail counters wrap,
+ * and NRF24L01_StreamStop leaves the module in Standby I with nothing
+ * queued.
+ */
+
+#include <limits.h>
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_TX_STREAM)
+
+/* PS: Slots of the stream buffer, a power of two */
+#define TEST_STREAM_SLOTS		4
+
+/* PS: Payloads per test */
+#define TEST_STREAM_PAYLOADS	20
+
+typedef struct
+{
+	tTestLink sLink;
+	char cBuffer[TEST_STREAM_SLOTS * 32];
+	unsigned char ucReceived[TEST_STREAM_PAYLOADS * 2];	// Byte 0 of every payload, in arrival order
+	unsigned int uiReceived;
+}tTestStream;
+
+static void
+TestStreamInit(tTestStream *psStream)
+{
+	memset(psStream, 0, sizeof(tTestStream));
+
+	TestLinkInit(&psStream->sLink, 0);
+	NRF24L01_ResetStreamStats(&psStream->sLink.sRadio[TEST_PTX]);
+}
+
+/* PS: What both IRQ handlers would do now: the PTX services the stream, the PRX empties
+ * its RX FIFO */
+static void
+TestStreamService(tTestStream *psStream)
+{
+	tNRF24L01 *psPRX = &psStream->sLink.sRadio[TEST_PRX];
+	char cData[32];
+	char cLength;
+	char cPipe;
+
+	if(0 == NRF24L01_SimGetIRQ(&psStream->sLink.sSim[TEST_PTX]))
+	{
+		NRF24L01_StreamService(&psStream->sLink.sRadio[TEST_PTX]);
+	}
+
+	if(0 == NRF24L01_SimGetIRQ(&psStream->sLink.sSim[TEST_PRX]))
+	{
+		NRF24L01_ClearInterruptFlag(psPRX, PDLIB_INTERRUPT_DATA_READY);
+
+		while(PDLIB_NRF24_SUCCESS == NRF24L01_IsDataReadyRx(psPRX, &cPipe))
+		{
+			cLength = sizeof(cData);
+
+			if(NRF24L01_GetData(psPRX, cPipe, cData, &cLength) <= 0)
+			{
+				break;
+			}
+
+			if(psStream->uiReceived < sizeof(psStream->ucReceived))
+			{
+				psStream->ucReceived[psStream->uiReceived] = (unsigned char)cData[0];
+			}
+
+			psStream->uiReceived++;
+		}
+	}
+}
+
+/* PS: Runs the air to its next event and services both radios */
+static void
+TestStreamStep(tTestStream *psStream)
+{
+	unsigned long long ullNow = TestLinkTimeUs(&psStream->sLink);
+	unsigned long long ullNext = NRF24L01_AirNextEvent(&psStream->sLink.sAir);
+
+	if(ullNext <= ullNow)
+	{
+		ullNext = ullNow + 1;
+	}
+
+	NRF24L01_AirRun(&psStream->sLink.sAir, ullNext);
+	TestStreamService(psStream);
+}
+
+/* PS: Writes payloads ucFirst to ucFirst + uiCount - 1 (byte 0 is the number), stepping the
+ * air while the stream buffer is full */
+static void
+TestStreamWrite(tTestStream *psStream, unsigned char ucFirst, unsigned int uiCount)
+{
+	tNRF24L01 *psPTX = &psStream->sLink.sRadio[TEST_PTX];
+	char cData[32];
+	unsigned int uiIndex;
+	unsigned int uiGuard;
+
+	for(uiIndex = 0; uiIndex < uiCount; uiIndex++)
+	{
+		memset(cData, 0, sizeof(cData));
+		cData[0] = (char)(ucFirst + uiIndex);
+
+		for(uiGuard = 0; (uiGuard < 10000) && (PDLIB_NRF24_TX_QUEUE_FULL == NRF24L01_StreamWrite(psPTX, cData)); uiGuard++)
+		{
+			TestStreamStep(psStream);
+		}
+
+		CHECK(uiGuard < 10000);
+	}
+}
+
+/* PS: Steps the air until the stream drained and the last payload is read at the PRX */
+static void
+TestStreamDrain(tTestStream *psStream, unsigned int uiExpected)
+{
+	unsigned int uiGuard;
+
+	for(uiGuard = 0; (uiGuard < 10000) && (!NRF24L01_IsStreamIdle(&psStream->sLink.sRadio[TEST_PTX]) ||
+										   (psStream->uiReceived < uiExpected)); uiGuard++)
+	{
+		TestStreamStep(psStream);
+	}
+
+	CHECK(uiGuard < 10000);
+}
+
+static void
+TestStreamCheckOrder(tTestStream *psStream, unsigned int uiExpected)
+{
+	unsigned int uiIndex;
+
+	CHECK_EQUAL(psStream->uiReceived, uiExpected);
+
+	for(uiIndex = 0; (uiIndex < psStream->uiReceived) && (uiIndex < uiExpected); uiIndex++)
+	{
+		CHECK_EQUAL(psStream->ucReceived[uiIndex], uiIndex);
+	}
+}
+
+static void
+TestStreamOrder(void)
+{
+	tTestStream sStream;
+	tNRF24L01 *psPTX;
+	tNRF24L01StreamStats sStats;
+
+	TestStreamInit(&sStream);
+	psPTX = &sStream.sLink.sRadio[TEST_PTX];
+
+	/* PS: The slot index is a mask, the count must be a power of two */
+	CHECK_EQUAL(NRF24L01_StreamStart(psPTX, sStream.cBuffer, 3, 32, 0), PDLIB_NRF24_INVALID_ARGUMENT);
+
+	CHECK_EQUAL(NRF24L01_StreamStart(psPTX, sStream.cBuffer, TEST_STREAM_SLOTS, 32, 0), PDLIB_NRF24_SUCCESS);
+	CHECK_EQUAL(NRF24L01_StreamStart(psPTX, sStream.cBuffer, TEST_STREAM_SLOTS, 32, 0), PDLIB_NRF24_BUSY);
+
+	TestStreamWrite(&sStream, 0, TEST_STREAM_PAYLOADS);
+	TestStreamDrain(&sStream, TEST_STREAM_PAYLOADS);
+
+	TestStreamCheckOrder(&sStream, TEST_STREAM_PAYLOADS);
+
+	NRF24L01_GetStreamStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.ulWritten, TEST_STREAM_PAYLOADS);
+	CHECK_EQUAL(sStats.ulLoaded, TEST_STREAM_PAYLOADS);
+	CHECK_EQUAL(sStats.ulSent, TEST_STREAM_PAYLOADS);
+	CHECK_EQUAL(sStats.ulMaxRT, 0);
+	CHECK_EQUAL(sStats.uiHighWater, TEST_STREAM_SLOTS);
+
+	/* PS: The end of the data is the only gap */
+	CHECK_EQUAL(sStats.ulUnderruns, 1);
+
+	NRF24L01_StreamStop(psPTX);
+
+	CHECK_EQUAL(sStream.sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+	CHECK_EQUAL(sStream.sLink.sSim[TEST_PRX].sStats.ulViolations, 0);
+}
+
+static void
+TestStreamUnderrun(void)
+{
+	tTestStream sStream;
+	tNRF24L01 *psPTX;
+	tNRF24L01StreamStats sStats;
+
+	TestStreamInit(&sStream);
+	psPTX = &sStream.sLink.sRadio[TEST_PTX];
+
+	/* PS: No ACK, no retransmission, the PRX still gets every payload on a clean air */
+	CHECK_EQUAL(NRF24L01_StreamStart(psPTX, sStream.cBuffer, TEST_STREAM_SLOTS, 32, 1), PDLIB_NRF24_SUCCESS);
+
+	/* PS: The producer stalls after every half, the FIFO runs empty with CE high */
+	TestStreamWrite(&sStream, 0, TEST_STREAM_PAYLOADS / 2);
+	TestStreamDrain(&sStream, TEST_STREAM_PAYLOADS / 2);
+
+	NRF24L01_GetStreamStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.ulUnderruns, 1);
+
+	TestStreamWrite(&sStream, TEST_STREAM_PAYLOADS / 2, TEST_STREAM_PAYLOADS / 2);
+	TestStreamDrain(&sStream, TEST_STREAM_PAYLOADS);
+
+	NRF24L01_GetStreamStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.ulUnderruns, 2);
+	CHECK_EQUAL(sStats.ulSent, TEST_STREAM_PAYLOADS);
+
+	TestStreamCheckOrder(&sStream, TEST_STREAM_PAYLOADS);
+	CHECK_EQUAL(sStream.sLink.sSim[TEST_PTX].sStats.ulRetransmits, 0);
+
+	NRF24L01_StreamStop(psPTX);
+
+	CHECK_EQUAL(sStream.sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+}
+
+static void
+TestStreamWrap(void)
+{
+	tTestStream sStream;
+	tNRF24L01 *psPTX;
+	tNRF24L01StreamStats sStats;
+
+	TestStreamInit(&sStream);
+	psPTX = &sStream.sLink.sRadio[TEST_PTX];
+
+	CHECK_EQUAL(NRF24L01_StreamStart(psPTX, sStream.cBuffer, TEST_STREAM_SLOTS, 32, 0), PDLIB_NRF24_SUCCESS);
+
+	/* PS: Days of streaming later, the counters are about to wrap. The first three payloads go
+	 * to the TX FIFO, the buffer is full when the head wraps. */
+	psPTX->uiStreamHead = (UINT_MAX - 5);
+	psPTX->uiStreamTail = (UINT_MAX - 5);
+
+	TestStreamWrite(&sStream, 0, TEST_STREAM_PAYLOADS);
+	TestStreamDrain(&sStream, TEST_STREAM_PAYLOADS);
+
+	/* PS: No payload written over before it was loaded */
+	TestStreamCheckOrder(&sStream, TEST_STREAM_PAYLOADS);
+
+	NRF24L01_GetStreamStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.uiDepth, 0);
+	CHECK_EQUAL(psPTX->uiStreamHead, (TEST_STREAM_PAYLOADS - 6));
+
+	NRF24L01_StreamStop(psPTX);
+}
+
+static void
+TestStreamStop(void)
+{
+	tTestStream sStream;
+	tNRF24L01 *psPTX;
+	tNRF24L01StreamStats sStats;
+
+	TestStreamInit(&sStream);
+	psPTX = &sStream.sLink.sRadio[TEST_PTX];
+
+	CHECK_EQUAL(NRF24L01_StreamStart(psPTX, sStream.cBuffer, TEST_STREAM_SLOTS, 32, 0), PDLIB_NRF24_SUCCESS);
+
+	/* PS: Three payloads go to the TX FIFO at once, the rest fills the stream buffer */
+	TestStreamWrite(&sStream, 0, 3 + TEST_STREAM_SLOTS);
+
+	NRF24L01_GetStreamStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.uiDepth, TEST_STREAM_SLOTS);
+
+	NRF24L01_StreamStop(psPTX);
+
+	/* PS: The packet on air, if any, ends. Nothing is sent after it. */
+	TestLinkRun(&sStream.sLink, 2000);
+	TestStreamService(&sStream);
+
+	NRF24L01_GetStreamStats(psPTX, &sStats);
+	CHECK_EQUAL(sStats.uiDepth, 0);
+	CHECK_EQUAL(NRF24L01_IsStreamIdle(psPTX), 1);
+	CHECK(sStream.uiReceived <= 1);
+
+	CHECK_EQUAL(sStream.sLink.sSim[TEST_PTX].ucState, PDLIB_NRF24_SIM_STANDBY_I);
+	CHECK(NRF24L01_RegisterRead_8(psPTX, RF24_FIFO_STATUS) & RF24_TX_EMPTY);
+
+	/* PS: Writes are refused, a new stream may start */
+	CHECK_EQUAL(NRF24L01_StreamWrite(psPTX, sStream.cBuffer), PDLIB_NRF24_ERROR);
+	CHECK_EQUAL(NRF24L01_StreamStart(psPTX, sStream.cBuffer, TEST_STREAM_SLOTS, 32, 0), PDLIB_NRF24_SUCCESS);
+	NRF24L01_StreamStop(psPTX);
+
+	CHECK_EQUAL(sStream.sLink.sSim[TEST_PTX].sStats.ulViolations, 0);
+}
+
+void
+TestStream(void)
+{
+	TestStreamOrder();
+	TestStreamUnderrun();
+	TestStreamWrap();
+	TestStreamStop();
+}
+
+#endif
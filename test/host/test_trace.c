@@ -0,0 +1,219 @@
+/*
+ * test_trace.c
+ *
+ * The trace ring (NRF24L01_CONF_TRACE, build.sh uses a small
+ * NRF24L01_CONF_TRACE_DEPTH): writers which lap the reader are counted as
+ * lost and the read goes on from the oldest entry left, with no gap in the
+ * sequence. NRF24L01_TraceDrain frames decode back into the CLOCK and LOST
+ * frames and the entries.
+ */
+
+#include <string.h>
+#include "pdlib_nrf24l01_test.h"
+
+#if defined(NRF24L01_CONF_HAL) && defined(NRF24L01_CONF_TRACE)
+
+#include "nRF24L01.h"
+
+/* PS: Frames one drain may write in these tests */
+#define TEST_TRACE_FRAMES	(NRF24L01_CONF_TRACE_DEPTH + 4)
+
+typedef struct
+{
+	unsigned char ucData[TEST_TRACE_FRAMES * PDLIB_NRF24_TRACE_FRAME_SIZE];
+	unsigned int uiLength;
+	unsigned int uiWrites;
+}tTestTraceSink;
+
+/* PS: pfnWrite of NRF24L01_TraceDrain */
+static void
+TestTraceWrite(void *pvArg, const unsigned char *pucData, unsigned int uiLength)
+{
+	tTestTraceSink *psSink = (tTestTraceSink *)pvArg;
+
+	psSink->uiWrites++;
+
+	if((psSink->uiLength + uiLength) <= sizeof(psSink->ucData))
+	{
+		memcpy(&psSink->ucData[psSink->uiLength], pucData, uiLength);
+		psSink->uiLength += uiLength;
+	}
+}
+
+/* PS: Frame uiFrame of the sink, as the trace example decodes it. 0 if the frame is not there
+ * or does not start with PDLIB_NRF24_TRACE_FRAME_START. */
+static int
+TestTraceDecode(const tTestTraceSink *psSink, unsigned int uiFrame, tNRF24L01TraceEntry *psEntry)
+{
+	const unsigned char *pucFrame = &psSink->ucData[uiFrame * PDLIB_NRF24_TRACE_FRAME_SIZE];
+
+	if((((uiFrame + 1) * PDLIB_NRF24_TRACE_FRAME_SIZE) > psSink->uiLength) || (pucFrame[0] != PDLIB_NRF24_TRACE_FRAME_START))
+	{
+		return 0;
+	}
+
+	psEntry->ulSequence = ((unsigned long)pucFrame[1] | ((unsigned long)pucFrame[2] << 8) |
+						   ((unsigned long)pucFrame[3] << 16) | ((unsigned long)pucFrame[4] << 24));
+	psEntry->ulTime = ((unsigned long)pucFrame[5] | ((unsigned long)pucFrame[6] << 8) |
+					   ((unsigned long)pucFrame[7] << 16) | ((unsigned long)pucFrame[8] << 24));
+	psEntry->ucType = pucFrame[9];
+	psEntry->ucCommand = pucFrame[10];
+	psEntry->ucLength = pucFrame[11];
+	psEntry->ucStatus = pucFrame[12];
+
+	return 1;
+}
+
+/* PS: Marks 0, 1, ... from ulFirst on, the mark is the low byte of its index */
+static void
+TestTraceMarks(tNRF24L01 *psRadio, unsigned long ulFirst, unsigned long ulCount)
+{
+	unsigned long ulIndex;
+
+	for(ulIndex = ulFirst; ulIndex < (ulFirst + ulCount); ulIndex++)
+	{
+		NRF24L01_TraceMark(psRadio, (unsigned char)ulIndex);
+	}
+}
+
+static void
+TestTraceOverflow(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psRadio = &sLink.sRadio[TEST_PTX];
+	tNRF24L01TraceEntry sEntry[NRF24L01_CONF_TRACE_DEPTH * 2];
+	unsigned long ulWritten = ((NRF24L01_CONF_TRACE_DEPTH * 3) + 3);
+	unsigned int uiRead;
+	unsigned int uiIndex;
+
+	TestLinkInit(&sLink, 0);
+	NRF24L01_TraceReset(psRadio);
+
+	CHECK_EQUAL(NRF24L01_TraceRead(psRadio, sEntry, NRF24L01_CONF_TRACE_DEPTH * 2), 0);
+
+	/* PS: The writers go round the ring three times and a bit, the ring keeps the newest */
+	TestTraceMarks(psRadio, 0, ulWritten);
+
+	uiRead = NRF24L01_TraceRead(psRadio, sEntry, NRF24L01_CONF_TRACE_DEPTH * 2);
+	CHECK_EQUAL(uiRead, NRF24L01_CONF_TRACE_DEPTH);
+	CHECK_EQUAL(NRF24L01_TraceGetLost(psRadio), ulWritten - NRF24L01_CONF_TRACE_DEPTH);
+	CHECK_EQUAL(NRF24L01_TraceGetLost(psRadio), 0);
+
+	for(uiIndex = 0; uiIndex < uiRead; uiIndex++)
+	{
+		CHECK_EQUAL(sEntry[uiIndex].ulSequence, (ulWritten - NRF24L01_CONF_TRACE_DEPTH) + uiIndex + 1);
+		CHECK_EQUAL(sEntry[uiIndex].ucType, PDLIB_NRF24_TRACE_MARK);
+		CHECK_EQUAL(sEntry[uiIndex].ucCommand, (unsigned char)(sEntry[uiIndex].ulSequence - 1));
+	}
+
+	CHECK_EQUAL(NRF24L01_TraceRead(psRadio, sEntry, NRF24L01_CONF_TRACE_DEPTH * 2), 0);
+
+	/* PS: A reader part way through is lapped by two, the sequence goes on without a gap */
+	TestTraceMarks(psRadio, ulWritten, 4);
+	CHECK_EQUAL(NRF24L01_TraceRead(psRadio, sEntry, 2), 2);
+	CHECK_EQUAL(sEntry[1].ulSequence, ulWritten + 2);
+
+	TestTraceMarks(psRadio, ulWritten + 4, NRF24L01_CONF_TRACE_DEPTH);
+	ulWritten += (4 + NRF24L01_CONF_TRACE_DEPTH);
+
+	uiRead = NRF24L01_TraceRead(psRadio, sEntry, NRF24L01_CONF_TRACE_DEPTH * 2);
+	CHECK_EQUAL(uiRead, NRF24L01_CONF_TRACE_DEPTH);
+	CHECK_EQUAL(NRF24L01_TraceGetLost(psRadio), 2);
+	CHECK_EQUAL(sEntry[0].ulSequence, ulWritten - NRF24L01_CONF_TRACE_DEPTH + 1);
+	CHECK_EQUAL(sEntry[uiRead - 1].ulSequence, ulWritten);
+
+	for(uiIndex = 1; uiIndex < uiRead; uiIndex++)
+	{
+		CHECK_EQUAL(sEntry[uiIndex].ulSequence, sEntry[uiIndex - 1].ulSequence + 1);
+	}
+
+	/* PS: Exactly full is not lapped */
+	TestTraceMarks(psRadio, ulWritten, NRF24L01_CONF_TRACE_DEPTH);
+
+	CHECK_EQUAL(NRF24L01_TraceRead(psRadio, sEntry, NRF24L01_CONF_TRACE_DEPTH * 2), NRF24L01_CONF_TRACE_DEPTH);
+	CHECK_EQUAL(NRF24L01_TraceGetLost(psRadio), 0);
+	CHECK_EQUAL(sEntry[0].ulSequence, ulWritten + 1);
+}
+
+static void
+TestTraceDrain(void)
+{
+	tTestLink sLink;
+	tNRF24L01 *psRadio = &sLink.sRadio[TEST_PTX];
+	tTestTraceSink sSink;
+	tNRF24L01TraceEntry sEntry;
+	unsigned long ulTime;
+	unsigned char ucStatus;
+	unsigned int uiFrame;
+
+	TestLinkInit(&sLink, 0);
+	NRF24L01_TraceReset(psRadio);
+	memset(&sSink, 0, sizeof(sSink));
+
+	/* PS: One SPI transaction, the simulated clock moves while it is clocked */
+	ulTime = (unsigned long)TestLinkTimeUs(&sLink);
+	NRF24L01_RegisterRead_8(psRadio, RF24_RF_CH);
+	ucStatus = NRF24L01_GetLastStatus(psRadio, NULL);
+
+	CHECK_EQUAL(NRF24L01_TraceDrain(psRadio, TestTraceWrite, &sSink, 0), 0);
+
+	/* PS: The CLOCK frame comes first, once */
+	CHECK_EQUAL(sSink.uiWrites, 1);
+	CHECK(TestTraceDecode(&sSink, 0, &sEntry));
+	CHECK_EQUAL(sEntry.ucType, PDLIB_NRF24_TRACE_CLOCK);
+	CHECK_EQUAL(sEntry.ulSequence, 0);
+	CHECK_EQUAL(sEntry.ulTime, NRF24L01_GetTraceTickRate(psRadio));
+	CHECK_EQUAL(sEntry.ulTime, 1000000);
+
+	CHECK_EQUAL(NRF24L01_TraceDrain(psRadio, TestTraceWrite, &sSink, 1), 1);
+	CHECK_EQUAL(sSink.uiWrites, 2);
+	CHECK(TestTraceDecode(&sSink, 1, &sEntry));
+	CHECK_EQUAL(sEntry.ucType, PDLIB_NRF24_TRACE_SPI);
+	CHECK_EQUAL(sEntry.ulSequence, 1);
+	CHECK(sEntry.ulTime >= ulTime);
+	CHECK(sEntry.ulTime <= (unsigned long)TestLinkTimeUs(&sLink));
+	CHECK_EQUAL(sEntry.ucCommand, (RF24_R_REGISTER | RF24_RF_CH));
+	CHECK_EQUAL(sEntry.ucLength, 1);
+	CHECK_EQUAL(sEntry.ucStatus, ucStatus);
+
+	/* PS: Two more than the ring holds */
+	TestTraceMarks(psRadio, 0, NRF24L01_CONF_TRACE_DEPTH + 2);
+
+	memset(&sSink, 0, sizeof(sSink));
+	CHECK_EQUAL(NRF24L01_TraceDrain(psRadio, TestTraceWrite, &sSink, TEST_TRACE_FRAMES), NRF24L01_CONF_TRACE_DEPTH);
+
+	/* PS: LOST where they were lost, then the entries left, in order */
+	CHECK_EQUAL(sSink.uiLength, (NRF24L01_CONF_TRACE_DEPTH + 1) * PDLIB_NRF24_TRACE_FRAME_SIZE);
+	CHECK(TestTraceDecode(&sSink, 0, &sEntry));
+	CHECK_EQUAL(sEntry.ucType, PDLIB_NRF24_TRACE_LOST);
+	CHECK_EQUAL(sEntry.ulSequence, 0);
+	CHECK_EQUAL(sEntry.ulTime, 2);
+
+	for(uiFrame = 1; uiFrame <= NRF24L01_CONF_TRACE_DEPTH; uiFrame++)
+	{
+		CHECK(TestTraceDecode(&sSink, uiFrame, &sEntry));
+		CHECK_EQUAL(sEntry.ucType, PDLIB_NRF24_TRACE_MARK);
+		CHECK_EQUAL(sEntry.ulSequence, 1 + 2 + uiFrame);
+		CHECK_EQUAL(sEntry.ucCommand, 2 + (uiFrame - 1));
+	}
+
+	/* PS: Nothing left, and no second CLOCK frame */
+	memset(&sSink, 0, sizeof(sSink));
+	CHECK_EQUAL(NRF24L01_TraceDrain(psRadio, TestTraceWrite, &sSink, TEST_TRACE_FRAMES), 0);
+	CHECK_EQUAL(sSink.uiWrites, 0);
+
+	/* PS: A reset sends the clock again */
+	NRF24L01_TraceReset(psRadio);
+	CHECK_EQUAL(NRF24L01_TraceDrain(psRadio, TestTraceWrite, &sSink, TEST_TRACE_FRAMES), 0);
+	CHECK(TestTraceDecode(&sSink, 0, &sEntry));
+	CHECK_EQUAL(sEntry.ucType, PDLIB_NRF24_TRACE_CLOCK);
+}
+
+void
+TestTrace(void)
+{
+	TestTraceOverflow();
+	TestTraceDrain();
+}
+
+#endif